@@ -5,7 +5,8 @@
 #include "src/ui/UI_Config.h"
 #include "src/rendering/Interpolation.h"
 #include "src/rendering/Render.h"
-#include <iostream>
+#include "src/track/TrackGeometry.h"
+#include "src/core/Log.h"
 #include <algorithm>
 #include <cmath>
 #include <glm/glm.hpp>
@@ -29,11 +30,14 @@
 
 #include "src/network/TrackServerClient.h"
 #include "src/ui/Accounts.h"
+#include "src/ui/LatencyPanel.h"
 #include "src/ui/pro/ProView.h"
 #include "src/network/Server.h"
 #include "src/network/ESP32_Code.h"
 #include "src/network/SimulationServer.h"
+#include "src/network/TelemetryIngest.h"
 #include "src/racing/RaceManager.h"
+#include "src/racing/RaceSnapshot.h"
 #include "src/racing/ModeManager/ModeManager.h"
 #include "src/vehicle/Vehicle.h"
 #include "src/track/TelemetryTrackBuilder.h"
@@ -189,6 +193,13 @@ void UI::UpdateNetworkingIps()
 static void applyTrackData(const std::string& data,
     std::vector<glm::vec2>* points, std::mutex* mtx)
 {
+    if (!isDualEdgeFormat(data) && (!points || !mtx)) return;
+
+    // The text loaders publish the new origin from the first point while they
+    // convert the rest: drop the old centre line first, so nothing is matched
+    // against it in the new origin's coordinates meanwhile.
+    TrackGeometry::ClearPoints();
+
     std::vector<glm::vec2> left, right;
     if (isDualEdgeFormat(data) && loadDualEdgeFromData(data, left, right))
     {
@@ -197,24 +208,28 @@ static void applyTrackData(const std::string& data,
     }
     if (!points || !mtx) return;
     loadTrackFromData(data, *points, *mtx);
+    MapOrigin origin = TrackGeometry::CurrentOrigin();
+    bool recentered = false;
     {
         std::lock_guard<std::mutex> lk(*mtx);
         TrackCenterInfo ci = calculateTrackCenter(*points);
         if (ci.is_closed)
         {
             recenterTrack(*points, ci);
-            g_map_origin.m_origin_meters_easting  -= ci.offset.x * MapConstants::MAP_SIZE;
-            g_map_origin.m_origin_meters_northing -= ci.offset.y * MapConstants::MAP_SIZE;
+            origin.m_origin_meters_easting  -= ci.offset.x * MapConstants::MAP_SIZE;
+            origin.m_origin_meters_northing -= ci.offset.y * MapConstants::MAP_SIZE;
             try {
                 using namespace GeographicLib;
-                const bool northp = (g_map_origin.m_origin_zone_char >= 'N');
-                UTMUPS::Reverse(g_map_origin.m_origin_zone_int, northp,
-                    g_map_origin.m_origin_meters_easting, g_map_origin.m_origin_meters_northing,
-                    g_map_origin.m_origin_lat_dd, g_map_origin.m_origin_lon_dd);
+                const bool northp = (origin.m_origin_zone_char >= 'N');
+                UTMUPS::Reverse(origin.m_origin_zone_int, northp,
+                    origin.m_origin_meters_easting, origin.m_origin_meters_northing,
+                    origin.m_origin_lat_dd, origin.m_origin_lon_dd);
             } catch (...) {}
+            recentered = true;
         }
     }
-    TrackRenderer::rebuildTrackCache(*points, *mtx);
+    // The recentred origin goes out with the recentred points
+    TrackRenderer::rebuildTrackCache(*points, *mtx, recentered ? &origin : nullptr);
 }
 
 // Load track from file path — handles .trk2 binary and legacy .txt automatically.
@@ -225,8 +240,10 @@ static void applyTrackFile(const std::string& path,
         path.compare(path.size() - 5, 5, ".trk2") == 0;
     if (isTrk2) {
         std::vector<glm::vec2> left, right;
-        if (loadTrk2File(path, left, right))
-            TrackRenderer::rebuildTrackCacheFromEdges(left, right);
+        std::vector<TrackGeometry::TimingLine> timingLines;
+        MapOrigin origin{};
+        if (loadTrk2File(path, left, right, timingLines, origin))
+            TrackRenderer::rebuildTrackCacheFromEdges(left, right, timingLines, &origin);
         return;
     }
     std::ifstream file(path);
@@ -635,7 +652,7 @@ bool UI::LoadTextureFromFile(const char* filename, void** out_texture, int* out_
     
     if (data == nullptr)
     {
-        std::cerr << "[UI] Failed to load texture: " << filename << "\n";
+        LOG_ERROR(UI, "[UI] Failed to load texture: " << filename);
         return false;
     }
     
@@ -654,7 +671,7 @@ bool UI::LoadTextureFromFile(const char* filename, void** out_texture, int* out_
     if (out_width) *out_width = width;
     if (out_height) *out_height = height;
     
-    std::cout << "[UI] Loaded texture: " << filename << " (" << width << "x" << height << ")\n";
+    LOG_INFO(UI, "[UI] Loaded texture: " << filename << " (" << width << "x" << height << ")");
     return true;
 }
 
@@ -664,26 +681,26 @@ void UI::LoadResources()
     // ?????? ???? ? ???????????
     if (!LoadTextureFromFile("styles/images/start.png", &m_backgroundTexture, &w, &h))
     {
-        std::cerr << "[UI] Warning: Background image not loaded\n";
+        LOG_WARN(UI, "[UI] Warning: Background image not loaded");
     }
     
     // Load Icons
-    if (!LoadTextureFromFile("styles/icons/PNG/file.png", &m_iconFile, nullptr, nullptr)) std::cerr << "Failed to load file.png\n";
-    if (!LoadTextureFromFile("styles/icons/PNG/contact.png", &m_iconContact, nullptr, nullptr)) std::cerr << "Failed to load contact.png\n";
-    if (!LoadTextureFromFile("styles/icons/PNG/copyright.png", &m_iconCopyright, nullptr, nullptr)) std::cerr << "Failed to load copyright.png\n";
-    if (!LoadTextureFromFile("styles/icons/PNG/heart.png", &m_iconHeart, nullptr, nullptr)) std::cerr << "Failed to load heart.png\n";
-    if (!LoadTextureFromFile("styles/icons/PNG/circle-x.png", &m_iconClose, nullptr, nullptr)) std::cerr << "Failed to load circle-x.png\n";
-    if (!LoadTextureFromFile("styles/icons/PNG/DragAndDrop.png", &m_iconDragDrop, nullptr, nullptr)) std::cerr << "Failed to load DragAndDrop.png\n";
-    if (!LoadTextureFromFile("styles/icons/PNG/Icon.png",       &m_logoTexture,   nullptr, nullptr)) std::cerr << "Failed to load Icon.png\n";
+    if (!LoadTextureFromFile("styles/icons/PNG/file.png", &m_iconFile, nullptr, nullptr)) LOG_ERROR(UI, "Failed to load file.png");
+    if (!LoadTextureFromFile("styles/icons/PNG/contact.png", &m_iconContact, nullptr, nullptr)) LOG_ERROR(UI, "Failed to load contact.png");
+    if (!LoadTextureFromFile("styles/icons/PNG/copyright.png", &m_iconCopyright, nullptr, nullptr)) LOG_ERROR(UI, "Failed to load copyright.png");
+    if (!LoadTextureFromFile("styles/icons/PNG/heart.png", &m_iconHeart, nullptr, nullptr)) LOG_ERROR(UI, "Failed to load heart.png");
+    if (!LoadTextureFromFile("styles/icons/PNG/circle-x.png", &m_iconClose, nullptr, nullptr)) LOG_ERROR(UI, "Failed to load circle-x.png");
+    if (!LoadTextureFromFile("styles/icons/PNG/DragAndDrop.png", &m_iconDragDrop, nullptr, nullptr)) LOG_ERROR(UI, "Failed to load DragAndDrop.png");
+    if (!LoadTextureFromFile("styles/icons/PNG/Icon.png",       &m_logoTexture,   nullptr, nullptr)) LOG_ERROR(UI, "Failed to load Icon.png");
     
     // Load Compass texture
     if (!LoadTextureFromFile("styles/images/Compas scaled.png", &m_compassTexture, nullptr, nullptr)) 
     {
-        std::cerr << "[UI] Failed to load Compas scaled.png\n";
+        LOG_ERROR(UI, "[UI] Failed to load Compas scaled.png");
     }
     else
     {
-        std::cout << "[UI] Compass texture loaded successfully\n";
+        LOG_INFO(UI, "[UI] Compass texture loaded successfully");
     }
 
     // Prototype toast resources
@@ -707,23 +724,23 @@ void UI::LoadRecentFiles()
     // Check if directory exists
     if (!fs::exists(saves_path) || !fs::is_directory(saves_path))
     {
-        std::cout << "[UI] Saves directory not found: " << saves_path << "\n";
-        std::cout << "[UI] Creating saves directory...\n";
+        LOG_INFO(UI, "[UI] Saves directory not found: " << saves_path);
+        LOG_INFO(UI, "[UI] Creating saves directory...");
         
         try
         {
             fs::create_directories(saves_path);
-            std::cout << "[UI] Saves directory created successfully\n";
+            LOG_INFO(UI, "[UI] Saves directory created successfully");
         }
         catch (const std::exception& e)
         {
-            std::cerr << "[UI] Failed to create saves directory: " << e.what() << "\n";
+            LOG_ERROR(UI, "[UI] Failed to create saves directory: " << e.what());
         }
         
         return;
     }
     
-    std::cout << "[UI] Scanning saves directory: " << saves_path << "\n";
+    LOG_INFO(UI, "[UI] Scanning saves directory: " << saves_path);
     
     // Scan directory for track files (.json and .txt)
     try
@@ -745,7 +762,7 @@ void UI::LoadRecentFiles()
                     std::replace(file.path.begin(), file.path.end(), '\\', '/');
                     
                     m_recentFiles.push_back(file);
-                    std::cout << "[UI] Found save file: " << filename << "\n";
+                    LOG_DEBUG(UI, "[UI] Found save file: " << filename);
                 }
             }
         }
@@ -756,11 +773,11 @@ void UI::LoadRecentFiles()
                      return a.name < b.name;
                  });
         
-        std::cout << "[UI] Loaded " << m_recentFiles.size() << " save file(s)\n";
+        LOG_INFO(UI, "[UI] Loaded " << m_recentFiles.size() << " save file(s)");
     }
     catch (const std::exception& e)
     {
-        std::cerr << "[UI] Error scanning saves directory: " << e.what() << "\n";
+        LOG_ERROR(UI, "[UI] Error scanning saves directory: " << e.what());
     }
 }
 
@@ -768,7 +785,7 @@ bool UI::Initialize(GLFWwindow* window)
 {
     if (!window)
     {
-        std::cerr << "[UI] Error: window is null\n";
+        LOG_ERROR(UI, "[UI] Error: window is null");
         return false;
     }
     
@@ -779,7 +796,7 @@ bool UI::Initialize(GLFWwindow* window)
     
     if (!m_context)
     {
-        std::cerr << "[UI] Error: Failed to create ImGui context\n";
+        LOG_ERROR(UI, "[UI] Error: Failed to create ImGui context");
         return false;
     }
     
@@ -804,7 +821,7 @@ bool UI::Initialize(GLFWwindow* window)
     auto loadFont = [&](const char* path, float size) -> ImFont* {
         if (std::filesystem::exists(path))
             return io.Fonts->AddFontFromFileTTF(path, size, &font_config);
-        std::cerr << "[UI] Warning: Font not found: " << path << ", using default\n";
+        LOG_WARN(UI, "[UI] Warning: Font not found: " << path << ", using default");
         return io.Fonts->AddFontDefault(&font_config);
     };
 
@@ -853,13 +870,13 @@ bool UI::Initialize(GLFWwindow* window)
 
     if (!ImGui_ImplGlfw_InitForOpenGL(window, true))
     {
-        std::cerr << "[UI] Error: Failed to init GLFW backend\n";
+        LOG_ERROR(UI, "[UI] Error: Failed to init GLFW backend");
         return false;
     }
     
     if (!ImGui_ImplOpenGL3_Init("#version 330"))
     {
-        std::cerr << "[UI] Error: Failed to init OpenGL3 backend\n";
+        LOG_ERROR(UI, "[UI] Error: Failed to init OpenGL3 backend");
         return false;
     }
 
@@ -876,7 +893,7 @@ bool UI::Initialize(GLFWwindow* window)
     m_ui_elements = new UIElements();
     if (!m_ui_elements->initialize())
     {
-        std::cerr << "[UI] Error: Failed to initialize UI Elements\n";
+        LOG_ERROR(UI, "[UI] Error: Failed to initialize UI Elements");
         delete m_ui_elements;
         m_ui_elements = nullptr;
         return false;
@@ -890,7 +907,7 @@ bool UI::Initialize(GLFWwindow* window)
     m_ui_elements->setFontJetBrainsMono(m_fontJetBrainsMono);
     m_ui_elements->setCompassTexture(m_compassTexture);
     
-    std::cout << "[UI] Initialized successfully\n";
+    LOG_INFO(UI, "[UI] Initialized successfully");
     return true;
 }
 
@@ -957,7 +974,7 @@ void UI::BeginFrame()
         else
         {
             // If user cancels, do not save.
-            std::cout << "[UI] Save cancelled by user." << std::endl;
+            LOG_INFO(UI, "[UI] Save cancelled by user.");
             TelemetryTrackBuilder::Stop(true);
             return;
         }
@@ -965,12 +982,12 @@ void UI::BeginFrame()
         // If user cancels, save to default name so we don't lose the created track.
         if (!TelemetryTrackBuilder::SaveFinalizedAsTxt(chosen))
         {
-            std::cerr << "[UI] Failed to save finalized track." << std::endl;
+            LOG_ERROR(UI, "[UI] Failed to save finalized track.");
         }
         else
         {
             LoadRecentFiles();
-            std::cout << "[UI] Track saved." << std::endl;
+            LOG_INFO(UI, "[UI] Track saved.");
         }
 
         // After auto-finish flow, switch mode OFF in UI but keep points for final rendering.
@@ -1070,11 +1087,11 @@ void UI::BeginFrame()
                 if (f)
                 {
                     f << g_race_manager->BuildResultsText();
-                    std::cout << "[UI] Results saved to " << ofn.lpstrFile << std::endl;
+                    LOG_INFO(UI, "[UI] Results saved to " << ofn.lpstrFile);
                 }
                 else
                 {
-                    std::cerr << "[UI] Cannot write " << ofn.lpstrFile << std::endl;
+                    LOG_ERROR(UI, "[UI] Cannot write " << ofn.lpstrFile);
                 }
             }
         }
@@ -1096,7 +1113,7 @@ void UI::BeginFrame()
             if (reinterpret_cast<INT_PTR>(r) <= 32)
                 ShellExecuteA(nullptr, "open", path.c_str(),
                               nullptr, nullptr, SW_SHOWNORMAL);
-            std::cout << "[UI] Results sent to print: " << path << std::endl;
+            LOG_INFO(UI, "[UI] Results sent to print: " << path);
         }
 
         // Track creation hotkey: Space finalizes an OPEN track (manual finish).
@@ -1126,13 +1143,13 @@ void UI::BeginFrame()
 
             if (!TelemetryTrackBuilder::FinalizeOpenAndSaveTxt(chosen))
             {
-                std::cerr << "[UI] Failed to finalize/save open track." << std::endl;
+                LOG_ERROR(UI, "[UI] Failed to finalize/save open track.");
             }
             else
             {
                 // Refresh recent files list so the new track appears in splash/recents.
                 LoadRecentFiles();
-                std::cout << "[UI] Track saved." << std::endl;
+                LOG_INFO(UI, "[UI] Track saved.");
             }
 
             // Manual finish => turn mode OFF.
@@ -1314,7 +1331,7 @@ void UI::Render()
         int trackedVehicleId = g_focused_vehicle_id;
         if (trackedVehicleId == -1)
         {
-            auto standings = g_race_manager->GetStandings();
+            const auto& standings = RaceSnapshot::Current().standings;
             if (!standings.empty())
                 trackedVehicleId = standings[0].vehicleID;
         }
@@ -1339,6 +1356,7 @@ void UI::Render()
     RenderPrototypeToast();
     RenderNetworkingModal();
     AccountsPanel::Render(m_fontUI, m_fontUBold);
+    LatencyPanel::Render(m_fontRegular);
     RenderAutoStopModal();
 
     // Render help modal if open
@@ -1570,7 +1588,7 @@ void UI::RenderSplashWindow()
         {
             m_showSplash = false;
             m_closeSplash = true;
-            std::cout << "[UI] Splash closed by clicking outside\n";
+            LOG_INFO(UI, "[UI] Splash closed by clicking outside");
             return;
         }
     }
@@ -1723,7 +1741,7 @@ void UI::RenderMainWindow()
 	if (ImGui::Button("Create Track", ImVec2(buttonW, buttonH)))
 	{
 		TelemetryTrackBuilder::StartLeftEdge();
-		std::cout << "[UI] Dual-edge recording started — drive the LEFT edge.\n";
+		LOG_INFO(UI, "[UI] Dual-edge recording started — drive the LEFT edge.");
 		m_showSplash = false;
 		m_closeSplash = true;
 	}
@@ -1866,7 +1884,7 @@ void UI::RenderMainWindow()
 
 		if (rowClicked)
 		{
-            std::cout << "[UI] Opening: " << m_recentFiles[i].path << "\n";
+            LOG_INFO(UI, "[UI] Opening: " << m_recentFiles[i].path);
             
             // Load file
             applyTrackFile(m_recentFiles[i].path, m_points, m_pointsMutex);
@@ -1927,10 +1945,10 @@ void UI::RenderMainWindow()
         if (clicked) onClick();
     };
 
-    barItem(windowSize.x * (14.0f  / 557.0f), "##contact", m_iconContact,   "Contact Us",     windowSize.x * (110.0f / 557.0f), [&]{ std::cout << "[UI] Contact Us\n"; });
+    barItem(windowSize.x * (14.0f  / 557.0f), "##contact", m_iconContact,   "Contact Us",     windowSize.x * (110.0f / 557.0f), [&]{ LOG_INFO(UI, "[UI] Contact Us"); });
     barItem(windowSize.x * (148.0f / 557.0f), "##copy",    m_iconCopyright, "RAJAGP",          0.0f,                             [&]{ });
-    barItem(windowSize.x * (293.0f / 557.0f), "##donate",  m_iconHeart,     "Donate to Us",   windowSize.x * (110.0f / 557.0f), [&]{ std::cout << "[UI] Donate\n"; });
-    barItem(windowSize.x * (430.0f / 557.0f), "##close",   m_iconClose,     "Close App",      windowSize.x * (110.0f / 557.0f), [&]{ std::cout << "[UI] Close App\n"; glfwSetWindowShouldClose(m_window, true); });
+    barItem(windowSize.x * (293.0f / 557.0f), "##donate",  m_iconHeart,     "Donate to Us",   windowSize.x * (110.0f / 557.0f), [&]{ LOG_INFO(UI, "[UI] Donate"); });
+    barItem(windowSize.x * (430.0f / 557.0f), "##close",   m_iconClose,     "Close App",      windowSize.x * (110.0f / 557.0f), [&]{ LOG_INFO(UI, "[UI] Close App"); glfwSetWindowShouldClose(m_window, true); });
 
     if (m_fontRegular) ImGui::PopFont();
 
@@ -2185,7 +2203,7 @@ void UI::RenderTopMenu()
             if (ImGui::MenuItem("Open...", "Ctrl+O"))
             {
                 // Open native Windows file dialog in Saves folder
-                std::cout << "[UI] Opening file dialog in Saves folder..." << std::endl;
+                LOG_INFO(UI, "[UI] Opening file dialog in Saves folder...");
                 
                 OPENFILENAMEA ofn = {};
                 char szFile[260] = {0};
@@ -2262,7 +2280,7 @@ void UI::RenderTopMenu()
                         p.lat = static_cast<int32_t>(lat * 1e7);
                         p.lon = static_cast<int32_t>(lon * 1e7);
                         p.time = t;
-                        processIncomingTelemetry(p);
+                        TelemetryIngest::pushTelemetry(p);
                         t += 16;
                         std::this_thread::sleep_for(std::chrono::milliseconds(1));
                     }
@@ -2277,7 +2295,7 @@ void UI::RenderTopMenu()
                         p.lat = static_cast<int32_t>(lat * 1e7);
                         p.lon = static_cast<int32_t>(lon * 1e7);
                         p.time = t;
-                        processIncomingTelemetry(p);
+                        TelemetryIngest::pushTelemetry(p);
                         t += 16;
                         std::this_thread::sleep_for(std::chrono::milliseconds(1));
                     }
@@ -2319,7 +2337,7 @@ void UI::RenderTopMenu()
                                     p.lat = (int32_t)(lat * 1e7);
                                     p.lon = (int32_t)(lon * 1e7);
                                     p.time = t; t += 8;
-                                    processIncomingTelemetry(p);
+                                    TelemetryIngest::pushTelemetry(p);
                                     std::this_thread::sleep_for(std::chrono::milliseconds(8));
                                 }
                             };
@@ -2342,7 +2360,7 @@ void UI::RenderTopMenu()
             ImGui::Separator();
 
             if (ImGui::MenuItem("Save Results", "Ctrl+P", false, true)) {
-                std::cout << "[UI] Menu: Save Results triggered." << std::endl;
+                LOG_INFO(UI, "[UI] Menu: Save Results triggered.");
             }
             ImGui::Separator();
             if (ImGui::MenuItem("Exit", "Alt+F4", false, true)) {
@@ -2362,7 +2380,14 @@ void UI::RenderTopMenu()
                 startComPortAutoDiscovery();
 
                 const std::string selected = getSelectedComPort();
-                std::string label = "SELECTED COM PORT: (" + (selected.empty() ? std::string("<none>") : selected) + ")";
+                const std::vector<std::string> openPorts = getOpenComPorts();
+                const std::vector<std::string> failedPorts = getFailedComPorts();
+                std::string portList;
+                for (const auto& port : openPorts)
+                    portList += (portList.empty() ? "" : ", ") + port;
+                for (const auto& port : failedPorts)
+                    portList += (portList.empty() ? "" : ", ") + port + " failed";
+                std::string label = "SELECTED COM PORT: (" + (portList.empty() ? std::string("<none>") : portList) + ")";
 
                 // A hoverable row with a submenu on the right (like in the reference screenshot)
                 if (ImGui::BeginMenu(label.c_str()))
@@ -2378,12 +2403,54 @@ void UI::RenderTopMenu()
                     {
                         for (const auto& p : ports)
                         {
-                            const bool isSelected = (!selected.empty() && p.port == selected);
+                            const bool isSelected = (!selected.empty() && p.port == selected &&
+                                std::find(failedPorts.begin(), failedPorts.end(), p.port) == failedPorts.end());
                             if (ImGui::MenuItem(p.description.c_str(), nullptr, isSelected))
                             {
                                 selectAndOpenComPort(p.port);
                             }
                         }
+
+                        // Extra gateways, merged with the selected one
+                        if (!openPorts.empty() && ImGui::BeginMenu("Additional receivers"))
+                        {
+                            for (const auto& p : ports)
+                            {
+                                if (p.port == selected)
+                                    continue;
+                                const bool isOpen = std::find(openPorts.begin(), openPorts.end(), p.port) != openPorts.end();
+                                if (ImGui::MenuItem(p.description.c_str(), nullptr, isOpen))
+                                {
+                                    if (isOpen)
+                                        removeComPort(p.port);
+                                    else
+                                        addComPort(p.port);
+                                }
+                            }
+                            ImGui::EndMenu();
+                        }
+                    }
+
+                    // Ports that would not open (in use, unplugged): pick them again to retry
+                    if (!failedPorts.empty())
+                    {
+                        ImGui::Separator();
+                        for (const auto& port : failedPorts)
+                            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s: could not open", port.c_str());
+                    }
+
+                    // Reception per gateway — coverage and frames only it heard
+                    if (openPorts.size() > 1)
+                    {
+                        ImGui::Separator();
+                        for (const GatewayInfo& g : getGatewayStats())
+                        {
+                            ImGui::TextDisabled("%s  %.1f%% coverage  %llu first  %llu exclusive  %llu bad",
+                                g.port.c_str(), g.coverage_pct,
+                                (unsigned long long)g.firsts,
+                                (unsigned long long)g.exclusive,
+                                (unsigned long long)g.frames_bad);
+                        }
                     }
                     ImGui::EndMenu();
                 }
@@ -2433,13 +2500,11 @@ void UI::RenderTopMenu()
                 g_focused_vehicle_id = -1;
                 g_is_map_loaded = false;
                 g_track_render_offset = glm::vec2(0.0f, 0.0f);
-                g_map_origin.m_origin_lat_dd = 0.0;
-                g_map_origin.m_origin_lon_dd = 0.0;
-                g_map_origin.m_origin_meters_easting = 0.0;
-                g_map_origin.m_origin_meters_northing = 0.0;
-                g_map_origin.m_origin_zone_int = 0;
-                g_map_origin.m_origin_zone_char = 0;
-                g_map_origin.m_map_size = MapConstants::MAP_SIZE;
+                {
+                    MapOrigin origin{};
+                    origin.m_map_size = MapConstants::MAP_SIZE;
+                    TrackGeometry::PublishOrigin(origin);
+                }
 
                 if (m_points && m_pointsMutex)
                 {
@@ -2456,6 +2521,8 @@ void UI::RenderTopMenu()
             ImGui::Separator();
            ImGui::MenuItem("Prototype panel", nullptr, &m_allowPrototypeToast);
             ImGui::MenuItem("Vehicle names", nullptr, &g_show_vehicle_names);
+            if (ImGui::MenuItem("Telemetry latency", nullptr, LatencyPanel::IsOpen()))
+                LatencyPanel::Toggle();
             if (ImGui::MenuItem("Toggle Fullscreen", "F11", false, false)) {}
             if (m_proMode) {
                 ImGui::Separator();
@@ -2608,7 +2675,7 @@ void UI::RenderBottomMenu()
     // Server, also frame loss % and delay (computed from seq/server_time_ms).
     {
         const uint32_t pps = telemetryGetPacketsPerSecond();
-        char pps_text[96];
+        char pps_text[160];
         if (TrackServerClient::isConnected()) {
             const float loss  = TrackServerClient::netLossPercent();
             const int   delay = TrackServerClient::netDelayMs();
@@ -2618,6 +2685,15 @@ void UI::RenderBottomMenu()
         } else {
             snprintf(pps_text, sizeof(pps_text), "PPS: %u", (unsigned)pps);
         }
+
+        // Ingest backpressure: only shown once the queue has dropped records.
+        const TelemetryIngest::Stats ingest = TelemetryIngest::stats();
+        if (ingest.dropped > 0) {
+            const size_t len = strlen(pps_text);
+            snprintf(pps_text + len, sizeof(pps_text) - len,
+                     "   Dropped: %llu (queue peak %zu/%zu)",
+                     (unsigned long long)ingest.dropped, ingest.highWater, ingest.capacity);
+        }
         ImGui::SetCursorPosX(10);
         ImGui::SetCursorPosY(3);
         ImGui::TextUnformatted(pps_text);
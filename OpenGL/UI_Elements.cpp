@@ -4,6 +4,8 @@
 #include "src/input/Input.h"
 #include "src/rendering/Interpolation.h"  // For SplinePoint
 #include "src/racing/RaceManager.h"  // For RaceManager and VehicleStanding
+#include "src/racing/RaceSnapshot.h"  // Per-frame standings, colours and names
+#include "src/racing/SessionStats.h"  // Sector marks, fastest lap and top speed
 #include <cmath>
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
@@ -524,10 +526,15 @@ void UIElements::drawLeaderboard()
     if (!g_race_manager)
         return;
 
-    std::vector<VehicleStanding> standings = g_race_manager->GetStandings();
+    // Published once per frame by RaceManager::PublishSnapshot — no lock here
+    const RaceFrame& frame = RaceSnapshot::Current();
+    const std::vector<VehicleStanding>& standings = frame.standings;
     if (standings.empty())
         return;
 
+    // Bests and marks, updated once per completed lap — no scan here
+    const SessionStats::TablePtr stats = SessionStats::Current();
+
     ImGuiIO& io = ImGui::GetIO();
     ImVec2 display_size = io.DisplaySize;
 
@@ -572,6 +579,8 @@ void UIElements::drawLeaderboard()
     const ImU32 col_focus_bg   = IM_COL32(0x2B, 0x2B, 0x2B, 255);
     const ImU32 col_lapped     = IM_COL32(0xF3, 0xCE, 0x87, 255);
     const ImU32 col_lap_accent = IM_COL32(0x18, 0x18, 0x18, 255);
+    const ImU32 col_purple     = IM_COL32(0xBB, 0x8E, 0xF9, 255); // session best
+    const ImU32 col_green      = IM_COL32(0x6E, 0xF9, 0x8E, 255); // personal best
 
     // Font sizes (all driven by ui_scale for consistent proportions)
     const float fs_header = 26.0f * ui_scale; // "Current Lap X"
@@ -689,6 +698,8 @@ void UIElements::drawLeaderboard()
         float div1x = panel_x + col_pos;
         float div2x = div1x + col_driver;
 
+        const SessionStats::VehicleStats* vs = stats->Find(s.vehicleID);
+
         // --- POS ---
         {
             char pos_buf[8];
@@ -696,33 +707,34 @@ void UIElements::drawLeaderboard()
             ImU32 pos_col = is_focused ? col_gold : col_text;
             drawCenteredText(font_pos, fs_data, pos_col,
                              panel_x, ry, col_pos, row_h, pos_buf);
+
+            // Fastest lap of the session: purple dot
+            if (stats->bestLapHolder == s.vehicleID)
+                dl->AddCircleFilled(ImVec2(div1x - 7.0f * ui_scale, ry + 7.0f * ui_scale),
+                                    3.5f * ui_scale, col_purple);
         }
 
         // --- DRIVER: color bar + name ---
         {
             // Get vehicle color from standings vehicleID
-            extern std::map<int32_t, Vehicle> g_vehicles;
-            extern std::mutex g_vehicles_mutex;
-
             glm::vec3 veh_color(0.5f, 0.5f, 0.5f);
-            std::string driver_name = "???";
+            char driver_name[8] = "???";
+            const int vi = frame.Find(s.vehicleID);
+            if (vi >= 0)
             {
-                std::lock_guard<std::mutex> lk(g_vehicles_mutex);
-                auto it = g_vehicles.find(s.vehicleID);
-                if (it != g_vehicles.end())
+                veh_color = frame.color[vi];
+                // First 4 chars of name uppercase (or "CN")
+                const std::string& full = frame.names[vi];
+                if (full == "Unknown" || full.empty())
                 {
-                    veh_color = it->second.getColor();
-                    // First 3 chars of name (or "CAR N")
-                    std::string full = it->second.name;
-                    if (full == "Unknown" || full.empty())
-                    {
-                        char nb[8];
-                        snprintf(nb, sizeof(nb), "C%d", s.vehicleID);
-                        full = nb;
-                    }
-                    // Take first 4 chars uppercase
-                    driver_name = full.substr(0, 4);
-                    for (char& c : driver_name) c = static_cast<char>(toupper(c));
+                    snprintf(driver_name, sizeof(driver_name), "C%d", s.vehicleID);
+                }
+                else
+                {
+                    size_t n = 0;
+                    for (; n < 4 && n < full.size(); ++n)
+                        driver_name[n] = static_cast<char>(toupper(static_cast<unsigned char>(full[n])));
+                    driver_name[n] = '\0';
                 }
             }
 
@@ -741,12 +753,36 @@ void UIElements::drawLeaderboard()
 
             // Driver name centered in remaining space between bar and div2x
             ImU32 name_col = is_focused ? col_gold : col_text;
-            ImVec2 name_ts = font_data->CalcTextSizeA(fs_data, FLT_MAX, 0.0f, driver_name.c_str());
+            ImVec2 name_ts = font_data->CalcTextSizeA(fs_data, FLT_MAX, 0.0f, driver_name);
             float text_zone_x = bar_x + bar_w + 3.0f * ui_scale;
             float text_zone_w = div2x - text_zone_x;
             float name_x = text_zone_x + (text_zone_w - name_ts.x) * 0.5f;
             float name_y = ry + (row_h - name_ts.y) * 0.5f;
-            dl->AddText(font_data, fs_data, ImVec2(name_x, name_y), name_col, driver_name.c_str());
+            dl->AddText(font_data, fs_data, ImVec2(name_x, name_y), name_col, driver_name);
+
+            // Last lap's sectors: purple / green / yellow strip under the name
+            if (vs && stats->sectorCount > 0)
+            {
+                const int   n     = stats->sectorCount;
+                const float gap   = 2.0f * ui_scale;
+                const float x0    = text_zone_x;
+                const float w     = (div2x - 4.0f * ui_scale - x0 - gap * (n - 1)) / n;
+                const float y0    = ry + row_h - 5.0f * ui_scale;
+                const float y1    = y0 + 2.5f * ui_scale;
+                for (int k = 0; k < n; ++k)
+                {
+                    ImU32 mark_col = col_divider;
+                    switch (vs->lastSectorMark[k])
+                    {
+                    case SessionStats::Mark::Purple: mark_col = col_purple; break;
+                    case SessionStats::Mark::Green:  mark_col = col_green;  break;
+                    case SessionStats::Mark::Yellow: mark_col = col_gold;   break;
+                    default: break;
+                    }
+                    const float sx = x0 + k * (w + gap);
+                    dl->AddRectFilled(ImVec2(sx, y0), ImVec2(sx + w, y1), mark_col);
+                }
+            }
         }
 
         // --- TIME/GAP ---
@@ -789,6 +825,18 @@ void UIElements::drawLeaderboard()
 
             drawCenteredText(font_data, fs_data, gap_col,
                              div2x, ry, col_gap, row_h, gap_buf);
+
+            // Holder of a session-best speed trap: purple corner tick
+            bool trap_best = false;
+            for (int t = 0; t < SessionStats::MAX_TRAPS && !trap_best; ++t)
+                trap_best = (stats->bestTrapKph[t] >= 0.0f && stats->bestTrapHolder[t] == s.vehicleID);
+            if (trap_best)
+            {
+                const float tx = div2x + col_gap - 4.0f * ui_scale;
+                const float ty = ry + 4.0f * ui_scale;
+                const float ts = 7.0f * ui_scale;
+                dl->AddTriangleFilled(ImVec2(tx - ts, ty), ImVec2(tx, ty), ImVec2(tx, ty + ts), col_purple);
+            }
         }
     }
 
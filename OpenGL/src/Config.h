@@ -3,6 +3,7 @@
 // Map and coordinate system constants
 namespace MapConstants {
     static constexpr double MAP_SIZE = 100.0; // 100 meters = 1.0 in OpenGL coordinates
+    static constexpr double LOCAL_PROJECTION_RADIUS_M = 10000.0; // GPS->UTM fast path around the origin (GeographicLib beyond)
     static constexpr float MAP_BOUND_X = 2.0f;
     static constexpr float MAP_BOUND_Y = 2.0f;
 }
@@ -133,6 +134,21 @@ struct Trk2FileHeader {
     uint32_t left_count;
     uint32_t right_count;
 };
+
+// Optional block after the edges (files without it simply end there):
+// Trk2TimingHeader | count * Trk2TimingLine, in the edges' coordinates.
+struct Trk2TimingHeader {
+    char     magic[4];          // 'T','L','N','1'
+    uint32_t count;
+};
+
+struct Trk2TimingLine {
+    uint8_t  kind;              // TrackGeometry::TimingLine::Kind
+    uint8_t  pad[3];
+    float    p1x, p1y;
+    float    p2x, p2y;
+    char     name[16];          // NUL-padded
+};
 #pragma pack(pop)
 
 // Grid rendering constants
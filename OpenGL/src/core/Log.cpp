@@ -0,0 +1,357 @@
+#include "Log.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+#include "../network/MpscQueue.h"
+
+namespace Log {
+
+namespace detail {
+    std::atomic<uint8_t> g_levels[static_cast<size_t>(Category::Count)] = {
+        {2}, {2}, {2}, {2}, {2}, {2}, {2}, {2}, {2}, {2}
+    };
+    static_assert(static_cast<size_t>(Category::Count) == 10, "update g_levels initializer");
+}
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Records
+// ---------------------------------------------------------------------------
+struct Entry {
+    int64_t timeUs = 0;          // system_clock, microseconds
+    Category category = Category::General;
+    Level level = Level::Info;
+    uint16_t length = 0;
+    char text[kMaxText];
+};
+
+// Streams straight into an Entry's text; extra characters are discarded.
+class FixedBuf : public std::streambuf {
+public:
+    void reset(char* begin, size_t size) { setp(begin, begin + size); }
+    size_t size() const { return static_cast<size_t>(pptr() - pbase()); }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        return traits_type::eq_int_type(ch, traits_type::eof()) ? traits_type::not_eof(ch) : ch;
+    }
+};
+
+// Two slots so a record formatted while another is being built on the same
+// thread (a logging call inside a streamed expression) still works.
+constexpr int kSlotsPerThread = 2;
+
+struct Slot {
+    Entry entry;
+    FixedBuf buf;
+    std::ostream os{ &buf };
+};
+
+struct ThreadSlots {
+    Slot slots[kSlotsPerThread];
+    int depth = 0;
+};
+
+thread_local ThreadSlots t_slots;
+
+// ~1000 records between two writer passes; queue memory is ~0.5 MB.
+constexpr size_t kQueueCapacity = 1024;
+
+MpscQueue<Entry>& queue()
+{
+    static MpscQueue<Entry> s_queue(kQueueCapacity);
+    return s_queue;
+}
+
+std::atomic<bool> g_running{ false };
+std::atomic<bool> g_stop_requested{ false };
+std::thread g_thread;
+std::mutex g_thread_mutex;
+std::mutex g_sync_mutex;     // Synchronous writes (writer not running)
+
+// ---------------------------------------------------------------------------
+// Formatting (writer thread, or caller when synchronous)
+// ---------------------------------------------------------------------------
+const char* levelName(Level level)
+{
+    switch (level) {
+    case Level::Trace: return "TRACE";
+    case Level::Debug: return "DEBUG";
+    case Level::Info:  return "INFO ";
+    case Level::Warn:  return "WARN ";
+    case Level::Error: return "ERROR";
+    default:           return "     ";
+    }
+}
+
+void appendEntry(std::string& out, const Entry& e)
+{
+    const std::time_t seconds = static_cast<std::time_t>(e.timeUs / 1000000);
+    const int millis = static_cast<int>((e.timeUs / 1000) % 1000);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &seconds);
+#else
+    localtime_r(&seconds, &tm);
+#endif
+    char prefix[32];
+    std::snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%03d %s ",
+                  tm.tm_hour, tm.tm_min, tm.tm_sec, millis, levelName(e.level));
+    out += prefix;
+
+    // Call sites used to frame messages with "\n"; the record is one line.
+    const char* begin = e.text;
+    const char* end = e.text + e.length;
+    while (begin < end && (*begin == '\n' || *begin == '\r')) ++begin;
+    while (end > begin && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ')) --end;
+    out.append(begin, end);
+    out += '\n';
+}
+
+std::ostream& streamFor(Level level)
+{
+    return level >= Level::Warn ? std::cerr : std::cout;
+}
+
+void writeSync(const Entry& e)
+{
+    std::string line;
+    appendEntry(line, e);
+    std::lock_guard<std::mutex> lock(g_sync_mutex);
+    std::ostream& os = streamFor(e.level);
+    os.write(line.data(), static_cast<std::streamsize>(line.size()));
+    os.flush();
+}
+
+void submit(const Entry& e)
+{
+    if (g_running.load(std::memory_order_acquire)) {
+        queue().TryPush(e);          // Full: dropped and counted by the queue
+        return;
+    }
+    writeSync(e);
+}
+
+// ---------------------------------------------------------------------------
+// Writer thread
+// ---------------------------------------------------------------------------
+void runWriter()
+{
+    std::string out;
+    out.reserve(64 * 1024);
+    uint64_t reportedDrops = 0;
+    auto lastDropReport = std::chrono::steady_clock::now();
+
+    Entry e;
+    auto drain = [&]() {
+        size_t count = 0;
+        bool toErr = false;
+        auto flushOut = [&]() {
+            if (out.empty()) return;
+            std::ostream& os = toErr ? std::cerr : std::cout;
+            os.write(out.data(), static_cast<std::streamsize>(out.size()));
+            os.flush();
+            out.clear();
+        };
+        while (queue().TryPop(e)) {
+            const bool err = e.level >= Level::Warn;
+            if (err != toErr) {
+                flushOut();
+                toErr = err;
+            }
+            appendEntry(out, e);
+            ++count;
+        }
+        flushOut();
+        return count;
+    };
+
+    while (!g_stop_requested.load()) {
+        const size_t written = drain();
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastDropReport >= std::chrono::seconds(1)) {
+            lastDropReport = now;
+            const uint64_t dropped = queue().Dropped();
+            if (dropped != reportedDrops) {
+                std::cerr << "[LOG] queue full: " << (dropped - reportedDrops) << " records dropped" << std::endl;
+                reportedDrops = dropped;
+            }
+        }
+
+        if (written == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    drain();
+}
+
+// ---------------------------------------------------------------------------
+// BONI_LOG="info,telemetry=trace,race=debug"
+// ---------------------------------------------------------------------------
+const char* const kCategoryNames[] = {
+    "general", "telemetry", "network", "serial", "track",
+    "vehicle", "race", "render", "ui", "sim"
+};
+static_assert(sizeof(kCategoryNames) / sizeof(kCategoryNames[0]) == static_cast<size_t>(Category::Count),
+              "kCategoryNames must match Log::Category");
+
+bool parseLevel(const std::string& s, Level& out)
+{
+    static const char* const names[] = { "trace", "debug", "info", "warn", "error", "off" };
+    for (int i = 0; i < 6; ++i) {
+        if (s == names[i]) {
+            out = static_cast<Level>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void applyEnvironment()
+{
+    std::string spec;
+#ifdef _WIN32
+    char* value = nullptr;
+    size_t len = 0;
+    if (_dupenv_s(&value, &len, "BONI_LOG") == 0 && value) {
+        spec = value;
+        std::free(value);
+    }
+#else
+    if (const char* value = std::getenv("BONI_LOG"))
+        spec = value;
+#endif
+    for (char& c : spec) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    size_t pos = 0;
+    while (pos < spec.size()) {
+        size_t comma = spec.find(',', pos);
+        if (comma == std::string::npos) comma = spec.size();
+        const std::string item = spec.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        const size_t eq = item.find('=');
+        Level level;
+        if (eq == std::string::npos) {
+            if (parseLevel(item, level)) SetLevel(level);
+            continue;
+        }
+        if (!parseLevel(item.substr(eq + 1), level)) continue;
+        const std::string name = item.substr(0, eq);
+        for (size_t c = 0; c < static_cast<size_t>(Category::Count); ++c) {
+            if (name == kCategoryNames[c])
+                SetLevel(static_cast<Category>(c), level);
+        }
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+void Start()
+{
+    std::lock_guard<std::mutex> lock(g_thread_mutex);
+    if (g_running.load()) return;
+    applyEnvironment();
+    g_stop_requested.store(false);
+    // Construct the queue before registering Stop with atexit: statics are
+    // destroyed in reverse order, so it then outlives the final drain.
+    queue();
+    g_thread = std::thread(runWriter);
+    g_running.store(true, std::memory_order_release);
+
+    // Early returns from main() and exit() still drain and join the writer.
+    static const bool s_at_exit = (std::atexit([] { Stop(); }) == 0);
+    (void)s_at_exit;
+}
+
+void Stop()
+{
+    std::lock_guard<std::mutex> lock(g_thread_mutex);
+    if (!g_running.load()) return;
+    // Later records are written synchronously; the writer drains the rest.
+    g_running.store(false, std::memory_order_release);
+    g_stop_requested.store(true);
+    if (g_thread.joinable()) g_thread.join();
+}
+
+void SetLevel(Level level)
+{
+    for (auto& l : detail::g_levels)
+        l.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+void SetLevel(Category category, Level level)
+{
+    detail::g_levels[static_cast<size_t>(category)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+Level GetLevel(Category category)
+{
+    return static_cast<Level>(detail::g_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed));
+}
+
+uint64_t Dropped()
+{
+    return queue().Dropped();
+}
+
+Record::Record(Category category, Level level)
+    : m_category(category)
+    , m_level(level)
+{
+    ThreadSlots& ts = t_slots;
+    if (ts.depth >= kSlotsPerThread) {
+        ++ts.depth;                      // Too deep: this record is discarded
+        return;
+    }
+    Slot& slot = ts.slots[ts.depth++];
+    slot.buf.reset(slot.entry.text, kMaxText);
+    slot.os.clear();
+    slot.os.flags(std::ios::dec | std::ios::skipws);
+    slot.os.precision(6);
+    slot.os.width(0);
+    slot.os.fill(' ');
+}
+
+Record::~Record()
+{
+    ThreadSlots& ts = t_slots;
+    const int index = --ts.depth;
+    if (index >= kSlotsPerThread)
+        return;
+
+    Slot& slot = ts.slots[index];
+    Entry& e = slot.entry;
+    e.category = m_category;
+    e.level = m_level;
+    e.length = static_cast<uint16_t>(slot.buf.size());
+    e.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    submit(e);
+}
+
+std::ostream& Record::stream()
+{
+    ThreadSlots& ts = t_slots;
+    static thread_local std::ostream s_null(nullptr);   // Discards everything
+    if (ts.depth > kSlotsPerThread)
+        return s_null;
+    return ts.slots[ts.depth - 1].os;
+}
+
+} // namespace Log
@@ -0,0 +1,126 @@
+#pragma once
+
+// ============================================================================
+// Log — asynchronous, level-filtered logger.
+//
+//   LOG_INFO(Telemetry, "[TELEMETRY] Vehicle #" << id << " created");
+//   LOG_DEBUG_EVERY_N(Race, 120, "[S/F DEBUG] veh#" << id);
+//
+// A record costs nothing below the compile-time level (LOG_COMPILE_LEVEL,
+// Debug in debug builds, Info in release) and one atomic load below the
+// run-time level of its category. An enabled record is streamed into a
+// fixed per-thread buffer (no allocation, truncated at kMaxText) and pushed
+// onto a lock-free queue; the writer thread adds the timestamp and level
+// and does the slow console writes. When the queue is full the record is
+// dropped and counted, never blocking the caller.
+//
+// Run-time levels default to Info and can be set with Log::SetLevel or the
+// BONI_LOG environment variable, e.g. "debug" or "info,telemetry=trace".
+// Before Start() and after Stop() records are written synchronously; Start()
+// registers Stop() with atexit so queued records are not lost on exit.
+// ============================================================================
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace Log {
+
+enum class Level : uint8_t { Trace = 0, Debug, Info, Warn, Error, Off };
+
+enum class Category : uint8_t {
+    General = 0,
+    Telemetry,   // GPS telemetry pipeline, ingest
+    Network,     // Track Server client, sockets
+    Serial,      // ESP32 / COM port
+    Track,       // Track loading, geometry, projection
+    Vehicle,
+    Race,        // Lap timing, session
+    Render,
+    UI,
+    Sim,         // Simulated vehicles
+    Count
+};
+
+// Longest message kept per record; longer text is cut.
+constexpr size_t kMaxText = 480;
+
+void Start();
+void Stop();
+
+void SetLevel(Level level);                      // All categories
+void SetLevel(Category category, Level level);
+Level GetLevel(Category category);
+
+uint64_t Dropped();
+
+namespace detail {
+    extern std::atomic<uint8_t> g_levels[static_cast<size_t>(Category::Count)];
+}
+
+inline bool Enabled(Category category, Level level)
+{
+    return static_cast<uint8_t>(level) >=
+        detail::g_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+// One record: stream into it, submitted when it goes out of scope.
+class Record {
+public:
+    Record(Category category, Level level);
+    ~Record();
+    Record(const Record&) = delete;
+    Record& operator=(const Record&) = delete;
+
+    std::ostream& stream();
+
+private:
+    Category m_category;
+    Level m_level;
+};
+
+} // namespace Log
+
+#ifndef LOG_COMPILE_LEVEL
+#  ifdef NDEBUG
+#    define LOG_COMPILE_LEVEL 2   // Info
+#  else
+#    define LOG_COMPILE_LEVEL 1   // Debug
+#  endif
+#endif
+
+#define LOG_AT(cat, lvl, ...)                                                          \
+    do {                                                                               \
+        if constexpr (static_cast<int>(::Log::Level::lvl) >= LOG_COMPILE_LEVEL) {     \
+            if (::Log::Enabled(::Log::Category::cat, ::Log::Level::lvl)) {            \
+                ::Log::Record log_record_(::Log::Category::cat, ::Log::Level::lvl);   \
+                log_record_.stream() << __VA_ARGS__;                                   \
+            }                                                                          \
+        }                                                                              \
+    } while (0)
+
+// Every n-th call of this call site (the first included) is logged. The
+// counter only advances while the level is enabled.
+#define LOG_EVERY_N(cat, lvl, n, ...)                                                  \
+    do {                                                                               \
+        if constexpr (static_cast<int>(::Log::Level::lvl) >= LOG_COMPILE_LEVEL) {     \
+            if (::Log::Enabled(::Log::Category::cat, ::Log::Level::lvl)) {            \
+                static std::atomic<uint32_t> log_count_{ 0 };                          \
+                if (log_count_.fetch_add(1, std::memory_order_relaxed) % (n) == 0) {   \
+                    ::Log::Record log_record_(::Log::Category::cat, ::Log::Level::lvl); \
+                    log_record_.stream() << __VA_ARGS__;                               \
+                }                                                                      \
+            }                                                                          \
+        }                                                                              \
+    } while (0)
+
+#define LOG_TRACE(cat, ...) LOG_AT(cat, Trace, __VA_ARGS__)
+#define LOG_DEBUG(cat, ...) LOG_AT(cat, Debug, __VA_ARGS__)
+#define LOG_INFO(cat, ...)  LOG_AT(cat, Info,  __VA_ARGS__)
+#define LOG_WARN(cat, ...)  LOG_AT(cat, Warn,  __VA_ARGS__)
+#define LOG_ERROR(cat, ...) LOG_AT(cat, Error, __VA_ARGS__)
+
+#define LOG_DEBUG_EVERY_N(cat, n, ...) LOG_EVERY_N(cat, Debug, n, __VA_ARGS__)
+#define LOG_INFO_EVERY_N(cat, n, ...)  LOG_EVERY_N(cat, Info,  n, __VA_ARGS__)
+#define LOG_WARN_EVERY_N(cat, n, ...)  LOG_EVERY_N(cat, Warn,  n, __VA_ARGS__)
@@ -47,10 +47,15 @@
 #include "../network/TrackServerClient.h"
 #include "../network/ESP32_Code.h"
 #include "../network/SimulationServer.h"
+#include "../network/TelemetryIngest.h"
+#include "../network/TrackServerReplay.h"
 #include "../track/TrackRecorder.h"
+#include "../track/TrackGeometry.h"
 #include "../vehicle/Vehicle.h"
 #include "../racing/RaceManager.h"
+#include "../racing/RaceSnapshot.h"
 #include "../racing/ModeManager/ModeManager.h"
+#include "Log.h"
 
 
 using namespace std;
@@ -103,9 +108,9 @@ const std::vector<glm::vec2>* track_points = nullptr, std::mutex* points_mutex =
 
 		// Guard clauses
 		if (!g_is_map_loaded) {
-			std::cout << "Cannot create vehicle - map not loaded!" << std::endl;
+			LOG_WARN(Sim, "Cannot create vehicle - map not loaded!");
 		} else if (smooth_track->empty()) {
-			std::cout << "Cannot create vehicle - track not interpolated!" << std::endl;
+			LOG_WARN(Sim, "Cannot create vehicle - track not interpolated!");
 		} else {
 			// Generate unique ID for simulation
          int vehicle_id = -1;
@@ -122,12 +127,12 @@ const std::vector<glm::vec2>* track_points = nullptr, std::mutex* points_mutex =
 			}
 			if (vehicle_id == -1)
 			{
-				std::cout << "[SIM] Cannot start simulation - no free race IDs (1-99)" << std::endl;
+				LOG_WARN(Sim, "[SIM] Cannot start simulation - no free race IDs (1-99)");
 			}
 			else
 			{
 
-               std::cout << "[SIM] Starting vehicle #" << vehicle_id << " simulation on track" << std::endl;
+               LOG_INFO(Sim, "[SIM] Starting vehicle #" << vehicle_id << " simulation on track");
 
 			// ✅ DON'T create vehicle here! Let first telemetry packet create it.
 			// This avoids coordinate mismatch between normalized→GPS→normalized roundtrip.
@@ -151,7 +156,7 @@ const std::vector<glm::vec2>* track_points = nullptr, std::mutex* points_mutex =
 
 		if (!g_is_map_loaded)
 		{
-			std::cout << "[TRACK-REC] Cannot test record: map origin not loaded (load a map/track first)." << std::endl;
+			LOG_WARN(Track, "[TRACK-REC] Cannot test record: map origin not loaded (load a map/track first).");
 		}
 		else
 		{
@@ -165,15 +170,16 @@ const std::vector<glm::vec2>* track_points = nullptr, std::mutex* points_mutex =
 			s.minLoopLengthMeters = 100.0f;
 			s.pointsPerSegment = 6;
 			TrackRecorder::Start(kTestVehicleId, s);
-			std::cout << "[TRACK-REC] Test recording started (press Y again when done is not needed; auto closes)." << std::endl;
+			LOG_INFO(Track, "[TRACK-REC] Test recording started (press Y again when done is not needed; auto closes).");
 
 			// Generate telemetry: a circle around origin in UTM meters then convert to lat/lon.
 			std::thread([=]() {
 				using namespace GeographicLib;
-				const bool northp = (g_map_origin.m_origin_zone_char >= 'N');
-				const double baseE = g_map_origin.m_origin_meters_easting;
-				const double baseN = g_map_origin.m_origin_meters_northing;
-				const int zone = g_map_origin.m_origin_zone_int;
+				const MapOrigin origin = TrackGeometry::CurrentOrigin();
+				const bool northp = (origin.m_origin_zone_char >= 'N');
+				const double baseE = origin.m_origin_meters_easting;
+				const double baseN = origin.m_origin_meters_northing;
+				const int zone = origin.m_origin_zone_int;
 
 				TelemetryPacket packet{};
 				packet.MagicMarker = PACKET_MAGIC_DATA;
@@ -198,7 +204,7 @@ const std::vector<glm::vec2>* track_points = nullptr, std::mutex* points_mutex =
 					packet.lat = static_cast<int32_t>(lat * 1e7);
 					packet.lon = static_cast<int32_t>(lon * 1e7);
 					packet.time = t;
-					processIncomingTelemetry(packet);
+					TelemetryIngest::pushTelemetry(packet);
 					t += 16;
 					std::this_thread::sleep_for(std::chrono::milliseconds(1));
 				}
@@ -206,12 +212,12 @@ const std::vector<glm::vec2>* track_points = nullptr, std::mutex* points_mutex =
 				// Try finalize and save.
 				if (TrackRecorder::FinalizeNow())
 				{
-					std::cout << "[TRACK-REC] Finalized. Saving to track_recorded.bin" << std::endl;
-					TrackRecorder::SaveToFile("track_recorded.bin", g_map_origin);
+					LOG_INFO(Track, "[TRACK-REC] Finalized. Saving to track_recorded.bin");
+					TrackRecorder::SaveToFile("track_recorded.bin", TrackGeometry::CurrentOrigin());
 				}
 				else
 				{
-					std::cout << "[TRACK-REC] Not finalized (did not close loop)." << std::endl;
+					LOG_INFO(Track, "[TRACK-REC] Not finalized (did not close loop).");
 				}
 			}).detach();
 		}
@@ -327,18 +333,18 @@ const std::vector<glm::vec2>* track_points = nullptr, std::mutex* points_mutex =
 		if (isWaitingForVehicleId) {
 			// Cancel input mode
 			isWaitingForVehicleId = false;
-			std::cout << "[FOCUS] Vehicle selection cancelled" << std::endl;
+			LOG_INFO(UI, "[FOCUS] Vehicle selection cancelled");
 		}
 		else if (g_focused_vehicle_id != -1) {
 			// Reset to leader
 			g_focused_vehicle_id = -1;
-			std::cout << "[FOCUS] Reset to leader tracking" << std::endl;
+			LOG_INFO(UI, "[FOCUS] Reset to leader tracking");
 		}
 		else {
 			// Start input mode
 			isWaitingForVehicleId = true;
 			focusInputStartTime = glfwGetTime();
-			std::cout << "[FOCUS] Enter vehicle ID (1-9) within 10 seconds..." << std::endl;
+			LOG_INFO(UI, "[FOCUS] Enter vehicle ID (1-9) within 10 seconds...");
 		}
 	}
 	if (glfwGetKey(window, GLFW_KEY_P) == GLFW_RELEASE)
@@ -352,7 +358,7 @@ const std::vector<glm::vec2>* track_points = nullptr, std::mutex* points_mutex =
 		double currentTime = glfwGetTime();
 		if (currentTime - focusInputStartTime > FOCUS_INPUT_TIMEOUT) {
 			isWaitingForVehicleId = false;
-			std::cout << "[FOCUS] Input timeout - cancelled" << std::endl;
+			LOG_INFO(UI, "[FOCUS] Input timeout - cancelled");
 		}
 		else {
 			// Check for number keys 1-9
@@ -365,11 +371,11 @@ const std::vector<glm::vec2>* track_points = nullptr, std::mutex* points_mutex =
 					if (g_vehicles.find(vehicleId) != g_vehicles.end()) {
 						g_focused_vehicle_id = vehicleId;
 						isWaitingForVehicleId = false;
-						std::cout << "[FOCUS] Now tracking Vehicle #" << vehicleId << std::endl;
+						LOG_INFO(UI, "[FOCUS] Now tracking Vehicle #" << vehicleId);
 					}
 					else {
 						isWaitingForVehicleId = false;
-						std::cout << "[FOCUS] Vehicle #" << vehicleId << " does not exist" << std::endl;
+						LOG_INFO(UI, "[FOCUS] Vehicle #" << vehicleId << " does not exist");
 					}
 					break;
 				}
@@ -590,7 +596,9 @@ int main()
 	std::cout << std::endl;
 
 
-	std::cout << "[MAIN] Starting application..." << std::endl;
+	Log::Start();
+
+	LOG_INFO(General, "[MAIN] Starting application...");
 
 #ifdef _WIN32
 	// === OpenGL renderer fallback (Mesa3D) ===
@@ -609,15 +617,15 @@ int main()
 		swprintf(mesaDll, MAX_PATH, L"%s\\opengl32.dll", mesaDir);
 		SetDllDirectoryW(mesaDir);  // let Mesa resolve its own deps (libgallium_wgl, dxil)
 		if (LoadLibraryExW(mesaDll, NULL, LOAD_WITH_ALTERED_SEARCH_PATH))
-			std::cout << "[MAIN] Using bundled Mesa OpenGL renderer" << std::endl;
+			LOG_INFO(General, "[MAIN] Using bundled Mesa OpenGL renderer");
 		else
-			std::cerr << "[MAIN] Warning: failed to load Mesa opengl32.dll (err "
-			          << GetLastError() << ")" << std::endl;
+			LOG_WARN(General, "[MAIN] Warning: failed to load Mesa opengl32.dll (err "
+			          << GetLastError() << ")");
 	}
 #endif
 
 	glfwInit();
-	std::cout << "[MAIN] GLFW initialized" << std::endl;
+	LOG_INFO(General, "[MAIN] GLFW initialized");
 	
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);  // OpenGL 3.3 — widest hardware + Mesa software support
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);	// OpenGL 3.3
@@ -629,22 +637,22 @@ int main()
 	int Width;
 	int Height;
 
-	std::cout << "[MAIN] Getting primary monitor..." << std::endl;
+	LOG_INFO(General, "[MAIN] Getting primary monitor...");
 	GLFWmonitor* monitor = glfwGetPrimaryMonitor();
 	
 	if (!monitor)
 	{
-		std::cerr << "[ERROR] Failed to get primary monitor!" << std::endl;
+		LOG_ERROR(General, "[ERROR] Failed to get primary monitor!");
 		glfwTerminate();
 		return -1;
 	}
 	
-	std::cout << "[MAIN] Getting video mode..." << std::endl;
+	LOG_INFO(General, "[MAIN] Getting video mode...");
 	const GLFWvidmode* mode = glfwGetVideoMode(monitor);
 	
 	if (!mode)
 	{
-		std::cerr << "[ERROR] Failed to get video mode!" << std::endl;
+		LOG_ERROR(General, "[ERROR] Failed to get video mode!");
 		glfwTerminate();
 		return -1;
 	}
@@ -652,27 +660,27 @@ int main()
 	Width = mode->width;
 	Height = mode->height;
 	
-	std::cout << "[MAIN] Screen resolution: " << Width << "x" << Height << std::endl;
+	LOG_INFO(General, "[MAIN] Screen resolution: " << Width << "x" << Height);
 
 	//glfwWindowHint(GLFW_DECORATED, GLFW_FALSE); //Full mode without borders
     // Use NULL for monitor to create a windowed mode (borderless because of GLFW_DECORATED = FALSE)
     // This fixes the black screen issue on capture and cursor visibility
 	glfwWindowHint(GLFW_SAMPLES, 4);
 	
-	std::cout << "[MAIN] Creating window " << Width << "x" << Height << "..." << std::endl;
+	LOG_INFO(General, "[MAIN] Creating window " << Width << "x" << Height << "...");
 	GLFWwindow* window = glfwCreateWindow(Width, Height, UIConfig::APP_NAME, NULL, NULL);
 	
-	std::cout << "[MAIN] Window created, enabling multisampling..." << std::endl;
+	LOG_INFO(General, "[MAIN] Window created, enabling multisampling...");
 	
 	if (window == NULL)
 	{
-		cout << "[ERROR] Failed to create GLFW window" << endl;
+		LOG_ERROR(General, "[ERROR] Failed to create GLFW window");
 #ifdef _WIN32
 		// Native OpenGL couldn't give us a 3.3 context. Relaunch ONCE using the
 		// bundled Mesa renderer (BONI_USE_MESA preloads it before GLFW starts).
 		if (GetEnvironmentVariableA("BONI_USE_MESA", nullptr, 0) == 0)
 		{
-			std::cout << "[MAIN] Native OpenGL unavailable, retrying with Mesa..." << std::endl;
+			LOG_INFO(General, "[MAIN] Native OpenGL unavailable, retrying with Mesa...");
 			glfwTerminate();
 			SetEnvironmentVariableW(L"BONI_USE_MESA", L"1");
 			wchar_t exePath[MAX_PATH];
@@ -686,14 +694,14 @@ int main()
 				CloseHandle(pi.hProcess); CloseHandle(pi.hThread);
 				return (int)code;
 			}
-			std::cerr << "[MAIN] Failed to relaunch with Mesa" << std::endl;
+			LOG_ERROR(General, "[MAIN] Failed to relaunch with Mesa");
 		}
 #endif
 		glfwTerminate();
 		return -1;
 	}
 	
-	std::cout << "[MAIN] Window created successfully" << std::endl;
+	LOG_INFO(General, "[MAIN] Window created successfully");
 
 
 
@@ -711,11 +719,11 @@ int main()
 			icon_image.pixels = icon_pixels;
 			glfwSetWindowIcon(window, 1, &icon_image);
 			stbi_image_free(icon_pixels);
-			std::cout << "[MAIN] Window icon set from styles/images/Icon" << std::endl;
+			LOG_INFO(General, "[MAIN] Window icon set from styles/images/Icon");
 		}
 		else
 		{
-			std::cerr << "[MAIN] Warning: Could not load window icon from styles/images/Icon(.png)" << std::endl;
+			LOG_WARN(General, "[MAIN] Warning: Could not load window icon from styles/images/Icon(.png)");
 		}
 	}
 
@@ -739,34 +747,34 @@ int main()
 
 
 	glfwMakeContextCurrent(window); // Make the window's context in current thread
-	std::cout << "[MAIN] Made context current" << std::endl;
+	LOG_INFO(General, "[MAIN] Made context current");
 	
 	glfwSwapInterval(1);  // Enable V-Sync (lock FPS to monitor refresh rate, e.g. 60 Hz)
-	std::cout << "[MAIN] V-Sync enabled" << std::endl;
+	LOG_INFO(General, "[MAIN] V-Sync enabled");
 	
 	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL); // Show the cursor
-	std::cout << "[MAIN] Cursor mode set" << std::endl;
+	LOG_INFO(General, "[MAIN] Cursor mode set");
 
-	std::cout << "[MAIN] Context created, loading GLAD..." << std::endl;
+	LOG_INFO(General, "[MAIN] Context created, loading GLAD...");
 
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) // Initialize GLAD before calling any OpenGL function
 	{
-		cout << "Failed to initialize GLAD" << endl;
+		LOG_ERROR(General, "Failed to initialize GLAD");
 		return -1;
 	}
 	// Commit
-	std::cout << "[MAIN] GLAD loaded successfully" << std::endl;
+	LOG_INFO(General, "[MAIN] GLAD loaded successfully");
 
 	if (const GLubyte* r = glGetString(GL_RENDERER))
-		std::cout << "[MAIN] GL_RENDERER: " << (const char*)r << std::endl;
+		LOG_INFO(General, "[MAIN] GL_RENDERER: " << (const char*)r);
 	if (const GLubyte* v = glGetString(GL_VERSION))
-		std::cout << "[MAIN] GL_VERSION:  " << (const char*)v << std::endl;
+		LOG_INFO(General, "[MAIN] GL_VERSION:  " << (const char*)v);
 
 	glEnable(GL_MULTISAMPLE);
-	std::cout << "[MAIN] Multisampling enabled" << std::endl;
+	LOG_INFO(General, "[MAIN] Multisampling enabled");
 
 	glViewport(0, 0, Width, Height); // Set the OpenGL viewport to cover the whole window
-	std::cout << "[MAIN] Viewport set" << std::endl;
+	LOG_INFO(General, "[MAIN] Viewport set");
 
 	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 	// Register the callback function to adjust the viewport when the window is resized
@@ -826,17 +834,17 @@ int main()
 
 	// ================= UI Initialization ==================
 
-	std::cout << "[MAIN] Initializing UI..." << std::endl;
+	LOG_INFO(General, "[MAIN] Initializing UI...");
 
 	if (!ui.Initialize(window))
 	{
-		std::cerr << "Failed UI Initialization" << endl;
+		LOG_ERROR(General, "Failed UI Initialization");
 		glfwTerminate();
 		return -1;
 	}
 	g_ui = &ui;
 
-	std::cout << "[MAIN] UI initialized successfully" << std::endl;
+	LOG_INFO(General, "[MAIN] UI initialized successfully");
 
 
 
@@ -859,14 +867,14 @@ int main()
 	if (!success)
 	{
 		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << endl;
+		LOG_ERROR(General, "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog);
 	}
 
 	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
 	if (!success)
 	{
 		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << endl;
+		LOG_ERROR(General, "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog);
 	}
 
 	// =================== Create Shader Program ===================
@@ -908,11 +916,17 @@ int main()
 	std::thread vehicleThread(vehicleLoop);
 	vehicleThread.detach();
 
-	std::cout << "vehicleLoop thread started" << std::endl;
+	LOG_INFO(Vehicle, "vehicleLoop thread started");
+
+	// Single consumer of all telemetry sources (serial, Track Server, simulation)
+	TelemetryIngest::start();
+
+	// BONI_REPLAY / BONI_TRACK_RECORD: local Track Server replay and frame recording
+	TrackServerReplay::applyEnvironment();
 	
 	// ========================== RACE MANAGER INITIALIZATION ==========================
 	g_race_manager = new RaceManager();
-	std::cout << "[MAIN] Race Manager initialized" << std::endl;
+	LOG_INFO(General, "[MAIN] Race Manager initialized");
 
 
 
@@ -978,13 +992,10 @@ int main()
 	GLuint grid_vao, grid_vbo;
 	glGenVertexArrays(1, &grid_vao);
 	glGenBuffers(1, &grid_vbo);
-	std::cout << "Grid VAO/VBO created (VAO: " << grid_vao << ", VBO: " << grid_vbo << ")" << std::endl;
+	LOG_DEBUG(Render, "Grid VAO/VBO created (VAO: " << grid_vao << ", VBO: " << grid_vbo << ")");
 
 	// ========================== RENDER LOOP ==========================
 
-	// Delta time calculation for physics-accurate timing
-	auto lastFrameTime = std::chrono::steady_clock::now();
-
 	while (!glfwWindowShouldClose(window)) // Main loop that runs until the window is closed
 	{
 		// ✅ CRITICAL: Skip rendering when window is minimized/iconified
@@ -999,15 +1010,18 @@ int main()
 		// upload to the GPU here, on the thread that owns the GL context.
 		{
 			std::vector<glm::vec2> ts_left, ts_right;
-			if (TrackServerClient::consumePendingTrack(ts_left, ts_right))
-				TrackRenderer::rebuildTrackCacheFromEdges(ts_left, ts_right);
+			MapOrigin ts_origin{};
+			bool ts_has_origin = false;
+			if (TrackServerClient::consumePendingTrack(ts_left, ts_right, ts_origin, ts_has_origin))
+				TrackRenderer::rebuildTrackCacheFromEdges(ts_left, ts_right, {},
+					ts_has_origin ? &ts_origin : nullptr);
 		}
 
 		// ✅ Build track rendering cache if track was loaded from network
 		// This must be done in main thread because OpenGL context is not thread-safe
 		if (g_is_map_loaded && !TrackRenderer::isTrackCacheValid() && !g_smooth_track_points.empty())
 		{
-			std::cout << "[MAIN] Building track rendering cache in main thread..." << std::endl;
+			LOG_INFO(General, "[MAIN] Building track rendering cache in main thread...");
 
 			// Copy spline points under mutex (network thread can update them during track load)
 			std::vector<SplinePoint> track_copy;
@@ -1019,18 +1033,16 @@ int main()
 			// Build cache directly from received spline points to avoid client-side reprocessing
 			TrackRenderer::rebuildTrackCacheFromSplinePoints(track_copy);
 
-			std::cout << "[MAIN] ✓ Track rendering cache built - track should now be visible!" << std::endl;
+			LOG_INFO(General, "[MAIN] ✓ Track rendering cache built - track should now be visible!");
 		}
 
-		// Calculate delta time
-		auto currentFrameTime = std::chrono::steady_clock::now();
-		float deltaTime = std::chrono::duration<float>(currentFrameTime - lastFrameTime).count();
-		lastFrameTime = currentFrameTime;
-
-		// Update Race Manager (lap timing logic)
+		// Update Race Manager (session state, leader, running lap timers; laps
+		// themselves are timed per fix at ingest), then publish this frame's
+		// race snapshot for the vehicle renderer, leaderboard and PRO panels
 		if (g_race_manager)
 		{
-			g_race_manager->Update(deltaTime);
+			g_race_manager->Update();
+			g_race_manager->PublishSnapshot();
 		}
 		
 		ui.BeginFrame();
@@ -1149,14 +1161,14 @@ int main()
 		// Render compass and laptimer — hidden when PRO view is active
 		if (ui.ShouldCloseSplash() && ui.getElements() && !ui.IsProMode())
 		{
-			ui.getElements()->drawCompass(camera_rotation, g_map_origin);
+			ui.getElements()->drawCompass(camera_rotation, TrackGeometry::CurrentOrigin());
 
 			if (g_race_manager)
 			{
 				int trackedVehicleId = g_focused_vehicle_id;
 				if (trackedVehicleId == -1)
 				{
-					auto standings = g_race_manager->GetStandings();
+					const auto& standings = RaceSnapshot::Current().standings;
 					if (!standings.empty())
 						trackedVehicleId = standings[0].vehicleID;
 				}
@@ -1195,7 +1207,7 @@ int main()
 	{
 		delete g_race_manager;
 		g_race_manager = nullptr;
-		std::cout << "[MAIN] Race Manager destroyed" << std::endl;
+		LOG_INFO(General, "[MAIN] Race Manager destroyed");
 	}
 	
 	ui.Shutdown();
@@ -1205,6 +1217,9 @@ int main()
 	stopComPortAutoDiscovery();
 
 	TrackServerClient::stop();
+	TrackServerReplay::stop();
+	TelemetryIngest::stop();
+	Log::Stop();
 	
 	TrackRenderer::clearTrackCache();  // Clear track VAO/VBO
 	VehicleNameRenderer::Shutdown();
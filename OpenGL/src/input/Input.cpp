@@ -2,9 +2,11 @@
 #include "Input.h"
 #include "../rendering/Interpolation.h"
 #include "../Config.h"
+#include "../track/TrackGeometry.h"
+#include "../core/Log.h"
+#include <cstring>
 #include <fstream>
 
-MapOrigin g_map_origin;
 std::atomic<bool> g_is_map_loaded = false;
 
 void chooseInputMode(std::vector<glm::vec2>& points, std::mutex& points_mutex, std::atomic<bool>& running)
@@ -182,7 +184,6 @@ void loadTrackFromData(const std::string& data, std::vector<glm::vec2>& points,
 		}
 
 		double normalized_x, normalized_y;
-		g_map_origin.m_map_size = MapConstants::MAP_SIZE;
 		getCoordinateDifferenceFromOrigin(easting_meters, northing_meters, normalized_x, normalized_y);
 
 		{
@@ -190,7 +191,7 @@ void loadTrackFromData(const std::string& data, std::vector<glm::vec2>& points,
 			points.push_back(glm::vec2(normalized_x, normalized_y));
 		}
 	}
-	std::cout << "Track loaded with " << points.size() << " points." << std::endl;
+	LOG_INFO(Track, "Track loaded with " << points.size() << " points.");
 
 	// If the file contains a saved start marker, rotate points so start/finish stays stable.
 	if (hasSavedStart)
@@ -257,7 +258,6 @@ bool loadDualEdgeFromData(const std::string& data,
 		if (firstPoint)
 		{
 			createOriginDD(lat, lon, e, n);
-			g_map_origin.m_map_size = MapConstants::MAP_SIZE;
 			firstPoint = false;
 		}
 		else
@@ -282,6 +282,22 @@ bool loadTrk2File(const std::string& path,
 	std::vector<glm::vec2>& leftOut,
 	std::vector<glm::vec2>& rightOut)
 {
+	std::vector<TrackGeometry::TimingLine> timingLines;
+	MapOrigin origin{};
+	if (!loadTrk2File(path, leftOut, rightOut, timingLines, origin))
+		return false;
+	TrackGeometry::PublishOrigin(origin);
+	return true;
+}
+
+bool loadTrk2File(const std::string& path,
+	std::vector<glm::vec2>& leftOut,
+	std::vector<glm::vec2>& rightOut,
+	std::vector<TrackGeometry::TimingLine>& timingLinesOut,
+	MapOrigin& originOut)
+{
+	timingLinesOut.clear();
+
 	std::ifstream f(path, std::ios::binary);
 	if (!f) return false;
 
@@ -290,16 +306,18 @@ bool loadTrk2File(const std::string& path,
 	if (memcmp(h.magic, "TRK2", 4) != 0 || h.version != 2) return false;
 	if (h.left_count < 2 || h.right_count < 2) return false;
 
-	g_map_origin.m_origin_meters_easting  = h.origin_easting;
-	g_map_origin.m_origin_meters_northing = h.origin_northing;
-	g_map_origin.m_origin_zone_int        = h.origin_zone;
-	g_map_origin.m_origin_zone_char       = h.origin_zone_char;
-	g_map_origin.m_map_size               = h.map_size;
+	MapOrigin& origin = originOut;
+	origin = MapOrigin{};
+	origin.m_origin_meters_easting  = h.origin_easting;
+	origin.m_origin_meters_northing = h.origin_northing;
+	origin.m_origin_zone_int        = h.origin_zone;
+	origin.m_origin_zone_char       = h.origin_zone_char;
+	origin.m_map_size               = h.map_size;
 	try {
 		bool northp = h.origin_zone_char >= 'N';
 		GeographicLib::UTMUPS::Reverse(h.origin_zone, northp,
 			h.origin_easting, h.origin_northing,
-			g_map_origin.m_origin_lat_dd, g_map_origin.m_origin_lon_dd);
+			origin.m_origin_lat_dd, origin.m_origin_lon_dd);
 	} catch (...) {}
 
 	leftOut.resize(h.left_count);
@@ -307,6 +325,27 @@ bool loadTrk2File(const std::string& path,
 	f.read(reinterpret_cast<char*>(leftOut.data()),  h.left_count  * sizeof(glm::vec2));
 	f.read(reinterpret_cast<char*>(rightOut.data()), h.right_count * sizeof(glm::vec2));
 
+	Trk2TimingHeader th;
+	if (f.read(reinterpret_cast<char*>(&th), sizeof(th)) && memcmp(th.magic, "TLN1", 4) == 0)
+	{
+		for (uint32_t i = 0; i < th.count; ++i)
+		{
+			Trk2TimingLine tl;
+			if (!f.read(reinterpret_cast<char*>(&tl), sizeof(tl)))
+				break;
+			if (tl.kind > static_cast<uint8_t>(TrackGeometry::TimingLine::Kind::PitExit))
+				continue;
+
+			TrackGeometry::TimingLine line;
+			line.kind = static_cast<TrackGeometry::TimingLine::Kind>(tl.kind);
+			line.p1 = glm::vec2(tl.p1x, tl.p1y);
+			line.p2 = glm::vec2(tl.p2x, tl.p2y);
+			line.name.assign(tl.name, strnlen(tl.name, sizeof(tl.name)));
+			timingLinesOut.push_back(std::move(line));
+		}
+		LOG_INFO(Track, "[TRK2] " << timingLinesOut.size() << " timing line(s) in " << path);
+	}
+
 	g_is_map_loaded = true;
 	return true;
 }
@@ -350,21 +389,22 @@ void createOriginDD(double lat_deg, double lon_deg, double& easting_meters, doub
 			else zone_letter = 'D'; // -80 to -64
 		}
 
-		std::cout << "UTM Coordinates: \n";
-		std::cout << "  easting_meters (X): " << easting_meters << " m\n";
-		std::cout << "  northing_meters (Y): " << northing_meters << " m\n";
-		std::cout << "  Zone: " << zone << zone_letter << "\n"; 
+		LOG_INFO(Track, "[COORD] Origin UTM: easting_meters (X)=" << easting_meters
+			<< " m, northing_meters (Y)=" << northing_meters << " m, zone " << zone << zone_letter);
 
 		
-		g_map_origin.m_origin_lat_dd = lat_deg;
-		g_map_origin.m_origin_lon_dd = lon_deg;
-		g_map_origin.m_origin_meters_easting = easting_meters;
-		g_map_origin.m_origin_meters_northing = northing_meters;
-		g_map_origin.m_origin_zone_int = zone;
-		g_map_origin.m_origin_zone_char = zone_letter;
+		MapOrigin origin{};
+		origin.m_origin_lat_dd = lat_deg;
+		origin.m_origin_lon_dd = lon_deg;
+		origin.m_origin_meters_easting = easting_meters;
+		origin.m_origin_meters_northing = northing_meters;
+		origin.m_origin_zone_int = zone;
+		origin.m_origin_zone_char = zone_letter;
+		origin.m_map_size = MapConstants::MAP_SIZE;
+		TrackGeometry::PublishOrigin(origin);
 	}
 	catch (const std::exception& e) {
-		std::cerr << "GeographicLib Error: " << e.what() << std::endl;
+		LOG_ERROR(Track, "GeographicLib Error: " << e.what());
 		easting_meters = 0;
 		northing_meters = 0;
 	}
@@ -372,12 +412,21 @@ void createOriginDD(double lat_deg, double lon_deg, double& easting_meters, doub
 
 void coordinatesToMeters(double DDlat, double DDlon, double &MetrCord_est, double &MetrCord_north)
 {
+	// Fitted projection around the current origin (falls back to
+	// GeographicLib by itself outside its radius).
+	const TrackGeometry::SnapshotPtr track = TrackGeometry::Current();
+	if (track->projection)
+	{
+		track->projection->ToMeters(DDlat, DDlon, MetrCord_est, MetrCord_north);
+		return;
+	}
+
 	try {
 		using namespace GeographicLib;
 
       // Force origin zone only when it is valid.
 		// If origin zone is not initialized yet, let GeographicLib pick the zone.
-		const int setzone = g_map_origin.m_origin_zone_int;
+		const int setzone = TrackGeometry::CurrentOrigin().m_origin_zone_int;
 		int zone;
 		bool northp;
 		if (setzone >= 1 && setzone <= 60)
@@ -390,8 +439,8 @@ void coordinatesToMeters(double DDlat, double DDlon, double &MetrCord_est, doubl
 		}
 	}
 	catch (const std::exception& e) {
-		std::cerr << "[COORD ERROR] GeographicLib: " << e.what() << std::endl;
-		std::cerr << "[COORD ERROR] Input: lat=" << DDlat << ", lon=" << DDlon << std::endl;
+		LOG_ERROR(Track, "[COORD ERROR] GeographicLib: " << e.what());
+		LOG_ERROR(Track, "[COORD ERROR] Input: lat=" << DDlat << ", lon=" << DDlon);
 		MetrCord_est = 0;
 		MetrCord_north = 0;
 	}
@@ -400,23 +449,19 @@ void coordinatesToMeters(double DDlat, double DDlon, double &MetrCord_est, doubl
 
 void getCoordinateDifferenceFromOrigin(double Metr_est, double Metr_north, double &normalized_x, double &normalized_y)
 {
-	double diff_easting = Metr_est - g_map_origin.m_origin_meters_easting;
-	double diff_northing = Metr_north - g_map_origin.m_origin_meters_northing;
-
-	normalized_x = (diff_easting / g_map_origin.m_map_size);
-	normalized_y = (diff_northing / g_map_origin.m_map_size);
-
-	// Debug output for vehicles (skip track loading)
-	static int call_count = 0;
-	call_count++;
-	if (call_count % 120 == 0) { // Log every 120th call (every 2 seconds at 60Hz)
-		std::cout << "[COORD] UTM: (" << Metr_est << ", " << Metr_north << ")" << std::endl;
-		std::cout << "[COORD] Origin UTM: (" << g_map_origin.m_origin_meters_easting 
-				  << ", " << g_map_origin.m_origin_meters_northing << ")" << std::endl;
-		std::cout << "[COORD] Diff: (" << diff_easting << ", " << diff_northing << ")" << std::endl;
-		std::cout << "[COORD] MAP_SIZE: " << g_map_origin.m_map_size << std::endl;
-		std::cout << "[COORD] Normalized: (" << normalized_x << ", " << normalized_y << ")" << std::endl;
-	}
+	const MapOrigin origin = TrackGeometry::CurrentOrigin();
+	double diff_easting = Metr_est - origin.m_origin_meters_easting;
+	double diff_northing = Metr_north - origin.m_origin_meters_northing;
+
+	normalized_x = (diff_easting / origin.m_map_size);
+	normalized_y = (diff_northing / origin.m_map_size);
+
+	// Debug output, every 120th call (every 2 seconds at 60Hz)
+	LOG_DEBUG_EVERY_N(Track, 120, "[COORD] UTM: (" << Metr_est << ", " << Metr_north << ")"
+		<< " origin: (" << origin.m_origin_meters_easting << ", " << origin.m_origin_meters_northing << ")"
+		<< " diff: (" << diff_easting << ", " << diff_northing << ")"
+		<< " MAP_SIZE: " << origin.m_map_size
+		<< " normalized: (" << normalized_x << ", " << normalized_y << ")");
 }
 
 void inputDataInCode(std::vector<glm::vec2>& points, std::mutex& points_mutex, std::atomic<bool>& running, double &normalized_x, double &normalized_y)
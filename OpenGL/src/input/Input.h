@@ -44,6 +44,18 @@ bool loadTrk2File(const std::string& path,
     std::vector<glm::vec2>& leftOut,
     std::vector<glm::vec2>& rightOut);
 
+namespace TrackGeometry { struct TimingLine; }
+class MapOrigin;
+
+// Same, plus the timing lines stored with the track (empty if it has none).
+// The file's origin is returned, not published: the caller publishes it with
+// the centre line (TrackRenderer::rebuildTrackCacheFromEdges).
+bool loadTrk2File(const std::string& path,
+    std::vector<glm::vec2>& leftOut,
+    std::vector<glm::vec2>& rightOut,
+    std::vector<TrackGeometry::TimingLine>& timingLinesOut,
+    MapOrigin& originOut);
+
 class MapOrigin
 {
 public:
@@ -57,7 +69,8 @@ public:
 
 };
 
-extern MapOrigin g_map_origin;
+// The current map origin is owned by TrackGeometry (CurrentOrigin / PublishOrigin)
+// so that it is always published together with the track it belongs to.
 
 extern std::atomic<bool> g_is_map_loaded;
 
@@ -1,6 +1,10 @@
 #include "../network/ESP32_Code.h"
 #include "SimulationServer.h"
-#include <iostream>
+#include "TelemetryIngest.h"
+#include "RajaStreamDecoder.h"
+#include "GatewayMerge.h"
+#include "../track/TrackGeometry.h"
+#include "../core/Log.h"
 #include <thread>
 #include <chrono>
 #include <atomic>
@@ -9,13 +13,11 @@
 #include <algorithm>
 #include <cstdlib>
 #include <limits>
+#include <memory>
 #include <GeographicLib/UTMUPS.hpp>
 
 // External globals from core/vehicle/track systems
 extern std::atomic<bool> g_is_map_loaded;
-extern std::vector<SplinePoint> g_smooth_track_points;
-extern std::mutex g_track_mutex;
-extern MapOrigin g_map_origin;
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -31,11 +33,29 @@ extern std::atomic<bool> g_is_client_mode;
 
 serialib serial;
 
-static std::atomic<bool> g_capture_running{ false };
-static std::atomic<bool> g_capture_stop_requested{ false };
-static std::thread g_capture_thread;
 static std::mutex g_serial_mutex;
 
+// One reader thread per open COM port. The slot index is the gateway index
+// in g_gateway_merge, which passes on the first copy of every frame.
+struct CaptureReader
+{
+    std::string port;
+    size_t gateway = 0;
+    serialib serial;
+    std::thread thread;
+    std::atomic<bool> stop_requested{ false };
+    std::atomic<bool> open_failed{ false };   // Device did not open; the thread has returned
+
+    // Decoder counters, published by the reader for getGatewayStats()
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<uint64_t> frames_ok{ 0 };
+    std::atomic<uint64_t> frames_bad{ 0 };
+};
+
+static std::mutex g_readers_mutex;  // Guards the slots; readers own their state
+static std::unique_ptr<CaptureReader> g_readers[GatewayMerge::kMaxGateways];
+static GatewayMerge g_gateway_merge;
+
 static std::mutex g_last_packet_mutex;
 static TelemetryPacket g_last_packet{};
 static std::atomic<bool> g_has_last_packet{ false };
@@ -74,13 +94,10 @@ bool calibrateOriginToStartFinish()
         packet = g_last_packet;
     }
 
-    glm::vec2 startPoint(0.0f, 0.0f);
-    {
-        std::lock_guard<std::mutex> lock(g_track_mutex);
-        if (g_smooth_track_points.empty())
-            return false;
-        startPoint = g_smooth_track_points.front().position;
-    }
+    const TrackGeometry::SnapshotPtr track = TrackGeometry::Current();
+    if (track->points.empty())
+        return false;
+    const glm::vec2 startPoint = track->points.front().position;
 
     // Current telemetry position in UTM meters
     const double lat_deg = static_cast<double>(packet.lat) / 1e7;
@@ -96,41 +113,41 @@ bool calibrateOriginToStartFinish()
 
     // Set origin so that this telemetry point maps to the track start point:
     // start = (UTM_current - origin) / MAP_SIZE  => origin = UTM_current - start*MAP_SIZE
-    g_map_origin.m_origin_meters_easting = easting - static_cast<double>(startPoint.x) * MapConstants::MAP_SIZE;
-    g_map_origin.m_origin_meters_northing = northing - static_cast<double>(startPoint.y) * MapConstants::MAP_SIZE;
+    MapOrigin origin = track->origin;
+    origin.m_origin_meters_easting = easting - static_cast<double>(startPoint.x) * MapConstants::MAP_SIZE;
+    origin.m_origin_meters_northing = northing - static_cast<double>(startPoint.y) * MapConstants::MAP_SIZE;
 
     try {
         using namespace GeographicLib;
-        const bool northp = (g_map_origin.m_origin_zone_char >= 'N');
+        const bool northp = (origin.m_origin_zone_char >= 'N');
         UTMUPS::Reverse(
-            g_map_origin.m_origin_zone_int,
+            origin.m_origin_zone_int,
             northp,
-            g_map_origin.m_origin_meters_easting,
-            g_map_origin.m_origin_meters_northing,
-            g_map_origin.m_origin_lat_dd,
-            g_map_origin.m_origin_lon_dd);
+            origin.m_origin_meters_easting,
+            origin.m_origin_meters_northing,
+            origin.m_origin_lat_dd,
+            origin.m_origin_lon_dd);
     }
     catch (...) {}
+    TrackGeometry::PublishOrigin(origin);
 
-    std::cout << "[ORIGIN] Calibrated to Start/Finish using latest telemetry packet." << std::endl;
-    std::cout << "[ORIGIN]   Start point norm=(" << startPoint.x << "," << startPoint.y << ")" << std::endl;
-    std::cout << "[ORIGIN]   Telemetry norm BEFORE=(" << nx_before << "," << ny_before << ")" << std::endl;
-    std::cout << "[ORIGIN]   New origin UTM: easting=" << g_map_origin.m_origin_meters_easting
-              << " northing=" << g_map_origin.m_origin_meters_northing << std::endl;
+    LOG_INFO(Track, "[ORIGIN] Calibrated to Start/Finish using latest telemetry packet.");
+    LOG_INFO(Track, "[ORIGIN]   Start point norm=(" << startPoint.x << "," << startPoint.y << ")");
+    LOG_INFO(Track, "[ORIGIN]   Telemetry norm BEFORE=(" << nx_before << "," << ny_before << ")");
+    LOG_INFO(Track, "[ORIGIN]   New origin UTM: easting=" << origin.m_origin_meters_easting
+              << " northing=" << origin.m_origin_meters_northing);
 
     // Calculate normalized position AFTER calibration (should match startPoint)
     double nx_after = 0.0;
     double ny_after = 0.0;
     getCoordinateDifferenceFromOrigin(easting, northing, nx_after, ny_after);
-    std::cout << "[ORIGIN]   Telemetry norm AFTER =(" << nx_after << "," << ny_after << ")" << std::endl;
+    LOG_INFO(Track, "[ORIGIN]   Telemetry norm AFTER =(" << nx_after << "," << ny_after << ")");
 
     return true;
 }
 
-bool openCOMPort(const std::string& port_name)
+static bool openSerialDevice(serialib& device_serial, const std::string& port_name)
 {
-    std::lock_guard<std::mutex> lock(g_serial_mutex);
-
     // On Windows, COM ports must be opened as "\\\\.\\COMx" for COM10+.
     // Using the prefix is safe for COM1..COM9 too.
     std::string device = port_name;
@@ -139,11 +156,11 @@ bool openCOMPort(const std::string& port_name)
         device = "\\\\.\\\\" + device;
 #endif
 
-    int result = serial.openDevice(device.c_str(), 921600);
+    int result = device_serial.openDevice(device.c_str(), 921600);
 
     if (result == 1) {
-        std::cout << "Successfully opened " << port_name << std::endl;
-        serial.flushReceiver();
+        LOG_INFO(Serial, "Successfully opened " << port_name);
+        device_serial.flushReceiver();
         return true;
     }
 
@@ -155,31 +172,37 @@ bool openCOMPort(const std::string& port_name)
     // -6 error while writing timeout parameters
     switch (result) {
     case -1:
-        std::cerr << "Error: Device not found: " << port_name << std::endl;
+        LOG_ERROR(Serial, "Error: Device not found: " << port_name);
         break;
     case -2:
-        std::cerr << "Error: Error while opening the device";
 #if defined(_WIN32)
-        std::cerr << " (GetLastError=" << GetLastError() << ")";
+        LOG_ERROR(Serial, "Error: Error while opening the device (GetLastError=" << GetLastError() << ")");
+#else
+        LOG_ERROR(Serial, "Error: Error while opening the device");
 #endif
-        std::cerr << std::endl;
         break;
     case -3:
-        std::cerr << "Error: Error while getting port parameters" << std::endl;
+        LOG_ERROR(Serial, "Error: Error while getting port parameters");
         break;
     case -5:
-        std::cerr << "Error: Error while writing port parameters" << std::endl;
+        LOG_ERROR(Serial, "Error: Error while writing port parameters");
         break;
     case -6:
-        std::cerr << "Error: Error while writing timeout parameters" << std::endl;
+        LOG_ERROR(Serial, "Error: Error while writing timeout parameters");
         break;
     default:
-        std::cerr << "Error: Unknown error opening port (code=" << result << ")" << std::endl;
+        LOG_ERROR(Serial, "Error: Unknown error opening port (code=" << result << ")");
         break;
     }
     return false;
 }
 
+bool openCOMPort(const std::string& port_name)
+{
+    std::lock_guard<std::mutex> lock(g_serial_mutex);
+    return openSerialDevice(serial, port_name);
+}
+
 #if defined(_WIN32)
 static std::vector<ComPortInfo> enumerateComPortsWindows()
 {
@@ -285,172 +308,255 @@ std::string getSelectedComPort()
     return g_selected_port;
 }
 
-void stopRealDataCapture()
+// Caller holds g_readers_mutex. The reader thread never takes it.
+static void stopReader(std::unique_ptr<CaptureReader>& reader)
 {
-    g_capture_stop_requested.store(true);
-    if (g_capture_thread.joinable())
-        g_capture_thread.join();
+    if (!reader)
+        return;
+    reader->stop_requested.store(true);
+    if (reader->thread.joinable())
+        reader->thread.join();
+    reader.reset();
+}
 
-    g_capture_running.store(false);
-    g_capture_stop_requested.store(false);
-    closeSerialNoThrow();
+void stopRealDataCapture()
+{
+    std::lock_guard<std::mutex> lock(g_readers_mutex);
+    for (auto& reader : g_readers)
+        stopReader(reader);
 }
 
-static void realDataThreadWorker(const std::string& com_port)
+static void realDataThreadWorker(CaptureReader* reader)
 {
-    if (!openCOMPort(com_port)) {
-        std::cerr << "[REAL DATA] Failed to open " << com_port << std::endl;
+    const std::string& com_port = reader->port;
+    serialib& serial = reader->serial;
+    if (!openSerialDevice(serial, com_port)) {
+        LOG_ERROR(Serial, "[REAL DATA] Failed to open " << com_port);
+        reader->open_failed.store(true);
         return;
     }
 
-    std::cout << "[REAL DATA] Listening on " << com_port << std::endl;
-
-    uint64_t bytes_seen = 0;
-    uint64_t telemetry_headers_seen = 0;
-    uint64_t telemetry_packets_ok = 0;
-    uint64_t telemetry_packets_bad = 0;
-    uint64_t nonmatch_bytes = 0;
+    LOG_INFO(Serial, "[REAL DATA] Listening on " << com_port);
 
     auto last_stats = std::chrono::steady_clock::now();
     auto last_coord_log = std::chrono::steady_clock::now();
     TelemetryPacket last_packet{};
     bool has_last_packet = false;
+    uint64_t bad_reported = 0;
 
-    // SX1280 device sends RajaTelemetryPacket in little-endian order.
-    // magic PACKET_MAGIC_RAJA (0x52414A41 'RAJA') appears on the wire as bytes: 41 4A 41 52
-    constexpr uint8_t kMagicLE[4] = { 0x41, 0x4A, 0x41, 0x52 };
-    uint8_t window[4] = { 0, 0, 0, 0 };
-    int windowCount = 0;
+    // SX1280 device sends RajaTelemetryPacket frames; RajaStreamDecoder finds
+    // the magic, checks the CRC and translates via rajagp_core (same code path
+    // as the track server).
+    RajaStreamDecoder decoder;
+    std::vector<TelemetryPacket> batch;
+    batch.reserve(64);
 
-    while (!g_capture_stop_requested.load())
+    while (!reader->stop_requested.load())
     {
-      const auto now = std::chrono::steady_clock::now();
-        // Read stream byte-by-byte and scan for magic marker.
-        uint8_t byte = 0;
-        if (serial.readBytes(&byte, 1, 100) <= 0)
+        // Read everything the driver has buffered in one call. With nothing
+        // pending, wait for a single byte instead — the read returns as soon
+        // as it arrives, or after 100 ms so the stop flag is still polled.
+        size_t space = 0;
+        uint8_t* dst = decoder.WriteSpace(space);
+        const int pending = serial.available();
+        const size_t want = pending > 0 ? std::min(static_cast<size_t>(pending), space) : 1;
+        const int r = serial.readBytes(dst, static_cast<unsigned int>(want), 100);
+        const auto now = std::chrono::steady_clock::now();
+
+        if (r < 0)
         {
+            // Read error (device unplugged, ...): don't spin on it.
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
-        else
+        else if (r > 0)
         {
-            bytes_seen++;
-
-            // shift window
-            window[0] = window[1];
-            window[1] = window[2];
-            window[2] = window[3];
-            window[3] = byte;
-            if (windowCount < 4) {
-                windowCount++;
-                continue;
+            // Chunk complete: latency is traced from here to the screen.
+            TelemetryLatency::Stamps stamps;
+            stamps.source = TelemetryLatency::Source::Serial;
+            stamps.receivedUs = TelemetryLatency::nowUs();
+
+            decoder.Commit(static_cast<size_t>(r));
+            TelemetryPacket packet{};
+            while (decoder.Next(packet))
+            {
+                // Other gateways may have delivered this frame already.
+                if (g_gateway_merge.Accept(reader->gateway, packet))
+                    batch.push_back(packet);
             }
+            stamps.decodedUs = TelemetryLatency::nowUs();
 
-            const bool matched = (window[0] == kMagicLE[0] && window[1] == kMagicLE[1] && window[2] == kMagicLE[2] && window[3] == kMagicLE[3]);
-            if (!matched)
+            if (!batch.empty())
             {
-                nonmatch_bytes++;
+                last_packet = batch.back();
+                has_last_packet = true;
 
-                // keep scanning
-            }
-            else
-            {
-                telemetry_headers_seen++;
-
-                // Read the payload bytes that follow the matched magic marker,
-                // then validate + translate via rajagp_core (same code path as
-                // the track server).
-                const size_t payloadSize = rajagp::kRajaPayloadAfterMagic;
-                uint8_t payload[rajagp::kRajaPayloadAfterMagic];
-                size_t totalRead = 0;
-                while (totalRead < payloadSize && !g_capture_stop_requested.load())
                 {
-                    const int r = serial.readBytes(reinterpret_cast<char*>(payload + totalRead), static_cast<int>(payloadSize - totalRead), 100);
-                    if (r > 0)
-                        totalRead += static_cast<size_t>(r);
-                    else
-                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    std::lock_guard<std::mutex> lock(g_last_packet_mutex);
+                    g_last_packet = last_packet;
+                    g_has_last_packet.store(true, std::memory_order_relaxed);
                 }
 
-                // CRC check + RAJA→TelemetryPacket translation (rajagp_core).
-                TelemetryPacket packet{};
-                const bool crc_ok = (totalRead == payloadSize) &&
-                    rajagp::parseRajaPayload(payload, packet);
+                // Queue for the ingest thread — never wait on g_vehicles_mutex
+                // here, the UART keeps filling while we do.
+                TelemetryIngest::pushTelemetryBatch(batch.data(), batch.size(), true, stamps);
 
-                if (crc_ok)
-                {
-                    telemetry_packets_ok++;
-                   last_packet = packet;
-                    has_last_packet = true;
-
-                    {
-                        std::lock_guard<std::mutex> lock(g_last_packet_mutex);
-                        g_last_packet = packet;
-                        g_has_last_packet.store(true, std::memory_order_relaxed);
-                    }
-
-                    processIncomingTelemetry(packet);
-
-                    // ✅ 2. Broadcast to network clients (if server is running)
-                    // Only broadcast if in server mode (not client mode)
-                    if (g_is_server_mode && !g_is_client_mode) {
-                        BroadcastTelemetryToClients(packet);
-                    }
+                // ✅ 2. Broadcast to network clients (if server is running)
+                // Only broadcast if in server mode (not client mode)
+                if (g_is_server_mode && !g_is_client_mode) {
+                    for (const TelemetryPacket& p : batch)
+                        BroadcastTelemetryToClients(p);
                 }
-                else
+                batch.clear();
+            }
+
+            const RajaStreamDecoder::Counters& counters = decoder.GetCounters();
+            reader->bytes.store(counters.bytes, std::memory_order_relaxed);
+            reader->frames_ok.store(counters.ok, std::memory_order_relaxed);
+            reader->frames_bad.store(counters.bad, std::memory_order_relaxed);
+            if (counters.bad != bad_reported)
+            {
+                // First rejection, then once per 10 more.
+                if (bad_reported == 0 || counters.bad / 10 != bad_reported / 10)
                 {
-                    telemetry_packets_bad++;
-                    if ((telemetry_packets_bad % 10) == 1)
-                    {
-                        std::cerr << "[SERIAL] RAJA packet rejected ("
-                                  << (totalRead == payloadSize ? "CRC mismatch" : "short read")
-                                  << "). expected=" << payloadSize
-                                  << " got=" << totalRead
-                                  << " | ok=" << telemetry_packets_ok
-                                  << " bad=" << telemetry_packets_bad
-                                  << std::endl;
-                    }
+                    LOG_WARN(Serial, "[SERIAL] " << com_port << ": RAJA packet rejected (CRC mismatch). frame="
+                              << RajaStreamDecoder::kFrameSize
+                              << " | ok=" << counters.ok
+                              << " bad=" << counters.bad);
+                }
+                bad_reported = counters.bad;
+            }
+        }
 
         // Periodic coordinate log (every 5 seconds)
         if (has_last_packet && (now - last_coord_log >= std::chrono::seconds(5)))
         {
             last_coord_log = now;
-           // Arduino packs GPS as scaled integers: degrees * 1e7
+            // Arduino packs GPS as scaled integers: degrees * 1e7
             const double lat = static_cast<double>(last_packet.lat) / 1e7;
             const double lon = static_cast<double>(last_packet.lon) / 1e7;
-            std::cout << "[SERIAL] last GNSS: lat=" << lat
+            LOG_INFO(Serial, "[SERIAL] last GNSS: lat=" << lat
                       << " lon=" << lon
                       << " fix=" << last_packet.fixtype
                       << " speed=" << (static_cast<double>(last_packet.speed) / 100.0)
-                      << "km/h"
-                      << std::endl;
-        }
-                }
-            }
+                      << "km/h");
         }
 
         // Periodic stats (every 2 seconds)
         if (now - last_stats >= std::chrono::seconds(2))
         {
             last_stats = now;
-            std::cout << "[SERIAL] stats: bytes_seen=" << bytes_seen
-                      << " telemetry_headers_seen=" << telemetry_headers_seen
-                      << " telemetry_packets_ok=" << telemetry_packets_ok
-                      << " telemetry_packets_bad=" << telemetry_packets_bad
-                      << " nonmatch_bytes=" << nonmatch_bytes
-                      << std::endl;
+            const RajaStreamDecoder::Counters& counters = decoder.GetCounters();
+            const GatewayMerge::GatewayStats merged = g_gateway_merge.Stats(reader->gateway);
+            LOG_INFO(Serial, "[SERIAL] " << com_port << " stats: bytes_seen=" << counters.bytes
+                      << " telemetry_headers_seen=" << counters.headers
+                      << " telemetry_packets_ok=" << counters.ok
+                      << " telemetry_packets_bad=" << counters.bad
+                      << " nonmatch_bytes=" << counters.nonmatch
+                      << " coverage=" << merged.coveragePct << "%"
+                      << " first=" << merged.firsts
+                      << " exclusive=" << merged.exclusive);
         }
     }
 
-    std::cout << "[REAL DATA] Stopped listening on " << com_port << std::endl;
-    closeSerialNoThrow();
+    LOG_INFO(Serial, "[REAL DATA] Stopped listening on " << com_port);
+    try { serial.closeDevice(); }
+    catch (...) {}
 }
 
 void startRealDataCapture(const std::string& com_port)
 {
     stopRealDataCapture();
-    g_capture_running.store(true);
-    g_capture_stop_requested.store(false);
-    g_capture_thread = std::thread(realDataThreadWorker, com_port);
+    g_gateway_merge.Reset();
+    addComPort(com_port);
+}
+
+bool addComPort(const std::string& port)
+{
+    if (port.empty())
+        return false;
+
+    std::lock_guard<std::mutex> lock(g_readers_mutex);
+    std::unique_ptr<CaptureReader>* freeSlot = nullptr;
+    for (auto& reader : g_readers)
+    {
+        // A reader that could not open its port gives its slot back here
+        if (reader && reader->open_failed.load())
+            stopReader(reader);
+        if (reader && reader->port == port)
+            return false;
+        if (!reader && !freeSlot)
+            freeSlot = &reader;
+    }
+    if (!freeSlot)
+    {
+        LOG_WARN(Serial, "[SERIAL] No free receiver slot for " << port
+                  << " (max " << GatewayMerge::kMaxGateways << ")");
+        return false;
+    }
+
+    auto reader = std::make_unique<CaptureReader>();
+    reader->port = port;
+    reader->gateway = static_cast<size_t>(freeSlot - g_readers);
+    g_gateway_merge.ResetGateway(reader->gateway);
+    reader->thread = std::thread(realDataThreadWorker, reader.get());
+    *freeSlot = std::move(reader);
+    return true;
+}
+
+void removeComPort(const std::string& port)
+{
+    std::lock_guard<std::mutex> lock(g_readers_mutex);
+    for (auto& reader : g_readers)
+    {
+        if (reader && reader->port == port)
+            stopReader(reader);
+    }
+}
+
+std::vector<std::string> getOpenComPorts()
+{
+    std::vector<std::string> out;
+    std::lock_guard<std::mutex> lock(g_readers_mutex);
+    for (const auto& reader : g_readers)
+    {
+        if (reader && !reader->open_failed.load())
+            out.push_back(reader->port);
+    }
+    return out;
+}
+
+std::vector<std::string> getFailedComPorts()
+{
+    std::vector<std::string> out;
+    std::lock_guard<std::mutex> lock(g_readers_mutex);
+    for (const auto& reader : g_readers)
+    {
+        if (reader && reader->open_failed.load())
+            out.push_back(reader->port);
+    }
+    return out;
+}
+
+std::vector<GatewayInfo> getGatewayStats()
+{
+    std::vector<GatewayInfo> out;
+    std::lock_guard<std::mutex> lock(g_readers_mutex);
+    for (const auto& reader : g_readers)
+    {
+        if (!reader || reader->open_failed.load())
+            continue;
+        GatewayInfo info;
+        info.port = reader->port;
+        info.bytes = reader->bytes.load(std::memory_order_relaxed);
+        info.frames_ok = reader->frames_ok.load(std::memory_order_relaxed);
+        info.frames_bad = reader->frames_bad.load(std::memory_order_relaxed);
+        const GatewayMerge::GatewayStats merged = g_gateway_merge.Stats(reader->gateway);
+        info.firsts = merged.firsts;
+        info.exclusive = merged.exclusive;
+        info.coverage_pct = merged.coveragePct;
+        out.push_back(info);
+    }
+    return out;
 }
 
 bool selectAndOpenComPort(const std::string& port)
@@ -463,7 +569,7 @@ bool selectAndOpenComPort(const std::string& port)
         g_selected_port = port;
     }
 
-    std::cout << "[SERIAL] Selected COM port: " << port << std::endl;
+    LOG_INFO(Serial, "[SERIAL] Selected COM port: " << port);
 
     // Avoid showing stale PPS from the previous source while the new port is opening.
     telemetryResetPpsCounters();
@@ -476,10 +582,10 @@ void testSerial()
 {
     if (openCOMPort("COM5"))
     {
-        std::cout << "Connection established. Ready to receive data." << std::endl;
+        LOG_INFO(Serial, "Connection established. Ready to receive data.");
         std::this_thread::sleep_for(std::chrono::seconds(2));
-        serial.closeDevice();
-        std::cout << "Port closed." << std::endl;
+        closeSerialNoThrow();
+        LOG_INFO(Serial, "Port closed.");
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "../network/Server.h"
 #include <serialib/serialib.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -38,9 +39,45 @@ bool selectAndOpenComPort(const std::string& port);
 // Stop capture and close port (safe to call multiple times)
 void stopRealDataCapture();
 
+// ============================================================================
+// MULTIPLE RECEIVERS — extra gateways on other COM ports. Frames heard by
+// several gateways are ingested once, from whichever delivered them first.
+// ============================================================================
+
+// Start capture on one more port, next to the ones already open.
+// False if it is already open or all receiver slots are taken. The reader
+// thread opens the device; if that fails the port moves to
+// getFailedComPorts() and its slot is free for the next add.
+bool addComPort(const std::string& port);
+
+// Stop capture on one port (others keep running)
+void removeComPort(const std::string& port);
+
+// Ports currently being captured
+std::vector<std::string> getOpenComPorts();
+
+// Ports whose device could not be opened. They are not captured and not in
+// getOpenComPorts(); adding one again retries it, removing it forgets it.
+std::vector<std::string> getFailedComPorts();
+
+struct GatewayInfo
+{
+    std::string port;
+    uint64_t bytes = 0;           // Bytes read
+    uint64_t frames_ok = 0;       // Valid frames decoded (duplicates included)
+    uint64_t frames_bad = 0;      // CRC failures
+    uint64_t firsts = 0;          // Frames this gateway delivered first
+    uint64_t exclusive = 0;       // Frames no other gateway heard
+    double coverage_pct = 0.0;    // Share of all unique frames this gateway heard
+};
+
+// Per-receiver reception stats for antenna placement
+std::vector<GatewayInfo> getGatewayStats();
+
 // ============================================================================
 // DATA SOURCES
 // ============================================================================
 
-// Start reading real data from COM port (runs in separate thread)
+// Start reading real data from COM port (runs in separate thread); replaces
+// any ports already open
 void startRealDataCapture(const std::string& com_port);
@@ -0,0 +1,136 @@
+#include "GatewayMerge.h"
+
+namespace {
+
+uint64_t mix(uint64_t h, uint64_t v)
+{
+    h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+// Exactly one bit set: the frame came through a single gateway.
+bool singleGateway(uint8_t mask)
+{
+    return mask != 0 && (mask & (mask - 1)) == 0;
+}
+
+size_t gatewayOf(uint8_t mask)
+{
+    size_t g = 0;
+    while ((mask & 1u) == 0) { mask >>= 1; ++g; }
+    return g;
+}
+
+} // namespace
+
+GatewayMerge::GatewayMerge()
+{
+    m_cars.reserve(64);
+}
+
+uint64_t GatewayMerge::frameKey(const rajagp::TelemetryPacket& packet)
+{
+    uint64_t h = packet.time;
+    h = mix(h, static_cast<uint32_t>(packet.lat));
+    h = mix(h, static_cast<uint32_t>(packet.lon));
+    h = mix(h, static_cast<uint32_t>(packet.speed));
+    return h;
+}
+
+void GatewayMerge::retire(const Entry& entry)
+{
+    if (singleGateway(entry.seenBy))
+        m_exclusive[gatewayOf(entry.seenBy)]++;
+}
+
+bool GatewayMerge::Accept(size_t gateway, const rajagp::TelemetryPacket& packet)
+{
+    if (gateway >= kMaxGateways)
+        return true;
+    const uint64_t key = frameKey(packet);
+    const uint8_t bit = static_cast<uint8_t>(1u << gateway);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    CarWindow& car = m_cars[packet.ID];
+    for (size_t i = 0; i < car.used; ++i)
+    {
+        Entry& entry = car.entries[i];
+        if (entry.key != key)
+            continue;
+        if ((entry.seenBy & bit) == 0)
+        {
+            entry.seenBy |= bit;
+            m_frames[gateway]++;
+        }
+        return false;
+    }
+
+    Entry& slot = car.entries[car.next];
+    if (car.used == kWindow)
+        retire(slot);
+    else
+        car.used++;
+    slot.key = key;
+    slot.seenBy = bit;
+    car.next = (car.next + 1) % kWindow;
+
+    m_unique++;
+    m_frames[gateway]++;
+    m_firsts[gateway]++;
+    return true;
+}
+
+GatewayMerge::GatewayStats GatewayMerge::Stats(size_t gateway) const
+{
+    GatewayStats s;
+    if (gateway >= kMaxGateways)
+        return s;
+    const uint8_t bit = static_cast<uint8_t>(1u << gateway);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    s.frames = m_frames[gateway];
+    s.firsts = m_firsts[gateway];
+    s.exclusive = m_exclusive[gateway];
+    // Frames still in a window count as exclusive while nobody else has them.
+    for (const auto& kv : m_cars)
+        for (size_t i = 0; i < kv.second.used; ++i)
+            if (kv.second.entries[i].seenBy == bit)
+                s.exclusive++;
+    if (m_unique != 0)
+        s.coveragePct = 100.0 * static_cast<double>(s.frames) / static_cast<double>(m_unique);
+    return s;
+}
+
+uint64_t GatewayMerge::UniqueFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_unique;
+}
+
+void GatewayMerge::ResetGateway(size_t gateway)
+{
+    if (gateway >= kMaxGateways)
+        return;
+    const uint8_t bit = static_cast<uint8_t>(1u << gateway);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frames[gateway] = 0;
+    m_firsts[gateway] = 0;
+    m_exclusive[gateway] = 0;
+    for (auto& kv : m_cars)
+        for (size_t i = 0; i < kv.second.used; ++i)
+            kv.second.entries[i].seenBy &= static_cast<uint8_t>(~bit);
+}
+
+void GatewayMerge::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cars.clear();
+    m_unique = 0;
+    for (size_t g = 0; g < kMaxGateways; ++g)
+    {
+        m_frames[g] = 0;
+        m_firsts[g] = 0;
+        m_exclusive[g] = 0;
+    }
+}
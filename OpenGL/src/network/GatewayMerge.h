@@ -0,0 +1,76 @@
+#pragma once
+
+// ============================================================================
+// GatewayMerge — several SX1280 gateways hear the same kart frames; exactly
+// the first copy of each frame goes on to the ingest thread.
+//
+// A frame is identified by its car ID plus a fingerprint of its payload
+// (GPS time, position, speed): the gateways forward the same radio frame, so
+// copies are bit-identical. Each car keeps a window of its last kWindow
+// frames with a bit per gateway that delivered it — a lookup is a scan of
+// 32 keys, so Accept() is O(1) whatever the number of cars or gateways.
+// A copy arriving after its frame left the window (kWindow frames later,
+// ~3 s at 10 Hz) would be taken as new; gateways are nowhere near that far
+// apart.
+//
+// Per gateway it also counts coverage (share of all unique frames it heard)
+// and exclusive frames (heard by no other gateway) — the numbers that tell
+// where the antennas should go. The packets carry no RSSI, so there is none.
+//
+// Thread-safe: every reader thread calls Accept() for its own gateway.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include <rajagp/Protocol.h>
+
+class GatewayMerge
+{
+public:
+    static constexpr size_t kMaxGateways = 8;
+    static constexpr size_t kWindow = 32;
+
+    struct GatewayStats {
+        uint64_t frames = 0;        // Distinct frames this gateway delivered
+        uint64_t firsts = 0;        // ...of which it was the first arrival
+        uint64_t exclusive = 0;     // ...of which no other gateway had a copy
+        double coveragePct = 0.0;   // frames / all unique frames
+    };
+
+    GatewayMerge();
+
+    // Any reader thread. True if `packet` is the first copy of its frame and
+    // should be ingested; false for a duplicate.
+    bool Accept(size_t gateway, const rajagp::TelemetryPacket& packet);
+
+    GatewayStats Stats(size_t gateway) const;
+    uint64_t UniqueFrames() const;
+
+    // Forget one gateway (its slot is being reused for another port).
+    void ResetGateway(size_t gateway);
+    void Reset();
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        uint8_t seenBy = 0;         // Bit per gateway
+    };
+    struct CarWindow {
+        Entry entries[kWindow];
+        size_t next = 0;            // Slot the next new frame overwrites
+        size_t used = 0;
+    };
+
+    static uint64_t frameKey(const rajagp::TelemetryPacket& packet);
+    void retire(const Entry& entry);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<int32_t, CarWindow> m_cars;
+    uint64_t m_unique = 0;
+    uint64_t m_frames[kMaxGateways] = {};
+    uint64_t m_firsts[kMaxGateways] = {};
+    uint64_t m_exclusive[kMaxGateways] = {};    // Retired entries only
+};
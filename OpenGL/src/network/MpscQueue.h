@@ -0,0 +1,120 @@
+#pragma once
+
+// ============================================================================
+// MpscQueue — bounded lock-free queue, many producers / one consumer.
+//
+// Array of cells with per-cell sequence numbers (D. Vyukov's bounded queue):
+// producers claim a slot with one CAS on the tail, the consumer is the only
+// writer of the head. Nothing allocates after construction and a full queue
+// fails the push instead of blocking — the caller (a serial reader that must
+// keep draining the UART) counts the drop and moves on.
+//
+// Capacity must be a power of two.
+// ============================================================================
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+template <typename T>
+class MpscQueue
+{
+public:
+    explicit MpscQueue(size_t capacity)
+        : m_cells(new Cell[capacity])
+        , m_mask(capacity - 1)
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    size_t Capacity() const { return m_mask + 1; }
+
+    // Any thread. False if the queue is full (item is not enqueued).
+    bool TryPush(const T& item)
+    {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = m_cells[pos & m_mask];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = item;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    const size_t head = m_head.load(std::memory_order_relaxed);
+                    noteDepth(pos + 1 > head ? pos + 1 - head : 0);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only.
+    bool TryPop(T& out)
+    {
+        const size_t pos = m_head.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[pos & m_mask];
+        const size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+            return false;
+
+        out = cell.value;
+        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_head.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate (racy by design) — for diagnostics only.
+    size_t Depth() const
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+    uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    // Any thread. Counts `count` items the caller gave up on without a
+    // TryPush (the rest of a batch after one failed).
+    void AddDropped(uint64_t count) { m_dropped.fetch_add(count, std::memory_order_relaxed); }
+    size_t HighWater() const { return m_high_water.load(std::memory_order_relaxed); }
+    void ResetHighWater() { m_high_water.store(Depth(), std::memory_order_relaxed); }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence{ 0 };
+        T value{};
+    };
+
+    void noteDepth(size_t depth)
+    {
+        size_t prev = m_high_water.load(std::memory_order_relaxed);
+        while (depth > prev && !m_high_water.compare_exchange_weak(prev, depth, std::memory_order_relaxed)) {}
+    }
+
+    std::unique_ptr<Cell[]> m_cells;
+    const size_t m_mask;
+
+    // Producers and consumer on separate cache lines.
+    alignas(64) std::atomic<size_t> m_tail{ 0 };
+    alignas(64) std::atomic<size_t> m_head{ 0 };
+    alignas(64) std::atomic<uint64_t> m_dropped{ 0 };
+    std::atomic<size_t> m_high_water{ 0 };
+};
@@ -0,0 +1,103 @@
+#include "RajaStreamDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// PACKET_MAGIC_RAJA (0x52414A41) in little-endian wire order.
+constexpr uint8_t kMagicLE[RajaStreamDecoder::kMagicSize] = { 0x41, 0x4A, 0x41, 0x52 };
+
+} // namespace
+
+RajaStreamDecoder::RajaStreamDecoder(size_t capacity)
+    : m_capacity(std::max(capacity, kFrameSize * 4))
+{
+    m_buffer.reset(new uint8_t[m_capacity]);
+}
+
+uint8_t* RajaStreamDecoder::WriteSpace(size_t& available)
+{
+    if (m_begin == m_end)
+    {
+        m_begin = 0;
+        m_end = 0;
+    }
+    else if (m_begin > 0)
+    {
+        std::memmove(m_buffer.get(), m_buffer.get() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+    available = m_capacity - m_end;
+    return m_buffer.get() + m_end;
+}
+
+void RajaStreamDecoder::Commit(size_t count)
+{
+    count = std::min(count, m_capacity - m_end);
+    m_end += count;
+    m_counters.bytes += count;
+}
+
+size_t RajaStreamDecoder::Feed(const uint8_t* data, size_t size)
+{
+    size_t available = 0;
+    uint8_t* dst = WriteSpace(available);
+    const size_t n = std::min(size, available);
+    std::memcpy(dst, data, n);
+    Commit(n);
+    return n;
+}
+
+bool RajaStreamDecoder::Next(rajagp::TelemetryPacket& out)
+{
+    const uint8_t* const buffer = m_buffer.get();
+    while (m_end - m_begin >= kMagicSize)
+    {
+        // Only positions with a whole magic after them can start a frame.
+        const size_t searchable = m_end - m_begin - (kMagicSize - 1);
+        const uint8_t* start = buffer + m_begin;
+        const void* hit = std::memchr(start, kMagicLE[0], searchable);
+        if (!hit)
+        {
+            m_counters.nonmatch += searchable;
+            m_begin += searchable;
+            return false;
+        }
+
+        const size_t offset = static_cast<size_t>(static_cast<const uint8_t*>(hit) - start);
+        if (std::memcmp(hit, kMagicLE, kMagicSize) != 0)
+        {
+            m_counters.nonmatch += offset + 1;
+            m_begin += offset + 1;
+            continue;
+        }
+        m_counters.nonmatch += offset;
+        m_begin += offset;
+
+        // Rest of the frame still on the wire — keep the magic for next time.
+        if (m_end - m_begin < kFrameSize)
+            return false;
+
+        m_counters.headers++;
+        if (rajagp::parseRajaPayload(buffer + m_begin + kMagicSize, out))
+        {
+            m_counters.ok++;
+            m_begin += kFrameSize;
+            return true;
+        }
+
+        // CRC mismatch: resync one byte on, a real frame may start inside.
+        m_counters.bad++;
+        m_begin += 1;
+    }
+    return false;
+}
+
+void RajaStreamDecoder::Reset()
+{
+    m_begin = 0;
+    m_end = 0;
+    m_counters = Counters{};
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+// ============================================================================
+// RajaStreamDecoder — pulls RAJA telemetry frames out of a raw byte stream.
+//
+// The SX1280 gateway writes back-to-back frames of
+//   "RAJA" magic (41 4A 41 52 on the wire) + rajagp::kRajaPayloadAfterMagic bytes
+// with line noise and half-frames in between. The caller reads whole chunks
+// straight into the decoder's buffer (WriteSpace/Commit) and then calls Next()
+// until it runs dry; frames are validated in place by rajagp::parseRajaPayload.
+//
+// The magic is found with memchr (vectorised by every CRT we ship on), so a
+// chunk of noise costs one scan instead of a shifted 4-byte window per byte.
+// A frame that fails its CRC only consumes its first byte: a false "RAJA" in
+// noise must not swallow a real frame that starts inside its payload.
+//
+// Nothing here touches the serial port — tests and benchmarks can Feed()
+// synthetic streams. Single-threaded: one decoder per reader thread.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <rajagp/RajaParser.h>
+
+class RajaStreamDecoder
+{
+public:
+    static constexpr size_t kMagicSize = 4;
+    static constexpr size_t kFrameSize = kMagicSize + rajagp::kRajaPayloadAfterMagic;
+
+    struct Counters {
+        uint64_t bytes = 0;         // Bytes committed
+        uint64_t headers = 0;       // Magic markers followed by a full frame
+        uint64_t ok = 0;            // Frames that passed the CRC
+        uint64_t bad = 0;           // Frames that failed the CRC
+        uint64_t nonmatch = 0;      // Bytes skipped while looking for a magic marker
+    };
+
+    // Capacity is clamped to at least a few frames.
+    explicit RajaStreamDecoder(size_t capacity = 4096);
+
+    RajaStreamDecoder(const RajaStreamDecoder&) = delete;
+    RajaStreamDecoder& operator=(const RajaStreamDecoder&) = delete;
+
+    // Free space to read into; `available` receives its size. Compacts the
+    // unconsumed tail (always shorter than one frame once Next() has run dry)
+    // to the front first.
+    uint8_t* WriteSpace(size_t& available);
+    // Marks `count` bytes written into WriteSpace() as received.
+    void Commit(size_t count);
+
+    // Copies `size` bytes in (WriteSpace + Commit). Returns how many fit —
+    // call Next() until it returns false to make room for the rest.
+    size_t Feed(const uint8_t* data, size_t size);
+
+    // Decodes the next valid frame into `out`. False once no complete frame
+    // is left in the buffer.
+    bool Next(rajagp::TelemetryPacket& out);
+
+    // Drops buffered bytes and zeroes the counters.
+    void Reset();
+
+    const Counters& GetCounters() const { return m_counters; }
+    size_t Buffered() const { return m_end - m_begin; }
+
+private:
+    std::unique_ptr<uint8_t[]> m_buffer;
+    size_t m_capacity;
+    size_t m_begin = 0;     // First unconsumed byte
+    size_t m_end = 0;       // One past the last committed byte
+    Counters m_counters;
+};
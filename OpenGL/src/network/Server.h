@@ -69,7 +69,7 @@ struct MapRequestPacket {
 struct MapDataPacket {
 	uint32_t magic_marker = PacketMagic::MAP_DATA;  // 'MAPD'
 
-	// Map origin data (from g_map_origin)
+	// Map origin data (from TrackGeometry::CurrentOrigin())
 	double origin_lat_dd;
 	double origin_lon_dd;
 	double origin_meters_easting;
@@ -0,0 +1,239 @@
+#include "ServerClock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace ServerClock {
+namespace {
+
+constexpr double   kWindowUs = 2'000'000.0;  // One best sample per window
+constexpr size_t   kWindows = 30;            // ~1 min of history in the fit
+constexpr double   kMinFitSpanUs = 10'000'000.0; // Drift needs >= 10 s of spread
+constexpr double   kMaxDrift = 500e-6;       // Crystal drift is ppm; more is noise
+constexpr double   kStepUs = 1'000'000.0;    // Farther than this from the model...
+constexpr int      kStepConfirm = 3;         // ...this many times in a row = clock step
+
+struct Sample {
+    double localUs = 0.0;
+    double offsetUs = 0.0;      // server - local
+    double rttUs = -1.0;        // Exchanges only
+};
+
+struct Model {
+    bool     valid = false;
+    bool     twoWay = false;
+    double   offsetUs = 0.0;    // At refUs
+    double   drift = 0.0;       // d(offset) / d(local)
+    double   refUs = 0.0;
+    double   rttUs = -1.0;
+    uint32_t windows = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Writer state (socket thread only)
+// ---------------------------------------------------------------------------
+Sample g_history[kWindows];     // Ring of finished window bests
+size_t g_history_head = 0;
+size_t g_history_count = 0;
+Sample g_current;               // Best of the open window
+double g_window_start = 0.0;
+bool   g_have_current = false;
+bool   g_two_way = false;
+int    g_deviating = 0;
+Model  g_model;
+
+// ---------------------------------------------------------------------------
+// Published model (sequence lock; odd sequence = write in progress)
+// ---------------------------------------------------------------------------
+std::atomic<uint32_t> g_seq{ 0 };
+std::atomic<bool>     g_pub_valid{ false };
+std::atomic<bool>     g_pub_two_way{ false };
+std::atomic<double>   g_pub_offset{ 0.0 };
+std::atomic<double>   g_pub_drift{ 0.0 };
+std::atomic<double>   g_pub_ref{ 0.0 };
+std::atomic<double>   g_pub_rtt{ -1.0 };
+std::atomic<uint32_t> g_pub_windows{ 0 };
+
+void publish(const Model& m)
+{
+    g_seq.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    g_pub_valid.store(m.valid, std::memory_order_relaxed);
+    g_pub_two_way.store(m.twoWay, std::memory_order_relaxed);
+    g_pub_offset.store(m.offsetUs, std::memory_order_relaxed);
+    g_pub_drift.store(m.drift, std::memory_order_relaxed);
+    g_pub_ref.store(m.refUs, std::memory_order_relaxed);
+    g_pub_rtt.store(m.rttUs, std::memory_order_relaxed);
+    g_pub_windows.store(m.windows, std::memory_order_relaxed);
+    g_seq.fetch_add(1, std::memory_order_release);
+}
+
+Model load()
+{
+    Model m;
+    for (;;) {
+        const uint32_t before = g_seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        m.valid    = g_pub_valid.load(std::memory_order_relaxed);
+        m.twoWay   = g_pub_two_way.load(std::memory_order_relaxed);
+        m.offsetUs = g_pub_offset.load(std::memory_order_relaxed);
+        m.drift    = g_pub_drift.load(std::memory_order_relaxed);
+        m.refUs    = g_pub_ref.load(std::memory_order_relaxed);
+        m.rttUs    = g_pub_rtt.load(std::memory_order_relaxed);
+        m.windows  = g_pub_windows.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (g_seq.load(std::memory_order_relaxed) == before)
+            return m;
+    }
+}
+
+void clearSamples()
+{
+    g_history_head = g_history_count = 0;
+    g_have_current = false;
+    g_deviating = 0;
+    g_model = Model{};
+}
+
+// Exchanges: the fastest round trip bounds the error best. Arrivals: the
+// frame that reached us quickest shows the largest server - local.
+bool better(const Sample& a, const Sample& b)
+{
+    return g_two_way ? a.rttUs < b.rttUs : a.offsetUs > b.offsetUs;
+}
+
+void refit()
+{
+    Sample samples[kWindows + 1];
+    size_t n = 0;
+    for (size_t i = 0; i < g_history_count; ++i)
+        samples[n++] = g_history[(g_history_head + kWindows - g_history_count + i) % kWindows];
+    samples[n++] = g_current;
+
+    Model m;
+    m.valid = true;
+    m.twoWay = g_two_way;
+    m.refUs = g_current.localUs;
+    m.windows = static_cast<uint32_t>(n);
+
+    const Sample* best = &samples[0];
+    for (size_t i = 1; i < n; ++i)
+        if (better(samples[i], *best)) best = &samples[i];
+    m.rttUs = best->rttUs;
+
+    const double span = samples[n - 1].localUs - samples[0].localUs;
+    if (n >= 3 && span >= kMinFitSpanUs) {
+        double sx = 0.0, sy = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            sx += samples[i].localUs - m.refUs;
+            sy += samples[i].offsetUs;
+        }
+        const double mx = sx / n, my = sy / n;
+        double sxx = 0.0, sxy = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double dx = samples[i].localUs - m.refUs - mx;
+            sxx += dx * dx;
+            sxy += dx * (samples[i].offsetUs - my);
+        }
+        m.drift = std::clamp(sxy / sxx, -kMaxDrift, kMaxDrift);
+        m.offsetUs = my - m.drift * mx;
+    } else {
+        m.offsetUs = best->offsetUs;
+    }
+
+    g_model = m;
+    publish(m);
+}
+
+void addSample(const Sample& s)
+{
+    if (g_model.valid) {
+        const double predicted = g_model.offsetUs + g_model.drift * (s.localUs - g_model.refUs);
+        if (std::abs(s.offsetUs - predicted) > kStepUs) {
+            // One stalled frame is no reason to drop the model; a few in a
+            // row mean the server clock moved.
+            if (++g_deviating < kStepConfirm) return;
+            clearSamples();
+        }
+    }
+    g_deviating = 0;
+
+    if (!g_have_current || s.localUs >= g_window_start + kWindowUs) {
+        if (g_have_current) {
+            g_history[g_history_head] = g_current;
+            g_history_head = (g_history_head + 1) % kWindows;
+            g_history_count = std::min(g_history_count + 1, kWindows);
+        }
+        g_current = s;
+        g_window_start = s.localUs;
+        g_have_current = true;
+    } else if (better(s, g_current)) {
+        g_current = s;
+    }
+    refit();
+}
+
+} // namespace
+
+void reset()
+{
+    g_two_way = false;
+    clearSamples();
+    publish(g_model);
+}
+
+void addExchange(int64_t t0LocalUs, double t1ServerMs, double t2ServerMs, int64_t t3LocalUs)
+{
+    const double t1 = t1ServerMs * 1000.0, t2 = t2ServerMs * 1000.0;
+    const double rtt = static_cast<double>(t3LocalUs - t0LocalUs) - (t2 - t1);
+    if (t3LocalUs < t0LocalUs || rtt < 0.0) return;
+
+    if (!g_two_way) {
+        // One-way arrivals are biased by the path delay; start over on the
+        // better samples.
+        g_two_way = true;
+        clearSamples();
+    }
+    Sample s;
+    s.localUs = static_cast<double>(t3LocalUs);
+    s.offsetUs = ((t1 - t0LocalUs) + (t2 - t3LocalUs)) / 2.0;
+    s.rttUs = rtt;
+    addSample(s);
+}
+
+void addArrival(double serverMs, int64_t arrivalLocalUs)
+{
+    if (g_two_way) return;
+    Sample s;
+    s.localUs = static_cast<double>(arrivalLocalUs);
+    s.offsetUs = serverMs * 1000.0 - static_cast<double>(arrivalLocalUs);
+    addSample(s);
+}
+
+bool toLocalUs(double serverMs, int64_t& localUs)
+{
+    const Model m = load();
+    if (!m.valid) return false;
+    // local = server - offset(local); one fixed-point step is exact to ppm^2.
+    const double server = serverMs * 1000.0;
+    const double guess = server - m.offsetUs;
+    localUs = std::llround(server - (m.offsetUs + m.drift * (guess - m.refUs)));
+    return true;
+}
+
+Estimate estimate()
+{
+    const Model m = load();
+    Estimate e;
+    e.valid = m.valid;
+    e.twoWay = m.twoWay;
+    e.windows = m.windows;
+    e.driftPpm = m.drift * 1e6;
+    e.rttMs = m.rttUs < 0.0 ? -1.0 : m.rttUs / 1000.0;
+    // Offset evaluated at the latest sample; drift moves it by ppm per second.
+    e.offsetMs = m.offsetUs / 1000.0;
+    return e;
+}
+
+} // namespace ServerClock
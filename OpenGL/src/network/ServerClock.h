@@ -0,0 +1,54 @@
+#pragma once
+
+// ============================================================================
+// ServerClock — the Track Server's clock as seen from this machine.
+//
+// One model for the whole connection: offset (server - local) and drift,
+// fitted over the last minute, that maps a server_time_ms onto the local
+// steady clock (the VehicleInterpolator / TelemetryLatency time base). Every
+// car of the Track Server shares it, in place of the per-vehicle offsets
+// the other sources keep.
+//
+// Samples come from two places, both on the socket thread:
+//   * ping/pong exchanges (NTP-style t0..t3) when the server offers them —
+//     offset = ((t1 - t0) + (t2 - t3)) / 2, good to within RTT/2;
+//   * otherwise every state frame's server_time_ms against its arrival,
+//     which puts the offset off by the smallest one-way delay seen.
+// Per 2 s window only the best sample is kept (lowest RTT, or the one that
+// spent least time in flight), so queuing and jitter do not move the model;
+// the window bests are fitted by least squares for the drift.
+//
+// The model is published through a sequence lock: readers on any thread
+// never block and never see a half-written update.
+// ============================================================================
+
+#include <cstdint>
+
+namespace ServerClock {
+
+// Socket thread (the only writer). Forget everything — new connection or
+// the server's clock stepped.
+void reset();
+
+// One ping/pong exchange: t0/t3 local steady us (sent / pong received),
+// t1/t2 server ms (ping received / pong sent).
+void addExchange(int64_t t0LocalUs, double t1ServerMs, double t2ServerMs, int64_t t3LocalUs);
+
+// A server-stamped frame and when it arrived (ignored once exchanges are
+// coming in).
+void addArrival(double serverMs, int64_t arrivalLocalUs);
+
+// Any thread, lock-free. False until the first sample.
+bool toLocalUs(double serverMs, int64_t& localUs);
+
+struct Estimate {
+    bool     valid = false;
+    bool     twoWay = false;        // From ping/pong (else one-way frames)
+    double   offsetMs = 0.0;        // server - local, now
+    double   driftPpm = 0.0;
+    double   rttMs = -1.0;          // Best recent round trip; -1 one-way
+    uint32_t windows = 0;           // Windows in the fit
+};
+Estimate estimate();
+
+} // namespace ServerClock
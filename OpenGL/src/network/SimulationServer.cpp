@@ -3,12 +3,15 @@
 #include "../network/Server.h"
 #include "../vehicle/Vehicle.h"
 #include "../vehicle/VehicleInterpolator.h"
+#include "../vehicle/VehicleFilter.h"
 #include "../input/Input.h"
 #include "../rendering/Interpolation.h"
 #include "../Config.h"
 #include "../racing/RaceManager.h"
 #include "../track/TrackRecorder.h"
 #include "../track/TelemetryTrackBuilder.h"
+#include "../track/TrackGeometry.h"
+#include "TelemetryIngest.h"
 #include <random>
 #include <chrono>
 #include <unordered_map>
@@ -21,6 +24,7 @@
 #include <array>
 #include <GeographicLib/UTMUPS.hpp>  // For accurate GPS conversion
 #include "../../UI.h"
+#include "../core/Log.h"
 
 extern UI* g_ui;
 
@@ -29,10 +33,7 @@ extern UI* g_ui;
 // ============================================================================
 extern std::map<int32_t, Vehicle> g_vehicles;
 extern std::mutex g_vehicles_mutex;
-extern MapOrigin g_map_origin;
 extern std::atomic<bool> g_is_map_loaded;
-extern std::vector<SplinePoint> g_smooth_track_points;
-extern std::mutex g_track_mutex;
 extern RaceManager* g_race_manager;
 
 static std::atomic<bool> g_simulation_stop_requested{ false };
@@ -57,6 +58,28 @@ namespace {
     // Track mismatch debounce (per race vehicle id)
     std::mutex g_track_mismatch_mutex;
     std::unordered_map<int32_t, uint32_t> g_track_mismatch_start_ms;
+
+    // Map-matching hint per race vehicle id (see matchTrackProgress): last
+    // accepted segment / arc length on the centre line, the TrackGeometry
+    // version they refer to and the time of the fix they came from. Kept
+    // outside Vehicle so ingest can project without g_vehicles_mutex.
+    struct TrackMatchState
+    {
+        int64_t segment = -1;   // -1 = no hint, next fix does a global search
+        double arcLength = 0.0;
+        double progress = 0.0;  // returned again when a fix is rejected
+        uint64_t trackVersion = 0;
+        double fixTime = 0.0;   // Snapshot time of that fix (s, interpolation clock)
+        int rejectedFixes = 0;
+    };
+
+    std::mutex g_track_match_mutex;
+    std::unordered_map<int32_t, TrackMatchState> g_track_match;
+
+    // State estimate per race vehicle id (see VehicleFilter): every fix goes
+    // through it before the track matcher, S/F detection and the interpolator
+    // see the position. Guarded by g_track_match_mutex, dropped with the hint.
+    std::unordered_map<int32_t, VehicleFilter> g_vehicle_filters;
 }
 uint32_t telemetryGetPacketsPerSecond()
 {
@@ -80,8 +103,16 @@ uint32_t telemetryGetPacketsPerSecond()
 
 void telemetryResetPrototypeIdMapping()
 {
-    std::lock_guard<std::mutex> lock(s_proto_map_mutex);
-    s_proto_to_race_id.clear();
+    {
+        std::lock_guard<std::mutex> lock(s_proto_map_mutex);
+        s_proto_to_race_id.clear();
+    }
+
+    // Race ids get reassigned, so their matching hints and filters are
+    // meaningless now.
+    std::lock_guard<std::mutex> lock(g_track_match_mutex);
+    g_track_match.clear();
+    g_vehicle_filters.clear();
 }
 
 int32_t telemetryGetRaceIdForPrototype(int32_t prototype_id)
@@ -149,90 +180,67 @@ namespace {
 
     std::mutex g_time_sync_mutex;
     std::unordered_map<int32_t, VehicleTimeSync> g_time_sync;
-}
 
-double getSynchronizedSnapshotTimeSeconds(int32_t vehicleID, uint32_t sourceTimeMs)
-{
-    const double localNow = VehicleInterpolator::GetTime();
-
-    if (sourceTimeMs == 0) {
-        return localNow;
-    }
-
-    const double packetTimeSeconds = static_cast<double>(sourceTimeMs) / 1000.0;
+    // g_time_sync_mutex MUST be held by caller (batch ingest stamps a whole
+    // frame under one lock).
+    double synchronizedSnapshotTimeLocked(int32_t vehicleID, uint32_t sourceTimeMs, double localNow)
+    {
+        if (sourceTimeMs == 0) {
+            return localNow;
+        }
 
-    std::lock_guard<std::mutex> lock(g_time_sync_mutex);
-    VehicleTimeSync& ts = g_time_sync[vehicleID];
+        const double packetTimeSeconds = static_cast<double>(sourceTimeMs) / 1000.0;
+        VehicleTimeSync& ts = g_time_sync[vehicleID];
 
-    const double sampleOffset = localNow - packetTimeSeconds;
+        const double sampleOffset = localNow - packetTimeSeconds;
 
-    if (!ts.initialized)
-    {
-        ts.initialized = true;
-        ts.offsetSeconds = sampleOffset;
-    }
-    else
-    {
-        // If the source clock jumped (device reboot / midnight reset), re-sync.
-        const double predictedLocal = packetTimeSeconds + ts.offsetSeconds;
-        if (std::abs(predictedLocal - localNow) > 5.0)
+        if (!ts.initialized)
         {
+            ts.initialized = true;
             ts.offsetSeconds = sampleOffset;
         }
         else
         {
-            // Smooth offset to reduce noise without adding latency.
-            ts.offsetSeconds = ts.offsetSeconds * 0.98 + sampleOffset * 0.02;
+            // If the source clock jumped (device reboot / midnight reset), re-sync.
+            const double predictedLocal = packetTimeSeconds + ts.offsetSeconds;
+            if (std::abs(predictedLocal - localNow) > 5.0)
+            {
+                ts.offsetSeconds = sampleOffset;
+            }
+            else
+            {
+                // Smooth offset to reduce noise without adding latency.
+                ts.offsetSeconds = ts.offsetSeconds * 0.98 + sampleOffset * 0.02;
+            }
         }
+
+        return packetTimeSeconds + ts.offsetSeconds;
+    }
+}
+
+double getSynchronizedSnapshotTimeSeconds(int32_t vehicleID, uint32_t sourceTimeMs)
+{
+    const double localNow = VehicleInterpolator::GetTime();
+    if (sourceTimeMs == 0) {
+        return localNow;
     }
 
-    return packetTimeSeconds + ts.offsetSeconds;
+    std::lock_guard<std::mutex> lock(g_time_sync_mutex);
+    return synchronizedSnapshotTimeLocked(vehicleID, sourceTimeMs, localNow);
 }
 
 namespace {
     // Returns true if (x,y) is within `radius_meters` of the track polyline.
     // NOTE: x,y are in normalized coordinates; we convert radius to normalized units.
-    static bool isPositionNearCurrentTrack(double x, double y, double radius_meters)
+    static bool isPositionNearTrack(const TrackGeometry::Snapshot& track, double x, double y, double radius_meters)
     {
-        if (!g_is_map_loaded) {
-            return false;
-        }
-
-        std::vector<SplinePoint> trackCopy;
-        {
-            std::lock_guard<std::mutex> lock(g_track_mutex);
-            trackCopy = g_smooth_track_points;
-        }
-
-        if (trackCopy.size() < 2) {
+        if (!track.HasTrack()) {
             return false;
         }
 
-        const double radius_norm = radius_meters / MapConstants::MAP_SIZE;
-        const double radius_sq = radius_norm * radius_norm;
-
+        const float radius_norm = static_cast<float>(radius_meters / MapConstants::MAP_SIZE);
         const glm::vec2 p(static_cast<float>(x), static_cast<float>(y));
-
-        const size_t segmentCount = trackCopy.size() - 1;
-        for (size_t i = 0; i < segmentCount; ++i)
-        {
-            const glm::vec2 a = trackCopy[i].position;
-            const glm::vec2 b = trackCopy[i + 1].position;
-
-            const glm::vec2 ab = b - a;
-            const float abLenSq = glm::dot(ab, ab);
-            if (abLenSq <= 1e-12f)
-                continue;
-
-            const float t = glm::clamp(glm::dot(p - a, ab) / abLenSq, 0.0f, 1.0f);
-            const glm::vec2 closest = a + ab * t;
-            const glm::vec2 d = p - closest;
-            const double distSq = static_cast<double>(glm::dot(d, d));
-            if (distSq <= radius_sq)
-                return true;
-        }
-
-        return false;
+        return track.segmentIndex.IsWithin(p, radius_norm);
     }
 }
 
@@ -240,104 +248,97 @@ namespace {
     // ------------------------------------------------------------------------
     // Track progress: compute 0..1 progress from current normalized position by
     // projecting onto the closest track segment (server and client will match
-    // as long as they share the same `g_smooth_track_points`).
+    // as long as they share the same track geometry). Cumulative distances and
+    // the segment grid come precomputed with the TrackGeometry snapshot.
+    //
+    // Map matching with temporal coherence: consecutive fixes of one vehicle
+    // land on the same or an adjacent segment, so the projection first searches
+    // a short window of the centre line around the vehicle's last segment and
+    // only falls back to the global grid search if nothing in that window is
+    // close enough. The window (and the hint) keep a car on its own branch
+    // where the layout doubles back, instead of snapping to whichever branch
+    // happens to be nearest.
+    //
+    // A match whose arc length moved further than the car could have driven
+    // since the last accepted fix is rejected and the previous progress is
+    // kept. The budget grows with the time since that fix, and after
+    // kMatchMaxRejectedFixes in a row the global match is trusted anyway (the
+    // car really is elsewhere — pit lane, tracker reset, wrong start point).
     // ------------------------------------------------------------------------
-    struct TrackProgressCache {
-        size_t pointCount = 0;
-        std::vector<float> cumulativeDistances;
-        float totalLength = 0.0f;
-    };
-
-    std::mutex g_track_progress_mutex;
-    TrackProgressCache g_track_progress_cache;
-
-    void ensureTrackProgressCacheLocked(const std::vector<SplinePoint>& track)
+    constexpr double kMatchWindowBackMeters = 20.0;
+    constexpr double kMatchWindowMinAheadMeters = 30.0;
+    constexpr double kMatchMaxHintErrorMeters = 10.0;
+    constexpr double kMatchSpeedFactor = 1.5;       // reported speed lags / is noisy
+    constexpr double kMatchSpeedMarginMps = 5.0;    // stationary cars still drift a little
+    constexpr double kMatchJumpSlackMeters = 15.0;  // GNSS noise + projection error
+    constexpr int kMatchMaxRejectedFixes = 10;
+
+    // g_track_match_mutex MUST be held by caller (owns `state`).
+    double matchTrackProgress(const TrackGeometry::Snapshot& track, TrackMatchState& state,
+                              double x, double y, double speedKph, double fixTime)
     {
-        if (track.size() == g_track_progress_cache.pointCount && g_track_progress_cache.totalLength > 1e-6f) {
-            return;
-        }
-
-        g_track_progress_cache.pointCount = track.size();
-        g_track_progress_cache.cumulativeDistances.clear();
-        g_track_progress_cache.totalLength = 0.0f;
-
-        if (track.size() < 2) {
-            return;
-        }
-
-        g_track_progress_cache.cumulativeDistances.reserve(track.size());
-        g_track_progress_cache.cumulativeDistances.push_back(0.0f);
-
-        float total = 0.0f;
-        for (size_t i = 1; i < track.size(); ++i)
-        {
-            const float seg = glm::distance(track[i - 1].position, track[i].position);
-            total += seg;
-            g_track_progress_cache.cumulativeDistances.push_back(total);
-        }
-
-        g_track_progress_cache.totalLength = total;
-    }
-
-    double calculateTrackProgressFromPosition(double x, double y)
-    {
-        if (!g_is_map_loaded) {
+        if (!track.HasTrack() || track.openLength <= 1e-6f) {
+            state = TrackMatchState{};
             return 0.0;
         }
 
-        std::vector<SplinePoint> trackCopy;
-        {
-            std::lock_guard<std::mutex> lock(g_track_mutex);
-            trackCopy = g_smooth_track_points;
-        }
+        const double metersPerUnit = static_cast<double>(MapConstants::MAP_SIZE);
+        const double openLength = static_cast<double>(track.openLength);
+        const glm::vec2 p(static_cast<float>(x), static_cast<float>(y));
 
-        if (trackCopy.size() < 2) {
-            return 0.0;
+        const bool haveHint = state.segment >= 0 &&
+            state.trackVersion == track.version &&
+            static_cast<size_t>(state.segment) + 1 < track.points.size();
+
+        // Distance the car may have covered since the last accepted fix, on
+        // the fixes' own timestamps: a batch that queued up behind a stall
+        // arrives all at once, but its fixes are still 100 ms apart.
+        double travelBudgetMeters = 0.0;
+        if (haveHint) {
+            const double dt = fixTime - state.fixTime;
+            const double speedMps = std::max(speedKph, 0.0) / 3.6;
+            travelBudgetMeters = (speedMps * kMatchSpeedFactor + kMatchSpeedMarginMps) * std::max(dt, 0.0) + kMatchJumpSlackMeters;
         }
 
-        std::lock_guard<std::mutex> lock(g_track_progress_mutex);
-        ensureTrackProgressCacheLocked(trackCopy);
+        TrackSpatialIndex::Hit hit;
+        if (haveHint) {
+            const float back = static_cast<float>(kMatchWindowBackMeters / metersPerUnit);
+            const float ahead = static_cast<float>(std::max(kMatchWindowMinAheadMeters, travelBudgetMeters) / metersPerUnit);
+            hit = track.segmentIndex.NearestAround(p, static_cast<size_t>(state.segment), back, ahead);
 
-        if (g_track_progress_cache.totalLength <= 1e-6f) {
-            return 0.0;
+            const float maxErr = static_cast<float>(kMatchMaxHintErrorMeters / metersPerUnit);
+            if (hit.found && hit.distSq > maxErr * maxErr)
+                hit = TrackSpatialIndex::Hit{};
         }
-
-        // Track points may be recentred and rendered with an offset. Vehicle positions are stored
-        // in raw normalized coordinates (relative to origin) and rendered with that same offset.
-        // To validate against the current recentered track geometry, compare in track space.
-        const glm::vec2 p(static_cast<float>(x), static_cast<float>(y));
-
-        double bestDistSq = std::numeric_limits<double>::infinity();
-        double bestDistanceAlong = 0.0;
-
-        const size_t segmentCount = trackCopy.size() - 1;
-        for (size_t i = 0; i < segmentCount; ++i)
-        {
-            const glm::vec2 a = trackCopy[i].position;
-            const glm::vec2 b = trackCopy[i + 1].position;
-            const glm::vec2 ab = b - a;
-            const float abLenSq = glm::dot(ab, ab);
-            if (abLenSq < 1e-10f) {
-                continue;
-            }
-
-            const float t = glm::clamp(glm::dot(p - a, ab) / abLenSq, 0.0f, 1.0f);
-            const glm::vec2 proj = a + ab * t;
-            const glm::vec2 d = p - proj;
-            const double distSq = static_cast<double>(glm::dot(d, d));
-
-            if (distSq < bestDistSq)
-            {
-                bestDistSq = distSq;
-                const float segLen = std::sqrt(abLenSq);
-                bestDistanceAlong = static_cast<double>(g_track_progress_cache.cumulativeDistances[i]) + static_cast<double>(segLen * t);
+        if (!hit.found)
+            hit = track.segmentIndex.Nearest(p);
+        if (!hit.found)
+            return state.progress;
+
+        const double arc = static_cast<double>(track.cumulative[hit.segment]) +
+            static_cast<double>(hit.segmentLength * hit.t);
+
+        if (haveHint) {
+            // Shortest signed distance along the loop (crossing start/finish is
+            // a small step, not a full lap).
+            double delta = arc - state.arcLength;
+            if (delta > openLength * 0.5)       delta -= openLength;
+            else if (delta < -openLength * 0.5) delta += openLength;
+
+            if (std::abs(delta) * metersPerUnit > travelBudgetMeters &&
+                state.rejectedFixes < kMatchMaxRejectedFixes) {
+                ++state.rejectedFixes;
+                return state.progress;
             }
         }
 
-
-        double progress = bestDistanceAlong / static_cast<double>(g_track_progress_cache.totalLength);
-        progress = std::clamp(progress, 0.0, 1.0);
-        return progress;
+        state.segment = static_cast<int64_t>(hit.segment);
+        state.arcLength = arc;
+        state.progress = std::clamp(arc / openLength, 0.0, 1.0);
+        state.trackVersion = track.version;
+        state.fixTime = fixTime;
+        state.rejectedFixes = 0;
+        return state.progress;
     }
 
     static bool isPositionOnCurrentTrack(double x, double y)
@@ -345,37 +346,13 @@ namespace {
         if (!g_is_map_loaded)
             return false;
 
-        std::vector<SplinePoint> trackCopy;
-        {
-            std::lock_guard<std::mutex> lock(g_track_mutex);
-            trackCopy = g_smooth_track_points;
-        }
-
-        if (trackCopy.size() < 2)
+        const TrackGeometry::SnapshotPtr track = TrackGeometry::Current();
+        if (!track->HasTrack())
             return false;
 
         const glm::vec2 p(static_cast<float>(x), static_cast<float>(y));
-        double bestDistSq = std::numeric_limits<double>::infinity();
-        const size_t segmentCount = trackCopy.size() - 1;
-        for (size_t i = 0; i < segmentCount; ++i)
-        {
-            const glm::vec2 a = trackCopy[i].position;
-            const glm::vec2 b = trackCopy[i + 1].position;
-            const glm::vec2 ab = b - a;
-            const float abLenSq = glm::dot(ab, ab);
-            if (abLenSq < 1e-10f)
-                continue;
-
-            const float t = glm::clamp(glm::dot(p - a, ab) / abLenSq, 0.0f, 1.0f);
-            const glm::vec2 proj = a + ab * t;
-            const glm::vec2 d = p - proj;
-            const double distSq = static_cast<double>(glm::dot(d, d));
-            if (distSq < bestDistSq)
-                bestDistSq = distSq;
-        }
-
-        const double maxDistNorm = 15.0 / static_cast<double>(MapConstants::MAP_SIZE);
-        return bestDistSq <= (maxDistNorm * maxDistNorm);
+        const float maxDistNorm = static_cast<float>(15.0 / static_cast<double>(MapConstants::MAP_SIZE));
+        return track->segmentIndex.IsWithin(p, maxDistNorm);
     }
 
     void applyRaceStateFromPacket(Vehicle& vehicle, const VehicleStatePacket& packet)
@@ -425,217 +402,85 @@ namespace {
 // UNIFIED TELEMETRY PROCESSING - Single entry point for all data sources
 // Used by: simulation, real COM port, network clients
 // ============================================================================
-// One physical packet received by the PC (COM frame or one WebSocket state
-// message — NOT one car record). PPS is a sliding window: packets whose
-// arrival timestamps are within the last 1000ms.
-void telemetryCountPacket()
-{
-    const uint32_t now_ms = getMonotonicTimeMs();
-
-    std::lock_guard<std::mutex> lock(g_pps_mutex);
-    g_pps_last_packet_ms = now_ms;
-
-    // Push timestamp
-    g_pps_ring[g_pps_head] = now_ms;
-    g_pps_head = (g_pps_head + 1) % kPpsRingSize;
-    if (g_pps_count < kPpsRingSize)
-        ++g_pps_count;
-
-    // Drop timestamps older than 1s
-    while (g_pps_count > 0)
-    {
-        const size_t tail = (g_pps_head + kPpsRingSize - g_pps_count) % kPpsRingSize;
-        const uint32_t t = g_pps_ring[tail];
-        if ((now_ms - t) <= 1000)
-            break;
-        --g_pps_count;
-    }
-
-    g_telemetry_packets_per_second.store(static_cast<uint32_t>(g_pps_count), std::memory_order_relaxed);
-}
-
-void processIncomingTelemetry(const TelemetryPacket& packet, bool count_pps)
-{
-    // If we are in telemetry track creation mode, feed packets into builder.
-    // Builder will auto-initialize origin from the first packet.
-    if (TelemetryTrackBuilder::IsActive())
-    {
-        TelemetryTrackBuilder::OnTelemetryPacket(packet);
-    }
-    if (count_pps)
-        telemetryCountPacket();
-
-    if (packet.MagicMarker != PACKET_MAGIC_DATA && packet.MagicMarker != PacketMagic::DATA)
+namespace {
+    // Pushes `count` arrival timestamps into the PPS window.
+    void countPackets(uint32_t count)
     {
-        return;
-    }
+        const uint32_t now_ms = getMonotonicTimeMs();
 
-    // Map prototype/device IDs (coming from hardware) to race vehicle IDs (1..99).
-    // This decouples device identity from race identity and keeps IDs UI-friendly.
+        std::lock_guard<std::mutex> lock(g_pps_mutex);
+        g_pps_last_packet_ms = now_ms;
 
-    // Ignore telemetry until a track is loaded.
-    // COM port can stay connected, but we don't create/update vehicles without the map origin.
-    // NOTE: Prototype->race assignment still happens so UI can show "Connected" immediately.
-    if (!g_is_map_loaded)
-    {
-        static std::atomic<bool> warned{ false };
-        if (!warned.exchange(true))
+        // Push timestamps
+        for (uint32_t i = 0; i < count; ++i)
         {
-            std::cerr << "[TELEMETRY] Ignoring telemetry updates: map/track is not loaded yet." << std::endl;
+            g_pps_ring[g_pps_head] = now_ms;
+            g_pps_head = (g_pps_head + 1) % kPpsRingSize;
+            if (g_pps_count < kPpsRingSize)
+                ++g_pps_count;
         }
-        return;
-    }
 
-    int32_t raceID = -1;
-    bool isNewMapping = false;
-    {
-        std::lock_guard<std::mutex> lock(s_proto_map_mutex);
-        auto it = s_proto_to_race_id.find(packet.ID);
-        if (it != s_proto_to_race_id.end())
-        {
-            raceID = it->second;
-        }
-        else
+        // Drop timestamps older than 1s
+        while (g_pps_count > 0)
         {
-            // Allocate a free race ID (1..99) that is not currently in use.
-            // Must coordinate with g_vehicles to avoid collisions with simulated racers.
-            std::lock_guard<std::mutex> vlock(g_vehicles_mutex);
-            raceID = allocateRaceIdLocked();
-            if (raceID != -1)
-            {
-                s_proto_to_race_id.emplace(packet.ID, raceID);
-                isNewMapping = true;
-            }
+            const size_t tail = (g_pps_head + kPpsRingSize - g_pps_count) % kPpsRingSize;
+            const uint32_t t = g_pps_ring[tail];
+            if ((now_ms - t) <= 1000)
+                break;
+            --g_pps_count;
         }
-    }
 
-    if (raceID == -1)
-    {
-        static std::atomic<bool> warnedIds{ false };
-        if (!warnedIds.exchange(true))
-        {
-            std::cerr << "[TELEMETRY] No free race IDs available (1..99). Ignoring telemetry." << std::endl;
-        }
-        return;
-    }
-
-    if (isNewMapping)
-    {
-        std::cout << "[TELEMETRY] Prototype #" << packet.ID << " assigned race vehicle #" << raceID << std::endl;
-        if (g_ui) {
-            g_ui->NotifyPrototypeConnected(raceID);
-        }
-    }
-
-    // If origin isn't initialized yet (zone + UTM origin), GPS->UTM conversion can fail.
-    // This would collapse vehicle positions to (0,0) and look like a constant render offset.
-    {
-        const int zone = g_map_origin.m_origin_zone_int;
-        const bool origin_ok = (zone >= 1 && zone <= 60) &&
-            (std::abs(g_map_origin.m_origin_meters_easting) > 1.0) &&
-            (std::abs(g_map_origin.m_origin_meters_northing) > 1.0);
-
-        if (!origin_ok)
-        {
-            static std::atomic<bool> warnedOrigin{ false };
-            if (!warnedOrigin.exchange(true))
-            {
-                std::cerr << "[TELEMETRY] Ignoring telemetry: map origin not initialized yet (zone/UTM origin invalid)." << std::endl;
-            }
-            return;
-        }
+        g_telemetry_packets_per_second.store(static_cast<uint32_t>(g_pps_count), std::memory_order_relaxed);
     }
 
-    // Track-fit validation: a vehicle can legitimately be off the racing line (pits, paddock),
-    // so we only treat telemetry as incompatible if it is FAR from the whole circuit.
-    // If it is near the track (within a large radius), keep the vehicle alive.
+    // One telemetry record after the lock-free part of ingest: race ID
+    // resolved, GPS converted to map coordinates, stamped with the
+    // synchronized snapshot time, filtered and projected onto the track.
+    struct PreparedTelemetry
     {
-        const double lat_deg = static_cast<double>(packet.lat) / 1e7;
-        const double lon_deg = static_cast<double>(packet.lon) / 1e7;
-        double easting = 0.0;
+        const TelemetryPacket* packet = nullptr;
+        int32_t raceID = -1;
+        double easting = 0.0;       // Filtered once the vehicle's filter is seeded
         double northing = 0.0;
-        coordinatesToMeters(lat_deg, lon_deg, easting, northing);
         double nx = 0.0;
         double ny = 0.0;
-        getCoordinateDifferenceFromOrigin(easting, northing, nx, ny);
-
-        constexpr double kNearTrackRadiusMeters = 1000.0; // 1km
-        const bool nearTrack = isPositionNearCurrentTrack(nx, ny, kNearTrackRadiusMeters);
-        const uint32_t now_ms = getMonotonicTimeMs();
-        constexpr uint32_t kFarFromTrackGraceMs = 5000; // debounce for wrong-track / wrong-origin
-
-        if (!nearTrack)
-        {
-            uint32_t start_ms = 0;
-            {
-                std::lock_guard<std::mutex> lock(g_track_mismatch_mutex);
-                auto& v = g_track_mismatch_start_ms[raceID];
-                if (v == 0)
-                    v = now_ms;
-                start_ms = v;
-            }
-
-            if ((now_ms - start_ms) >= kFarFromTrackGraceMs)
-            {
-                std::lock_guard<std::mutex> lock(g_vehicles_mutex);
-                auto it = g_vehicles.find(raceID);
-                if (it != g_vehicles.end())
-                {
-                    g_vehicles.erase(it);
-                    VehicleInterpolator::Get().RemoveVehicle(raceID);
-                    std::cout << "[TELEMETRY] Vehicle #" << raceID << " removed: far from track (>" << kNearTrackRadiusMeters << "m)" << std::endl;
-                }
-
-                std::lock_guard<std::mutex> mlock(g_track_mismatch_mutex);
-                g_track_mismatch_start_ms.erase(raceID);
-            }
-
-            return;
-        }
-        else
-        {
-            // Back on track => clear mismatch state
-            std::lock_guard<std::mutex> lock(g_track_mismatch_mutex);
-            g_track_mismatch_start_ms.erase(raceID);
-        }
-    }
-
-    // ? Debug: print packet info to diagnose coordinate issues
-    static int packet_count = 0;
-    packet_count++;
-    if (packet_count % 60 == 0) { // Log every 60th packet (once per second at ~60Hz)
-        // Arduino packs GPS as scaled integers: degrees * 1e7
-        const double lat_deg = static_cast<double>(packet.lat) / 1e7;
-        const double lon_deg = static_cast<double>(packet.lon) / 1e7;
-        std::cout << "[TELEMETRY DEBUG] Prototype ID=" << packet.ID << " -> Vehicle #" << raceID
-               << " | GPS: (" << lat_deg << ", " << lon_deg << ")"
-                  << " | Speed: " << (packet.speed / 100.0) << " km/h" << std::endl;
-    }
+        double trackProgress = 0.0;
+        double snapshotTime = 0.0;
+        bool filtered = false;      // Heading/yaw rate/speed below are valid
+        double heading = 0.0;
+        double yawRate = 0.0;
+        double speedKph = 0.0;
+    };
 
-    // ? CRITICAL DEBUG: Check vehicle existence BEFORE lock
-    bool vehicle_exists = false;
+    // Scratch buffers, reused per ingest thread so a steady stream of frames
+    // does not allocate.
+    thread_local std::vector<PreparedTelemetry> t_prepared;
+    thread_local std::vector<std::pair<int32_t, int32_t>> t_new_mappings; // prototype -> race
+    thread_local std::vector<int32_t> t_far_from_track;
+    thread_local std::vector<VehicleSnapshotUpdate> t_snapshots;
+    thread_local std::vector<VehicleStatePacket> t_states;
+    thread_local std::vector<double> t_lat, t_lon, t_easting, t_northing;
+
+    // Fix timestamp for RaceManager::OnPositionFix (interpolation clock, us)
+    int64_t fixTimeUs(double snapshotTime)
     {
-        std::lock_guard<std::mutex> check_lock(g_vehicles_mutex);
-        vehicle_exists = (g_vehicles.find(raceID) != g_vehicles.end());
-
-        // Print map contents on creation
-        if (!vehicle_exists && packet_count % 10 == 0) {
-            std::cout << "[DEBUG] Vehicle #" << raceID << " NOT in map. Current: ";
-            for (const auto& [id, v] : g_vehicles) {
-                std::cout << "#" << id << " ";
-            }
-            std::cout << "(total: " << g_vehicles.size() << ")" << std::endl;
-        }
+        return static_cast<int64_t>(std::llround(snapshotTime * 1e6));
     }
 
-    // 1) Update authoritative server-side vehicle state from telemetry.
-    // Also replicate at a bounded rate to avoid UI jitter from uneven serial packet timing.
-    static std::mutex s_send_rate_mutex;
-    static std::unordered_map<int32_t, uint32_t> s_last_send_time_ms;
-    const uint32_t now_ms = getMonotonicTimeMs();
+    // Replicate at a bounded rate to avoid UI jitter from uneven serial packet timing.
+    std::mutex s_send_rate_mutex;
+    std::unordered_map<int32_t, uint32_t> s_last_send_time_ms;
     constexpr uint32_t kMinSendIntervalMs = 16; // ~60 Hz
+
+    // g_vehicles_mutex and s_send_rate_mutex MUST be held by caller. Snapshots
+    // and state packets are queued and published by the caller after unlocking.
+    void applyTelemetryLocked(const PreparedTelemetry& rec, const TrackGeometry::Snapshot& track,
+                              uint32_t now_ms,
+                              std::vector<VehicleSnapshotUpdate>& snapshots,
+                              std::vector<VehicleStatePacket>& states)
     {
-        std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+        const TelemetryPacket& packet = *rec.packet;
+        const int32_t raceID = rec.raceID;
 
         auto it = g_vehicles.find(raceID);
 
@@ -654,79 +499,78 @@ void processIncomingTelemetry(const TelemetryPacket& packet, bool count_pps)
             vehicle.m_lon_dd = packet.lon / 1e7;
             vehicle.m_speed_kph = packet.speed / 100.0;
             vehicle.m_acceleration = packet.acceleration / 100.0;
-            vehicle.m_g_force_x = packet.gForceX / 100.0;
-            vehicle.m_g_force_y = packet.gForceY / 100.0;
+            vehicle.m_g_force_x = static_cast<int16_t>(packet.gForceX) / 100.0;   // Signed on the wire
+            vehicle.m_g_force_y = static_cast<int16_t>(packet.gForceY) / 100.0;
             vehicle.m_fix_type = packet.fixtype;
 
-            coordinatesToMeters(vehicle.m_lat_dd, vehicle.m_lon_dd, 
-                               vehicle.m_meters_easting, vehicle.m_meters_northing);
-            getCoordinateDifferenceFromOrigin(vehicle.m_meters_easting, vehicle.m_meters_northing,
-                                             vehicle.m_normalized_x, vehicle.m_normalized_y);
-
-            // Track points are physically recentered to (0,0) and map origin is updated accordingly.
-            // Vehicles computed from the same origin are already in the same coordinate space.
+            // Converted outside the lock (same origin as the track snapshot).
+            vehicle.m_meters_easting = rec.easting;
+            vehicle.m_meters_northing = rec.northing;
+            vehicle.m_normalized_x = rec.nx;
+            vehicle.m_normalized_y = rec.ny;
 
             // Track recording uses positions in the same space as rendered track/vehicles.
             TrackRecorder::OnTelemetryPosition(raceID, glm::vec2(static_cast<float>(vehicle.m_normalized_x), static_cast<float>(vehicle.m_normalized_y)));
 
-            // [DEBUG_ALIGN_TMP] Raw vs render position (once per second)
-            if ((packet_count % 60) == 0)
+            // [DEBUG_ALIGN_TMP] Raw vs render position (every 60th update)
             {
                 // vehicle.m_normalized_* is already in race/render space (offset applied above)
                 const double rx = vehicle.m_normalized_x;
                 const double ry = vehicle.m_normalized_y;
-                std::cout.setf(std::ios::fixed);
-                std::cout << "[DEBUG_ALIGN_TMP] upd proto=" << packet.ID
+                LOG_DEBUG_EVERY_N(Telemetry, 60, std::fixed << "[DEBUG_ALIGN_TMP] upd proto=" << packet.ID
                     << " race=" << raceID
                     << " utm=(" << std::setprecision(3) << vehicle.m_meters_easting << "," << vehicle.m_meters_northing << ")"
                     << " norm_race=(" << std::setprecision(6) << vehicle.m_normalized_x << "," << vehicle.m_normalized_y << ")"
-                    << " norm_render=(" << rx << "," << ry << ")"
-                    << std::endl;
+                    << " norm_render=(" << rx << "," << ry << ")");
             }
 
-            // Update track progress (needed for consistent leader + lap logic on clients)
-            vehicle.m_track_progress = calculateTrackProgressFromPosition(vehicle.m_normalized_x, vehicle.m_normalized_y);
+            // Track progress (needed for consistent leader + lap logic on clients)
+            vehicle.m_track_progress = rec.trackProgress;
 
             vehicle.m_last_update_time = std::chrono::steady_clock::now();
             vehicle.m_has_authoritative_state = false;
 
-            // ? Calculate heading from movement (only if vehicle moved significantly)
-            double dx = vehicle.m_normalized_x - vehicle.m_prev_x;
-            double dy = vehicle.m_normalized_y - vehicle.m_prev_y;
-            double distance_moved = std::sqrt(dx * dx + dy * dy);
-
-            // Only update heading if vehicle moved at least 1 meter (0.01 in normalized coords)
+            // ? Heading from the filter; without one yet, from movement (only
+            // if vehicle moved significantly)
             double new_heading = vehicle.m_heading; // Keep previous heading by default
-            if (distance_moved > 0.01) {
-                new_heading = std::atan2(dy, dx);
-                vehicle.m_heading = new_heading; // Update stored heading
+            if (rec.filtered) {
+                new_heading = rec.heading;
+                vehicle.m_heading = new_heading;
+            } else {
+                double dx = vehicle.m_normalized_x - vehicle.m_prev_x;
+                double dy = vehicle.m_normalized_y - vehicle.m_prev_y;
+                double distance_moved = std::sqrt(dx * dx + dy * dy);
+
+                // Only update heading if vehicle moved at least 1 meter (0.01 in normalized coords)
+                if (distance_moved > 0.01) {
+                    new_heading = std::atan2(dy, dx);
+                    vehicle.m_heading = new_heading; // Update stored heading
+                }
             }
 
-            // ? Add snapshot to interpolator for smooth rendering
-            VehicleSnapshot snapshot;
-            snapshot.timestamp = getSynchronizedSnapshotTimeSeconds(raceID, packet.time);
-            snapshot.x = vehicle.m_normalized_x;
-            snapshot.y = vehicle.m_normalized_y;
-            snapshot.speed_kph = vehicle.m_speed_kph;
-            snapshot.heading = new_heading;
-            snapshot.track_progress = vehicle.m_track_progress;
-
-            VehicleInterpolator::Get().AddSnapshot(raceID, snapshot);
+            // ? Queue snapshot for the interpolator (smooth rendering)
+            VehicleSnapshotUpdate update;
+            update.vehicleID = raceID;
+            update.snapshot.timestamp = rec.snapshotTime;
+            update.snapshot.x = vehicle.m_normalized_x;
+            update.snapshot.y = vehicle.m_normalized_y;
+            update.snapshot.speed_kph = rec.filtered ? rec.speedKph : vehicle.m_speed_kph;
+            update.snapshot.heading = new_heading;
+            update.snapshot.yaw_rate = rec.yawRate;
+            update.snapshot.track_progress = vehicle.m_track_progress;
+            snapshots.push_back(update);
+
+            // Lap timing on this fix's own timestamp
+            if (g_race_manager)
+                g_race_manager->OnPositionFix(raceID, vehicle, fixTimeUs(rec.snapshotTime), track);
 
             // Replicate authoritative state to clients (including lap timing produced by RaceManager).
-         bool should_send = true;
-            {
-                std::lock_guard<std::mutex> rlock(s_send_rate_mutex);
-                auto& last = s_last_send_time_ms[raceID];
-                if (last != 0 && (now_ms - last) < kMinSendIntervalMs)
-                    should_send = false;
-                else
-                    last = now_ms;
-            }
+            auto& last = s_last_send_time_ms[raceID];
+            if (last != 0 && (now_ms - last) < kMinSendIntervalMs)
+                return;
+            last = now_ms;
 
-            if (should_send)
-            {
-                VehicleStatePacket state{};
+            VehicleStatePacket state{};
             state.magic_marker = PacketMagic::VSTA;
             state.vehicle_id = raceID;
             state.server_time_ms = (packet.time != 0) ? packet.time : now_ms;
@@ -736,48 +580,47 @@ void processIncomingTelemetry(const TelemetryPacket& packet, bool count_pps)
             state.speed_kph = static_cast<float>(vehicle.m_speed_kph);
             state.track_progress = static_cast<float>(vehicle.m_track_progress);
             fillPacketRaceStateFromVehicle(state, vehicle);
-            BroadcastVehicleStateToClients(state);
-           }
+            states.push_back(state);
         }
         else
         {
-            // ?? Vehicle NOT FOUND - this happens when:
-            // 1. Server sends telemetry for vehicle that client doesn't have yet (normal - create it)
-            // 2. Vehicle was deleted by timeout (should not recreate)
-
             // Create the vehicle from telemetry. Must NOT depend on the
             // removed GNS networking: both the standalone COM receiver and the
             // Track Server WebSocket stream land here and need vehicles.
-            std::cout << "[TELEMETRY] Creating new vehicle #" << raceID << " from prototype #" << packet.ID << std::endl;
+            LOG_INFO(Telemetry, "[TELEMETRY] Creating new vehicle #" << raceID << " from prototype #" << packet.ID);
 
-            Vehicle new_vehicle(packet);
+            // Same converted, filtered position an update would apply
+            Vehicle new_vehicle(packet, rec.easting, rec.northing, rec.nx, rec.ny);
+            if (rec.filtered)
+                new_vehicle.m_heading = rec.heading;
 
             // [DEBUG_ALIGN_TMP] Raw vs render position on create
             {
                 const double rx = new_vehicle.m_normalized_x;
                 const double ry = new_vehicle.m_normalized_y;
-                std::cout.setf(std::ios::fixed);
-                std::cout << "[DEBUG_ALIGN_TMP] create proto=" << packet.ID
+                LOG_DEBUG(Telemetry, std::fixed << "[DEBUG_ALIGN_TMP] create proto=" << packet.ID
                     << " race=" << raceID
                     << " utm=(" << std::setprecision(3) << new_vehicle.m_meters_easting << "," << new_vehicle.m_meters_northing << ")"
                     << " norm_race=(" << std::setprecision(6) << new_vehicle.m_normalized_x << "," << new_vehicle.m_normalized_y << ")"
-                    << " norm_render=(" << rx << "," << ry << ")"
-                    << std::endl;
+                    << " norm_render=(" << rx << "," << ry << ")");
             }
 
-            // Compute initial track progress (needed for correct leader/standings immediately)
-            new_vehicle.m_track_progress = calculateTrackProgressFromPosition(new_vehicle.m_normalized_x, new_vehicle.m_normalized_y);
+            // Initial track progress (needed for correct leader/standings immediately)
+            new_vehicle.m_track_progress = rec.trackProgress;
 
             TrackRecorder::OnTelemetryPosition(raceID, glm::vec2(static_cast<float>(new_vehicle.m_normalized_x), static_cast<float>(new_vehicle.m_normalized_y)));
 
-            // ? Add initial snapshot BEFORE moving
-            VehicleSnapshot snapshot;
-            snapshot.timestamp = getSynchronizedSnapshotTimeSeconds(raceID, packet.time);
-            snapshot.x = new_vehicle.m_normalized_x;
-            snapshot.y = new_vehicle.m_normalized_y;
-            snapshot.speed_kph = new_vehicle.m_speed_kph;
-            snapshot.heading = 0.0;
-            snapshot.track_progress = new_vehicle.m_track_progress;
+            // ? Queue initial snapshot BEFORE moving
+            VehicleSnapshotUpdate update;
+            update.vehicleID = raceID;
+            update.snapshot.timestamp = rec.snapshotTime;
+            update.snapshot.x = new_vehicle.m_normalized_x;
+            update.snapshot.y = new_vehicle.m_normalized_y;
+            update.snapshot.speed_kph = rec.filtered ? rec.speedKph : new_vehicle.m_speed_kph;
+            update.snapshot.heading = new_vehicle.m_heading;
+            update.snapshot.yaw_rate = rec.yawRate;
+            update.snapshot.track_progress = new_vehicle.m_track_progress;
+            snapshots.push_back(update);
 
             new_vehicle.m_has_authoritative_state = false;
 
@@ -788,7 +631,8 @@ void processIncomingTelemetry(const TelemetryPacket& packet, bool count_pps)
             // ? Use emplace to avoid default constructor call!
             auto [insertIt, inserted] = g_vehicles.emplace(raceID, std::move(new_vehicle));
 
-            VehicleInterpolator::Get().AddSnapshot(raceID, snapshot);
+            if (g_race_manager)
+                g_race_manager->OnPositionFix(raceID, insertIt->second, fixTimeUs(rec.snapshotTime), track);
 
             // Replicate initial authoritative state to clients.
             VehicleStatePacket state{};
@@ -801,12 +645,350 @@ void processIncomingTelemetry(const TelemetryPacket& packet, bool count_pps)
             state.speed_kph = static_cast<float>(insertIt->second.m_speed_kph);
             state.track_progress = static_cast<float>(insertIt->second.m_track_progress);
             fillPacketRaceStateFromVehicle(state, insertIt->second);
-            BroadcastVehicleStateToClients(state);
+            states.push_back(state);
+        }
+    }
+}
+
+// One physical packet received by the PC (COM frame or one WebSocket state
+// message — NOT one car record). PPS is a sliding window: packets whose
+// arrival timestamps are within the last 1000ms.
+void telemetryCountPacket()
+{
+    countPackets(1);
+}
+
+void processIncomingTelemetry(const TelemetryPacket& packet, bool count_pps)
+{
+    processIncomingTelemetryBatch(&packet, 1, count_pps);
+}
+
+// Every stage takes its lock once per batch instead of once per car:
+//   1. prototype -> race IDs                (s_proto_map_mutex)
+//   2. GPS -> map coordinates               (no lock)
+//   3. far-from-track debounce              (g_track_mismatch_mutex)
+//   4. track projection                     (g_track_match_mutex)
+//   5. snapshot time sync                   (g_time_sync_mutex; not for Track Server records)
+//   6. vehicle updates / creation / removal (g_vehicles_mutex, once)
+//   7. interpolator + client replication    (after g_vehicles_mutex is released)
+// With `stamps`, the stage boundaries are reported to TelemetryLatency.
+void processIncomingTelemetryBatch(const TelemetryPacket* packets, size_t count, bool count_pps,
+                                   const TelemetryLatency::Stamps* stamps)
+{
+    if (packets == nullptr || count == 0)
+        return;
+
+    TelemetryLatency::BatchTimes latency;
+    if (stamps)
+        latency.startUs = TelemetryLatency::nowUs();
+
+    // If we are in telemetry track creation mode, feed packets into builder.
+    // Builder will auto-initialize origin from the first packet.
+    if (TelemetryTrackBuilder::IsActive())
+    {
+        for (size_t i = 0; i < count; ++i)
+            TelemetryTrackBuilder::OnTelemetryPacket(packets[i]);
+    }
+    if (count_pps)
+        countPackets(static_cast<uint32_t>(count));
+
+    // Ignore telemetry until a track is loaded.
+    // COM port can stay connected, but we don't create/update vehicles without the map origin.
+    if (!g_is_map_loaded)
+    {
+        static std::atomic<bool> warned{ false };
+        if (!warned.exchange(true))
+        {
+            LOG_WARN(Telemetry, "[TELEMETRY] Ignoring telemetry updates: map/track is not loaded yet.");
+        }
+        return;
+    }
+
+    std::vector<PreparedTelemetry>& prepared = t_prepared;
+    prepared.clear();
+
+    // 1) Map prototype/device IDs (coming from hardware) to race vehicle IDs (1..99).
+    // This decouples device identity from race identity and keeps IDs UI-friendly.
+    std::vector<std::pair<int32_t, int32_t>>& newMappings = t_new_mappings;
+    newMappings.clear();
+    {
+        std::lock_guard<std::mutex> lock(s_proto_map_mutex);
+        // Only needed to allocate a new race ID (rare), so taken lazily.
+        std::unique_lock<std::mutex> vlock(g_vehicles_mutex, std::defer_lock);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const TelemetryPacket& packet = packets[i];
+            if (packet.MagicMarker != PACKET_MAGIC_DATA && packet.MagicMarker != PacketMagic::DATA)
+                continue;
+
+            int32_t raceID = -1;
+            auto it = s_proto_to_race_id.find(packet.ID);
+            if (it != s_proto_to_race_id.end())
+            {
+                raceID = it->second;
+            }
+            else
+            {
+                // Allocate a free race ID (1..99) that is not currently in use.
+                // Must coordinate with g_vehicles to avoid collisions with simulated racers.
+                if (!vlock.owns_lock())
+                    vlock.lock();
+                raceID = allocateRaceIdLocked();
+                if (raceID != -1)
+                {
+                    s_proto_to_race_id.emplace(packet.ID, raceID);
+                    newMappings.emplace_back(packet.ID, raceID);
+                }
+            }
+
+            if (raceID == -1)
+            {
+                static std::atomic<bool> warnedIds{ false };
+                if (!warnedIds.exchange(true))
+                {
+                    LOG_WARN(Telemetry, "[TELEMETRY] No free race IDs available (1..99). Ignoring telemetry.");
+                }
+                continue;
+            }
+
+            PreparedTelemetry rec;
+            rec.packet = &packet;
+            rec.raceID = raceID;
+            prepared.push_back(rec);
         }
     }
 
+    for (const auto& [protoID, raceID] : newMappings)
+    {
+        LOG_INFO(Telemetry, "[TELEMETRY] Prototype #" << protoID << " assigned race vehicle #" << raceID);
+        if (g_ui) {
+            g_ui->NotifyPrototypeConnected(raceID);
+        }
+    }
+
+    if (prepared.empty())
+        return;
+
+    // If origin isn't initialized yet (zone + UTM origin), GPS->UTM conversion can fail.
+    // This would collapse vehicle positions to (0,0) and look like a constant render offset.
+    // One snapshot for the whole batch: the origin used below and the track the
+    // positions are matched against always belong together.
+    const TrackGeometry::SnapshotPtr track = TrackGeometry::Current();
+    {
+        const MapOrigin& origin = track->origin;
+        const int zone = origin.m_origin_zone_int;
+        const bool origin_ok = (zone >= 1 && zone <= 60) &&
+            (std::abs(origin.m_origin_meters_easting) > 1.0) &&
+            (std::abs(origin.m_origin_meters_northing) > 1.0);
+
+        if (!origin_ok)
+        {
+            static std::atomic<bool> warnedOrigin{ false };
+            if (!warnedOrigin.exchange(true))
+            {
+                LOG_WARN(Telemetry, "[TELEMETRY] Ignoring telemetry: map origin not initialized yet (zone/UTM origin invalid).");
+            }
+            return;
+        }
+    }
+
+    // 2) GPS -> UTM -> normalized map coordinates, the whole batch through the
+    // projection fitted around this snapshot's origin.
+    {
+        const size_t n = prepared.size();
+        t_lat.resize(n);
+        t_lon.resize(n);
+        t_easting.resize(n);
+        t_northing.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            t_lat[i] = static_cast<double>(prepared[i].packet->lat) / 1e7;
+            t_lon[i] = static_cast<double>(prepared[i].packet->lon) / 1e7;
+        }
+
+        if (track->projection)
+        {
+            track->projection->ToMetersBatch(t_lat.data(), t_lon.data(), n, t_easting.data(), t_northing.data());
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+                coordinatesToMeters(t_lat[i], t_lon[i], t_easting[i], t_northing[i]);
+        }
+
+        const MapOrigin& origin = track->origin;
+        for (size_t i = 0; i < n; ++i)
+        {
+            PreparedTelemetry& rec = prepared[i];
+            rec.easting = t_easting[i];
+            rec.northing = t_northing[i];
+            rec.nx = (rec.easting - origin.m_origin_meters_easting) / origin.m_map_size;
+            rec.ny = (rec.northing - origin.m_origin_meters_northing) / origin.m_map_size;
+        }
+    }
+
+    // 3) Track-fit validation: a vehicle can legitimately be off the racing line (pits, paddock),
+    // so we only treat telemetry as incompatible if it is FAR from the whole circuit.
+    // If it is near the track (within a large radius), keep the vehicle alive.
+    constexpr double kNearTrackRadiusMeters = 1000.0; // 1km
+    constexpr uint32_t kFarFromTrackGraceMs = 5000; // debounce for wrong-track / wrong-origin
+    const uint32_t now_ms = getMonotonicTimeMs();
+
+    std::vector<int32_t>& farFromTrack = t_far_from_track;
+    farFromTrack.clear();
+    {
+        std::lock_guard<std::mutex> lock(g_track_mismatch_mutex);
+        size_t kept = 0;
+        for (size_t i = 0; i < prepared.size(); ++i)
+        {
+            const PreparedTelemetry& rec = prepared[i];
+            if (!isPositionNearTrack(*track, rec.nx, rec.ny, kNearTrackRadiusMeters))
+            {
+                auto& start_ms = g_track_mismatch_start_ms[rec.raceID];
+                if (start_ms == 0)
+                    start_ms = now_ms;
+                if ((now_ms - start_ms) >= kFarFromTrackGraceMs)
+                {
+                    farFromTrack.push_back(rec.raceID);
+                    g_track_mismatch_start_ms.erase(rec.raceID);
+                }
+                continue;
+            }
+
+            // Back on track => clear mismatch state
+            g_track_mismatch_start_ms.erase(rec.raceID);
+            prepared[kept++] = rec;
+        }
+        prepared.resize(kept);
+    }
+
+    // 4) Snapshot timestamps on the local interpolation clock. Track Server
+    // records arrive already mapped through the shared ServerClock; only the
+    // other sources need the per-vehicle offsets and their lock.
+    {
+        bool needSync = false;
+        for (PreparedTelemetry& rec : prepared)
+        {
+            const int64_t serverUs = stamps ? stamps[rec.packet - packets].serverUs : 0;
+            rec.snapshotTime = static_cast<double>(serverUs) / 1e6;
+            needSync = needSync || serverUs == 0;
+        }
+        if (needSync)
+        {
+            const double localNow = VehicleInterpolator::GetTime();
+            std::lock_guard<std::mutex> lock(g_time_sync_mutex);
+            for (PreparedTelemetry& rec : prepared)
+                if (rec.snapshotTime == 0.0)
+                    rec.snapshotTime = synchronizedSnapshotTimeLocked(rec.raceID, rec.packet->time, localNow);
+        }
+    }
+
+    // 5) Filter (VehicleFilter: gates outlier fixes, fuses speed and G) and
+    // project the filtered position onto the centre line (per-vehicle hint,
+    // see matchTrackProgress).
+    {
+        const MapOrigin& origin = track->origin;
+        std::lock_guard<std::mutex> lock(g_track_match_mutex);
+        for (PreparedTelemetry& rec : prepared)
+        {
+            const TelemetryPacket& packet = *rec.packet;
+            VehicleFilter& filter = g_vehicle_filters[rec.raceID];
+
+            // G fields carry signed hundredths through the unsigned wire type
+            VehicleFilter::Measurement m;
+            m.time = rec.snapshotTime;
+            m.easting = rec.easting;
+            m.northing = rec.northing;
+            m.fixType = packet.fixtype;
+            m.speed = packet.speed / 100.0 / 3.6;
+            m.lateralG = static_cast<int16_t>(packet.gForceX) / 100.0;
+            m.longitudinalG = static_cast<int16_t>(packet.gForceY) / 100.0;
+            if (!filter.Update(m) && m.fixType > 0)
+            {
+                LOG_DEBUG_EVERY_N(Telemetry, 20, "[TELEMETRY] Vehicle #" << rec.raceID << " GNSS fix gated out (NIS "
+                    << std::setprecision(3) << filter.GetStats().lastNis << ", " << filter.GetStats().rejected << " so far)");
+            }
+
+            if (filter.HasHeading())
+            {
+                const VehicleFilter::State s = filter.At(rec.snapshotTime);
+                rec.easting = s.easting;
+                rec.northing = s.northing;
+                rec.nx = (rec.easting - origin.m_origin_meters_easting) / origin.m_map_size;
+                rec.ny = (rec.northing - origin.m_origin_meters_northing) / origin.m_map_size;
+                rec.filtered = true;
+                rec.heading = s.heading;
+                rec.yawRate = s.yawRate;
+                rec.speedKph = s.speed * 3.6;
+            }
+
+            rec.trackProgress = matchTrackProgress(*track, g_track_match[rec.raceID],
+                rec.nx, rec.ny, packet.speed / 100.0, rec.snapshotTime);
+        }
+        for (int32_t raceID : farFromTrack)
+        {
+            g_track_match.erase(raceID);
+            g_vehicle_filters.erase(raceID);
+        }
+    }
+
+    // ? Debug: print packet info to diagnose coordinate issues (every 60th
+    // packet, once per second at ~60Hz). Arduino packs GPS as degrees * 1e7.
+    for (const PreparedTelemetry& rec : prepared)
+    {
+        LOG_DEBUG_EVERY_N(Telemetry, 60, "[TELEMETRY DEBUG] Prototype ID=" << rec.packet->ID << " -> Vehicle #" << rec.raceID
+            << " | GPS: (" << (rec.packet->lat / 1e7) << ", " << (rec.packet->lon / 1e7) << ")"
+            << " | Speed: " << (rec.packet->speed / 100.0) << " km/h");
+    }
+
+    // 6) Update authoritative server-side vehicle state from telemetry — the
+    // whole batch in one critical section.
+    std::vector<VehicleSnapshotUpdate>& snapshots = t_snapshots;
+    std::vector<VehicleStatePacket>& states = t_states;
+    snapshots.clear();
+    states.clear();
+    size_t removedCount = 0;
+    if (stamps)
+        latency.lockRequestUs = TelemetryLatency::nowUs();
+    {
+        std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+        if (stamps)
+            latency.lockedUs = TelemetryLatency::nowUs();
+
+        for (int32_t raceID : farFromTrack)
+        {
+            auto it = g_vehicles.find(raceID);
+            if (it == g_vehicles.end())
+                continue;
+            g_vehicles.erase(it);
+            farFromTrack[removedCount++] = raceID;
+            LOG_INFO(Telemetry, "[TELEMETRY] Vehicle #" << raceID << " removed: far from track (>" << kNearTrackRadiusMeters << "m)");
+        }
+
+        std::lock_guard<std::mutex> rlock(s_send_rate_mutex);
+        for (const PreparedTelemetry& rec : prepared)
+            applyTelemetryLocked(rec, *track, now_ms, snapshots, states);
+    }
+    if (stamps)
+        latency.updatedUs = TelemetryLatency::nowUs();
+
+    // 7) Publish outside g_vehicles_mutex so the render thread is not held up.
+    for (size_t i = 0; i < removedCount; ++i)
+        VehicleInterpolator::Get().RemoveVehicle(farFromTrack[i]);
+    VehicleInterpolator::Get().AddSnapshots(snapshots.data(), snapshots.size());
+
+    if (stamps)
+    {
+        latency.publishedUs = TelemetryLatency::nowUs();
+        for (const PreparedTelemetry& rec : prepared)
+            TelemetryLatency::recordIngest(stamps[rec.packet - packets], latency, rec.raceID, rec.snapshotTime);
+    }
+
     // Network replication is server-authoritative via VehicleStatePacket.
     // Do not broadcast raw telemetry to clients.
+    for (const VehicleStatePacket& state : states)
+        BroadcastVehicleStateToClients(state);
 }
 
 void processIncomingVehicleState(const VehicleStatePacket& packet)
@@ -863,6 +1045,10 @@ void processIncomingVehicleState(const VehicleStatePacket& packet)
         snapshot.heading = vehicle.m_heading;
         snapshot.track_progress = vehicle.m_track_progress;
         VehicleInterpolator::Get().AddSnapshot(packet.vehicle_id, snapshot);
+
+        // Authoritative: records the TimeDiff samples only
+        if (g_race_manager)
+            g_race_manager->OnPositionFix(packet.vehicle_id, vehicle, fixTimeUs(snapshot.timestamp), *TrackGeometry::Current());
     }
     else
     {
@@ -1016,22 +1202,23 @@ static bool convertNormalizedToGPS(
     double& out_latitude,
     double& out_longitude)
 {
-    double meters_easting = g_map_origin.m_origin_meters_easting + 
+    const MapOrigin origin = TrackGeometry::CurrentOrigin();
+    double meters_easting = origin.m_origin_meters_easting + 
                            (normalized_pos.x * MapConstants::MAP_SIZE);
-    double meters_northing = g_map_origin.m_origin_meters_northing + 
+    double meters_northing = origin.m_origin_meters_northing + 
                             (normalized_pos.y * MapConstants::MAP_SIZE);
 
     try {
         using namespace GeographicLib;
         // ? CRITICAL: Use origin's hemisphere, not hardcoded 'true'
-        bool northp = (g_map_origin.m_origin_zone_char >= 'N');
-        UTMUPS::Reverse(g_map_origin.m_origin_zone_int, northp,
+        bool northp = (origin.m_origin_zone_char >= 'N');
+        UTMUPS::Reverse(origin.m_origin_zone_int, northp,
                        meters_easting, meters_northing,
                        out_latitude, out_longitude);
         return true;
     }
     catch (const std::exception& e) {
-        std::cerr << "[GPS] Conversion error: " << e.what() << std::endl;
+        LOG_ERROR(Telemetry, "[GPS] Conversion error: " << e.what());
         return false;
     }
 }
@@ -1093,18 +1280,18 @@ static VehicleStatePacket createVehicleStatePacket(
 // Simulation worker function (runs in separate thread) - ??????????? ????????
 static void simulationThreadWorker(int vehicle_id, std::vector<SplinePoint> smooth_path)
 {
-    std::cout << "[SIM] Vehicle #" << vehicle_id << " started (track points: " << smooth_path.size() << ")" << std::endl;
+    LOG_INFO(Sim, "[SIM] Vehicle #" << vehicle_id << " started (track points: " << smooth_path.size() << ")");
 
     // ? 1. Calculate cumulative distances (once)
     auto [cumulative_distances, total_track_length] = calculateCumulativeDistances(smooth_path);
 
     if (total_track_length < 1e-6f)
     {
-        std::cerr << "[SIM] Error: Track length is zero!" << std::endl;
+        LOG_ERROR(Sim, "[SIM] Error: Track length is zero!");
         return;
     }
 
-    std::cout << "[SIM] Vehicle #" << vehicle_id << " track length: " << total_track_length << " units" << std::endl;
+    LOG_INFO(Sim, "[SIM] Vehicle #" << vehicle_id << " track length: " << total_track_length << " units");
 
     // ? 2. Initialize random number generator
     std::mt19937 gen(vehicle_id * 12345 + static_cast<unsigned>(std::chrono::steady_clock::now().time_since_epoch().count()));
@@ -1120,7 +1307,7 @@ static void simulationThreadWorker(int vehicle_id, std::vector<SplinePoint> smoo
     const float update_interval_ms = SimulationConstants::UPDATE_INTERVAL_MS;
     const float deltaTime = update_interval_ms / 1000.0f;
 
-    std::cout << "[SIM] Vehicle #" << vehicle_id << " initial speed: " << currentSpeedKph << " km/h" << std::endl;
+    LOG_INFO(Sim, "[SIM] Vehicle #" << vehicle_id << " initial speed: " << currentSpeedKph << " km/h");
 
     // ? 4. Main simulation loop
     while (!g_simulation_stop_requested.load(std::memory_order_relaxed))
@@ -1160,59 +1347,78 @@ static void simulationThreadWorker(int vehicle_id, std::vector<SplinePoint> smoo
             track_progress
         );
 
-        // ? Update local authoritative server state exactly, without GPS roundtrip
-        {
-            std::lock_guard<std::mutex> lock(g_vehicles_mutex);
-            auto it = g_vehicles.find(vehicle_id);
+        // ? Hand the state to the ingest thread (it owns g_vehicles and
+        // replicates the packet to clients)
+        TelemetryIngest::pushVehicleState(packet);
 
-            if (it == g_vehicles.end())
-            {
-                Vehicle new_vehicle(vehicle_id, sample.position.x, sample.position.y);
-                new_vehicle.m_prev_x = sample.position.x;
-                new_vehicle.m_prev_y = sample.position.y;
-                new_vehicle.m_heading = packet.heading;
-                new_vehicle.m_speed_kph = currentSpeedKph;
-                new_vehicle.m_track_progress = track_progress;
-                new_vehicle.m_prev_track_progress = track_progress;
-                new_vehicle.m_has_authoritative_state = false;
-                new_vehicle.m_last_update_time = std::chrono::steady_clock::now();
-                new_vehicle.name = "CAR" + std::to_string(vehicle_id);
-                auto [insertedIt, inserted] = g_vehicles.emplace(vehicle_id, std::move(new_vehicle));
-                it = insertedIt;
-            }
-            else
-            {
-                Vehicle& vehicle = it->second;
-                vehicle.m_prev_x = vehicle.m_normalized_x;
-                vehicle.m_prev_y = vehicle.m_normalized_y;
-                vehicle.m_prev_track_progress = vehicle.m_track_progress;
-                vehicle.m_normalized_x = sample.position.x;
-                vehicle.m_normalized_y = sample.position.y;
-                vehicle.m_heading = packet.heading;
-                vehicle.m_speed_kph = currentSpeedKph;
-                vehicle.m_track_progress = track_progress;
-                vehicle.m_has_authoritative_state = false;
-                vehicle.m_last_update_time = std::chrono::steady_clock::now();
-            }
+        // Sleep until next update
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(update_interval_ms)));
+    }
+}
+
+// Locally simulated car: the state is authoritative as-is, without a GPS
+// roundtrip. Applied on the TelemetryIngest thread (simulation threads only
+// produce packets).
+void processLocalVehicleState(const VehicleStatePacket& in)
+{
+    if (in.magic_marker != PacketMagic::VSTA)
+    {
+        return;
+    }
 
-            fillPacketRaceStateFromVehicle(packet, it->second);
+    VehicleStatePacket packet = in;
+    const double snapshotTime = getSynchronizedSnapshotTimeSeconds(packet.vehicle_id, packet.server_time_ms);
+    {
+        std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+        auto it = g_vehicles.find(packet.vehicle_id);
 
-            VehicleSnapshot snapshot;
-            snapshot.timestamp = getSynchronizedSnapshotTimeSeconds(packet.vehicle_id, packet.server_time_ms);
-            snapshot.x = sample.position.x;
-            snapshot.y = sample.position.y;
-            snapshot.speed_kph = currentSpeedKph;
-            snapshot.heading = packet.heading;
-            snapshot.track_progress = track_progress;
-            VehicleInterpolator::Get().AddSnapshot(vehicle_id, snapshot);
+        if (it == g_vehicles.end())
+        {
+            Vehicle new_vehicle(packet.vehicle_id, packet.normalized_x, packet.normalized_y);
+            new_vehicle.m_prev_x = packet.normalized_x;
+            new_vehicle.m_prev_y = packet.normalized_y;
+            new_vehicle.m_heading = packet.heading;
+            new_vehicle.m_speed_kph = packet.speed_kph;
+            new_vehicle.m_track_progress = packet.track_progress;
+            new_vehicle.m_prev_track_progress = packet.track_progress;
+            new_vehicle.m_has_authoritative_state = false;
+            new_vehicle.m_last_update_time = std::chrono::steady_clock::now();
+            new_vehicle.name = "CAR" + std::to_string(packet.vehicle_id);
+            auto [insertedIt, inserted] = g_vehicles.emplace(packet.vehicle_id, std::move(new_vehicle));
+            it = insertedIt;
+        }
+        else
+        {
+            Vehicle& vehicle = it->second;
+            vehicle.m_prev_x = vehicle.m_normalized_x;
+            vehicle.m_prev_y = vehicle.m_normalized_y;
+            vehicle.m_prev_track_progress = vehicle.m_track_progress;
+            vehicle.m_normalized_x = packet.normalized_x;
+            vehicle.m_normalized_y = packet.normalized_y;
+            vehicle.m_heading = packet.heading;
+            vehicle.m_speed_kph = packet.speed_kph;
+            vehicle.m_track_progress = packet.track_progress;
+            vehicle.m_has_authoritative_state = false;
+            vehicle.m_last_update_time = std::chrono::steady_clock::now();
         }
 
-        // ? Broadcast processed packet to clients
-        BroadcastVehicleStateToClients(packet);
+        if (g_race_manager)
+            g_race_manager->OnPositionFix(packet.vehicle_id, it->second, fixTimeUs(snapshotTime), *TrackGeometry::Current());
 
-        // Sleep until next update
-        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(update_interval_ms)));
+        fillPacketRaceStateFromVehicle(packet, it->second);
     }
+
+    VehicleSnapshot snapshot;
+    snapshot.timestamp = snapshotTime;
+    snapshot.x = packet.normalized_x;
+    snapshot.y = packet.normalized_y;
+    snapshot.speed_kph = packet.speed_kph;
+    snapshot.heading = packet.heading;
+    snapshot.track_progress = packet.track_progress;
+    VehicleInterpolator::Get().AddSnapshot(packet.vehicle_id, snapshot);
+
+    // ? Broadcast processed packet to clients
+    BroadcastVehicleStateToClients(packet);
 }
 
 void simulationStopAll()
@@ -1224,12 +1430,12 @@ void simulateVehicleMovement(int vehicle_id, const std::vector<SplinePoint>& smo
 {
     // Guard clauses
     if (smooth_track_points.empty()) {
-        std::cerr << "Error: Empty track points for simulation" << std::endl;
+        LOG_ERROR(Sim, "Error: Empty track points for simulation");
         return;
     }
 
     if (!g_is_map_loaded) {
-        std::cerr << "Error: Map not loaded, cannot simulate vehicle movement" << std::endl;
+        LOG_ERROR(Sim, "Error: Map not loaded, cannot simulate vehicle movement");
         return;
     }
 
@@ -1,14 +1,27 @@
 #pragma once
 
 #include "../network/Server.h"
+#include "TelemetryLatency.h"
 
 // Unified telemetry processing entry points implemented in `SimulationServer.cpp`.
 // (Used by real COM capture, simulation and network.)
 // count_pps=false lets a caller that receives MULTIPLE car records in one
 // network packet (Track Server state frame) count the packet itself instead.
 void processIncomingTelemetry(const TelemetryPacket& packet, bool count_pps = true);
+
+// Same pipeline for several car records at once (Track Server state frame,
+// several RAJA frames from one serial read). Locks are taken once per batch
+// instead of once per car and vehicle updates are applied in a single
+// g_vehicles_mutex critical section. count_pps counts every record as a packet.
+// `stamps` (parallel to `packets`, optional) traces each record's latency.
+void processIncomingTelemetryBatch(const TelemetryPacket* packets, size_t count, bool count_pps = true,
+                                   const TelemetryLatency::Stamps* stamps = nullptr);
 void processIncomingVehicleState(const VehicleStatePacket& packet);
 
+// Locally simulated car state (already normalized, authoritative). Called on
+// the TelemetryIngest thread; simulation threads push via TelemetryIngest.
+void processLocalVehicleState(const VehicleStatePacket& packet);
+
 // Count one received packet in the PPS window (used with count_pps=false).
 void telemetryCountPacket();
 
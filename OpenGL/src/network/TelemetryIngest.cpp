@@ -0,0 +1,352 @@
+#include "TelemetryIngest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MpscQueue.h"
+#include "SimulationServer.h"
+#include "../vehicle/Vehicle.h"
+#include "../racing/RaceManager.h"
+#include "../core/Log.h"
+
+namespace TelemetryIngest {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Queue
+// ---------------------------------------------------------------------------
+struct Record {
+    enum class Kind : uint8_t { Telemetry, VehicleState, ServerTiming, SessionReset };
+
+    Kind kind = Kind::Telemetry;
+    bool count_pps = true;
+    TelemetryPacket telemetry{};
+    TelemetryLatency::Stamps stamps{};
+    VehicleStatePacket state{};
+    ServerTiming timing{};
+};
+
+// ~4 s of a 40-car Track Server stream at 25 Hz, far more than the serial
+// link can deliver between two ingest passes.
+constexpr size_t kQueueCapacity = 4096;
+static_assert(kQueueCapacity != 0 && (kQueueCapacity & (kQueueCapacity - 1)) == 0,
+              "MpscQueue indexes cells with a mask: capacity must be a power of two");
+
+// Records handled per pass before the batches are flushed.
+constexpr size_t kMaxDrainPerPass = 256;
+
+// Upper bound on one processIncomingTelemetryBatch call (one g_vehicles_mutex
+// section) so a backlog is applied in slices, not one long lock.
+constexpr size_t kMaxTelemetryBatch = 64;
+
+// Longest the ingest thread stays parked without a push; only a safety net,
+// producers wake it (see push / park).
+constexpr auto kMaxParkTime = std::chrono::milliseconds(100);
+
+MpscQueue<Record>& queue()
+{
+    static MpscQueue<Record> s_queue(kQueueCapacity);
+    return s_queue;
+}
+
+std::atomic<uint64_t> g_pushed{0};
+
+std::atomic<bool> g_running{false};
+std::atomic<bool> g_stop_requested{false};
+std::thread g_thread;
+std::mutex g_thread_mutex;
+
+// Wakeup for an idle ingest thread. Producers only touch the mutex when the
+// consumer has announced it is parked, so a busy stream stays lock-free.
+std::atomic<bool> g_parked{false};
+std::mutex g_wake_mutex;
+std::condition_variable g_wake;
+
+void wakeConsumer()
+{
+    std::lock_guard<std::mutex> lock(g_wake_mutex);
+    g_wake.notify_one();
+}
+
+bool push(const Record& rec)
+{
+    if (!queue().TryPush(rec))
+        return false;
+    g_pushed.fetch_add(1, std::memory_order_relaxed);
+
+    // Pairs with the fence in park(): either this sees g_parked set, or
+    // park() sees the record and does not wait.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (g_parked.load(std::memory_order_relaxed))
+        wakeConsumer();
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Consumer side (ingest thread only)
+// ---------------------------------------------------------------------------
+std::vector<TelemetryPacket> g_telemetry;
+std::vector<TelemetryLatency::Stamps> g_telemetry_stamps;   // Parallel to g_telemetry
+bool g_telemetry_count_pps = true;
+std::vector<ServerTiming> g_timings;
+std::vector<int32_t> g_timing_race_ids;
+
+void flushTelemetry()
+{
+    if (g_telemetry.empty()) return;
+    processIncomingTelemetryBatch(g_telemetry.data(), g_telemetry.size(), g_telemetry_count_pps,
+                                  g_telemetry_stamps.data());
+    g_telemetry.clear();
+    g_telemetry_stamps.clear();
+}
+
+// Server-computed timings → authoritative vehicle state (the server
+// computes, the client draws). Vehicles are stored under their RACE id
+// (1..99), not the device id — translate via the prototype mapping.
+void flushTimings()
+{
+    if (g_timings.empty()) return;
+
+    g_timing_race_ids.clear();
+    for (const ServerTiming& t : g_timings)
+        g_timing_race_ids.push_back(telemetryGetRaceIdForPrototype(t.id));
+
+    // lap_t is the timer at the server's frame time; what has elapsed since
+    // is added so the display does not inherit the network's jitter.
+    constexpr int64_t kMaxTimerAgeUs = 1'000'000;
+    const int64_t nowUs = TelemetryLatency::nowUs();
+
+    {
+        std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+        for (size_t i = 0; i < g_timings.size(); ++i) {
+            const int32_t race_id = g_timing_race_ids[i];
+            if (race_id == -1) continue;
+            auto it = g_vehicles.find(race_id);
+            if (it == g_vehicles.end()) continue;
+
+            const ServerTiming& t = g_timings[i];
+            Vehicle& v = it->second;
+            v.m_has_authoritative_state = true;
+            v.m_current_lap_number = t.lap;
+            v.m_completed_laps     = t.lap > 0 ? t.lap - 1 : 0;
+            v.m_current_lap_timer  = t.lap_t;
+            if (t.server_us != 0 && t.lap > 0 && !t.finished && t.lap_t > 0.0f)
+                v.m_current_lap_timer += static_cast<float>(
+                    std::clamp<int64_t>(nowUs - t.server_us, 0, kMaxTimerAgeUs) / 1e6);
+            if (t.best > 0.0f) v.m_best_lap_time = t.best;
+            v.m_is_leader = (t.position == 1);
+            v.m_has_started_first_lap = t.lap > 0;
+            v.m_server_position = t.position;
+            v.m_is_finished     = t.finished;
+            // Server-computed completed-lap time → per-lap history, so the
+            // PRO panels (previous lap / lap list) work in networked mode
+            // where the local RaceManager does not detect laps itself.
+            if (t.last_t > 0.0f && t.lap >= 2) {
+                LapData& rec = v.m_laps[t.lap - 1];
+                if (rec.lapTime <= 0.0f) {
+                    rec.lapTime = t.last_t;
+                    rec.positionAtFinish = t.position;
+                }
+            }
+        }
+    }
+    g_timings.clear();
+}
+
+// Records keep their queue order: a batch is flushed before a record of a
+// different kind is applied (timings must see the vehicles their frame created).
+void dispatch(const Record& rec)
+{
+    switch (rec.kind) {
+    case Record::Kind::Telemetry:
+        flushTimings();
+        if (!g_telemetry.empty() && rec.count_pps != g_telemetry_count_pps)
+            flushTelemetry();
+        g_telemetry_count_pps = rec.count_pps;
+        g_telemetry.push_back(rec.telemetry);
+        g_telemetry_stamps.push_back(rec.stamps);
+        if (g_telemetry.size() >= kMaxTelemetryBatch)
+            flushTelemetry();
+        break;
+    case Record::Kind::VehicleState:
+        flushTelemetry();
+        flushTimings();
+        processLocalVehicleState(rec.state);
+        break;
+    case Record::Kind::ServerTiming:
+        flushTelemetry();
+        g_timings.push_back(rec.timing);
+        break;
+    case Record::Kind::SessionReset:
+        flushTelemetry();
+        flushTimings();
+        {
+            std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+            RaceManager::ResetLapHistory();
+        }
+        LOG_INFO(Telemetry, "[INGEST] session reset: lap history cleared");
+        break;
+    }
+}
+
+void reportDrops()
+{
+    static uint64_t s_reported = 0;
+    static auto s_last = std::chrono::steady_clock::now();
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - s_last < std::chrono::seconds(5)) return;
+    s_last = now;
+
+    const uint64_t dropped = queue().Dropped();
+    if (dropped == s_reported) return;
+    LOG_WARN(Telemetry, "[INGEST] queue full: " << (dropped - s_reported)
+              << " records dropped in the last 5 s (high-water "
+              << queue().HighWater() << "/" << queue().Capacity() << ")");
+    s_reported = dropped;
+}
+
+// Ingest thread, queue found empty: sleep until a producer pushes (or stop()).
+// The mutex is held from the re-check to the wait, so a producer that saw
+// g_parked cannot notify in between.
+void park()
+{
+    std::unique_lock<std::mutex> lock(g_wake_mutex);
+    g_parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (queue().Depth() == 0 && !g_stop_requested.load())
+        g_wake.wait_for(lock, kMaxParkTime);
+    g_parked.store(false, std::memory_order_relaxed);
+}
+
+void runLoop()
+{
+    g_telemetry.reserve(kMaxTelemetryBatch);
+    g_telemetry_stamps.reserve(kMaxTelemetryBatch);
+    g_timings.reserve(kMaxDrainPerPass);
+
+    Record rec;
+    while (!g_stop_requested.load()) {
+        size_t drained = 0;
+        while (drained < kMaxDrainPerPass && queue().TryPop(rec)) {
+            dispatch(rec);
+            ++drained;
+        }
+        flushTelemetry();
+        flushTimings();
+        reportDrops();
+
+        if (drained == 0)
+            park();
+    }
+
+    g_running.store(false);
+}
+
+} // namespace
+
+void start()
+{
+    std::lock_guard<std::mutex> lock(g_thread_mutex);
+    if (g_running.load()) return;
+    if (g_thread.joinable()) g_thread.join();
+
+    g_stop_requested.store(false);
+    g_running.store(true);
+    g_thread = std::thread(runLoop);
+    LOG_INFO(Telemetry, "[INGEST] thread started (queue " << kQueueCapacity << " records)");
+}
+
+void stop()
+{
+    std::lock_guard<std::mutex> lock(g_thread_mutex);
+    g_stop_requested.store(true);
+    wakeConsumer();
+    if (g_thread.joinable()) g_thread.join();
+    g_running.store(false);
+}
+
+bool isRunning()
+{
+    return g_running.load();
+}
+
+bool pushTelemetry(const TelemetryPacket& packet, bool count_pps,
+                   const TelemetryLatency::Stamps& stamps)
+{
+    Record rec;
+    rec.kind = Record::Kind::Telemetry;
+    rec.count_pps = count_pps;
+    rec.telemetry = packet;
+    rec.stamps = stamps;
+    if (rec.stamps.receivedUs == 0) {
+        rec.stamps.receivedUs = TelemetryLatency::nowUs();
+        rec.stamps.decodedUs = rec.stamps.receivedUs;
+    }
+    return push(rec);
+}
+
+size_t pushTelemetryBatch(const TelemetryPacket* packets, size_t count, bool count_pps,
+                          const TelemetryLatency::Stamps& stamps)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!pushTelemetry(packets[i], count_pps, stamps)) {
+            // The failed push counted itself; the rest are dropped with it
+            queue().AddDropped(count - i - 1);
+            return i;
+        }
+    }
+    return count;
+}
+
+bool pushVehicleState(const VehicleStatePacket& packet)
+{
+    Record rec;
+    rec.kind = Record::Kind::VehicleState;
+    rec.state = packet;
+    return push(rec);
+}
+
+size_t pushServerTimings(const ServerTiming* timings, size_t count)
+{
+    Record rec;
+    rec.kind = Record::Kind::ServerTiming;
+    for (size_t i = 0; i < count; ++i) {
+        rec.timing = timings[i];
+        if (!push(rec)) {
+            queue().AddDropped(count - i - 1);
+            return i;
+        }
+    }
+    return count;
+}
+
+bool pushSessionReset()
+{
+    Record rec;
+    rec.kind = Record::Kind::SessionReset;
+    return push(rec);
+}
+
+Stats stats()
+{
+    Stats s;
+    s.pushed    = g_pushed.load(std::memory_order_relaxed);
+    s.dropped   = queue().Dropped();
+    s.depth     = queue().Depth();
+    s.highWater = queue().HighWater();
+    s.capacity  = queue().Capacity();
+    return s;
+}
+
+void resetHighWater()
+{
+    queue().ResetHighWater();
+}
+
+} // namespace TelemetryIngest
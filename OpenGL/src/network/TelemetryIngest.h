@@ -0,0 +1,70 @@
+#pragma once
+
+// ============================================================================
+// TelemetryIngest — single owner of telemetry-driven vehicle updates.
+//
+// Every source (serial capture, Track Server WebSocket, simulated cars, test
+// generators) pushes decoded records into one bounded lock-free queue and
+// returns immediately. One ingest thread drains it and is the only telemetry
+// path that writes g_vehicles, so a render frame holding g_vehicles_mutex
+// stalls the ingest thread — never the serial reader draining the UART.
+//
+// Consecutive telemetry records are handed to processIncomingTelemetryBatch
+// together. When the queue is full the record is dropped and counted; the
+// drop count and the high-water mark are shown in the status bar.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Server.h"
+#include "TelemetryLatency.h"
+
+namespace TelemetryIngest {
+
+// Server-computed timings of one car record in a Track Server state frame,
+// applied to the vehicle after the frame's telemetry.
+struct ServerTiming {
+    int32_t id = 0;         // device (prototype) id
+    int     lap = 0;
+    int     position = 0;
+    float   best = 0.0f;
+    float   lap_t = 0.0f;
+    float   last_t = 0.0f;
+    bool    finished = false;
+    int64_t server_us = 0;  // When lap_t was read, local steady us (ServerClock), 0 = unknown
+};
+
+// Spawns the ingest thread (no-op if already running). Records pushed before
+// start() wait in the queue.
+void start();
+void stop();
+bool isRunning();
+
+// Producers — any thread, never block. False / fewer than `count` means the
+// queue was full and the remaining records were dropped (counted).
+// `stamps` feeds TelemetryLatency; unstamped records count as Local, received
+// and decoded at push time. A batch shares one set of stamps.
+bool pushTelemetry(const TelemetryPacket& packet, bool count_pps = true,
+                   const TelemetryLatency::Stamps& stamps = {});
+size_t pushTelemetryBatch(const TelemetryPacket* packets, size_t count, bool count_pps = true,
+                          const TelemetryLatency::Stamps& stamps = {});
+// Locally simulated car state (applied via processLocalVehicleState).
+bool pushVehicleState(const VehicleStatePacket& packet);
+size_t pushServerTimings(const ServerTiming* timings, size_t count);
+// New Track Server race epoch: clears the lap history (RaceManager::
+// ResetLapHistory) in queue order, after every record pushed before it and
+// before any pushed after. False if the queue was full: nothing was reset.
+bool pushSessionReset();
+
+struct Stats {
+    uint64_t pushed = 0;
+    uint64_t dropped = 0;
+    size_t   depth = 0;
+    size_t   highWater = 0;
+    size_t   capacity = 0;
+};
+Stats stats();
+void resetHighWater();
+
+} // namespace TelemetryIngest
@@ -0,0 +1,280 @@
+#include "TelemetryLatency.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+
+#include "../core/Log.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace TelemetryLatency {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Log-linear histogram (HDR-style): values below 32 us get one bucket each,
+// every power of two above is split into 32 equal sub-buckets.
+// ---------------------------------------------------------------------------
+constexpr int kSubBits = 5;
+constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBits;
+constexpr int kMaxExponent = 26;                        // Clamped above 2^27 us (~134 s)
+constexpr size_t kBuckets = kSubBuckets + (kMaxExponent - kSubBits + 1) * kSubBuckets;
+
+int highestBit(uint64_t v)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, v);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+size_t bucketOf(uint64_t v)
+{
+    if (v < kSubBuckets)
+        return static_cast<size_t>(v);
+    const int e = highestBit(v);
+    if (e > kMaxExponent)
+        return kBuckets - 1;
+    const uint64_t mantissa = v >> (e - kSubBits);       // [32, 63]
+    return static_cast<size_t>(kSubBuckets + (e - kSubBits) * kSubBuckets + (mantissa - kSubBuckets));
+}
+
+// Midpoint of a bucket, the value reported for it.
+double bucketValue(size_t index)
+{
+    if (index < kSubBuckets)
+        return static_cast<double>(index);
+    const size_t e = kSubBits + (index - kSubBuckets) / kSubBuckets;
+    const uint64_t mantissa = kSubBuckets + (index - kSubBuckets) % kSubBuckets;
+    const uint64_t width = uint64_t(1) << (e - kSubBits);
+    return static_cast<double>(mantissa * width) + 0.5 * static_cast<double>(width - 1);
+}
+
+struct Histogram {
+    std::atomic<uint32_t> buckets[kBuckets];
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> max{ 0 };
+
+    Histogram()
+    {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    }
+
+    void record(int64_t us)
+    {
+        const uint64_t v = us > 0 ? static_cast<uint64_t>(us) : 0;
+        buckets[bucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(v, std::memory_order_relaxed);
+        uint64_t prev = max.load(std::memory_order_relaxed);
+        while (v > prev && !max.compare_exchange_weak(prev, v, std::memory_order_relaxed)) {}
+    }
+
+    void clear()
+    {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+};
+
+constexpr size_t kSources = static_cast<size_t>(Source::Count);
+constexpr size_t kStages = static_cast<size_t>(Stage::Count);
+
+Histogram g_histograms[kSources][kStages];
+
+Histogram& histogram(Source source, Stage stage)
+{
+    return g_histograms[static_cast<size_t>(source)][static_cast<size_t>(stage)];
+}
+
+// Records to - from, unless either end was not stamped.
+void recordSpan(Source source, Stage stage, int64_t fromUs, int64_t toUs)
+{
+    if (fromUs == 0 || toUs == 0) return;
+    histogram(source, stage).record(toUs - fromUs);
+}
+
+// ---------------------------------------------------------------------------
+// Display stage: one record per vehicle in flight. The ingest thread arms a
+// free slot, the render thread measures and frees it — the `armed` flag hands
+// the plain fields over in both directions.
+// ---------------------------------------------------------------------------
+constexpr int32_t kMaxRaceId = 128;
+
+struct PendingDisplay {
+    std::atomic<bool> armed{ false };
+    Source source = Source::Local;
+    int64_t receivedUs = 0;
+    int64_t publishedUs = 0;
+    double snapshotTime = 0.0;
+};
+
+PendingDisplay g_pending[kMaxRaceId];
+
+} // namespace
+
+const char* sourceName(Source source)
+{
+    switch (source) {
+    case Source::Local:       return "Local";
+    case Source::Serial:      return "Serial";
+    case Source::TrackServer: return "Track Server";
+    default:                  return "?";
+    }
+}
+
+const char* stageName(Stage stage)
+{
+    switch (stage) {
+    case Stage::Decode:   return "Decode";
+    case Stage::Queue:    return "Queue";
+    case Stage::Convert:  return "Convert";
+    case Stage::LockWait: return "LockWait";
+    case Stage::Update:   return "Update";
+    case Stage::Publish:  return "Publish";
+    case Stage::Display:  return "Display";
+    case Stage::Total:    return "Total";
+    default:              return "?";
+    }
+}
+
+int64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void recordIngest(const Stamps& stamps, const BatchTimes& times, int32_t raceID, double snapshotTime)
+{
+    const Source source = stamps.source;
+    recordSpan(source, Stage::Decode, stamps.receivedUs, stamps.decodedUs);
+    recordSpan(source, Stage::Queue, stamps.decodedUs, times.startUs);
+    recordSpan(source, Stage::Convert, times.startUs, times.lockRequestUs);
+    recordSpan(source, Stage::LockWait, times.lockRequestUs, times.lockedUs);
+    recordSpan(source, Stage::Update, times.lockedUs, times.updatedUs);
+    recordSpan(source, Stage::Publish, times.updatedUs, times.publishedUs);
+
+    if (raceID < 0 || raceID >= kMaxRaceId) return;
+    PendingDisplay& slot = g_pending[raceID];
+    if (slot.armed.load(std::memory_order_acquire)) return;
+    slot.source = source;
+    slot.receivedUs = stamps.receivedUs;
+    slot.publishedUs = times.publishedUs;
+    slot.snapshotTime = snapshotTime;
+    slot.armed.store(true, std::memory_order_release);
+}
+
+void onFrameRendered(const RenderedVehicle* vehicles, size_t count)
+{
+    const int64_t now = nowUs();
+    for (size_t i = 0; i < count; ++i) {
+        if (vehicles[i].raceID < 0 || vehicles[i].raceID >= kMaxRaceId) continue;
+        PendingDisplay& slot = g_pending[vehicles[i].raceID];
+        if (!slot.armed.load(std::memory_order_acquire)) continue;
+        if (slot.snapshotTime > vehicles[i].playoutTime) continue;
+        recordSpan(slot.source, Stage::Display, slot.publishedUs, now);
+        recordSpan(slot.source, Stage::Total, slot.receivedUs, now);
+        slot.armed.store(false, std::memory_order_release);
+    }
+}
+
+Summary summary(Source source, Stage stage)
+{
+    const Histogram& h = histogram(source, stage);
+
+    // Copy first so the percentiles come from one consistent set of counts.
+    uint32_t counts[kBuckets];
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        counts[i] = h.buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    Summary s;
+    s.count = total;
+    if (total == 0) return s;
+    s.maxUs = static_cast<double>(h.max.load(std::memory_order_relaxed));
+    const uint64_t recorded = h.count.load(std::memory_order_relaxed);
+    if (recorded != 0)
+        s.meanUs = static_cast<double>(h.sum.load(std::memory_order_relaxed)) / static_cast<double>(recorded);
+
+    auto percentile = [&](double p) {
+        const uint64_t rank = static_cast<uint64_t>(std::ceil(p * static_cast<double>(total)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank && counts[i] != 0)
+                return std::fmin(bucketValue(i), s.maxUs);
+        }
+        return s.maxUs;
+    };
+    s.p50Us = percentile(0.50);
+    s.p95Us = percentile(0.95);
+    s.p99Us = percentile(0.99);
+    return s;
+}
+
+void reset()
+{
+    for (auto& perSource : g_histograms)
+        for (Histogram& h : perSource)
+            h.clear();
+}
+
+std::string saveCsv()
+{
+    std::error_code ec;
+    std::filesystem::create_directories("saves", ec);
+
+    const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm tm_now{};
+#ifdef _WIN32
+    localtime_s(&tm_now, &now);
+#else
+    localtime_r(&now, &tm_now);
+#endif
+
+    char filename[256];
+    std::snprintf(filename, sizeof(filename),
+                  "saves/Latency_%04d-%02d-%02d_%02d-%02d-%02d.csv",
+                  tm_now.tm_year + 1900, tm_now.tm_mon + 1, tm_now.tm_mday,
+                  tm_now.tm_hour, tm_now.tm_min, tm_now.tm_sec);
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        LOG_ERROR(Telemetry, "[LATENCY] Failed to create file: " << filename);
+        return {};
+    }
+
+    file << "source,stage,count,mean_us,p50_us,p95_us,p99_us,max_us\n";
+    char line[192];
+    for (size_t src = 0; src < kSources; ++src) {
+        for (size_t st = 0; st < kStages; ++st) {
+            const Source source = static_cast<Source>(src);
+            const Stage stage = static_cast<Stage>(st);
+            const Summary s = summary(source, stage);
+            if (s.count == 0) continue;
+            std::snprintf(line, sizeof(line), "%s,%s,%llu,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+                          sourceName(source), stageName(stage), (unsigned long long)s.count,
+                          s.meanUs, s.p50Us, s.p95Us, s.p99Us, s.maxUs);
+            file << line;
+        }
+    }
+
+    LOG_INFO(Telemetry, "[LATENCY] Histograms saved to: " << filename);
+    return filename;
+}
+
+} // namespace TelemetryLatency
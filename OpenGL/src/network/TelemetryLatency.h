@@ -0,0 +1,105 @@
+#pragma once
+
+// ============================================================================
+// TelemetryLatency — where a telemetry record spends its time in the client.
+//
+// Every record is stamped when its frame is complete at the source (serial
+// frame read, WebSocket message received) and when it is decoded; the ingest
+// thread adds the batch stages and the render thread the first frame whose
+// interpolation time reaches the record's snapshot. Each stage goes into a
+// lock-free log-linear histogram per source:
+//
+//   Decode    received          -> decoded
+//   Queue     decoded           -> ingest batch started (TelemetryIngest queue)
+//   Convert   batch started     -> g_vehicles_mutex requested (IDs, GPS->map, track match)
+//   LockWait  mutex requested   -> mutex acquired
+//   Update    mutex acquired    -> vehicles updated, mutex released
+//   Publish   mutex released    -> interpolator snapshot added
+//   Display   snapshot added    -> first frame that rendered it (includes
+//                                  the vehicle's adaptive playout delay)
+//   Total     received          -> first frame that rendered it
+//
+// Histograms keep 32 sub-buckets per power of two (<= 3% error) from 1 us to
+// ~2 min; recording is a handful of relaxed atomic increments.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace TelemetryLatency {
+
+enum class Source : uint8_t {
+    Local = 0,      // Simulation / test generators / anything unstamped
+    Serial,         // ESP32 gateway on a COM port
+    TrackServer,    // Track Server WebSocket state frames
+    Count
+};
+
+enum class Stage : uint8_t {
+    Decode = 0,
+    Queue,
+    Convert,
+    LockWait,
+    Update,
+    Publish,
+    Display,
+    Total,
+    Count
+};
+
+const char* sourceName(Source source);
+const char* stageName(Stage stage);
+
+// Microseconds on the steady clock; 0 means "not stamped".
+int64_t nowUs();
+
+// Source-side stamps, carried with a record through TelemetryIngest.
+struct Stamps {
+    Source  source = Source::Local;
+    int64_t receivedUs = 0;
+    int64_t decodedUs = 0;
+    int64_t serverUs = 0;       // Track Server: frame's server time on this clock (ServerClock), 0 = none
+};
+
+// Ingest-side times of one processIncomingTelemetryBatch call.
+struct BatchTimes {
+    int64_t startUs = 0;
+    int64_t lockRequestUs = 0;
+    int64_t lockedUs = 0;
+    int64_t updatedUs = 0;
+    int64_t publishedUs = 0;
+};
+
+// Ingest thread: records the source and batch stages of one record and arms
+// the Display stage for its vehicle (race ID) until a frame reaches
+// `snapshotTime` on the VehicleInterpolator clock. One record per vehicle is
+// in flight; later ones are measured up to Publish only.
+void recordIngest(const Stamps& stamps, const BatchTimes& times, int32_t raceID, double snapshotTime);
+
+// Render thread, once per frame: the interpolator time each vehicle was
+// drawn at (render time - its playout delay).
+struct RenderedVehicle {
+    int32_t raceID;
+    double  playoutTime;
+};
+void onFrameRendered(const RenderedVehicle* vehicles, size_t count);
+
+struct Summary {
+    uint64_t count = 0;
+    double meanUs = 0.0;
+    double p50Us = 0.0;
+    double p95Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+};
+Summary summary(Source source, Stage stage);
+
+void reset();
+
+// Writes every non-empty histogram as CSV rows
+// (source,stage,count,mean_us,p50_us,p95_us,p99_us,max_us) to
+// saves/Latency_<timestamp>.csv. Returns the path, empty on failure.
+std::string saveCsv();
+
+} // namespace TelemetryLatency
@@ -1,27 +1,29 @@
 #include "TrackServerClient.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
 #include <deque>
+#include <fstream>
+#include <memory>
 #include <mutex>
+#include <random>
+#include <string_view>
 #include <thread>
 
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-#include <windows.h>
-#include <winhttp.h>
-#pragma comment(lib, "winhttp.lib")
-
 #include "Server.h"             // TelemetryPacket (rajagp_core alias)
-#include "SimulationServer.h"   // processIncomingTelemetry
+#include "SimulationServer.h"   // telemetryCountPacket
+#include "TelemetryIngest.h"    // car records → ingest thread
+#include "TrackServerJson.h"    // single-pass frame reader
+#include "TrackServerDelta.h"   // binary delta1 state frames
+#include "ServerClock.h"        // server_time_ms -> local steady clock
+#include "WebSocketTransport.h" // WinHTTP / epoll socket
 #include "../vehicle/Vehicle.h" // g_vehicles authoritative timing update
-#include "../input/Input.h"     // g_map_origin (map origin from the track frame)
+#include "../input/Input.h"     // MapOrigin (map origin from the track frame)
+#include "../track/TrackGeometry.h"
+#include "../core/Log.h"
 
 #include <GeographicLib/UTMUPS.hpp>
 
@@ -37,6 +39,7 @@ uint16_t    g_port = 8080;
 std::string g_token;
 std::string g_role;
 std::string g_flag = "none";
+std::string g_record_path;      // Raw frames appended here when set
 
 std::atomic<bool> g_running{false};
 std::atomic<bool> g_stop_requested{false};
@@ -44,9 +47,10 @@ std::atomic<bool> g_connected{false};
 std::atomic<bool> g_failure{false};
 std::thread g_thread;
 
-// WebSocket handle shared with stop() so a blocking receive can be aborted.
-std::mutex g_ws_mutex;
-HINTERNET  g_ws = nullptr;
+// Transport of the current session, shared with stop() (abort a blocking
+// receive) and sendCommand().
+std::mutex          g_ws_mutex;
+WebSocketTransport* g_ws = nullptr;
 
 // Track geometry handoff (socket thread → render thread).
 std::mutex g_track_mutex_local;
@@ -74,6 +78,25 @@ std::string g_race_state;
 uint32_t    g_race_epoch = 0;
 bool        g_have_epoch = false;
 
+// Per-frame scratch, reused across frames (socket thread only).
+TrackServerJson::Frame                     g_frame;
+std::vector<TelemetryPacket>               g_frame_packets;
+std::vector<TelemetryIngest::ServerTiming> g_frame_timings;
+
+// When the message being handled was fully received (TelemetryLatency).
+int64_t g_message_received_us = 0;
+
+// Binary state frames (socket thread only). Asked for in reply to a hello
+// that offers them — unless recording, whose files are JSON lines.
+TrackServerDelta::Decoder g_delta;
+bool g_want_delta = false;
+
+// Clock sync pings (socket thread only), sent between received messages
+// while the server's hello lists the "ping" feature.
+constexpr int64_t kPingIntervalUs = 500'000;
+bool    g_ping_enabled = false;
+int64_t g_last_ping_us = 0;
+
 // ---------------------------------------------------------------------------
 // Link quality from state frames: loss via "seq" gaps, delay via the
 // (arrival - server_time_ms) spread over a ~5 s sliding window.
@@ -123,8 +146,8 @@ void pushAdminResponse(std::string line)
 }
 
 // ---------------------------------------------------------------------------
-// Tiny JSON field readers for the server's fixed, machine-generated frames.
-// Not a general parser — good for flat numeric/string fields we produce.
+// Tiny JSON field reader for the rare admin replies. The hot frames (state,
+// track, hello) go through TrackServerJson instead.
 // ---------------------------------------------------------------------------
 std::string jsonString(const std::string& text, const std::string& key,
                        size_t from = 0)
@@ -138,204 +161,110 @@ std::string jsonString(const std::string& text, const std::string& key,
     return text.substr(start, end - start);
 }
 
-double jsonNumber(const std::string& text, const std::string& key,
-                  size_t from, bool& ok)
-{
-    const std::string pat = "\"" + key + "\":";
-    const auto pos = text.find(pat, from);
-    if (pos == std::string::npos) { ok = false; return 0.0; }
-    ok = true;
-    return std::strtod(text.c_str() + pos + pat.size(), nullptr);
-}
-
-// Parse "key":[[x,y],[x,y],...] into points.
-bool jsonPointArray(const std::string& text, const std::string& key,
-                    std::vector<glm::vec2>& out)
-{
-    const std::string pat = "\"" + key + "\":[";
-    auto pos = text.find(pat);
-    if (pos == std::string::npos) return false;
-    pos += pat.size();
-    while (pos < text.size() && text[pos] != ']') {
-        if (text[pos] == '[') {
-            const char* p = text.c_str() + pos + 1;
-            char* endp = nullptr;
-            const float x = std::strtof(p, &endp);
-            if (endp && *endp == ',') {
-                const float y = std::strtof(endp + 1, nullptr);
-                out.emplace_back(x, y);
-            }
-            const auto close = text.find(']', pos);
-            if (close == std::string::npos) return false;
-            pos = close + 1;
-        } else {
-            ++pos;
-        }
-    }
-    return true;
-}
-
 // ---------------------------------------------------------------------------
 // Frame handlers
 // ---------------------------------------------------------------------------
-void handleState(const std::string& text)
+void handleState(const TrackServerJson::Frame& frame)
 {
     // PPS counts NETWORK PACKETS: one state frame = one packet, no matter how
     // many car records it carries.
     telemetryCountPacket();
 
     // Link quality: sequence gap = loss, server_time_ms spread = delay.
-    {
-        bool ok_seq = false, ok_ms = false;
-        const auto seq = static_cast<uint32_t>(jsonNumber(text, "seq", 0, ok_seq));
-        const auto sms = static_cast<uint32_t>(jsonNumber(text, "server_time_ms", 0, ok_ms));
-        if (ok_seq && ok_ms)
-            recordFrameStat(seq, sms);
+    if (frame.has_seq && frame.has_server_time)
+        recordFrameStat(static_cast<uint32_t>(frame.seq),
+                        static_cast<uint32_t>(frame.server_time_ms));
+
+    // The frame's server time on the local clock: every car in it is
+    // timestamped with that, not with when the network delivered it.
+    int64_t server_us = 0;
+    if (frame.has_server_time) {
+        ServerClock::addArrival(frame.server_time_ms, g_message_received_us);
+        if (ServerClock::toLocalUs(frame.server_time_ms, server_us))
+            server_us = std::min(server_us, g_message_received_us);
     }
 
     {
         std::lock_guard<std::mutex> lock(g_mutex);
-        const std::string f = jsonString(text, "flag");
-        if (!f.empty()) g_flag = f;
-        const std::string rs = jsonString(text, "race");
-        if (!rs.empty()) g_race_state = rs;
+        if (!frame.flag.empty()) g_flag.assign(frame.flag.data(), frame.flag.size());
+        if (!frame.race.empty()) g_race_state.assign(frame.race.data(), frame.race.size());
     }
 
     // New race epoch (admin pressed Start/Reset on the server): wipe local lap
     // history so the session counts from zero — practice data must not leak
-    // into the race results.
-    {
-        bool ok = false;
-        const auto epoch = static_cast<uint32_t>(jsonNumber(text, "epoch", 0, ok));
-        if (ok && (!g_have_epoch || epoch != g_race_epoch)) {
-            const bool is_new_session = g_have_epoch; // first frame just adopts
-            g_race_epoch = epoch;
-            g_have_epoch = true;
-            if (is_new_session) {
-                std::lock_guard<std::mutex> lock(g_vehicles_mutex);
-                for (auto& [id, v] : g_vehicles) {
-                    v.m_laps.clear();
-                    v.laps.clear();
-                    v.m_best_lap_time       = -1.0f;
-                    v.m_completed_laps      = 0;
-                    v.m_current_lap_number  = 1;
-                    v.m_current_lap_timer   = 0.0f;
-                    v.m_has_started_first_lap = false;
-                    v.m_is_leader           = false;
-                    v.m_server_position     = 0;
-                    v.m_is_finished         = false;
-                }
-                std::cout << "[TRACK-CLIENT] race epoch " << epoch
-                          << " — local lap history cleared" << std::endl;
+    // into the race results. The reset is queued like the frames, so the
+    // ingest thread applies it after the old epoch's frames and before this
+    // one's.
+    if (frame.has_epoch) {
+        const auto epoch = static_cast<uint32_t>(frame.epoch);
+        if (!g_have_epoch || epoch != g_race_epoch) {
+            if (g_have_epoch && !TelemetryIngest::pushSessionReset()) {
+                // Queue full: drop the frame, the next one tries again
+                LOG_WARN(Network, "[TRACK-CLIENT] race epoch " << epoch
+                          << ": ingest queue full, reset deferred");
+                return;
             }
+            if (g_have_epoch)
+                LOG_INFO(Network, "[TRACK-CLIENT] race epoch " << epoch
+                          << " — local lap history reset queued");
+            g_race_epoch = epoch;   // The first frame just adopts it
+            g_have_epoch = true;
         }
     }
 
-    const auto cars_pos = text.find("\"cars\":[");
-    if (cars_pos == std::string::npos) return;
+    g_frame_packets.clear();
+    g_frame_timings.clear();
 
-    size_t pos = cars_pos + 8;
-    while (true) {
-        const auto obj_start = text.find('{', pos);
-        if (obj_start == std::string::npos) break;
-        const auto obj_end = text.find('}', obj_start);
-        if (obj_end == std::string::npos) break;
-        const std::string car = text.substr(obj_start, obj_end - obj_start + 1);
-        pos = obj_end + 1;
-
-        bool ok = false;
-        const auto id = static_cast<int32_t>(jsonNumber(car, "id", 0, ok));
-        if (!ok) continue;
+    for (const TrackServerJson::Car& car : frame.cars) {
+        if (!car.has_id) continue;
+        const auto id = static_cast<int32_t>(car.id);
 
         // Raw values → the existing telemetry pipeline (GPS→UTM, vehicle
         // creation/updates, interpolation) — same as local COM reception.
         TelemetryPacket pkt{};
         pkt.MagicMarker  = PACKET_MAGIC_DATA;
         pkt.ID           = id;
-        pkt.lat          = static_cast<int32_t>(jsonNumber(car, "lat", 0, ok));
-        pkt.lon          = static_cast<int32_t>(jsonNumber(car, "lon", 0, ok));
-        pkt.time         = static_cast<uint32_t>(jsonNumber(car, "gps_ms", 0, ok));
-        pkt.speed        = static_cast<uint32_t>(jsonNumber(car, "speed", 0, ok));
-        pkt.acceleration = static_cast<uint32_t>(jsonNumber(car, "accel", 0, ok));
-        pkt.gForceX      = static_cast<uint16_t>(jsonNumber(car, "gfx", 0, ok));
-        pkt.gForceY      = static_cast<uint16_t>(jsonNumber(car, "gfy", 0, ok));
-        pkt.fixtype      = static_cast<int16_t>(jsonNumber(car, "fix", 0, ok));
-        processIncomingTelemetry(pkt, /*count_pps=*/false); // frame counted above
-
-        // Server-computed timings → authoritative vehicle state (the server
-        // computes, the client draws). Vehicles are stored under their RACE id
-        // (1..99), not the device id — translate via the prototype mapping.
-        const auto lap      = static_cast<int>(jsonNumber(car, "lap", 0, ok));
-        const auto position = static_cast<int>(jsonNumber(car, "pos", 0, ok));
-        const float best    = static_cast<float>(jsonNumber(car, "best_lap", 0, ok));
-        const float lap_t   = static_cast<float>(jsonNumber(car, "lap_time", 0, ok));
-        const float last_t  = static_cast<float>(jsonNumber(car, "last_lap", 0, ok));
-        const bool finished = jsonNumber(car, "fin", 0, ok) != 0.0;
-        const int32_t race_id = telemetryGetRaceIdForPrototype(id);
-        if (race_id != -1) {
-            std::lock_guard<std::mutex> lock(g_vehicles_mutex);
-            auto it = g_vehicles.find(race_id);
-            if (it != g_vehicles.end()) {
-                Vehicle& v = it->second;
-                v.m_has_authoritative_state = true;
-                v.m_current_lap_number = lap;
-                v.m_completed_laps     = lap > 0 ? lap - 1 : 0;
-                v.m_current_lap_timer  = lap_t;
-                if (best > 0.0f) v.m_best_lap_time = best;
-                v.m_is_leader = (position == 1);
-                v.m_has_started_first_lap = lap > 0;
-                v.m_server_position = position;
-                v.m_is_finished     = finished;
-                // Server-computed completed-lap time → per-lap history, so the
-                // PRO panels (previous lap / lap list) work in networked mode
-                // where the local RaceManager does not detect laps itself.
-                if (last_t > 0.0f && lap >= 2) {
-                    LapData& rec = v.m_laps[lap - 1];
-                    if (rec.lapTime <= 0.0f) {
-                        rec.lapTime = last_t;
-                        rec.positionAtFinish = position;
-                    }
-                }
-            }
-        }
+        pkt.lat          = static_cast<int32_t>(car.lat);
+        pkt.lon          = static_cast<int32_t>(car.lon);
+        pkt.time         = static_cast<uint32_t>(car.gps_ms);
+        pkt.speed        = static_cast<uint32_t>(car.speed);
+        pkt.acceleration = static_cast<uint32_t>(car.accel);
+        pkt.gForceX      = static_cast<uint16_t>(car.gfx);
+        pkt.gForceY      = static_cast<uint16_t>(car.gfy);
+        pkt.fixtype      = static_cast<int16_t>(car.fix);
+        g_frame_packets.push_back(pkt);
+
+        TelemetryIngest::ServerTiming t;
+        t.id       = id;
+        t.lap      = static_cast<int>(car.lap);
+        t.position = static_cast<int>(car.pos);
+        t.best     = static_cast<float>(car.best_lap);
+        t.lap_t    = static_cast<float>(car.lap_time);
+        t.last_t   = static_cast<float>(car.last_lap);
+        t.finished = car.fin != 0.0;
+        t.server_us = server_us;
+        g_frame_timings.push_back(t);
     }
+
+    if (g_frame_packets.empty()) return;
+
+    // Raw values first (vehicle creation/updates), then the server-computed
+    // timings (the server computes, the client draws) — the ingest thread
+    // applies them in this order, the whole frame as one batch.
+    TelemetryLatency::Stamps stamps;
+    stamps.source = TelemetryLatency::Source::TrackServer;
+    stamps.receivedUs = g_message_received_us;
+    stamps.decodedUs = TelemetryLatency::nowUs();
+    stamps.serverUs = server_us;
+    TelemetryIngest::pushTelemetryBatch(g_frame_packets.data(), g_frame_packets.size(),
+                                        /*count_pps=*/false, stamps); // frame counted above
+    TelemetryIngest::pushServerTimings(g_frame_timings.data(), g_frame_timings.size());
 }
 
-void handleMessage(const std::string& text)
+// Admin replies: rare, so they keep the simple find-based reader.
+void handleAdminMessage(const std::string& text, std::string_view type)
 {
-    const std::string type = jsonString(text, "type");
-    if (type == "state") {
-        handleState(text);
-    } else if (type == "hello") {
-        std::lock_guard<std::mutex> lock(g_mutex);
-        g_role = jsonString(text, "role");
-        g_connected.store(true);
-        std::cout << "[TRACK-CLIENT] connected, role=" << g_role << std::endl;
-    } else if (type == "track") {
-        std::vector<glm::vec2> left, right;
-        if (jsonPointArray(text, "left", left) &&
-            jsonPointArray(text, "right", right) && !left.empty() && !right.empty()) {
-            bool ok = false;
-            PendingOrigin origin;
-            origin.easting  = jsonNumber(text, "origin_easting", 0, ok);
-            origin.valid    = ok;
-            origin.northing = jsonNumber(text, "origin_northing", 0, ok);
-            origin.zone     = static_cast<int>(jsonNumber(text, "origin_zone", 0, ok));
-            origin.map_size = jsonNumber(text, "map_size", 0, ok);
-            const std::string zc = jsonString(text, "origin_zone_char");
-            if (!zc.empty()) origin.zone_char = zc[0];
-
-            std::lock_guard<std::mutex> lock(g_track_mutex_local);
-            g_track_left = std::move(left);
-            g_track_right = std::move(right);
-            g_track_origin = origin;
-            g_track_pending = true;
-            std::cout << "[TRACK-CLIENT] track received: left=" << g_track_left.size()
-                      << " right=" << g_track_right.size()
-                      << " origin_valid=" << origin.valid << std::endl;
-        }
-    }
-    else if (type == "user_created") {
+    if (type == "user_created") {
         pushAdminResponse("User '" + jsonString(text, "name") +
                           "' created. TOKEN: " + jsonString(text, "token") +
                           "  (expires: " + jsonString(text, "expires_at") + ")");
@@ -367,86 +296,137 @@ void handleMessage(const std::string& text)
         std::lock_guard<std::mutex> lock(g_admin_mutex);
         g_users = std::move(users);
     }
+}
+
+void handleMessage(std::string_view text)
+{
+    if (TrackServerDelta::isDeltaFrame(text)) {
+        if (g_delta.Decode(text, g_frame))
+            handleState(g_frame);
+        else
+            LOG_WARN_EVERY_N(Network, 100, "[TRACK-CLIENT] binary state frame dropped ("
+                             << text.size() << " bytes)");
+        return;
+    }
+
+    if (!TrackServerJson::parse(text, g_frame)) {
+        LOG_WARN_EVERY_N(Network, 100, "[TRACK-CLIENT] malformed frame dropped ("
+                         << text.size() << " bytes)");
+        return;
+    }
+
+    const std::string_view type = g_frame.type;
+    if (type == "state") {
+        handleState(g_frame);
+    } else if (type == "hello") {
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            g_role.assign(g_frame.role.data(), g_frame.role.size());
+        }
+        g_connected.store(true);
+        LOG_INFO(Network, "[TRACK-CLIENT] connected, role=" << g_frame.role);
+
+        const bool offered = std::find(g_frame.formats.begin(), g_frame.formats.end(),
+                                       TrackServerDelta::kFormatName) != g_frame.formats.end();
+        g_ping_enabled = std::find(g_frame.features.begin(), g_frame.features.end(),
+                                   "ping") != g_frame.features.end();
+        if (offered && g_want_delta &&
+            sendCommand(R"({"type":"format","format":")" + std::string(TrackServerDelta::kFormatName) + "\"}"))
+            LOG_INFO(Network, "[TRACK-CLIENT] state frames: " << TrackServerDelta::kFormatName);
+    } else if (type == "pong") {
+        if (g_frame.has_t0)
+            ServerClock::addExchange(static_cast<int64_t>(g_frame.t0), g_frame.t1, g_frame.t2,
+                                     g_message_received_us);
+    } else if (type == "track") {
+        if (!g_frame.left.empty() && !g_frame.right.empty()) {
+            PendingOrigin origin;
+            origin.valid    = g_frame.has_origin_easting;
+            origin.easting  = g_frame.origin_easting;
+            origin.northing = g_frame.origin_northing;
+            origin.zone     = static_cast<int>(g_frame.origin_zone);
+            if (g_frame.has_map_size) origin.map_size = g_frame.map_size;
+            if (!g_frame.origin_zone_char.empty()) origin.zone_char = g_frame.origin_zone_char[0];
+
+            std::lock_guard<std::mutex> lock(g_track_mutex_local);
+            g_track_left = std::move(g_frame.left);
+            g_track_right = std::move(g_frame.right);
+            g_track_origin = origin;
+            g_track_pending = true;
+            LOG_INFO(Network, "[TRACK-CLIENT] track received: left=" << g_track_left.size()
+                      << " right=" << g_track_right.size()
+                      << " origin_valid=" << origin.valid);
+        }
+    } else if (!type.empty()) {
+        handleAdminMessage(std::string(text), type);
+    }
     // history frames need no client-side action yet.
 }
 
 // ---------------------------------------------------------------------------
 // Connection loop
 // ---------------------------------------------------------------------------
-std::wstring widen(const std::string& s)
+// Reconnect backoff: doubles from kBackoffBaseMs up to kBackoffMaxMs, with
+// half of each delay random so a paddock of clients does not reconnect in
+// lockstep after a server restart. Reset by a session that got its hello.
+constexpr uint32_t kBackoffBaseMs = 250;
+constexpr uint32_t kBackoffMaxMs = 10000;
+
+uint32_t backoffMs(int failures, std::mt19937& rng)
 {
-    return std::wstring(s.begin(), s.end()); // host/path are ASCII
+    const uint32_t cap = std::min<uint32_t>(kBackoffMaxMs, kBackoffBaseMs << std::min(failures, 6));
+    return cap / 2 + std::uniform_int_distribution<uint32_t>(0, cap / 2)(rng);
 }
 
-// One connect + receive session. Returns when the socket drops or stop is set.
-void runOnce(const std::string& host, uint16_t port, const std::string& token)
+// One connect + receive session. Returns when the socket drops or stop is
+// set; true if the server got as far as its hello.
+bool runOnce(const std::string& host, uint16_t port, const std::string& token,
+             const std::string& record_path)
 {
-    HINTERNET session = WinHttpOpen(L"RAJAGP-Client/1.0",
-                                    WINHTTP_ACCESS_TYPE_NO_PROXY,
-                                    WINHTTP_NO_PROXY_NAME,
-                                    WINHTTP_NO_PROXY_BYPASS, 0);
-    if (!session) { g_failure.store(true); return; }
-
-    HINTERNET connect = WinHttpConnect(session, widen(host).c_str(), port, 0);
-    HINTERNET request = nullptr;
-    HINTERNET ws = nullptr;
-
-    do {
-        if (!connect) break;
-        std::string path = "/";
-        if (!token.empty()) path += "?token=" + token;
-        request = WinHttpOpenRequest(connect, L"GET", widen(path).c_str(),
-                                     nullptr, WINHTTP_NO_REFERER,
-                                     WINHTTP_DEFAULT_ACCEPT_TYPES, 0);
-        if (!request) break;
-
-        if (!WinHttpSetOption(request, WINHTTP_OPTION_UPGRADE_TO_WEB_SOCKET,
-                              nullptr, 0))
-            break;
-        if (!WinHttpSendRequest(request, WINHTTP_NO_ADDITIONAL_HEADERS, 0,
-                                nullptr, 0, 0, 0))
-            break;
-        if (!WinHttpReceiveResponse(request, nullptr))
-            break;
-
-        ws = WinHttpWebSocketCompleteUpgrade(request, 0);
-    } while (false);
-
-    if (request) { WinHttpCloseHandle(request); request = nullptr; }
-
-    if (!ws) {
-        std::cout << "[TRACK-CLIENT] connect failed  host=" << host
-                  << " port=" << port << " err=" << GetLastError() << std::endl;
-        g_failure.store(true);
-        if (connect) WinHttpCloseHandle(connect);
-        WinHttpCloseHandle(session);
-        return;
-    }
-
+    std::unique_ptr<WebSocketTransport> ws = CreateWebSocketTransport();
     {
+        // Published before connecting so stop() can abort a hanging connect.
         std::lock_guard<std::mutex> lock(g_ws_mutex);
-        g_ws = ws;
+        g_ws = ws.get();
     }
-    g_failure.store(false);
 
-    // Receive loop: reassemble fragmented UTF-8 messages.
-    std::string message;
-    std::vector<char> buf(64 * 1024);
-    while (!g_stop_requested.load()) {
-        DWORD read = 0;
-        WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
-        const DWORD rc = WinHttpWebSocketReceive(
-            ws, buf.data(), static_cast<DWORD>(buf.size()), &read, &type);
-        if (rc != NO_ERROR)
-            break;
-        if (type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE)
-            break;
-        message.append(buf.data(), read);
-        if (type == WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE ||
-            type == WINHTTP_WEB_SOCKET_BINARY_MESSAGE_BUFFER_TYPE) {
+    std::string path = "/";
+    if (!token.empty()) path += "?token=" + token;
+    bool had_hello = false;
+    g_delta.Reset();
+    g_want_delta = record_path.empty();
+    g_ping_enabled = false;
+    ServerClock::reset();   // Possibly another server, or a restarted one
+
+    if (!g_stop_requested.load() && ws->Connect(host, port, path)) {
+        g_failure.store(false);
+
+        // Optional capture of the raw frames for TrackServerReplay.
+        std::ofstream recording;
+        if (!record_path.empty()) {
+            recording.open(record_path, std::ios::out | std::ios::app | std::ios::binary);
+            if (!recording.is_open())
+                LOG_WARN(Network, "[TRACK-CLIENT] cannot record to " << record_path);
+        }
+
+        std::string_view message;
+        while (!g_stop_requested.load() &&
+               ws->ReceiveMessage(message) == WebSocketTransport::Receive::Message) {
+            g_message_received_us = TelemetryLatency::nowUs();
             handleMessage(message);
-            message.clear();
+            had_hello = had_hello || g_connected.load();
+            if (g_ping_enabled && g_message_received_us - g_last_ping_us >= kPingIntervalUs) {
+                g_last_ping_us = g_message_received_us;
+                ws->SendText(R"({"type":"ping","t0":)" + std::to_string(TelemetryLatency::nowUs()) + "}");
+            }
+            if (recording.is_open())
+                recording.write(message.data(), static_cast<std::streamsize>(message.size())).put('\n');
         }
+        if (!g_stop_requested.load())
+            LOG_INFO(Network, "[TRACK-CLIENT] disconnected (" << ws->LastError() << ")");
+    } else if (!g_stop_requested.load()) {
+        LOG_WARN(Network, "[TRACK-CLIENT] connect failed  host=" << host
+                  << " port=" << port << " " << ws->LastError());
+        g_failure.store(true);
     }
 
     {
@@ -454,28 +434,30 @@ void runOnce(const std::string& host, uint16_t port, const std::string& token)
         g_ws = nullptr;
     }
     g_connected.store(false);
-    WinHttpWebSocketClose(ws, WINHTTP_WEB_SOCKET_SUCCESS_CLOSE_STATUS, nullptr, 0);
-    WinHttpCloseHandle(ws);
-    WinHttpCloseHandle(connect);
-    WinHttpCloseHandle(session);
-    std::cout << "[TRACK-CLIENT] disconnected" << std::endl;
+    return had_hello;
 }
 
 void runLoop()
 {
+    std::mt19937 rng(std::random_device{}());
+    int failures = 0;
     while (!g_stop_requested.load()) {
-        std::string host, token;
+        std::string host, token, record_path;
         uint16_t port;
         {
             std::lock_guard<std::mutex> lock(g_mutex);
             host = g_host;
             port = g_port;
             token = g_token;
+            record_path = g_record_path;
         }
-        runOnce(host, port, token);
+        failures = runOnce(host, port, token, record_path) ? 0 : failures + 1;
+
         // Reconnect with backoff unless the app is shutting down.
-        for (int i = 0; i < 30 && !g_stop_requested.load(); ++i)
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto resume = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(backoffMs(failures, rng));
+        while (!g_stop_requested.load() && std::chrono::steady_clock::now() < resume)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
     g_running.store(false);
 }
@@ -491,6 +473,12 @@ void setConnectParams(const std::string& host, uint16_t port,
     g_token = token;
 }
 
+void setRecordingPath(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_record_path = path;
+}
+
 void start()
 {
     if (g_running.exchange(true))
@@ -509,8 +497,7 @@ void stop()
         // Abort a blocking receive so the thread can exit promptly.
         std::lock_guard<std::mutex> lock(g_ws_mutex);
         if (g_ws)
-            WinHttpWebSocketClose(g_ws, WINHTTP_WEB_SOCKET_SUCCESS_CLOSE_STATUS,
-                                  nullptr, 0);
+            g_ws->Abort();
     }
     if (g_thread.joinable())
         g_thread.join();
@@ -575,10 +562,7 @@ bool sendCommand(const std::string& json)
     std::lock_guard<std::mutex> lock(g_ws_mutex);
     if (!g_ws)
         return false;
-    const DWORD rc = WinHttpWebSocketSend(
-        g_ws, WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
-        const_cast<char*>(json.data()), static_cast<DWORD>(json.size()));
-    return rc == NO_ERROR;
+    return g_ws->SendText(json);
 }
 
 std::vector<std::string> adminResponses()
@@ -600,7 +584,8 @@ std::vector<UserInfo> userList()
 }
 
 bool consumePendingTrack(std::vector<glm::vec2>& left,
-                         std::vector<glm::vec2>& right)
+                         std::vector<glm::vec2>& right,
+                         MapOrigin& mapOrigin, bool& hasOrigin)
 {
     PendingOrigin origin;
     {
@@ -615,24 +600,26 @@ bool consumePendingTrack(std::vector<glm::vec2>& left,
         g_track_pending = false;
     }
 
-    // Apply the map origin exactly like loadTrk2File() does for a local file —
-    // this is what lets processIncomingTelemetry convert GPS→map coordinates.
+    // The map origin, built exactly like loadTrk2File() does for a local file
+    // — this is what lets processIncomingTelemetry convert GPS→map
+    // coordinates. Published by the caller together with the centre line.
+    hasOrigin = origin.valid;
     if (origin.valid) {
-        g_map_origin.m_origin_meters_easting  = origin.easting;
-        g_map_origin.m_origin_meters_northing = origin.northing;
-        g_map_origin.m_origin_zone_int        = origin.zone;
-        g_map_origin.m_origin_zone_char       = origin.zone_char;
-        g_map_origin.m_map_size               = origin.map_size;
+        mapOrigin = MapOrigin{};
+        mapOrigin.m_origin_meters_easting  = origin.easting;
+        mapOrigin.m_origin_meters_northing = origin.northing;
+        mapOrigin.m_origin_zone_int        = origin.zone;
+        mapOrigin.m_origin_zone_char       = origin.zone_char;
+        mapOrigin.m_map_size               = origin.map_size;
         try {
             const bool northp = origin.zone_char >= 'N';
             GeographicLib::UTMUPS::Reverse(origin.zone, northp,
                 origin.easting, origin.northing,
-                g_map_origin.m_origin_lat_dd, g_map_origin.m_origin_lon_dd);
+                mapOrigin.m_origin_lat_dd, mapOrigin.m_origin_lon_dd);
         } catch (...) {}
-        g_is_map_loaded = true;
-        std::cout << "[TRACK-CLIENT] map origin applied: zone="
+        LOG_INFO(Network, "[TRACK-CLIENT] map origin received: zone="
                   << origin.zone << origin.zone_char
-                  << " E=" << origin.easting << " N=" << origin.northing << std::endl;
+                  << " E=" << origin.easting << " N=" << origin.northing);
     }
     return true;
 }
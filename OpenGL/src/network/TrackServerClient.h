@@ -4,17 +4,19 @@
 // TrackServerClient — connects the RAJAGP app to the RAJAGP Track Server over
 // WebSocket (replaces the removed GameNetworkingSockets client).
 //
-// Implemented on native WinHTTP (no third-party sockets), so it builds on
-// Windows x64 AND ARM64 — the old GNS path was x64-only.
+// The socket is a WebSocketTransport: native WinHTTP on Windows (x64 AND
+// ARM64 — the old GNS path was x64-only), epoll on Linux.
 //
 // What it consumes from the server:
 //   * hello frame  → role (user/admin);
 //   * track frame  → full track geometry, applied on the render thread via
 //                    consumePendingTrack() (GPU upload must not happen here);
 //   * state frames → every car is fed into the existing telemetry pipeline
-//                    (processIncomingTelemetry) + server-computed timings
+//                    (queued to TelemetryIngest) + server-computed timings
 //                    (position/lap/best) are written into g_vehicles as
-//                    authoritative values.
+//                    authoritative values. A server that offers the
+//                    binary delta1 encoding in hello is asked for it
+//                    (TrackServerDelta); decoded frames take the same path.
 //
 // The local serial (COM/SX1280) reception path is untouched — the app can
 // still catch trackers by itself without any server.
@@ -26,14 +28,20 @@
 
 #include <glm/glm.hpp>
 
+class MapOrigin;
+
 namespace TrackServerClient {
 
 // host like "192.168.1.10", port 8080, token may be empty (open server).
 void setConnectParams(const std::string& host, uint16_t port,
                       const std::string& token);
 
-// Spawns the connection thread (no-op if already running). Reconnects with a
-// 3 s backoff until stop() is called.
+// Appends every received frame as one line to `path` from the next session
+// on (empty = off) — the input format of TrackServerReplay.
+void setRecordingPath(const std::string& path);
+
+// Spawns the connection thread (no-op if already running). Reconnects with
+// jittered exponential backoff (0.25 s .. 10 s) until stop() is called.
 void start();
 void stop();
 
@@ -57,15 +65,17 @@ std::string raceState();
 // ---------------------------------------------------------------------------
 // Lost state frames over the last ~5 s, percent (0..100).
 float netLossPercent();
-// Extra network delay above the observed baseline, ms (jitter/queuing; the
-// absolute one-way latency is unknowable without clock sync).
+// Extra network delay above the observed baseline, ms (jitter/queuing). The
+// clock offset and round trip are in ServerClock::estimate().
 int netDelayMs();
 
 // Render-thread handoff of the track geometry received on the socket thread.
-// Returns true once per received track; caller uploads it to the GPU (the map
-// origin from the frame is applied here too).
+// Returns true once per received track; caller uploads it to the GPU and
+// publishes the map origin from the frame with it (`hasOrigin`: the frame
+// carried one).
 bool consumePendingTrack(std::vector<glm::vec2>& left,
-                         std::vector<glm::vec2>& right);
+                         std::vector<glm::vec2>& right,
+                         MapOrigin& origin, bool& hasOrigin);
 
 // ---------------------------------------------------------------------------
 // Admin channel (see server README: flag / visibility / create_user / ...)
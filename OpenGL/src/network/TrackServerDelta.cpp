@@ -0,0 +1,302 @@
+#include "TrackServerDelta.h"
+
+#include <cmath>
+
+namespace TrackServerDelta {
+namespace {
+
+enum Flags : uint8_t {
+    kKeyframe = 1,
+    kFlagText = 2,
+    kRaceText = 4,
+};
+
+enum Field : size_t {
+    kLat, kLon, kGpsMs, kSpeed, kAccel, kGfx, kGfy, kFix,
+    kLap, kPos, kBestLap, kLapTime, kLastLap, kFin,
+};
+static_assert(kFin + 1 == kFieldCount, "field list and kFieldCount disagree");
+
+// Lap times travel as integer milliseconds.
+int64_t toMs(double seconds) { return std::llround(seconds * 1000.0); }
+
+CarValues toValues(const TrackServerJson::Car& car)
+{
+    CarValues v;
+    v.field[kLat]     = std::llround(car.lat);
+    v.field[kLon]     = std::llround(car.lon);
+    v.field[kGpsMs]   = std::llround(car.gps_ms);
+    v.field[kSpeed]   = std::llround(car.speed);
+    v.field[kAccel]   = std::llround(car.accel);
+    v.field[kGfx]     = std::llround(car.gfx);
+    v.field[kGfy]     = std::llround(car.gfy);
+    v.field[kFix]     = std::llround(car.fix);
+    v.field[kLap]     = std::llround(car.lap);
+    v.field[kPos]     = std::llround(car.pos);
+    v.field[kBestLap] = toMs(car.best_lap);
+    v.field[kLapTime] = toMs(car.lap_time);
+    v.field[kLastLap] = toMs(car.last_lap);
+    v.field[kFin]     = car.fin != 0.0 ? 1 : 0;
+    return v;
+}
+
+void toCar(int64_t id, const CarValues& v, TrackServerJson::Car& car)
+{
+    car.has_id   = true;
+    car.id       = static_cast<double>(id);
+    car.lat      = static_cast<double>(v.field[kLat]);
+    car.lon      = static_cast<double>(v.field[kLon]);
+    car.gps_ms   = static_cast<double>(v.field[kGpsMs]);
+    car.speed    = static_cast<double>(v.field[kSpeed]);
+    car.accel    = static_cast<double>(v.field[kAccel]);
+    car.gfx      = static_cast<double>(v.field[kGfx]);
+    car.gfy      = static_cast<double>(v.field[kGfy]);
+    car.fix      = static_cast<double>(v.field[kFix]);
+    car.lap      = static_cast<double>(v.field[kLap]);
+    car.pos      = static_cast<double>(v.field[kPos]);
+    car.best_lap = v.field[kBestLap] / 1000.0;
+    car.lap_time = v.field[kLapTime] / 1000.0;
+    car.last_lap = v.field[kLastLap] / 1000.0;
+    car.fin      = static_cast<double>(v.field[kFin]);
+}
+
+// What a car starts from: the origin for its position, 0 for the rest.
+CarValues baseline(int32_t originLat, int32_t originLon)
+{
+    CarValues v{};
+    v.field[kLat] = originLat;
+    v.field[kLon] = originLon;
+    return v;
+}
+
+void putVarint(std::string& out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out += static_cast<char>(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+void putSigned(std::string& out, int64_t v)
+{
+    putVarint(out, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+}
+
+void putText(std::string& out, const std::string& text)
+{
+    putVarint(out, text.size());
+    out += text;
+}
+
+class Reader
+{
+public:
+    explicit Reader(std::string_view data)
+        : m_p(reinterpret_cast<const uint8_t*>(data.data())), m_end(m_p + data.size()) {}
+
+    bool byte(uint8_t& out)
+    {
+        if (m_p >= m_end) return false;
+        out = *m_p++;
+        return true;
+    }
+
+    bool varint(uint64_t& out)
+    {
+        out = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_p >= m_end) return false;
+            const uint8_t b = *m_p++;
+            out |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool signedVarint(int64_t& out)
+    {
+        uint64_t v;
+        if (!varint(v)) return false;
+        out = static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+        return true;
+    }
+
+    bool text(std::string& out)
+    {
+        uint64_t size;
+        if (!varint(size) || size > static_cast<uint64_t>(m_end - m_p)) return false;
+        out.assign(reinterpret_cast<const char*>(m_p), static_cast<size_t>(size));
+        m_p += size;
+        return true;
+    }
+
+    bool atEnd() const { return m_p == m_end; }
+
+private:
+    const uint8_t* m_p;
+    const uint8_t* m_end;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Encoder
+// ---------------------------------------------------------------------------
+void Encoder::SetOrigin(int32_t lat_e7, int32_t lon_e7)
+{
+    m_originLat = lat_e7;
+    m_originLon = lon_e7;
+    m_started = false; // Next frame is a keyframe against the new origin
+}
+
+void Encoder::Reset()
+{
+    m_cars.clear();
+    m_flag.clear();
+    m_race.clear();
+    m_sinceKeyframe = 0;
+    m_started = false;
+}
+
+void Encoder::Encode(const TrackServerJson::Frame& frame, std::string& out)
+{
+    const bool keyframe = !m_started ||
+        (m_keyframeInterval != 0 && m_sinceKeyframe >= m_keyframeInterval);
+    if (keyframe) {
+        m_cars.clear();
+        m_started = true;
+        m_sinceKeyframe = 0;
+    }
+    ++m_sinceKeyframe;
+
+    const bool flagChanged = keyframe || frame.flag != m_flag;
+    const bool raceChanged = keyframe || frame.race != m_race;
+    if (flagChanged) m_flag.assign(frame.flag);
+    if (raceChanged) m_race.assign(frame.race);
+
+    out.clear();
+    out += static_cast<char>(kMagic);
+    out += static_cast<char>((keyframe ? kKeyframe : 0) |
+                             (flagChanged ? kFlagText : 0) |
+                             (raceChanged ? kRaceText : 0));
+    putVarint(out, static_cast<uint64_t>(std::llround(frame.seq)));
+    putVarint(out, static_cast<uint64_t>(std::llround(frame.server_time_ms)));
+    putVarint(out, static_cast<uint64_t>(std::llround(frame.epoch)));
+    if (keyframe) {
+        putSigned(out, m_originLat);
+        putSigned(out, m_originLon);
+    }
+    if (flagChanged) putText(out, m_flag);
+    if (raceChanged) putText(out, m_race);
+
+    size_t count = 0;
+    for (const TrackServerJson::Car& car : frame.cars)
+        count += car.has_id ? 1 : 0;
+    putVarint(out, count);
+
+    int64_t previousId = 0;
+    for (const TrackServerJson::Car& car : frame.cars) {
+        if (!car.has_id) continue;
+        const int64_t id = std::llround(car.id);
+        const CarValues now = toValues(car);
+        auto it = m_cars.try_emplace(id, baseline(m_originLat, m_originLon)).first;
+        CarValues& old = it->second;
+
+        uint64_t mask = 0;
+        for (size_t f = 0; f < kFieldCount; ++f)
+            if (now.field[f] != old.field[f]) mask |= uint64_t(1) << f;
+
+        putSigned(out, id - previousId);
+        putVarint(out, mask);
+        for (size_t f = 0; f < kFieldCount; ++f)
+            if (mask & (uint64_t(1) << f))
+                putSigned(out, now.field[f] - old.field[f]);
+
+        old = now;
+        previousId = id;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Decoder
+// ---------------------------------------------------------------------------
+void Decoder::Reset()
+{
+    m_cars.clear();
+    m_flag.clear();
+    m_race.clear();
+    m_haveKeyframe = false;
+}
+
+bool Decoder::Decode(std::string_view message, TrackServerJson::Frame& frame)
+{
+    // A frame that fails halfway has already moved some cars, so the table
+    // cannot be trusted until the next keyframe.
+    if (DecodeFrame(message, frame)) return true;
+    m_haveKeyframe = false;
+    return false;
+}
+
+bool Decoder::DecodeFrame(std::string_view message, TrackServerJson::Frame& frame)
+{
+    Reader in(message);
+    uint8_t magic = 0, flags = 0;
+    uint64_t seq, serverTime, epoch, count;
+    if (!in.byte(magic) || magic != kMagic || !in.byte(flags) ||
+        !in.varint(seq) || !in.varint(serverTime) || !in.varint(epoch))
+        return false;
+
+    if (flags & kKeyframe) {
+        int64_t lat, lon;
+        if (!in.signedVarint(lat) || !in.signedVarint(lon)) return false;
+        m_originLat = static_cast<int32_t>(lat);
+        m_originLon = static_cast<int32_t>(lon);
+        m_cars.clear();
+        m_haveKeyframe = true;
+    } else if (!m_haveKeyframe) {
+        return false;
+    }
+    if ((flags & kFlagText) && !in.text(m_flag)) return false;
+    if ((flags & kRaceText) && !in.text(m_race)) return false;
+    if (!in.varint(count) || count > message.size()) return false; // >= 2 bytes per car
+
+    // Field by field, so the Frame's vectors keep their capacity.
+    frame.type = "state";
+    frame.role = {};
+    frame.flag = m_flag;
+    frame.race = m_race;
+    frame.origin_zone_char = {};
+    frame.formats.clear();
+    frame.features.clear();
+    frame.has_t0 = false;
+    frame.left.clear();
+    frame.right.clear();
+    frame.has_origin_easting = frame.has_map_size = false;
+    frame.has_seq = frame.has_server_time = frame.has_epoch = true;
+    frame.seq = static_cast<double>(seq);
+    frame.server_time_ms = static_cast<double>(serverTime);
+    frame.epoch = static_cast<double>(epoch);
+    frame.cars.resize(static_cast<size_t>(count));
+
+    int64_t id = 0;
+    for (TrackServerJson::Car& car : frame.cars) {
+        int64_t idDelta;
+        uint64_t mask;
+        if (!in.signedVarint(idDelta) || !in.varint(mask) || (mask >> kFieldCount) != 0)
+            return false;
+        id += idDelta;
+
+        CarValues& values = m_cars.try_emplace(id, baseline(m_originLat, m_originLon)).first->second;
+        for (size_t f = 0; f < kFieldCount; ++f) {
+            if (!(mask & (uint64_t(1) << f))) continue;
+            int64_t delta;
+            if (!in.signedVarint(delta)) return false;
+            values.field[f] += delta;
+        }
+        toCar(id, values, car);
+    }
+    return in.atEnd();
+}
+
+} // namespace TrackServerDelta
@@ -0,0 +1,98 @@
+#pragma once
+
+// ============================================================================
+// TrackServerDelta — the binary "delta1" encoding of Track Server state
+// frames, negotiated in hello.
+//
+// A JSON state frame repeats every field of every car as text, although from
+// one frame to the next mostly lat/lon, gps_ms and lap_time move. delta1
+// sends a keyframe now and then and otherwise only what changed:
+//
+//   u8     magic (0xD1)
+//   u8     flags: 1 = keyframe, 2 = flag text follows, 4 = race text follows
+//   varint seq, server_time_ms, epoch
+//   [keyframe] svarint origin lat, lon (deg * 1e7)
+//   [flag/race] varint length + bytes
+//   varint car count, then per car:
+//     svarint id - previous id in this frame
+//     varint  mask of the fields that changed (bit i = kFields[i])
+//     svarint new - old, for every field in the mask
+//
+// "old" is that car's value in the previous frame; a keyframe, and a car
+// seen for the first time, start from the origin for lat/lon and 0 for the
+// rest. Positions stay in the server's 1e-7 degree units and lap times are
+// quantized to milliseconds — the precision the JSON carries — so a decoded
+// frame feeds handleState() exactly like the parsed JSON.
+//
+// Encoder and Decoder keep the same per-car table, so both live for exactly
+// one connection; a delta reaching a Decoder that has seen no keyframe is
+// dropped.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "TrackServerJson.h"
+
+namespace TrackServerDelta {
+
+constexpr std::string_view kFormatName = "delta1";
+constexpr uint8_t kMagic = 0xD1;
+constexpr size_t kFieldCount = 14;
+
+// A binary delta1 frame (JSON frames always start with '{').
+inline bool isDeltaFrame(std::string_view message)
+{
+    return !message.empty() && static_cast<uint8_t>(message[0]) == kMagic;
+}
+
+struct CarValues {
+    int64_t field[kFieldCount];
+};
+
+class Encoder
+{
+public:
+    // Reference for keyframe positions (the track origin), deg * 1e7.
+    void SetOrigin(int32_t lat_e7, int32_t lon_e7);
+
+    // A keyframe every `frames` frames (0 = only the first one).
+    void SetKeyframeInterval(uint32_t frames) { m_keyframeInterval = frames; }
+
+    // Encodes a parsed state frame; `out` is overwritten.
+    void Encode(const TrackServerJson::Frame& frame, std::string& out);
+
+    void Reset();
+
+private:
+    std::unordered_map<int64_t, CarValues> m_cars;
+    std::string m_flag, m_race;
+    int32_t  m_originLat = 0, m_originLon = 0;
+    uint32_t m_keyframeInterval = 100;  // 5 s at 20 Hz
+    uint32_t m_sinceKeyframe = 0;
+    bool     m_started = false;
+};
+
+class Decoder
+{
+public:
+    // Fills `frame` as TrackServerJson::parse() would for the same state
+    // frame (type "state"; flag/race point into the Decoder). False if the
+    // frame is malformed or a delta without a keyframe before it.
+    bool Decode(std::string_view message, TrackServerJson::Frame& frame);
+
+    void Reset();
+
+private:
+    bool DecodeFrame(std::string_view message, TrackServerJson::Frame& frame);
+
+    std::unordered_map<int64_t, CarValues> m_cars;
+    std::string m_flag, m_race;
+    int32_t m_originLat = 0, m_originLon = 0;
+    bool    m_haveKeyframe = false;
+};
+
+} // namespace TrackServerDelta
@@ -0,0 +1,268 @@
+#include "TrackServerJson.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace TrackServerJson {
+namespace {
+
+// FNV-1a; `case keyHash("lat"):` is folded at compile time.
+constexpr uint32_t keyHash(std::string_view key)
+{
+    uint32_t h = 2166136261u;
+    for (const char c : key) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr int kMaxDepth = 32;   // Server frames nest 3 deep; stops runaway input
+
+class Parser
+{
+public:
+    explicit Parser(std::string_view text)
+        : m_p(text.data()), m_end(text.data() + text.size()) {}
+
+    bool frame(Frame& out)
+    {
+        const bool ok = object([&](std::string_view key, uint32_t hash) {
+            switch (hash) {
+            case keyHash("type"):             if (key == "type")             return string(out.type); break;
+            case keyHash("role"):             if (key == "role")             return string(out.role); break;
+            case keyHash("formats"):          if (key == "formats")          return strings(out.formats); break;
+            case keyHash("features"):         if (key == "features")         return strings(out.features); break;
+            case keyHash("t0"):               if (key == "t0")               return number(out.t0, &out.has_t0); break;
+            case keyHash("t1"):               if (key == "t1")               return number(out.t1); break;
+            case keyHash("t2"):               if (key == "t2")               return number(out.t2); break;
+            case keyHash("flag"):             if (key == "flag")             return string(out.flag); break;
+            case keyHash("race"):             if (key == "race")             return string(out.race); break;
+            case keyHash("seq"):              if (key == "seq")              return number(out.seq, &out.has_seq); break;
+            case keyHash("server_time_ms"):   if (key == "server_time_ms")   return number(out.server_time_ms, &out.has_server_time); break;
+            case keyHash("epoch"):            if (key == "epoch")            return number(out.epoch, &out.has_epoch); break;
+            case keyHash("cars"):             if (key == "cars")             return cars(out.cars); break;
+            case keyHash("left"):             if (key == "left")             return points(out.left); break;
+            case keyHash("right"):            if (key == "right")            return points(out.right); break;
+            case keyHash("origin_easting"):   if (key == "origin_easting")   return number(out.origin_easting, &out.has_origin_easting); break;
+            case keyHash("origin_northing"):  if (key == "origin_northing")  return number(out.origin_northing); break;
+            case keyHash("origin_zone"):      if (key == "origin_zone")      return number(out.origin_zone); break;
+            case keyHash("origin_zone_char"): if (key == "origin_zone_char") return string(out.origin_zone_char); break;
+            case keyHash("map_size"):         if (key == "map_size")         return number(out.map_size, &out.has_map_size); break;
+            default: break;
+            }
+            return skipValue(1);
+        }, 0);
+        skipWhitespace();
+        return ok && m_p == m_end;
+    }
+
+private:
+    void skipWhitespace()
+    {
+        while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t'))
+            ++m_p;
+    }
+
+    // Skips whitespace, then consumes `c` if it is next.
+    bool accept(char c)
+    {
+        skipWhitespace();
+        if (m_p < m_end && *m_p == c) { ++m_p; return true; }
+        return false;
+    }
+
+    bool next(char c)
+    {
+        skipWhitespace();
+        return m_p < m_end && *m_p == c;
+    }
+
+    // Raw string contents (escapes are skipped over, not decoded — the fields
+    // read here are identifiers and never contain any).
+    bool rawString(std::string_view& out)
+    {
+        if (!accept('"')) return false;
+        const char* start = m_p;
+        for (;;) {
+            const void* hit = std::memchr(m_p, '"', static_cast<size_t>(m_end - m_p));
+            if (!hit) return false;
+            const char* quote = static_cast<const char*>(hit);
+            // Escaped quote if preceded by an odd number of backslashes.
+            size_t slashes = 0;
+            for (const char* b = quote; b > start && b[-1] == '\\'; --b) ++slashes;
+            m_p = quote + 1;
+            if ((slashes & 1) == 0) {
+                out = std::string_view(start, static_cast<size_t>(quote - start));
+                return true;
+            }
+        }
+    }
+
+    bool string(std::string_view& out)
+    {
+        if (!next('"')) return skipValue(1);
+        return rawString(out);
+    }
+
+    bool literal(const char* word, size_t size)
+    {
+        if (static_cast<size_t>(m_end - m_p) < size || std::memcmp(m_p, word, size) != 0)
+            return false;
+        m_p += size;
+        return true;
+    }
+
+    // A number (true/false/null read as 1/0/0, like the server's flags). A
+    // value of another type is skipped and leaves `out` and `has` alone.
+    bool number(double& out, bool* has = nullptr)
+    {
+        skipWhitespace();
+        if (m_p >= m_end) return false;
+        switch (*m_p) {
+        case 't': if (!literal("true", 4))  return false; out = 1.0; break;
+        case 'f': if (!literal("false", 5)) return false; out = 0.0; break;
+        case 'n': if (!literal("null", 4))  return false; out = 0.0; break;
+        case '"': case '{': case '[':
+            return skipValue(1);
+        default: {
+            const auto result = std::from_chars(m_p, m_end, out);
+            if (result.ec != std::errc()) return false;
+            m_p = result.ptr;
+            break;
+        }
+        }
+        if (has) *has = true;
+        return true;
+    }
+
+    // {"key":value,...}; `field(key, hash)` consumes each value.
+    template <typename Field>
+    bool object(Field&& field, int depth)
+    {
+        if (depth > kMaxDepth || !accept('{')) return false;
+        if (accept('}')) return true;
+        do {
+            std::string_view key;
+            if (!rawString(key) || !accept(':')) return false;
+            if (!field(key, keyHash(key))) return false;
+        } while (accept(','));
+        return accept('}');
+    }
+
+    // [value,...]; `element()` consumes each value.
+    template <typename Element>
+    bool array(Element&& element, int depth)
+    {
+        if (depth > kMaxDepth || !accept('[')) return false;
+        if (accept(']')) return true;
+        do {
+            if (!element()) return false;
+        } while (accept(','));
+        return accept(']');
+    }
+
+    bool skipValue(int depth)
+    {
+        skipWhitespace();
+        if (m_p >= m_end) return false;
+        switch (*m_p) {
+        case '{': return object([&](std::string_view, uint32_t) { return skipValue(depth + 1); }, depth);
+        case '[': return array([&] { return skipValue(depth + 1); }, depth);
+        case '"': { std::string_view ignored; return rawString(ignored); }
+        default:  { double ignored; return number(ignored); }
+        }
+    }
+
+    bool car(Car& out)
+    {
+        return object([&](std::string_view key, uint32_t hash) {
+            switch (hash) {
+            case keyHash("id"):       if (key == "id")       return number(out.id, &out.has_id); break;
+            case keyHash("lat"):      if (key == "lat")      return number(out.lat); break;
+            case keyHash("lon"):      if (key == "lon")      return number(out.lon); break;
+            case keyHash("gps_ms"):   if (key == "gps_ms")   return number(out.gps_ms); break;
+            case keyHash("speed"):    if (key == "speed")    return number(out.speed); break;
+            case keyHash("accel"):    if (key == "accel")    return number(out.accel); break;
+            case keyHash("gfx"):      if (key == "gfx")      return number(out.gfx); break;
+            case keyHash("gfy"):      if (key == "gfy")      return number(out.gfy); break;
+            case keyHash("fix"):      if (key == "fix")      return number(out.fix); break;
+            case keyHash("lap"):      if (key == "lap")      return number(out.lap); break;
+            case keyHash("pos"):      if (key == "pos")      return number(out.pos); break;
+            case keyHash("best_lap"): if (key == "best_lap") return number(out.best_lap); break;
+            case keyHash("lap_time"): if (key == "lap_time") return number(out.lap_time); break;
+            case keyHash("last_lap"): if (key == "last_lap") return number(out.last_lap); break;
+            case keyHash("fin"):      if (key == "fin")      return number(out.fin); break;
+            default: break;
+            }
+            return skipValue(3);
+        }, 2);
+    }
+
+    bool cars(std::vector<Car>& out)
+    {
+        if (!next('[')) return skipValue(1);
+        return array([&] {
+            if (!next('{')) return skipValue(2);
+            out.emplace_back();
+            return car(out.back());
+        }, 1);
+    }
+
+    // ["a","b",...]; non-string elements are skipped.
+    bool strings(std::vector<std::string_view>& out)
+    {
+        if (!next('[')) return skipValue(1);
+        return array([&] {
+            if (!next('"')) return skipValue(2);
+            out.emplace_back();
+            return rawString(out.back());
+        }, 1);
+    }
+
+    // [[x,y],...]; extra elements of a point are ignored.
+    bool points(std::vector<glm::vec2>& out)
+    {
+        if (!next('[')) return skipValue(1);
+        return array([&] {
+            if (!next('[')) return skipValue(2);
+            double xy[2] = { 0.0, 0.0 };
+            size_t n = 0;
+            const bool ok = array([&] {
+                return n < 2 ? number(xy[n++]) : skipValue(3);
+            }, 2);
+            if (ok && n == 2)
+                out.emplace_back(static_cast<float>(xy[0]), static_cast<float>(xy[1]));
+            return ok;
+        }, 1);
+    }
+
+    const char* m_p;
+    const char* m_end;
+};
+
+} // namespace
+
+bool parse(std::string_view text, Frame& frame)
+{
+    frame.type = {};
+    frame.role = {};
+    frame.flag = {};
+    frame.race = {};
+    frame.origin_zone_char = {};
+    frame.has_seq = frame.has_server_time = frame.has_epoch = false;
+    frame.has_t0 = false;
+    frame.t0 = frame.t1 = frame.t2 = 0.0;
+    frame.has_origin_easting = frame.has_map_size = false;
+    frame.seq = frame.server_time_ms = frame.epoch = 0.0;
+    frame.origin_easting = frame.origin_northing = frame.origin_zone = frame.map_size = 0.0;
+    frame.formats.clear();
+    frame.features.clear();
+    frame.cars.clear();
+    frame.left.clear();
+    frame.right.clear();
+
+    return Parser(text).frame(frame);
+}
+
+} // namespace TrackServerJson
@@ -0,0 +1,67 @@
+#pragma once
+
+// ============================================================================
+// TrackServerJson — single-pass reader for the Track Server's JSON frames.
+//
+// Walks a frame once, left to right: keys are matched by a hash computed at
+// compile time (then confirmed), numbers go through std::from_chars, strings
+// come back as views into the frame. Only keys at their own level count —
+// a "lap" inside some nested object can never land in a car's lap field.
+//
+// Covers the hot frames: state (20 Hz, one record per car), track (the
+// left/right border arrays), hello and pong. Anything else (admin replies)
+// is left to the caller; `type` is still filled in for dispatch.
+//
+// The Frame is meant to be reused: its vectors keep their capacity, so once
+// warmed up a state frame is parsed without touching the heap.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace TrackServerJson {
+
+// One object of a state frame's "cars" array. Values stay doubles and are
+// narrowed by the caller, exactly as the server sent them.
+struct Car {
+    bool   has_id = false;
+    double id = 0.0;
+    double lat = 0.0, lon = 0.0, gps_ms = 0.0;
+    double speed = 0.0, accel = 0.0, gfx = 0.0, gfy = 0.0, fix = 0.0;
+    double lap = 0.0, pos = 0.0;
+    double best_lap = 0.0, lap_time = 0.0, last_lap = 0.0, fin = 0.0;
+};
+
+struct Frame {
+    // Views into the parsed text — valid only while it is.
+    std::string_view type;
+    std::string_view role;              // hello
+    std::vector<std::string_view> formats; // hello: state encodings offered
+    std::vector<std::string_view> features; // hello: e.g. "ping"
+    std::string_view flag, race;        // state
+    std::string_view origin_zone_char;  // track
+
+    // state
+    bool   has_seq = false, has_server_time = false, has_epoch = false;
+    double seq = 0.0, server_time_ms = 0.0, epoch = 0.0;
+    std::vector<Car> cars;
+
+    // pong: t0 echoed from the ping, t1/t2 server receive/send time (ms)
+    bool   has_t0 = false;
+    double t0 = 0.0, t1 = 0.0, t2 = 0.0;
+
+    // track
+    bool   has_origin_easting = false, has_map_size = false;
+    double origin_easting = 0.0, origin_northing = 0.0, origin_zone = 0.0, map_size = 0.0;
+    std::vector<glm::vec2> left, right;
+};
+
+// Fills `frame` (cleared first). False if the text is not a well-formed JSON
+// object — the frame is then incomplete and should be dropped.
+bool parse(std::string_view text, Frame& frame);
+
+} // namespace TrackServerJson
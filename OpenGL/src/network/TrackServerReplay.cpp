@@ -0,0 +1,645 @@
+#include "TrackServerReplay.h"
+#include "TrackServerClient.h"
+#include "TrackServerJson.h"
+#include "TrackServerDelta.h"
+#include "WebSocketProtocol.h"
+#include "../core/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <GeographicLib/UTMUPS.hpp>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+using socket_t = SOCKET;
+constexpr socket_t kInvalidSocket = INVALID_SOCKET;
+constexpr int kSendFlags = 0;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using socket_t = int;
+constexpr socket_t kInvalidSocket = -1;
+constexpr int kSendFlags = MSG_NOSIGNAL;    // A vanished client is an error, not SIGPIPE
+#endif
+
+namespace TrackServerReplay {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void closeSocket(socket_t s)
+{
+#if defined(_WIN32)
+    closesocket(s);
+#else
+    ::close(s);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Traffic
+// ---------------------------------------------------------------------------
+
+// One car object of a recorded state frame, split around its id so clones
+// can be written under another one: prefix + id + suffix.
+struct CarText {
+    std::string prefix;
+    int64_t     id = 0;
+    std::string suffix;
+};
+
+struct StateText {
+    double epoch = 0.0;
+    std::string flag = "green", race = "running";
+    std::vector<CarText> cars;
+};
+
+struct Traffic {
+    std::string hello;
+    std::string track;
+    std::vector<StateText> states;      // Looped
+    int cars = 0;                       // Per state frame after cloning
+    int cloneStride = 1000;             // Clone k of a car gets id + k * stride
+    int32_t originLat = 0, originLon = 0; // delta1 position reference, deg * 1e7
+};
+
+constexpr const char* kDefaultHello = R"({"type":"hello","role":"viewer"})";
+
+// Offers delta1 state frames and clock-sync pings, like a server that
+// speaks them would.
+void offerFormats(std::string& hello)
+{
+    const size_t end = hello.rfind('}');
+    if (end == std::string::npos || hello.find("\"formats\"") != std::string::npos) return;
+    hello.insert(end, R"(,"formats":["json",")" + std::string(TrackServerDelta::kFormatName) +
+                      R"("],"features":["ping"])");
+}
+
+// Top-level objects of the array that starts at `pos` ('['), as views.
+std::vector<std::string_view> arrayObjects(std::string_view text, size_t pos)
+{
+    std::vector<std::string_view> out;
+    int depth = 0;
+    bool inString = false;
+    size_t start = 0;
+    for (size_t i = pos + 1; i < text.size(); ++i) {
+        const char c = text[i];
+        if (inString) {
+            if (c == '\\') ++i;
+            else if (c == '"') inString = false;
+            continue;
+        }
+        if (c == '"') inString = true;
+        else if (c == '{' || c == '[') { if (depth++ == 0) start = i; }
+        else if (c == '}' || c == ']') {
+            if (depth == 0) break;      // End of the array itself
+            if (--depth == 0) out.push_back(text.substr(start, i - start + 1));
+        }
+    }
+    return out;
+}
+
+bool splitCar(std::string_view obj, CarText& out)
+{
+    const size_t key = obj.find("\"id\":");
+    if (key == std::string_view::npos) return false;
+    size_t begin = key + 5;
+    while (begin < obj.size() && obj[begin] == ' ') ++begin;
+    size_t end = begin;
+    while (end < obj.size() && std::strchr("-+0123456789.eE", obj[end])) ++end;
+    if (end == begin) return false;
+    out.prefix.assign(obj.data(), begin);
+    out.id = static_cast<int64_t>(std::strtod(std::string(obj.substr(begin, end - begin)).c_str(), nullptr));
+    out.suffix.assign(obj.data() + end, obj.size() - end);
+    return true;
+}
+
+bool loadRecording(const std::string& path, Traffic& traffic)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        LOG_ERROR(Network, "[REPLAY] cannot open recording " << path);
+        return false;
+    }
+
+    TrackServerJson::Frame frame;
+    std::string line;
+    size_t maxCars = 0;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || !TrackServerJson::parse(line, frame)) continue;
+
+        if (frame.type == "hello") {
+            if (traffic.hello.empty()) traffic.hello = line;
+        } else if (frame.type == "track") {
+            traffic.track = line;
+            if (frame.has_origin_easting) {
+                double lat = 0.0, lon = 0.0;
+                GeographicLib::UTMUPS::Reverse(static_cast<int>(frame.origin_zone),
+                    frame.origin_zone_char.empty() || frame.origin_zone_char[0] >= 'N',
+                    frame.origin_easting, frame.origin_northing, lat, lon);
+                traffic.originLat = static_cast<int32_t>(std::llround(lat * 1e7));
+                traffic.originLon = static_cast<int32_t>(std::llround(lon * 1e7));
+            }
+        } else if (frame.type == "state") {
+            const size_t arr = line.find("\"cars\":[");
+            if (arr == std::string::npos) continue;
+            StateText state;
+            state.epoch = frame.epoch;
+            if (!frame.flag.empty()) state.flag.assign(frame.flag);
+            if (!frame.race.empty()) state.race.assign(frame.race);
+            for (std::string_view obj : arrayObjects(line, arr + 7)) {
+                CarText car;
+                if (splitCar(obj, car)) state.cars.push_back(std::move(car));
+            }
+            maxCars = std::max(maxCars, state.cars.size());
+            traffic.states.push_back(std::move(state));
+        }
+    }
+
+    if (traffic.states.empty()) {
+        LOG_ERROR(Network, "[REPLAY] no state frames in " << path);
+        return false;
+    }
+    if (traffic.hello.empty())
+        traffic.hello = kDefaultHello;
+    offerFormats(traffic.hello);
+    if (traffic.cars <= 0)
+        traffic.cars = static_cast<int>(maxCars);
+    LOG_INFO(Network, "[REPLAY] loaded " << traffic.states.size() << " state frames ("
+             << maxCars << " cars) from " << path);
+    return true;
+}
+
+// Built-in circuit: a 150 m circle (borders at 140/160 m) centred on Riga.
+constexpr double kCentreLat = 56.9496;
+constexpr double kCentreLon = 24.1052;
+constexpr double kRadiusM = 150.0;
+constexpr double kMapSize = 500.0;
+constexpr double kMetresPerDegLat = 111320.0;
+constexpr double kLapSeconds = 30.0;
+constexpr double kPi = 3.14159265358979323846;
+
+char latitudeBand(double lat)
+{
+    static const char kBands[] = "CDEFGHJKLMNPQRSTUVWXX";
+    const int band = static_cast<int>(std::floor((lat + 80.0) / 8.0));
+    return kBands[std::clamp(band, 0, 20)];
+}
+
+void circlePoint(double radiusM, double angle, double& lat, double& lon)
+{
+    lat = kCentreLat + radiusM * std::sin(angle) / kMetresPerDegLat;
+    lon = kCentreLon + radiusM * std::cos(angle) /
+          (kMetresPerDegLat * std::cos(kCentreLat * kPi / 180.0));
+}
+
+void buildCircuit(Traffic& traffic)
+{
+    using GeographicLib::UTMUPS;
+    int zone = 0;
+    bool northp = true;
+    double originE = 0.0, originN = 0.0;
+    UTMUPS::Forward(kCentreLat, kCentreLon, zone, northp, originE, originN);
+
+    std::ostringstream track;
+    track.precision(6);
+    track << std::fixed << R"({"type":"track")";
+    for (const double radius : { 140.0, 160.0 }) {
+        track << (radius < kRadiusM ? R"(,"left":[)" : R"(,"right":[)");
+        constexpr int kPoints = 128;
+        for (int i = 0; i <= kPoints; ++i) {
+            double lat, lon, e, n;
+            int z;
+            bool np;
+            circlePoint(radius, 2.0 * kPi * (i % kPoints) / kPoints, lat, lon);
+            UTMUPS::Forward(lat, lon, z, np, e, n, zone);
+            track << (i ? "," : "") << '[' << (e - originE) / kMapSize
+                  << ',' << (n - originN) / kMapSize << ']';
+        }
+        track << ']';
+    }
+    track.precision(3);
+    track << R"(,"origin_easting":)" << originE << R"(,"origin_northing":)" << originN
+          << R"(,"origin_zone":)" << zone << R"(,"origin_zone_char":")" << latitudeBand(kCentreLat)
+          << R"(","map_size":)" << kMapSize << '}';
+
+    traffic.hello = kDefaultHello;
+    offerFormats(traffic.hello);
+    traffic.track = track.str();
+    traffic.originLat = static_cast<int32_t>(std::llround(kCentreLat * 1e7));
+    traffic.originLon = static_cast<int32_t>(std::llround(kCentreLon * 1e7));
+    if (traffic.cars <= 0) traffic.cars = 20;
+}
+
+// One state frame of the built-in circuit at `t` seconds.
+void appendCircuitCars(std::string& out, int cars, double t)
+{
+    char buf[320];
+    for (int i = 0; i < cars; ++i) {
+        const double laps = t / kLapSeconds + static_cast<double>(i) / cars;
+        const double angle = 2.0 * kPi * (laps - std::floor(laps));
+        double lat, lon;
+        circlePoint(kRadiusM, angle, lat, lon);
+        const double speedKph = 2.0 * kPi * kRadiusM / kLapSeconds * 3.6;
+        const int n = std::snprintf(buf, sizeof(buf),
+            R"(%s{"id":%d,"lat":%lld,"lon":%lld,"gps_ms":%lld,"speed":%d,"accel":0,"gfx":0,"gfy":0,"fix":3,)"
+            R"("lap":%d,"pos":%d,"best_lap":%.3f,"lap_time":%.3f,"last_lap":%.3f,"fin":0})",
+            i ? "," : "", i + 1,
+            static_cast<long long>(std::llround(lat * 1e7)), static_cast<long long>(std::llround(lon * 1e7)),
+            static_cast<long long>(t * 1000.0), static_cast<int>(speedKph * 100.0),
+            static_cast<int>(laps) + 1, i + 1, kLapSeconds, (laps - std::floor(laps)) * kLapSeconds,
+            laps >= 1.0 ? kLapSeconds : 0.0);
+        if (n > 0) out.append(buf, std::min<size_t>(static_cast<size_t>(n), sizeof(buf) - 1));
+    }
+}
+
+void buildState(const Traffic& traffic, uint64_t tick, double t, std::string& out)
+{
+    const StateText* recorded = traffic.states.empty()
+        ? nullptr : &traffic.states[tick % traffic.states.size()];
+
+    char head[192];
+    std::snprintf(head, sizeof(head),
+        R"({"type":"state","seq":%llu,"server_time_ms":%lld,"epoch":%.0f,"flag":"%s","race":"%s","cars":[)",
+        static_cast<unsigned long long>(tick), static_cast<long long>(t * 1000.0),
+        recorded ? recorded->epoch : 1.0,
+        recorded ? recorded->flag.c_str() : "green",
+        recorded ? recorded->race.c_str() : "running");
+    out.assign(head);
+
+    if (!recorded) {
+        appendCircuitCars(out, traffic.cars, t);
+    } else if (!recorded->cars.empty()) {
+        const int source = static_cast<int>(recorded->cars.size());
+        for (int i = 0; i < traffic.cars; ++i) {
+            const CarText& car = recorded->cars[i % source];
+            if (i) out += ',';
+            out += car.prefix;
+            out += std::to_string(car.id + static_cast<int64_t>(traffic.cloneStride) * (i / source));
+            out += car.suffix;
+        }
+    }
+    out += "]}";
+}
+
+// ---------------------------------------------------------------------------
+// Server
+// ---------------------------------------------------------------------------
+
+struct Counters {
+    std::atomic<uint32_t> clients{ 0 };
+    std::atomic<uint64_t> frames{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<uint64_t> late{ 0 };
+    std::atomic<int64_t>  maxLagUs{ 0 };
+};
+
+Options g_options;
+Traffic g_traffic;
+Counters g_counters;
+socket_t g_listen = kInvalidSocket;
+std::atomic<bool> g_running{ false };
+std::atomic<bool> g_stop{ false };
+std::thread g_accept_thread;
+std::mutex g_clients_mutex;
+std::vector<std::thread> g_client_threads;
+Clock::time_point g_clock_zero;     // The replay's server_time_ms counts from here
+
+double serverMs()
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - g_clock_zero).count();
+}
+
+bool sendAll(socket_t s, const char* data, size_t size)
+{
+    while (size > 0) {
+        const int sent = ::send(s, data, static_cast<int>(std::min<size_t>(size, 1 << 30)), kSendFlags);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool sendFrame(socket_t s, std::string_view text, std::string& scratch,
+               uint8_t opcode = WebSocketProtocol::kText)
+{
+    uint8_t header[WebSocketProtocol::kMaxHeaderSize];
+    const size_t headerSize = WebSocketProtocol::writeFrameHeader(header, opcode, text.size());
+    scratch.assign(reinterpret_cast<const char*>(header), headerSize);
+    scratch.append(text.data(), text.size());
+    if (!sendAll(s, scratch.data(), scratch.size())) return false;
+    g_counters.frames.fetch_add(1, std::memory_order_relaxed);
+    g_counters.bytes.fetch_add(scratch.size(), std::memory_order_relaxed);
+    return true;
+}
+
+bool handshake(socket_t s)
+{
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        if (request.size() > 16 * 1024) return false;
+        const int got = ::recv(s, buf, sizeof(buf), 0);
+        if (got <= 0) return false;
+        request.append(buf, static_cast<size_t>(got));
+    }
+    const std::string_view key = WebSocketProtocol::headerValue(request, "Sec-WebSocket-Key");
+    if (key.empty()) return false;
+    const std::string response =
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: " + WebSocketProtocol::acceptKey(key) + "\r\n\r\n";
+    return sendAll(s, response.data(), response.size());
+}
+
+// Drains what the client sent, without blocking: answers pings and notes a
+// {"type":"format","format":"delta1"}. False once it closed.
+bool readClient(socket_t s, std::string& inbox, bool& wantDelta)
+{
+    std::string scratch;
+    TrackServerJson::Frame ping;
+    for (;;) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(s, &readable);
+        timeval zero{ 0, 0 };
+        if (::select(static_cast<int>(s) + 1, &readable, nullptr, nullptr, &zero) <= 0)
+            return true;
+        char buf[4096];
+        const int got = ::recv(s, buf, sizeof(buf), 0);
+        if (got <= 0) return false;
+        inbox.append(buf, static_cast<size_t>(got));
+        const double receivedMs = serverMs();
+
+        WebSocketProtocol::FrameHeader header;
+        while (WebSocketProtocol::parseFrameHeader(reinterpret_cast<const uint8_t*>(inbox.data()), inbox.size(), header) &&
+               inbox.size() - header.headerSize >= header.payloadSize) {
+            char* payload = &inbox[header.headerSize];
+            const size_t size = static_cast<size_t>(header.payloadSize);
+            if (header.masked)
+                WebSocketProtocol::applyMask(reinterpret_cast<uint8_t*>(payload), size, header.mask);
+            if (header.opcode == WebSocketProtocol::kClose) return false;
+            const std::string_view text(payload, size);
+            if (header.opcode == WebSocketProtocol::kText && text.find(R"("type":"format")") != std::string_view::npos)
+                wantDelta = text.find(TrackServerDelta::kFormatName) != std::string_view::npos;
+            if (header.opcode == WebSocketProtocol::kText && text.find(R"("type":"ping")") != std::string_view::npos &&
+                TrackServerJson::parse(text, ping) && ping.has_t0) {
+                char reply[128];
+                std::snprintf(reply, sizeof(reply), R"({"type":"pong","t0":%.0f,"t1":%.3f,"t2":%.3f})",
+                              ping.t0, receivedMs, serverMs());
+                if (!sendFrame(s, reply, scratch)) return false;
+            }
+            inbox.erase(0, header.headerSize + size);
+        }
+    }
+}
+
+void serveClient(socket_t s)
+{
+    g_counters.clients.fetch_add(1);
+    std::string scratch, state, inbox, encoded;
+    bool wantDelta = false;
+    TrackServerDelta::Encoder encoder;
+    TrackServerJson::Frame frame;
+    encoder.SetOrigin(g_traffic.originLat, g_traffic.originLon);
+    bool ok = handshake(s) &&
+              sendFrame(s, g_traffic.hello, scratch) &&
+              (g_traffic.track.empty() || sendFrame(s, g_traffic.track, scratch));
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / std::max(g_options.rate_hz, 0.1)));
+    auto due = Clock::now();
+    uint64_t tick = 0;
+
+    while (ok && !g_stop.load()) {
+        // Sleep until the tick on the socket, so a ping is stamped when it
+        // arrives rather than at the next tick.
+        for (auto left = due - Clock::now(); ok && left > Clock::duration::zero(); left = due - Clock::now()) {
+            const auto us = std::chrono::duration_cast<std::chrono::microseconds>(left).count();
+            fd_set readable;
+            FD_ZERO(&readable);
+            FD_SET(s, &readable);
+            timeval timeout{ static_cast<long>(us / 1000000), static_cast<long>(us % 1000000) };
+            if (::select(static_cast<int>(s) + 1, &readable, nullptr, nullptr, &timeout) > 0)
+                ok = readClient(s, inbox, wantDelta);
+        }
+        if (!ok) break;
+        const auto now = Clock::now();
+        const auto lag = now - due;
+        if (lag > period) {
+            g_counters.late.fetch_add(1, std::memory_order_relaxed);
+            const int64_t lagUs = std::chrono::duration_cast<std::chrono::microseconds>(lag).count();
+            int64_t seen = g_counters.maxLagUs.load(std::memory_order_relaxed);
+            while (lagUs > seen && !g_counters.maxLagUs.compare_exchange_weak(seen, lagUs)) {}
+        }
+
+        buildState(g_traffic, tick++, std::chrono::duration<double>(now - g_clock_zero).count(), state);
+        if (wantDelta && TrackServerJson::parse(state, frame)) {
+            encoder.Encode(frame, encoded);
+            ok = sendFrame(s, encoded, scratch, WebSocketProtocol::kBinary);
+        } else {
+            ok = sendFrame(s, state, scratch);
+        }
+
+        // A client that fell a whole second behind gets a fresh schedule
+        // rather than a burst of catch-up frames.
+        due += period;
+        if (Clock::now() - due > std::chrono::seconds(1))
+            due = Clock::now();
+    }
+
+    closeSocket(s);
+    g_counters.clients.fetch_sub(1);
+}
+
+void acceptLoop()
+{
+    auto nextLog = Clock::now() + std::chrono::seconds(5);
+    while (!g_stop.load()) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(g_listen, &readable);
+        timeval timeout{ 0, 200 * 1000 }; // Re-checks g_stop five times a second
+        const int ready = ::select(static_cast<int>(g_listen) + 1, &readable, nullptr, nullptr, &timeout);
+
+        if (ready > 0) {
+            const socket_t client = ::accept(g_listen, nullptr, nullptr);
+            if (client != kInvalidSocket) {
+                const int one = 1;
+                ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+#if defined(_WIN32)
+                const DWORD sendTimeout = 1000;
+#else
+                const timeval sendTimeout{ 1, 0 };
+#endif
+                ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&sendTimeout), sizeof(sendTimeout));
+                std::lock_guard<std::mutex> lock(g_clients_mutex);
+                g_client_threads.emplace_back(serveClient, client);
+            }
+        }
+
+        if (Clock::now() >= nextLog) {
+            nextLog += std::chrono::seconds(5);
+            const Stats s = stats();
+            LOG_INFO(Network, "[REPLAY] clients=" << s.clients << " frames=" << s.frames_sent
+                     << " bytes=" << s.bytes_sent << " late=" << s.late_ticks
+                     << " max_lag_ms=" << s.max_lag_ms);
+        }
+    }
+}
+
+std::string readEnvironment(const char* name)
+{
+#if defined(_WIN32)
+    char* value = nullptr;
+    size_t size = 0;
+    std::string out;
+    if (_dupenv_s(&value, &size, name) == 0 && value) {
+        out = value;
+        free(value);
+    }
+    return out;
+#else
+    const char* value = std::getenv(name);
+    return value ? value : "";
+#endif
+}
+
+} // namespace
+
+bool start(const Options& options)
+{
+    if (g_running.load()) return true;
+
+    g_options = options;
+    g_traffic = Traffic{};
+    g_traffic.cars = options.cars;
+    if (!options.recording.empty()) {
+        if (!loadRecording(options.recording, g_traffic)) return false;
+    } else {
+        buildCircuit(g_traffic);
+    }
+
+#if defined(_WIN32)
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    g_listen = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (g_listen == kInvalidSocket) return false;
+    const int one = 1;
+    ::setsockopt(g_listen, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(options.port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(g_listen, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(g_listen, 16) != 0) {
+        LOG_ERROR(Network, "[REPLAY] cannot listen on 127.0.0.1:" << options.port);
+        closeSocket(g_listen);
+        g_listen = kInvalidSocket;
+        return false;
+    }
+
+    g_counters.frames = 0;
+    g_counters.bytes = 0;
+    g_counters.late = 0;
+    g_counters.maxLagUs = 0;
+    g_clock_zero = Clock::now();
+    g_stop.store(false);
+    g_running.store(true);
+    g_accept_thread = std::thread(acceptLoop);
+    LOG_INFO(Network, "[REPLAY] serving ws://127.0.0.1:" << options.port << "/ — "
+             << g_traffic.cars << " cars at " << options.rate_hz << " Hz ("
+             << (options.recording.empty() ? "built-in circuit" : options.recording) << ")");
+    return true;
+}
+
+void stop()
+{
+    if (!g_running.load()) return;
+    g_stop.store(true);
+    if (g_accept_thread.joinable())
+        g_accept_thread.join();
+    closeSocket(g_listen);
+    g_listen = kInvalidSocket;
+
+    std::vector<std::thread> clients;
+    {
+        std::lock_guard<std::mutex> lock(g_clients_mutex);
+        clients.swap(g_client_threads);
+    }
+    for (std::thread& t : clients)
+        t.join();
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+    g_running.store(false);
+}
+
+bool isRunning() { return g_running.load(); }
+
+Stats stats()
+{
+    Stats s;
+    s.clients = g_counters.clients.load();
+    s.frames_sent = g_counters.frames.load();
+    s.bytes_sent = g_counters.bytes.load();
+    s.late_ticks = g_counters.late.load();
+    s.max_lag_ms = g_counters.maxLagUs.load() / 1000.0;
+    return s;
+}
+
+void applyEnvironment()
+{
+    const std::string record = readEnvironment("BONI_TRACK_RECORD");
+    if (!record.empty())
+        TrackServerClient::setRecordingPath(record);
+
+    const std::string spec = readEnvironment("BONI_REPLAY");
+    if (spec.empty()) return;
+
+    // port[,cars[,hz[,recording]]]
+    Options options;
+    std::vector<std::string> fields;
+    std::stringstream ss(spec);
+    for (std::string field; fields.size() < 3 && std::getline(ss, field, ',');)
+        fields.push_back(field);
+    std::getline(ss, options.recording); // May itself contain commas
+    if (!fields.empty() && !fields[0].empty()) options.port = static_cast<uint16_t>(std::atoi(fields[0].c_str()));
+    if (fields.size() > 1 && !fields[1].empty()) options.cars = std::atoi(fields[1].c_str());
+    if (fields.size() > 2 && !fields[2].empty()) options.rate_hz = std::atof(fields[2].c_str());
+
+    if (!start(options)) return;
+    TrackServerClient::setConnectParams("127.0.0.1", options.port, "");
+    TrackServerClient::start();
+}
+
+} // namespace TrackServerReplay
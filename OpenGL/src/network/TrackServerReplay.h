@@ -0,0 +1,55 @@
+#pragma once
+
+// ============================================================================
+// TrackServerReplay — a stand-in Track Server on localhost for load tests.
+//
+// Speaks just enough WebSocket to feed TrackServerClient: on connect it sends
+// hello + track, then state frames at `rate_hz` with `cars` cars, for as long
+// as the client stays. The traffic comes from a recording made with
+// TrackServerClient::setRecordingPath() (one frame per line; its state frames
+// are looped, their cars cloned under new IDs up to `cars`), or without one
+// from a built-in circle circuit.
+//
+// Offers the binary delta1 state encoding (TrackServerDelta) in hello and
+// switches a client over when it asks for it.
+//
+// Every client gets its own sender thread, which counts ticks it could not
+// send on time — a client that stops draining its socket shows up as late
+// ticks and max lag in stats() and in the periodic log line.
+//
+// BONI_REPLAY=port[,cars[,hz[,recording]]] starts it at launch and points
+// TrackServerClient at it (applyEnvironment()); BONI_TRACK_RECORD=file turns
+// on client recording.
+// ============================================================================
+
+#include <cstdint>
+#include <string>
+
+namespace TrackServerReplay {
+
+struct Options {
+    uint16_t    port = 8765;
+    int         cars = 0;           // 0 = as recorded (built-in circuit: 20)
+    double      rate_hz = 20.0;
+    std::string recording;          // Empty = built-in circuit
+};
+
+// Loads the traffic and starts listening on 127.0.0.1. False if the
+// recording cannot be read or the port cannot be bound.
+bool start(const Options& options);
+void stop();
+bool isRunning();
+
+struct Stats {
+    uint32_t clients = 0;           // Connected right now
+    uint64_t frames_sent = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t late_ticks = 0;        // State frames sent more than a tick late
+    double   max_lag_ms = 0.0;
+};
+Stats stats();
+
+// Reads BONI_REPLAY / BONI_TRACK_RECORD (see above). No-op when unset.
+void applyEnvironment();
+
+} // namespace TrackServerReplay
@@ -0,0 +1,179 @@
+#include "WebSocketProtocol.h"
+
+#include <cctype>
+#include <cstring>
+
+namespace WebSocketProtocol {
+namespace {
+
+constexpr const char* kHandshakeGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+uint32_t rotl(uint32_t v, int n)
+{
+    return (v << n) | (v >> (32 - n));
+}
+
+// SHA-1 — only ever run over a 60-byte handshake string.
+void sha1(const uint8_t* data, size_t size, uint8_t digest[20])
+{
+    uint32_t h[5] = { 0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u };
+
+    const uint64_t bitSize = static_cast<uint64_t>(size) * 8;
+    const size_t paddedSize = ((size + 8) / 64 + 1) * 64;
+    uint8_t block[64];
+
+    for (size_t offset = 0; offset < paddedSize; offset += 64) {
+        for (size_t i = 0; i < 64; ++i) {
+            const size_t pos = offset + i;
+            if (pos < size)                 block[i] = data[pos];
+            else if (pos == size)           block[i] = 0x80;
+            else if (pos >= paddedSize - 8) block[i] = static_cast<uint8_t>(bitSize >> ((paddedSize - 1 - pos) * 8));
+            else                            block[i] = 0;
+        }
+
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i)
+            w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+                   (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+        for (int i = 16; i < 80; ++i)
+            w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999u; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1u; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDCu; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6u; }
+            const uint32_t t = rotl(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rotl(b, 30); b = a; a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        digest[i * 4]     = static_cast<uint8_t>(h[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+    }
+}
+
+bool equalsNoCase(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+            return false;
+    return true;
+}
+
+} // namespace
+
+bool parseFrameHeader(const uint8_t* data, size_t size, FrameHeader& out)
+{
+    if (size < 2) return false;
+    out.fin = (data[0] & 0x80) != 0;
+    out.opcode = data[0] & 0x0F;
+    out.masked = (data[1] & 0x80) != 0;
+
+    size_t pos = 2;
+    uint64_t length = data[1] & 0x7F;
+    if (length == 126) {
+        if (size < pos + 2) return false;
+        length = (uint64_t(data[2]) << 8) | data[3];
+        pos += 2;
+    } else if (length == 127) {
+        if (size < pos + 8) return false;
+        length = 0;
+        for (int i = 0; i < 8; ++i)
+            length = (length << 8) | data[2 + i];
+        pos += 8;
+    }
+    if (out.masked) {
+        if (size < pos + 4) return false;
+        std::memcpy(out.mask, data + pos, 4);
+        pos += 4;
+    }
+    out.payloadSize = length;
+    out.headerSize = pos;
+    return true;
+}
+
+size_t writeFrameHeader(uint8_t* out, uint8_t opcode, uint64_t payloadSize, const uint8_t* mask)
+{
+    out[0] = static_cast<uint8_t>(0x80 | (opcode & 0x0F));
+    const uint8_t maskBit = mask ? 0x80 : 0x00;
+    size_t pos = 2;
+    if (payloadSize < 126) {
+        out[1] = static_cast<uint8_t>(maskBit | payloadSize);
+    } else if (payloadSize <= 0xFFFF) {
+        out[1] = static_cast<uint8_t>(maskBit | 126);
+        out[2] = static_cast<uint8_t>(payloadSize >> 8);
+        out[3] = static_cast<uint8_t>(payloadSize);
+        pos = 4;
+    } else {
+        out[1] = static_cast<uint8_t>(maskBit | 127);
+        for (int i = 0; i < 8; ++i)
+            out[2 + i] = static_cast<uint8_t>(payloadSize >> ((7 - i) * 8));
+        pos = 10;
+    }
+    if (mask) {
+        std::memcpy(out + pos, mask, 4);
+        pos += 4;
+    }
+    return pos;
+}
+
+void applyMask(uint8_t* data, size_t size, const uint8_t mask[4])
+{
+    for (size_t i = 0; i < size; ++i)
+        data[i] ^= mask[i & 3];
+}
+
+std::string base64(const uint8_t* data, size_t size)
+{
+    static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((size + 2) / 3 * 4);
+    for (size_t i = 0; i < size; i += 3) {
+        const uint32_t n = (uint32_t(data[i]) << 16) |
+                           (i + 1 < size ? uint32_t(data[i + 1]) << 8 : 0) |
+                           (i + 2 < size ? uint32_t(data[i + 2]) : 0);
+        out += kAlphabet[(n >> 18) & 63];
+        out += kAlphabet[(n >> 12) & 63];
+        out += i + 1 < size ? kAlphabet[(n >> 6) & 63] : '=';
+        out += i + 2 < size ? kAlphabet[n & 63] : '=';
+    }
+    return out;
+}
+
+std::string acceptKey(std::string_view clientKey)
+{
+    std::string input(clientKey);
+    input += kHandshakeGuid;
+    uint8_t digest[20];
+    sha1(reinterpret_cast<const uint8_t*>(input.data()), input.size(), digest);
+    return base64(digest, sizeof(digest));
+}
+
+std::string_view headerValue(std::string_view head, std::string_view name)
+{
+    size_t pos = head.find("\r\n");
+    while (pos != std::string_view::npos) {
+        const size_t start = pos + 2;
+        const size_t end = head.find("\r\n", start);
+        const std::string_view line = head.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+        const size_t colon = line.find(':');
+        if (colon != std::string_view::npos && equalsNoCase(line.substr(0, colon), name)) {
+            std::string_view value = line.substr(colon + 1);
+            while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+            while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+            return value;
+        }
+        pos = end;
+    }
+    return {};
+}
+
+} // namespace WebSocketProtocol
@@ -0,0 +1,57 @@
+#pragma once
+
+// ============================================================================
+// WebSocketProtocol — the bits of RFC 6455 shared by our own client transport
+// (WebSocketTransportEpoll) and the loopback replay server: handshake keys
+// and frame headers. No sockets in here.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace WebSocketProtocol {
+
+enum Opcode : uint8_t {
+    kContinuation = 0x0,
+    kText         = 0x1,
+    kBinary       = 0x2,
+    kClose        = 0x8,
+    kPing         = 0x9,
+    kPong         = 0xA,
+};
+
+// Largest frame header: 2 + 8 (64-bit length) + 4 (mask).
+constexpr size_t kMaxHeaderSize = 14;
+
+struct FrameHeader {
+    bool     fin = false;
+    uint8_t  opcode = 0;
+    bool     masked = false;
+    uint8_t  mask[4] = {};
+    uint64_t payloadSize = 0;
+    size_t   headerSize = 0;
+};
+
+// False while `size` bytes are not yet a whole header.
+bool parseFrameHeader(const uint8_t* data, size_t size, FrameHeader& out);
+
+// Writes a single-frame (FIN) header into `out` (kMaxHeaderSize bytes) and
+// returns its size. `mask` nullptr = unmasked (server -> client).
+size_t writeFrameHeader(uint8_t* out, uint8_t opcode, uint64_t payloadSize,
+                        const uint8_t* mask = nullptr);
+
+// XORs `size` bytes with the 4-byte mask, starting at mask offset 0.
+void applyMask(uint8_t* data, size_t size, const uint8_t mask[4]);
+
+std::string base64(const uint8_t* data, size_t size);
+
+// Sec-WebSocket-Accept for a client's Sec-WebSocket-Key.
+std::string acceptKey(std::string_view clientKey);
+
+// Value of an HTTP header (case-insensitive name) in a raw request/response
+// head, empty if absent.
+std::string_view headerValue(std::string_view head, std::string_view name);
+
+} // namespace WebSocketProtocol
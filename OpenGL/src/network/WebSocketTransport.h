@@ -0,0 +1,51 @@
+#pragma once
+
+// ============================================================================
+// WebSocketTransport — the socket under TrackServerClient.
+//
+// One object = one connection attempt/session. Backends:
+//   * Windows: WinHTTP (WebSocketTransportWinHttp.cpp) — what the client has
+//     always used;
+//   * Linux:   non-blocking socket + epoll, RFC 6455 done by hand
+//     (WebSocketTransportEpoll.cpp), so the client builds, profiles and
+//     load-tests on the Linux boxes too.
+//
+// Threading: one thread connects and receives; SendText() and Abort() may be
+// called from any other thread while it does.
+// ============================================================================
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class WebSocketTransport
+{
+public:
+    enum class Receive {
+        Message,    // `message` holds one whole (reassembled) message
+        Closed,     // Server closed the connection, or Abort() was called
+        Error,      // Socket / protocol error — see LastError()
+    };
+
+    virtual ~WebSocketTransport() = default;
+
+    // Blocking connect + HTTP upgrade to ws://host:port/path.
+    virtual bool Connect(const std::string& host, uint16_t port, const std::string& path) = 0;
+
+    // Blocks until a whole message has arrived. `message` points into the
+    // transport's receive buffer and stays valid until the next call.
+    virtual Receive ReceiveMessage(std::string_view& message) = 0;
+
+    // Any thread. Sends one text message.
+    virtual bool SendText(std::string_view text) = 0;
+
+    // Any thread. Makes a blocked Connect/ReceiveMessage return; the session
+    // is over afterwards.
+    virtual void Abort() = 0;
+
+    virtual std::string LastError() const = 0;
+};
+
+// The backend for this platform.
+std::unique_ptr<WebSocketTransport> CreateWebSocketTransport();
@@ -0,0 +1,391 @@
+// ============================================================================
+// WebSocketTransport for Linux: non-blocking TCP socket, epoll, RFC 6455 by
+// hand (client side: masked sends, unmasked receives).
+//
+// Receiving: bytes land in one reusable buffer; frames are parsed where they
+// are and the payloads of a fragmented message are slid down next to each
+// other in place, so a message is handed out as a view — no per-message
+// copy or allocation once the buffer has grown to the largest frame seen.
+// Pings are answered from the receive thread.
+//
+// An eventfd in the epoll set (and in the poll of a blocked send) is the
+// Abort() doorbell.
+// ============================================================================
+
+#if defined(__linux__)
+
+#include "WebSocketTransport.h"
+#include "WebSocketProtocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+namespace WS = WebSocketProtocol;
+
+constexpr int    kConnectTimeoutMs = 5000;
+constexpr int    kSendTimeoutMs = 5000;
+constexpr size_t kInitialBuffer = 64 * 1024;
+constexpr size_t kMinRead = 16 * 1024;              // Free space kept for each recv
+constexpr uint64_t kMaxMessageSize = 64ull << 20;   // A track frame is ~1 MB at most
+
+class EpollTransport final : public WebSocketTransport
+{
+public:
+    EpollTransport()
+        : m_rng(std::random_device{}())
+    {
+        m_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = m_wake;
+        epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &ev);
+        m_buffer.resize(kInitialBuffer);
+    }
+
+    ~EpollTransport() override
+    {
+        if (m_open && !m_aborted.load()) {
+            const uint8_t normal[2] = { 0x03, 0xE8 };   // 1000: normal closure
+            sendFrame(WS::kClose, normal, sizeof(normal));
+        }
+        if (m_fd >= 0) close(m_fd);
+        if (m_epoll >= 0) close(m_epoll);
+        if (m_wake >= 0) close(m_wake);
+    }
+
+    bool Connect(const std::string& host, uint16_t port, const std::string& path) override
+    {
+        if (m_wake < 0 || m_epoll < 0)
+            return fail("epoll/eventfd unavailable");
+        if (!connectSocket(host, port))
+            return false;
+
+        // HTTP upgrade.
+        uint8_t nonce[16];
+        for (uint8_t& b : nonce) b = static_cast<uint8_t>(m_rng());
+        const std::string key = WS::base64(nonce, sizeof(nonce));
+        const std::string request =
+            "GET " + path + " HTTP/1.1\r\n"
+            "Host: " + host + ":" + std::to_string(port) + "\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Key: " + key + "\r\n"
+            "Sec-WebSocket-Version: 13\r\n"
+            "User-Agent: RAJAGP-Client/1.0\r\n"
+            "\r\n";
+        if (!sendAll(reinterpret_cast<const uint8_t*>(request.data()), request.size()))
+            return false;
+
+        size_t headEnd = std::string::npos;
+        while (headEnd == std::string::npos) {
+            if (!readMore(kConnectTimeoutMs))
+                return false;
+            const std::string_view received(reinterpret_cast<const char*>(m_buffer.data()), m_end);
+            headEnd = received.find("\r\n\r\n");
+            if (headEnd == std::string::npos && m_end > 16 * 1024)
+                return fail("oversized handshake response");
+        }
+
+        const std::string_view head(reinterpret_cast<const char*>(m_buffer.data()), headEnd + 2);
+        if (head.compare(0, 12, "HTTP/1.1 101") != 0)
+            return fail("upgrade refused: " + std::string(head.substr(0, head.find("\r\n"))));
+        if (WS::headerValue(head, "Sec-WebSocket-Accept") != WS::acceptKey(key))
+            return fail("bad Sec-WebSocket-Accept");
+
+        // Frames the server sent right behind the handshake stay buffered.
+        m_consumed = headEnd + 4;
+        m_open = true;
+        return true;
+    }
+
+    Receive ReceiveMessage(std::string_view& message) override
+    {
+        // Drop what the previous call handed out.
+        if (m_consumed) {
+            std::memmove(m_buffer.data(), m_buffer.data() + m_consumed, m_end - m_consumed);
+            m_end -= m_consumed;
+            m_consumed = 0;
+        }
+
+        size_t parse = 0;           // Next frame header
+        size_t messageStart = 0;    // Payload of the message being assembled
+        size_t messageSize = 0;
+        bool inMessage = false;
+
+        for (;;) {
+            if (m_aborted.load())
+                return Receive::Closed;
+
+            WS::FrameHeader header;
+            const bool haveHeader = WS::parseFrameHeader(m_buffer.data() + parse, m_end - parse, header);
+            if (haveHeader && header.payloadSize > kMaxMessageSize) {
+                fail("frame too large");
+                return Receive::Error;
+            }
+            if (!haveHeader || m_end - parse < header.headerSize + header.payloadSize) {
+                // Need more bytes; grow only when a frame outgrows the buffer.
+                const size_t needed = haveHeader ? parse + header.headerSize + static_cast<size_t>(header.payloadSize) : 0;
+                if (m_buffer.size() < std::max(needed, m_end + kMinRead))
+                    m_buffer.resize(std::max(std::max(needed, m_end + kMinRead), m_buffer.size() * 2));
+                if (!readMore(-1))
+                    return m_aborted.load() || m_peerClosed ? Receive::Closed : Receive::Error;
+                continue;
+            }
+
+            uint8_t* payload = m_buffer.data() + parse + header.headerSize;
+            const size_t payloadSize = static_cast<size_t>(header.payloadSize);
+            if (header.masked)
+                WS::applyMask(payload, payloadSize, header.mask);
+            const size_t frameEnd = parse + header.headerSize + payloadSize;
+
+            switch (header.opcode) {
+            case WS::kPing:
+                sendFrame(WS::kPong, payload, payloadSize);
+                parse = frameEnd;
+                continue;
+            case WS::kPong:
+                parse = frameEnd;
+                continue;
+            case WS::kClose:
+                sendFrame(WS::kClose, payload, std::min<size_t>(payloadSize, 2));
+                m_open = false;
+                return Receive::Closed;
+            case WS::kText:
+            case WS::kBinary:
+            case WS::kContinuation:
+                if ((header.opcode == WS::kContinuation) != inMessage) {
+                    fail("unexpected fragment");
+                    return Receive::Error;
+                }
+                if (!inMessage) {
+                    inMessage = true;
+                    messageStart = parse + header.headerSize;
+                    messageSize = 0;
+                }
+                if (payload != m_buffer.data() + messageStart + messageSize)
+                    std::memmove(m_buffer.data() + messageStart + messageSize, payload, payloadSize);
+                messageSize += payloadSize;
+                if (messageSize > kMaxMessageSize) {
+                    fail("message too large");
+                    return Receive::Error;
+                }
+                parse = frameEnd;
+                if (header.fin) {
+                    message = std::string_view(reinterpret_cast<const char*>(m_buffer.data()) + messageStart, messageSize);
+                    m_consumed = parse;
+                    return Receive::Message;
+                }
+                continue;
+            default:
+                fail("unknown opcode " + std::to_string(header.opcode));
+                return Receive::Error;
+            }
+        }
+    }
+
+    bool SendText(std::string_view text) override
+    {
+        if (!m_open || m_aborted.load())
+            return false;
+        return sendFrame(WS::kText, reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    }
+
+    void Abort() override
+    {
+        m_aborted.store(true);
+        const uint64_t one = 1;
+        if (m_wake >= 0)
+            (void)!write(m_wake, &one, sizeof(one));
+    }
+
+    std::string LastError() const override
+    {
+        std::lock_guard<std::mutex> lock(m_error_mutex);
+        return m_error;
+    }
+
+private:
+    // Also called from sending threads, hence the lock.
+    bool fail(const std::string& what)
+    {
+        std::lock_guard<std::mutex> lock(m_error_mutex);
+        m_error = what;
+        return false;
+    }
+
+    bool failErrno(const char* what)
+    {
+        return fail(std::string(what) + ": " + std::strerror(errno));
+    }
+
+    // Waits for `events` on the socket or the Abort() doorbell.
+    bool waitSocket(short events, int timeoutMs)
+    {
+        pollfd fds[2] = { { m_fd, events, 0 }, { m_wake, POLLIN, 0 } };
+        for (;;) {
+            const int rc = poll(fds, 2, timeoutMs);
+            if (rc < 0 && errno == EINTR) continue;
+            if (rc < 0) return failErrno("poll");
+            if (rc == 0) return fail("timeout");
+            if (fds[1].revents) return fail("aborted");
+            return true;
+        }
+    }
+
+    bool connectSocket(const std::string& host, uint16_t port)
+    {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+        const int rc = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses);
+        if (rc != 0)
+            return fail(std::string("getaddrinfo: ") + gai_strerror(rc));
+
+        for (addrinfo* ai = addresses; ai && m_fd < 0; ai = ai->ai_next) {
+            m_fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+            if (m_fd < 0) continue;
+
+            bool connected = ::connect(m_fd, ai->ai_addr, ai->ai_addrlen) == 0;
+            if (!connected && errno == EINPROGRESS && waitSocket(POLLOUT, kConnectTimeoutMs)) {
+                int error = 0;
+                socklen_t len = sizeof(error);
+                getsockopt(m_fd, SOL_SOCKET, SO_ERROR, &error, &len);
+                connected = error == 0;
+                if (!connected) fail(std::string("connect: ") + std::strerror(error));
+            } else if (!connected && errno != EINPROGRESS) {
+                failErrno("connect");
+            }
+            if (!connected) {
+                close(m_fd);
+                m_fd = -1;
+            }
+        }
+        freeaddrinfo(addresses);
+        if (m_fd < 0)
+            return false;
+
+        const int one = 1;
+        setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = m_fd;
+        if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_fd, &ev) != 0)
+            return failErrno("epoll_ctl");
+        return true;
+    }
+
+    // Appends whatever the socket has to m_buffer, waiting up to `timeoutMs`
+    // (-1 = forever) for the first byte. False on close/abort/error.
+    bool readMore(int timeoutMs)
+    {
+        for (;;) {
+            if (m_buffer.size() - m_end < kMinRead)
+                m_buffer.resize(m_end + kMinRead);
+            const ssize_t n = recv(m_fd, m_buffer.data() + m_end, m_buffer.size() - m_end, 0);
+            if (n > 0) {
+                m_end += static_cast<size_t>(n);
+                return true;
+            }
+            if (n == 0) {
+                m_peerClosed = true;
+                return fail("connection closed by peer");
+            }
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                return failErrno("recv");
+
+            epoll_event events[2];
+            const int rc = epoll_wait(m_epoll, events, 2, timeoutMs);
+            if (rc < 0 && errno != EINTR)
+                return failErrno("epoll_wait");
+            if (rc == 0)
+                return fail("timeout");
+            for (int i = 0; i < rc; ++i)
+                if (events[i].data.fd == m_wake)
+                    return fail("aborted");
+        }
+    }
+
+    bool sendAll(const uint8_t* data, size_t size)
+    {
+        while (size > 0) {
+            const ssize_t n = send(m_fd, data, size, MSG_NOSIGNAL);
+            if (n > 0) {
+                data += n;
+                size -= static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!waitSocket(POLLOUT, kSendTimeoutMs))
+                    return false;
+                continue;
+            }
+            return failErrno("send");
+        }
+        return true;
+    }
+
+    // One masked FIN frame. Serialised: the UI thread sends commands while
+    // the receive thread answers pings.
+    bool sendFrame(uint8_t opcode, const uint8_t* payload, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_send_mutex);
+        uint8_t mask[4];
+        for (uint8_t& b : mask) b = static_cast<uint8_t>(m_rng());
+
+        m_send.resize(WS::kMaxHeaderSize + size);
+        const size_t headerSize = WS::writeFrameHeader(m_send.data(), opcode, size, mask);
+        if (size)
+            std::memcpy(m_send.data() + headerSize, payload, size);
+        WS::applyMask(m_send.data() + headerSize, size, mask);
+        return sendAll(m_send.data(), headerSize + size);
+    }
+
+    int m_fd = -1;
+    int m_epoll = -1;
+    int m_wake = -1;
+    std::atomic<bool> m_open{ false };
+    bool m_peerClosed = false;
+    std::atomic<bool> m_aborted{ false };
+    mutable std::mutex m_error_mutex;
+    std::string m_error;
+
+    std::vector<uint8_t> m_buffer;  // Receive side, reused
+    size_t m_end = 0;               // Valid bytes in m_buffer
+    size_t m_consumed = 0;          // Bytes of the message handed out last
+
+    std::mutex m_send_mutex;        // Guards m_send, m_rng and the socket's send side
+    std::vector<uint8_t> m_send;
+    std::mt19937 m_rng;
+};
+
+} // namespace
+
+std::unique_ptr<WebSocketTransport> CreateWebSocketTransport()
+{
+    return std::make_unique<EpollTransport>();
+}
+
+#endif // __linux__
@@ -0,0 +1,156 @@
+// ============================================================================
+// WebSocketTransport on native WinHTTP (Windows x64 + ARM64, no third-party
+// sockets). Moved here from TrackServerClient unchanged in behaviour.
+// ============================================================================
+
+#if defined(_WIN32)
+
+#include "WebSocketTransport.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <winhttp.h>
+#pragma comment(lib, "winhttp.lib")
+
+namespace {
+
+constexpr size_t kReceiveChunk = 64 * 1024;
+
+std::wstring widen(const std::string& s)
+{
+    return std::wstring(s.begin(), s.end()); // host/path are ASCII
+}
+
+class WinHttpTransport final : public WebSocketTransport
+{
+public:
+    ~WinHttpTransport() override
+    {
+        if (m_ws) {
+            WinHttpWebSocketClose(m_ws, WINHTTP_WEB_SOCKET_SUCCESS_CLOSE_STATUS, nullptr, 0);
+            WinHttpCloseHandle(m_ws);
+        }
+        if (m_connect) WinHttpCloseHandle(m_connect);
+        if (m_session) WinHttpCloseHandle(m_session);
+    }
+
+    bool Connect(const std::string& host, uint16_t port, const std::string& path) override
+    {
+        m_session = WinHttpOpen(L"RAJAGP-Client/1.0",
+                                WINHTTP_ACCESS_TYPE_NO_PROXY,
+                                WINHTTP_NO_PROXY_NAME,
+                                WINHTTP_NO_PROXY_BYPASS, 0);
+        if (!m_session) { m_error = GetLastError(); return false; }
+
+        m_connect = WinHttpConnect(m_session, widen(host).c_str(), port, 0);
+        HINTERNET request = nullptr;
+        HINTERNET ws = nullptr;
+
+        do {
+            if (!m_connect) break;
+            request = WinHttpOpenRequest(m_connect, L"GET", widen(path).c_str(),
+                                         nullptr, WINHTTP_NO_REFERER,
+                                         WINHTTP_DEFAULT_ACCEPT_TYPES, 0);
+            if (!request) break;
+
+            if (!WinHttpSetOption(request, WINHTTP_OPTION_UPGRADE_TO_WEB_SOCKET,
+                                  nullptr, 0))
+                break;
+            if (!WinHttpSendRequest(request, WINHTTP_NO_ADDITIONAL_HEADERS, 0,
+                                    nullptr, 0, 0, 0))
+                break;
+            if (!WinHttpReceiveResponse(request, nullptr))
+                break;
+
+            ws = WinHttpWebSocketCompleteUpgrade(request, 0);
+        } while (false);
+
+        if (!ws) m_error = GetLastError();
+        if (request) WinHttpCloseHandle(request);
+        if (!ws) return false;
+
+        std::lock_guard<std::mutex> lock(m_ws_mutex);
+        m_ws = ws;
+        return true;
+    }
+
+    Receive ReceiveMessage(std::string_view& message) override
+    {
+        // Fragments are received straight into the tail of the reused buffer.
+        size_t size = 0;
+        for (;;) {
+            if (m_aborted.load()) return Receive::Closed;
+            if (m_buffer.size() < size + kReceiveChunk)
+                m_buffer.resize(size + kReceiveChunk);
+
+            DWORD read = 0;
+            WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
+            const DWORD rc = WinHttpWebSocketReceive(
+                m_ws, m_buffer.data() + size, static_cast<DWORD>(m_buffer.size() - size), &read, &type);
+            if (rc != NO_ERROR) {
+                m_error = rc;
+                return m_aborted.load() ? Receive::Closed : Receive::Error;
+            }
+            if (type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE)
+                return Receive::Closed;
+            size += read;
+            if (type == WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE ||
+                type == WINHTTP_WEB_SOCKET_BINARY_MESSAGE_BUFFER_TYPE) {
+                message = std::string_view(m_buffer.data(), size);
+                return Receive::Message;
+            }
+        }
+    }
+
+    bool SendText(std::string_view text) override
+    {
+        std::lock_guard<std::mutex> lock(m_ws_mutex);
+        if (!m_ws || m_aborted.load())
+            return false;
+        const DWORD rc = WinHttpWebSocketSend(
+            m_ws, WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
+            const_cast<char*>(text.data()), static_cast<DWORD>(text.size()));
+        return rc == NO_ERROR;
+    }
+
+    void Abort() override
+    {
+        m_aborted.store(true);
+        // Closing the socket is what wakes a blocked WinHttpWebSocketReceive.
+        std::lock_guard<std::mutex> lock(m_ws_mutex);
+        if (m_ws)
+            WinHttpWebSocketClose(m_ws, WINHTTP_WEB_SOCKET_SUCCESS_CLOSE_STATUS, nullptr, 0);
+    }
+
+    std::string LastError() const override
+    {
+        return "err=" + std::to_string(m_error);
+    }
+
+private:
+    HINTERNET m_session = nullptr;
+    HINTERNET m_connect = nullptr;
+    HINTERNET m_ws = nullptr;
+    std::mutex m_ws_mutex;              // m_ws vs. SendText/Abort from other threads
+    std::atomic<bool> m_aborted{ false };
+    std::vector<char> m_buffer;
+    DWORD m_error = 0;
+};
+
+} // namespace
+
+std::unique_ptr<WebSocketTransport> CreateWebSocketTransport()
+{
+    return std::make_unique<WinHttpTransport>();
+}
+
+#endif // _WIN32
@@ -0,0 +1,169 @@
+#include "LapSamples.h"
+#include "LapSpill.h"
+#include "../Config.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ============================================================================
+// QUANTIZATION
+// ============================================================================
+namespace
+{
+    constexpr double kCentimetresPerUnit = MapConstants::MAP_SIZE * 100.0;
+
+    // Round to the nearest step and saturate to T's range
+    template <typename T>
+    T quantize(double value, double stepsPerUnit)
+    {
+        const double q = std::round(value * stepsPerUnit);
+        if (!(q > static_cast<double>(std::numeric_limits<T>::min())))
+            return std::numeric_limits<T>::min();
+        if (q >= static_cast<double>(std::numeric_limits<T>::max()))
+            return std::numeric_limits<T>::max();
+        return static_cast<T>(q);
+    }
+
+    uint32_t quantizeProgress(double progress)
+    {
+        return quantize<uint32_t>(progress, LapSamples::PROGRESS_ONE);
+    }
+}
+
+// ============================================================================
+// APPEND / CLEAR
+// ============================================================================
+void LapSamples::Append(const LapInfo& sample)
+{
+    if (m_spilled)
+        return;
+
+    const size_t slot = m_size % CHUNK_SAMPLES;
+    if (slot == 0)
+        m_chunks.emplace_back();
+
+    Chunk& chunk = m_chunks.back();
+    chunk.timeMs[slot]        = quantize<uint32_t>(sample.timefromstart, 1000.0);
+    chunk.progress[slot]      = quantizeProgress(sample.progress);
+    chunk.xCm[slot]           = quantize<int32_t>(sample.position.x, kCentimetresPerUnit);
+    chunk.yCm[slot]           = quantize<int32_t>(sample.position.y, kCentimetresPerUnit);
+    chunk.speedCentiKph[slot] = quantize<uint16_t>(sample.speed, 100.0);
+    chunk.gForceXMilli[slot]  = quantize<int16_t>(sample.gForceX, 1000.0);
+    chunk.gForceYMilli[slot]  = quantize<int16_t>(sample.gForceY, 1000.0);
+    chunk.accelCenti[slot]    = quantize<int16_t>(sample.aceleration, 100.0);
+    chunk.racePosition[slot]  = quantize<uint16_t>(sample.curentPosition, 1.0);
+    ++m_size;
+}
+
+void LapSamples::Clear()
+{
+    m_chunks.clear();
+    m_spilled = nullptr;
+    m_size = 0;
+}
+
+// ============================================================================
+// SPILL - chunks copied back to back into the session file
+// ============================================================================
+bool LapSamples::Spill()
+{
+    if (m_spilled || m_chunks.empty())
+        return m_spilled != nullptr;
+
+    uint8_t* out = LapSpill::Reserve(m_chunks.size() * sizeof(Chunk));
+    if (!out)
+        return false;
+
+    Chunk* chunks = reinterpret_cast<Chunk*>(out);
+    std::copy(m_chunks.begin(), m_chunks.end(), chunks);
+    m_spilled = chunks;
+    std::deque<Chunk>().swap(m_chunks);   // Give the memory back
+    return true;
+}
+
+// ============================================================================
+// READ
+// ============================================================================
+LapInfo LapSamples::At(size_t i) const
+{
+    const Chunk& chunk = this->chunk(i / CHUNK_SAMPLES);
+    const size_t slot = i % CHUNK_SAMPLES;
+
+    LapInfo sample;
+    sample.timefromstart  = chunk.timeMs[slot] / 1000.0f;
+    sample.progress       = static_cast<double>(chunk.progress[slot]) / PROGRESS_ONE;
+    sample.position       = glm::vec2(static_cast<float>(chunk.xCm[slot] / kCentimetresPerUnit),
+                                      static_cast<float>(chunk.yCm[slot] / kCentimetresPerUnit));
+    sample.speed          = chunk.speedCentiKph[slot] / 100.0f;
+    sample.gForceX        = chunk.gForceXMilli[slot] / 1000.0f;
+    sample.gForceY        = chunk.gForceYMilli[slot] / 1000.0f;
+    sample.aceleration    = chunk.accelCenti[slot] / 100.0f;
+    sample.curentPosition = chunk.racePosition[slot];
+    return sample;
+}
+
+float LapSamples::TimeAt(size_t i) const
+{
+    return chunk(i / CHUNK_SAMPLES).timeMs[i % CHUNK_SAMPLES] / 1000.0f;
+}
+
+double LapSamples::ProgressAt(size_t i) const
+{
+    return static_cast<double>(chunk(i / CHUNK_SAMPLES).progress[i % CHUNK_SAMPLES]) / PROGRESS_ONE;
+}
+
+void LapSamples::SetBackRacePosition(int position)
+{
+    if (m_size == 0 || m_spilled)
+        return;
+    const size_t i = m_size - 1;
+    m_chunks[i / CHUNK_SAMPLES].racePosition[i % CHUNK_SAMPLES] = quantize<uint16_t>(position, 1.0);
+}
+
+size_t LapSamples::LowerBound(double progress) const
+{
+    const uint32_t q = quantizeProgress(progress);
+
+    // Chunk: the first whose last sample is not below q
+    const size_t chunks = (m_size + CHUNK_SAMPLES - 1) / CHUNK_SAMPLES;
+    size_t lo = 0, hi = chunks;
+    while (lo < hi)
+    {
+        const size_t mid = (lo + hi) / 2;
+        const size_t last = std::min(m_size - mid * CHUNK_SAMPLES, CHUNK_SAMPLES) - 1;
+        if (chunk(mid).progress[last] < q)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == chunks)
+        return m_size;
+
+    // Sample within that chunk
+    const uint32_t* column = chunk(lo).progress;
+    const size_t count = std::min(m_size - lo * CHUNK_SAMPLES, CHUNK_SAMPLES);
+    const uint32_t* it = std::lower_bound(column, column + count, q);
+    return lo * CHUNK_SAMPLES + static_cast<size_t>(it - column);
+}
+
+double LapSamples::TimeAtProgress(double progress) const
+{
+    if (m_size == 0)
+        return -1.0;
+
+    const size_t i = LowerBound(progress);
+
+    // Beyond the last sample / before the first one
+    if (i == m_size)
+        return TimeAt(m_size - 1);
+    if (i == 0)
+        return TimeAt(0);
+
+    // Linear interpolation between two samples
+    const double p0 = ProgressAt(i - 1), p1 = ProgressAt(i);
+    const double t0 = TimeAt(i - 1), t1 = TimeAt(i);
+    if (p1 <= p0)
+        return t1;
+    const double t = (progress - p0) / (p1 - p0);
+    return t0 + (t1 - t0) * t;
+}
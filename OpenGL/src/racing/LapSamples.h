@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <glm/glm.hpp>
+
+// ============================================================================
+// LAP SAMPLE - one telemetry sample of a lap, decoded
+// ============================================================================
+struct LapInfo
+{
+    float timefromstart = 0.0f;        // Seconds since the lap's start crossing
+    double progress = 0.0;             // Along the lap, 0.0 - 1.0
+    glm::vec2 position{ 0.0f };        // Normalized map coordinates (track origin = 0,0)
+    float gForceX = 0.0f, gForceY = 0.0f;
+    float aceleration = 0.0f, speed = 0.0f;
+    int curentPosition = 0;            // Race position when recorded (0 = unknown)
+};
+
+// ============================================================================
+// LAP SAMPLES - one lap's telemetry, columnar and quantized
+//
+// Samples are recorded at 10 Hz for every lap of every vehicle for the whole
+// session, so they are stored compactly: each field is its own fixed-point
+// column (26 bytes a sample, about half a decoded LapInfo) and the columns
+// live in fixed-size chunks, so appending never moves what is recorded.
+//
+//   time       uint32  milliseconds since the lap's start crossing
+//   progress   uint32  1 / PROGRESS_ONE of a lap
+//   position   int32   centimetres from the track origin, x and y
+//   speed      uint16  0.01 kph
+//   g-force    int16   0.001 g, x and y
+//   accel      int16   0.01
+//   race pos   uint16  position in the standings
+//
+// Readers decode one sample at a time (At, or TimeAt / ProgressAt for a
+// single column); LowerBound and TimeAtProgress binary-search the progress
+// column without decoding anything else. Samples are expected in progress
+// order, as RaceManager records them. g_vehicles_mutex guards it all.
+//
+// A completed lap can be Spill()ed: its chunks move to the memory-mapped
+// session file (LapSpill) and are read from there by the same calls. A
+// spilled lap points into space the next session reuses, so the samples are
+// move-only: nothing can keep a copy of that pointer past ResetSession.
+// ============================================================================
+class LapSamples
+{
+public:
+    static constexpr size_t   CHUNK_SAMPLES = 256;         // 25.6 s at 10 Hz
+    static constexpr uint32_t PROGRESS_ONE = 1u << 30;     // Progress 1.0
+
+    LapSamples() = default;
+    LapSamples(const LapSamples&) = delete;
+    LapSamples& operator=(const LapSamples&) = delete;
+    LapSamples(LapSamples&& other) noexcept { *this = std::move(other); }
+    LapSamples& operator=(LapSamples&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+        m_chunks = std::move(other.m_chunks);
+        m_spilled = other.m_spilled;
+        m_size = other.m_size;
+        other.m_chunks.clear();
+        other.m_spilled = nullptr;
+        other.m_size = 0;
+        return *this;
+    }
+
+    // Not after Spill(): a spilled lap is complete
+    void Append(const LapInfo& sample);
+    void Clear();
+
+    // Move the chunks to the session file and free them; false (and still in
+    // RAM) if there is no session file
+    bool Spill();
+    bool IsSpilled() const { return m_spilled != nullptr; }
+
+    size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+
+    // Decoded sample i (< Size())
+    LapInfo At(size_t i) const;
+    LapInfo Back() const { return At(m_size - 1); }
+
+    // Single columns of sample i (< Size())
+    float TimeAt(size_t i) const;
+    double ProgressAt(size_t i) const;
+
+    // Race position of the latest sample, known only after the standings sort
+    void SetBackRacePosition(int position);
+
+    // First sample whose progress is not below `progress`; Size() if none
+    size_t LowerBound(double progress) const;
+
+    // Lap time (seconds) at `progress`, interpolated between the bracketing
+    // samples and clamped to the first / last one; -1 if there are none
+    double TimeAtProgress(double progress) const;
+
+    // Bytes of heap held by the sample columns (0 once spilled)
+    size_t MemoryBytes() const { return m_chunks.size() * sizeof(Chunk); }
+
+private:
+    struct Chunk
+    {
+        uint32_t timeMs[CHUNK_SAMPLES];
+        uint32_t progress[CHUNK_SAMPLES];
+        int32_t  xCm[CHUNK_SAMPLES];
+        int32_t  yCm[CHUNK_SAMPLES];
+        uint16_t speedCentiKph[CHUNK_SAMPLES];
+        int16_t  gForceXMilli[CHUNK_SAMPLES];
+        int16_t  gForceYMilli[CHUNK_SAMPLES];
+        int16_t  accelCenti[CHUNK_SAMPLES];
+        uint16_t racePosition[CHUNK_SAMPLES];
+    };
+
+    const Chunk& chunk(size_t k) const { return m_spilled ? m_spilled[k] : m_chunks[k]; }
+
+    std::deque<Chunk> m_chunks;        // Deque: appending never relocates a chunk
+    const Chunk* m_spilled = nullptr;  // In the session file, contiguous, instead of m_chunks
+    size_t m_size = 0;
+};
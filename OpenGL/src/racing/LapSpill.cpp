@@ -0,0 +1,330 @@
+#include "LapSpill.h"
+#include "../core/Log.h"
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// SESSION FILE
+// ============================================================================
+namespace
+{
+    constexpr size_t kAlign = 64;
+    constexpr size_t kMappedAhead = 2;   // Segments mapped from the one being filled on
+
+    class SessionFile
+    {
+    public:
+        ~SessionFile()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            if (m_thread.joinable())
+                m_thread.join();
+
+            for (uint8_t* base : m_segments)
+                unmapSegment(base);
+            closeFile();
+        }
+
+        // Called from the UI thread, never under g_vehicles_mutex: creating
+        // the file and mapping the first segments can block on the disk
+        void Open()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_opened)
+                    return;
+                m_opened = true;
+            }
+
+            if (!openFile())
+            {
+                LOG_WARN(Race, "[LAP SPILL] Could not create the session file; completed laps stay in memory");
+                return;
+            }
+
+            // The segment being filled and the one after it; the writer
+            // thread keeps mapping ahead from there
+            std::vector<uint8_t*> mapped;
+            for (size_t index = 0; index < kMappedAhead; ++index)
+            {
+                uint8_t* base = mapSegment(index);
+                if (!base)
+                    break;
+                mapped.push_back(base);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_segments = std::move(mapped);
+                m_fileOk = true;
+            }
+            m_thread = std::thread(&SessionFile::writerLoop, this);
+        }
+
+        // Only hands out space that is already mapped: it runs on the ingest
+        // thread under g_vehicles_mutex and must not touch the file itself
+        uint8_t* Reserve(size_t bytes)
+        {
+            bytes = (bytes + kAlign - 1) & ~(kAlign - 1);
+            if (bytes == 0 || bytes > LapSpill::SEGMENT_BYTES)
+                return nullptr;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_fileOk)
+                return nullptr;
+
+            size_t segment = m_segment;
+            size_t offset = m_offset;
+            if (offset + bytes > LapSpill::SEGMENT_BYTES)
+            {
+                ++segment;
+                offset = 0;
+            }
+
+            if (segment >= m_segments.size())
+            {
+                // Not mapped yet (or mapping failed): the lap stays in RAM
+                // for now and the writer thread maps, or retries, meanwhile
+                m_mapFailed = false;
+                lock.unlock();
+                m_wake.notify_one();
+                return nullptr;
+            }
+
+            if (segment != m_segment)
+            {
+                m_flush.push_back(m_segment);
+                m_segment = segment;
+            }
+
+            uint8_t* out = m_segments[segment] + offset;
+            m_offset = offset + bytes;
+            m_used += bytes;
+            lock.unlock();
+            m_wake.notify_one();
+            return out;
+        }
+
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_segment = 0;
+            m_offset = 0;
+            m_used = 0;
+            m_flush.clear();
+        }
+
+        size_t Used()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_used;
+        }
+
+    private:
+        // ====================================================================
+        // WRITER THREAD: keep one segment mapped ahead, write back full ones
+        // ====================================================================
+        void writerLoop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_stop)
+            {
+                if (!m_flush.empty())
+                {
+                    const size_t index = m_flush.back();
+                    m_flush.pop_back();
+                    uint8_t* base = m_segments[index];
+                    lock.unlock();
+                    flushSegment(base);
+                    lock.lock();
+                    continue;
+                }
+                if (!m_mapFailed && m_segments.size() < m_segment + kMappedAhead)
+                {
+                    // Mapping only touches the file and the new segment;
+                    // writers keep reserving in the current one meanwhile.
+                    // This thread is the only one appending to m_segments.
+                    const size_t index = m_segments.size();
+                    lock.unlock();
+                    uint8_t* base = mapSegment(index);
+                    lock.lock();
+                    if (base)
+                        m_segments.push_back(base);
+                    else
+                        m_mapFailed = true;   // Until a Reserve() runs short again
+                    continue;
+                }
+                m_wake.wait(lock);
+            }
+        }
+
+        // ====================================================================
+        // PLATFORM
+        // ====================================================================
+#if defined(_WIN32)
+        bool openFile()
+        {
+            std::error_code ec;
+            const std::filesystem::path path = std::filesystem::temp_directory_path(ec) /
+                ("boni_laps_" + std::to_string(GetCurrentProcessId()) + ".bin");
+            if (ec)
+                return false;
+            m_file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                                 FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+            return m_file != INVALID_HANDLE_VALUE;
+        }
+
+        void closeFile()
+        {
+            if (m_file != INVALID_HANDLE_VALUE)
+                CloseHandle(m_file);
+        }
+
+        uint8_t* mapSegment(size_t index)
+        {
+            std::lock_guard<std::mutex> lock(m_fileMutex);
+            const uint64_t offset = uint64_t(index) * LapSpill::SEGMENT_BYTES;
+            const uint64_t end = offset + LapSpill::SEGMENT_BYTES;
+
+            // Sizing the mapping past the end of the file grows the file
+            HANDLE mapping = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE,
+                                                DWORD(end >> 32), DWORD(end & 0xFFFFFFFFu), nullptr);
+            if (!mapping)
+                return nullptr;
+            void* view = MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE,
+                                       DWORD(offset >> 32), DWORD(offset & 0xFFFFFFFFu),
+                                       LapSpill::SEGMENT_BYTES);
+            CloseHandle(mapping);   // The view keeps the mapping alive
+            return static_cast<uint8_t*>(view);
+        }
+
+        void unmapSegment(uint8_t* base)
+        {
+            UnmapViewOfFile(base);
+        }
+
+        void flushSegment(uint8_t* base)
+        {
+            FlushViewOfFile(base, LapSpill::SEGMENT_BYTES);
+        }
+
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+#else
+        bool openFile()
+        {
+            std::error_code ec;
+            std::string path = (std::filesystem::temp_directory_path(ec) / "boni_laps_XXXXXX").string();
+            if (ec)
+                return false;
+            m_fd = mkstemp(path.data());
+            if (m_fd < 0)
+                return false;
+            unlink(path.c_str());   // Deleted once closed
+            return true;
+        }
+
+        void closeFile()
+        {
+            if (m_fd >= 0)
+                close(m_fd);
+        }
+
+        uint8_t* mapSegment(size_t index)
+        {
+            std::lock_guard<std::mutex> lock(m_fileMutex);
+            const off_t offset = off_t(index) * off_t(LapSpill::SEGMENT_BYTES);
+            const off_t end = offset + off_t(LapSpill::SEGMENT_BYTES);
+
+            // Only ever grow: a late map of an earlier segment must not cut
+            // off one that is already mapped
+            if (end > m_fileBytes)
+            {
+                if (ftruncate(m_fd, end) != 0)
+                    return nullptr;
+                m_fileBytes = end;
+            }
+            void* view = mmap(nullptr, LapSpill::SEGMENT_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, offset);
+            return (view == MAP_FAILED) ? nullptr : static_cast<uint8_t*>(view);
+        }
+
+        void unmapSegment(uint8_t* base)
+        {
+            munmap(base, LapSpill::SEGMENT_BYTES);
+        }
+
+        void flushSegment(uint8_t* base)
+        {
+            msync(base, LapSpill::SEGMENT_BYTES, MS_ASYNC);
+        }
+
+        int m_fd = -1;
+        off_t m_fileBytes = 0;               // Guarded by m_fileMutex
+#endif
+
+        std::mutex m_mutex;                  // Everything below
+        std::mutex m_fileMutex;              // Growing / mapping the file
+        std::condition_variable m_wake;
+        std::thread m_thread;
+        bool m_stop = false;
+        bool m_opened = false;               // Open() ran (whether or not it worked)
+        bool m_fileOk = false;               // File created: Reserve() may hand out space
+        bool m_mapFailed = false;            // Writer stops mapping ahead until asked again
+
+        std::vector<uint8_t*> m_segments;    // Mapped, never unmapped before exit
+        size_t m_segment = 0;                // Being filled
+        size_t m_offset = 0;                 // Into it
+        size_t m_used = 0;
+        std::vector<size_t> m_flush;         // Filled segments to write back
+    };
+
+    SessionFile& sessionFile()
+    {
+        static SessionFile s_file;
+        return s_file;
+    }
+}
+
+namespace LapSpill
+{
+    void Open()
+    {
+        sessionFile().Open();
+    }
+
+    uint8_t* Reserve(size_t bytes)
+    {
+        return sessionFile().Reserve(bytes);
+    }
+
+    void Reset()
+    {
+        sessionFile().Reset();
+    }
+
+    size_t SpilledBytes()
+    {
+        return sessionFile().Used();
+    }
+}
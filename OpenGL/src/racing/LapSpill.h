@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// LAP SPILL - append-only, memory-mapped session file for completed laps
+//
+// Once a lap is completed its telemetry is only read again by the delta to
+// the best lap and by analysis, so RaceManager moves every completed lap
+// except the vehicle's best out of the heap and into this file (see
+// LapSamples::Spill). What stays in RAM per vehicle is then the current lap
+// and the best one, whatever the length of the session; a spilled lap is
+// read straight from the mapping, and the pages of laps that are being looked
+// at stay resident in the OS page cache like any recently used file.
+//
+// The file lives in the temp directory and is deleted when it is closed. It
+// grows in SEGMENT_BYTES segments, each mapped once and kept mapped until
+// exit, so a pointer handed out by Reserve() stays valid for the whole
+// process. Open() creates it and maps the first segments when a session
+// starts; from then on a background thread maps the next segment ahead of
+// the writers and starts write-back of the filled ones. Reserve() runs under
+// g_vehicles_mutex and never touches the file: it only hands out space that
+// is already mapped, a few instructions under its own mutex.
+// ============================================================================
+namespace LapSpill
+{
+    constexpr size_t SEGMENT_BYTES = size_t(64) << 20;
+
+    // Create and map the session file; later calls do nothing. Called by
+    // ResetSession outside g_vehicles_mutex, as it may block on the disk.
+    void Open();
+
+    // Room for `bytes` (at most SEGMENT_BYTES) in the session file, to be
+    // filled right away by the caller. 64-byte aligned. nullptr if the file
+    // is not open or the writer thread has not mapped the space yet: the
+    // caller keeps its data in RAM and may try again later.
+    uint8_t* Reserve(size_t bytes);
+
+    // New session: rewind to the start of the file, so the next Reserve()
+    // hands out space that earlier laps may still point into. Only call it
+    // once every spilled lap has been released: RaceManager::ResetLapHistory
+    // clears every vehicle's laps first, under g_vehicles_mutex.
+    void Reset();
+
+    // Bytes reserved since the last Reset()
+    size_t SpilledBytes();
+}
@@ -0,0 +1,106 @@
+#include "LapTimer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    double cross(const glm::dvec2& a, const glm::dvec2& b)
+    {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    // Where along prev->cur the path meets the segment p1->p2 (0..1), or -1
+    double segmentCrossing(const glm::dvec2& prev, const glm::dvec2& cur,
+                           const glm::dvec2& p1, const glm::dvec2& p2)
+    {
+        const glm::dvec2 v = cur - prev;
+        const glm::dvec2 s = p2 - p1;
+        const double denominator = cross(v, s);
+        if (std::abs(denominator) < 1e-12) {
+            return -1.0;  // Parallel or not moving
+        }
+        const glm::dvec2 delta = p1 - prev;
+        const double t = cross(delta, s) / denominator;   // Along the vehicle path
+        const double u = cross(delta, v) / denominator;   // Along the line
+        return (t >= 0.0 && t <= 1.0 && u >= 0.0 && u <= 1.0) ? t : -1.0;
+    }
+}
+
+LapTimer::Crossing LapTimer::OnFix(const Fix& fix, const Line& line)
+{
+    Crossing result;
+    if (!m_hasFix) {
+        m_hasFix = true;
+        m_last = fix;
+        m_lapStartUs = fix.timeUs;
+        return result;
+    }
+    if (fix.timeUs < m_last.timeUs) {
+        return result;  // Out of order: the pair it belongs to is already past
+    }
+
+    const glm::dvec2 prev(m_last.x, m_last.y);
+    const glm::dvec2 cur(fix.x, fix.y);
+
+    // Direction (+1 forward, -1 backward) and position (0..1) of a crossing
+    // between the two fixes
+    int direction = 0;
+    double ratio = 0.0;
+    const double t = segmentCrossing(prev, cur, line.p1, line.p2);
+    if (t >= 0.0) {
+        const double side = cross(line.p2 - line.p1, cur - prev);
+        const double reference = (line.forward != glm::dvec2(0.0))
+            ? cross(line.p2 - line.p1, line.forward)
+            : m_learnedDirection;
+        if (reference == 0.0) {
+            m_learnedDirection = side;  // No track direction: the first crossing defines it
+            direction = 1;
+        } else {
+            direction = (side * reference > 0.0) ? 1 : -1;
+        }
+        ratio = t;
+    } else if (fix.progressWrap && m_last.progress > 0.85 && fix.progress < 0.15) {
+        direction = 1;
+        ratio = (1.0 - m_last.progress) / (1.0 - m_last.progress + fix.progress);
+    } else if (fix.progressWrap && m_last.progress < 0.15 && fix.progress > 0.85) {
+        direction = -1;
+    }
+
+    const int64_t crossingUs = m_last.timeUs +
+        static_cast<int64_t>(std::llround(ratio * static_cast<double>(fix.timeUs - m_last.timeUs)));
+    m_last = fix;
+
+    if (direction < 0) {
+        ++m_behind;
+        return result;
+    }
+    if (direction == 0) {
+        return result;
+    }
+    if (m_behind > 0) {
+        --m_behind;  // Back over the line it reversed across
+        return result;
+    }
+    if (m_hasCrossed && crossingUs - m_lastCrossingUs < MIN_LAP_US) {
+        return result;
+    }
+
+    result.crossed = true;
+    result.timeUs = crossingUs;
+    result.lapUs = crossingUs - m_lapStartUs;
+    result.first = !m_hasCrossed;
+    m_hasCrossed = true;
+    m_lastCrossingUs = crossingUs;
+    m_lapStartUs = crossingUs;
+    return result;
+}
+
+int64_t LapTimer::ElapsedUs(int64_t timeUs) const
+{
+    return m_hasFix ? std::max<int64_t>(0, timeUs - m_lapStartUs) : 0;
+}
+
+void LapTimer::Reset()
+{
+    *this = LapTimer{};
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// ============================================================================
+// LAP TIMER - start/finish crossings of one vehicle, event-driven
+//
+// Fed every position fix as it is ingested (not once per rendered frame), so
+// no pair of consecutive fixes goes unchecked however the render loop runs.
+// A crossing is placed between the two fixes that bracket it, proportionally
+// to where the path meets the line, on the fixes' own timestamps — integer
+// microseconds on the interpolation clock. Lap times are differences of
+// crossing times, so they do not depend on frame rate or V-Sync.
+//
+// Jitter around the line: a fix pair crossing backwards is remembered and the
+// next forward crossing only cancels it, and a forward crossing within
+// MIN_LAP_US of the last one is the same passage seen twice (line and
+// progress wrap on different fixes). Neither counts as a lap.
+//
+// Pure and deterministic; the owner serializes access (g_vehicles_mutex).
+// ============================================================================
+class LapTimer
+{
+public:
+    struct Line {
+        glm::dvec2 p1{ 0.0 };
+        glm::dvec2 p2{ 0.0 };
+        glm::dvec2 forward{ 0.0 };   // Direction of travel; zero: first crossing decides
+    };
+
+    struct Fix {
+        int64_t timeUs = 0;
+        double x = 0.0, y = 0.0;     // Same space as the line
+        double progress = 0.0;       // 0..1 along the track
+        bool progressWrap = false;   // 0.85+ -> 0.15- also counts (low-rate GNSS)
+    };
+
+    struct Crossing {
+        bool crossed = false;
+        int64_t timeUs = 0;          // Interpolated between the bracketing fixes
+        int64_t lapUs = 0;           // Since the previous crossing (or the first fix)
+        bool first = false;          // No crossing before: lapUs is since the first fix
+    };
+
+    Crossing OnFix(const Fix& fix, const Line& line);
+
+    // Lap in progress at `timeUs` (0 before the first fix)
+    int64_t ElapsedUs(int64_t timeUs) const;
+    int64_t LapStartUs() const { return m_lapStartUs; }
+    bool HasFix() const { return m_hasFix; }
+
+    void Reset();
+
+    static constexpr int64_t MIN_LAP_US = 2'000'000;
+
+private:
+    bool m_hasFix = false;
+    Fix m_last;
+    int64_t m_lapStartUs = 0;
+    bool m_hasCrossed = false;
+    int64_t m_lastCrossingUs = 0;
+    int m_behind = 0;                // Backward crossings not yet undone
+    double m_learnedDirection = 0.0; // +1 / -1 once a line without `forward` was crossed
+};
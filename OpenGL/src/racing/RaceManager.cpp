@@ -1,9 +1,13 @@
 ﻿#include "RaceManager.h"
+#include "RaceSnapshot.h"
+#include "SessionStats.h"
 #include "../vehicle/Vehicle.h"
+#include "../vehicle/VehicleInterpolator.h"
 #include "../rendering/Interpolation.h"
 #include "../Config.h"
 #include "TimeDiffirence/TimeDiff.h"
-#include <iostream>
+#include "../track/TrackGeometry.h"
+#include "../core/Log.h"
 #include <fstream>
 #include <iomanip>
 #include <filesystem>
@@ -32,12 +36,12 @@ RaceManager::RaceManager()
     , m_startFinishP1(0.0f, 0.0f)
     , m_startFinishP2(0.0f, 0.0f)
 {
-    std::cout << "[RACE MANAGER] Initialized" << std::endl;
+    LOG_INFO(Race, "[RACE MANAGER] Initialized");
 }
 
 RaceManager::~RaceManager()
 {
-    std::cout << "[RACE MANAGER] Destroyed" << std::endl;
+    LOG_INFO(Race, "[RACE MANAGER] Destroyed");
 }
 
 // ============================================================================
@@ -49,9 +53,12 @@ void RaceManager::SetStartFinishLine(const glm::vec2& p1, const glm::vec2& p2)
     m_startFinishP2 = p2;
     m_lineInitialized = true;
 
-    std::cout << "[RACE MANAGER] Start/Finish line set: "
+    // Publish alongside the track so ingest-side consumers see the same line.
+    TrackGeometry::PublishStartFinish(p1, p2);
+
+    LOG_INFO(Race, "[RACE MANAGER] Start/Finish line set: "
               << "P1(" << p1.x << ", " << p1.y << ") -> "
-              << "P2(" << p2.x << ", " << p2.y << ")" << std::endl;
+              << "P2(" << p2.x << ", " << p2.y << ")");
 }
 
 // ============================================================================
@@ -74,9 +81,11 @@ float RaceManager::GetAutoStopSeconds() const
 }
 
 // ============================================================================
-// CORE UPDATE LOOP - Reads/writes Vehicle data directly under mutex
+// CORE UPDATE LOOP - session bookkeeping and display, once per frame
+// Lap timing itself happens per fix in OnPositionFix; nothing here depends on
+// the frame's delta time.
 // ============================================================================
-void RaceManager::Update(float deltaTime)
+void RaceManager::Update()
 {
     if (!g_is_map_loaded || !m_lineInitialized)
         return;
@@ -91,6 +100,7 @@ void RaceManager::Update(float deltaTime)
 
         if (m_autoStopMaxLaps > 0)
         {
+            std::lock_guard<std::mutex> lock(g_vehicles_mutex);
             for (const auto& [id, veh] : g_vehicles)
             {
                 if (veh.m_completed_laps >= m_autoStopMaxLaps)
@@ -109,254 +119,16 @@ void RaceManager::Update(float deltaTime)
 
     std::lock_guard<std::mutex> lock(g_vehicles_mutex);
 
+    // ====================================================================
+    // RUNNING LAP TIMERS (display only: the clock minus the lap's start
+    // crossing, so they keep counting between fixes)
+    // ====================================================================
+    const int64_t nowUs = static_cast<int64_t>(std::llround(VehicleInterpolator::GetTime() * 1e6));
     for (auto& [vehicleID, vehicle] : g_vehicles)
     {
-        constexpr bool kDebugFinishCrossing = true;
-        // ====================================================================
-        // TELEMETRY RECORDING (every frame during active lap)
-        // Records vehicle state for TimeDiff calculations.
-        // IMPORTANT: On clients, vehicles can be authoritative (replicated)
-        // and we still need to record samples, otherwise TimeDiff can't work.
-        // ====================================================================
-        if (vehicle.m_has_started_first_lap && !vehicle.m_is_finished)
-        {
-            constexpr float kTelemetrySampleInterval = 0.1f; // 10 Hz
-            constexpr size_t kMaxSamplesPerLap = 36000;       // 1 hour cap per lap
-            vehicle.m_telemetry_sample_timer += deltaTime;
-
-            if (vehicle.m_telemetry_sample_timer >= kTelemetrySampleInterval)
-            {
-                vehicle.m_telemetry_sample_timer = 0.0f;
-
-                LapInfo sample;
-                sample.timefromstart = vehicle.m_current_lap_timer;
-                sample.progress = vehicle.m_track_progress;
-                sample.timestamp = std::chrono::steady_clock::now();
-                sample.total_progress = vehicle.m_total_progress;
-                sample.gForceX = static_cast<float>(vehicle.m_g_force_x);
-                sample.gForceY = static_cast<float>(vehicle.m_g_force_y);
-                sample.aceleration = static_cast<float>(vehicle.m_acceleration);
-                sample.speed = static_cast<float>(vehicle.m_speed_kph);
-                sample.curentPosition = 0; // Updated after standings sort
-
-                if (vehicle.laps.find(vehicle.m_current_lap_number) == vehicle.laps.end())
-                {
-                    vehicle.laps[vehicle.m_current_lap_number] = CarLapSessions();
-                    vehicle.laps[vehicle.m_current_lap_number].lapnumber = vehicle.m_current_lap_number;
-                }
-                auto& currentLapSamples = vehicle.laps[vehicle.m_current_lap_number].samples;
-                if (currentLapSamples.size() < kMaxSamplesPerLap)
-                    currentLapSamples.push_back(sample);
-            }
-        }
-
-        // Vehicles driven by processed server state already have authoritative
-        // lap/progress/timing values. Do not advance them locally on the client.
-        if (vehicle.m_has_authoritative_state)
-        {
-            // Client-side: do not advance timing/lap counters locally.
-            // Still keep derived fields consistent for standings/time-diff.
-            // If server provides a valid best lap time, keep it visible in UI.
-            if (vehicle.m_best_lap_time >= 0.0f)
-            {
-                // Best lap ID is used by TimeDiff; if it is unset, point it to the
-                // latest completed lap (bestlap time itself is authoritative).
-                if (vehicle.bestlapID < RaceConstants::LAP_START_NUMBER)
-                {
-                    const int candidate = vehicle.m_current_lap_number - 1;
-                    if (candidate >= RaceConstants::LAP_START_NUMBER)
-                        vehicle.bestlapID = candidate;
-                }
-            }
-
-            vehicle.m_total_progress = vehicle.m_completed_laps + vehicle.m_track_progress;
-            continue;
-        }
-        
-        // Check for start/finish crossing.
-        // Use strict segment intersection for correctness. Progress-cycle fallback below
-        // handles low-rate updates on closed tracks.
-        const glm::vec2 prevPos(vehicle.m_prev_x, vehicle.m_prev_y);
-        const glm::vec2 curPos(vehicle.m_normalized_x, vehicle.m_normalized_y);
-
-        const glm::vec2 sfP1 = m_startFinishP1;
-        const glm::vec2 sfP2 = m_startFinishP2;
-
-        float intersectionRatio = 0.0f;
-        const bool crossed = CheckLineSegmentIntersection(prevPos, curPos, sfP1, sfP2, intersectionRatio);
-        
-        // Check for progress cycle (0.999 -> 0.001)
-        // Use this only for real GNSS telemetry (jitter/low-rate updates). Simulation and
-        // other non-GNSS sources should rely on strict line intersection to avoid false laps.
-        const bool isNonGnssSource = (vehicle.m_fix_type < 2);
-        bool progressCycled = false;
-        if (!isNonGnssSource)
-        {
-            progressCycled = (vehicle.m_prev_track_progress > 0.85 &&
-                              vehicle.m_track_progress < 0.15);
-        }
-        
-        // ====================================================================
-        // LAP COMPLETION DETECTION
-        // ====================================================================
-        if (kDebugFinishCrossing && (crossed || progressCycled))
-        {
-            const glm::vec2 off = getTrackRenderOffset();
-            std::cout.setf(std::ios::fixed);
-            std::cout << "[S/F DEBUG] veh#" << vehicleID
-                      << " sessionState=" << static_cast<int>(m_sessionState)
-                      << " finished=" << (vehicle.m_is_finished ? 1 : 0)
-                      << " crossed=" << (crossed ? 1 : 0)
-                      << " ratio=" << std::setprecision(3) << intersectionRatio
-                      << std::endl;
-        }
-
-        if (m_sessionState == SessionState::Idle)
-        {
-            // Just riding, reset timer if crossed but don't record laps.
-            if (crossed || progressCycled) {
-                vehicle.m_current_lap_timer = deltaTime * (1.0f - intersectionRatio);
-            } else {
-                vehicle.m_current_lap_timer += deltaTime;
-            }
-            vehicle.m_total_progress = vehicle.m_completed_laps + vehicle.m_track_progress;
+        if (vehicle.m_has_authoritative_state || vehicle.m_is_finished || !vehicle.m_lap_timer.HasFix())
             continue;
-        }
-
-        if (vehicle.m_is_finished)
-        {
-            // Just driving after finishing. Ignore laps.
-            vehicle.m_total_progress = vehicle.m_completed_laps + vehicle.m_track_progress;
-            continue;
-        }
-
-        if (vehicle.m_has_started_first_lap && (crossed || progressCycled))
-        {
-            // Sub-frame accurate timing
-            float crossingTime = vehicle.m_current_lap_timer + (deltaTime * intersectionRatio);
-
-            const float MIN_VALID_LAP_TIME = 0.1f;
-
-            if (crossingTime > MIN_VALID_LAP_TIME)
-            {
-                // ----------------------------------------------------------------
-                // In Finishing state, enforce correct finishing order:
-                //   1) The stored leader must finish first.
-                //   2) Same-lap cars may finish only after the leader has crossed.
-                //   3) Lapped cars may finish only after ALL same-lap cars are done.
-                // If a car is not yet allowed to finish, skip recording this
-                // crossing entirely — the timer resets below and it tries again.
-                // ----------------------------------------------------------------
-                bool processLap = true;
-                if (m_sessionState == SessionState::Finishing)
-                {
-                    const bool isTheLeader       = (vehicleID == m_leaderAtStop);
-                    const bool leaderHasFinished = (m_leaderAtStop >= 0 &&
-                                                    m_finishPositions.count(m_leaderAtStop) > 0);
-                    // completed_laps not yet incremented here — compare against stored baseline
-                    const bool isLeadLapCar      = (vehicle.m_completed_laps >= m_leaderLapsAtStop);
-                    const bool allLeadLapFinished = (static_cast<int>(m_finishPositions.size()) >= m_leadLapCarCount);
-
-                    processLap = (isTheLeader ||
-                                  (isLeadLapCar  && leaderHasFinished) ||
-                                  (!isLeadLapCar && allLeadLapFinished));
-                }
-
-                if (processLap)
-                {
-                    // Store completed lap
-                    LapData lapData(crossingTime, 0);
-                    vehicle.m_laps[vehicle.m_current_lap_number] = lapData;
-                    vehicle.m_completed_laps++;
-
-                    // Update best lap time and ID
-                    if (crossingTime < vehicle.m_best_lap_time || vehicle.m_best_lap_time < 0.0f)
-                    {
-                        vehicle.m_best_lap_time = crossingTime;
-                        vehicle.bestlapID = vehicle.m_current_lap_number;
-                    }
-
-                    std::cout << "[RACE MANAGER] Vehicle #" << vehicleID
-                              << " completed Lap " << vehicle.m_current_lap_number
-                              << " in " << std::fixed << std::setprecision(3) << crossingTime << "s"
-                              << " | Total completed: " << vehicle.m_completed_laps << std::endl;
-
-                    if (m_sessionState == SessionState::Finishing)
-                    {
-                        vehicle.m_is_finished = true;
-                        if (m_finishPositions.find(vehicleID) == m_finishPositions.end())
-                            m_finishPositions[vehicleID] = static_cast<int>(m_finishPositions.size() + 1);
-                        vehicle.m_current_lap_timer = 0.0f;
-                        std::cout << "[RACE MANAGER] Vehicle #" << vehicleID
-                                  << " HAS FINISHED! pos=" << m_finishPositions[vehicleID] << std::endl;
-                    }
-                    else
-                    {
-                        vehicle.m_current_lap_number++;
-                    }
-                }
-                // else: car not yet allowed to finish — timer resets below, it retries next crossing
-            }
-
-            // Reset timer after crossing (applies even when processLap==false)
-            vehicle.m_current_lap_timer = deltaTime * (1.0f - intersectionRatio);
-        }
-        // ====================================================================
-        // FIRST LAP START DETECTION
-        // ====================================================================
-        else if (!vehicle.m_has_started_first_lap && crossed)
-        {
-            // Prevent false start on vehicle creation
-            float timeSinceCreation = vehicle.m_current_lap_timer;
-            
-            if (timeSinceCreation > 0.5f)
-            {
-                if (kDebugFinishCrossing)
-                {
-                    const glm::vec2 off = getTrackRenderOffset();
-                    std::cout.setf(std::ios::fixed);
-                    std::cout << "[S/F DEBUG] START veh#" << vehicleID
-                              << " fixType=" << vehicle.m_fix_type
-                              << " ratio=" << std::setprecision(3) << intersectionRatio
-                              << " prevPos=(" << std::setprecision(6) << prevPos.x << "," << prevPos.y << ")"
-                              << " curPos=(" << curPos.x << "," << curPos.y << ")"
-                              << " sfP1=(" << sfP1.x << "," << sfP1.y << ")"
-                              << " sfP2=(" << sfP2.x << "," << sfP2.y << ")"
-                              << " off=(" << off.x << "," << off.y << ")"
-                              << " prevProg=" << std::setprecision(3) << vehicle.m_prev_track_progress
-                              << " curProg=" << vehicle.m_track_progress
-                              << " lapT=" << vehicle.m_current_lap_timer
-                              << std::endl;
-                }
-
-                vehicle.m_has_started_first_lap = true;
-                vehicle.m_current_lap_timer = deltaTime * (1.0f - intersectionRatio);
-                vehicle.m_prev_track_progress = vehicle.m_track_progress;
-                
-                std::cout << "[RACE MANAGER] Vehicle #" << vehicleID 
-                          << " crossed start/finish line, starting Lap " << vehicle.m_current_lap_number 
-                          << std::endl;
-            }
-            else
-            {
-                vehicle.m_current_lap_timer += deltaTime;
-            }
-        }
-        // ====================================================================
-        // NORMAL TIMER INCREMENT
-        // ====================================================================
-        else
-        {
-            vehicle.m_current_lap_timer += deltaTime;
-        }
-
-        // ====================================================================
-        // UPDATE TOTAL PROGRESS (lap number + current lap progress)
-        // This is essential for CalculateLeaderTimeDiffInternal to work
-        // Total progress allows comparing vehicles on different laps
-        // Example: Lap 2, progress 0.35 -> total_progress = 2.35
-        // ====================================================================
-        vehicle.m_total_progress = vehicle.m_completed_laps + vehicle.m_track_progress;
+        vehicle.m_current_lap_timer = static_cast<float>(vehicle.m_lap_timer.ElapsedUs(nowUs) / 1e6);
     }
 
     // Check if everyone finished
@@ -377,12 +149,13 @@ void RaceManager::Update(float deltaTime)
                 m_raceElapsedSeconds = elapsed.count();
                 m_raceTimerRunning = false;
             }
-            std::cout << "[SESSION] Session Ended! All cars have finished." << std::endl;
+            LOG_INFO(Race, "[SESSION] Session Ended! All cars have finished.");
         }
     }
 
     // Update leader and positions
-    std::vector<VehicleStanding> standings = GetStandingsInternal();
+    RefreshStandingsInternal();
+    const std::vector<VehicleStanding>& standings = m_standings;
     
     // ====================================================================
     // UPDATE CURRENT POSITION IN TELEMETRY SAMPLES
@@ -396,9 +169,9 @@ void RaceManager::Update(float deltaTime)
             if (vehicle.m_has_started_first_lap && !vehicle.laps.empty())
             {
                 auto lap_it = vehicle.laps.find(vehicle.m_current_lap_number);
-                if (lap_it != vehicle.laps.end() && !lap_it->second.samples.empty())
+                if (lap_it != vehicle.laps.end() && !lap_it->second.samples.Empty())
                 {
-                    lap_it->second.samples.back().curentPosition = static_cast<int>(i + 1);
+                    lap_it->second.samples.SetBackRacePosition(static_cast<int>(i + 1));
                 }
             }
         }
@@ -426,20 +199,18 @@ void RaceManager::Update(float deltaTime)
         // Debug: print leader change
         if (kLogLeaderChanges && currentLeader != previousLeader && previousLeader != -1)
         {
-            std::cout << "\n[LEADER CHANGE] New leader: Vehicle #" << currentLeader 
+            LOG_INFO(Race, "[LEADER CHANGE] New leader: Vehicle #" << currentLeader 
                       << " | Laps: " << standings[0].completedLaps 
                       << " | Progress: " << std::fixed << std::setprecision(3) << standings[0].distanceFromStart
-                      << " (was Vehicle #" << previousLeader << ")" << std::endl;
+                      << " (was Vehicle #" << previousLeader << ")");
             
             size_t topCount = standings.size() < 3 ? standings.size() : 3;
             for (size_t i = 0; i < topCount; ++i)
             {
-                std::cout << "  " << (i+1) << ". Vehicle #" << standings[i].vehicleID 
+                LOG_INFO(Race, "  " << (i+1) << ". Vehicle #" << standings[i].vehicleID 
                           << " | Laps: " << standings[i].completedLaps
-                          << " | Progress: " << std::fixed << std::setprecision(3) << standings[i].distanceFromStart
-                          << std::endl;
+                          << " | Progress: " << std::fixed << std::setprecision(3) << standings[i].distanceFromStart);
             }
-            std::cout << std::endl;
         }
         
         previousLeader = currentLeader;
@@ -447,39 +218,242 @@ void RaceManager::Update(float deltaTime)
 }
 
 // ============================================================================
-// LINE SEGMENT INTERSECTION (2D)
-// Returns true if segments intersect, and outIntersectionRatio (0.0 to 1.0)
-// indicates where along the vehicle's path the intersection occurred.
+// POSITION FIX - lap timing on every fix, ingest thread
 // ============================================================================
-bool RaceManager::CheckLineSegmentIntersection(
-    const glm::vec2& vehiclePrev, const glm::vec2& vehicleCurrent,
-    const glm::vec2& lineP1, const glm::vec2& lineP2,
-    float& outIntersectionRatio) const
+void RaceManager::OnPositionFix(int32_t vehicleID, Vehicle& vehicle, int64_t timeUs,
+                                const TrackGeometry::Snapshot& track)
 {
-    // Vehicle movement vector
-    glm::vec2 v = vehicleCurrent - vehiclePrev;
-    
-    // Start/Finish line vector
-    glm::vec2 s = lineP2 - lineP1;
-    
-    // Check if parallel (cross product near zero)
-    float denominator = (-s.x * v.y) + (v.x * s.y);
-    if (std::abs(denominator) < 1e-6f)
-        return false;  // Parallel or coincident
-    
-    // Calculate parametric intersection points
-    glm::vec2 delta = vehiclePrev - lineP1;
-    float t = ((-s.y * delta.x) + (s.x * delta.y)) / denominator;  // t along vehicle path
-    float u = ((-v.y * delta.x) + (v.x * delta.y)) / denominator;  // u along finish line
-    
-    // Check if intersection is within both segments
-    if (t >= 0.0f && t <= 1.0f && u >= 0.0f && u <= 1.0f)
+    // ====================================================================
+    // TELEMETRY RECORDING (10 Hz of fix time during active lap)
+    // Records vehicle state for TimeDiff calculations.
+    // IMPORTANT: On clients, vehicles can be authoritative (replicated)
+    // and we still need to record samples, otherwise TimeDiff can't work.
+    // ====================================================================
+    if (vehicle.m_has_started_first_lap && !vehicle.m_is_finished)
     {
-        outIntersectionRatio = t;
-        return true;
+        constexpr int64_t kTelemetrySampleIntervalUs = 100'000; // 10 Hz
+        constexpr size_t kMaxSamplesPerLap = 36000;              // 1 hour cap per lap
+
+        if (timeUs - vehicle.m_last_sample_us >= kTelemetrySampleIntervalUs)
+        {
+            vehicle.m_last_sample_us = timeUs;
+
+            LapInfo sample;
+            sample.timefromstart = vehicle.m_has_authoritative_state
+                ? vehicle.m_current_lap_timer
+                : static_cast<float>(vehicle.m_lap_timer.ElapsedUs(timeUs) / 1e6);
+            sample.progress = vehicle.m_track_progress;
+            sample.position = glm::vec2(static_cast<float>(vehicle.m_normalized_x),
+                                        static_cast<float>(vehicle.m_normalized_y));
+            sample.gForceX = static_cast<float>(vehicle.m_g_force_x);
+            sample.gForceY = static_cast<float>(vehicle.m_g_force_y);
+            sample.aceleration = static_cast<float>(vehicle.m_acceleration);
+            sample.speed = static_cast<float>(vehicle.m_speed_kph);
+            sample.curentPosition = 0; // Updated after standings sort
+
+            if (vehicle.laps.find(vehicle.m_current_lap_number) == vehicle.laps.end())
+            {
+                vehicle.laps[vehicle.m_current_lap_number] = CarLapSessions();
+                vehicle.laps[vehicle.m_current_lap_number].lapnumber = vehicle.m_current_lap_number;
+
+                // A new lap: the ones before it are complete. All but the
+                // best (TimeDiff's reference) move to the session file, so
+                // RAM holds two laps per vehicle however long the session runs
+                for (auto& [lapNumber, lap] : vehicle.laps)
+                {
+                    if (lapNumber != vehicle.m_current_lap_number && lapNumber != vehicle.bestlapID &&
+                        !lap.samples.IsSpilled())
+                        lap.samples.Spill();
+                }
+            }
+            auto& currentLapSamples = vehicle.laps[vehicle.m_current_lap_number].samples;
+            if (currentLapSamples.Size() < kMaxSamplesPerLap)
+                currentLapSamples.Append(sample);
+        }
+    }
+
+    // Check for start/finish crossing between this fix and the previous one.
+    // Progress-cycle fallback handles low-rate updates on closed tracks, and
+    // is used only for real GNSS telemetry (jitter/low-rate updates).
+    // Simulation and other non-GNSS sources rely on strict line intersection
+    // to avoid false laps.
+    LapTimer::Fix fix;
+    fix.timeUs = timeUs;
+    fix.x = vehicle.m_normalized_x;
+    fix.y = vehicle.m_normalized_y;
+    fix.progress = vehicle.m_track_progress;
+    fix.progressWrap = (vehicle.m_fix_type >= 2);
+
+    // Vehicles driven by processed server state already have authoritative
+    // lap/progress/timing values. Do not advance them locally on the client.
+    if (vehicle.m_has_authoritative_state)
+    {
+        // Client-side: do not advance timing/lap counters locally.
+        // Still keep derived fields consistent for standings/time-diff.
+        // If server provides a valid best lap time, keep it visible in UI.
+        if (vehicle.m_best_lap_time >= 0.0f)
+        {
+            // Best lap ID is used by TimeDiff; if it is unset, point it to the
+            // latest completed lap (bestlap time itself is authoritative).
+            if (vehicle.bestlapID < RaceConstants::LAP_START_NUMBER)
+            {
+                const int candidate = vehicle.m_current_lap_number - 1;
+                if (candidate >= RaceConstants::LAP_START_NUMBER)
+                    vehicle.bestlapID = candidate;
+            }
+        }
+
+        vehicle.m_total_progress = vehicle.m_completed_laps + vehicle.m_track_progress;
+
+        // Sectors still come from the timing lines; the server's lap number
+        // changing is the start/finish crossing, its lap timer says when
+        if (vehicle.m_has_started_first_lap && !vehicle.m_is_finished)
+        {
+            const int64_t lapStartUs = timeUs - static_cast<int64_t>(std::llround(vehicle.m_current_lap_timer * 1e6));
+            TimingRecord& timing = vehicle.m_timing;
+            if (timing.InLap() && vehicle.m_current_lap_number == timing.LapNumber() + 1)
+            {
+                const int closedLap = timing.LapNumber();
+                if (const TimingRecord::Splits* lap = timing.CloseLap(lapStartUs))
+                    SessionStats::OnLapCompleted(vehicleID, closedLap, *lap);
+            }
+            else if (!timing.InLap() || vehicle.m_current_lap_number != timing.LapNumber())
+                timing.StartLap(vehicle.m_current_lap_number, lapStartUs);
+        }
+        else
+        {
+            vehicle.m_timing.Stop();
+        }
+        if (g_is_map_loaded)
+            vehicle.m_timing.OnFix(fix, vehicle.m_speed_kph, track);
+        return;
+    }
+
+    if (!g_is_map_loaded || !track.hasStartFinish)
+        return;
+
+    // The line is laid across the first centre-line segment; travel along it
+    // is forward.
+    LapTimer::Line line;
+    line.p1 = glm::dvec2(track.startFinishP1);
+    line.p2 = glm::dvec2(track.startFinishP2);
+    if (track.HasTrack())
+        line.forward = glm::dvec2(track.points[1].position - track.points[0].position);
+
+    const LapTimer::Crossing crossing = vehicle.m_lap_timer.OnFix(fix, line);
+
+    vehicle.m_total_progress = vehicle.m_completed_laps + vehicle.m_track_progress;
+    if (!vehicle.m_is_finished)
+        vehicle.m_current_lap_timer = static_cast<float>(vehicle.m_lap_timer.ElapsedUs(timeUs) / 1e6);
+
+    if (crossing.crossed)
+        OnStartFinishCrossing(vehicleID, vehicle, crossing);
+
+    // Sector lines, speed traps and pit lane, in the lap the crossing opened
+    vehicle.m_timing.OnFix(fix, vehicle.m_speed_kph, track);
+}
+
+// ============================================================================
+// START/FINISH CROSSING (from OnPositionFix, g_vehicles_mutex held)
+// ============================================================================
+void RaceManager::OnStartFinishCrossing(int32_t vehicleID, Vehicle& vehicle, const LapTimer::Crossing& crossing)
+{
+    if (m_sessionState == SessionState::Ended)
+        return;
+
+    LOG_DEBUG(Race, std::fixed << "[S/F DEBUG] veh#" << vehicleID
+              << " sessionState=" << static_cast<int>(m_sessionState.load())
+              << " finished=" << (vehicle.m_is_finished ? 1 : 0)
+              << " at=" << crossing.timeUs << "us"
+              << " lap=" << crossing.lapUs << "us");
+
+    // Idle: just riding, the timer restarted at the line but no laps are recorded.
+    // Finished: just driving after finishing, laps are ignored.
+    if (m_sessionState == SessionState::Idle || vehicle.m_is_finished)
+        return;
+
+    // ====================================================================
+    // FIRST LAP START DETECTION
+    // ====================================================================
+    if (!vehicle.m_has_started_first_lap)
+    {
+        // Prevent false start on vehicle creation
+        if (!crossing.first || crossing.lapUs > 500'000)
+        {
+            vehicle.m_has_started_first_lap = true;
+            vehicle.m_prev_track_progress = vehicle.m_track_progress;
+            vehicle.m_timing.StartLap(vehicle.m_current_lap_number, crossing.timeUs);
+
+            LOG_INFO(Race, "[RACE MANAGER] Vehicle #" << vehicleID
+                      << " crossed start/finish line, starting Lap " << vehicle.m_current_lap_number);
+        }
+        return;
+    }
+
+    // ====================================================================
+    // LAP COMPLETION
+    // ----------------------------------------------------------------
+    // In Finishing state, enforce correct finishing order:
+    //   1) The stored leader must finish first.
+    //   2) Same-lap cars may finish only after the leader has crossed.
+    //   3) Lapped cars may finish only after ALL same-lap cars are done.
+    // If a car is not yet allowed to finish, skip recording this
+    // crossing entirely — the lap restarted at the line, it tries again.
+    // ====================================================================
+    if (m_sessionState == SessionState::Finishing)
+    {
+        const bool isTheLeader       = (vehicleID == m_leaderAtStop);
+        const bool leaderHasFinished = (m_leaderAtStop >= 0 &&
+                                        m_finishPositions.count(m_leaderAtStop) > 0);
+        // completed_laps not yet incremented here — compare against stored baseline
+        const bool isLeadLapCar      = (vehicle.m_completed_laps >= m_leaderLapsAtStop);
+        const bool allLeadLapFinished = (static_cast<int>(m_finishPositions.size()) >= m_leadLapCarCount);
+
+        if (!(isTheLeader ||
+              (isLeadLapCar  && leaderHasFinished) ||
+              (!isLeadLapCar && allLeadLapFinished)))
+        {
+            vehicle.m_timing.StartLap(vehicle.m_current_lap_number, crossing.timeUs);
+            return;
+        }
+    }
+
+    // Store completed lap
+    const float lapTime = static_cast<float>(crossing.lapUs / 1e6);
+    LapData lapData(lapTime, 0);
+    lapData.lapTimeUs = crossing.lapUs;
+    vehicle.m_laps[vehicle.m_current_lap_number] = lapData;
+    vehicle.m_completed_laps++;
+    vehicle.m_total_progress = vehicle.m_completed_laps + vehicle.m_track_progress;
+    if (const TimingRecord::Splits* lap = vehicle.m_timing.CloseLap(crossing.timeUs))
+        SessionStats::OnLapCompleted(vehicleID, vehicle.m_current_lap_number, *lap);
+
+    // Update best lap time and ID
+    if (lapTime < vehicle.m_best_lap_time || vehicle.m_best_lap_time < 0.0f)
+    {
+        vehicle.m_best_lap_time = lapTime;
+        vehicle.bestlapID = vehicle.m_current_lap_number;
+    }
+
+    LOG_INFO(Race, "[RACE MANAGER] Vehicle #" << vehicleID
+              << " completed Lap " << vehicle.m_current_lap_number
+              << " in " << std::fixed << std::setprecision(6) << lapTime << "s"
+              << " | Total completed: " << vehicle.m_completed_laps);
+
+    if (m_sessionState == SessionState::Finishing)
+    {
+        vehicle.m_is_finished = true;
+        if (m_finishPositions.find(vehicleID) == m_finishPositions.end())
+            m_finishPositions[vehicleID] = static_cast<int>(m_finishPositions.size() + 1);
+        vehicle.m_current_lap_timer = 0.0f;
+        vehicle.m_timing.Stop();
+        LOG_INFO(Race, "[RACE MANAGER] Vehicle #" << vehicleID
+                  << " HAS FINISHED! pos=" << m_finishPositions[vehicleID]);
+    }
+    else
+    {
+        vehicle.m_current_lap_number++;
     }
-    
-    return false;
 }
 
     auto formatTime = [](float totalSeconds) {
@@ -500,101 +474,218 @@ bool RaceManager::CheckLineSegmentIntersection(
 // ============================================================================
 std::vector<VehicleStanding> RaceManager::GetStandingsInternal() const
 {
-    std::vector<VehicleStanding> standings;
-    const bool useFinishOrder = (m_sessionState == SessionState::Finishing || m_sessionState == SessionState::Ended);
-    
+    RefreshStandingsInternal();
+    return m_standings;
+}
+
+// ============================================================================
+// SORT: 0) Track Server position when authoritative, else
+//       1) Started racing? 2) Completed laps (desc), 3) Progress (desc)
+// ============================================================================
+bool RaceManager::StandingBefore(const VehicleStanding& a, const VehicleStanding& b, bool useFinishOrder) const
+{
+    // Networked session: the server's classification is the truth. It
+    // freezes at the checkered flag, so a finished leader can never be
+    // visually overtaken by live track progress after the line.
+    if (a.serverPosition > 0 && b.serverPosition > 0)
+        return a.serverPosition < b.serverPosition;
+    if ((a.serverPosition > 0) != (b.serverPosition > 0))
+        return a.serverPosition > 0;
+
+    if (a.hasStartedFirstLap != b.hasStartedFirstLap)
+        return a.hasStartedFirstLap > b.hasStartedFirstLap;
+
+    if (useFinishOrder)
+    {
+        const auto aIt = m_finishPositions.find(a.vehicleID);
+        const auto bIt = m_finishPositions.find(b.vehicleID);
+        const bool aFinished = (aIt != m_finishPositions.end());
+        const bool bFinished = (bIt != m_finishPositions.end());
+
+        if (aFinished != bFinished)
+            return aFinished > bFinished;
+
+        if (aFinished && bFinished)
+            return aIt->second < bIt->second;
+    }
+
+    if (a.completedLaps != b.completedLaps)
+        return a.completedLaps > b.completedLaps;
+
+    return a.distanceFromStart > b.distanceFromStart;
+}
+
+// ============================================================================
+// REFRESH STANDINGS (g_vehicles_mutex held)
+// ============================================================================
+bool RaceManager::RefreshStandingsInternal() const
+{
+    const SessionState state = m_sessionState;
+    const bool useFinishOrder = (state == SessionState::Finishing || state == SessionState::Ended);
+    const size_t count = g_vehicles.size();
+
+    // A new session state or finisher changes the comparator or zeroes the
+    // deltas: rebuild every row. A vehicle added or removed reindexes them.
+    bool rebuildAll = (state != m_standingsSessionState ||
+                       m_finishPositions.size() != m_standingsFinishCount);
+    bool reindexed = (m_standingKeys.size() != count);
+    if (reindexed)
+    {
+        m_standingKeys.assign(count, StandingKey{});
+        m_standingRows.assign(count, VehicleStanding{});
+        rebuildAll = true;
+    }
+
+    // Best lap logic depends on LAP_START_NUMBER
+    const int minCompletedLaps = (RaceConstants::LAP_START_NUMBER == 0) ? 1 : 2;
+
+    // ========================================================================
+    // ROWS: rebuild the ones whose key changed, run the lap timers on
+    // ========================================================================
+    bool changed = rebuildAll;
+    size_t r = 0;
     for (const auto& [vehicleID, vehicle] : g_vehicles)
     {
-        VehicleStanding standing;
-        standing.vehicleID = vehicleID;
-        standing.completedLaps = vehicle.m_completed_laps;
-        standing.currentLapNumber = vehicle.m_current_lap_number;
+        VehicleStanding& standing = m_standingRows[r];
         standing.currentLapTime = vehicle.m_is_finished ? 0.0f : vehicle.m_current_lap_timer;
-        standing.hasStartedFirstLap = vehicle.m_has_started_first_lap;
-        standing.isFinished = vehicle.m_is_finished;
-        standing.distanceFromStart = vehicle.m_track_progress;
-        standing.serverPosition = vehicle.m_has_authoritative_state
-                                    ? vehicle.m_server_position : 0;
-        
-        // Best lap logic depends on LAP_START_NUMBER
-        int minCompletedLaps = (RaceConstants::LAP_START_NUMBER == 0) ? 1 : 2;
-        standing.bestLapTime = (vehicle.m_completed_laps >= minCompletedLaps) ? vehicle.m_best_lap_time : -1.0f;
-        
-        // Calculate total race time (sum of all completed laps)
-        standing.totalRaceTime = 0.0f;
-        for (const auto& [lapNum, lapData] : vehicle.m_laps)
-        {
-            standing.totalRaceTime += lapData.lapTime;
-        }
-        
-        // ====================================================================
-        // CALCULATE TIME DIFFERENCES (using Internal versions - no mutex)
-        // ====================================================================
-        if (vehicle.m_is_finished || m_sessionState == SessionState::Ended)
-        {
-            standing.deltaTimeToBest = 0.0f;
-            standing.deltaTimeToLeader = 0.0f;
-        }
-        else
+
+        StandingKey key;
+        key.vehicleID = vehicleID;
+        key.completedLaps = vehicle.m_completed_laps;
+        key.currentLapNumber = vehicle.m_current_lap_number;
+        key.serverPosition = vehicle.m_has_authoritative_state ? vehicle.m_server_position : 0;
+        key.progressBucket = static_cast<int64_t>(std::floor(vehicle.m_track_progress * STANDINGS_PROGRESS_BUCKETS));
+        key.lapsStored = vehicle.m_laps.size();
+        key.bestLapTime = vehicle.m_best_lap_time;
+        key.started = vehicle.m_has_started_first_lap;
+        key.finished = vehicle.m_is_finished;
+
+        StandingKey& previous = m_standingKeys[r];
+        if (previous.vehicleID != vehicleID)
+            reindexed = true;
+
+        if (rebuildAll || !(key == previous))
         {
-            standing.deltaTimeToBest = CalculateLapTimeDiffInternal(vehicleID);
-            standing.deltaTimeToLeader = CalculateLeaderTimeDiffInternal(vehicleID);
+            standing.vehicleID = vehicleID;
+            standing.completedLaps = vehicle.m_completed_laps;
+            standing.currentLapNumber = vehicle.m_current_lap_number;
+            standing.hasStartedFirstLap = vehicle.m_has_started_first_lap;
+            standing.isFinished = vehicle.m_is_finished;
+            standing.distanceFromStart = vehicle.m_track_progress;
+            standing.serverPosition = key.serverPosition;
+            standing.bestLapTime = (vehicle.m_completed_laps >= minCompletedLaps) ? vehicle.m_best_lap_time : -1.0f;
+
+            // Total race time (sum of all completed laps): only when a lap was stored
+            if (rebuildAll || previous.vehicleID != vehicleID || key.lapsStored != previous.lapsStored)
+            {
+                standing.totalRaceTime = 0.0f;
+                for (const auto& [lapNum, lapData] : vehicle.m_laps)
+                {
+                    standing.totalRaceTime += lapData.lapTime;
+                }
+            }
+
+            standing.deltaTimeToBest = (vehicle.m_is_finished || state == SessionState::Ended)
+                                           ? 0.0f : CalculateLapTimeDiffInternal(vehicleID);
+
+            previous = key;
+            changed = true;
         }
-        
-        standings.push_back(standing);
+        ++r;
     }
-    
+
+    if (!changed)
+    {
+        for (size_t i = 0; i < m_standingOrder.size(); ++i)
+            m_standings[i].currentLapTime = m_standingRows[m_standingOrder[i]].currentLapTime;
+        return false;
+    }
+
     // ========================================================================
-    // SORT: 0) Track Server position when authoritative, else
-    //       1) Started racing? 2) Completed laps (desc), 3) Progress (desc)
+    // LEADER GAPS: one reference for the whole field, one pass. Progress is
+    // refreshed for every row here so the order below agrees with the gaps.
     // ========================================================================
-    std::sort(standings.begin(), standings.end(),
-        [this, useFinishOrder](const VehicleStanding& a, const VehicleStanding& b) -> bool
-        {
-            // Networked session: the server's classification is the truth. It
-            // freezes at the checkered flag, so a finished leader can never be
-            // visually overtaken by live track progress after the line.
-            if (a.serverPosition > 0 && b.serverPosition > 0)
-                return a.serverPosition < b.serverPosition;
-            if ((a.serverPosition > 0) != (b.serverPosition > 0))
-                return a.serverPosition > 0;
-
-            if (a.hasStartedFirstLap != b.hasStartedFirstLap)
-                return a.hasStartedFirstLap > b.hasStartedFirstLap;
-
-            if (useFinishOrder)
-            {
-                const auto aIt = m_finishPositions.find(a.vehicleID);
-                const auto bIt = m_finishPositions.find(b.vehicleID);
-                const bool aFinished = (aIt != m_finishPositions.end());
-                const bool bFinished = (bIt != m_finishPositions.end());
-
-                if (aFinished != bFinished)
-                    return aFinished > bFinished;
+    const LeaderGapReference gapRef = PrepareLeaderTimeDiffInternal();
+    r = 0;
+    for (const auto& [vehicleID, vehicle] : g_vehicles)
+    {
+        m_standingRows[r].distanceFromStart = vehicle.m_track_progress;
+        m_standingRows[r].deltaTimeToLeader = (vehicle.m_is_finished || state == SessionState::Ended)
+                                                  ? 0.0f : LeaderTimeDiffInternal(gapRef, vehicleID, vehicle);
+        ++r;
+    }
 
-                if (aFinished && bFinished)
-                    return aIt->second < bIt->second;
-            }
+    // ========================================================================
+    // ORDER: repair the previous order by insertion (a frame moves few cars),
+    // fall back to a full sort past N log N moves or when reindexed
+    // ========================================================================
+    const auto before = [this, useFinishOrder](uint32_t x, uint32_t y)
+    {
+        return StandingBefore(m_standingRows[x], m_standingRows[y], useFinishOrder);
+    };
 
-            if (a.completedLaps != b.completedLaps)
-                return a.completedLaps > b.completedLaps;
+    bool sorted = false;
+    if (!reindexed && m_standingOrder.size() == count)
+    {
+        size_t budget = count;
+        for (size_t n = count; n > 1; n >>= 1)
+            budget += count;
 
-            return a.distanceFromStart > b.distanceFromStart;
+        sorted = true;
+        for (size_t i = 1; i < count && sorted; ++i)
+        {
+            const uint32_t row = m_standingOrder[i];
+            size_t j = i;
+            while (j > 0 && before(row, m_standingOrder[j - 1]))
+            {
+                m_standingOrder[j] = m_standingOrder[j - 1];
+                --j;
+                if (budget-- == 0)
+                {
+                    sorted = false;
+                    break;
+                }
+            }
+            m_standingOrder[j] = row;
         }
-    );
-    
+    }
+    if (!sorted)
+    {
+        if (reindexed || m_standingOrder.size() != count)
+        {
+            m_standingOrder.resize(count);
+            for (size_t i = 0; i < count; ++i)
+                m_standingOrder[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(m_standingOrder.begin(), m_standingOrder.end(), before);
+    }
+
     // ========================================================================
     // ASSIGN POSITIONS & DETECT LAPPED CARS
     // ========================================================================
-    int leaderLaps = standings.empty() ? 0 : standings[0].completedLaps;
-    
-    for (size_t i = 0; i < standings.size(); ++i)
+    m_standings.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        m_standings[i] = m_standingRows[m_standingOrder[i]];
+
+    int leaderLaps = m_standings.empty() ? 0 : m_standings[0].completedLaps;
+
+    for (size_t i = 0; i < m_standings.size(); ++i)
     {
-        standings[i].position = static_cast<int>(i + 1);
-        standings[i].isLapped = (standings[i].completedLaps < leaderLaps);
+        m_standings[i].position = static_cast<int>(i + 1);
+        m_standings[i].isLapped = (m_standings[i].completedLaps < leaderLaps);
     }
-    
-    return standings;
+
+    m_standingsSessionState = state;
+    m_standingsFinishCount = m_finishPositions.size();
+    ++m_standingsVersion;
+    return true;
+}
+
+uint64_t RaceManager::GetStandingsVersion() const
+{
+    std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+    RefreshStandingsInternal();
+    return m_standingsVersion;
 }
 
 // ============================================================================
@@ -607,6 +698,49 @@ std::vector<VehicleStanding> RaceManager::GetStandings() const
     return GetStandingsInternal();
 }
 
+// ============================================================================
+// PUBLISH RACE SNAPSHOT (once per frame, render thread)
+// ============================================================================
+void RaceManager::PublishSnapshot()
+{
+    RaceFrame& frame = RaceSnapshot::Back();
+    {
+        std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+
+        frame.Resize(g_vehicles.size());
+        size_t i = 0;
+        for (const auto& [vehicleID, vehicle] : g_vehicles)   // std::map: ascending ids
+        {
+            frame.ids[i]            = vehicleID;
+            frame.position[i]       = glm::vec2(static_cast<float>(vehicle.m_normalized_x),
+                                                static_cast<float>(vehicle.m_normalized_y));
+            frame.heading[i]        = static_cast<float>(vehicle.m_heading);
+            frame.speedKph[i]       = static_cast<float>(vehicle.m_speed_kph);
+            frame.acceleration[i]   = static_cast<float>(vehicle.m_acceleration);
+            frame.gForceX[i]        = static_cast<float>(vehicle.m_g_force_x);
+            frame.gForceY[i]        = static_cast<float>(vehicle.m_g_force_y);
+            frame.trackProgress[i]  = static_cast<float>(vehicle.m_track_progress);
+            frame.fixType[i]        = vehicle.m_fix_type;
+            frame.color[i]          = vehicle.m_cached_color;
+            frame.currentLapTime[i] = vehicle.m_is_finished ? 0.0f : vehicle.m_current_lap_timer;
+            frame.previousLapTime[i] = PreviousLapTimeOf(vehicle);
+            frame.names[i]          = vehicle.name;   // Short names: no allocation
+
+            uint8_t flags = 0;
+            if (vehicle.m_is_leader)                 flags |= RaceFrame::kLeader;
+            if (vehicle.m_is_finished)               flags |= RaceFrame::kFinished;
+            if (vehicle.m_apply_track_render_offset) flags |= RaceFrame::kTrackRenderOffset;
+            frame.flags[i] = flags;
+            ++i;
+        }
+
+        RefreshStandingsInternal();
+        frame.standings = m_standings;        // Same size once the field is stable: no allocation
+        frame.standingsVersion = m_standingsVersion;
+    }
+    RaceSnapshot::Swap();
+}
+
 // ============================================================================
 // CALCULATE DISTANCE FROM START (0.0 to 1.0)
 // ? ?????: ?????????? ?????? ???????? ?? ????????? ?????? ?????? ????????? ?????
@@ -700,17 +834,21 @@ float RaceManager::GetVehiclePreviousLapTime(int32_t vehicleID) const
     std::lock_guard<std::mutex> lock(g_vehicles_mutex);
     auto it = g_vehicles.find(vehicleID);
     if (it != g_vehicles.end())
-    {
-        const auto& vehicle = it->second;
-        int previousLapNumber = vehicle.m_current_lap_number - 1;
-        
-        if (previousLapNumber < RaceConstants::LAP_START_NUMBER)
-            return -1.0f;
-        
-        auto lapIt = vehicle.m_laps.find(previousLapNumber);
-        if (lapIt != vehicle.m_laps.end())
-            return lapIt->second.lapTime;
-    }
+        return PreviousLapTimeOf(it->second);
+    
+    return -1.0f;
+}
+
+float RaceManager::PreviousLapTimeOf(const Vehicle& vehicle)
+{
+    int previousLapNumber = vehicle.m_current_lap_number - 1;
+    
+    if (previousLapNumber < RaceConstants::LAP_START_NUMBER)
+        return -1.0f;
+    
+    auto lapIt = vehicle.m_laps.find(previousLapNumber);
+    if (lapIt != vehicle.m_laps.end())
+        return lapIt->second.lapTime;
     
     return -1.0f;
 }
@@ -765,25 +903,25 @@ void RaceManager::PrintSessionSummary() const
 {
     std::lock_guard<std::mutex> lock(g_vehicles_mutex);
     
-    std::cout << "\n========================================" << std::endl;
-    std::cout << "       RACE SESSION SUMMARY" << std::endl;
-    std::cout << "========================================" << std::endl;
+    LOG_INFO(Race, "========================================");
+    LOG_INFO(Race, "       RACE SESSION SUMMARY");
+    LOG_INFO(Race, "========================================");
     
     for (const auto& [vehicleID, vehicle] : g_vehicles)
     {
-        std::cout << "\nVehicle #" << vehicleID << ":" << std::endl;
-        std::cout << "  Completed Laps: " << vehicle.m_completed_laps << std::endl;
-        std::cout << "  Current Lap Time: " << vehicle.m_current_lap_timer << "s" << std::endl;
-        std::cout << "  Best Lap: " << vehicle.m_best_lap_time << "s" << std::endl;
+        LOG_INFO(Race, "Vehicle #" << vehicleID << ":");
+        LOG_INFO(Race, "  Completed Laps: " << vehicle.m_completed_laps);
+        LOG_INFO(Race, "  Current Lap Time: " << vehicle.m_current_lap_timer << "s");
+        LOG_INFO(Race, "  Best Lap: " << vehicle.m_best_lap_time << "s");
         
-        std::cout << "  Lap Times:" << std::endl;
+        LOG_INFO(Race, "  Lap Times:");
         for (auto it = vehicle.m_laps.begin(); it != vehicle.m_laps.end(); ++it)
         {
-            std::cout << "    Lap " << it->first << ": " << it->second.lapTime << "s" << std::endl;
+            LOG_INFO(Race, "    Lap " << it->first << ": " << it->second.lapTime << "s");
         }
     }
     
-    std::cout << "\n========================================\n" << std::endl;
+    LOG_INFO(Race, "========================================");
 }
 
 // ============================================================================
@@ -926,12 +1064,12 @@ bool RaceManager::SaveResultsToFile() const
     std::ofstream file(filename);
     if (!file.is_open())
     {
-        std::cerr << "[RACE MANAGER] Failed to create file: " << filename << std::endl;
+        LOG_ERROR(Race, "[RACE MANAGER] Failed to create file: " << filename);
         return false;
     }
     file << BuildResultsText();
     file.close();
 
-    std::cout << "[RACE MANAGER] Results saved to: " << filename << std::endl;
+    LOG_INFO(Race, "[RACE MANAGER] Results saved to: " << filename);
     return true;
 }
@@ -3,12 +3,16 @@
 #include <map>
 #include <vector>
 #include <chrono>
+#include <atomic>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include "../vehicle/Vehicle.h"
 #include "StopReset/StartStop.h"
 
 // LapData is defined in Vehicle.h
 
+namespace TrackGeometry { struct Snapshot; }
+
 // ============================================================================
 // VEHICLE STANDING (for leaderboard)
 // ============================================================================
@@ -48,9 +52,20 @@ public:
     ~RaceManager();
     
     // ========================================================================
-    // CORE UPDATE LOOP (called every frame with delta time)
+    // CORE UPDATE LOOP (called every frame: auto-stop, finishing, leader,
+    // running lap timers for display)
+    // ========================================================================
+    void Update();
+
+    // ========================================================================
+    // POSITION FIXES (ingest thread, g_vehicles_mutex held by caller)
+    // Every position update of a vehicle as it arrives: start/finish
+    // crossings, lap completion, the track's timing lines (sectors, speed
+    // traps, pit lane) and telemetry samples, all on the fix's timestamp
+    // (interpolation clock, microseconds).
     // ========================================================================
-    void Update(float deltaTime);
+    void OnPositionFix(int32_t vehicleID, Vehicle& vehicle, int64_t timeUs,
+                       const TrackGeometry::Snapshot& track);
     
     // ========================================================================
     // SESSION CONTROL
@@ -58,6 +73,11 @@ public:
     void StartSession();
     void StopSession();
     void ResetSession();                        // Clear all lap data and timers
+    // The lap data part of ResetSession: every vehicle's session state, then
+    // the lap spill file, then the session statistics. Also run by the ingest
+    // thread when the Track Server starts a new race epoch. g_vehicles_mutex
+    // held by caller.
+    static void ResetLapHistory();
     void ResetMap();
     SessionState GetSessionState() const;
     float GetRaceElapsedTime() const;
@@ -72,6 +92,14 @@ public:
     // LEADERBOARD & STANDINGS
     // ========================================================================
     std::vector<VehicleStanding> GetStandings() const;
+    // Bumped whenever the order, a lap count, a finish or a gap changes
+    // (the lap timers in the standings run on without bumping it).
+    uint64_t GetStandingsVersion() const;
+
+    // Publish this frame's RaceSnapshot (positions, flags, lap timers and
+    // standings) for the renderers and panels. Call once per frame after
+    // Update(), on the render thread.
+    void PublishSnapshot();
     
     // ========================================================================
     // LAP DATA ACCESS (for UI display)
@@ -104,7 +132,9 @@ private:
     // ========================================================================
     // SESSION TRACKING
     // ========================================================================
-    SessionState m_sessionState = SessionState::Idle;
+    // Read by OnPositionFix on the ingest thread. m_finishPositions and the
+    // finishing state below change only under g_vehicles_mutex.
+    std::atomic<SessionState> m_sessionState{ SessionState::Idle };
     std::map<int32_t, int> m_finishPositions;
     std::chrono::steady_clock::time_point m_raceStartTime;
     bool m_raceTimerRunning = false;
@@ -126,14 +156,6 @@ private:
     glm::vec2 m_startFinishP2;
     bool m_lineInitialized;
     
-    // ========================================================================
-    // INTERSECTION DETECTION (sub-frame accurate)
-    // ========================================================================
-    bool CheckLineSegmentIntersection(
-        const glm::vec2& vehiclePrev, const glm::vec2& vehicleCurrent,
-        const glm::vec2& lineP1, const glm::vec2& lineP2,
-        float& outIntersectionRatio) const;
-    
     // ========================================================================
     // DISTANCE CALCULATION (for leaderboard sorting)
     // ========================================================================
@@ -141,13 +163,57 @@ private:
     
     // ========================================================================
     // INTERNAL STANDINGS (without mutex lock - for use within Update)
+    // Maintained incrementally: a vehicle's row is rebuilt only when its key
+    // (laps, start/finish, server position, best lap, progress bucket)
+    // changes, the order is repaired from the previous one and the leader
+    // gaps come from one pass. Nothing changed: only the lap timers update.
     // ========================================================================
+    static constexpr int STANDINGS_PROGRESS_BUCKETS = 1000;   // Per lap
+
+    struct StandingKey
+    {
+        int32_t vehicleID = -1;
+        int     completedLaps = 0;
+        int     currentLapNumber = 0;
+        int     serverPosition = 0;
+        int64_t progressBucket = 0;
+        size_t  lapsStored = 0;          // m_laps entries (total race time)
+        float   bestLapTime = -1.0f;
+        bool    started = false;
+        bool    finished = false;
+
+        bool operator==(const StandingKey& o) const
+        {
+            return vehicleID == o.vehicleID && completedLaps == o.completedLaps &&
+                   currentLapNumber == o.currentLapNumber && serverPosition == o.serverPosition &&
+                   progressBucket == o.progressBucket && lapsStored == o.lapsStored &&
+                   bestLapTime == o.bestLapTime && started == o.started && finished == o.finished;
+        }
+    };
+
     std::vector<VehicleStanding> GetStandingsInternal() const;
+    // Brings the cached standings up to date; true if the version changed
+    bool RefreshStandingsInternal() const;
+    bool StandingBefore(const VehicleStanding& a, const VehicleStanding& b, bool useFinishOrder) const;
+
+    mutable std::vector<StandingKey>     m_standingKeys;    // g_vehicles order
+    mutable std::vector<VehicleStanding> m_standingRows;    // g_vehicles order
+    mutable std::vector<uint32_t>        m_standingOrder;   // Row indices, leaderboard order
+    mutable std::vector<VehicleStanding> m_standings;       // Leaderboard order
+    mutable uint64_t     m_standingsVersion = 0;
+    mutable SessionState m_standingsSessionState = SessionState::Idle;
+    mutable size_t       m_standingsFinishCount = 0;
     
     // ========================================================================
     // LEADER LAP COUNT (for lapped detection)
     // ========================================================================
     int GetLeaderLapCount() const;
+
+    // Lap bookkeeping for a counted start/finish crossing; g_vehicles_mutex held
+    void OnStartFinishCrossing(int32_t vehicleID, Vehicle& vehicle, const LapTimer::Crossing& crossing);
+
+    // Last completed lap time of a vehicle (-1 if none); g_vehicles_mutex held
+    static float PreviousLapTimeOf(const Vehicle& vehicle);
 };
 
 // ============================================================================
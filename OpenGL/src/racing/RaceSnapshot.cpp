@@ -0,0 +1,74 @@
+#include "RaceSnapshot.h"
+#include <algorithm>
+#include <atomic>
+
+// ============================================================================
+// DOUBLE BUFFER
+// ============================================================================
+namespace
+{
+    RaceFrame g_frames[2];
+    std::atomic<int> g_front{ 0 };
+}
+
+// ============================================================================
+// RACE FRAME
+// ============================================================================
+int RaceFrame::Find(int32_t vehicleID) const
+{
+    auto it = std::lower_bound(ids.begin(), ids.end(), vehicleID);
+    if (it == ids.end() || *it != vehicleID)
+        return -1;
+    return static_cast<int>(it - ids.begin());
+}
+
+const VehicleStanding* RaceFrame::FindStanding(int32_t vehicleID) const
+{
+    for (const VehicleStanding& s : standings)
+    {
+        if (s.vehicleID == vehicleID)
+            return &s;
+    }
+    return nullptr;
+}
+
+void RaceFrame::Resize(size_t n)
+{
+    ids.resize(n);
+    position.resize(n);
+    heading.resize(n);
+    speedKph.resize(n);
+    acceleration.resize(n);
+    gForceX.resize(n);
+    gForceY.resize(n);
+    trackProgress.resize(n);
+    fixType.resize(n);
+    color.resize(n);
+    flags.resize(n);
+    currentLapTime.resize(n);
+    previousLapTime.resize(n);
+    names.resize(n);
+}
+
+// ============================================================================
+// PUBLISH / READ
+// ============================================================================
+namespace RaceSnapshot
+{
+    const RaceFrame& Current()
+    {
+        return g_frames[g_front.load(std::memory_order_acquire)];
+    }
+
+    RaceFrame& Back()
+    {
+        return g_frames[1 - g_front.load(std::memory_order_relaxed)];
+    }
+
+    void Swap()
+    {
+        const int back = 1 - g_front.load(std::memory_order_relaxed);
+        g_frames[back].tick = g_frames[1 - back].tick + 1;
+        g_front.store(back, std::memory_order_release);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "RaceManager.h"
+
+// ============================================================================
+// RACE SNAPSHOT - per-frame, read-only view of every vehicle
+// ============================================================================
+// RaceManager::PublishSnapshot() copies the few fields the renderers and
+// panels draw out of g_vehicles (one short lock per frame) into a compact
+// structure-of-arrays frame. Readers then use the front frame with no lock
+// and without copying Vehicle (whose lap maps and telemetry samples grow
+// for the whole session).
+//
+// Two frames are kept and reused, so publishing does not allocate once the
+// vehicle count is stable. Publisher and readers all run on the render
+// thread: the front frame stays valid until the next PublishSnapshot().
+// ============================================================================
+struct RaceFrame
+{
+    enum Flags : uint8_t
+    {
+        kLeader            = 1 << 0,
+        kFinished          = 1 << 1,
+        kTrackRenderOffset = 1 << 2,   // Vehicle::m_apply_track_render_offset
+    };
+
+    uint64_t tick = 0;                 // Publish counter (0 = nothing published yet)
+
+    // Per-vehicle columns, all the same length, sorted by ascending id.
+    std::vector<int32_t>     ids;
+    std::vector<glm::vec2>   position;        // Normalized, latest telemetry
+    std::vector<float>       heading;         // Radians
+    std::vector<float>       speedKph;
+    std::vector<float>       acceleration;
+    std::vector<float>       gForceX;
+    std::vector<float>       gForceY;
+    std::vector<float>       trackProgress;
+    std::vector<int16_t>     fixType;
+    std::vector<glm::vec3>   color;
+    std::vector<uint8_t>     flags;
+    std::vector<float>       currentLapTime;  // 0 once finished
+    std::vector<float>       previousLapTime; // -1 if none
+    std::vector<std::string> names;
+
+    // Leaderboard order, same content as RaceManager::GetStandings().
+    std::vector<VehicleStanding> standings;
+    uint64_t standingsVersion = 0;     // RaceManager::GetStandingsVersion() they came from
+
+    size_t Size() const { return ids.size(); }
+
+    // Column index of a vehicle, or -1.
+    int Find(int32_t vehicleID) const;
+
+    // Standing of a vehicle, or nullptr.
+    const VehicleStanding* FindStanding(int32_t vehicleID) const;
+
+    bool Is(size_t i, Flags f) const { return (flags[i] & f) != 0; }
+
+    void Resize(size_t n);
+};
+
+namespace RaceSnapshot
+{
+    // Latest published frame (empty before the first publish).
+    const RaceFrame& Current();
+
+    // Publisher side (RaceManager::PublishSnapshot): fill the back frame,
+    // then Swap() makes it current.
+    RaceFrame& Back();
+    void Swap();
+}
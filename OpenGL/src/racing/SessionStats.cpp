@@ -0,0 +1,222 @@
+#include "SessionStats.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+// ============================================================================
+// PUBLISHED TABLE
+// ============================================================================
+namespace
+{
+    using SessionStats::Table;
+    using SessionStats::TablePtr;
+
+    // Serializes publishers (ingest thread, session reset); readers only do
+    // an atomic_load and never touch this mutex.
+    std::mutex g_publish_mutex;
+
+    TablePtr& currentSlot()
+    {
+        static TablePtr s_current = std::make_shared<const Table>();
+        return s_current;
+    }
+
+    // Called with g_publish_mutex held.
+    void publish(std::shared_ptr<Table> next)
+    {
+        next->version = SessionStats::Current()->version + 1;
+        std::atomic_store(&currentSlot(), TablePtr(std::move(next)));
+    }
+
+    // Sectors and traps are numbered by the track's timing lines: bests timed
+    // on other lines do not compare.
+    void clearLineBests(Table& table)
+    {
+        std::fill(std::begin(table.bestSectorUs), std::end(table.bestSectorUs), -1);
+        std::fill(std::begin(table.bestSectorHolder), std::end(table.bestSectorHolder), -1);
+        std::fill(std::begin(table.bestTrapKph), std::end(table.bestTrapKph), -1.0f);
+        std::fill(std::begin(table.bestTrapHolder), std::end(table.bestTrapHolder), -1);
+        std::fill(std::begin(table.bestMiniSectors), std::end(table.bestMiniSectors), -1.0f);
+        for (auto& [id, stats] : table.vehicles)
+        {
+            std::fill(std::begin(stats.bestSectorUs), std::end(stats.bestSectorUs), -1);
+            std::fill(std::begin(stats.bestTrapKph), std::end(stats.bestTrapKph), -1.0f);
+            std::fill(std::begin(stats.bestLapMiniSectors), std::end(stats.bestLapMiniSectors), -1.0f);
+            stats.theoreticalBestUs = -1;
+        }
+    }
+
+    SessionStats::Mark markOf(int64_t timeUs, int64_t personalBestUs, int64_t sessionBestUs)
+    {
+        if (timeUs < 0)
+            return SessionStats::Mark::None;
+        if (timeUs <= sessionBestUs)
+            return SessionStats::Mark::Purple;
+        if (timeUs <= personalBestUs)
+            return SessionStats::Mark::Green;
+        return SessionStats::Mark::Yellow;
+    }
+}
+
+namespace SessionStats
+{
+    VehicleStats::VehicleStats()
+    {
+        std::fill(std::begin(lastSectorUs), std::end(lastSectorUs), -1);
+        std::fill(std::begin(lastSectorMark), std::end(lastSectorMark), Mark::None);
+        std::fill(std::begin(lastTrapKph), std::end(lastTrapKph), -1.0f);
+        std::fill(std::begin(bestSectorUs), std::end(bestSectorUs), -1);
+        std::fill(std::begin(bestTrapKph), std::end(bestTrapKph), -1.0f);
+        std::fill(std::begin(bestLapMiniSectors), std::end(bestLapMiniSectors), -1.0f);
+    }
+
+    Table::Table()
+    {
+        std::fill(std::begin(bestSectorUs), std::end(bestSectorUs), -1);
+        std::fill(std::begin(bestSectorHolder), std::end(bestSectorHolder), -1);
+        std::fill(std::begin(bestTrapKph), std::end(bestTrapKph), -1.0f);
+        std::fill(std::begin(bestTrapHolder), std::end(bestTrapHolder), -1);
+        std::fill(std::begin(bestMiniSectors), std::end(bestMiniSectors), -1.0f);
+    }
+
+    const VehicleStats* Table::Find(int32_t vehicleID) const
+    {
+        const auto it = vehicles.find(vehicleID);
+        return (it != vehicles.end()) ? &it->second : nullptr;
+    }
+
+    TablePtr Current()
+    {
+        return std::atomic_load(&currentSlot());
+    }
+
+    // ========================================================================
+    // LAP COMPLETED
+    // Everything here is O(sectors + traps + mini-sectors) for the one lap,
+    // plus the copy of the per-vehicle table.
+    // ========================================================================
+    void OnLapCompleted(int32_t vehicleID, int lapNumber, const TimingRecord::Splits& lap)
+    {
+        if (lap.lapUs <= 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(g_publish_mutex);
+        auto next = std::make_shared<Table>(*Current());
+        Table& table = *next;
+
+        // Only newer lines reset the bests. The sectors, traps and slices of a
+        // lap timed on older lines (a car that closed it just before picking
+        // up the new ones) are ignored; its lap time still counts.
+        const bool linesCurrent = (lap.linesVersion >= table.linesVersion);
+        if (lap.linesVersion > table.linesVersion)
+        {
+            clearLineBests(table);
+            table.linesVersion = lap.linesVersion;
+        }
+        if (linesCurrent)
+            table.sectorCount = std::clamp(lap.sectorCount, 0, MAX_SECTORS);
+
+        VehicleStats& stats = table.vehicles[vehicleID];
+        stats.completedLaps++;
+        stats.lastLapNumber = lapNumber;
+        stats.lastLapUs = lap.lapUs;
+
+        // Lap
+        if (stats.bestLapUs < 0 || lap.lapUs < stats.bestLapUs)
+        {
+            stats.bestLapUs = lap.lapUs;
+            stats.bestLapNumber = lapNumber;
+            if (linesCurrent)
+                std::copy(std::begin(lap.miniSectors), std::end(lap.miniSectors), stats.bestLapMiniSectors);
+            else
+                std::fill(std::begin(stats.bestLapMiniSectors), std::end(stats.bestLapMiniSectors), -1.0f);
+        }
+        if (table.bestLapUs < 0 || lap.lapUs < table.bestLapUs)
+        {
+            table.bestLapUs = lap.lapUs;
+            table.bestLapHolder = vehicleID;
+        }
+        stats.lastLapMark = markOf(lap.lapUs, stats.bestLapUs, table.bestLapUs);
+
+        // Sectors
+        for (int k = 0; k < MAX_SECTORS; ++k)
+        {
+            const int64_t sector = (linesCurrent && k < table.sectorCount) ? lap.sectorUs[k] : -1;
+            stats.lastSectorUs[k] = sector;
+            if (sector < 0)
+            {
+                stats.lastSectorMark[k] = Mark::None;
+                continue;
+            }
+            if (stats.bestSectorUs[k] < 0 || sector < stats.bestSectorUs[k])
+                stats.bestSectorUs[k] = sector;
+            if (table.bestSectorUs[k] < 0 || sector < table.bestSectorUs[k])
+            {
+                table.bestSectorUs[k] = sector;
+                table.bestSectorHolder[k] = vehicleID;
+            }
+            stats.lastSectorMark[k] = markOf(sector, stats.bestSectorUs[k], table.bestSectorUs[k]);
+        }
+
+        stats.theoreticalBestUs = (table.sectorCount > 0) ? 0 : -1;
+        for (int k = 0; k < table.sectorCount; ++k)
+        {
+            if (stats.bestSectorUs[k] < 0)
+            {
+                stats.theoreticalBestUs = -1;
+                break;
+            }
+            stats.theoreticalBestUs += stats.bestSectorUs[k];
+        }
+
+        // Speed traps
+        for (int t = 0; t < MAX_TRAPS; ++t)
+        {
+            const float kph = linesCurrent ? lap.trapKph[t] : -1.0f;
+            stats.lastTrapKph[t] = kph;
+            if (kph < 0.0f)
+                continue;
+            stats.bestTrapKph[t] = std::max(stats.bestTrapKph[t], kph);
+            if (kph > table.bestTrapKph[t])
+            {
+                table.bestTrapKph[t] = kph;
+                table.bestTrapHolder[t] = vehicleID;
+            }
+        }
+
+        // Mini-sectors
+        for (int m = 0; linesCurrent && m < MINI_SECTORS; ++m)
+        {
+            const float t = lap.miniSectors[m];
+            if (t >= 0.0f && (table.bestMiniSectors[m] < 0.0f || t < table.bestMiniSectors[m]))
+                table.bestMiniSectors[m] = t;
+        }
+
+        // Rolling average / consistency over the last ROLLING_LAPS laps
+        stats.recentLapUs[stats.recentNext] = lap.lapUs;
+        stats.recentNext = (stats.recentNext + 1) % ROLLING_LAPS;
+        stats.rollingCount = std::min(stats.rollingCount + 1, ROLLING_LAPS);
+
+        double sum = 0.0;
+        for (int i = 0; i < stats.rollingCount; ++i)
+            sum += stats.recentLapUs[i] / 1e6;
+        stats.rollingMeanS = sum / stats.rollingCount;
+
+        double squares = 0.0;
+        for (int i = 0; i < stats.rollingCount; ++i)
+        {
+            const double d = stats.recentLapUs[i] / 1e6 - stats.rollingMeanS;
+            squares += d * d;
+        }
+        stats.rollingStdDevS = (stats.rollingCount > 1) ? std::sqrt(squares / (stats.rollingCount - 1)) : 0.0;
+
+        stats.revision = Current()->version + 1;
+        publish(std::move(next));
+    }
+
+    void Reset()
+    {
+        std::lock_guard<std::mutex> lock(g_publish_mutex);
+        publish(std::make_shared<Table>());
+    }
+}
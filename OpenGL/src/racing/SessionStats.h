@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include "TimingRecord.h"
+
+// ============================================================================
+// SESSION STATS - derived timing statistics, updated per completed lap
+// ============================================================================
+// RaceManager hands every lap a TimingRecord closes to OnLapCompleted(); the
+// bests, the theoretical best, the rolling average and the sector marks are
+// updated there once, from that lap alone, and published as an immutable
+// Table (copy-on-publish, like TrackGeometry). Panels read Current() with no
+// lock and no scan over lap samples, so their cost does not grow with the
+// session.
+//
+// Table::version bumps on every publish and VehicleStats::revision records
+// the version that last touched a vehicle: a panel that caches what it drew
+// can skip the work while the revision it saw is unchanged.
+// ============================================================================
+namespace SessionStats
+{
+    constexpr int MAX_SECTORS = TimingRecord::MAX_SECTORS;
+    constexpr int MAX_TRAPS = TimingRecord::MAX_TRAPS;
+    constexpr int MINI_SECTORS = TimingRecord::MINI_SECTORS;
+    constexpr int ROLLING_LAPS = 5;    // Laps in the rolling average
+
+    // How a lap or sector compared when it was completed
+    enum class Mark : uint8_t
+    {
+        None,       // Not timed
+        Purple,     // Session best (all vehicles)
+        Green,      // Personal best
+        Yellow,     // Neither
+    };
+
+    struct VehicleStats
+    {
+        uint64_t revision = 0;                 // Table version of the last update
+        int      completedLaps = 0;            // Laps seen by OnLapCompleted
+
+        int      lastLapNumber = -1;
+        int64_t  lastLapUs = -1;
+        Mark     lastLapMark = Mark::None;
+        int64_t  lastSectorUs[MAX_SECTORS];    // -1: not timed
+        Mark     lastSectorMark[MAX_SECTORS];
+        float    lastTrapKph[MAX_TRAPS];       // -1: not passed
+
+        int      bestLapNumber = -1;
+        int64_t  bestLapUs = -1;
+        int64_t  bestSectorUs[MAX_SECTORS];    // Best of any lap, -1 if none
+        int64_t  theoreticalBestUs = -1;       // Sum of the best sectors, -1 until all are timed
+        float    bestTrapKph[MAX_TRAPS];
+        float    bestLapMiniSectors[MINI_SECTORS];  // Of the best lap, seconds, -1: not timed
+
+        // Mean and standard deviation of the last ROLLING_LAPS lap times
+        int      rollingCount = 0;
+        double   rollingMeanS = 0.0;
+        double   rollingStdDevS = 0.0;
+        int64_t  recentLapUs[ROLLING_LAPS] = {};   // Ring behind the rolling stats
+        int      recentNext = 0;
+
+        VehicleStats();
+    };
+
+    struct Table
+    {
+        uint64_t version = 0;
+        uint64_t linesVersion = 0;             // TimingRecord::Splits::linesVersion the line-based bests were timed on
+        int      sectorCount = 0;
+
+        std::map<int32_t, VehicleStats> vehicles;
+
+        // Session bests and who holds them (-1: nobody yet)
+        int64_t  bestLapUs = -1;
+        int32_t  bestLapHolder = -1;
+        int64_t  bestSectorUs[MAX_SECTORS];
+        int32_t  bestSectorHolder[MAX_SECTORS];
+        float    bestTrapKph[MAX_TRAPS];
+        int32_t  bestTrapHolder[MAX_TRAPS];
+        float    bestMiniSectors[MINI_SECTORS];    // Fastest through each slice, any lap
+
+        Table();
+
+        // Stats of a vehicle, or nullptr before its first completed lap.
+        const VehicleStats* Find(int32_t vehicleID) const;
+    };
+
+    using TablePtr = std::shared_ptr<const Table>;
+
+    // Latest published table (never null).
+    TablePtr Current();
+
+    // A lap closed by a vehicle's TimingRecord; g_vehicles_mutex held.
+    void OnLapCompleted(int32_t vehicleID, int lapNumber, const TimingRecord::Splits& lap);
+
+    // Forget every lap (session reset).
+    void Reset();
+}
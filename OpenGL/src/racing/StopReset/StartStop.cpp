@@ -1,8 +1,10 @@
 ﻿#include "StartStop.h"
 #include "../RaceManager.h"
+#include "../SessionStats.h"
+#include "../LapSpill.h"
 #include "../../rendering/Render.h"
 #include "../../Config.h"
-#include <iostream>
+#include "../../core/Log.h"
 #include <chrono>
 
 void RaceManager::StartSession() {
@@ -11,16 +13,16 @@ void RaceManager::StartSession() {
     m_raceStartTime = std::chrono::steady_clock::now();
     m_raceTimerRunning = true;
     m_raceElapsedSeconds = 0.0f;
-    std::cout << "[SESSION] Session Started!" << std::endl;
+    LOG_INFO(Race, "[SESSION] Session Started!");
 }
 
 void RaceManager::StopSession() {
     if (m_sessionState == SessionState::Active) {
-        m_sessionState = SessionState::Finishing;
-
         // Record leader state so finishing order is enforced correctly:
         // 1) The stored leader must be the first to cross the finish line.
         // 2) Lapped cars may only finish after all lead-lap cars have finished.
+        // Switched under the lock: crossings on the ingest thread must see
+        // Finishing and the recorded leader together.
         {
             std::lock_guard<std::mutex> lock(g_vehicles_mutex);
 
@@ -47,46 +49,64 @@ void RaceManager::StopSession() {
             for (const auto& [id, veh] : g_vehicles)
                 if (veh.m_has_started_first_lap && veh.m_completed_laps >= maxLaps)
                     m_leadLapCarCount++;
+
+            m_sessionState = SessionState::Finishing;
         }
 
-        std::cout << "[SESSION] Session Stopped! Leader=#" << m_leaderAtStop
+        LOG_INFO(Race, "[SESSION] Session Stopped! Leader=#" << m_leaderAtStop
                   << " laps=" << m_leaderLapsAtStop
                   << " leadLapCars=" << m_leadLapCarCount
-                  << " Awaiting finishing laps..." << std::endl;
+                  << " Awaiting finishing laps...");
     }
 }
 
 void RaceManager::ResetSession() {
-    m_sessionState = SessionState::Idle;
-    m_finishPositions.clear();
     m_raceTimerRunning = false;
     m_raceElapsedSeconds = 0.0f;
+
+    // Creating and mapping the spill file can block: not under the lock
+    LapSpill::Open();
+
+    std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+    m_sessionState = SessionState::Idle;
+    m_finishPositions.clear();
     m_leaderLapsAtStop = 0;
     m_leaderAtStop = -1;
     m_leadLapCarCount = 0;
+    ResetLapHistory();
+    LOG_INFO(Race, "[SESSION] Session Reset! All lap data cleared.");
+}
 
-    std::lock_guard<std::mutex> lock(g_vehicles_mutex);
-    for (auto& [id, vehicle] : g_vehicles) {
-        vehicle.m_laps.clear();
-        vehicle.laps.clear(); // Clear telemetry samples
-        vehicle.m_current_lap_timer = 0.0f;
-        vehicle.m_current_lap_number = RaceConstants::LAP_START_NUMBER;
-        vehicle.m_completed_laps = 0;
-        vehicle.m_total_progress = 0.0;
-        vehicle.m_has_started_first_lap = false;
-        vehicle.m_best_lap_time = -1.0f;
-        vehicle.bestlapID = -1;
-        vehicle.m_prev_track_progress = 0.0;
-        vehicle.m_is_finished = false;
-        vehicle.m_telemetry_sample_timer = 0.0f;
-    }
-    std::cout << "[SESSION] Session Reset! All lap data cleared." << std::endl;
+void RaceManager::ResetLapHistory() {
+    for (auto& [id, vehicle] : g_vehicles)
+        vehicle.ResetSessionState();
+    LapSpill::Reset();   // Only now: every lap pointing into it is gone
+    SessionStats::Reset();
+}
+
+void Vehicle::ResetSessionState() {
+    m_laps.clear();
+    laps.clear(); // Clear telemetry samples
+    m_current_lap_timer = 0.0f;
+    m_current_lap_number = RaceConstants::LAP_START_NUMBER;
+    m_completed_laps = 0;
+    m_total_progress = 0.0;
+    m_has_started_first_lap = false;
+    m_best_lap_time = -1.0f;
+    bestlapID = -1;
+    m_prev_track_progress = 0.0;
+    m_is_finished = false;
+    m_is_leader = false;
+    m_server_position = 0;
+    m_lap_timer.Reset();
+    m_timing.Reset();      // Sector splits, speed traps, mini-sectors
+    m_last_sample_us = 0;
 }
 
 void RaceManager::ResetMap() {
     ResetSession();
     TrackRenderer::clearTrackCache();
-    std::cout << "[SESSION] Track & Map Reset!" << std::endl;
+    LOG_INFO(Race, "[SESSION] Track & Map Reset!");
 }
 
 SessionState RaceManager::GetSessionState() const {
@@ -1,12 +1,13 @@
 ﻿#include "./TimeDiff.h"
 #include "../../rendering/Interpolation.h"
+#include "../../track/TrackGeometry.h"
 #include "../../Config.h"
+#include "../../core/Log.h"
 #include <algorithm>
 #include <chrono>
 #include <limits>
 #include <mutex>
 #include <cmath>
-#include <iostream>
 #include <iomanip>
 #include <unordered_map>
 
@@ -19,12 +20,10 @@
 #undef max
 #undef min
 
-extern std::vector<SplinePoint> g_smooth_track_points;
-
 // ============================================================================
 // CALCULATE LAP TIME DIFFERENCE TO BEST LAP (INTERNAL - NO MUTEX)
 // Compares current lap progress with interpolated best lap time
-// Called from GetStandingsInternal where mutex is already locked
+// Called from RefreshStandingsInternal where mutex is already locked
 // ============================================================================
 float CalculateLapTimeDiffInternal(int vehicleID)
 {
@@ -42,33 +41,15 @@ float CalculateLapTimeDiffInternal(int vehicleID)
 
     if (bestLapID == -1 || vehicle.laps.find(bestLapID) == vehicle.laps.end()) return 0.0f;
 
-    const auto& bestLapSamples = vehicle.laps.at(bestLapID).samples;
-    if (bestLapSamples.empty()) return 0.0f;
+    const LapSamples& bestLapSamples = vehicle.laps.at(bestLapID).samples;
+    if (bestLapSamples.Empty()) return 0.0f;
 
     double currentProgress = vehicle.m_track_progress;  // Use m_track_progress (0.0-1.0)
     double currentTime = vehicle.m_current_lap_timer;
 
-    // Binary search for closest sample at current progress
-    auto it = std::lower_bound(bestLapSamples.begin(), bestLapSamples.end(), currentProgress,
-        [](const LapInfo& s, double val) {
-            return s.progress < val;
-        });
-
-    // Edge case: current progress beyond best lap samples
-    if (it == bestLapSamples.end())
-    {
-        return (float)(currentTime - bestLapSamples.back().timefromstart);
-    }
-
-    // Edge case: current progress before first sample
-    if (it == bestLapSamples.begin()) {
-        return (float)(currentTime - it->timefromstart);
-    }
-
-    // Linear interpolation between two samples
-    auto prevIt = std::prev(it);
-    double t = (currentProgress - prevIt->progress) / (it->progress - prevIt->progress);
-    double interpolatedBestTime = prevIt->timefromstart + (it->timefromstart - prevIt->timefromstart) * t;
+    // Binary search on the progress column, linear interpolation between the
+    // two bracketing samples (clamped to the first / last one at the ends)
+    double interpolatedBestTime = bestLapSamples.TimeAtProgress(currentProgress);
 
     return (float)(currentTime - interpolatedBestTime);
 }
@@ -84,41 +65,14 @@ float CalculateLapTimeDiff(int vehicleID)
 }
 
 // ============================================================================
-// TRACK LENGTH CACHE
-// Computes total spline length in normalized units once and caches it.
-// g_smooth_track_points uses normalized coordinates (same as m_track_progress),
-// so the result is in the same unit space. Multiply by a meters-per-unit scale
-// to convert to real-world meters when needed.
+// TRACK LENGTH
+// Closed-loop spline length in normalized units (same unit space as
+// m_track_progress), precomputed once per track by TrackGeometry. Multiply by
+// a meters-per-unit scale to convert to real-world meters when needed.
 // ============================================================================
 float GetCachedTrackLengthMeters()
 {
-    static float s_cachedLength = 0.0f;
-    static size_t s_cachedPointCount = 0;
-
-    if (g_smooth_track_points.size() == s_cachedPointCount && s_cachedLength > 0.0f)
-        return s_cachedLength;
-
-    s_cachedPointCount = g_smooth_track_points.size();
-    if (s_cachedPointCount < 2)
-    {
-        s_cachedLength = 0.0f;
-        return 0.0f;
-    }
-
-    float total = 0.0f;
-    for (size_t i = 1; i < s_cachedPointCount; ++i)
-    {
-        glm::vec2 d = g_smooth_track_points[i].position - g_smooth_track_points[i - 1].position;
-        total += std::sqrt(d.x * d.x + d.y * d.y);
-    }
-    // Close the loop
-    {
-        glm::vec2 d = g_smooth_track_points[0].position - g_smooth_track_points[s_cachedPointCount - 1].position;
-        total += std::sqrt(d.x * d.x + d.y * d.y);
-    }
-
-    s_cachedLength = total;
-    return s_cachedLength;
+    return TrackGeometry::Current()->loopLength;
 }
 
 // ============================================================================
@@ -136,47 +90,40 @@ float GetCachedTrackLengthMeters()
 // Using a single reference speed for ALL cars guarantees monotonic gaps:
 // a car further behind always shows a strictly larger gap than one ahead.
 // ============================================================================
-float CalculateLeaderTimeDiffInternal(int vehicleID)
+LeaderGapReference PrepareLeaderTimeDiffInternal()
 {
-    if (g_vehicles.find(vehicleID) == g_vehicles.end()) return 0.0f;
-    auto& vehicle = g_vehicles.at(vehicleID);
+    LeaderGapReference ref;
 
     // -----------------------------------------------------------------------
     // Find leader by highest total_progress — NOT by m_is_leader flag.
-    // m_is_leader is updated AFTER GetStandingsInternal() runs, so on a lap
+    // m_is_leader is updated AFTER the standings are refreshed, so on a lap
     // boundary it can be stale for one frame and return 0 for everyone.
     // -----------------------------------------------------------------------
-    int leaderID = -1;
     double leaderProgress = -1.0;
     for (auto& [id, v] : g_vehicles)
     {
         if (v.m_has_started_first_lap && v.m_total_progress > leaderProgress)
         {
             leaderProgress = v.m_total_progress;
-            leaderID = id;
+            ref.leaderID = id;
         }
     }
-    if (leaderID == -1 || leaderID == vehicleID) return 0.0f;
+    if (ref.leaderID == -1) return ref;
 
-    auto& leader = g_vehicles.at(leaderID);
+    const Vehicle& leader = g_vehicles.at(ref.leaderID);
+    ref.leaderProgress = leader.m_total_progress;
 
     // -----------------------------------------------------------------------
-    // 1. Progress gap (dimensionless, 1.0 = one full lap ahead)
-    // -----------------------------------------------------------------------
-    double progressGap = leader.m_total_progress - vehicle.m_total_progress;
-    if (progressGap <= 0.0) return 0.0f;
-
-    // -----------------------------------------------------------------------
-    // 2. Convert progress gap to real meters.
+    // Progress gap → real meters.
     //    GetCachedTrackLengthMeters() returns spline length in NORMALIZED units.
     //    MAP_SIZE = 100 means 1 normalized unit = 100 meters.
     // -----------------------------------------------------------------------
     float trackLengthNorm = GetCachedTrackLengthMeters();
-    if (trackLengthNorm <= 0.0f) return 0.0f;
-    const float trackLengthMeters = trackLengthNorm * static_cast<float>(MapConstants::MAP_SIZE);
+    if (trackLengthNorm <= 0.0f) return ref;
+    ref.trackLengthMeters = trackLengthNorm * static_cast<float>(MapConstants::MAP_SIZE);
 
     // -----------------------------------------------------------------------
-    // 3. Reference speed for gap calculation.
+    // Reference speed for gap calculation.
     //
     // Professional approach (F1/WEC): use trackLength / bestLapTime as the
     // reference speed. This value only changes when a new best lap is set,
@@ -187,56 +134,77 @@ float CalculateLeaderTimeDiffInternal(int vehicleID)
     // -----------------------------------------------------------------------
     constexpr float kMinSpeedKph = 10.0f; // absolute floor to avoid div-by-zero
 
-    float referenceSpeedMs = 0.0f;
-
     // Primary: theoretical lap pace (most stable, immune to braking)
     const float leaderBestLap = leader.m_best_lap_time;
     if (leaderBestLap > 0.0f)
     {
-        referenceSpeedMs = trackLengthMeters / leaderBestLap;
+        ref.referenceSpeedMs = ref.trackLengthMeters / leaderBestLap;
     }
     else
     {
-        // Fallback: EMA-smoothed leader speed.
-        // alpha = 0.05 → ~20-sample time constant at 10 Hz ≈ 2 seconds of smoothing.
+        // Fallback: EMA-smoothed leader speed, ~2 s time constant.
+        // Weighted by the time since the last update, so it smooths the same
+        // however often the standings are refreshed.
         // Stored per leaderID so it survives across calls.
-        constexpr float kEmaAlpha = 0.05f;
+        constexpr double kEmaTauSeconds = 2.0;
 
-        static std::unordered_map<int, float> s_emaSpeed;
+        struct Ema { float kph; std::chrono::steady_clock::time_point at; };
+        static std::unordered_map<int, Ema> s_emaSpeed;
 
+        const auto now = std::chrono::steady_clock::now();
         float rawKph = static_cast<float>(leader.m_speed_kph);
-        auto emaIt = s_emaSpeed.find(leaderID);
+        auto emaIt = s_emaSpeed.find(ref.leaderID);
         if (emaIt == s_emaSpeed.end())
         {
-            s_emaSpeed[leaderID] = rawKph;
-            emaIt = s_emaSpeed.find(leaderID);
+            emaIt = s_emaSpeed.emplace(ref.leaderID, Ema{ rawKph, now }).first;
         }
         else
         {
-            emaIt->second = emaIt->second + kEmaAlpha * (rawKph - emaIt->second);
+            const double dt = std::chrono::duration<double>(now - emaIt->second.at).count();
+            const float alpha = static_cast<float>(1.0 - std::exp(-dt / kEmaTauSeconds));
+            emaIt->second.kph += alpha * (rawKph - emaIt->second.kph);
+            emaIt->second.at = now;
         }
 
-        float smoothedKph = emaIt->second;
+        float smoothedKph = emaIt->second.kph;
         if (smoothedKph < kMinSpeedKph)
             smoothedKph = kMinSpeedKph;
 
-        referenceSpeedMs = smoothedKph / 3.6f;
+        ref.referenceSpeedMs = smoothedKph / 3.6f;
     }
 
-    const float gapMeters = static_cast<float>(progressGap) * trackLengthMeters;
-    float gapSeconds      = gapMeters / referenceSpeedMs;
+    return ref;
+}
+
+float LeaderTimeDiffInternal(const LeaderGapReference& ref, int vehicleID, const Vehicle& vehicle)
+{
+    if (ref.leaderID == -1 || ref.leaderID == vehicleID || ref.referenceSpeedMs <= 0.0f) return 0.0f;
+
+    // Progress gap (dimensionless, 1.0 = one full lap ahead)
+    double progressGap = ref.leaderProgress - vehicle.m_total_progress;
+    if (progressGap <= 0.0) return 0.0f;
+
+    const float gapMeters = static_cast<float>(progressGap) * ref.trackLengthMeters;
+    float gapSeconds      = gapMeters / ref.referenceSpeedMs;
 
     #ifdef DEBUG_TIME_DIFF
-    std::cout << "[LEADER DIFF] veh#" << vehicleID
+    LOG_DEBUG(Race, "[LEADER DIFF] veh#" << vehicleID
               << " gap=" << std::fixed << std::setprecision(4) << progressGap
               << " gapM=" << gapMeters
-              << " leaderKph=" << leaderSpeedKph
-              << " result=" << std::setprecision(3) << gapSeconds << "s" << std::endl;
+              << " refMs=" << ref.referenceSpeedMs
+              << " result=" << std::setprecision(3) << gapSeconds << "s");
     #endif
 
     return gapSeconds;
 }
 
+float CalculateLeaderTimeDiffInternal(int vehicleID)
+{
+    auto it = g_vehicles.find(vehicleID);
+    if (it == g_vehicles.end()) return 0.0f;
+    return LeaderTimeDiffInternal(PrepareLeaderTimeDiffInternal(), vehicleID, it->second);
+}
+
 // ============================================================================
 // CALCULATE TIME DIFFERENCE TO LEADER (PUBLIC - WITH MUTEX)
 // Thread-safe wrapper for external calls (UI, etc.)
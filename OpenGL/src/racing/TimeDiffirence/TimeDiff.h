@@ -13,6 +13,19 @@ float CalculateLapTimeDiffInternal(int vehicleID);  // Internal (no mutex)
 float CalculateLeaderTimeDiff(int vehicleID);          // Thread-safe (with mutex)
 float CalculateLeaderTimeDiffInternal(int vehicleID);  // Internal (no mutex)
 
-// Returns cached track length in meters (computed from g_smooth_track_points).
+// Leader and reference pace shared by every gap of one standings pass: found
+// once (O(N)), after which each vehicle's gap is O(1)
+struct LeaderGapReference
+{
+    int    leaderID = -1;
+    double leaderProgress = 0.0;
+    float  trackLengthMeters = 0.0f;
+    float  referenceSpeedMs = 0.0f;
+};
+LeaderGapReference PrepareLeaderTimeDiffInternal();    // Internal (no mutex)
+float LeaderTimeDiffInternal(const LeaderGapReference& ref, int vehicleID, const Vehicle& vehicle);
+
+// Returns track length (closed loop, normalized units) from the current
+// TrackGeometry snapshot.
 // Returns 0 if track is not loaded.
 float GetCachedTrackLengthMeters();
@@ -0,0 +1,200 @@
+#include "TimingRecord.h"
+#include "../track/TrackGeometry.h"
+#include <algorithm>
+#include <cmath>
+
+TimingRecord::Splits::Splits()
+{
+    std::fill(std::begin(sectorUs), std::end(sectorUs), -1);
+    std::fill(std::begin(trapKph), std::end(trapKph), -1.0f);
+    std::fill(std::begin(miniSectors), std::end(miniSectors), -1.0f);
+}
+
+// ============================================================================
+// FIXES
+// ============================================================================
+void TimingRecord::OnFix(const LapTimer::Fix& fix, double speedKph, const TrackGeometry::Snapshot& track)
+{
+    if (m_hasLastFix && fix.timeUs < m_lastFixUs) {
+        return;  // Out of order (the line timers ignore it too)
+    }
+
+    if (track.timingLinesVersion != m_linesVersion) {
+        // New lines: their state and the sectors timed so far no longer apply.
+        // An origin or start/finish publish keeps the lines and this version.
+        m_linesVersion = track.timingLinesVersion;
+        m_lines.assign(track.timingLines.size(), LapTimer{});
+        m_sectorCount = std::clamp(track.sectorCount, 1, MAX_SECTORS);
+        if (m_inLap) {
+            StartLap(m_lapNumber, m_lapStartUs);
+        }
+    }
+
+    int boundary = 1;
+    int trap = 0;
+    for (size_t i = 0; i < m_lines.size(); ++i) {
+        const TrackGeometry::TimingLine& timingLine = track.timingLines[i];
+
+        LapTimer::Line line;
+        line.p1 = glm::dvec2(timingLine.p1);
+        line.p2 = glm::dvec2(timingLine.p2);
+        line.forward = glm::dvec2(timingLine.forward);
+
+        // Progress relative to the line, so the low-rate fallback wraps there
+        LapTimer::Fix lineFix = fix;
+        lineFix.progress = fix.progress - timingLine.progress;
+        if (lineFix.progress < 0.0) {
+            lineFix.progress += 1.0;
+        }
+
+        const LapTimer::Crossing crossing = m_lines[i].OnFix(lineFix, line);
+        const bool inThisLap = crossing.crossed && m_inLap && crossing.timeUs >= m_lapStartUs;
+
+        switch (timingLine.kind) {
+        case TrackGeometry::TimingLine::Kind::Sector: {
+            const int b = boundary++;
+            if (!inThisLap || b >= m_sectorCount || m_boundaryUs[b] >= 0) {
+                break;
+            }
+            m_boundaryUs[b] = crossing.timeUs - m_lapStartUs;
+            if (m_boundaryUs[b - 1] >= 0 && m_boundaryUs[b] > m_boundaryUs[b - 1]) {
+                m_current.sectorUs[b - 1] = m_boundaryUs[b] - m_boundaryUs[b - 1];
+            }
+            break;
+        }
+        case TrackGeometry::TimingLine::Kind::SpeedTrap: {
+            const int t = trap++;
+            if (!inThisLap || t >= MAX_TRAPS || m_current.trapKph[t] >= 0.0f) {
+                break;
+            }
+            // Speed at the crossing, between the two fixes' speeds
+            double speed = speedKph;
+            if (m_hasLastFix && fix.timeUs > m_lastFixUs) {
+                const double ratio = static_cast<double>(crossing.timeUs - m_lastFixUs) /
+                                     static_cast<double>(fix.timeUs - m_lastFixUs);
+                speed = m_lastSpeedKph + (speedKph - m_lastSpeedKph) * ratio;
+            }
+            m_current.trapKph[t] = static_cast<float>(speed);
+            break;
+        }
+        case TrackGeometry::TimingLine::Kind::PitEntry:
+            if (crossing.crossed) {
+                m_inPit = true;
+                m_pitEntryUs = crossing.timeUs;
+            }
+            break;
+        case TrackGeometry::TimingLine::Kind::PitExit:
+            if (crossing.crossed) {
+                m_inPit = false;
+                m_pitExitUs = crossing.timeUs;
+            }
+            break;
+        }
+    }
+
+    if (m_inLap) {
+        UpdateMiniSectors(fix);
+    }
+
+    m_hasLastFix = true;
+    m_lastFixUs = fix.timeUs;
+    m_lastSpeedKph = speedKph;
+}
+
+void TimingRecord::UpdateMiniSectors(const LapTimer::Fix& fix)
+{
+    // Progress is noisy and can step back (braking, matching); only the
+    // furthest point reached counts, so a slice once timed stays timed
+    const double p = fix.progress;
+    if (fix.timeUs < m_miniProgressUs || p <= m_miniProgress || p - m_miniProgress > MINI_MAX_STEP) {
+        return;
+    }
+
+    while (m_miniNext < MINI_SECTORS && static_cast<double>(m_miniNext) / MINI_SECTORS <= p) {
+        const double at = static_cast<double>(m_miniNext) / MINI_SECTORS;
+        const double ratio = std::clamp((at - m_miniProgress) / (p - m_miniProgress), 0.0, 1.0);
+        const int64_t boundaryUs = m_miniProgressUs +
+            static_cast<int64_t>(std::llround(ratio * static_cast<double>(fix.timeUs - m_miniProgressUs)));
+        if (m_miniNext > 0) {
+            m_current.miniSectors[m_miniNext - 1] = static_cast<float>((boundaryUs - m_miniBoundaryUs) / 1e6);
+        }
+        m_miniBoundaryUs = boundaryUs;
+        ++m_miniNext;
+    }
+    m_miniProgress = p;
+    m_miniProgressUs = fix.timeUs;
+}
+
+// ============================================================================
+// LAPS
+// ============================================================================
+void TimingRecord::StartLap(int lapNumber, int64_t timeUs)
+{
+    m_inLap = true;
+    m_lapNumber = lapNumber;
+    m_lapStartUs = timeUs;
+    std::fill(std::begin(m_boundaryUs), std::end(m_boundaryUs), -1);
+    m_boundaryUs[0] = 0;
+    m_current = Splits{};
+    m_current.sectorCount = m_sectorCount;
+    m_current.linesVersion = m_linesVersion;
+
+    // Progress 0 is the start/finish line: the first slice starts here
+    m_miniNext = 1;
+    m_miniBoundaryUs = timeUs;
+    m_miniProgress = 0.0;
+    m_miniProgressUs = timeUs;
+}
+
+const TimingRecord::Splits* TimingRecord::CloseLap(int64_t timeUs)
+{
+    if (!m_inLap) {
+        return nullptr;
+    }
+
+    // Start/finish closes the last sector and the last slice
+    const int last = m_sectorCount - 1;
+    const int64_t lapUs = timeUs - m_lapStartUs;
+    if (m_boundaryUs[last] >= 0 && lapUs > m_boundaryUs[last]) {
+        m_current.sectorUs[last] = lapUs - m_boundaryUs[last];
+    }
+    if (m_miniNext == MINI_SECTORS) {
+        m_current.miniSectors[MINI_SECTORS - 1] = static_cast<float>((timeUs - m_miniBoundaryUs) / 1e6);
+    }
+
+    m_current.lapUs = lapUs;
+
+    m_laps[m_lapNumber] = m_current;
+    m_lastLapNumber = m_lapNumber;
+    StartLap(m_lapNumber + 1, timeUs);
+    return LastLap();
+}
+
+void TimingRecord::Stop()
+{
+    m_inLap = false;
+}
+
+// ============================================================================
+// RESULTS
+// ============================================================================
+int64_t TimingRecord::BoundaryUs(int boundary) const
+{
+    return (m_inLap && boundary >= 0 && boundary < MAX_SECTORS) ? m_boundaryUs[boundary] : -1;
+}
+
+const TimingRecord::Splits* TimingRecord::Lap(int lapNumber) const
+{
+    const auto it = m_laps.find(lapNumber);
+    return (it != m_laps.end()) ? &it->second : nullptr;
+}
+
+const TimingRecord::Splits* TimingRecord::LastLap() const
+{
+    return Lap(m_lastLapNumber);
+}
+
+void TimingRecord::Reset()
+{
+    *this = TimingRecord{};
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "LapTimer.h"
+
+namespace TrackGeometry { struct Snapshot; }
+
+// ============================================================================
+// TIMING RECORD - one vehicle's sector, speed trap and pit lane timing
+//
+// Evaluated once per position fix, right after the start/finish line, against
+// the timing lines of the current track (TrackGeometry::Snapshot): each line
+// keeps its own LapTimer, so crossings are interpolated between the bracketing
+// fixes and debounced exactly like start/finish. Results are kept per lap:
+//
+//   - sector times, from start/finish over the Sector lines back to it
+//   - speed at each trap, interpolated between the two fixes' speeds
+//   - MINI_SECTORS equal slices of the lap by progress, for the sector map
+//   - the last pit entry / exit
+//
+// RaceManager opens and closes laps on the start/finish crossings it counts
+// and hands each closed lap to SessionStats, which keeps the bests.
+// g_vehicles_mutex guards it all.
+// ============================================================================
+class TimingRecord
+{
+public:
+    static constexpr int MAX_SECTORS = 8;
+    static constexpr int MAX_TRAPS = 4;
+    static constexpr int MINI_SECTORS = 48;
+
+    struct Splits {
+        int     sectorCount = 0;
+        int64_t lapUs = -1;                   // Set when the lap is closed
+        uint64_t linesVersion = 0;            // Snapshot::timingLinesVersion it was timed against
+        int64_t sectorUs[MAX_SECTORS];        // -1: not timed
+        float   trapKph[MAX_TRAPS];           // -1: not passed
+        float   miniSectors[MINI_SECTORS];    // Seconds, -1: not timed
+
+        Splits();
+    };
+
+    // Every fix, after the start/finish line has been checked
+    void OnFix(const LapTimer::Fix& fix, double speedKph, const TrackGeometry::Snapshot& track);
+
+    // Lap `lapNumber` starts at `timeUs`; whatever was in progress is dropped
+    void StartLap(int lapNumber, int64_t timeUs);
+    // The lap in progress ends at `timeUs` and is kept; the next one starts.
+    // Returns the closed lap, nullptr if none was in progress.
+    const Splits* CloseLap(int64_t timeUs);
+    // No lap in progress (session idle, vehicle finished)
+    void Stop();
+
+    bool InLap() const { return m_inLap; }
+    int LapNumber() const { return m_lapNumber; }
+    int64_t LapStartUs() const { return m_lapStartUs; }
+
+    // Lap in progress: sectors and traps timed so far, and when each sector
+    // boundary was crossed (since the lap start; boundary 0 is the start
+    // itself, -1 until crossed).
+    const Splits& Current() const { return m_current; }
+    int64_t BoundaryUs(int boundary) const;
+
+    // Completed laps (nullptr if not timed)
+    const Splits* Lap(int lapNumber) const;
+    const Splits* LastLap() const;
+
+    bool InPit() const { return m_inPit; }
+    int64_t PitEntryUs() const { return m_pitEntryUs; }
+    int64_t PitExitUs() const { return m_pitExitUs; }
+
+    void Reset();
+
+private:
+    // Mini-sectors: a jump of more than this much progress between fixes is
+    // the matcher catching up (e.g. still 0.99 just after the line), not driving
+    static constexpr double MINI_MAX_STEP = 0.25;
+
+    uint64_t m_linesVersion = 0;       // Snapshot::timingLinesVersion of m_lines
+    std::vector<LapTimer> m_lines;     // One per timing line of the track
+    int m_sectorCount = 1;
+
+    bool m_inLap = false;
+    int m_lapNumber = 0;
+    int64_t m_lapStartUs = 0;
+    int64_t m_boundaryUs[MAX_SECTORS] = {};
+    Splits m_current;
+
+    int m_miniNext = 0;                // Next mini-sector boundary to reach
+    int64_t m_miniBoundaryUs = 0;      // When the previous one was reached
+    double m_miniProgress = 0.0;       // Furthest progress this lap
+    int64_t m_miniProgressUs = 0;
+
+    bool m_hasLastFix = false;
+    int64_t m_lastFixUs = 0;
+    double m_lastSpeedKph = 0.0;
+
+    std::map<int, Splits> m_laps;
+    int m_lastLapNumber = -1;          // Most recently completed
+
+    bool m_inPit = false;
+    int64_t m_pitEntryUs = -1;
+    int64_t m_pitExitUs = -1;
+
+    void UpdateMiniSectors(const LapTimer::Fix& fix);
+};
@@ -1,6 +1,6 @@
 ﻿#include "Interpolation.h"
+#include "../core/Log.h"
 #include <cmath>
-#include <iostream>
 #include <algorithm>
 
 glm::vec2 g_track_render_offset(0.0f, 0.0f);
@@ -345,9 +345,9 @@ TrackCenterInfo calculateTrackCenter(const std::vector<glm::vec2>& points)
 
     resetTrackRenderOffsetIfNoRecenter(info);
     
-    std::cout << "[TRACK CENTER] Calculated center: (" << info.geometric_center.x << ", " << info.geometric_center.y << ")" << std::endl;
-    std::cout << "[TRACK CENTER] Track is " << (info.is_closed ? "CLOSED" : "OPEN") << std::endl;
-    std::cout << "[TRACK CENTER] Offset to apply: (" << info.offset.x << ", " << info.offset.y << ")" << std::endl;
+    LOG_INFO(Track, "[TRACK CENTER] Calculated center: (" << info.geometric_center.x << ", " << info.geometric_center.y << ")");
+    LOG_INFO(Track, "[TRACK CENTER] Track is " << (info.is_closed ? "CLOSED" : "OPEN"));
+    LOG_INFO(Track, "[TRACK CENTER] Offset to apply: (" << info.offset.x << ", " << info.offset.y << ")");
     
     return info;
 }
@@ -4,13 +4,15 @@
 #include "../vehicle/Vehicle.h"
 #include "../input/Input.h"  //  g_is_map_loaded
 #include "../racing/RaceManager.h"  // For RaceManager
-#include <iostream>
+#include "../track/TrackGeometry.h"
+#include "../core/Log.h"
 
 // ============================================================================
 // EXTERNAL GLOBALS 
 // ============================================================================
 extern std::atomic<bool> g_is_map_loaded;       // ?? Input.cpp
 extern std::vector<SplinePoint> g_smooth_track_points;  // ?? main.cpp
+extern std::mutex g_track_mutex;                        // main.cpp
 extern RaceManager* g_race_manager;  // From main.cpp
 
 namespace TrackRenderer
@@ -94,7 +96,7 @@ namespace TrackRenderer
         if (!success)
         {
             glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-            std::cerr << "[START/FINISH] Vertex shader compilation failed:\n" << infoLog << std::endl;
+            LOG_ERROR(Render, "[START/FINISH] Vertex shader compilation failed:\n" << infoLog);
             return 0;
         }
         
@@ -107,7 +109,7 @@ namespace TrackRenderer
         if (!success)
         {
             glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-            std::cerr << "[START/FINISH] Fragment shader compilation failed:\n" << infoLog << std::endl;
+            LOG_ERROR(Render, "[START/FINISH] Fragment shader compilation failed:\n" << infoLog);
             glDeleteShader(vertexShader);
             return 0;
         }
@@ -122,7 +124,7 @@ namespace TrackRenderer
         if (!success)
         {
             glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-            std::cerr << "[START/FINISH] Shader program linking failed:\n" << infoLog << std::endl;
+            LOG_ERROR(Render, "[START/FINISH] Shader program linking failed:\n" << infoLog);
             glDeleteShader(vertexShader);
             glDeleteShader(fragmentShader);
             return 0;
@@ -131,7 +133,7 @@ namespace TrackRenderer
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
         
-        std::cout << "[START/FINISH] Dedicated shader compiled successfully" << std::endl;
+        LOG_INFO(Render, "[START/FINISH] Dedicated shader compiled successfully");
         return shaderProgram;
     }
     
@@ -207,7 +209,8 @@ namespace TrackRenderer
     // PUBLIC FUNCTIONS
     // ============================================================================
     
-    void rebuildTrackCache(const std::vector<glm::vec2>& points, std::mutex& points_mutex)
+    void rebuildTrackCache(const std::vector<glm::vec2>& points, std::mutex& points_mutex,
+        const MapOrigin* origin)
     {
         std::lock_guard<std::mutex> lock(points_mutex);
         
@@ -217,24 +220,26 @@ namespace TrackRenderer
             s_cached_border_layer.clear();
             s_cached_asphalt_layer.clear();
             s_track_cache_valid = false;
+            if (origin)
+                TrackGeometry::PublishOrigin(*origin);   // No track to go with it
             
-            std::cout << "[CACHE] Track cache cleared (no points)" << std::endl;
+            LOG_INFO(Render, "[CACHE] Track cache cleared (no points)");
             return;
         }
         
-        std::cout << "[CACHE] Rebuilding track cache with " << points.size() << " points..." << std::endl;
+        LOG_INFO(Render, "[CACHE] Rebuilding track cache with " << points.size() << " points...");
         
         // ========================================================================
         // STEP 1: Filter noise (??????? ????? ??????? ??????? ??????)
         // ========================================================================
         std::vector<glm::vec2> filteredPoints = filterPointsByDistance(points, 0.01f);
-        std::cout << "[CACHE]   Step 1: Filtered to " << filteredPoints.size() << " points" << std::endl;
+        LOG_DEBUG(Render, "[CACHE]   Step 1: Filtered to " << filteredPoints.size() << " points");
         
         // ========================================================================
         // STEP 2: Simplify path (??????? ??????????? ?? ?????? ????????)
         // ========================================================================
         std::vector<glm::vec2> simplifiedPoints = simplifyPath(filteredPoints, 0.005f);
-        std::cout << "[CACHE]   Step 2: Simplified to " << simplifiedPoints.size() << " points" << std::endl;
+        LOG_DEBUG(Render, "[CACHE]   Step 2: Simplified to " << simplifiedPoints.size() << " points");
         
         // ========================================================================
         // STEP 3: Generate rounded corners (????????? ????)
@@ -244,12 +249,19 @@ namespace TrackRenderer
             TrackConstants::TRACK_CORNER_RADIUS, 
             TrackConstants::TRACK_CORNER_SEGMENTS
         );
-        std::cout << "[CACHE]   Step 3: Interpolated to " << smoothPoints.size() << " smooth points" << std::endl;
+        LOG_DEBUG(Render, "[CACHE]   Step 3: Interpolated to " << smoothPoints.size() << " smooth points");
         
         // ????????? ??? ????????? ?????
-        g_smooth_track_points = smoothPoints;
+        {
+            std::lock_guard<std::mutex> track_lock(g_track_mutex);
+            g_smooth_track_points = smoothPoints;
+        }
+        if (origin)
+            TrackGeometry::Publish(*origin, smoothPoints);
+        else
+            TrackGeometry::PublishPoints(smoothPoints);
         
-        std::cout << "[CACHE]   g_smooth_track_points filled with " << g_smooth_track_points.size() << " points" << std::endl;
+        LOG_DEBUG(Render, "[CACHE]   g_smooth_track_points filled with " << g_smooth_track_points.size() << " points");
         
         // ========================================================================
         // STEP 4: Initialize Start/Finish Line (ONCE per track load)
@@ -262,7 +274,7 @@ namespace TrackRenderer
         s_start_line_shader = compileStartLineShader();
         if (s_start_line_shader == 0)
         {
-            std::cerr << "[START/FINISH] Failed to compile shader!" << std::endl;
+            LOG_ERROR(Render, "[START/FINISH] Failed to compile shader!");
         }
         else
         {
@@ -314,8 +326,8 @@ namespace TrackRenderer
             glBindVertexArray(0);
             
             s_start_line_initialized = true;
-            std::cout << "[START/FINISH] ✓ Line initialized at (" << startPos.x << ", " << startPos.y << ")" << std::endl;
-            std::cout << "[START/FINISH]   Dimensions: width=" << lineWidth << ", length=" << lineLength << std::endl;
+            LOG_INFO(Render, "[START/FINISH] ✓ Line initialized at (" << startPos.x << ", " << startPos.y << ")");
+            LOG_DEBUG(Render, "[START/FINISH]   Dimensions: width=" << lineWidth << ", length=" << lineLength);
             
             // ========================================================================
             // SET RACE MANAGER START/FINISH LINE (for lap timing)
@@ -386,18 +398,21 @@ namespace TrackRenderer
                 s_debug_line.push_back(topCenter + rotated);
             }
             
-            std::cout << "[START/FINISH] Gray line created: " << lineHeight << " high × " << lineThickness << " thick (with rounded caps)" << std::endl;
-            std::cout << "[START/FINISH]   Total vertices: " << s_debug_line.size() << std::endl;
+            LOG_INFO(Render, "[START/FINISH] Gray line created: " << lineHeight << " high × " << lineThickness << " thick (with rounded caps)");
+            LOG_DEBUG(Render, "[START/FINISH]   Total vertices: " << s_debug_line.size());
         }
         
+        // Text tracks carry no timing lines: default sectors
+        TrackGeometry::PublishTimingLines({});
+
         // ========================================================================
         // STEP 5: Generate triangle strips
         // ========================================================================
         s_cached_border_layer = generateTriangleStripFromLine(smoothPoints, TrackConstants::TRACK_BORDER_WIDTH);
         s_cached_asphalt_layer = generateTriangleStripFromLine(smoothPoints, TrackConstants::TRACK_ASPHALT_WIDTH);
         
-        std::cout << "[CACHE]   Step 4: Generated geometry (border: " << s_cached_border_layer.size() 
-                  << ", asphalt: " << s_cached_asphalt_layer.size() << " vertices)" << std::endl;
+        LOG_DEBUG(Render, "[CACHE]   Step 4: Generated geometry (border: " << s_cached_border_layer.size() 
+                  << ", asphalt: " << s_cached_asphalt_layer.size() << " vertices)");
         
         // ========================================================================
         // STEP 5: Upload to GPU (NO vertex attribute setup!)
@@ -409,9 +424,9 @@ namespace TrackRenderer
             glGenVertexArrays(1, &s_track_vao);
             glGenBuffers(1, &s_vbo_border);
             glGenBuffers(1, &s_vbo_asphalt);
-            std::cout << "[CACHE]   Created OpenGL objects (VAO: " << s_track_vao 
+            LOG_DEBUG(Render, "[CACHE]   Created OpenGL objects (VAO: " << s_track_vao 
                       << ", VBO border: " << s_vbo_border 
-                      << ", VBO asphalt: " << s_vbo_asphalt << ")" << std::endl;
+                      << ", VBO asphalt: " << s_vbo_asphalt << ")");
         }
         
         // Upload border data to GPU
@@ -433,10 +448,10 @@ namespace TrackRenderer
         s_track_cache_valid = true;
         g_is_map_loaded = true;
         
-        std::cout << "[CACHE] ? Track uploaded to GPU (STATIC buffers)" << std::endl;
-        std::cout << "[CACHE]   Memory: ~" 
+        LOG_INFO(Render, "[CACHE] ? Track uploaded to GPU (STATIC buffers)");
+        LOG_DEBUG(Render, "[CACHE]   Memory: ~" 
                   << ((s_cached_border_layer.size() + s_cached_asphalt_layer.size()) * sizeof(glm::vec2) / 1024)
-                  << " KB" << std::endl;
+                  << " KB");
     }
 
     void rebuildTrackCacheFromSplinePoints(const std::vector<SplinePoint>& smoothPoints)
@@ -448,14 +463,18 @@ namespace TrackRenderer
             s_track_cache_valid = false;
             g_is_map_loaded = false;
 
-            std::cout << "[CACHE] Track cache cleared (no spline points)" << std::endl;
+            LOG_INFO(Render, "[CACHE] Track cache cleared (no spline points)");
             return;
         }
 
-        std::cout << "[CACHE] Rebuilding track cache from spline points (" << smoothPoints.size() << ")..." << std::endl;
+        LOG_INFO(Render, "[CACHE] Rebuilding track cache from spline points (" << smoothPoints.size() << ")...");
 
         // Keep server-provided geometry/tangents as-is (important for consistent progress + start/finish line)
-        g_smooth_track_points = smoothPoints;
+        {
+            std::lock_guard<std::mutex> track_lock(g_track_mutex);
+            g_smooth_track_points = smoothPoints;
+        }
+        TrackGeometry::PublishPoints(smoothPoints);
 
         // ========================================================================
         // STEP 1: Initialize Start/Finish Line (ONCE per track load)
@@ -465,7 +484,7 @@ namespace TrackRenderer
         s_start_line_shader = compileStartLineShader();
         if (s_start_line_shader == 0)
         {
-            std::cerr << "[START/FINISH] Failed to compile shader!" << std::endl;
+            LOG_ERROR(Render, "[START/FINISH] Failed to compile shader!");
         }
         else
         {
@@ -573,6 +592,8 @@ namespace TrackRenderer
             }
         }
 
+        TrackGeometry::PublishTimingLines({});
+
         // ========================================================================
         // STEP 2: Generate triangle strips + upload to GPU
         // ========================================================================
@@ -584,9 +605,9 @@ namespace TrackRenderer
             glGenVertexArrays(1, &s_track_vao);
             glGenBuffers(1, &s_vbo_border);
             glGenBuffers(1, &s_vbo_asphalt);
-            std::cout << "[CACHE]   Created OpenGL objects (VAO: " << s_track_vao
+            LOG_DEBUG(Render, "[CACHE]   Created OpenGL objects (VAO: " << s_track_vao
                       << ", VBO border: " << s_vbo_border
-                      << ", VBO asphalt: " << s_vbo_asphalt << ")" << std::endl;
+                      << ", VBO asphalt: " << s_vbo_asphalt << ")");
         }
 
         glBindBuffer(GL_ARRAY_BUFFER, s_vbo_border);
@@ -606,7 +627,7 @@ namespace TrackRenderer
         s_track_cache_valid = true;
         g_is_map_loaded = true;
 
-        std::cout << "[CACHE] ✓ Track uploaded to GPU (STATIC buffers, spline source)" << std::endl;
+        LOG_INFO(Render, "[CACHE] ✓ Track uploaded to GPU (STATIC buffers, spline source)");
     }
     
     void renderCachedTrack(GLuint shader_program)
@@ -624,7 +645,7 @@ namespace TrackRenderer
         
         static bool printed = false;
         if (!printed) {
-            std::cout << "[CACHE] ? Rendering from GPU (ZERO CPU->GPU transfer!)" << std::endl;
+            LOG_DEBUG(Render, "[CACHE] ? Rendering from GPU (ZERO CPU->GPU transfer!)");
             printed = true;
         }
         
@@ -731,6 +752,7 @@ namespace TrackRenderer
         s_debug_line.clear();
         s_track_cache_valid = false;
         g_is_map_loaded = false;
+        TrackGeometry::ClearPoints();
         
         // ??????? OpenGL ???????
         if (s_track_vao != 0)
@@ -741,13 +763,13 @@ namespace TrackRenderer
             s_track_vao = 0;
             s_vbo_border = 0;
             s_vbo_asphalt = 0;
-            std::cout << "[CACHE] OpenGL objects deleted" << std::endl;
+            LOG_INFO(Render, "[CACHE] OpenGL objects deleted");
         }
         
         // Clear Start/Finish Line (dedicated shader system)
         clearStartFinishLine();
         
-        std::cout << "[CACHE] Track cache cleared" << std::endl;
+        LOG_INFO(Render, "[CACHE] Track cache cleared");
     }
     
     size_t getBorderVertexCount()
@@ -921,7 +943,21 @@ namespace TrackRenderer
         const std::vector<glm::vec2>& leftIn,
         const std::vector<glm::vec2>& rightIn)
     {
-        if (leftIn.size() < 2 || rightIn.size() < 2) return;
+        rebuildTrackCacheFromEdges(leftIn, rightIn, {});
+    }
+
+    void rebuildTrackCacheFromEdges(
+        const std::vector<glm::vec2>& leftIn,
+        const std::vector<glm::vec2>& rightIn,
+        const std::vector<TrackGeometry::TimingLine>& timingLines,
+        const MapOrigin* origin)
+    {
+        if (leftIn.size() < 2 || rightIn.size() < 2)
+        {
+            if (origin)
+                TrackGeometry::PublishOrigin(*origin);   // No track to go with it
+            return;
+        }
 
         // Compute centroid of the centre line and apply centering offset so the
         // track appears at the screen centre (same behaviour as the TXT-path's
@@ -945,15 +981,32 @@ namespace TrackRenderer
         s_cached_border_layer  = generateTriangleStripFromEdges(bL, bR);
         s_cached_asphalt_layer = generateTriangleStripFromEdges(left, right);
 
-        g_smooth_track_points = interpolatePointsWithTangents(centres, 6);
+        std::vector<SplinePoint> smoothPoints = interpolatePointsWithTangents(centres, 6);
+        {
+            std::lock_guard<std::mutex> track_lock(g_track_mutex);
+            g_smooth_track_points = smoothPoints;
+        }
+        if (origin)
+            TrackGeometry::Publish(*origin, smoothPoints);
+        else
+            TrackGeometry::PublishPoints(smoothPoints);
 
         setupStartFinishFromEdgePoints(left[0], right[0]);
+
+        // Timing lines come in the file's coordinates, like the edges
+        std::vector<TrackGeometry::TimingLine> lines(timingLines);
+        for (TrackGeometry::TimingLine& line : lines) {
+            line.p1 += offset;
+            line.p2 += offset;
+        }
+        TrackGeometry::PublishTimingLines(lines);
+
         uploadEdgeGeometry(s_cached_border_layer, s_cached_asphalt_layer, GL_STATIC_DRAW);
 
         s_track_cache_valid = true;
         g_is_map_loaded     = true;
-        std::cout << "[CACHE] Track (dual-edge) uploaded, centered offset=("
-                  << offset.x << "," << offset.y << ")\n";
+        LOG_INFO(Render, "[CACHE] Track (dual-edge) uploaded, centered offset=("
+                  << offset.x << "," << offset.y << ")");
     }
 
     void rebuildDualEdgePreviewCache(
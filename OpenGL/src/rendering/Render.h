@@ -7,10 +7,15 @@
 
 // Forward declarations
 struct SplinePoint;
+class MapOrigin;
+namespace TrackGeometry { struct TimingLine; }
 
 namespace TrackRenderer
 {
-    void rebuildTrackCache(const std::vector<glm::vec2>& points, std::mutex& points_mutex);
+    // `origin`, if set, is published with the new centre line (a track load
+    // that moved the map origin, see TrackGeometry::Publish).
+    void rebuildTrackCache(const std::vector<glm::vec2>& points, std::mutex& points_mutex,
+        const MapOrigin* origin = nullptr);
 
     // Build GPU cache directly from already-smoothed spline points (e.g. received from server).
     // Must be called from the main thread (OpenGL context thread).
@@ -42,6 +47,15 @@ namespace TrackRenderer
         const std::vector<glm::vec2>& left,
         const std::vector<glm::vec2>& right);
 
+    // Same, with the track's own timing lines (sector boundaries, speed traps,
+    // pit lane), in the edges' coordinates, and the origin they were loaded
+    // with if it is new (published with the centre line, as above).
+    void rebuildTrackCacheFromEdges(
+        const std::vector<glm::vec2>& left,
+        const std::vector<glm::vec2>& right,
+        const std::vector<TrackGeometry::TimingLine>& timingLines,
+        const MapOrigin* origin = nullptr);
+
     // Live preview during right-edge recording: shows the forming track mesh.
     void rebuildDualEdgePreviewCache(
         const std::vector<glm::vec2>& left,
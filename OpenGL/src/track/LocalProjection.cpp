@@ -0,0 +1,234 @@
+#include "LocalProjection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+#include <GeographicLib/UTMUPS.hpp>
+
+#include "../core/Log.h"
+
+namespace
+{
+	constexpr double kPi = 3.14159265358979323846;
+	constexpr double kDegToRad = kPi / 180.0;
+
+	// WGS84 lower bounds on the radii of curvature (meridional at the
+	// equator, prime vertical = equatorial radius), so the lat/lon box built
+	// from them always covers the requested radius.
+	constexpr double kMinMeridionalRadius = 6335439.0;
+	constexpr double kEquatorialRadius = 6378137.0;
+	constexpr double kBoxMargin = 1.05;
+
+	// UTM band; beyond it GeographicLib switches to UPS.
+	constexpr double kMinUtmLatitude = -80.0;
+	constexpr double kMaxUtmLatitude = 84.0;
+
+	// Validation grid: (kValidationSteps + 1)^2 points, edges included.
+	constexpr int kValidationSteps = 24;
+
+	constexpr int kTerms = LocalProjection::kTerms;
+
+	// t[i][p]: coefficient of x^p in the Chebyshev polynomial T_i(x).
+	void chebyshevMonomials(double (&t)[kTerms][kTerms])
+	{
+		for (auto& row : t)
+			std::fill(std::begin(row), std::end(row), 0.0);
+		t[0][0] = 1.0;
+		if (kTerms > 1)
+			t[1][1] = 1.0;
+		for (int i = 2; i < kTerms; ++i)
+		{
+			for (int p = 0; p < kTerms; ++p)
+			{
+				const double shifted = (p > 0) ? t[i - 1][p - 1] : 0.0;
+				t[i][p] = 2.0 * shifted - t[i - 2][p];
+			}
+		}
+	}
+}
+
+LocalProjection::LocalProjection(const MapOrigin& origin, double radiusMeters)
+	: m_radiusMeters(radiusMeters)
+	, m_lat0(origin.m_origin_lat_dd)
+	, m_lon0(origin.m_origin_lon_dd)
+{
+	const int zone = origin.m_origin_zone_int;
+	m_zone = (zone >= 1 && zone <= 60) ? zone : 0;
+
+	m_halfLat = kBoxMargin * radiusMeters / kMinMeridionalRadius / kDegToRad;
+	const double cosLat = std::cos((std::abs(m_lat0) + m_halfLat) * kDegToRad);
+	if (m_zone == 0 || radiusMeters <= 0.0 || cosLat <= 0.0)
+		return;
+	m_halfLon = kBoxMargin * radiusMeters / (kEquatorialRadius * cosLat) / kDegToRad;
+
+	// One hemisphere, one UTM zone numbering, no antimeridian wrap — the
+	// UTM offsets are smooth over the whole box.
+	if (m_lat0 - m_halfLat < kMinUtmLatitude || m_lat0 + m_halfLat > kMaxUtmLatitude)
+		return;
+	if ((m_lat0 - m_halfLat < 0.0) != (m_lat0 + m_halfLat < 0.0))
+		return;
+	if (std::abs(m_lon0) + m_halfLon >= 180.0)
+		return;
+
+	m_invHalfLat = 1.0 / m_halfLat;
+	m_invHalfLon = 1.0 / m_halfLon;
+	if (!forwardExact(m_lat0, m_lon0, m_east0, m_north0))
+		return;
+
+	// Samples at the Chebyshev nodes of both axes.
+	double node[kTerms];
+	double sampleE[kTerms][kTerms];
+	double sampleN[kTerms][kTerms];
+	for (int k = 0; k < kTerms; ++k)
+		node[k] = std::cos(kPi * (k + 0.5) / kTerms);
+	for (int k = 0; k < kTerms; ++k)
+	{
+		for (int l = 0; l < kTerms; ++l)
+		{
+			double e, n;
+			if (!forwardExact(m_lat0 + node[k] * m_halfLat, m_lon0 + node[l] * m_halfLon, e, n))
+				return;
+			sampleE[k][l] = e - m_east0;
+			sampleN[k][l] = n - m_north0;
+		}
+	}
+
+	// Chebyshev coefficients (discrete orthogonality on the nodes).
+	double chebE[kTerms][kTerms] = {};
+	double chebN[kTerms][kTerms] = {};
+	for (int i = 0; i < kTerms; ++i)
+	{
+		for (int j = 0; j < kTerms; ++j)
+		{
+			double sumE = 0.0, sumN = 0.0;
+			for (int k = 0; k < kTerms; ++k)
+			{
+				const double ti = std::cos(i * kPi * (k + 0.5) / kTerms);
+				for (int l = 0; l < kTerms; ++l)
+				{
+					const double w = ti * std::cos(j * kPi * (l + 0.5) / kTerms);
+					sumE += sampleE[k][l] * w;
+					sumN += sampleN[k][l] * w;
+				}
+			}
+			const double scale = (i == 0 ? 1.0 : 2.0) * (j == 0 ? 1.0 : 2.0) / (kTerms * kTerms);
+			chebE[i][j] = sumE * scale;
+			chebN[i][j] = sumN * scale;
+		}
+	}
+
+	// Chebyshev -> monomials, so evaluation is a plain 2-D Horner scheme.
+	double t[kTerms][kTerms];
+	chebyshevMonomials(t);
+	for (int i = 0; i < kTerms; ++i)
+		for (int j = 0; j < kTerms; ++j)
+			for (int p = 0; p <= i; ++p)
+				for (int q = 0; q <= j; ++q)
+				{
+					const double w = t[i][p] * t[j][q];
+					m_eastCoef[p][q] += chebE[i][j] * w;
+					m_northCoef[p][q] += chebN[i][j] * w;
+				}
+
+	// Validate against GeographicLib on a grid that includes the box edges.
+	double maxErr = 0.0;
+	for (int a = 0; a <= kValidationSteps; ++a)
+	{
+		for (int b = 0; b <= kValidationSteps; ++b)
+		{
+			const double lat = m_lat0 + m_halfLat * (2.0 * a / kValidationSteps - 1.0);
+			const double lon = m_lon0 + m_halfLon * (2.0 * b / kValidationSteps - 1.0);
+			double e, n, fe, fn;
+			if (!forwardExact(lat, lon, e, n))
+				return;
+			evaluate(lat, lon, fe, fn);
+			maxErr = std::max(maxErr, std::hypot(fe - e, fn - n));
+		}
+	}
+	m_maxFitError = maxErr;
+	m_valid = maxErr <= kMaxErrorMeters;
+
+	if (m_valid)
+		LOG_INFO(Track, "[PROJECTION] Local fit around (" << m_lat0 << ", " << m_lon0 << ") r="
+		          << radiusMeters << " m, max error " << maxErr * 1000.0 << " mm");
+	else
+		LOG_WARN(Track, "[PROJECTION] Local fit rejected (max error " << maxErr * 1000.0
+		          << " mm) - using GeographicLib for every point");
+}
+
+bool LocalProjection::Contains(double latDeg, double lonDeg) const
+{
+	return m_valid && std::abs(latDeg - m_lat0) <= m_halfLat && std::abs(lonDeg - m_lon0) <= m_halfLon;
+}
+
+inline void LocalProjection::evaluate(double latDeg, double lonDeg, double& easting, double& northing) const
+{
+	const double u = (latDeg - m_lat0) * m_invHalfLat;
+	const double v = (lonDeg - m_lon0) * m_invHalfLon;
+	double e = 0.0, n = 0.0;
+	for (int p = kDegree; p >= 0; --p)
+	{
+		double rowE = 0.0, rowN = 0.0;
+		for (int q = kDegree; q >= 0; --q)
+		{
+			rowE = rowE * v + m_eastCoef[p][q];
+			rowN = rowN * v + m_northCoef[p][q];
+		}
+		e = e * u + rowE;
+		n = n * u + rowN;
+	}
+	easting = m_east0 + e;
+	northing = m_north0 + n;
+}
+
+bool LocalProjection::forwardExact(double latDeg, double lonDeg, double& easting, double& northing) const
+{
+	try {
+		using namespace GeographicLib;
+		int zone;
+		bool northp;
+		if (m_zone != 0)
+			UTMUPS::Forward(latDeg, lonDeg, zone, northp, easting, northing, m_zone);
+		else
+			UTMUPS::Forward(latDeg, lonDeg, zone, northp, easting, northing);
+		return true;
+	}
+	catch (const std::exception& e) {
+		LOG_ERROR(Track, "[COORD ERROR] GeographicLib: " << e.what());
+		LOG_ERROR(Track, "[COORD ERROR] Input: lat=" << latDeg << ", lon=" << lonDeg);
+		easting = 0;
+		northing = 0;
+		return false;
+	}
+}
+
+bool LocalProjection::ToMeters(double latDeg, double lonDeg, double& easting, double& northing) const
+{
+	if (Contains(latDeg, lonDeg))
+	{
+		evaluate(latDeg, lonDeg, easting, northing);
+		return true;
+	}
+	return forwardExact(latDeg, lonDeg, easting, northing);
+}
+
+size_t LocalProjection::ToMetersBatch(const double* latDeg, const double* lonDeg, size_t count,
+	double* easting, double* northing) const
+{
+	if (m_valid)
+	{
+		for (size_t i = 0; i < count; ++i)
+			evaluate(latDeg[i], lonDeg[i], easting[i], northing[i]);
+	}
+
+	size_t fallbacks = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (Contains(latDeg[i], lonDeg[i]))
+			continue;
+		forwardExact(latDeg[i], lonDeg[i], easting[i], northing[i]);
+		++fallbacks;
+	}
+	return fallbacks;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// ============================================================================
+// LocalProjection — fast GPS -> UTM conversion near the map origin.
+//
+// UTMUPS::Forward evaluates the full transverse-Mercator series for every
+// fix, yet all telemetry lies within a few km of the origin. Built once per
+// origin, this object fits the UTM easting/northing offsets from the origin
+// over a lat/lon box covering `radiusMeters` with a small 2-D polynomial
+// (Chebyshev interpolation, stored as monomials) and checks the fit against
+// GeographicLib on a dense grid before enabling it. A fit that misses
+// kMaxErrorMeters anywhere on that grid is discarded.
+//
+// Points outside the fitted box (or every point, if the fit was discarded)
+// go through UTMUPS::Forward in the origin's zone, exactly like
+// coordinatesToMeters().
+// ============================================================================
+
+#include <cstddef>
+
+#include "../input/Input.h"
+
+class LocalProjection
+{
+public:
+	// Worst error accepted from the fit on the validation grid, metres.
+	static constexpr double kMaxErrorMeters = 0.005;
+
+	// Polynomial degree per axis (Chebyshev nodes per axis = kDegree + 1).
+	static constexpr int kDegree = 4;
+	static constexpr int kTerms = kDegree + 1;
+
+	// Invalid projection: every conversion uses GeographicLib.
+	LocalProjection() = default;
+	LocalProjection(const MapOrigin& origin, double radiusMeters);
+
+	// True if the fit passed validation and is used inside the radius.
+	bool IsValid() const { return m_valid; }
+	double RadiusMeters() const { return m_radiusMeters; }
+	double MaxFitErrorMeters() const { return m_maxFitError; }
+
+	bool Contains(double latDeg, double lonDeg) const;
+
+	// UTM metres in the origin's zone. False if GeographicLib failed on a
+	// point outside the radius (outputs are then 0, as in coordinatesToMeters).
+	bool ToMeters(double latDeg, double lonDeg, double& easting, double& northing) const;
+
+	// Converts `count` points. The fitted points are evaluated in one
+	// branch-free pass; the rest fall back one by one. Returns how many
+	// points needed the GeographicLib fallback.
+	size_t ToMetersBatch(const double* latDeg, const double* lonDeg, size_t count,
+		double* easting, double* northing) const;
+
+private:
+	bool forwardExact(double latDeg, double lonDeg, double& easting, double& northing) const;
+	void evaluate(double latDeg, double lonDeg, double& easting, double& northing) const;
+
+	bool m_valid = false;
+	double m_radiusMeters = 0.0;
+	double m_maxFitError = 0.0;
+
+	int m_zone = 0;                 // Origin zone; 0 = let GeographicLib pick
+	double m_lat0 = 0.0, m_lon0 = 0.0;
+	double m_halfLat = 0.0, m_halfLon = 0.0;       // Box half-size, degrees
+	double m_invHalfLat = 0.0, m_invHalfLon = 0.0;
+	double m_east0 = 0.0, m_north0 = 0.0;          // UTM of the box centre
+
+	// Offsets from (m_east0, m_north0): sum of c[p][q] * u^p * v^q with
+	// u = (lat - lat0) / halfLat, v = (lon - lon0) / halfLon.
+	double m_eastCoef[kTerms][kTerms] = {};
+	double m_northCoef[kTerms][kTerms] = {};
+};
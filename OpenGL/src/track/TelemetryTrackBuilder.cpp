@@ -4,6 +4,8 @@
 #include "../input/Input.h"
 #include "../network/Server.h"
 #include "../rendering/Interpolation.h"
+#include "TrackGeometry.h"
+#include "../core/Log.h"
 
 #include <GeographicLib/UTMUPS.hpp>
 
@@ -11,10 +13,8 @@
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
-#include <iostream>
 #include <sstream>
 
-extern MapOrigin g_map_origin;
 extern std::atomic<bool> g_is_map_loaded;
 
 namespace
@@ -48,7 +48,6 @@ namespace
 		if (g_origin_initialized) return;
 		double e = 0.0, n = 0.0;
 		createOriginDD(lat, lon, e, n);
-		g_map_origin.m_map_size = MapConstants::MAP_SIZE;
 		g_is_map_loaded = true;
 		g_origin_initialized = true;
 	}
@@ -81,12 +80,13 @@ namespace
 	// Convert normalized point to GPS DMS and write one line
 	static void writePointDMS(std::ofstream& f, const glm::vec2& p)
 	{
-		double utmE = g_map_origin.m_origin_meters_easting  + (double)p.x * MapConstants::MAP_SIZE;
-		double utmN = g_map_origin.m_origin_meters_northing + (double)p.y * MapConstants::MAP_SIZE;
+		const MapOrigin origin = TrackGeometry::CurrentOrigin();
+		double utmE = origin.m_origin_meters_easting  + (double)p.x * MapConstants::MAP_SIZE;
+		double utmN = origin.m_origin_meters_northing + (double)p.y * MapConstants::MAP_SIZE;
 		double lat = 0.0, lon = 0.0;
 		try {
-			bool northp = g_map_origin.m_origin_zone_char >= 'N';
-			GeographicLib::UTMUPS::Reverse(g_map_origin.m_origin_zone_int, northp, utmE, utmN, lat, lon);
+			bool northp = origin.m_origin_zone_char >= 'N';
+			GeographicLib::UTMUPS::Reverse(origin.m_origin_zone_int, northp, utmE, utmN, lat, lon);
 		} catch (...) { return; }
 
 		auto dms = [](double dd, int& deg, int& min, double& sec) {
@@ -131,7 +131,7 @@ namespace
 			f << "#start_norm " << g_points.front().x << ' ' << g_points.front().y << '\n';
 		for (const auto& p : g_points) writePointDMS(f, p);
 
-		std::cout << "[TRACK-BUILD] Saved centre-line track to: " << abs << '\n';
+		LOG_INFO(Track, "[TRACK-BUILD] Saved centre-line track to: " << abs);
 		return true;
 	}
 
@@ -152,15 +152,16 @@ namespace
 		std::ofstream f(p, std::ios::binary);
 		if (!f) return false;
 
+		const MapOrigin origin = TrackGeometry::CurrentOrigin();
 		Trk2FileHeader h;
 		memcpy(h.magic, "TRK2", 4);
 		h.version           = 2;
-		h.origin_easting    = g_map_origin.m_origin_meters_easting;
-		h.origin_northing   = g_map_origin.m_origin_meters_northing;
-		h.origin_zone       = g_map_origin.m_origin_zone_int;
-		h.origin_zone_char  = g_map_origin.m_origin_zone_char;
+		h.origin_easting    = origin.m_origin_meters_easting;
+		h.origin_northing   = origin.m_origin_meters_northing;
+		h.origin_zone       = origin.m_origin_zone_int;
+		h.origin_zone_char  = origin.m_origin_zone_char;
 		memset(h.pad, 0, 3);
-		h.map_size          = g_map_origin.m_map_size;
+		h.map_size          = origin.m_map_size;
 		h.left_count        = (uint32_t)g_left_points.size();
 		h.right_count       = (uint32_t)g_points.size();
 
@@ -170,7 +171,7 @@ namespace
 
 		std::string absStr; std::error_code ec;
 		absStr = fs::absolute(p, ec).string();
-		std::cout << "[TRACK-BUILD] Saved .trk2 to: " << absStr << '\n';
+		LOG_INFO(Track, "[TRACK-BUILD] Saved .trk2 to: " << absStr);
 		return true;
 	}
 
@@ -185,14 +186,16 @@ namespace
 		if (info.is_closed)
 		{
 			recenterTrack(g_points, info);
-			g_map_origin.m_origin_meters_easting  -= info.offset.x * MapConstants::MAP_SIZE;
-			g_map_origin.m_origin_meters_northing -= info.offset.y * MapConstants::MAP_SIZE;
+			MapOrigin origin = TrackGeometry::CurrentOrigin();
+			origin.m_origin_meters_easting  -= info.offset.x * MapConstants::MAP_SIZE;
+			origin.m_origin_meters_northing -= info.offset.y * MapConstants::MAP_SIZE;
 			try {
-				bool northp = g_map_origin.m_origin_zone_char >= 'N';
-				GeographicLib::UTMUPS::Reverse(g_map_origin.m_origin_zone_int, northp,
-					g_map_origin.m_origin_meters_easting, g_map_origin.m_origin_meters_northing,
-					g_map_origin.m_origin_lat_dd, g_map_origin.m_origin_lon_dd);
+				bool northp = origin.m_origin_zone_char >= 'N';
+				GeographicLib::UTMUPS::Reverse(origin.m_origin_zone_int, northp,
+					origin.m_origin_meters_easting, origin.m_origin_meters_northing,
+					origin.m_origin_lat_dd, origin.m_origin_lon_dd);
 			} catch (...) {}
+			TrackGeometry::PublishOrigin(origin);
 		}
 		rebuildSmoothLocked();
 		g_finalized = true;
@@ -0,0 +1,216 @@
+#include "TrackGeometry.h"
+
+#include "../Config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+namespace
+{
+	using TrackGeometry::Snapshot;
+	using TrackGeometry::SnapshotPtr;
+
+	// Writers are serialized so read-modify-publish (e.g. keep the origin,
+	// replace the points) never loses a concurrent update. Readers only do
+	// an atomic_load and never touch this mutex.
+	std::mutex g_publish_mutex;
+	uint64_t g_version = 0;
+
+	SnapshotPtr& currentSlot()
+	{
+		static SnapshotPtr s_current = std::make_shared<const Snapshot>();
+		return s_current;
+	}
+
+	void fillDerivedFields(Snapshot& s)
+	{
+		s.cumulative.clear();
+		s.openLength = 0.0f;
+		s.loopLength = 0.0f;
+		s.boundsMin = glm::vec2(0.0f);
+		s.boundsMax = glm::vec2(0.0f);
+		s.segmentIndex.Clear();
+
+		const size_t n = s.points.size();
+		if (n == 0)
+			return;
+
+		s.cumulative.reserve(n);
+		s.cumulative.push_back(0.0f);
+		s.boundsMin = s.boundsMax = s.points[0].position;
+
+		float total = 0.0f;
+		for (size_t i = 1; i < n; ++i)
+		{
+			const glm::vec2 p = s.points[i].position;
+			total += glm::distance(s.points[i - 1].position, p);
+			s.cumulative.push_back(total);
+			s.boundsMin = glm::min(s.boundsMin, p);
+			s.boundsMax = glm::max(s.boundsMax, p);
+		}
+
+		s.openLength = total;
+		s.loopLength = (n >= 2) ? total + glm::distance(s.points[n - 1].position, s.points[0].position) : 0.0f;
+
+		s.segmentIndex.Build(s.points);
+	}
+
+	// Where a timing line meets the centre line (progress of its midpoint's
+	// projection, as matchTrackProgress measures it) and the direction of
+	// travel there.
+	void placeTimingLine(const Snapshot& s, TrackGeometry::TimingLine& line)
+	{
+		const TrackSpatialIndex::Hit hit = s.segmentIndex.Nearest((line.p1 + line.p2) * 0.5f);
+		if (!hit.found || s.openLength <= 1e-6f)
+			return;
+
+		const float arc = s.cumulative[hit.segment] + hit.segmentLength * hit.t;
+		line.progress = std::clamp(arc / s.openLength, 0.0f, 1.0f);
+		line.forward = s.points[hit.segment + 1].position - s.points[hit.segment].position;
+	}
+
+	// Line square to the centre line at `progress`, `halfWidth` to each side.
+	TrackGeometry::TimingLine lineAtProgress(const Snapshot& s, float progress, float halfWidth)
+	{
+		const float arc = progress * s.openLength;
+		const size_t last = s.points.size() - 2;
+		const size_t i = std::min(last, static_cast<size_t>(
+			std::upper_bound(s.cumulative.begin(), s.cumulative.end(), arc) - s.cumulative.begin() - 1));
+
+		const glm::vec2 a = s.points[i].position;
+		const glm::vec2 b = s.points[i + 1].position;
+		const float length = s.cumulative[i + 1] - s.cumulative[i];
+		const float t = (length > 1e-9f) ? std::clamp((arc - s.cumulative[i]) / length, 0.0f, 1.0f) : 0.0f;
+		const glm::vec2 centre = a + (b - a) * t;
+		const glm::vec2 direction = (length > 1e-9f) ? (b - a) / length : glm::vec2(1.0f, 0.0f);
+		const glm::vec2 across(-direction.y, direction.x);
+
+		TrackGeometry::TimingLine line;
+		line.p1 = centre - across * halfWidth;
+		line.p2 = centre + across * halfWidth;
+		line.forward = direction;
+		line.progress = progress;
+		return line;
+	}
+
+	// Called with g_publish_mutex held. `linesChanged`: the centre line or
+	// the timing lines were replaced (bumps timingLinesVersion).
+	void publishLocked(std::shared_ptr<Snapshot> next, bool linesChanged = false)
+	{
+		next->version = ++g_version;
+		if (linesChanged)
+			next->timingLinesVersion = next->version;
+		std::atomic_store(&currentSlot(), SnapshotPtr(std::move(next)));
+	}
+}
+
+namespace TrackGeometry
+{
+	SnapshotPtr Current()
+	{
+		return std::atomic_load(&currentSlot());
+	}
+
+	MapOrigin CurrentOrigin()
+	{
+		return Current()->origin;
+	}
+
+	void PublishPoints(const std::vector<SplinePoint>& points)
+	{
+		// Build outside the lock — this is the only O(n) part.
+		auto next = std::make_shared<Snapshot>();
+		next->points = points;
+		fillDerivedFields(*next);
+
+		std::lock_guard<std::mutex> lock(g_publish_mutex);
+		const SnapshotPtr current = Current();
+		next->origin = current->origin;
+		next->projection = current->projection;
+		publishLocked(std::move(next), true);
+	}
+
+	void Publish(const MapOrigin& origin, const std::vector<SplinePoint>& points)
+	{
+		// Fit and derived fields outside the lock, as in PublishOrigin and
+		// PublishPoints.
+		auto next = std::make_shared<Snapshot>();
+		next->points = points;
+		fillDerivedFields(*next);
+		next->origin = origin;
+		next->projection = std::make_shared<const LocalProjection>(origin, MapConstants::LOCAL_PROJECTION_RADIUS_M);
+
+		std::lock_guard<std::mutex> lock(g_publish_mutex);
+		publishLocked(std::move(next), true);
+	}
+
+	void PublishStartFinish(const glm::vec2& p1, const glm::vec2& p2)
+	{
+		std::lock_guard<std::mutex> lock(g_publish_mutex);
+		auto next = std::make_shared<Snapshot>(*Current());
+		next->hasStartFinish = true;
+		next->startFinishP1 = p1;
+		next->startFinishP2 = p2;
+		publishLocked(std::move(next));
+	}
+
+	void PublishTimingLines(const std::vector<TimingLine>& lines)
+	{
+		std::lock_guard<std::mutex> lock(g_publish_mutex);
+		auto next = std::make_shared<Snapshot>(*Current());
+		next->timingLines = lines;
+		next->sectorCount = 1;
+		if (!next->HasTrack())
+		{
+			next->timingLines.clear();
+			publishLocked(std::move(next), true);
+			return;
+		}
+
+		for (TimingLine& line : next->timingLines)
+		{
+			placeTimingLine(*next, line);
+			if (line.kind == TimingLine::Kind::Sector)
+				++next->sectorCount;
+		}
+
+		// Default sectors: thirds of the lap, as wide as the start/finish line
+		if (next->sectorCount == 1)
+		{
+			const float halfWidth = next->hasStartFinish
+				? 0.5f * glm::distance(next->startFinishP1, next->startFinishP2)
+				: 0.5f * TrackConstants::TRACK_ASPHALT_WIDTH;
+			next->timingLines.push_back(lineAtProgress(*next, 1.0f / 3.0f, halfWidth));
+			next->timingLines.push_back(lineAtProgress(*next, 2.0f / 3.0f, halfWidth));
+			next->sectorCount = 3;
+		}
+
+		std::stable_sort(next->timingLines.begin(), next->timingLines.end(),
+			[](const TimingLine& a, const TimingLine& b) { return a.progress < b.progress; });
+		publishLocked(std::move(next), true);
+	}
+
+	void PublishOrigin(const MapOrigin& origin)
+	{
+		// The fit (a few hundred GeographicLib calls) is built outside the lock.
+		auto projection = std::make_shared<const LocalProjection>(origin, MapConstants::LOCAL_PROJECTION_RADIUS_M);
+
+		std::lock_guard<std::mutex> lock(g_publish_mutex);
+		auto next = std::make_shared<Snapshot>(*Current());
+		next->origin = origin;
+		next->projection = std::move(projection);
+		publishLocked(std::move(next));
+	}
+
+	void ClearPoints()
+	{
+		std::lock_guard<std::mutex> lock(g_publish_mutex);
+		const SnapshotPtr current = Current();
+		auto next = std::make_shared<Snapshot>();
+		next->origin = current->origin;
+		next->projection = current->projection;
+		publishLocked(std::move(next), true);
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+// ============================================================================
+// TrackGeometry — immutable, reference-counted snapshot of the loaded track.
+//
+// Writers (TrackRenderer::rebuildTrackCache*, track file / track server
+// loaders, origin calibration) build a new Snapshot and swap it in atomically.
+// Readers (telemetry ingest, TimeDiff, PRO panels) take one pointer per call
+// or per frame and read it without locks or copies — a published Snapshot is
+// never modified, so it stays valid for as long as the reader holds it.
+//
+// The Snapshot also owns the map origin: UTM <-> normalized conversion on the
+// ingest threads must use the origin that belongs to the points it is matched
+// against. A track load that sets a new origin publishes it with the new
+// centre line in one Snapshot (Publish); PublishOrigin alone keeps the points
+// and is for calibrating the origin against the track already published.
+// ============================================================================
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../input/Input.h"
+#include "../rendering/Interpolation.h"
+#include "LocalProjection.h"
+#include "TrackSpatialIndex.h"
+
+namespace TrackGeometry
+{
+	// A timing line laid across the track: an official sector boundary, a
+	// speed trap or the pit lane entry/exit. Like the start/finish line it is
+	// a segment in track space, crossed by the vehicles' own positions.
+	struct TimingLine
+	{
+		enum class Kind : uint8_t { Sector, SpeedTrap, PitEntry, PitExit };
+
+		Kind kind = Kind::Sector;
+		glm::vec2 p1{ 0.0f, 0.0f };
+		glm::vec2 p2{ 0.0f, 0.0f };
+		std::string name;
+
+		// Filled in on publish from the centre line
+		glm::vec2 forward{ 0.0f, 0.0f };   // Direction of travel over the line
+		float progress = 0.0f;             // Where it meets the centre line, 0..1
+	};
+
+	struct Snapshot
+	{
+		// Smoothed centre line in track space (normalized units, render offset
+		// already baked in — same data as g_smooth_track_points).
+		std::vector<SplinePoint> points;
+
+		// Arc length from points[0] to points[i], normalized units.
+		std::vector<float> cumulative;
+		float openLength = 0.0f;   // points[0] -> points[n-1]
+		float loopLength = 0.0f;   // openLength + closing segment back to points[0]
+
+		// Grid over the segments for nearest-segment / distance queries.
+		TrackSpatialIndex segmentIndex;
+
+		glm::vec2 boundsMin{ 0.0f, 0.0f };
+		glm::vec2 boundsMax{ 0.0f, 0.0f };
+
+		bool hasStartFinish = false;
+		glm::vec2 startFinishP1{ 0.0f, 0.0f };
+		glm::vec2 startFinishP2{ 0.0f, 0.0f };
+
+		// Sorted by progress. The Sector lines split the lap into sectorCount
+		// sectors; start/finish opens the first and closes the last.
+		std::vector<TimingLine> timingLines;
+		int sectorCount = 1;
+
+		MapOrigin origin{};
+
+		// GPS -> UTM conversion fitted around `origin` (null until an origin
+		// is published). Shared between snapshots with the same origin.
+		std::shared_ptr<const LocalProjection> projection;
+
+		// Incremented on every publish; lets consumers detect a new track.
+		uint64_t version = 0;
+
+		// The `version` that last replaced the centre line or the timing
+		// lines (origin and start/finish publishes keep it). Timing state
+		// keyed on it survives an origin recalibration.
+		uint64_t timingLinesVersion = 0;
+
+		bool HasTrack() const { return points.size() >= 2; }
+	};
+
+	using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+	// Never null (an empty Snapshot is published at startup).
+	SnapshotPtr Current();
+	MapOrigin CurrentOrigin();
+
+	// Replaces the centre line. Origin is kept, start/finish is reset (the
+	// caller publishes the new line right after via PublishStartFinish).
+	void PublishPoints(const std::vector<SplinePoint>& points);
+	// Same, together with the origin the points were converted against: a
+	// reader sees the old track or the new one, never one's origin with the
+	// other's points.
+	void Publish(const MapOrigin& origin, const std::vector<SplinePoint>& points);
+	void PublishStartFinish(const glm::vec2& p1, const glm::vec2& p2);
+
+	// Replaces the timing lines (track space; call after PublishPoints, which
+	// clears them). A track that defines no sector boundary gets the default
+	// ones, at a third and two thirds of the lap.
+	void PublishTimingLines(const std::vector<TimingLine>& lines);
+	void PublishOrigin(const MapOrigin& origin);
+	void ClearPoints();
+}
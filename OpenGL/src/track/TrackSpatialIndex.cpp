@@ -0,0 +1,302 @@
+#include "TrackSpatialIndex.h"
+
+#include "../rendering/Interpolation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Same threshold the linear scans used to skip duplicate spline points.
+	constexpr float kMinSegmentLenSq = 1e-10f;
+
+	// Upper bound on grid cells per indexed segment — keeps memory linear in
+	// the track size even for very dense tracks in a large bounding box.
+	constexpr float kMaxCellsPerSegment = 4.0f;
+
+	// Cell coordinates of far-away query points are clamped to this range so
+	// the float -> int conversion cannot overflow.
+	constexpr float kMaxCellCoord = 1.0e7f;
+}
+
+void TrackSpatialIndex::Clear()
+{
+	m_min = m_max = glm::vec2(0.0f);
+	m_cellSize = 1.0f;
+	m_cols = m_rows = 0;
+	m_cellStart.clear();
+	m_cellSegments.clear();
+	m_segA.clear();
+	m_segAB.clear();
+	m_segLenSq.clear();
+}
+
+void TrackSpatialIndex::Build(const std::vector<SplinePoint>& points)
+{
+	Clear();
+	if (points.size() < 2)
+		return;
+
+	const size_t segCount = points.size() - 1;
+	m_segA.resize(segCount);
+	m_segAB.resize(segCount);
+	m_segLenSq.resize(segCount);
+
+	m_min = m_max = points[0].position;
+	float totalLen = 0.0f;
+	size_t validCount = 0;
+	for (size_t i = 0; i < segCount; ++i)
+	{
+		const glm::vec2 a = points[i].position;
+		const glm::vec2 b = points[i + 1].position;
+		m_segA[i] = a;
+		m_segAB[i] = b - a;
+		m_segLenSq[i] = glm::dot(m_segAB[i], m_segAB[i]);
+		m_min = glm::min(m_min, b);
+		m_max = glm::max(m_max, b);
+		if (m_segLenSq[i] >= kMinSegmentLenSq)
+		{
+			totalLen += std::sqrt(m_segLenSq[i]);
+			++validCount;
+		}
+	}
+
+	if (validCount == 0)
+	{
+		Clear();
+		return;
+	}
+
+	// Cell size: ~2 average segments per cell along the line, but never so
+	// small that the grid outgrows kMaxCellsPerSegment * segments.
+	const glm::vec2 extent = glm::max(m_max - m_min, glm::vec2(1e-6f));
+	const float avgLen = totalLen / static_cast<float>(validCount);
+	const float minCellForArea = std::sqrt(extent.x * extent.y / (kMaxCellsPerSegment * static_cast<float>(validCount)));
+	m_cellSize = std::max({ avgLen * 2.0f, minCellForArea, 1e-6f });
+	m_cols = static_cast<int>(extent.x / m_cellSize) + 1;
+	m_rows = static_cast<int>(extent.y / m_cellSize) + 1;
+
+	const size_t cellCount = static_cast<size_t>(m_cols) * static_cast<size_t>(m_rows);
+	auto cellRange = [&](size_t seg, int& x0, int& y0, int& x1, int& y1) {
+		const glm::vec2 a = m_segA[seg];
+		const glm::vec2 b = a + m_segAB[seg];
+		const glm::vec2 lo = (glm::min(a, b) - m_min) / m_cellSize;
+		const glm::vec2 hi = (glm::max(a, b) - m_min) / m_cellSize;
+		x0 = std::clamp(static_cast<int>(lo.x), 0, m_cols - 1);
+		y0 = std::clamp(static_cast<int>(lo.y), 0, m_rows - 1);
+		x1 = std::clamp(static_cast<int>(hi.x), 0, m_cols - 1);
+		y1 = std::clamp(static_cast<int>(hi.y), 0, m_rows - 1);
+	};
+
+	// Pass 1: count segments per cell (segment AABB, conservative).
+	m_cellStart.assign(cellCount + 1, 0);
+	for (size_t s = 0; s < segCount; ++s)
+	{
+		if (m_segLenSq[s] < kMinSegmentLenSq)
+			continue;
+		int x0, y0, x1, y1;
+		cellRange(s, x0, y0, x1, y1);
+		for (int y = y0; y <= y1; ++y)
+			for (int x = x0; x <= x1; ++x)
+				++m_cellStart[static_cast<size_t>(y) * m_cols + x + 1];
+	}
+	for (size_t c = 0; c < cellCount; ++c)
+		m_cellStart[c + 1] += m_cellStart[c];
+
+	// Pass 2: fill.
+	m_cellSegments.resize(m_cellStart[cellCount]);
+	std::vector<uint32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+	for (size_t s = 0; s < segCount; ++s)
+	{
+		if (m_segLenSq[s] < kMinSegmentLenSq)
+			continue;
+		int x0, y0, x1, y1;
+		cellRange(s, x0, y0, x1, y1);
+		for (int y = y0; y <= y1; ++y)
+			for (int x = x0; x <= x1; ++x)
+				m_cellSegments[cursor[static_cast<size_t>(y) * m_cols + x]++] = static_cast<uint32_t>(s);
+	}
+}
+
+void TrackSpatialIndex::testSegment(uint32_t seg, const glm::vec2& p, Hit& best) const
+{
+	const glm::vec2 a = m_segA[seg];
+	const glm::vec2 ab = m_segAB[seg];
+	const float abLenSq = m_segLenSq[seg];
+
+	const float t = glm::clamp(glm::dot(p - a, ab) / abLenSq, 0.0f, 1.0f);
+	const glm::vec2 proj = a + ab * t;
+	const glm::vec2 d = p - proj;
+	const float distSq = glm::dot(d, d);
+
+	// Ties go to the lower segment index, like the old front-to-back scan.
+	if (distSq < best.distSq || (distSq == best.distSq && seg < best.segment))
+	{
+		best.found = true;
+		best.segment = seg;
+		best.t = t;
+		best.segmentLength = std::sqrt(abLenSq);
+		best.distSq = distSq;
+		best.closest = proj;
+	}
+}
+
+// Visits cells in square rings around the cell containing p (which may lie
+// outside the grid). Every cell at ring r+1 or further is at least r*cellSize
+// away from p, so the walk stops once that bound exceeds the current search
+// radius. Ring sides (and single cells) whose rectangle is already farther
+// than the search radius are skipped without touching their segments, which
+// keeps queries from points well off the track at O(rings) instead of
+// O(cells). `visit(cell)` returns the new squared search radius, or a
+// negative value to stop immediately.
+template <typename Visit>
+void TrackSpatialIndex::walkRings(const glm::vec2& p, float maxDist, Visit&& visit) const
+{
+	if (Empty())
+		return;
+
+	const glm::vec2 rel = glm::clamp((p - m_min) / m_cellSize, glm::vec2(-kMaxCellCoord), glm::vec2(kMaxCellCoord));
+	const int pcx = static_cast<int>(std::floor(rel.x));
+	const int pcy = static_cast<int>(std::floor(rel.y));
+
+	// First ring that touches the grid, and the ring that covers all of it.
+	const int dx = (pcx < 0) ? -pcx : (pcx >= m_cols ? pcx - (m_cols - 1) : 0);
+	const int dy = (pcy < 0) ? -pcy : (pcy >= m_rows ? pcy - (m_rows - 1) : 0);
+	const int firstRing = std::max(dx, dy);
+	const int lastRing = std::max({ std::abs(pcx), std::abs(pcx - (m_cols - 1)),
+	                                std::abs(pcy), std::abs(pcy - (m_rows - 1)) });
+
+	float limitSq = maxDist * maxDist;
+	bool stop = false;
+
+	// Squared distance from p to the cell block [x0..x1] x [y0..y1].
+	auto blockDistSq = [&](int x0, int y0, int x1, int y1) {
+		const glm::vec2 lo = m_min + glm::vec2(static_cast<float>(x0), static_cast<float>(y0)) * m_cellSize;
+		const glm::vec2 hi = m_min + glm::vec2(static_cast<float>(x1 + 1), static_cast<float>(y1 + 1)) * m_cellSize;
+		const glm::vec2 d = glm::max(glm::max(lo - p, p - hi), glm::vec2(0.0f));
+		return glm::dot(d, d);
+	};
+	auto visitCell = [&](int x, int y) {
+		const size_t cell = static_cast<size_t>(y) * m_cols + x;
+		if (m_cellStart[cell] == m_cellStart[cell + 1] || blockDistSq(x, y, x, y) > limitSq) return;
+		const float next = visit(cell);
+		if (next < 0.0f) stop = true;
+		else             limitSq = next;
+	};
+	auto visitRow = [&](int y, int x0, int x1) {
+		if (y < 0 || y >= m_rows) return;
+		x0 = std::max(x0, 0);
+		x1 = std::min(x1, m_cols - 1);
+		if (x0 > x1 || blockDistSq(x0, y, x1, y) > limitSq) return;
+		for (int x = x0; x <= x1 && !stop; ++x) visitCell(x, y);
+	};
+	auto visitCol = [&](int x, int y0, int y1) {
+		if (x < 0 || x >= m_cols) return;
+		y0 = std::max(y0, 0);
+		y1 = std::min(y1, m_rows - 1);
+		if (y0 > y1 || blockDistSq(x, y0, x, y1) > limitSq) return;
+		for (int y = y0; y <= y1 && !stop; ++y) visitCell(x, y);
+	};
+
+	for (int r = firstRing; r <= lastRing && !stop; ++r)
+	{
+		if (r > 0)
+		{
+			const float reach = static_cast<float>(r - 1) * m_cellSize;
+			if (reach * reach > limitSq)
+				return;
+		}
+
+		if (r == 0)
+		{
+			visitCell(pcx, pcy);
+			continue;
+		}
+		visitRow(pcy - r, pcx - r, pcx + r);
+		visitRow(pcy + r, pcx - r, pcx + r);
+		visitCol(pcx - r, pcy - r + 1, pcy + r - 1);
+		visitCol(pcx + r, pcy - r + 1, pcy + r - 1);
+	}
+}
+
+TrackSpatialIndex::Hit TrackSpatialIndex::Nearest(const glm::vec2& p) const
+{
+	return NearestWithin(p, std::numeric_limits<float>::infinity());
+}
+
+TrackSpatialIndex::Hit TrackSpatialIndex::NearestWithin(const glm::vec2& p, float maxDist) const
+{
+	Hit best;
+	const float maxDistSq = maxDist * maxDist;
+	walkRings(p, maxDist, [&](size_t cell) {
+		for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+			testSegment(m_cellSegments[i], p, best);
+		return std::min(best.distSq, maxDistSq);
+	});
+
+	if (best.found && best.distSq > maxDistSq)
+		return Hit{};
+	return best;
+}
+
+TrackSpatialIndex::Hit TrackSpatialIndex::NearestAround(const glm::vec2& p, size_t hintSegment, float backLength, float aheadLength) const
+{
+	Hit best;
+	const size_t n = m_segA.size();
+	if (hintSegment >= n)
+		return best;
+
+	// Forward from the hint (inclusive) until aheadLength is covered.
+	size_t seg = hintSegment;
+	float covered = 0.0f;
+	for (size_t k = 0; k < n; ++k)
+	{
+		if (m_segLenSq[seg] >= kMinSegmentLenSq)
+		{
+			testSegment(static_cast<uint32_t>(seg), p, best);
+			covered += std::sqrt(m_segLenSq[seg]);
+		}
+		if (covered > aheadLength)
+			break;
+		seg = (seg + 1 == n) ? 0 : seg + 1;
+	}
+
+	// Backward from the segment before the hint.
+	seg = hintSegment;
+	covered = 0.0f;
+	for (size_t k = 1; k < n; ++k)
+	{
+		seg = (seg == 0) ? n - 1 : seg - 1;
+		if (m_segLenSq[seg] >= kMinSegmentLenSq)
+		{
+			testSegment(static_cast<uint32_t>(seg), p, best);
+			covered += std::sqrt(m_segLenSq[seg]);
+		}
+		if (covered > backLength)
+			break;
+	}
+	return best;
+}
+
+bool TrackSpatialIndex::IsWithin(const glm::vec2& p, float radius) const
+{
+	const float radiusSq = radius * radius;
+	bool hit = false;
+	walkRings(p, radius, [&](size_t cell) {
+		for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+		{
+			const uint32_t seg = m_cellSegments[i];
+			const glm::vec2 a = m_segA[seg];
+			const glm::vec2 ab = m_segAB[seg];
+			const float t = glm::clamp(glm::dot(p - a, ab) / m_segLenSq[seg], 0.0f, 1.0f);
+			const glm::vec2 d = p - (a + ab * t);
+			if (glm::dot(d, d) <= radiusSq)
+			{
+				hit = true;
+				return -1.0f;
+			}
+		}
+		return radiusSq;
+	});
+	return hit;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+// ============================================================================
+// TrackSpatialIndex — uniform grid over the segments of the track centre line.
+//
+// Built once per track (TrackGeometry builds it when points are published) and
+// read concurrently afterwards; all queries are const and allocation-free.
+// Only the open polyline points[i] -> points[i+1] is indexed, matching the
+// progress projection used for lap timing (the closing segment is excluded).
+//
+// Queries walk rings of cells outward from the query point and stop as soon as
+// no unvisited cell can hold a closer segment, so a car on (or near) the
+// track touches a handful of cells regardless of how many points the track has.
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct SplinePoint;
+
+class TrackSpatialIndex
+{
+public:
+	struct Hit
+	{
+		bool found = false;
+		size_t segment = 0;        // points[segment] -> points[segment + 1]
+		float t = 0.0f;            // 0..1 along the segment
+		float segmentLength = 0.0f;
+		float distSq = std::numeric_limits<float>::infinity();
+		glm::vec2 closest{ 0.0f, 0.0f };
+	};
+
+	void Build(const std::vector<SplinePoint>& points);
+	void Clear();
+	bool Empty() const { return m_segA.empty(); }
+
+	// Closest point on the centre line (normalized units).
+	Hit Nearest(const glm::vec2& p) const;
+
+	// Closest point, but only among segments whose distance can be <= maxDist.
+	// Returns found=false if nothing is that close.
+	Hit NearestWithin(const glm::vec2& p, float maxDist) const;
+
+	// True if any segment is within `radius` of p (early-out on first hit).
+	bool IsWithin(const glm::vec2& p, float radius) const;
+
+	// Closest point among the segments within `backLength` behind and
+	// `aheadLength` ahead of `hintSegment` along the line (arc length,
+	// normalized units). Wraps past either end of the polyline, so a hint near
+	// the start/finish also covers the other side of the line. Cost is linear
+	// in the window, independent of the grid.
+	Hit NearestAround(const glm::vec2& p, size_t hintSegment, float backLength, float aheadLength) const;
+
+private:
+	template <typename Visit>
+	void walkRings(const glm::vec2& p, float maxDist, Visit&& visit) const;
+
+	void testSegment(uint32_t seg, const glm::vec2& p, Hit& best) const;
+
+	glm::vec2 m_min{ 0.0f, 0.0f };
+	glm::vec2 m_max{ 0.0f, 0.0f };
+	float m_cellSize = 1.0f;
+	int m_cols = 0;
+	int m_rows = 0;
+
+	// CSR layout: segments of cell c are m_cellSegments[m_cellStart[c] .. m_cellStart[c+1]).
+	std::vector<uint32_t> m_cellStart;
+	std::vector<uint32_t> m_cellSegments;
+
+	// Per-segment data (index = segment id, degenerate segments are not inserted).
+	std::vector<glm::vec2> m_segA;
+	std::vector<glm::vec2> m_segAB;
+	std::vector<float> m_segLenSq;
+};
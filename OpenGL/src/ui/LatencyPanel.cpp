@@ -0,0 +1,181 @@
+#include "LatencyPanel.h"
+
+#include <string>
+#include <vector>
+
+#include <imgui/imgui.h>
+
+#include "../network/ServerClock.h"
+#include "../network/TelemetryLatency.h"
+#include "../vehicle/VehicleInterpolator.h"
+
+namespace LatencyPanel {
+namespace {
+
+bool s_open = false;
+std::string s_last_csv;     // Path of the last Save CSV, shown under the buttons
+std::vector<VehiclePlayoutStats> s_playout;     // Reused between frames
+
+// Latency in ms with a precision that still shows sub-ms stages.
+void cellMs(double us)
+{
+    ImGui::TableNextColumn();
+    if (us < 1000.0)
+        ImGui::Text("%.3f", us / 1000.0);
+    else
+        ImGui::Text("%.1f", us / 1000.0);
+}
+
+} // namespace
+
+void Toggle()
+{
+    s_open = !s_open;
+}
+
+bool IsOpen()
+{
+    return s_open;
+}
+
+void Render(ImFont* font)
+{
+    if (!s_open)
+        return;
+
+    const ImVec4 colGold(218.f/255.f, 165.f/255.f, 64.f/255.f, 1.f);
+    const ImVec4 colDim (0.70f, 0.70f, 0.70f, 1.f);
+
+    ImGui::SetNextWindowSize(ImVec2(560.f, 0.f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.92f);
+    if (font) ImGui::PushFont(font);
+    if (ImGui::Begin("Telemetry latency", &s_open, ImGuiWindowFlags_NoSavedSettings))
+    {
+        if (ImGui::SmallButton("Reset"))
+        {
+            TelemetryLatency::reset();
+            VehicleInterpolator::Get().ResetPlayoutCounters();
+            s_last_csv.clear();
+        }
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Save CSV"))
+        {
+            s_last_csv = TelemetryLatency::saveCsv();
+            if (s_last_csv.empty())
+                s_last_csv = "(failed to write CSV)";
+        }
+        if (!s_last_csv.empty())
+        {
+            ImGui::SameLine();
+            ImGui::TextColored(colDim, "%s", s_last_csv.c_str());
+        }
+        ImGui::TextColored(colDim, "Milliseconds per record. Display includes the playout delay.");
+
+        const ServerClock::Estimate clock = ServerClock::estimate();
+        if (clock.valid && clock.twoWay)
+            ImGui::TextColored(colDim, "Track Server clock: offset %.1f ms, drift %+.1f ppm, RTT %.1f ms",
+                               clock.offsetMs, clock.driftPpm, clock.rttMs);
+        else if (clock.valid)
+            ImGui::TextColored(colDim, "Track Server clock: offset %.1f ms (one-way, less the fastest delay), drift %+.1f ppm",
+                               clock.offsetMs, clock.driftPpm);
+
+        bool anyData = false;
+        for (size_t src = 0; src < static_cast<size_t>(TelemetryLatency::Source::Count); ++src)
+        {
+            const auto source = static_cast<TelemetryLatency::Source>(src);
+            if (TelemetryLatency::summary(source, TelemetryLatency::Stage::Queue).count == 0)
+                continue;
+            anyData = true;
+
+            ImGui::Spacing();
+            ImGui::TextColored(colGold, "%s", TelemetryLatency::sourceName(source));
+            ImGui::PushID(static_cast<int>(src));
+            if (ImGui::BeginTable("Latency", 6,
+                                  ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+                                  ImGuiTableFlags_SizingStretchProp))
+            {
+                ImGui::TableSetupColumn("Stage", ImGuiTableColumnFlags_WidthStretch, 2.f);
+                ImGui::TableSetupColumn("Count");
+                ImGui::TableSetupColumn("p50");
+                ImGui::TableSetupColumn("p95");
+                ImGui::TableSetupColumn("p99");
+                ImGui::TableSetupColumn("Max");
+                ImGui::TableHeadersRow();
+                for (size_t st = 0; st < static_cast<size_t>(TelemetryLatency::Stage::Count); ++st)
+                {
+                    const auto stage = static_cast<TelemetryLatency::Stage>(st);
+                    const TelemetryLatency::Summary s = TelemetryLatency::summary(source, stage);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(TelemetryLatency::stageName(stage));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", (unsigned long long)s.count);
+                    if (s.count == 0)
+                    {
+                        for (int c = 0; c < 4; ++c) { ImGui::TableNextColumn(); ImGui::TextColored(colDim, "-"); }
+                        continue;
+                    }
+                    cellMs(s.p50Us);
+                    cellMs(s.p95Us);
+                    cellMs(s.p99Us);
+                    cellMs(s.maxUs);
+                }
+                ImGui::EndTable();
+            }
+            ImGui::PopID();
+        }
+        if (!anyData)
+            ImGui::TextColored(colDim, "(no telemetry yet)");
+
+        VehicleInterpolator::Get().GetPlayoutStats(s_playout);
+        if (!s_playout.empty())
+        {
+            ImGui::Spacing();
+            ImGui::TextColored(colGold, "Playout buffers");
+            ImGui::SameLine();
+            ImGui::TextColored(colDim, "(target %.0f%% of gaps run dry)", PlayoutDelay::TARGET_UNDERRUN * 100.0);
+            const float rows = static_cast<float>(s_playout.size() < 10 ? s_playout.size() + 1 : 11);
+            if (ImGui::BeginTable("Playout", 6,
+                                  ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+                                  ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY,
+                                  ImVec2(0.f, rows * ImGui::GetTextLineHeightWithSpacing() + 8.f)))
+            {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Car");
+                ImGui::TableSetupColumn("Rate Hz");
+                ImGui::TableSetupColumn("Jitter");
+                ImGui::TableSetupColumn("Loss %");
+                ImGui::TableSetupColumn("Delay (target)", ImGuiTableColumnFlags_WidthStretch, 2.f);
+                ImGui::TableSetupColumn("Underrun %");
+                ImGui::TableHeadersRow();
+                for (const VehiclePlayoutStats& v : s_playout)
+                {
+                    const PlayoutDelay::Stats& p = v.playout;
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d", v.vehicleID);
+                    ImGui::TableNextColumn();
+                    if (p.interval > 0.0)
+                        ImGui::Text("%.1f", 1.0 / p.interval);
+                    else
+                        ImGui::TextColored(colDim, "-");
+                    cellMs(p.jitter * 1e6);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", p.loss * 100.0);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.0f (%.0f)", p.delay * 1000.0, p.target * 1000.0);
+                    ImGui::TableNextColumn();
+                    if (p.frames > 0)
+                        ImGui::Text("%.2f", 100.0 * p.underruns / p.frames);
+                    else
+                        ImGui::TextColored(colDim, "-");
+                }
+                ImGui::EndTable();
+            }
+        }
+    }
+    ImGui::End();
+    if (font) ImGui::PopFont();
+}
+
+} // namespace LatencyPanel
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <imgui/imgui.h>
+
+// ============================================================================
+// LatencyPanel — View → Telemetry latency: p50/p95/p99/max of every
+// TelemetryLatency stage per data source, with Reset and Save CSV
+// (saves/Latency_<timestamp>.csv), and every vehicle's playout buffer
+// (rate, jitter, loss, adaptive delay, underruns). A floating window, so the map stays
+// usable while watching the numbers.
+// ============================================================================
+
+namespace LatencyPanel {
+
+void Toggle();
+bool IsOpen();
+// font may be nullptr — falls back to the current ImGui font.
+void Render(ImFont* font = nullptr);
+
+} // namespace LatencyPanel
@@ -5,8 +5,8 @@
 
 #include "../../racing/RaceManager.h"
 #include "../../network/TrackServerClient.h"
+#include "../../core/Log.h"
 #include "../../../libraries/include/imgui/imgui.h"
-#include <iostream>
 #include <string>
 
 extern RaceManager* g_race_manager;
@@ -41,7 +41,7 @@ void RenderRaceMenu()
 
         if (ImGui::MenuItem("Start Race", nullptr, false, can_start))
         {
-            std::cout << "[UI] Race Started\n";
+            LOG_INFO(UI, "[UI] Race Started");
             if (server_admin)
                 TrackServerClient::sendCommand(R"({"type":"race","action":"start"})");
             else
@@ -50,7 +50,7 @@ void RenderRaceMenu()
 
         if (ImGui::MenuItem("End Race", nullptr, false, can_end))
         {
-            std::cout << "[UI] Race Ended\n";
+            LOG_INFO(UI, "[UI] Race Ended");
             if (server_admin)
                 TrackServerClient::sendCommand(R"({"type":"race","action":"stop"})");
             else
@@ -59,7 +59,7 @@ void RenderRaceMenu()
 
         if (ImGui::MenuItem("Restart Race", nullptr, false, can_restart))
         {
-            std::cout << "[UI] Race Restarted\n";
+            LOG_INFO(UI, "[UI] Race Restarted");
             if (server_admin)
                 TrackServerClient::sendCommand(R"({"type":"race","action":"reset"})");
             else
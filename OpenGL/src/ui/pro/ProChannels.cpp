@@ -1,12 +1,8 @@
 #include "ProChannels.h"
-#include "../../vehicle/Vehicle.h"
+#include "../../racing/RaceSnapshot.h"
 #include <imgui.h>
-#include <mutex>
 #include <cstdio>
 
-extern std::map<int32_t, Vehicle> g_vehicles;
-extern std::mutex g_vehicles_mutex;
-
 namespace Pro {
 
 void RenderChannelsWindow(const ProContext& ctx, int32_t vehicleId,
@@ -30,13 +26,12 @@ void RenderChannelsWindow(const ProContext& ctx, int32_t vehicleId,
     double speed = 0, gx = 0, gy = 0, accel = 0, progress = 0;
     int16_t fixType = 0;
     {
-        std::lock_guard<std::mutex> lk(g_vehicles_mutex);
-        auto it = g_vehicles.find(vehicleId);
-        if (it != g_vehicles.end()) {
-            const Vehicle& v = it->second;
-            speed = v.m_speed_kph; gx = v.m_g_force_x; gy = v.m_g_force_y;
-            accel = v.m_acceleration; fixType = v.m_fix_type;
-            progress = v.m_track_progress;
+        const RaceFrame& f = RaceSnapshot::Current();
+        const int i = f.Find(vehicleId);
+        if (i >= 0) {
+            speed = f.speedKph[i]; gx = f.gForceX[i]; gy = f.gForceY[i];
+            accel = f.acceleration[i]; fixType = f.fixType[i];
+            progress = f.trackProgress[i];
         }
     }
     const char* fixLabel = fixType == 5 ? "RTK Fixed" :
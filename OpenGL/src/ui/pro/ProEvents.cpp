@@ -1,7 +1,9 @@
 #include "ProEvents.h"
 #include "../../racing/RaceManager.h"
+#include "../../racing/SessionStats.h"
 #include "../../vehicle/Vehicle.h"
 #include "../../network/TrackServerClient.h"
+#include "../../track/TrackGeometry.h"
 #include <imgui.h>
 #include <mutex>
 #include <deque>
@@ -9,6 +11,7 @@
 #include <string>
 #include <map>
 #include <climits>
+#include <algorithm>
 #include <cstdio>
 
 extern RaceManager* g_race_manager;
@@ -32,42 +35,21 @@ static void fmtSec(float s, char* b, size_t n) {
     else       snprintf(b, n, "%.3f", r);
 }
 
-// Robust per-sector times for a lap (running-max progress, lap time closes S3).
-static void crossTimes(const std::vector<LapInfo>& s, float bt[4]) {
-    for (int i = 0; i < 4; ++i) bt[i] = -1.f;
-    if (s.size() < 2) return;
-    double prevMaxP = s.front().progress;
-    float  prevT    = s.front().timefromstart;
-    int    nb       = 0;
-    while (nb <= 3 && (double)nb / 3.0 <= prevMaxP) bt[nb++] = prevT;
-    for (size_t i = 1; i < s.size(); ++i) {
-        double p = s[i].progress; if (p < prevMaxP) p = prevMaxP;
-        float  t = s[i].timefromstart;
-        while (nb <= 3 && (double)nb / 3.0 <= p) {
-            double bp = (double)nb / 3.0, den = p - prevMaxP;
-            double f = den > 1e-9 ? (bp - prevMaxP) / den : 1.0;
-            bt[nb++] = prevT + (t - prevT) * (float)f;
-        }
-        prevMaxP = p; prevT = t;
-    }
-}
-static void secCompleted(const std::vector<LapInfo>& s, float lapTime, float out[3], bool v[3]) {
-    float bt[4]; crossTimes(s, bt);
-    if (bt[3] < 0.f && lapTime > 0.f && bt[2] >= 0.f) bt[3] = lapTime;
-    for (int k = 0; k < 3; ++k) {
-        if (bt[k] >= 0.f && bt[k + 1] >= 0.f) { out[k] = bt[k + 1] - bt[k]; v[k] = true; }
-        else { out[k] = 0.f; v[k] = false; }
-    }
-}
+// Sector bests come precomputed from SessionStats.
+static constexpr int MAX_SEC = SessionStats::MAX_SECTORS;
 
 // ── Event log + detection state ─────────────────────────────────────────────
 struct LogEvent { char time[12]; std::string text; ImU32 col; };
 static std::deque<LogEvent> s_log;
 
-struct EvtState { float bestLap = -1.f; float bestSec[3] = { -1.f, -1.f, -1.f }; };
+struct EvtState {
+    float bestLap = -1.f;
+    float bestSec[MAX_SEC];
+    EvtState() { for (float& s : bestSec) s = -1.f; }
+};
 static std::map<int32_t, EvtState> s_prev;
 static float        s_sessBestLap    = -1.f;
-static float        s_sessBestSec[3] = { -1.f, -1.f, -1.f };
+static float        s_sessBestSec[MAX_SEC];
 static int32_t      s_leader         = INT_MIN;
 static SessionState s_state          = SessionState::Idle;
 static bool         s_init           = false;
@@ -86,7 +68,7 @@ static void pushEvent(float sessT, std::string text, ImU32 col) {
 static void resetTracking() {
     s_prev.clear();
     s_sessBestLap = -1.f;
-    for (int k = 0; k < 3; ++k) s_sessBestSec[k] = -1.f;
+    for (int k = 0; k < MAX_SEC; ++k) s_sessBestSec[k] = -1.f;
     s_leader = INT_MIN;
     s_log.clear();
 }
@@ -118,24 +100,23 @@ static void detectEvents() {
         }
     }
 
-    struct Snap { int32_t id; std::string name; float bestLap; float sec[3]; bool secV[3]; double prog; bool started; };
+    const int nSec = std::min(TrackGeometry::Current()->sectorCount, MAX_SEC);
+    const SessionStats::TablePtr stats = SessionStats::Current();
+    struct Snap { int32_t id; std::string name; float bestLap; float sec[MAX_SEC]; bool secV[MAX_SEC]; double prog; bool started; };
     std::vector<Snap> snaps;
     int32_t leader = INT_MIN; double leadProg = -1.0;
     {
         std::lock_guard<std::mutex> lk(g_vehicles_mutex);
-        auto lapTimeOf = [](Vehicle& v, int ln) -> float {
-            auto m = v.m_laps.find(ln); return (m != v.m_laps.end()) ? m->second.lapTime : -1.f;
-        };
         for (auto& [id, v] : g_vehicles) {
             Snap s;
             s.id = id;
             s.name = (v.name.empty() || v.name == "Unknown") ? ("CAR " + std::to_string(v.m_id)) : v.name;
             s.bestLap = v.m_best_lap_time;
-            for (int k = 0; k < 3; ++k) { s.sec[k] = -1.f; s.secV[k] = false; }
-            for (auto& [ln, sess] : v.laps) {
-                float z[3]; bool zv[3]; secCompleted(sess.samples, lapTimeOf(v, ln), z, zv);
-                for (int k = 0; k < 3; ++k)
-                    if (zv[k] && (!s.secV[k] || z[k] < s.sec[k])) { s.sec[k] = z[k]; s.secV[k] = true; }
+            const SessionStats::VehicleStats* vs = stats->Find(id);
+            for (int k = 0; k < nSec; ++k) {
+                const int64_t b = vs ? vs->bestSectorUs[k] : -1;
+                s.secV[k] = b >= 0;
+                s.sec[k]  = s.secV[k] ? (float)(b / 1e6) : -1.f;
             }
             s.prog = v.m_total_progress;
             s.started = v.m_has_started_first_lap;
@@ -146,9 +127,10 @@ static void detectEvents() {
 
     // First frame (or after a reset): seed bests silently, do not flood the log.
     if (!s_init) {
+        for (int k = 0; k < MAX_SEC; ++k) s_sessBestSec[k] = -1.f;
         for (auto& s : snaps) {
             EvtState e; e.bestLap = s.bestLap;
-            for (int k = 0; k < 3; ++k) {
+            for (int k = 0; k < nSec; ++k) {
                 e.bestSec[k] = s.secV[k] ? s.sec[k] : -1.f;
                 if (s.secV[k] && (s_sessBestSec[k] < 0.f || s.sec[k] < s_sessBestSec[k])) s_sessBestSec[k] = s.sec[k];
             }
@@ -183,7 +165,7 @@ static void detectEvents() {
             pv.bestLap = s.bestLap;
         }
 
-        for (int k = 0; k < 3; ++k) {
+        for (int k = 0; k < nSec; ++k) {
             if (s.secV[k] && (pv.bestSec[k] < 0.f || s.sec[k] < pv.bestSec[k] - eps)) {
                 char tb[16]; fmtSec(s.sec[k], tb, sizeof(tb));
                 bool overall = (s_sessBestSec[k] < 0.f || s.sec[k] < s_sessBestSec[k] - eps);
@@ -1,13 +1,9 @@
 #include "ProGForce.h"
-#include "../../vehicle/Vehicle.h"
+#include "../../racing/RaceSnapshot.h"
 #include <imgui.h>
-#include <mutex>
 #include <cmath>
 #include <cstdio>
 
-extern std::map<int32_t, Vehicle> g_vehicles;
-extern std::mutex g_vehicles_mutex;
-
 namespace Pro {
 
 void RenderGForceWindow(const ProContext& ctx, int32_t vehicleId,
@@ -30,11 +26,11 @@ void RenderGForceWindow(const ProContext& ctx, int32_t vehicleId,
     // Live data
     double gx = 0, gy = 0;
     {
-        std::lock_guard<std::mutex> lk(g_vehicles_mutex);
-        auto it = g_vehicles.find(vehicleId);
-        if (it != g_vehicles.end()) {
-            gx = it->second.m_g_force_x;
-            gy = it->second.m_g_force_y;
+        const RaceFrame& f = RaceSnapshot::Current();
+        const int i = f.Find(vehicleId);
+        if (i >= 0) {
+            gx = f.gForceX[i];
+            gy = f.gForceY[i];
         }
     }
 
@@ -1,18 +1,20 @@
 #include "ProLapInfo.h"
 #include "../../racing/RaceManager.h"
-#include "../../vehicle/Vehicle.h"
+#include "../../racing/RaceSnapshot.h"
+#include "../../racing/SessionStats.h"
+#include "../../track/TrackGeometry.h"
 #include <imgui.h>
-#include <mutex>
+#include <algorithm>
 #include <cstdio>
 #include <ctime>
 #include <string>
 
 extern RaceManager* g_race_manager;
-extern std::map<int32_t, Vehicle> g_vehicles;
-extern std::mutex g_vehicles_mutex;
 
 namespace Pro {
 
+static constexpr ImU32 LI_PURPLE = IM_COL32(0xBB, 0x8E, 0xF9, 255); // session best sector
+
 // Sector row: label | time (right mid) | delta (right edge)
 static void SectorRow(const ProContext& ctx, float w,
                        const char* lbl, const char* time,
@@ -60,15 +62,14 @@ void RenderLapInfoWindow(const ProContext& ctx, int32_t vehicleId,
 
     if (!g_race_manager) { ImGui::SetWindowFontScale(1.f); ImGui::End(); return; }
 
-    int   curLap   = g_race_manager->GetVehicleCurrentLapNumber(vehicleId);
-    float prevTime = g_race_manager->GetVehiclePreviousLapTime(vehicleId);
-    float delta    = g_race_manager->GetVehicleLapDelta(vehicleId);
-    int   pos      = 0;
-    {
-        auto standings = g_race_manager->GetStandings();
-        for (auto& s : standings)
-            if (s.vehicleID == vehicleId) { pos = s.position; break; }
-    }
+    const RaceFrame&       f  = RaceSnapshot::Current();
+    const int              vi = f.Find(vehicleId);
+    const VehicleStanding* st = f.FindStanding(vehicleId);
+
+    int   curLap   = st ? st->currentLapNumber : 0;
+    float prevTime = vi >= 0 ? f.previousLapTime[vi] : -1.f;
+    float delta    = st ? st->deltaTimeToBest : 0.f;
+    int   pos      = st ? st->position : 0;
 
     char tb[32], db[32], pb[16];
     snprintf(tb, sizeof(tb), "%d", curLap);
@@ -79,9 +80,37 @@ void RenderLapInfoWindow(const ProContext& ctx, int32_t vehicleId,
 
     ImGui::Dummy(ImVec2(0, 2.f));
 
-    SectorRow(ctx, w, "S1", "--:--.---", "---", COL_LABEL, COL_LABEL);
-    SectorRow(ctx, w, "S2", "--:--.---", "---", COL_LABEL, COL_LABEL);
-    SectorRow(ctx, w, "S3", "--:--.---", "---", COL_LABEL, COL_LABEL);
+    // Sectors of the last completed lap (precomputed by SessionStats), delta
+    // to the driver's best sector, colored by how the sector ranked
+    const TrackGeometry::SnapshotPtr  track = TrackGeometry::Current();
+    const SessionStats::TablePtr      stats = SessionStats::Current();
+    const SessionStats::VehicleStats* vs    = stats->Find(vehicleId);
+    const SessionStats::VehicleStats  none;
+    const SessionStats::VehicleStats& s     = vs ? *vs : none;
+    const int nSec = std::min(track->sectorCount, SessionStats::MAX_SECTORS);
+    for (int k = 0; k < nSec; ++k) {
+        char lb[8];
+        snprintf(lb, sizeof(lb), "S%d", k + 1);
+        if (s.lastSectorUs[k] < 0) { SectorRow(ctx, w, lb, "--:--.---", "---", COL_LABEL, COL_LABEL); continue; }
+        const float d = (float)((s.lastSectorUs[k] - s.bestSectorUs[k]) / 1e6);
+        fmtTime((float)(s.lastSectorUs[k] / 1e6), tb, sizeof(tb));
+        fmtDelta(d, db, sizeof(db));
+        ImU32 tCol = COL_WHITE;
+        if      (s.lastSectorMark[k] == SessionStats::Mark::Purple) tCol = LI_PURPLE;
+        else if (s.lastSectorMark[k] == SessionStats::Mark::Green)  tCol = COL_GREEN;
+        SectorRow(ctx, w, lb, tb, db, tCol, d > 0.f ? COL_RED : COL_DIM);
+    }
+
+    // Speed traps of the last lap
+    int trap = 0;
+    for (const TrackGeometry::TimingLine& l : track->timingLines) {
+        if (l.kind != TrackGeometry::TimingLine::Kind::SpeedTrap) continue;
+        if (trap >= SessionStats::MAX_TRAPS) break;
+        const float kph = s.lastTrapKph[trap++];
+        if (kph < 0.f) snprintf(tb, sizeof(tb), "--- km/h");
+        else           snprintf(tb, sizeof(tb), "%.1f km/h", kph);
+        SectorRow(ctx, w, l.name.empty() ? "Trap" : l.name.c_str(), tb, "", COL_WHITE, COL_DIM);
+    }
 
     ImGui::Dummy(ImVec2(0, 2.f));
 
@@ -90,6 +119,25 @@ void RenderLapInfoWindow(const ProContext& ctx, int32_t vehicleId,
     ImU32 dCol = delta < 0.f ? COL_GREEN : (delta > 0.f ? COL_RED : COL_DIM);
     SectorRow(ctx, w, "Last", tb, db, COL_WHITE, dCol);
 
+    // Theoretical best (best sectors) vs best lap, and consistency of the
+    // last SessionStats::ROLLING_LAPS laps
+    if (s.theoreticalBestUs > 0) {
+        fmtTime((float)(s.theoreticalBestUs / 1e6), tb, sizeof(tb));
+        fmtDelta((float)((s.theoreticalBestUs - s.bestLapUs) / 1e6), db, sizeof(db));
+    } else {
+        snprintf(tb, sizeof(tb), "--:--.---");
+        snprintf(db, sizeof(db), "---");
+    }
+    SectorRow(ctx, w, "Ideal", tb, db, COL_WHITE, COL_DIM);
+    if (s.rollingCount > 0) {
+        fmtTime((float)s.rollingMeanS, tb, sizeof(tb));
+        snprintf(db, sizeof(db), "\xc2\xb1%.3f", s.rollingStdDevS);
+    } else {
+        snprintf(tb, sizeof(tb), "--:--.---");
+        snprintf(db, sizeof(db), "---");
+    }
+    SectorRow(ctx, w, "Avg", tb, db, COL_WHITE, COL_DIM);
+
     ImGui::End();
 }
 
@@ -109,12 +157,9 @@ void RenderSessionInfoWindow(const ProContext& ctx, int32_t vehicleId,
     DrawPanelHeader(ctx, "SESSION INFO", false, nullptr, z);
     ImGui::SetWindowFontScale(z);
 
-    std::string driverName = "---";
-    {
-        std::lock_guard<std::mutex> lk(g_vehicles_mutex);
-        auto it = g_vehicles.find(vehicleId);
-        if (it != g_vehicles.end()) driverName = it->second.name;
-    }
+    const RaceFrame& f  = RaceSnapshot::Current();
+    const int        vi = f.Find(vehicleId);
+    const char* driverName = vi >= 0 ? f.names[vi].c_str() : "---";
 
     char dateBuf[32] = "---";
     std::time_t t = std::time(nullptr);
@@ -131,7 +176,7 @@ void RenderSessionInfoWindow(const ProContext& ctx, int32_t vehicleId,
         }
     }
 
-    LabelValue(ctx, "Driver",   driverName.c_str());
+    LabelValue(ctx, "Driver",   driverName);
     LabelValue(ctx, "Engineer", "---");
     LabelValue(ctx, "Circuit",  "---");
     LabelValue(ctx, "Vehicle",  std::to_string(vehicleId).c_str());
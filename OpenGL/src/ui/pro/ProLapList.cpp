@@ -1,9 +1,12 @@
 #include "ProLapList.h"
 #include "../../racing/RaceManager.h"
+#include "../../racing/RaceSnapshot.h"
+#include "../../racing/SessionStats.h"
 #include "../../vehicle/Vehicle.h"
 #include <imgui.h>
 #include <mutex>
 #include <cmath>
+#include <climits>
 #include <cstdio>
 
 extern RaceManager* g_race_manager;
@@ -14,6 +17,18 @@ namespace Pro {
 
 static int s_selected_lap = -1;
 
+// Completed laps of the shown vehicle. They only change when a lap completes,
+// so they are re-copied then (SessionStats revision, completed-lap count or
+// vehicle changed), not every frame.
+struct LapCache {
+    int32_t                vehicleId = INT_MIN;
+    uint64_t               revision  = 0;
+    int                    completed = -1;
+    std::map<int, LapData> laps;
+    float                  bestTime  = -1.f;
+};
+static LapCache s_cache;
+
 // ── Palette ───────────────────────────────────────────────────────────────────
 static constexpr ImU32 LL_BG_SEL    = IM_COL32(0x29, 0x29, 0x29, 255);
 static constexpr ImU32 LL_BG_HOVER  = IM_COL32(0x1A, 0x1A, 0x1A, 255);
@@ -93,16 +108,27 @@ void RenderLapListWindow(const ProContext& ctx, int32_t vehicleId,
 
     // Thread-safe snapshot — the network thread mutates the live lap map, so we
     // copy under the lock rather than iterating a borrowed pointer.
-    std::map<int, LapData> laps;
-    float bestTime = -1.f;
-    int   curLap   = 1;
-    float curTime  = 0.f;
-    if (g_race_manager) {
-        laps     = g_race_manager->GetVehicleLapsCopy(vehicleId);
-        bestTime = g_race_manager->GetVehicleBestLapTime(vehicleId);
-        curLap   = g_race_manager->GetVehicleCurrentLapNumber(vehicleId);
-        curTime  = g_race_manager->GetVehicleCurrentLapTime(vehicleId);
+    const RaceFrame&       f  = RaceSnapshot::Current();
+    const int              vi = f.Find(vehicleId);
+    const VehicleStanding* st = f.FindStanding(vehicleId);
+    {
+        const SessionStats::TablePtr      stats = SessionStats::Current();
+        const SessionStats::VehicleStats* vs    = stats->Find(vehicleId);
+        const uint64_t rev       = vs ? vs->revision : 0;
+        const int      completed = st ? st->completedLaps : 0;
+        if (g_race_manager && (s_cache.vehicleId != vehicleId || s_cache.revision != rev ||
+                               s_cache.completed != completed)) {
+            s_cache.vehicleId = vehicleId;
+            s_cache.revision  = rev;
+            s_cache.completed = completed;
+            s_cache.laps      = g_race_manager->GetVehicleLapsCopy(vehicleId);
+            s_cache.bestTime  = g_race_manager->GetVehicleBestLapTime(vehicleId);
+        }
     }
+    const std::map<int, LapData>& laps = s_cache.laps;
+    float bestTime = s_cache.bestTime;
+    int   curLap   = st ? st->currentLapNumber : 1;
+    float curTime  = vi >= 0 ? f.currentLapTime[vi] : 0.f;
 
     // ── Row draw helper ───────────────────────────────────────────────────────
     // IMPORTANT: always call ImGui::GetWindowDrawList() INSIDE the lambda so
@@ -1,15 +1,9 @@
 #include "ProLaptime.h"
-#include "../../racing/RaceManager.h"
-#include "../../vehicle/Vehicle.h"
+#include "../../racing/RaceSnapshot.h"
 #include <imgui.h>
-#include <mutex>
 #include <cstdio>
 #include <cmath>
 
-extern RaceManager* g_race_manager;
-extern std::map<int32_t, Vehicle> g_vehicles;
-extern std::mutex g_vehicles_mutex;
-
 namespace Pro {
 
 // ── Palette (from the Time.svg mockup) ──────────────────────────────────────
@@ -65,8 +59,12 @@ void RenderLaptimeWindow(const ProContext& ctx, int32_t vehicleId,
         ImGui::Dummy(ImVec2(w, rowH + 3.f * z));
     };
 
+    const RaceFrame&       f  = RaceSnapshot::Current();
+    const int              vi = f.Find(vehicleId);
+    const VehicleStanding* st = f.FindStanding(vehicleId);
+
     // ── Big LAPTIME ──────────────────────────────────────────────────────────
-    float curTime = g_race_manager ? g_race_manager->GetVehicleCurrentLapTime(vehicleId) : 0.f;
+    float curTime = vi >= 0 ? f.currentLapTime[vi] : 0.f;
     char  tb[32];
     fmtTime(curTime, tb, sizeof(tb));
 
@@ -81,13 +79,9 @@ void RenderLaptimeWindow(const ProContext& ctx, int32_t vehicleId,
 
     // ── SPEED / ACCELE. ──────────────────────────────────────────────────────
     double speed = 0, accel = 0;
-    {
-        std::lock_guard<std::mutex> lk(g_vehicles_mutex);
-        auto it = g_vehicles.find(vehicleId);
-        if (it != g_vehicles.end()) {
-            speed = it->second.m_speed_kph;
-            accel = it->second.m_acceleration;
-        }
+    if (vi >= 0) {
+        speed = f.speedKph[vi];
+        accel = f.acceleration[vi];
     }
 
     char vb[32];
@@ -99,7 +93,7 @@ void RenderLaptimeWindow(const ProContext& ctx, int32_t vehicleId,
     goldLine();
 
     // ── TIME DIFF ────────────────────────────────────────────────────────────
-    float delta = g_race_manager ? g_race_manager->GetVehicleLapDelta(vehicleId) : 0.f;
+    float delta = st ? st->deltaTimeToBest : 0.f;
     char  db[32];
     fmtDelta(delta, db, sizeof(db));
     ImU32 dCol = delta < 0.f ? COL_GREEN : (delta > 0.f ? COL_RED : LT_LABEL);
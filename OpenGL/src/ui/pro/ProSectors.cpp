@@ -1,5 +1,7 @@
 #include "ProSectors.h"
 #include "../../rendering/Interpolation.h"
+#include "../../racing/SessionStats.h"
+#include "../../track/TrackGeometry.h"
 #include "../../vehicle/Vehicle.h"
 #include <imgui.h>
 #include <mutex>
@@ -8,7 +10,6 @@
 #include <cmath>
 #include <cstdio>
 
-extern std::vector<SplinePoint> g_smooth_track_points;
 extern std::map<int32_t, Vehicle> g_vehicles;
 extern std::mutex g_vehicles_mutex;
 
@@ -17,7 +18,11 @@ namespace Pro {
 // ── Mini-sector delta palette ───────────────────────────────────────────────
 // Track is split into SEC_ZONES mini-sectors; each is colored by how the driver
 // performed in it versus their personal best lap (and the overall session best).
-static constexpr int   SEC_ZONES  = 48;
+// Zone times come precomputed: the lap in progress from the vehicle's
+// TimingRecord, the bests from SessionStats (< 0: the zone's boundaries were
+// not both crossed).
+// The overall best of a zone is the fastest anyone has driven it on any lap.
+static constexpr int   SEC_ZONES  = TimingRecord::MINI_SECTORS;
 static constexpr ImU32 SEC_PURPLE = IM_COL32(177, 156, 224, 255); // fastest of all
 static constexpr ImU32 SEC_GREEN  = IM_COL32( 62, 142,  71, 255); // beats own best
 static constexpr ImU32 SEC_YELLOW = IM_COL32(218, 165,  64, 255); // < 1s off best
@@ -26,45 +31,6 @@ static constexpr ImU32 SEC_NONE   = IM_COL32( 70,  70,  70, 255); // no comparis
 
 static constexpr float SEC_EPS    = 0.005f; // tie tolerance (s)
 
-// Per-zone traversal time for one lap.
-//   out[k]   = time spent in mini-sector k (seconds)
-//   valid[k] = true only when BOTH boundaries of zone k were actually crossed
-//
-// Samples are stored in TIME order; their `progress` is NOT guaranteed monotonic
-// (position noise / braking / standing still can push it backward). So we walk
-// the samples once, tracking the running-MAX progress, and record the time each
-// zone boundary was first reached. A completed zone's time is then fixed forever,
-// regardless of what the car does later — no flicker on hard braking/acceleration.
-static void zoneTimes(const std::vector<LapInfo>& s,
-                      float out[SEC_ZONES], bool valid[SEC_ZONES]) {
-    for (int k = 0; k < SEC_ZONES; ++k) { out[k] = 0.f; valid[k] = false; }
-    if (s.size() < 2) return;
-
-    float bt[SEC_ZONES + 1];
-    for (int i = 0; i <= SEC_ZONES; ++i) bt[i] = -1.f;
-
-    double prevMaxP = s.front().progress;
-    float  prevT    = s.front().timefromstart;
-    int    nb       = 0;
-    // Boundaries already behind the first sample are reached at lap start.
-    while (nb <= SEC_ZONES && (double)nb / SEC_ZONES <= prevMaxP) bt[nb++] = prevT;
-
-    for (size_t i = 1; i < s.size(); ++i) {
-        double p = s[i].progress; if (p < prevMaxP) p = prevMaxP; // running max
-        float  t = s[i].timefromstart;
-        while (nb <= SEC_ZONES && (double)nb / SEC_ZONES <= p) {
-            double bp    = (double)nb / SEC_ZONES;
-            double denom = p - prevMaxP;
-            double frac  = denom > 1e-9 ? (bp - prevMaxP) / denom : 1.0;
-            bt[nb++] = prevT + (t - prevT) * (float)frac;
-        }
-        prevMaxP = p; prevT = t;
-    }
-
-    for (int k = 0; k < SEC_ZONES; ++k)
-        if (bt[k] >= 0.f && bt[k + 1] >= 0.f) { out[k] = bt[k + 1] - bt[k]; valid[k] = true; }
-}
-
 void RenderSectorsWindow(const ProContext& ctx, int32_t vehicleId,
                           ImVec2 vpSz, float topH) {
     ImGui::SetNextWindowPos ({635.f, topH + 600.f}, ImGuiCond_FirstUseEver);
@@ -97,74 +63,53 @@ void RenderSectorsWindow(const ProContext& ctx, int32_t vehicleId,
     ImU32 zoneCol[SEC_ZONES];
     for (int k = 0; k < SEC_ZONES; ++k) zoneCol[k] = SEC_NONE;
     {
-        float bestZ[SEC_ZONES]; bool bestV[SEC_ZONES] = { false };
-        float dispZ[SEC_ZONES]; bool zValid[SEC_ZONES] = { false };
-        float sessZ[SEC_ZONES]; bool sessV[SEC_ZONES] = { false };
-
-        std::lock_guard<std::mutex> lk(g_vehicles_mutex);
-
-        auto it = g_vehicles.find(vehicleId);
-        if (it != g_vehicles.end()) {
-            Vehicle& v = it->second;
-
-            // Personal best lap → reference times (full lap → all zones valid)
-            if (v.bestlapID >= 0) {
-                auto bit = v.laps.find(v.bestlapID);
-                if (bit != v.laps.end()) zoneTimes(bit->second.samples, bestZ, bestV);
-            }
-
-            // F1-style live map: color ONLY the current lap, zone by zone as the
-            // driver passes through each one. A zone is colored once both of its
-            // boundaries are crossed; unreached zones stay neutral and the map
-            // resets each lap. So a slow lap shows green where pace matched and
-            // yellow/red only in the mini-sectors where time was actually lost.
-            auto cit = v.laps.find(v.m_current_lap_number);
-            if (cit != v.laps.end())
-                zoneTimes(cit->second.samples, dispZ, zValid);
-        }
-
-        // Overall session best per zone (across every car's best lap)
-        for (auto& [id, v] : g_vehicles) {
-            if (v.bestlapID < 0) continue;
-            auto bit = v.laps.find(v.bestlapID);
-            if (bit == v.laps.end()) continue;
-            float z[SEC_ZONES]; bool zv[SEC_ZONES];
-            zoneTimes(bit->second.samples, z, zv);
-            for (int k = 0; k < SEC_ZONES; ++k) {
-                if (!zv[k]) continue;
-                if (!sessV[k] || z[k] < sessZ[k]) { sessZ[k] = z[k]; sessV[k] = true; }
+        const SessionStats::TablePtr      stats = SessionStats::Current();
+        const SessionStats::VehicleStats* vs    = stats->Find(vehicleId);
+        const float* bestZ = vs ? vs->bestLapMiniSectors : nullptr;  // personal best lap
+        const float* sessZ = stats->bestMiniSectors;
+
+        // F1-style live map: color ONLY the current lap, zone by zone as the
+        // driver passes through each one. A zone is colored once both of its
+        // boundaries are crossed; unreached zones stay neutral and the map
+        // resets each lap. So a slow lap shows green where pace matched and
+        // yellow/red only in the mini-sectors where time was actually lost.
+        float dispZ[SEC_ZONES];
+        bool  inLap = false;
+        {
+            std::lock_guard<std::mutex> lk(g_vehicles_mutex);
+            auto it = g_vehicles.find(vehicleId);
+            if (it != g_vehicles.end() && it->second.m_timing.InLap()) {
+                const float* cur = it->second.m_timing.Current().miniSectors;
+                std::copy(cur, cur + SEC_ZONES, dispZ);
+                inLap = true;
             }
         }
 
-        for (int k = 0; k < SEC_ZONES; ++k) {
-            if (!zValid[k] || !bestV[k]) continue;          // no data / no reference
+        for (int k = 0; bestZ && inLap && k < SEC_ZONES; ++k) {
+            if (dispZ[k] < 0.f || bestZ[k] < 0.f) continue;  // no data / no reference
             float delta = dispZ[k] - bestZ[k];
-            if (sessV[k] && dispZ[k] <= sessZ[k] + SEC_EPS)  zoneCol[k] = SEC_PURPLE;
-            else if (delta <= SEC_EPS)                       zoneCol[k] = SEC_GREEN;
-            else if (delta < 1.0f)                           zoneCol[k] = SEC_YELLOW;
-            else                                             zoneCol[k] = SEC_RED;
+            if (sessZ[k] >= 0.f && dispZ[k] <= sessZ[k] + SEC_EPS) zoneCol[k] = SEC_PURPLE;
+            else if (delta <= SEC_EPS)                             zoneCol[k] = SEC_GREEN;
+            else if (delta < 1.0f)                                 zoneCol[k] = SEC_YELLOW;
+            else                                                   zoneCol[k] = SEC_RED;
         }
     }
 
     // ── Draw the track, painting each segment by its mini-sector color ─────────
-    if (g_smooth_track_points.empty()) {
+    const TrackGeometry::SnapshotPtr track = TrackGeometry::Current();
+    const std::vector<SplinePoint>& pts = track->points;
+    if (pts.empty()) {
         const char* msg = "No track";
         ImVec2 tSz = ImGui::CalcTextSize(msg);
         dl->AddText(nullptr, 0.f,
                     {base.x + (mapW - tSz.x)*0.5f, base.y + (mapH - tSz.y)*0.5f},
                     IM_COL32(60,60,60,255), msg);
     } else {
-        const size_t n = g_smooth_track_points.size();
+        const size_t n = pts.size();
 
         // Bounds
-        glm::vec2 lo = g_smooth_track_points[0].position;
-        glm::vec2 hi = lo;
-        for (auto& sp : g_smooth_track_points) {
-            lo.x = lo.x < sp.position.x ? lo.x : sp.position.x;
-            lo.y = lo.y < sp.position.y ? lo.y : sp.position.y;
-            hi.x = hi.x > sp.position.x ? hi.x : sp.position.x;
-            hi.y = hi.y > sp.position.y ? hi.y : sp.position.y;
-        }
+        const glm::vec2 lo = track->boundsMin;
+        const glm::vec2 hi = track->boundsMax;
         float rX = hi.x - lo.x; if (rX < 1e-6f) rX = 1.f;
         float rY = hi.y - lo.y; if (rY < 1e-6f) rY = 1.f;
         float pad   = 20.f;
@@ -177,13 +122,8 @@ void RenderSectorsWindow(const ProContext& ctx, int32_t vehicleId,
         };
 
         // Cumulative arc length per point → progress (matches m_track_progress).
-        std::vector<float> cum(n, 0.f);
-        for (size_t i = 1; i < n; ++i) {
-            glm::vec2 d = g_smooth_track_points[i].position - g_smooth_track_points[i-1].position;
-            cum[i] = cum[i-1] + sqrtf(d.x*d.x + d.y*d.y);
-        }
-        glm::vec2 dc = g_smooth_track_points[0].position - g_smooth_track_points[n-1].position;
-        float total = cum[n-1] + sqrtf(dc.x*dc.x + dc.y*dc.y);
+        const std::vector<float>& cum = track->cumulative;
+        float total = track->loopLength;
         if (total < 1e-6f) total = 1.f;
 
         auto colAtProg = [&](float p) -> ImU32 {
@@ -195,13 +135,13 @@ void RenderSectorsWindow(const ProContext& ctx, int32_t vehicleId,
         const float trackTh = fmaxf(mapH * 0.022f, 4.f);
         for (size_t i = 0; i < n; ++i) {
             size_t j  = (i + 1) % n;
-            ImVec2 pa = toScreen(g_smooth_track_points[i].position);
-            ImVec2 pb = toScreen(g_smooth_track_points[j].position);
+            ImVec2 pa = toScreen(pts[i].position);
+            ImVec2 pb = toScreen(pts[j].position);
             dl->AddLine(pa, pb, colAtProg(cum[i] / total), trackTh);
         }
 
         // Vehicle position dot — apply the same centering offset that is baked
-        // into g_smooth_track_points (see rebuildTrackCacheFromEdges).
+        // into the track points (see rebuildTrackCacheFromEdges).
         double vx = 0, vy = 0; bool found = false;
         {
             std::lock_guard<std::mutex> lk(g_vehicles_mutex);
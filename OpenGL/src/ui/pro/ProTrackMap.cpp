@@ -1,6 +1,8 @@
 #include "ProTrackMap.h"
 #include "../../racing/RaceManager.h"
+#include "../../racing/SessionStats.h"
 #include "../../rendering/Interpolation.h"
+#include "../../track/TrackGeometry.h"
 #include "../../vehicle/Vehicle.h"
 #include "../UI_Config.h"
 #include <imgui.h>
@@ -15,7 +17,6 @@
 #include <cmath>
 
 extern RaceManager* g_race_manager;
-extern std::vector<SplinePoint> g_smooth_track_points;
 extern std::map<int32_t, Vehicle> g_vehicles;
 extern std::mutex g_vehicles_mutex;
 
@@ -43,49 +44,14 @@ static void fmtSector(float s, char* b, size_t n) {
     else       snprintf(b, n, "%.3f", r);
 }
 
-// Time at which each sector boundary (0, 1/3, 2/3, 1) was first crossed in a lap.
-// bt[i] = -1 when not reached yet. Robust to noisy/non-monotonic progress.
-static void crossTimes(const std::vector<LapInfo>& s, float bt[4]) {
-    for (int i = 0; i < 4; ++i) bt[i] = -1.f;
-    if (s.size() < 2) return;
-    double prevMaxP = s.front().progress;
-    float  prevT    = s.front().timefromstart;
-    int    nb       = 0;
-    while (nb <= 3 && (double)nb / 3.0 <= prevMaxP) bt[nb++] = prevT;
-    for (size_t i = 1; i < s.size(); ++i) {
-        double p = s[i].progress; if (p < prevMaxP) p = prevMaxP;
-        float  t = s[i].timefromstart;
-        while (nb <= 3 && (double)nb / 3.0 <= p) {
-            double bp = (double)nb / 3.0, den = p - prevMaxP;
-            double f = den > 1e-9 ? (bp - prevMaxP) / den : 1.0;
-            bt[nb++] = prevT + (t - prevT) * (float)f;
-        }
-        prevMaxP = p; prevT = t;
-    }
-}
-
-// Sector times for a COMPLETED lap. The final boundary (progress 1.0) is rarely
-// sampled exactly — the lap ends at the finish line — so sector 3 is closed off
-// with the lap's recorded total time.
-static void secCompleted(const std::vector<LapInfo>& s, float lapTime,
-                         float out[3], bool v[3]) {
-    float bt[4]; crossTimes(s, bt);
-    if (bt[3] < 0.f && lapTime > 0.f && bt[2] >= 0.f) bt[3] = lapTime;
-    for (int k = 0; k < 3; ++k) {
-        if (bt[k] >= 0.f && bt[k + 1] >= 0.f) { out[k] = bt[k + 1] - bt[k]; v[k] = true; }
-        else { out[k] = 0.f; v[k] = false; }
-    }
-}
-
-static void accMin(float dst[3], bool dv[3], const float z[3], const bool zv[3]) {
-    for (int k = 0; k < 3; ++k)
-        if (zv[k] && (!dv[k] || z[k] < dst[k])) { dst[k] = z[k]; dv[k] = true; }
-}
+// Sector times come precomputed from each vehicle's TimingRecord (timing lines
+// crossed at ingest); MAX_SEC bounds the arrays, the track says how many.
+static constexpr int MAX_SEC = SessionStats::MAX_SECTORS;
 
 // Color a sector vs the driver's best-ever time for THAT sector (bestS) and the
 // overall session best for that sector (sessS).
-static SecStyle colorFor(float secT, const float bestS[3], const bool bestV[3],
-                         const float sessS[3], const bool sessV[3], int i) {
+static SecStyle colorFor(float secT, const float bestS[], const bool bestV[],
+                         const float sessS[], const bool sessV[], int i) {
     if (sessV[i] && secT <= sessS[i] + SEC_EPS)    return SEC_PURPLE;
     if (bestV[i] && secT - bestS[i] <= SEC_EPS)    return SEC_GREEN;
     if (bestV[i] && secT - bestS[i] <  1.0f)       return SEC_YELLOW;
@@ -97,8 +63,8 @@ static SecStyle colorFor(float secT, const float bestS[3], const bool bestV[3],
 struct SecHold {
     int  lastLap = INT_MIN;
     bool has     = false;
-    char tstr[3][16];
-    SecStyle sty[3];
+    char tstr[MAX_SEC][16];
+    SecStyle sty[MAX_SEC];
     std::chrono::steady_clock::time_point holdUntil;
 };
 static std::map<int32_t, SecHold> s_hold;
@@ -119,24 +85,24 @@ static void DrawFlag(ImDrawList* dl, ImVec2 p, float sz) {
 // Strip geometry, sized from available width/height with a max cell size so the
 // cells keep the reference aspect ratio instead of stretching.
 struct StripLayout { float carW, nameW, cellW, cellGap, contentW; };
-static StripLayout computeStrip(float availW, float cellH, float ux) {
+static StripLayout computeStrip(float availW, float cellH, float ux, int cells) {
     StripLayout L;
     L.carW    = fmaxf(38.f * ux, 32.f);
     L.nameW   = fmaxf(120.f * ux, 92.f);
     L.cellGap = 4.f;
     float fixed    = L.carW + 2.f + L.nameW + 8.f;
     float maxCellW = cellH * CELL_RATIO;
-    float share    = (availW - fixed - L.cellGap * 3.f) / 4.f;
+    float share    = (availW - fixed - L.cellGap * (cells - 1)) / cells;
     L.cellW    = fminf(share, maxCellW); if (L.cellW < 40.f) L.cellW = 40.f;
-    L.contentW = fixed + 4.f * L.cellW + L.cellGap * 3.f;
+    L.contentW = fixed + cells * L.cellW + L.cellGap * (cells - 1);
     return L;
 }
 
-// Bottom strip: car number + name + 3 colored sector cells + LAP TIME cell.
+// Bottom strip: car number + name + one colored cell per sector + LAP TIME cell.
 static void DrawStatusStrip(ImDrawList* dl, const ProContext& ctx,
                              ImVec2 base, float stripH, const StripLayout& L,
                              const char* driverNum, const char* driverName,
-                             const char* secTime[3], const SecStyle secStyle[3],
+                             int sectors, const char* const secTime[], const SecStyle secStyle[],
                              const char* lapTime, float scale) {
     float fSz  = (ctx.russo ? ctx.russo->FontSize : 12.f) * scale;
     float hdrH = fmaxf(stripH * 0.34f, 16.f);
@@ -156,14 +122,16 @@ static void DrawStatusStrip(ImDrawList* dl, const ProContext& ctx,
                 {x + 8.f, valY + (valH - fSz) * 0.5f}, COL_WHITE, driverName);
     x += L.nameW + 8.f;
 
-    const char* labels[4] = { "SECTOR 1", "SECTOR 2", "SECTOR 3", "LAP TIME" };
-    for (int i = 0; i < 4; ++i) {
-        SecStyle st = (i < 3) ? secStyle[i] : SEC_NONE;
-        const char* val = (i < 3) ? secTime[i] : lapTime;
+    for (int i = 0; i <= sectors; ++i) {
+        SecStyle st = (i < sectors) ? secStyle[i] : SEC_NONE;
+        const char* val = (i < sectors) ? secTime[i] : lapTime;
+        char label[16];
+        if (i < sectors) snprintf(label, sizeof(label), "SECTOR %d", i + 1);
+        else             snprintf(label, sizeof(label), "LAP TIME");
 
         dl->AddRectFilled({x, base.y}, {x + L.cellW, base.y + hdrH}, IM_COL32(0x29,0x29,0x29,255));
         dl->AddText(ctx.russo, fSz * 0.8f, {x + 8.f, base.y + (hdrH - fSz * 0.8f) * 0.5f},
-                    COL_WHITE, labels[i]);
+                    COL_WHITE, label);
 
         dl->AddRectFilled({x, valY}, {x + L.cellW, valY + valH}, st.bg);
         dl->AddRectFilled({x, valY}, {x + 4.f, valY + valH}, st.accent);
@@ -208,62 +176,64 @@ void RenderTrackMapWindow(const ProContext& ctx, int32_t vehicleId,
 
     dl->AddRectFilled(base, {base.x + mapW, base.y + mapH}, COL_BG);
 
+    const TrackGeometry::SnapshotPtr track = TrackGeometry::Current();
+    const int nSec = std::min(track->sectorCount, MAX_SEC);
+
     // ── Gather lap/sector data under the vehicles lock ─────────────────────────
-    float curBt[4]; for (int i = 0; i < 4; ++i) curBt[i] = -1.f;
-    float bestS[3]; bool bestV[3] = { false };   // personal best PER SECTOR (all laps)
-    float sessS[3]; bool sessV[3] = { false };   // overall best PER SECTOR (all cars)
-    float lastS[3]; bool lastV[3] = { false };
+    float curBt[MAX_SEC + 1]; for (int i = 0; i <= MAX_SEC; ++i) curBt[i] = -1.f;
+    float bestS[MAX_SEC]; bool bestV[MAX_SEC] = { false };   // personal best PER SECTOR (all laps)
+    float sessS[MAX_SEC]; bool sessV[MAX_SEC] = { false };   // overall best PER SECTOR (all cars)
+    float lastS[MAX_SEC]; bool lastV[MAX_SEC] = { false };
     int   curLapNum = 0;
-    double curProg  = 0.0;
     float curTimer  = 0.f;
     std::string dname = "---";
     char  dnum[8] = "?";
     float lapPrev = g_race_manager ? g_race_manager->GetVehiclePreviousLapTime(vehicleId) : -1.f;
     {
         std::lock_guard<std::mutex> lk(g_vehicles_mutex);
-        auto lapTimeOf = [](Vehicle& v, int ln) -> float {
-            auto m = v.m_laps.find(ln);
-            return (m != v.m_laps.end()) ? m->second.lapTime : -1.f;
-        };
         auto it = g_vehicles.find(vehicleId);
         if (it != g_vehicles.end()) {
             Vehicle& v = it->second;
             dname     = v.name;
             snprintf(dnum, sizeof(dnum), "%d", vehicleId);
             curLapNum = v.m_current_lap_number;
-            curProg   = v.m_track_progress;
             curTimer  = v.m_current_lap_timer;
 
-            auto cit = v.laps.find(curLapNum);
-            if (cit != v.laps.end()) crossTimes(cit->second.samples, curBt);
-
-            // Best PER SECTOR across EVERY lap (theoretical-best sectors), so a slow
-            // sector inside an overall-fast lap is still judged against the fastest
-            // that sector has ever been driven.
-            for (auto& [ln, sess] : v.laps) {
-                float z[3]; bool zv[3]; secCompleted(sess.samples, lapTimeOf(v, ln), z, zv);
-                accMin(bestS, bestV, z, zv);
+            const TimingRecord& rec = v.m_timing;
+            for (int k = 0; k < nSec; ++k) {
+                const int64_t b = rec.BoundaryUs(k);
+                if (b >= 0) curBt[k] = (float)(b / 1e6);
             }
-            auto lit = v.laps.find(curLapNum - 1);
-            if (lit != v.laps.end()) secCompleted(lit->second.samples, lapTimeOf(v, curLapNum - 1), lastS, lastV);
         }
-        for (auto& [id, v] : g_vehicles)
-            for (auto& [ln, sess] : v.laps) {
-                float z[3]; bool zv[3]; secCompleted(sess.samples, lapTimeOf(v, ln), z, zv);
-                accMin(sessS, sessV, z, zv);
-            }
+    }
+
+    // Best PER SECTOR across EVERY lap (theoretical-best sectors), so a slow
+    // sector inside an overall-fast lap is still judged against the fastest
+    // that sector has ever been driven. Precomputed per lap by SessionStats.
+    {
+        const SessionStats::TablePtr stats = SessionStats::Current();
+        for (int k = 0; k < nSec; ++k)
+            if (stats->bestSectorUs[k] >= 0) { sessS[k] = (float)(stats->bestSectorUs[k] / 1e6); sessV[k] = true; }
+        if (const SessionStats::VehicleStats* vs = stats->Find(vehicleId)) {
+            for (int k = 0; k < nSec; ++k)
+                if (vs->bestSectorUs[k] >= 0) { bestS[k] = (float)(vs->bestSectorUs[k] / 1e6); bestV[k] = true; }
+            if (vs->lastLapNumber == curLapNum - 1)
+                for (int k = 0; k < nSec; ++k)
+                    if (vs->lastSectorUs[k] >= 0) { lastS[k] = (float)(vs->lastSectorUs[k] / 1e6); lastV[k] = true; }
+        }
     }
 
     // ── Sector display: live current lap, finalize on cross, hold 10s ──────────
-    char     secBuf[3][16];
-    SecStyle secSty[3] = { SEC_NONE, SEC_NONE, SEC_NONE };
+    char     secBuf[MAX_SEC][16];
+    SecStyle secSty[MAX_SEC];
+    for (int i = 0; i < MAX_SEC; ++i) secSty[i] = SEC_NONE;
     {
         auto now = std::chrono::steady_clock::now();
         SecHold& H = s_hold[vehicleId];
 
         if (H.lastLap != INT_MIN && curLapNum != H.lastLap) {
-            if (lastV[0] || lastV[1] || lastV[2]) {
-                for (int i = 0; i < 3; ++i) {
+            if (std::any_of(lastV, lastV + nSec, [](bool v) { return v; })) {
+                for (int i = 0; i < nSec; ++i) {
                     if (lastV[i]) { fmtSector(lastS[i], H.tstr[i], sizeof(H.tstr[i]));
                                     H.sty[i] = colorFor(lastS[i], bestS, bestV, sessS, sessV, i); }
                     else { snprintf(H.tstr[i], sizeof(H.tstr[i]), "--.---"); H.sty[i] = SEC_NONE; }
@@ -275,15 +245,17 @@ void RenderTrackMapWindow(const ProContext& ctx, int32_t vehicleId,
         H.lastLap = curLapNum;
 
         if (H.has && now < H.holdUntil) {
-            for (int i = 0; i < 3; ++i) { snprintf(secBuf[i], sizeof(secBuf[i]), "%s", H.tstr[i]); secSty[i] = H.sty[i]; }
+            for (int i = 0; i < nSec; ++i) { snprintf(secBuf[i], sizeof(secBuf[i]), "%s", H.tstr[i]); secSty[i] = H.sty[i]; }
         } else {
-            float sc[3]; bool sv[3];
-            for (int k = 0; k < 3; ++k) {
+            float sc[MAX_SEC]; bool sv[MAX_SEC];
+            for (int k = 0; k < nSec; ++k) {
                 if (curBt[k] >= 0.f && curBt[k + 1] >= 0.f) { sc[k] = curBt[k + 1] - curBt[k]; sv[k] = true; }
                 else { sc[k] = 0.f; sv[k] = false; }
             }
-            int active = (int)(curProg * 3.0); if (active < 0) active = 0; if (active > 2) active = 2;
-            for (int i = 0; i < 3; ++i) {
+            // Running sector: the last boundary crossed this lap
+            int active = 0;
+            for (int k = 0; k < nSec; ++k) if (curBt[k] >= 0.f) active = k;
+            for (int i = 0; i < nSec; ++i) {
                 if (sv[i]) {
                     fmtSector(sc[i], secBuf[i], sizeof(secBuf[i]));
                     secSty[i] = colorFor(sc[i], bestS, bestV, sessS, sessV, i);
@@ -303,7 +275,8 @@ void RenderTrackMapWindow(const ProContext& ctx, int32_t vehicleId,
     else               snprintf(lapBuf, sizeof(lapBuf), "--:--.---");
 
     // ── Track drawing ──────────────────────────────────────────────────────────
-    if (g_smooth_track_points.empty()) {
+    const std::vector<SplinePoint>& pts = track->points;
+    if (pts.empty()) {
         const char* msg = "No track loaded — drag a .trk2 file here";
         ImVec2 tSz = ImGui::CalcTextSize(msg);
         ImGui::SetCursorScreenPos({base.x + (mapW - tSz.x) * 0.5f, base.y + (mapH - tSz.y) * 0.5f});
@@ -311,14 +284,8 @@ void RenderTrackMapWindow(const ProContext& ctx, int32_t vehicleId,
         ImGui::TextUnformatted(msg);
         ImGui::PopStyleColor();
     } else {
-        const size_t n = g_smooth_track_points.size();
-        glm::vec2 lo = g_smooth_track_points[0].position, hi = lo;
-        for (auto& sp : g_smooth_track_points) {
-            lo.x = lo.x < sp.position.x ? lo.x : sp.position.x;
-            lo.y = lo.y < sp.position.y ? lo.y : sp.position.y;
-            hi.x = hi.x > sp.position.x ? hi.x : sp.position.x;
-            hi.y = hi.y > sp.position.y ? hi.y : sp.position.y;
-        }
+        const size_t n = pts.size();
+        const glm::vec2 lo = track->boundsMin, hi = track->boundsMax;
         float rX = hi.x - lo.x; if (rX < 1e-6f) rX = 1.f;
         float rY = hi.y - lo.y; if (rY < 1e-6f) rY = 1.f;
         float pad = fmaxf(80.f * ux, 64.f);   // room for off-track sector cards
@@ -331,21 +298,6 @@ void RenderTrackMapWindow(const ProContext& ctx, int32_t vehicleId,
             return {offX + (p.x - lo.x)*scale, offY + (rY - (p.y - lo.y))*scale};
         };
 
-        // Cumulative arc length → so visual boundaries match the arc-length-based
-        // lap progress used for timing (point indices are NOT evenly spaced).
-        std::vector<float> cum(n, 0.f);
-        for (size_t i = 1; i < n; ++i) {
-            glm::vec2 d = g_smooth_track_points[i].position - g_smooth_track_points[i-1].position;
-            cum[i] = cum[i-1] + sqrtf(d.x*d.x + d.y*d.y);
-        }
-        glm::vec2 dc = g_smooth_track_points[0].position - g_smooth_track_points[n-1].position;
-        float total = cum[n-1] + sqrtf(dc.x*dc.x + dc.y*dc.y); if (total < 1e-6f) total = 1.f;
-        auto idxAtProg = [&](double prog) -> size_t {
-            float target = (float)prog * total;
-            for (size_t i = 0; i < n; ++i) if (cum[i] >= target) return i;
-            return n - 1;
-        };
-
         // Road: white center line + thin white edge lines (dark gaps between).
         float roadTh  = fmaxf(mapH * 0.018f, 8.f);
         float outerTh = roadTh;            // outer white (forms the two edge lines)
@@ -355,24 +307,24 @@ void RenderTrackMapWindow(const ProContext& ctx, int32_t vehicleId,
         const ImU32 dark  = IM_COL32(0x1A,0x1A,0x1A,255);
         auto drawRing = [&](float th, ImU32 col) {
             for (size_t i = 1; i < n; ++i)
-                dl->AddLine(toScreen(g_smooth_track_points[i-1].position),
-                            toScreen(g_smooth_track_points[i].position), col, th);
+                dl->AddLine(toScreen(pts[i-1].position),
+                            toScreen(pts[i].position), col, th);
             if (n > 2)
-                dl->AddLine(toScreen(g_smooth_track_points.back().position),
-                            toScreen(g_smooth_track_points.front().position), col, th);
+                dl->AddLine(toScreen(pts.back().position),
+                            toScreen(pts.front().position), col, th);
         };
         drawRing(outerTh, white);
         drawRing(midTh,   dark);
         drawRing(innerTh, white);
 
-        auto drawCross = [&](size_t idx) {
-            size_t a = (idx + n - 1) % n, b = (idx + 1) % n;
-            ImVec2 pa = toScreen(g_smooth_track_points[a].position);
-            ImVec2 pb = toScreen(g_smooth_track_points[b].position);
+        // Boundary mark along a timing line (p1 -> p2), centred on the road
+        auto drawCross = [&](glm::vec2 p1, glm::vec2 p2) {
+            ImVec2 pa = toScreen(p1);
+            ImVec2 pb = toScreen(p2);
             ImVec2 d = {pb.x - pa.x, pb.y - pa.y};
             float L = sqrtf(d.x*d.x + d.y*d.y); if (L < 1e-3f) return;
-            ImVec2 perp = {-d.y / L, d.x / L};
-            ImVec2 c = toScreen(g_smooth_track_points[idx].position);
+            ImVec2 perp = {d.x / L, d.y / L};
+            ImVec2 c = toScreen((p1 + p2) * 0.5f);
             float hl = outerTh * 0.6f + 3.f;
             dl->AddLine({c.x - perp.x*hl, c.y - perp.y*hl},
                         {c.x + perp.x*hl, c.y + perp.y*hl}, SEC_MARK, 2.f);
@@ -380,8 +332,8 @@ void RenderTrackMapWindow(const ProContext& ctx, int32_t vehicleId,
 
         // Neutral, upright sector indicator card placed fully off the track, sized
         // to the reference aspect ratio with a max size so it does not stretch.
-        auto drawSectorCard = [&](size_t idx, const char* label, const char* timeStr) {
-            ImVec2 c = toScreen(g_smooth_track_points[idx].position);
+        auto drawSectorCard = [&](glm::vec2 at, const char* label, const char* timeStr) {
+            ImVec2 c = toScreen(at);
             ImVec2 dir = {c.x - mapCenter.x, c.y - mapCenter.y};
             float L = sqrtf(dir.x*dir.x + dir.y*dir.y); if (L < 1e-3f) { dir = {0,-1}; L = 1; }
             dir = {dir.x / L, dir.y / L};
@@ -408,18 +360,25 @@ void RenderTrackMapWindow(const ProContext& ctx, int32_t vehicleId,
                         {p.x + 11.f, v0.y + (valH - valFsz)*0.5f}, COL_WHITE, timeStr);
         };
 
-        size_t i1 = idxAtProg(1.0 / 3.0);
-        size_t i2 = idxAtProg(2.0 / 3.0);
-        drawCross(i1); drawSectorCard(i1, "SECTOR 1", secBuf[0]);
-        drawCross(i2); drawSectorCard(i2, "SECTOR 2", secBuf[1]);
-        drawCross(0);  drawSectorCard(0,  "SECTOR 3", secBuf[2]);
+        // Each sector's card sits at the line that ends it; start/finish ends the last
+        char label[16];
+        int  sec = 0;
+        for (const TrackGeometry::TimingLine& tl : track->timingLines) {
+            if (tl.kind != TrackGeometry::TimingLine::Kind::Sector || sec >= nSec - 1) continue;
+            snprintf(label, sizeof(label), "SECTOR %d", sec + 1);
+            drawCross(tl.p1, tl.p2); drawSectorCard((tl.p1 + tl.p2) * 0.5f, label, secBuf[sec]);
+            ++sec;
+        }
+        if (track->hasStartFinish) drawCross(track->startFinishP1, track->startFinishP2);
+        snprintf(label, sizeof(label), "SECTOR %d", nSec);
+        drawSectorCard(pts.front().position, label, secBuf[nSec - 1]);
 
         // Start/finish checkered flag
-        ImVec2 sf = toScreen(g_smooth_track_points.front().position);
+        ImVec2 sf = toScreen(pts.front().position);
         DrawFlag(dl, {sf.x + outerTh * 0.8f, sf.y - outerTh - 14.f}, fmaxf(11.f * ux, 9.f));
 
         // Vehicle dot — gold circle, white outline + leader-line callout.
-        // g_smooth_track_points already carry the centering offset baked in by
+        // Track points already carry the centering offset baked in by
         // rebuildTrackCacheFromEdges, so the raw vehicle position must be
         // shifted by the same getTrackRenderOffset() to land on the track.
         double vx = 0, vy = 0; bool found = false;
@@ -454,15 +413,16 @@ void RenderTrackMapWindow(const ProContext& ctx, int32_t vehicleId,
 
     // ── Bottom status strip — floating element, sized to content + centered ────
     float cellH = STRIP_H - 2.f * STRIP_PAD;
-    StripLayout L = computeStrip(mapW - 2.f * SIDE_MARGIN - 2.f * STRIP_PAD, cellH, ux);
+    StripLayout L = computeStrip(mapW - 2.f * SIDE_MARGIN - 2.f * STRIP_PAD, cellH, ux, nSec + 1);
     float containerW = L.contentW + 2.f * STRIP_PAD;
     ImVec2 outP = {base.x + (mapW - containerW) * 0.5f, base.y + mapH + TOP_GAP};
     dl->AddRectFilled(outP, {outP.x + containerW, outP.y + STRIP_H}, IM_COL32(0x12,0x12,0x12,255), 5.f);
     dl->AddRect      (outP, {outP.x + containerW, outP.y + STRIP_H}, COL_GOLD_DIM, 5.f, 0, 1.f);
 
-    const char* secT[3] = { secBuf[0], secBuf[1], secBuf[2] };
+    const char* secT[MAX_SEC];
+    for (int i = 0; i < nSec; ++i) secT[i] = secBuf[i];
     DrawStatusStrip(dl, ctx, {outP.x + STRIP_PAD, outP.y + STRIP_PAD}, cellH, L,
-                    dnum, dname.c_str(), secT, secSty, lapBuf, z);
+                    dnum, dname.c_str(), nSec, secT, secSty, lapBuf, z);
 
     ImGui::End();
     ImGui::PopStyleColor(); // WindowBg override
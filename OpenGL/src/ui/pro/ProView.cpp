@@ -9,6 +9,7 @@
 #include "ProSectors.h"
 #include "../../vehicle/Vehicle.h"
 #include "../../racing/RaceManager.h"
+#include "../../racing/RaceSnapshot.h"
 #include "../../racing/StopReset/StartStop.h"
 #include "../UI_Config.h"
 #include <imgui.h>
@@ -20,8 +21,6 @@
 #include <fstream>
 
 extern RaceManager* g_race_manager;
-extern std::map<int32_t, Vehicle> g_vehicles;
-extern std::mutex g_vehicles_mutex;
 extern int g_focused_vehicle_id;
 
 namespace Pro {
@@ -77,12 +76,9 @@ float PanelZoom(const char* key) {
 
 static int32_t getDisplayVehicleId() {
     if (g_focused_vehicle_id != -1) return g_focused_vehicle_id;
-    if (g_race_manager) {
-        auto standings = g_race_manager->GetStandings();
-        if (!standings.empty()) return standings.front().vehicleID;
-    }
-    std::lock_guard<std::mutex> lk(g_vehicles_mutex);
-    if (!g_vehicles.empty()) return g_vehicles.begin()->first;
+    const RaceFrame& f = RaceSnapshot::Current();
+    if (!f.standings.empty()) return f.standings.front().vehicleID;
+    if (f.Size() > 0) return f.ids.front();
     return -1;
 }
 
@@ -0,0 +1,171 @@
+#include "PlayoutDelay.h"
+#include <algorithm>
+#include <cmath>
+
+// ============================================================================
+// ARRIVALS
+// ============================================================================
+void PlayoutDelay::OnArrival(double timestamp, double arrivalTime)
+{
+    if (!m_haveLast) {
+        m_haveLast = true;
+        m_lastTimestamp = timestamp;
+        m_lastTransit = arrivalTime - timestamp;
+        return;
+    }
+
+    // RFC 3550: smoothed change in transit time between consecutive packets
+    const double transit = arrivalTime - timestamp;
+    m_jitterSum += (std::abs(transit - m_lastTransit) - m_jitterSum) / 16.0;
+    m_lastTransit = transit;
+    m_jitter.store(m_jitterSum, std::memory_order_relaxed);
+
+    m_holds[m_head] = arrivalTime - m_lastTimestamp;
+    m_intervals[m_head] = timestamp - m_lastTimestamp;
+    m_head = (m_head + 1) % HISTORY;
+    m_count = std::min(m_count + 1, HISTORY);
+    m_lastTimestamp = timestamp;
+
+    UpdateTarget();
+}
+
+void PlayoutDelay::ResetArrivals()
+{
+    m_head = 0;
+    m_count = 0;
+    m_haveLast = false;
+    m_jitterSum = 0.0;
+    m_target.store(INITIAL_DELAY, std::memory_order_relaxed);
+    m_settled.store(false, std::memory_order_relaxed);
+    m_interval.store(0.0, std::memory_order_relaxed);
+    m_jitter.store(0.0, std::memory_order_relaxed);
+    m_lossEstimate.store(0.0, std::memory_order_relaxed);
+}
+
+void PlayoutDelay::UpdateTarget()
+{
+    double sorted[HISTORY] = {};
+
+    // Median send interval; a gap of N intervals means N - 1 snapshots lost
+    std::copy(m_intervals, m_intervals + m_count, sorted);
+    std::nth_element(sorted, sorted + m_count / 2, sorted + m_count);
+    const double interval = sorted[m_count / 2];
+    m_interval.store(interval, std::memory_order_relaxed);
+    if (interval > 0.0) {
+        double missing = 0.0;
+        for (size_t i = 0; i < m_count; ++i) {
+            missing += std::max(0.0, std::round(m_intervals[i] / interval) - 1.0);
+        }
+        m_lossEstimate.store(missing / (m_count + missing), std::memory_order_relaxed);
+    }
+
+    // The hold that all but TARGET_UNDERRUN of the gaps fit in
+    std::copy(m_holds, m_holds + m_count, sorted);
+    const size_t rank = std::min(m_count - 1,
+        static_cast<size_t>(std::ceil((1.0 - TARGET_UNDERRUN) * m_count)) - 1);
+    std::nth_element(sorted, sorted + rank, sorted + m_count);
+    m_target.store(std::clamp(sorted[rank] + MARGIN, MIN_DELAY, MAX_DELAY), std::memory_order_relaxed);
+    m_settled.store(m_count >= SETTLE_SAMPLES, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// PLAYOUT CLOCK
+// ============================================================================
+double PlayoutDelay::Advance(double renderTime)
+{
+    const double dt = (m_lastRender < 0.0) ? 0.0 : std::clamp(renderTime - m_lastRender, 0.0, 0.1);
+    m_lastRender = renderTime;
+
+    const double target = m_target.load(std::memory_order_relaxed);
+    if (!m_settled.load(std::memory_order_relaxed)) {
+        // Vehicle just appeared: nothing on screen to keep smooth yet
+        m_delay = target;
+    } else if (target > m_delay) {
+        m_delay = std::min(target, m_delay + WARP_SLOWER * dt);
+    } else {
+        m_delay = std::max(target, m_delay - WARP_FASTER * dt);
+    }
+    return m_delay;
+}
+
+void PlayoutDelay::OnRendered(bool underrun)
+{
+    ++m_frames;
+    if (underrun) {
+        ++m_underruns;
+    }
+}
+
+void PlayoutDelay::ResetCounters()
+{
+    m_frames = 0;
+    m_underruns = 0;
+}
+
+void PlayoutDelay::ResetClock()
+{
+    m_delay = INITIAL_DELAY;
+    m_lastRender = -1.0;
+    ResetCounters();
+}
+
+PlayoutDelay::Stats PlayoutDelay::GetStats() const
+{
+    Stats s;
+    s.delay = m_delay;
+    s.target = m_target.load(std::memory_order_relaxed);
+    s.interval = m_interval.load(std::memory_order_relaxed);
+    s.jitter = m_jitter.load(std::memory_order_relaxed);
+    s.loss = m_lossEstimate.load(std::memory_order_relaxed);
+    s.frames = m_frames;
+    s.underruns = m_underruns;
+    return s;
+}
+
+// ============================================================================
+// TRACE REPLAY
+// ============================================================================
+PlayoutDelay::ReplayResult PlayoutDelay::ReplayTrace(const Arrival* trace, size_t count, double frameRate)
+{
+    ReplayResult result;
+    if (count == 0 || frameRate <= 0.0) {
+        return result;
+    }
+
+    PlayoutDelay playout;
+    size_t next = 0;
+    size_t buffered = 0;
+    double newest = 0.0;
+    double delaySum = 0.0;
+
+    const double start = trace[0].arrivalTime;
+    const double end = trace[count - 1].arrivalTime;
+    for (uint64_t frame = 0; ; ++frame) {
+        const double t = start + frame / frameRate;
+        if (t > end) {
+            break;
+        }
+        for (; next < count && trace[next].arrivalTime <= t; ++next) {
+            // Same rule as VehicleBuffer::PushLocked
+            if (buffered > 0 && trace[next].timestamp <= newest) {
+                continue;
+            }
+            playout.OnArrival(trace[next].timestamp, trace[next].arrivalTime);
+            newest = trace[next].timestamp;
+            ++buffered;
+        }
+        if (buffered < 2) {
+            continue;  // The renderer falls back to raw telemetry
+        }
+
+        const double delay = playout.Advance(t);
+        playout.OnRendered(t - delay > newest);
+        delaySum += delay;
+        result.maxDelay = std::max(result.maxDelay, delay);
+    }
+
+    result.frames = playout.m_frames;
+    result.underruns = playout.m_underruns;
+    result.meanDelay = result.frames ? delaySum / result.frames : 0.0;
+    return result;
+}
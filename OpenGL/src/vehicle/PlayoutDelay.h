@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// PLAYOUT DELAY - adaptive jitter buffer depth for one vehicle
+//
+// The renderer draws a vehicle at (render time - delay). The delay must cover
+// the wait for the next snapshot: when snapshot k arrives, the renderer has
+// been holding snapshot k-1 since its timestamp, so this gap needed
+//
+//     hold = arrival(k) - timestamp(k-1)
+//
+// = one send interval + that packet's extra transit (jitter) + every interval
+// lost in between. The target delay is the (1 - TARGET_UNDERRUN) quantile of
+// the last HISTORY holds, so a 20 Hz LAN car plays out ~55 ms behind while a
+// 10 Hz LoRa kart with lost packets gets enough to bridge them.
+//
+// The delay actually used moves towards the target at a bounded rate — the
+// playout clock runs a few percent slow or fast — so a change in the link
+// never makes the car jump.
+//
+// Pure and deterministic: every time comes from the caller (VehicleInterpolator
+// clock, seconds), which is what ReplayTrace relies on.
+//
+// One producer thread (arrivals) and one consumer thread (render) may use it
+// concurrently; they share only the published atomics.
+// ============================================================================
+class PlayoutDelay
+{
+public:
+    // --- Producer ------------------------------------------------------------
+    // Snapshot arrival (ingest thread). Out-of-order snapshots are not passed in.
+    void OnArrival(double timestamp, double arrivalTime);
+
+    // Forget the link measurements (slot handed to another vehicle)
+    void ResetArrivals();
+
+    // --- Consumer ------------------------------------------------------------
+    // Once per rendered frame: warps the current delay towards the target and
+    // returns it.
+    double Advance(double renderTime);
+
+    // Outcome of a frame drawn with Advance()'s delay: true when the buffer ran
+    // dry (the render time was past the newest snapshot).
+    void OnRendered(bool underrun);
+
+    void ResetCounters();
+
+    // Back to INITIAL_DELAY with no counters (slot handed to another vehicle)
+    void ResetClock();
+
+    struct Stats {
+        double   delay = 0.0;        // In use, seconds
+        double   target = 0.0;       // Quantile of the holds, seconds
+        double   interval = 0.0;     // Median send interval, seconds
+        double   jitter = 0.0;       // RFC 3550 interarrival jitter, seconds
+        double   loss = 0.0;         // Fraction of snapshots missing from the sequence
+        uint64_t frames = 0;
+        uint64_t underruns = 0;
+    };
+    // Consumer thread
+    Stats GetStats() const;
+
+    // One arrival of a recorded trace.
+    struct Arrival {
+        double timestamp;
+        double arrivalTime;
+    };
+
+    struct ReplayResult {
+        uint64_t frames = 0;
+        uint64_t underruns = 0;
+        double   meanDelay = 0.0;    // Added latency, averaged over the frames
+        double   maxDelay = 0.0;
+    };
+
+    // Plays `trace` (in arrival order) through a fresh PlayoutDelay, rendering
+    // at `frameRate` Hz from the first arrival to the last. Same trace, same
+    // result.
+    static ReplayResult ReplayTrace(const Arrival* trace, size_t count, double frameRate);
+
+    static constexpr double INITIAL_DELAY = 0.033;     // Until the first hold is measured
+    static constexpr double MIN_DELAY = 0.010;
+    static constexpr double MAX_DELAY = 0.500;
+    static constexpr double TARGET_UNDERRUN = 0.01;    // Share of gaps allowed to run dry
+    static constexpr double MARGIN = 0.003;            // Render/ingest scheduling slack
+
+private:
+    static constexpr size_t HISTORY = 128;             // Gaps in the quantile
+    static constexpr size_t SETTLE_SAMPLES = 8;        // Snap to the target until then
+    static constexpr double WARP_SLOWER = 0.10;        // Delay growth per second of playout
+    static constexpr double WARP_FASTER = 0.02;        // Delay shrink per second of playout
+
+    void UpdateTarget();
+
+    // Producer only
+    double   m_holds[HISTORY] = {};
+    double   m_intervals[HISTORY] = {};
+    size_t   m_head = 0;
+    size_t   m_count = 0;
+    bool     m_haveLast = false;
+    double   m_lastTimestamp = 0.0;
+    double   m_lastTransit = 0.0;
+    double   m_jitterSum = 0.0;
+
+    // Published by the producer
+    std::atomic<double> m_target{ INITIAL_DELAY };
+    std::atomic<bool>   m_settled{ false };
+    std::atomic<double> m_interval{ 0.0 };
+    std::atomic<double> m_jitter{ 0.0 };
+    std::atomic<double> m_lossEstimate{ 0.0 };
+
+    // Consumer only
+    double   m_delay = INITIAL_DELAY;
+    double   m_lastRender = -1.0;
+    uint64_t m_frames = 0;
+    uint64_t m_underruns = 0;
+};
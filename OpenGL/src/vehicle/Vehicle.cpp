@@ -3,12 +3,16 @@
 #include "../input/Input.h"
 #include "../Config.h"
 #include "../rendering/Interpolation.h"
+#include "../track/TrackGeometry.h"
 #include "../rendering/VehicleNameRenderer.h"
+#include "../racing/RaceSnapshot.h"
 #include "../../UI.h"
+#include "../core/Log.h"
+#include "../network/TelemetryLatency.h"
 #include <cmath>
-#include <iostream>
 #include <iomanip>
 #include <thread>
+#include <unordered_map>
 #include <GeographicLib/UTMUPS.hpp>
 
 extern UI* g_ui;
@@ -35,7 +39,7 @@ Vehicle::Vehicle()
     // ✅ Проверяем что карта загружена
     if (!g_is_map_loaded)
     {
-        std::cerr << "Error: Cannot create vehicle - map not loaded!" << std::endl;
+        LOG_ERROR(Vehicle, "Error: Cannot create vehicle - map not loaded!");
         return;
     }
 
@@ -44,19 +48,20 @@ Vehicle::Vehicle()
     m_normalized_y = 0.0;
 
     // Конвертируем обратно в GPS через origin UTM
-    m_meters_easting = g_map_origin.m_origin_meters_easting + (m_normalized_x * MapConstants::MAP_SIZE);
-    m_meters_northing = g_map_origin.m_origin_meters_northing + (m_normalized_y * MapConstants::MAP_SIZE);
+    const MapOrigin origin = TrackGeometry::CurrentOrigin();
+    m_meters_easting = origin.m_origin_meters_easting + (m_normalized_x * MapConstants::MAP_SIZE);
+    m_meters_northing = origin.m_origin_meters_northing + (m_normalized_y * MapConstants::MAP_SIZE);
 
     // Конвертируем UTM в GPS
     try {
         using namespace GeographicLib;
-        bool northp = (g_map_origin.m_origin_zone_char >= 'N');  // ✅ Use correct hemisphere
-        UTMUPS::Reverse(g_map_origin.m_origin_zone_int, northp, 
+        bool northp = (origin.m_origin_zone_char >= 'N');  // ✅ Use correct hemisphere
+        UTMUPS::Reverse(origin.m_origin_zone_int, northp, 
                        m_meters_easting, m_meters_northing, 
                        m_lat_dd, m_lon_dd);
     }
     catch (const std::exception& e) {
-        std::cerr << "GeographicLib Error: " << e.what() << std::endl;
+        LOG_ERROR(Vehicle, "GeographicLib Error: " << e.what());
         m_lat_dd = 0;
         m_lon_dd = 0;
     }
@@ -73,7 +78,7 @@ Vehicle::Vehicle()
     // ✅ Вычисляем цвет ОДИН раз при создании
     m_cached_color = getColor();
     
-    std::cout << "Vehicle #" << m_id << " created at center (0, 0), GPS: (" << m_lat_dd << ", " << m_lon_dd << ")" << std::endl;
+    LOG_INFO(Vehicle, "Vehicle #" << m_id << " created at center (0, 0), GPS: (" << m_lat_dd << ", " << m_lon_dd << ")");
 }
 
 // ✅ Конструктор с начальной позицией на треке
@@ -82,7 +87,7 @@ Vehicle::Vehicle(double normalized_x, double normalized_y)
     // ✅ Проверяем что карта загружена
     if (!g_is_map_loaded)
     {
-        std::cerr << "Error: Cannot create vehicle - map not loaded!" << std::endl;
+        LOG_ERROR(Vehicle, "Error: Cannot create vehicle - map not loaded!");
         return;
     }
 
@@ -93,19 +98,20 @@ Vehicle::Vehicle(double normalized_x, double normalized_y)
     // getTrackRenderOffset() keeps vehicles aligned with the centred track.
 
     // Конвертируем обратно в GPS через origin UTM
-    m_meters_easting = g_map_origin.m_origin_meters_easting + (m_normalized_x * MapConstants::MAP_SIZE);
-    m_meters_northing = g_map_origin.m_origin_meters_northing + (m_normalized_y * MapConstants::MAP_SIZE);
+    const MapOrigin origin = TrackGeometry::CurrentOrigin();
+    m_meters_easting = origin.m_origin_meters_easting + (m_normalized_x * MapConstants::MAP_SIZE);
+    m_meters_northing = origin.m_origin_meters_northing + (m_normalized_y * MapConstants::MAP_SIZE);
 
     // Конвертируем UTM в GPS
     try {
         using namespace GeographicLib;
-        bool northp = (g_map_origin.m_origin_zone_char >= 'N');  // ✅ Use correct hemisphere
-        UTMUPS::Reverse(g_map_origin.m_origin_zone_int, northp, 
+        bool northp = (origin.m_origin_zone_char >= 'N');  // ✅ Use correct hemisphere
+        UTMUPS::Reverse(origin.m_origin_zone_int, northp, 
                        m_meters_easting, m_meters_northing, 
                        m_lat_dd, m_lon_dd);
     }
     catch (const std::exception& e) {
-        std::cerr << "GeographicLib Error: " << e.what() << std::endl;
+        LOG_ERROR(Vehicle, "GeographicLib Error: " << e.what());
         m_lat_dd = 0;
         m_lon_dd = 0;
     }
@@ -126,7 +132,7 @@ Vehicle::Vehicle(double normalized_x, double normalized_y)
     // ✅ Вычисляем цвет ОДИН раз при создании
     m_cached_color = getColor();
     
-    std::cout << "Vehicle #" << m_id << " created at START line (" << m_normalized_x << ", " << m_normalized_y << "), GPS: (" << m_lat_dd << ", " << m_lon_dd << ")" << std::endl;
+    LOG_INFO(Vehicle, "Vehicle #" << m_id << " created at START line (" << m_normalized_x << ", " << m_normalized_y << "), GPS: (" << m_lat_dd << ", " << m_lon_dd << ")");
 }
 
 // ✅ Конструктор с явным ID (для симуляции)
@@ -135,7 +141,7 @@ Vehicle::Vehicle(int32_t id, double normalized_x, double normalized_y)
     // ✅ Проверяем что карта загружена
     if (!g_is_map_loaded)
     {
-        std::cerr << "Error: Cannot create vehicle - map not loaded!" << std::endl;
+        LOG_ERROR(Vehicle, "Error: Cannot create vehicle - map not loaded!");
         return;
     }
 
@@ -149,19 +155,20 @@ Vehicle::Vehicle(int32_t id, double normalized_x, double normalized_y)
     // getTrackRenderOffset() keeps vehicles aligned with the centred track.
 
     // Конвертируем обратно в GPS через origin UTM
-    m_meters_easting = g_map_origin.m_origin_meters_easting + (m_normalized_x * MapConstants::MAP_SIZE);
-    m_meters_northing = g_map_origin.m_origin_meters_northing + (m_normalized_y * MapConstants::MAP_SIZE);
+    const MapOrigin origin = TrackGeometry::CurrentOrigin();
+    m_meters_easting = origin.m_origin_meters_easting + (m_normalized_x * MapConstants::MAP_SIZE);
+    m_meters_northing = origin.m_origin_meters_northing + (m_normalized_y * MapConstants::MAP_SIZE);
 
     // Конвертируем UTM в GPS
     try {
         using namespace GeographicLib;
-        int zone = g_map_origin.m_origin_zone_int;
-        bool northp = (g_map_origin.m_origin_zone_char >= 'N');  // ✅ Use correct hemisphere
+        int zone = origin.m_origin_zone_int;
+        bool northp = (origin.m_origin_zone_char >= 'N');  // ✅ Use correct hemisphere
         UTMUPS::Reverse(zone, northp, m_meters_easting, m_meters_northing,
                        m_lat_dd, m_lon_dd);
     }
     catch (const std::exception& e) {
-        std::cerr << "GeographicLib Error: " << e.what() << std::endl;
+        LOG_ERROR(Vehicle, "GeographicLib Error: " << e.what());
         m_lat_dd = 0;
         m_lon_dd = 0;
     }
@@ -181,7 +188,7 @@ Vehicle::Vehicle(int32_t id, double normalized_x, double normalized_y)
     // ✅ Вычисляем цвет ОДИН раз при создании
     m_cached_color = getColor();
 
-    std::cout << "Vehicle #" << m_id << " created at START line (" << m_normalized_x << ", " << m_normalized_y << "), GPS: (" << m_lat_dd << ", " << m_lon_dd << ")" << std::endl;
+    LOG_INFO(Vehicle, "Vehicle #" << m_id << " created at START line (" << m_normalized_x << ", " << m_normalized_y << "), GPS: (" << m_lat_dd << ", " << m_lon_dd << ")");
 }
 
 Vehicle::Vehicle(const TelemetryPacket& packet)
@@ -190,20 +197,20 @@ Vehicle::Vehicle(const TelemetryPacket& packet)
     m_lon_dd = packet.lon / 1e7;
     m_speed_kph = packet.speed / 100.0;
     m_acceleration = packet.acceleration / 100.0;
-    m_g_force_x = packet.gForceX / 100.0;
-    m_g_force_y = packet.gForceY / 100.0;
+    // G fields carry signed hundredths through the unsigned wire type
+    m_g_force_x = static_cast<int16_t>(packet.gForceX) / 100.0;
+    m_g_force_y = static_cast<int16_t>(packet.gForceY) / 100.0;
     m_fix_type = packet.fixtype;
     m_id = packet.ID;
 
     // ⚠️ CRITICAL DEBUG: Print stack trace to find who creates this
-    std::cout << "[VEHICLE CONSTRUCTOR] Creating vehicle #" << m_id 
-              << " from TelemetryPacket (this should only happen for NEW vehicles!)" << std::endl;
-    std::cout.flush();
+    LOG_DEBUG(Vehicle, "[VEHICLE CONSTRUCTOR] Creating vehicle #" << m_id 
+              << " from TelemetryPacket (this should only happen for NEW vehicles!)");
 
     // Validate GPS coordinates
     if (std::abs(m_lat_dd) < 0.0001 || std::abs(m_lon_dd) < 0.0001) {
-        std::cerr << "[VEHICLE ERROR] Invalid GPS coordinates for vehicle #" << m_id 
-                  << ": lat=" << m_lat_dd << ", lon=" << m_lon_dd << std::endl;
+        LOG_ERROR(Vehicle, "[VEHICLE ERROR] Invalid GPS coordinates for vehicle #" << m_id 
+                  << ": lat=" << m_lat_dd << ", lon=" << m_lon_dd);
     }
 
     // Convert GPS to meters
@@ -211,18 +218,17 @@ Vehicle::Vehicle(const TelemetryPacket& packet)
 
     // Check if conversion failed
     if (std::abs(m_meters_easting) < 1.0 && std::abs(m_meters_northing) < 1.0) {
-        std::cerr << "[VEHICLE ERROR] coordinatesToMeters returned near-zero: "
-                  << "easting=" << m_meters_easting << ", northing=" << m_meters_northing << std::endl;
+        LOG_ERROR(Vehicle, "[VEHICLE ERROR] coordinatesToMeters returned near-zero: "
+                  << "easting=" << m_meters_easting << ", northing=" << m_meters_northing);
     }
 
     // Convert meters to normalized coordinates
     getCoordinateDifferenceFromOrigin(m_meters_easting, m_meters_northing, m_normalized_x, m_normalized_y);
 
-    std::cout << "[VEHICLE] Created vehicle #" << m_id << " at (" 
+    LOG_INFO(Vehicle, "[VEHICLE] Created vehicle #" << m_id << " at (" 
               << m_normalized_x << ", " << m_normalized_y << "), GPS: (" 
               << m_lat_dd << ", " << m_lon_dd << ")"
-              << " | UTM: (" << m_meters_easting << ", " << m_meters_northing << ")" << std::endl;
-    std::cout.flush();
+              << " | UTM: (" << m_meters_easting << ", " << m_meters_northing << ")");
 
     m_prev_x = m_normalized_x;
     m_prev_y = m_normalized_y;
@@ -232,6 +238,37 @@ Vehicle::Vehicle(const TelemetryPacket& packet)
     m_cached_color = getColor();
 }
 
+Vehicle::Vehicle(const TelemetryPacket& packet, double meters_easting, double meters_northing,
+                 double normalized_x, double normalized_y)
+{
+    m_lat_dd = packet.lat / 1e7;
+    m_lon_dd = packet.lon / 1e7;
+    m_speed_kph = packet.speed / 100.0;
+    m_acceleration = packet.acceleration / 100.0;
+    m_g_force_x = static_cast<int16_t>(packet.gForceX) / 100.0;
+    m_g_force_y = static_cast<int16_t>(packet.gForceY) / 100.0;
+    m_fix_type = packet.fixtype;
+    m_id = packet.ID;
+
+    // Position as ingest prepared it: no second GPS conversion
+    m_meters_easting = meters_easting;
+    m_meters_northing = meters_northing;
+    m_normalized_x = normalized_x;
+    m_normalized_y = normalized_y;
+
+    LOG_INFO(Vehicle, "[VEHICLE] Created vehicle #" << m_id << " at ("
+              << m_normalized_x << ", " << m_normalized_y << "), GPS: ("
+              << m_lat_dd << ", " << m_lon_dd << ")"
+              << " | UTM: (" << m_meters_easting << ", " << m_meters_northing << ")");
+
+    m_prev_x = m_normalized_x;
+    m_prev_y = m_normalized_y;
+    m_heading = 0.0;
+
+    m_last_update_time = std::chrono::steady_clock::now();
+    m_cached_color = getColor();
+}
+
 glm::vec3 Vehicle::getColor() const
 {
     uint32_t hash = static_cast<uint32_t>(m_id);
@@ -249,7 +286,7 @@ glm::vec3 Vehicle::getColor() const
 void vehicleLoop()
 {
     g_is_vehicles_active = true; // ✅ Используем ГЛОБАЛЬНУЮ переменную
-    std::cout << "vehicleLoop started" << std::endl;
+    LOG_INFO(Vehicle, "vehicleLoop started");
     
 	while (g_is_vehicles_active) // Need to chabge ( g_is_vehicles_active is all time true, but we need check if car movving or send packed if not then remove venchile 
                                  // and replace checking to functiont ) 
@@ -259,7 +296,7 @@ void vehicleLoop()
         std::this_thread::sleep_for(std::chrono::milliseconds(33));
     }
     
-    std::cout << "vehicleLoop stopped" << std::endl;
+    LOG_INFO(Vehicle, "vehicleLoop stopped");
 }
 
 void removeVehicles()
@@ -278,10 +315,9 @@ void removeVehicles()
 
                 if (timeSinceLastUpdate >= timeoutMs)
                 {
-                    std::cout << "[TIMEOUT] Vehicle ID #" << it->second.m_id 
+                    LOG_INFO(Vehicle, "[TIMEOUT] Vehicle ID #" << it->second.m_id 
                               << " removed due to timeout (" << timeSinceLastUpdate << "ms > " 
-                              << timeoutMs << "ms)" << std::endl;
-                    std::cout.flush();
+                              << timeoutMs << "ms)");
                     it = g_vehicles.erase(it); // ✅ erase возвращает следующий итератор
                 }
                 else
@@ -328,7 +364,8 @@ std::vector<glm::vec2> generateTriangle(float size)
 }
 
 void renderVehicle(GLuint shader_program, GLuint vao, GLuint vbo,
-    const Vehicle& vehicle, const glm::mat4& projection)
+    const glm::vec2& position, float heading, bool is_leader, const glm::vec3& color,
+    float& last_rotation_angle, const glm::mat4& projection)
 {
     // ✅ Статические геометрии (генерируются один раз для производительности)
     static std::vector<glm::vec2> circleOutline = generateCircle(
@@ -346,41 +383,41 @@ void renderVehicle(GLuint shader_program, GLuint vao, GLuint vbo,
     static GLint colorLoc = glGetUniformLocation(shader_program, "uColor");
     
     // ✅ Выбираем форму: треугольник для лидера, круг для остальных
-    const std::vector<glm::vec2>& outlineShape = vehicle.m_is_leader ? triangleOutline : circleOutline;
-    const std::vector<glm::vec2>& bodyShape = vehicle.m_is_leader ? triangleBody : circleBody;
+    const std::vector<glm::vec2>& outlineShape = is_leader ? triangleOutline : circleOutline;
+    const std::vector<glm::vec2>& bodyShape = is_leader ? triangleBody : circleBody;
 
     // ========================================================================
     // ✅ CALCULATE ROTATION ANGLE WITH PERSISTENCE
     // Caches last valid angle to prevent flickering when GPS jitter causes
     // movement < MIN_MOVEMENT threshold. Uses exponential smoothing for gradual rotation.
     // ========================================================================
-    float rotationAngle = vehicle.m_last_rotation_angle;  // ✅ Start with cached angle
+    float rotationAngle = last_rotation_angle;  // ✅ Start with cached angle
 
-    if (vehicle.m_is_leader)
+    if (is_leader)
     {
         // Use authoritative heading if available. This is more stable than deriving
         // rotation from frame-to-frame position differences.
-        float newAngle = static_cast<float>(vehicle.m_heading) - glm::half_pi<float>();
+        float newAngle = heading - glm::half_pi<float>();
 
         // ✅ SMOOTH INTERPOLATION (exponential smoothing)
         const float SMOOTHING_FACTOR = 0.3f;  // 0.0 = no change, 1.0 = instant (0.3 = good balance)
 
         // Handle angle wrapping (-PI to PI)
-        float angleDiff = newAngle - vehicle.m_last_rotation_angle;
+        float angleDiff = newAngle - last_rotation_angle;
 
         if (angleDiff > glm::pi<float>())
             angleDiff -= 2.0f * glm::pi<float>();
         else if (angleDiff < -glm::pi<float>())
             angleDiff += 2.0f * glm::pi<float>();
 
-        rotationAngle = vehicle.m_last_rotation_angle + angleDiff * SMOOTHING_FACTOR;
+        rotationAngle = last_rotation_angle + angleDiff * SMOOTHING_FACTOR;
 
-        vehicle.m_last_rotation_angle = rotationAngle;
+        last_rotation_angle = rotationAngle;
     }
 
     // ✅ ОПТИМИЗАЦИЯ: Создаем матрицу вращения один раз
     glm::mat2 rotationMatrix(1.0f);
-    if (vehicle.m_is_leader)
+    if (is_leader)
     {
         float cosAngle = std::cos(rotationAngle);
         float sinAngle = std::sin(rotationAngle);
@@ -390,16 +427,15 @@ void renderVehicle(GLuint shader_program, GLuint vao, GLuint vbo,
         );
     }
 
-  const glm::vec2 renderOffset = vehicle.m_apply_track_render_offset ? getTrackRenderOffset() : glm::vec2(0.0f, 0.0f);
-    const float baseX = static_cast<float>(vehicle.m_normalized_x) + renderOffset.x;
-    const float baseY = static_cast<float>(vehicle.m_normalized_y) + renderOffset.y;
+    const float baseX = position.x;
+    const float baseY = position.y;
 
     // === РИСУЕМ БЕЛУЮ ОБВОДКУ ===
     std::vector<glm::vec2> outlineVertices;
     outlineVertices.reserve(outlineShape.size());
     for (const auto& vertex : outlineShape) {
         // ✅ Применяем матрицу поворота (экономит вычисления cos/sin)
-        glm::vec2 transformedVertex = (vehicle.m_is_leader) 
+        glm::vec2 transformedVertex = (is_leader) 
             ? rotationMatrix * vertex 
             : vertex;
         
@@ -427,7 +463,7 @@ void renderVehicle(GLuint shader_program, GLuint vao, GLuint vbo,
     bodyVertices.reserve(bodyShape.size());
     for (const auto& vertex : bodyShape) {
         // ✅ Применяем матрицу поворота (экономит вычисления cos/sin)
-        glm::vec2 transformedVertex = (vehicle.m_is_leader) 
+        glm::vec2 transformedVertex = (is_leader) 
             ? rotationMatrix * vertex 
             : vertex;
         
@@ -442,7 +478,7 @@ void renderVehicle(GLuint shader_program, GLuint vao, GLuint vbo,
         bodyVertices.data(), GL_DYNAMIC_DRAW);
 
     // ✅ Используем кешированный цвет машины
-    glUniform3f(colorLoc, vehicle.m_cached_color.r, vehicle.m_cached_color.g, vehicle.m_cached_color.b);
+    glUniform3f(colorLoc, color.r, color.g, color.b);
 
     glBindVertexArray(vao);
     glDrawArrays(GL_TRIANGLE_FAN, 0, static_cast<GLsizei>(bodyVertices.size()));
@@ -467,82 +503,71 @@ void renderAllVehicles(GLuint shader_program, GLuint vao, GLuint vbo,
     float minY = camera_pos.y - visibleHeight;
     float maxY = camera_pos.y + visibleHeight;
 
-    // ✅ Собираем копии машин с интерполированными позициями
-    struct RenderData {
-        Vehicle vehicle;  // Copy for thread-safe rendering
-        double interp_x, interp_y, interp_heading, interp_speed;
-        bool use_interpolation;
-    };
-
-    std::vector<RenderData> vehiclesToRender;
-    {
-        std::lock_guard<std::mutex> lock(g_vehicles_mutex);
-        vehiclesToRender.reserve(g_vehicles.size());
-
-        for (const auto& [id, vehicle] : g_vehicles) {
-            RenderData data{ vehicle, 0.0, 0.0, 0.0, 0.0, false };
+    // ✅ Кадр, опубликованный RaceManager::PublishSnapshot — без g_vehicles_mutex и без копий Vehicle
+    const RaceFrame& frame = RaceSnapshot::Current();
 
-            // Try to get interpolated position
-            if (VehicleInterpolator::Get().GetInterpolatedState(
-                id, renderTime,
-                data.interp_x, data.interp_y, 
-                data.interp_heading, data.interp_speed))
-            {
-                data.use_interpolation = true;
-
-                // Check visibility with interpolated position
-                if (data.interp_x >= minX && data.interp_x <= maxX &&
-                    data.interp_y >= minY && data.interp_y <= maxY)
-                {
-                    // ✅ Use interpolated position AND heading for rendering
-                    data.vehicle.m_normalized_x = data.interp_x;
-                    data.vehicle.m_normalized_y = data.interp_y;
-                    data.vehicle.m_speed_kph = data.interp_speed;
-                    data.vehicle.m_heading = data.interp_heading;  // ✅ Fix: update heading too!
+    // Smoothed leader-triangle rotation, kept per vehicle across frames
+    static std::unordered_map<int32_t, float> s_rotation;
 
-                    // Update prev position for direction calculation
-                    data.vehicle.m_prev_x = vehicle.m_prev_x;
-                    data.vehicle.m_prev_y = vehicle.m_prev_y;
+    struct RenderData {
+        size_t index;         // Column in the race frame
+        glm::vec2 position;   // Track render offset applied
+        float heading;
+    };
+    static std::vector<RenderData> vehiclesToRender;
+    vehiclesToRender.clear();
+    static std::vector<TelemetryLatency::RenderedVehicle> rendered;
+    rendered.clear();
+
+    // All poses in one pass over the interpolator, without locks
+    static std::vector<VehiclePose> poses;
+    poses.resize(frame.Size());
+    VehicleInterpolator::Get().GetInterpolatedStates(renderTime, frame.ids.data(), frame.Size(), poses.data());
+
+    const glm::vec2 trackOffset = getTrackRenderOffset();
+
+    for (size_t i = 0; i < frame.Size(); ++i) {
+        glm::vec2 pos = frame.position[i];
+        float heading = frame.heading[i];
+
+        // Interpolated position AND heading; fall back to the last telemetry
+        // (first few frames, or packets lost)
+        const VehiclePose& pose = poses[i];
+        if (pose.valid)
+        {
+            pos = glm::vec2(static_cast<float>(pose.x), static_cast<float>(pose.y));
+            heading = static_cast<float>(pose.heading);
+            rendered.push_back({ frame.ids[i], pose.playout_time });
+        }
 
-                    vehiclesToRender.push_back(data);
-                }
-            }
-            else
-            {
-                // ✅ Fallback to direct position (no interpolation data yet or buffer not ready)
-                // This happens in first few frames or if packets are lost
-                float vX = static_cast<float>(vehicle.m_normalized_x);
-                float vY = static_cast<float>(vehicle.m_normalized_y);
+        if (pos.x < minX || pos.x > maxX || pos.y < minY || pos.y > maxY)
+            continue;
 
-                if (vX >= minX && vX <= maxX && vY >= minY && vY <= maxY) {
-                    vehiclesToRender.push_back(data);
-                }
-            }
-        }
-    } // ✅ Мьютекс освобожден
+        const glm::vec2 offset = frame.Is(i, RaceFrame::kTrackRenderOffset) ? trackOffset : glm::vec2(0.0f, 0.0f);
+        vehiclesToRender.push_back({ i, pos + offset, heading });
+    }
 
-    // ✅ Рендеринг БЕЗ блокировки (может занять 10-20ms)
     for (const RenderData& data : vehiclesToRender) {
-        renderVehicle(shader_program, vao, vbo, data.vehicle, projection);
+        renderVehicle(shader_program, vao, vbo, data.position, data.heading,
+            frame.Is(data.index, RaceFrame::kLeader), frame.color[data.index],
+            s_rotation[frame.ids[data.index]], projection);
     }
 
-    // Draw TLA names above each vehicle if enabled.
-    // Apply the same track-centering offset used by the dot so label and
-    // dot always land at the same screen position.
+    // Draw TLA names above each vehicle if enabled, at the same (offset)
+    // position as the dot.
     if (g_show_vehicle_names) {
         for (const RenderData& data : vehiclesToRender) {
-            if (!data.vehicle.name.empty()) {
-                const glm::vec2 rOff = data.vehicle.m_apply_track_render_offset
-                                         ? getTrackRenderOffset()
-                                         : glm::vec2(0.0f, 0.0f);
+            const std::string& name = frame.names[data.index];
+            if (!name.empty()) {
                 VehicleNameRenderer::DrawName(
-                    data.vehicle.name,
-                    static_cast<float>(data.vehicle.m_normalized_x) + rOff.x,
-                    static_cast<float>(data.vehicle.m_normalized_y) + rOff.y,
+                    name, data.position.x, data.position.y,
                     projection, g_ui ? g_ui->GetTitleFont() : nullptr, 1.0f);
             }
         }
     }
+
+    // Telemetry that each vehicle's playout time has reached is now on screen
+    TelemetryLatency::onFrameRendered(rendered.data(), rendered.size());
 }
 
 void vehicleClose()
@@ -8,6 +8,9 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "../racing/LapTimer.h"
+#include "../racing/TimingRecord.h"
+#include "../racing/LapSamples.h"
 
 extern int g_focused_vehicle_id;  // -1 = лидер (дефолт), иначе ID машины
 extern bool g_show_vehicle_names; // true = show TLA names above vehicles
@@ -15,6 +18,7 @@ extern bool g_show_vehicle_names; // true = show TLA names above vehicles
 struct LapData
 {
 	float lapTime;                              // Lap time in seconds
+	int64_t lapTimeUs = 0;                      // Exact, from the crossing timestamps (0 = server-provided)
 	int positionAtFinish;                       // Position when crossing line
 	std::vector<glm::vec2> telemetryPoints;     // Placeholder for future telemetry
 	
@@ -23,23 +27,11 @@ struct LapData
 };
 
 
-struct LapInfo
-{
-	float timefromstart;
-	double progress;
-	std::chrono::steady_clock::time_point timestamp;
-	double total_progress;
-	float gForceX, gForceY;
-	float aceleration, speed;
-	int curentPosition;
-	
-};
-
 struct CarLapSessions
 {
 	int lapnumber;
 	int globalLapnumber;
-	std::vector<LapInfo> samples;
+	LapSamples samples;                         // Telemetry at 10 Hz, compact (see LapSamples.h)
 };
 
 
@@ -52,6 +44,10 @@ public:
 	Vehicle(double normalized_x, double normalized_y);
 	Vehicle(int32_t id, double normalized_x, double normalized_y);  // ✅ New: with explicit ID
 	Vehicle(const TelemetryPacket& packet);
+	// From telemetry whose position ingest already converted (and filtered):
+	// easting/northing in UTM metres, normalized against the same origin
+	Vehicle(const TelemetryPacket& packet, double meters_easting, double meters_northing,
+	        double normalized_x, double normalized_y);
 	
 	double m_lat_dd;
 	double m_lon_dd;
@@ -70,11 +66,6 @@ public:
 	glm::vec3 m_cached_color; 
 	bool m_is_leader = false;  
 	
-	// ========================================================================
-	// RENDERING CACHE (for smooth triangle rotation)
-	// ========================================================================
-	mutable float m_last_rotation_angle = 0.0f;
-	
 	// ========================================================================
 	// LAP TIMING DATA (RaceManager reads/writes, Vehicle stores)
 	// ========================================================================
@@ -87,6 +78,8 @@ public:
 	float m_best_lap_time = -1.0f;
 	int bestlapID = -1;
 	bool m_is_finished = false;
+	LapTimer m_lap_timer;                       // S/F crossings on fix timestamps (RaceManager::OnPositionFix)
+	TimingRecord m_timing;                      // Sectors, speed traps, pit lane (same fixes)
 
 
 	// ========================================================================
@@ -113,13 +106,18 @@ public:
 	// ========================================================================
 	std::map<int, CarLapSessions> laps;
 
-	// Accumulator for throttling telemetry sample recording (seconds)
-	float m_telemetry_sample_timer = 0.0f;
+	// Fix time of the last recorded telemetry sample (throttles recording)
+	int64_t m_last_sample_us = 0;
 	
 	// ========================================================================
 	// COLOR GENERATION
 	// ========================================================================
 	glm::vec3 getColor() const;
+
+	// Back to the start of a session: lap history, lap timer, timing lines
+	// state, progress and finishing state (RaceManager::ResetSession and a new Track Server race
+	// epoch). Caller holds g_vehicles_mutex.
+	void ResetSessionState();
 };
 
 
@@ -143,9 +141,13 @@ int32_t generateVehicleID();
 std::vector<glm::vec2> generateCircle(float radius, int segments = 16);
 std::vector<glm::vec2> generateTriangle(float size); // ✅ Треугольник для лидера
 
+// position is the final normalized draw position (track offset applied);
+// last_rotation_angle is the caller's per-vehicle smoothing state.
 void renderVehicle(GLuint shader_program, GLuint vao, GLuint vbo,
-	const Vehicle& vehicle, const glm::mat4& projection);
+	const glm::vec2& position, float heading, bool is_leader, const glm::vec3& color,
+	float& last_rotation_angle, const glm::mat4& projection);
 
+// Draws every vehicle of the current RaceSnapshot frame.
 void renderAllVehicles(GLuint shader_program, GLuint vao, GLuint vbo,
 	const glm::mat4& projection,
 	const glm::vec2& camera_pos, float camera_zoom);
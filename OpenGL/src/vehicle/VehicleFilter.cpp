@@ -0,0 +1,413 @@
+#include "VehicleFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kGravity = 9.81;
+
+    enum : int { PX = 0, PY, TH, V, W, A };
+
+    // Process noise spectral densities (white yaw acceleration and jerk drive
+    // the CTRA model; the position term covers everything it does not model)
+    constexpr double kQPosition = 0.05;    // m^2/s
+    constexpr double kQHeading = 0.001;    // rad^2/s
+    constexpr double kQYawAccel = 1.0;     // (rad/s^2)^2 / Hz, yaw rate seen through GNSS only
+    constexpr double kQYawAccelG = 4.0;    // Lateral G measures it directly: let it follow
+    constexpr double kQJerk = 200.0;       // (m/s^3)^2 / Hz
+
+    constexpr double kSpeedSigma = 0.3;    // m/s
+    constexpr double kGSigma = 0.08;       // g, vibration and mounting tilt
+    constexpr double kMaxAbsG = 5.0;       // Beyond: corrupt or sign-wrapped field
+
+    constexpr double kHeadingMinDistance = 2.0;  // m from the seed fix...
+    constexpr double kHeadingNoiseSigmas = 3.0;  // ...plus this many sigmas of two fixes' noise
+    constexpr double kMaxStep = 0.05;            // s per CTRA integration step
+
+    // Sign learning: enough motion, then a clear correlation either way
+    constexpr double kLearnMinSpeed = 5.0;       // m/s
+    constexpr int    kLearnSamples = 50;
+    constexpr int    kLearnWindow = 500;
+    constexpr double kLearnMinRms = 0.1;         // g of predicted signal
+    constexpr double kLearnCorrelation = 0.6;
+
+    double wrapAngle(double a)
+    {
+        while (a > kPi) a -= 2.0 * kPi;
+        while (a < -kPi) a += 2.0 * kPi;
+        return a;
+    }
+
+    // Horizontal position sigma (metres) for a GNSS fix type; 0 = no fix
+    double positionSigma(int fixType)
+    {
+        if (fixType == 5) return 0.03;   // RTK fixed
+        if (fixType == 4) return 0.3;    // RTK float
+        if (fixType >= 1) return 1.5;    // Autonomous / DGPS
+        return 0.0;
+    }
+}
+
+// ============================================================================
+// MODEL
+// ============================================================================
+// CTRA with midpoint integration: exact for straight lines and constant
+// acceleration, and within millimetres of the closed form on a corner at
+// 50 ms steps (the closed form divides by the yaw rate).
+void VehicleFilter::Propagate(Vec x, double dt)
+{
+    const double th = x[TH] + 0.5 * x[W] * dt;
+    const double v = x[V] + 0.5 * x[A] * dt;
+    x[PX] += v * std::cos(th) * dt;
+    x[PY] += v * std::sin(th) * dt;
+    x[TH] = wrapAngle(x[TH] + x[W] * dt);
+    x[V] += x[A] * dt;
+}
+
+void VehicleFilter::Predict(double dt)
+{
+    const int steps = std::max(1, static_cast<int>(std::ceil(dt / kMaxStep)));
+    const double h = dt / steps;
+    const double qYaw = m_lateral.sign != 0 ? kQYawAccelG : kQYawAccel;
+
+    for (int s = 0; s < steps; ++s) {
+        // Jacobian at the midpoint: identity plus the position/heading/speed rows
+        const double th = m_x[TH] + 0.5 * m_x[W] * h;
+        const double v = m_x[V] + 0.5 * m_x[A] * h;
+        const double c = std::cos(th), sn = std::sin(th);
+
+        Mat F = {};
+        for (int i = 0; i < N; ++i) {
+            F[i][i] = 1.0;
+        }
+        F[PX][TH] = -v * sn * h;
+        F[PX][V] = c * h;
+        F[PX][W] = -v * sn * h * h * 0.5;
+        F[PX][A] = c * h * h * 0.5;
+        F[PY][TH] = v * c * h;
+        F[PY][V] = sn * h;
+        F[PY][W] = v * c * h * h * 0.5;
+        F[PY][A] = sn * h * h * 0.5;
+        F[TH][W] = h;
+        F[V][A] = h;
+
+        Propagate(m_x, h);
+
+        // P = F P F^T + Q
+        Mat FP = {};
+        for (int i = 0; i < N; ++i) {
+            for (int k = 0; k < N; ++k) {
+                if (F[i][k] == 0.0) continue;
+                for (int j = 0; j < N; ++j) {
+                    FP[i][j] += F[i][k] * m_P[k][j];
+                }
+            }
+        }
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                double sum = 0.0;
+                for (int k = 0; k < N; ++k) {
+                    sum += FP[i][k] * F[j][k];
+                }
+                m_P[i][j] = sum;
+            }
+        }
+
+        // Integrated white noise on the rates: [h^3/3, h^2/2; h^2/2, h] * q
+        const double h2 = h * h, h3 = h2 * h;
+        m_P[PX][PX] += kQPosition * h;
+        m_P[PY][PY] += kQPosition * h;
+        m_P[TH][TH] += kQHeading * h + qYaw * h3 / 3.0;
+        m_P[TH][W] += qYaw * h2 / 2.0;
+        m_P[W][TH] += qYaw * h2 / 2.0;
+        m_P[W][W] += qYaw * h;
+        m_P[V][V] += kQJerk * h3 / 3.0;
+        m_P[V][A] += kQJerk * h2 / 2.0;
+        m_P[A][V] += kQJerk * h2 / 2.0;
+        m_P[A][A] += kQJerk * h;
+    }
+}
+
+// ============================================================================
+// MEASUREMENT UPDATES
+// ============================================================================
+bool VehicleFilter::UpdatePosition(double easting, double northing, double variance)
+{
+    const double y0 = easting - m_x[PX];
+    const double y1 = northing - m_x[PY];
+    const double s00 = m_P[PX][PX] + variance;
+    const double s01 = m_P[PX][PY];
+    const double s11 = m_P[PY][PY] + variance;
+    const double det = s00 * s11 - s01 * s01;
+    if (det <= 0.0) {
+        return false;
+    }
+    const double i00 = s11 / det, i01 = -s01 / det, i11 = s00 / det;
+
+    m_stats.lastNis = y0 * (i00 * y0 + i01 * y1) + y1 * (i01 * y0 + i11 * y1);
+    if (m_stats.lastNis > GATE_POSITION) {
+        return false;
+    }
+
+    // K = P H^T S^-1, H picks the two position rows
+    double K[N][2];
+    for (int i = 0; i < N; ++i) {
+        K[i][0] = m_P[i][PX] * i00 + m_P[i][PY] * i01;
+        K[i][1] = m_P[i][PX] * i01 + m_P[i][PY] * i11;
+    }
+    for (int i = 0; i < N; ++i) {
+        m_x[i] += K[i][0] * y0 + K[i][1] * y1;
+    }
+
+    // P -= K H P
+    double HP[2][N];
+    for (int j = 0; j < N; ++j) {
+        HP[0][j] = m_P[PX][j];
+        HP[1][j] = m_P[PY][j];
+    }
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            m_P[i][j] -= K[i][0] * HP[0][j] + K[i][1] * HP[1][j];
+        }
+    }
+    return true;
+}
+
+bool VehicleFilter::UpdateScalar(double innovation, const double* h, double variance)
+{
+    double PHt[N];
+    double s = variance;
+    for (int i = 0; i < N; ++i) {
+        PHt[i] = 0.0;
+        for (int k = 0; k < N; ++k) {
+            PHt[i] += m_P[i][k] * h[k];
+        }
+    }
+    for (int i = 0; i < N; ++i) {
+        s += h[i] * PHt[i];
+    }
+    if (s <= 0.0 || innovation * innovation / s > GATE_SCALAR) {
+        return false;
+    }
+
+    for (int i = 0; i < N; ++i) {
+        m_x[i] += PHt[i] / s * innovation;
+    }
+    // P -= (P h)(P h)^T / s  (P symmetric, so h^T P = (P h)^T)
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            m_P[i][j] -= PHt[i] * PHt[j] / s;
+        }
+    }
+    return true;
+}
+
+void VehicleFilter::Symmetrize()
+{
+    for (int i = 0; i < N; ++i) {
+        for (int j = i + 1; j < N; ++j) {
+            const double m = 0.5 * (m_P[i][j] + m_P[j][i]);
+            m_P[i][j] = m;
+            m_P[j][i] = m;
+        }
+    }
+}
+
+void VehicleFilter::AxisSign::Observe(double measured, double predicted)
+{
+    sumMP += measured * predicted;
+    sumMM += measured * measured;
+    sumPP += predicted * predicted;
+    if (++samples < kLearnSamples || sumPP < kLearnMinRms * kLearnMinRms * samples) {
+        if (samples >= kLearnWindow) {
+            *this = AxisSign{};  // Mostly straights so far; start over
+        }
+        return;
+    }
+
+    const double correlation = sumMP / std::sqrt(sumMM * sumPP);
+    if (correlation > kLearnCorrelation) {
+        sign = 1;
+    } else if (correlation < -kLearnCorrelation) {
+        sign = -1;
+    } else if (samples >= kLearnWindow) {
+        *this = AxisSign{};
+    }
+}
+
+// ============================================================================
+// UPDATE
+// ============================================================================
+void VehicleFilter::Seed(const Measurement& m)
+{
+    const double dx = m.easting - m_anchorEasting;
+    const double dy = m.northing - m_anchorNorthing;
+    const double sigma = positionSigma(m.fixType);
+
+    for (auto& row : m_P) {
+        std::fill(std::begin(row), std::end(row), 0.0);
+    }
+    m_x[PX] = m.easting;
+    m_x[PY] = m.northing;
+    m_x[TH] = std::atan2(dy, dx);
+    m_x[V] = m.speed >= 0.0
+        ? m.speed
+        : std::sqrt(dx * dx + dy * dy) / std::max(m.time - m_anchorTime, 0.02);
+    m_x[W] = 0.0;
+    m_x[A] = 0.0;
+    m_P[PX][PX] = m_P[PY][PY] = sigma * sigma;
+    // Two noisy fixes a few metres apart point the heading only roughly
+    m_P[TH][TH] = std::max(0.3 * 0.3, 2.0 * sigma * sigma / std::max(dx * dx + dy * dy, 1e-6));
+    m_P[V][V] = 2.0 * 2.0;
+    m_P[W][W] = 0.5 * 0.5;
+    m_P[A][A] = 3.0 * 3.0;
+    m_hasHeading = true;
+}
+
+bool VehicleFilter::Update(const Measurement& m)
+{
+    const double sigma = positionSigma(m.fixType);
+
+    if (m_initialized && m.time - m_time > MAX_GAP) {
+        Reset();
+    }
+
+    if (!m_initialized) {
+        if (sigma <= 0.0) {
+            return false;
+        }
+        m_initialized = true;
+        m_hasHeading = false;
+        m_time = m.time;
+        m_anchorEasting = m_x[PX] = m.easting;
+        m_anchorNorthing = m_x[PY] = m.northing;
+        m_anchorTime = m.time;
+        m_x[V] = std::max(m.speed, 0.0);
+        ++m_stats.fixes;
+        return true;
+    }
+
+    if (!m_hasHeading) {
+        // Stationary or creeping: follow the fixes until the displacement is
+        // large enough to point the heading
+        m_time = std::max(m_time, m.time);
+        if (sigma <= 0.0) {
+            return false;
+        }
+        const double dx = m.easting - m_anchorEasting;
+        const double dy = m.northing - m_anchorNorthing;
+        const double minDistance = kHeadingMinDistance + kHeadingNoiseSigmas * std::sqrt(2.0) * sigma;
+        if (dx * dx + dy * dy >= minDistance * minDistance) {
+            Seed(m);
+        } else {
+            m_x[PX] = m.easting;
+            m_x[PY] = m.northing;
+            m_x[V] = std::max(m.speed, 0.0);
+        }
+        ++m_stats.fixes;
+        return true;
+    }
+
+    // Records of one frame share a timestamp; a late one is fused as current
+    if (m.time > m_time) {
+        Predict(m.time - m_time);
+        m_time = m.time;
+    }
+
+    bool accepted = false;
+    if (sigma > 0.0) {
+        accepted = UpdatePosition(m.easting, m.northing, sigma * sigma);
+        if (accepted) {
+            m_rejectStreak = 0;
+            ++m_stats.fixes;
+        } else {
+            ++m_stats.rejected;
+            if (++m_rejectStreak >= GATE_RESETS) {
+                // Consistently elsewhere: the car was moved, not the fixes wrong
+                ++m_stats.resets;
+                Reset();
+                return Update(m);
+            }
+        }
+    }
+
+    if (m.speed >= 0.0) {
+        const double h[N] = { 0, 0, 0, 1, 0, 0 };
+        UpdateScalar(m.speed - m_x[V], h, kSpeedSigma * kSpeedSigma);
+    }
+
+    // G axes: learn the sign from the filtered motion, then fuse
+    const bool lateralValid = m.lateralG != 0.0 && std::abs(m.lateralG) < kMaxAbsG;
+    const bool longitudinalValid = m.longitudinalG != 0.0 && std::abs(m.longitudinalG) < kMaxAbsG;
+    if (m_x[V] > kLearnMinSpeed) {
+        if (lateralValid && m_lateral.sign == 0) {
+            m_lateral.Observe(m.lateralG, m_x[V] * m_x[W] / kGravity);
+        }
+        if (longitudinalValid && m_longitudinal.sign == 0) {
+            m_longitudinal.Observe(m.longitudinalG, m_x[A] / kGravity);
+        }
+    }
+    if (lateralValid && m_lateral.sign != 0) {
+        const double s = m_lateral.sign / kGravity;
+        const double h[N] = { 0, 0, 0, s * m_x[W], s * m_x[V], 0 };
+        UpdateScalar(m.lateralG - s * m_x[V] * m_x[W], h, kGSigma * kGSigma);
+    }
+    if (longitudinalValid && m_longitudinal.sign != 0) {
+        const double s = m_longitudinal.sign / kGravity;
+        const double h[N] = { 0, 0, 0, 0, 0, s };
+        UpdateScalar(m.longitudinalG - s * m_x[A], h, kGSigma * kGSigma);
+    }
+
+    // A car does not reverse on track; a negative speed is the heading flipped
+    if (m_x[V] < 0.0) {
+        m_x[V] = -m_x[V];
+        m_x[TH] += kPi;
+    }
+    m_x[TH] = wrapAngle(m_x[TH]);
+    Symmetrize();
+
+    m_stats.lateralSign = m_lateral.sign;
+    m_stats.longitudinalSign = m_longitudinal.sign;
+    return accepted;
+}
+
+void VehicleFilter::Reset()
+{
+    // The G axis signs belong to the logger's mounting, not to this track
+    const AxisSign lateral = m_lateral;
+    const AxisSign longitudinal = m_longitudinal;
+    const Stats stats = m_stats;
+    *this = VehicleFilter{};
+    m_lateral = lateral;
+    m_longitudinal = longitudinal;
+    m_stats = stats;
+}
+
+// ============================================================================
+// QUERY
+// ============================================================================
+VehicleFilter::State VehicleFilter::At(double time) const
+{
+    Vec x;
+    std::copy(std::begin(m_x), std::end(m_x), x);
+
+    if (m_hasHeading) {
+        double dt = std::clamp(time - m_time, -MAX_PREDICT, MAX_PREDICT);
+        const int steps = std::max(1, static_cast<int>(std::ceil(std::abs(dt) / kMaxStep)));
+        dt /= steps;
+        for (int s = 0; s < steps; ++s) {
+            Propagate(x, dt);
+        }
+    }
+
+    State state;
+    state.easting = x[PX];
+    state.northing = x[PY];
+    state.heading = m_hasHeading ? x[TH] : 0.0;
+    state.speed = x[V];
+    state.yawRate = m_hasHeading ? x[W] : 0.0;
+    state.accel = m_hasHeading ? x[A] : 0.0;
+    return state;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+
+// ============================================================================
+// VEHICLE FILTER - per-vehicle extended Kalman filter over the telemetry
+//
+// State: position (UTM metres), heading, speed, yaw rate and longitudinal
+// acceleration, propagated with a constant turn rate and acceleration (CTRA)
+// model. Every telemetry record is fused in one Update():
+//
+//   - GNSS position, noise by fix type, gated on the innovation (a fix whose
+//     normalized innovation is beyond GATE_POSITION is dropped as an outlier;
+//     GATE_RESETS in a row mean the car really is elsewhere and re-seed it)
+//   - reported speed
+//   - lateral G (= v * yaw rate) and longitudinal G (= acceleration), once the
+//     sign convention of the logger's axes has been learned from the GNSS
+//     track, so a sensor mounted the other way round is never fused backwards
+//
+// At(t) predicts the mean to any time, which gives heading and yaw rate to the
+// interpolator and a clean position to the track matcher and S/F detection.
+//
+// Pure and deterministic: every time comes from the caller (the interpolation
+// clock, seconds). Not thread-safe; the owner serializes access.
+// ============================================================================
+class VehicleFilter
+{
+public:
+    struct Measurement {
+        double time = 0.0;           // Seconds, interpolation clock
+        double easting = 0.0;        // UTM metres
+        double northing = 0.0;
+        int    fixType = 0;          // 0 none, >= 1 GPS, 4 RTK float, 5 RTK fixed
+        double speed = -1.0;         // m/s, negative: not reported
+        double lateralG = 0.0;       // g, 0: not reported
+        double longitudinalG = 0.0;  // g, 0: not reported
+    };
+
+    struct State {
+        double easting = 0.0;
+        double northing = 0.0;
+        double heading = 0.0;        // Radians, atan2 convention (east = 0)
+        double speed = 0.0;          // m/s
+        double yawRate = 0.0;        // rad/s
+        double accel = 0.0;          // m/s^2 along the heading
+    };
+
+    // Fuses one record; false when its position was rejected by the gate.
+    bool Update(const Measurement& m);
+
+    // Until the first fix nothing is known; until the car has moved the
+    // heading is not (At() reports it as 0 and the yaw rate as 0).
+    bool IsInitialized() const { return m_initialized; }
+    bool HasHeading() const { return m_hasHeading; }
+
+    // Mean state predicted to `time` (clamped to MAX_PREDICT around the last
+    // update). Valid once IsInitialized().
+    State At(double time) const;
+
+    double LastUpdateTime() const { return m_time; }
+
+    // Forget the motion (keeps the learned G axis signs and the counters)
+    void Reset();
+
+    struct Stats {
+        uint64_t fixes = 0;          // Positions fused
+        uint64_t rejected = 0;       // Positions gated out
+        uint64_t resets = 0;         // Re-seeded after GATE_RESETS rejections
+        double   lastNis = 0.0;      // Normalized innovation of the last fix
+        int      lateralSign = 0;    // Learned G axis signs, 0 until learned
+        int      longitudinalSign = 0;
+    };
+    const Stats& GetStats() const { return m_stats; }
+
+    static constexpr double GATE_POSITION = 13.8;   // chi^2, 2 dof, 99.9%
+    static constexpr double GATE_SCALAR = 10.8;     // chi^2, 1 dof, 99.9%
+    static constexpr int    GATE_RESETS = 5;
+    static constexpr double MAX_GAP = 2.0;          // Seconds without data before re-seeding
+    static constexpr double MAX_PREDICT = 1.0;      // At() horizon, seconds
+
+private:
+    static constexpr int N = 6;                     // px, py, heading, speed, yaw rate, accel
+    using Vec = double[N];
+    using Mat = double[N][N];
+
+    // Tracks whether a G axis agrees or disagrees with the GNSS-derived motion
+    struct AxisSign {
+        double sumMP = 0.0, sumMM = 0.0, sumPP = 0.0;
+        int    samples = 0;
+        int    sign = 0;
+        void Observe(double measured, double predicted);
+    };
+
+    void Seed(const Measurement& m);
+    void Predict(double dt);
+    bool UpdatePosition(double easting, double northing, double variance);
+    bool UpdateScalar(double innovation, const double* h, double variance);
+    void Symmetrize();
+
+    static void Propagate(Vec x, double dt);
+
+    Vec m_x = {};
+    Mat m_P = {};
+    double m_time = 0.0;
+    bool m_initialized = false;
+    bool m_hasHeading = false;
+    int m_rejectStreak = 0;
+
+    // Seed position, kept until the car has moved far enough to give a heading
+    double m_anchorEasting = 0.0;
+    double m_anchorNorthing = 0.0;
+    double m_anchorTime = 0.0;
+
+    AxisSign m_lateral;
+    AxisSign m_longitudinal;
+    Stats m_stats;
+};
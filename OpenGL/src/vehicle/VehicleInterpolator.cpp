@@ -1,13 +1,146 @@
 #include "VehicleInterpolator.h"
 #include "../Config.h"
+#include "../core/Log.h"
+#include "../track/TrackGeometry.h"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace
+{
+    // A vehicle relative to the centre line
+    struct TrackCoords
+    {
+        double arc = 0.0;           // Arc length from points[0], normalized units
+        double along = 0.0;         // Offset along the tangent
+        double lateral = 0.0;       // Offset to the left of the line
+        double relHeading = 0.0;    // Heading minus the tangent direction
+    };
+
+    constexpr double kMaxTrackOffsetM = 12.0; // Farther from the line = not on this track
+    constexpr double kClosedGap = 0.05;   // Closing segment < 5% of the line = a loop
+    constexpr double kDetourFactor = 1.5; // Arc this much longer than the chord...
+    constexpr double kDetourSlackM = 2.0; // ...plus this = matched to another part of the track
+    constexpr double kCurvatureSpanM = 1.0;   // Curvature measured over +-this much of the line
+    constexpr double kMinArcScale = 0.25;     // Cap on the speed-up on the inside of a bend
+
+    double wrapAngle(double a)
+    {
+        while (a > M_PI) a -= 2.0 * M_PI;
+        while (a < -M_PI) a += 2.0 * M_PI;
+        return a;
+    }
+
+    bool isLoop(const TrackGeometry::Snapshot& track)
+    {
+        return track.loopLength - track.openLength < kClosedGap * track.openLength;
+    }
+
+    // Shortest way from one arc length to another (across start/finish on a loop)
+    double arcDelta(const TrackGeometry::Snapshot& track, double from, double to)
+    {
+        double d = to - from;
+        if (isLoop(track)) {
+            const double loop = track.loopLength;
+            if (d > loop * 0.5) d -= loop;
+            else if (d < -loop * 0.5) d += loop;
+        }
+        return d;
+    }
+
+    // Centre-line point and unit tangent at arc length s. On a loop s wraps
+    // through the closing segment; an open line is clamped at its ends.
+    void centreAt(const TrackGeometry::Snapshot& track, double s, glm::dvec2& pos, glm::dvec2& tangent)
+    {
+        const std::vector<SplinePoint>& points = track.points;
+        const size_t n = points.size();
+        const double open = track.openLength;
+
+        const SplinePoint* a;
+        const SplinePoint* b;
+        double u;
+        if (isLoop(track)) {
+            s = std::fmod(s, static_cast<double>(track.loopLength));
+            if (s < 0.0) s += track.loopLength;
+        } else {
+            s = std::clamp(s, 0.0, open);
+        }
+        if (s >= open) {
+            a = &points[n - 1];
+            b = &points[0];
+            const double closing = track.loopLength - open;
+            u = closing > 0.0 ? (s - open) / closing : 0.0;
+        } else {
+            const auto it = std::upper_bound(track.cumulative.begin(), track.cumulative.end(), static_cast<float>(s));
+            const size_t i = std::min(static_cast<size_t>(std::max<std::ptrdiff_t>(it - track.cumulative.begin() - 1, 0)), n - 2);
+            a = &points[i];
+            b = &points[i + 1];
+            const double len = track.cumulative[i + 1] - track.cumulative[i];
+            u = len > 0.0 ? std::clamp((s - track.cumulative[i]) / len, 0.0, 1.0) : 0.0;
+        }
+
+        const glm::dvec2 pa(a->position), pb(b->position);
+        pos = pa + (pb - pa) * u;
+        tangent = glm::dvec2(a->tangent) * (1.0 - u) + glm::dvec2(b->tangent) * u;
+        double len = glm::length(tangent);
+        if (len < 1e-9) {
+            tangent = pb - pa;
+            len = glm::length(tangent);
+        }
+        tangent = len > 1e-12 ? tangent / len : glm::dvec2(1.0, 0.0);
+    }
+
+    // Centre-line arc length covered per unit travelled parallel to it at
+    // `lateral` off it: more on the inside of a bend, less on the outside
+    double arcPerDistance(const TrackGeometry::Snapshot& track, double arc, double lateral)
+    {
+        const double h = kCurvatureSpanM / MapConstants::MAP_SIZE;
+        glm::dvec2 p0, t0, p1, t1;
+        centreAt(track, arc - h, p0, t0);
+        centreAt(track, arc + h, p1, t1);
+        const double curvature = (t0.x * t1.y - t0.y * t1.x) / (2.0 * h);  // Left turns positive
+        return 1.0 / std::max(1.0 - curvature * lateral, kMinArcScale);
+    }
+
+    bool toTrack(const TrackGeometry::Snapshot& track, const VehicleSnapshot& s, TrackCoords& out)
+    {
+        glm::dvec2 centre, tangent;
+        out.arc = std::clamp(s.track_progress, 0.0, 1.0) * track.openLength;
+        centreAt(track, out.arc, centre, tangent);
+
+        const glm::dvec2 r = glm::dvec2(s.x, s.y) - centre;
+        const double maxOffset = kMaxTrackOffsetM / MapConstants::MAP_SIZE;
+        if (glm::dot(r, r) > maxOffset * maxOffset) {
+            return false;  // Progress not matched to this track (or to this part of it)
+        }
+        out.along = glm::dot(r, tangent);
+        out.lateral = r.y * tangent.x - r.x * tangent.y;
+        out.relHeading = wrapAngle(s.heading - std::atan2(tangent.y, tangent.x));
+        return true;
+    }
+
+    void fromTrack(const TrackGeometry::Snapshot& track, const TrackCoords& c, VehiclePose& out)
+    {
+        glm::dvec2 centre, tangent;
+        centreAt(track, c.arc, centre, tangent);
+        const glm::dvec2 normal(-tangent.y, tangent.x);
+        const glm::dvec2 p = centre + tangent * c.along + normal * c.lateral;
+        out.x = p.x;
+        out.y = p.y;
+        out.heading = wrapAngle(std::atan2(tangent.y, tangent.x) + c.relHeading);
+
+        double arc = c.arc;
+        if (isLoop(track)) {
+            arc = std::fmod(arc, static_cast<double>(track.loopLength));
+            if (arc < 0.0) arc += track.loopLength;
+        }
+        out.track_progress = std::clamp(arc / track.openLength, 0.0, 1.0);
+    }
+}
+
 // ============================================================================
 // SINGLETON
 // ============================================================================
@@ -18,13 +151,17 @@ VehicleInterpolator& VehicleInterpolator::Get()
 }
 
 VehicleInterpolator::VehicleInterpolator()
+    : m_slots(new VehicleSlot[MAX_VEHICLES])
 {
-    std::cout << "[INTERPOLATOR] Initialized" << std::endl;
+    for (std::atomic<int16_t>& slot : m_slot_of_id) {
+        slot.store(-1, std::memory_order_relaxed);
+    }
+    LOG_DEBUG(Vehicle, "[INTERPOLATOR] Initialized");
 }
 
 VehicleInterpolator::~VehicleInterpolator()
 {
-    std::cout << "[INTERPOLATOR] Destroyed" << std::endl;
+    LOG_DEBUG(Vehicle, "[INTERPOLATOR] Destroyed");
 }
 
 // ============================================================================
@@ -39,144 +176,310 @@ double VehicleInterpolator::GetTime()
 }
 
 // ============================================================================
-// ADD SNAPSHOT FROM NETWORK
+// RING STORAGE
 // ============================================================================
-void VehicleInterpolator::AddSnapshot(int32_t vehicleID, const VehicleSnapshot& snapshot)
+void VehicleInterpolator::RingSnapshot::Store(const VehicleSnapshot& s)
 {
-    // Get or create buffer for this vehicle
-    VehicleBuffer* buffer = nullptr;
-    {
-        std::lock_guard<std::mutex> lock(m_buffers_mutex);
-        buffer = &m_vehicle_buffers[vehicleID];
-    }
-    
-    // Thread-safe add to buffer
-    std::lock_guard<std::mutex> lock(buffer->mutex);
-    
+    timestamp.store(s.timestamp, std::memory_order_relaxed);
+    x.store(s.x, std::memory_order_relaxed);
+    y.store(s.y, std::memory_order_relaxed);
+    speed_kph.store(s.speed_kph, std::memory_order_relaxed);
+    heading.store(s.heading, std::memory_order_relaxed);
+    yaw_rate.store(s.yaw_rate, std::memory_order_relaxed);
+    track_progress.store(s.track_progress, std::memory_order_relaxed);
+}
+
+VehicleSnapshot VehicleInterpolator::RingSnapshot::Load() const
+{
+    VehicleSnapshot s;
+    s.timestamp = timestamp.load(std::memory_order_relaxed);
+    s.x = x.load(std::memory_order_relaxed);
+    s.y = y.load(std::memory_order_relaxed);
+    s.speed_kph = speed_kph.load(std::memory_order_relaxed);
+    s.heading = heading.load(std::memory_order_relaxed);
+    s.yaw_rate = yaw_rate.load(std::memory_order_relaxed);
+    s.track_progress = track_progress.load(std::memory_order_relaxed);
+    return s;
+}
+
+void VehicleInterpolator::VehicleSlot::Push(const VehicleSnapshot& snapshot, double arrivalTime)
+{
+    const uint64_t index = published.load(std::memory_order_relaxed);
+
     // Check for duplicate/old timestamp
-    if (!buffer->snapshots.empty() && snapshot.timestamp <= buffer->snapshots.back().timestamp) {
+    if (index > 0 && snapshot.timestamp <= newestTimestamp) {
         return;  // Ignore out-of-order or duplicate packets
     }
-    
-    // Add snapshot
-    buffer->snapshots.push_back(snapshot);
-    
-    // Cleanup old snapshots (keep last MAX_BUFFER_SIZE)
-    if (buffer->snapshots.size() > MAX_BUFFER_SIZE) {
-        buffer->snapshots.pop_front();
+
+    // Announce the overwrite before touching the entry, publish after
+    begun.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ring[index % RING_SIZE].Store(snapshot);
+    published.store(index + 1, std::memory_order_release);
+
+    newestTimestamp = snapshot.timestamp;
+    lastArrival = arrivalTime;
+    playout.OnArrival(snapshot.timestamp, arrivalTime);
+}
+
+uint64_t VehicleInterpolator::VehicleSlot::FindAfter(double time, uint64_t lo, uint64_t hi) const
+{
+    while (lo < hi) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        if (ring[mid % RING_SIZE].timestamp.load(std::memory_order_relaxed) > time) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
     }
+    return lo;
 }
 
 // ============================================================================
-// GET INTERPOLATED STATE FOR RENDERING
+// SLOTS (PRODUCER SIDE)
 // ============================================================================
-bool VehicleInterpolator::GetInterpolatedState(
-    int32_t vehicleID,
-    double renderTime,
-    double& out_x,
-    double& out_y,
-    double& out_heading,
-    double& out_speed)
+int VehicleInterpolator::FindSlot(int32_t vehicleID) const
 {
-    // Find vehicle buffer
-    VehicleBuffer* buffer = nullptr;
-    {
-        std::lock_guard<std::mutex> lock(m_buffers_mutex);
-        auto it = m_vehicle_buffers.find(vehicleID);
-        if (it == m_vehicle_buffers.end()) {
-            return false;  // Vehicle not found
+    if (vehicleID >= 0 && vehicleID < DIRECT_IDS) {
+        return m_slot_of_id[vehicleID].load(std::memory_order_acquire);
+    }
+    for (size_t i = 0; i < MAX_VEHICLES; ++i) {
+        const VehicleSlot& slot = m_slots[i];
+        if ((slot.generation.load(std::memory_order_acquire) & 1) &&
+            slot.vehicleID.load(std::memory_order_relaxed) == vehicleID) {
+            return static_cast<int>(i);
         }
-        buffer = &it->second;
     }
-    
-    std::lock_guard<std::mutex> lock(buffer->mutex);
-    
-    // Need at least 2 snapshots for interpolation
-    if (buffer->snapshots.size() < 2) {
-        return false;
+    return -1;
+}
+
+VehicleInterpolator::VehicleSlot* VehicleInterpolator::ClaimSlotLocked(int32_t vehicleID, double now)
+{
+    const int existing = FindSlot(vehicleID);
+    if (existing >= 0) {
+        return &m_slots[existing];
     }
-    
-    // Apply interpolation delay (render behind server for smooth playback)
-    double interpolationTime = renderTime - INTERPOLATION_DELAY;
-    
-    // Try to find bracketing snapshots
-    VehicleSnapshot before, after;
-    if (buffer->GetBracketingSnapshots(interpolationTime, before, after))
+
+    for (size_t i = 0; i < MAX_VEHICLES; ++i)
     {
-        // Interpolate between before and after
-        double timeDelta = after.timestamp - before.timestamp;
-        double alpha = (timeDelta > 0.0) 
-            ? (interpolationTime - before.timestamp) / timeDelta 
-            : 0.0;
-        
-        // Clamp alpha to [0, 1]
-        alpha = std::clamp(alpha, 0.0, 1.0);
-        
-        Interpolate(before, after, alpha, out_x, out_y, out_heading, out_speed);
-        return true;
+        VehicleSlot& slot = m_slots[i];
+        if (slot.generation.load(std::memory_order_relaxed) & 1) {
+            continue;
+        }
+
+        // Readers still holding the previous generation will see it change
+        slot.begun.store(0, std::memory_order_relaxed);
+        slot.published.store(0, std::memory_order_relaxed);
+        slot.playout.ResetArrivals();
+        slot.newestTimestamp = 0.0;
+        slot.lastArrival = now;
+        slot.vehicleID.store(vehicleID, std::memory_order_relaxed);
+        slot.generation.fetch_add(1, std::memory_order_release);
+        if (vehicleID >= 0 && vehicleID < DIRECT_IDS) {
+            m_slot_of_id[vehicleID].store(static_cast<int16_t>(i), std::memory_order_release);
+        }
+        return &slot;
+    }
+
+    LOG_WARN_EVERY_N(Vehicle, 100, "[INTERPOLATOR] All " << MAX_VEHICLES << " slots in use, vehicle #" << vehicleID << " not buffered");
+    return nullptr;
+}
+
+void VehicleInterpolator::RetireSlotLocked(size_t index)
+{
+    VehicleSlot& slot = m_slots[index];
+    if (!(slot.generation.load(std::memory_order_relaxed) & 1)) {
+        return;
+    }
+
+    const int32_t vehicleID = slot.vehicleID.load(std::memory_order_relaxed);
+    if (vehicleID >= 0 && vehicleID < DIRECT_IDS) {
+        m_slot_of_id[vehicleID].store(-1, std::memory_order_relaxed);
+    }
+    slot.generation.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.vehicleID.store(-1, std::memory_order_relaxed);
+}
+
+void VehicleInterpolator::SweepStaleLocked(double now)
+{
+    if (now - m_last_sweep < SWEEP_INTERVAL) {
+        return;
     }
-    else
+    m_last_sweep = now;
+
+    for (size_t i = 0; i < MAX_VEHICLES; ++i)
     {
-        // No bracketing snapshots - need to extrapolate
-        const VehicleSnapshot& last = buffer->snapshots.back();
-        double deltaTime = interpolationTime - last.timestamp;
-        
-        // Only extrapolate for short duration (avoid wild predictions)
-        if (deltaTime > EXTRAPOLATION_LIMIT) {
-            deltaTime = EXTRAPOLATION_LIMIT;
-        }
-        
-        // Don't extrapolate backwards
-        if (deltaTime < 0.0) {
-            deltaTime = 0.0;
-        }
-        
-        Extrapolate(last, deltaTime, out_x, out_y, out_heading, out_speed);
-        return true;
+        const VehicleSlot& slot = m_slots[i];
+        if ((slot.generation.load(std::memory_order_relaxed) & 1) && now - slot.lastArrival > STALE_AFTER)
+        {
+            LOG_DEBUG(Vehicle, "[INTERPOLATOR] Vehicle #" << slot.vehicleID.load(std::memory_order_relaxed)
+                << " silent for " << STALE_AFTER << " s, buffer retired");
+            RetireSlotLocked(i);
+        }
+    }
+}
+
+void VehicleInterpolator::PushLocked(int32_t vehicleID, const VehicleSnapshot& snapshot, double now)
+{
+    if (VehicleSlot* slot = ClaimSlotLocked(vehicleID, now)) {
+        slot->Push(snapshot, now);
     }
 }
 
 // ============================================================================
-// GET BRACKETING SNAPSHOTS
+// ADD SNAPSHOT FROM NETWORK
 // ============================================================================
-bool VehicleInterpolator::VehicleBuffer::GetBracketingSnapshots(
-    double time,
-    VehicleSnapshot& out_before,
-    VehicleSnapshot& out_after) const
+void VehicleInterpolator::AddSnapshot(int32_t vehicleID, const VehicleSnapshot& snapshot)
 {
-    if (snapshots.size() < 2) {
-        return false;
+    const double arrivalTime = GetTime();
+
+    std::lock_guard<std::mutex> lock(m_producer_mutex);
+    SweepStaleLocked(arrivalTime);
+    PushLocked(vehicleID, snapshot, arrivalTime);
+}
+
+void VehicleInterpolator::AddSnapshots(const VehicleSnapshotUpdate* updates, size_t count)
+{
+    if (count == 0) {
+        return;
     }
-    
-    // Find first snapshot after time
-    auto it = std::find_if(snapshots.begin(), snapshots.end(),
-        [time](const VehicleSnapshot& s) { return s.timestamp > time; });
-    
-    // Check if we found bracketing snapshots
-    if (it != snapshots.end() && it != snapshots.begin())
-    {
-        out_after = *it;
-        out_before = *(it - 1);
-        return true;
+
+    const double arrivalTime = GetTime();  // One frame, one arrival
+
+    std::lock_guard<std::mutex> lock(m_producer_mutex);
+    SweepStaleLocked(arrivalTime);
+    for (size_t i = 0; i < count; ++i) {
+        PushLocked(updates[i].vehicleID, updates[i].snapshot, arrivalTime);
     }
-    
-    return false;  // Time is outside buffer range
 }
 
 // ============================================================================
-// CLEANUP OLD SNAPSHOTS
+// GET INTERPOLATED STATE FOR RENDERING
 // ============================================================================
-void VehicleInterpolator::VehicleBuffer::Cleanup(double currentTime)
+VehiclePose VehicleInterpolator::Sample(VehicleSlot& slot, int32_t vehicleID, double renderTime,
+    const TrackGeometry::Snapshot* track)
 {
-    // Remove snapshots older than 1 second
-    double cutoffTime = currentTime - 1.0;
-    
-    while (!snapshots.empty() && snapshots.front().timestamp < cutoffTime)
+    VehiclePose pose;
+
+    const uint32_t generation = slot.generation.load(std::memory_order_acquire);
+    if (!(generation & 1) || slot.vehicleID.load(std::memory_order_relaxed) != vehicleID) {
+        return pose;
+    }
+    if (slot.renderedGeneration != generation) {
+        slot.playout.ResetClock();  // A new vehicle in this slot
+        slot.renderedGeneration = generation;
+    }
+
+    // Apply this vehicle's playout delay (render behind server for smooth playback)
+    const double interpolationTime = renderTime - slot.playout.Advance(renderTime);
+
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt)
     {
-        snapshots.pop_front();
+        const uint64_t hi = slot.published.load(std::memory_order_acquire);
+
+        // Need at least 2 snapshots for interpolation
+        if (hi < 2) {
+            return pose;
+        }
+        const uint64_t lo = hi - std::min<uint64_t>(hi, RING_SIZE - READ_SLACK);
+
+        const uint64_t after = slot.FindAfter(interpolationTime, lo, hi);
+        const bool bracketed = after > lo && after < hi;
+        VehicleSnapshot before = slot.ring[(bracketed || after == hi ? after - 1 : lo) % RING_SIZE].Load();
+        VehicleSnapshot next = bracketed ? slot.ring[after % RING_SIZE].Load() : before;
+
+        // Nothing was overwritten or handed to another vehicle while we read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.begun.load(std::memory_order_relaxed) > lo + RING_SIZE ||
+            slot.generation.load(std::memory_order_relaxed) != generation) {
+            continue;
+        }
+
+        if (bracketed)
+        {
+            // Interpolate between before and after
+            double timeDelta = next.timestamp - before.timestamp;
+            double alpha = (timeDelta > 0.0)
+                ? (interpolationTime - before.timestamp) / timeDelta
+                : 0.0;
+
+            // Clamp alpha to [0, 1]
+            alpha = std::clamp(alpha, 0.0, 1.0);
+
+            if (!track || !InterpolateOnTrack(*track, before, next, alpha, pose)) {
+                Interpolate(before, next, alpha, pose.x, pose.y, pose.heading, pose.speed_kph);
+                pose.track_progress = before.track_progress;
+            }
+            slot.playout.OnRendered(false);
+        }
+        else
+        {
+            // Past the newest snapshot - need to extrapolate (or, before the
+            // oldest, hold it)
+            double deltaTime = interpolationTime - before.timestamp;
+            slot.playout.OnRendered(deltaTime > 0.0);  // Ran past the newest snapshot
+
+            // Don't extrapolate backwards
+            if (deltaTime < 0.0) {
+                deltaTime = 0.0;
+            }
+
+            // Only extrapolate for short duration (avoid wild predictions);
+            // along the track the prediction bends with it, so it may run longer
+            if (!track || !ExtrapolateOnTrack(*track, before, std::min(deltaTime, EXTRAPOLATION_LIMIT_ON_TRACK), pose)) {
+                Extrapolate(before, std::min(deltaTime, EXTRAPOLATION_LIMIT), pose.x, pose.y, pose.heading, pose.speed_kph);
+                pose.track_progress = before.track_progress;
+            }
+        }
+        pose.valid = true;
+        pose.playout_time = interpolationTime;
+        return pose;
+    }
+
+    LOG_DEBUG(Vehicle, "[INTERPOLATOR] Vehicle #" << vehicleID << " ring overrun while reading");
+    return pose;
+}
+
+void VehicleInterpolator::GetInterpolatedStates(double renderTime, const int32_t* ids, size_t count, VehiclePose* out)
+{
+    // One track for the whole frame
+    const TrackGeometry::SnapshotPtr trackPtr = TrackGeometry::Current();
+    const TrackGeometry::Snapshot* track =
+        (trackPtr->HasTrack() && trackPtr->openLength > 1e-6f) ? trackPtr.get() : nullptr;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const int index = FindSlot(ids[i]);
+        out[i] = (index >= 0) ? Sample(m_slots[index], ids[i], renderTime, track) : VehiclePose{};
     }
 }
 
+bool VehicleInterpolator::GetInterpolatedState(
+    int32_t vehicleID,
+    double renderTime,
+    double& out_x,
+    double& out_y,
+    double& out_heading,
+    double& out_speed,
+    double* out_playout_time)
+{
+    VehiclePose pose;
+    GetInterpolatedStates(renderTime, &vehicleID, 1, &pose);
+    if (!pose.valid) {
+        return false;
+    }
+
+    out_x = pose.x;
+    out_y = pose.y;
+    out_heading = pose.heading;
+    out_speed = pose.speed_kph;
+    if (out_playout_time) {
+        *out_playout_time = pose.playout_time;
+    }
+    return true;
+}
+
 // ============================================================================
 // LINEAR INTERPOLATION
 // ============================================================================
@@ -206,6 +509,77 @@ void VehicleInterpolator::Interpolate(
     out_heading = before.heading + angleDiff * alpha;
 }
 
+// ============================================================================
+// TRACK-SPACE INTERPOLATION
+// ============================================================================
+bool VehicleInterpolator::InterpolateOnTrack(
+    const TrackGeometry::Snapshot& track,
+    const VehicleSnapshot& before,
+    const VehicleSnapshot& after,
+    double alpha,
+    VehiclePose& out)
+{
+    TrackCoords a, b;
+    if (!toTrack(track, before, a) || !toTrack(track, after, b)) {
+        return false;
+    }
+
+    const double dt = after.timestamp - before.timestamp;
+    const double ds = arcDelta(track, a.arc, b.arc);
+    const double chord = std::hypot(after.x - before.x, after.y - before.y);
+    if (dt <= 0.0 || std::abs(ds) > kDetourFactor * chord + kDetourSlackM / MapConstants::MAP_SIZE) {
+        return false;  // Progress jumped to another part of the track
+    }
+
+    // Slopes: the reported speeds carried onto the centre line, limited to
+    // 3x the mean so the arc length never runs backwards or overshoots the
+    // next fix (Fritsch-Carlson)
+    const double secant = ds / dt;
+    double v0 = secant, v1 = secant;
+    if (secant > 0.0) {
+        v0 = std::clamp(before.speed_kph / 3.6 / MapConstants::MAP_SIZE * arcPerDistance(track, a.arc, a.lateral),
+            0.0, 3.0 * secant);
+        v1 = std::clamp(after.speed_kph / 3.6 / MapConstants::MAP_SIZE * arcPerDistance(track, b.arc, b.lateral),
+            0.0, 3.0 * secant);
+    }
+
+    const double t = alpha, t2 = t * t, t3 = t2 * t;
+    const double h10 = t3 - 2.0 * t2 + t;
+    const double h01 = -2.0 * t3 + 3.0 * t2;
+    const double h11 = t3 - t2;
+
+    TrackCoords c;
+    c.arc = a.arc + h10 * dt * v0 + h01 * ds + h11 * dt * v1;
+    c.along = a.along + (b.along - a.along) * alpha;
+    c.lateral = a.lateral + (b.lateral - a.lateral) * alpha;
+    c.relHeading = a.relHeading + wrapAngle(b.relHeading - a.relHeading) * alpha;
+    fromTrack(track, c, out);
+
+    out.speed_kph = before.speed_kph + (after.speed_kph - before.speed_kph) * alpha;
+    return true;
+}
+
+bool VehicleInterpolator::ExtrapolateOnTrack(
+    const TrackGeometry::Snapshot& track,
+    const VehicleSnapshot& last,
+    double deltaTime,
+    VehiclePose& out)
+{
+    TrackCoords c;
+    if (!toTrack(track, last, c)) {
+        return false;
+    }
+
+    // Carried along the line at the last speed, still crossing it at the
+    // last angle to it (a car moving across to the apex keeps doing so)
+    const double distance = (last.speed_kph / 3.6 / MapConstants::MAP_SIZE) * deltaTime;
+    c.arc += distance * std::cos(c.relHeading) * arcPerDistance(track, c.arc, c.lateral);
+    c.lateral += distance * std::sin(c.relHeading);
+    fromTrack(track, c, out);
+    out.speed_kph = last.speed_kph;
+    return true;
+}
+
 // ============================================================================
 // EXTRAPOLATION (CLIENT-SIDE PREDICTION)
 // ============================================================================
@@ -223,22 +597,64 @@ void VehicleInterpolator::Extrapolate(
     // Convert to normalized units (MapConstants::MAP_SIZE meters = 1.0 units)
     double speed_normalized = speed_ms / MapConstants::MAP_SIZE;
     
-    // Predict position based on last known heading and speed
+    // Predict position based on last known heading, yaw rate and speed
     double distance = speed_normalized * deltaTime;
+    double turn = last.yaw_rate * deltaTime;
     
-    out_x = last.x + std::cos(last.heading) * distance;
-    out_y = last.y + std::sin(last.heading) * distance;
-    out_heading = last.heading;  // Assume constant heading
+    if (std::abs(turn) < 1e-6) {
+        out_x = last.x + std::cos(last.heading) * distance;
+        out_y = last.y + std::sin(last.heading) * distance;
+    } else {
+        // Constant turn rate: arc of radius distance / turn
+        double radius = distance / turn;
+        out_x = last.x + radius * (std::sin(last.heading + turn) - std::sin(last.heading));
+        out_y = last.y - radius * (std::cos(last.heading + turn) - std::cos(last.heading));
+    }
+    out_heading = last.heading + turn;
     out_speed = last.speed_kph;  // Assume constant speed
 }
 
+
 // ============================================================================
 // REMOVE VEHICLE
 // ============================================================================
 void VehicleInterpolator::RemoveVehicle(int32_t vehicleID)
 {
-    std::lock_guard<std::mutex> lock(m_buffers_mutex);
-    m_vehicle_buffers.erase(vehicleID);
+    std::lock_guard<std::mutex> lock(m_producer_mutex);
+    const int index = FindSlot(vehicleID);
+    if (index >= 0) {
+        RetireSlotLocked(static_cast<size_t>(index));
+    }
+}
+
+// ============================================================================
+// PLAYOUT STATS
+// ============================================================================
+void VehicleInterpolator::GetPlayoutStats(std::vector<VehiclePlayoutStats>& out)
+{
+    out.clear();
+    for (size_t i = 0; i < MAX_VEHICLES; ++i)
+    {
+        const VehicleSlot& slot = m_slots[i];
+        const uint32_t generation = slot.generation.load(std::memory_order_acquire);
+        if (!(generation & 1)) {
+            continue;
+        }
+        VehiclePlayoutStats stats;
+        stats.vehicleID = slot.vehicleID.load(std::memory_order_relaxed);
+        stats.playout = slot.playout.GetStats();
+        if (slot.renderedGeneration != generation) {
+            stats.playout.frames = stats.playout.underruns = 0;  // Counters of the previous owner
+        }
+        out.push_back(stats);
+    }
+}
+
+void VehicleInterpolator::ResetPlayoutCounters()
+{
+    for (size_t i = 0; i < MAX_VEHICLES; ++i) {
+        m_slots[i].playout.ResetCounters();
+    }
 }
 
 // ============================================================================
@@ -246,7 +662,9 @@ void VehicleInterpolator::RemoveVehicle(int32_t vehicleID)
 // ============================================================================
 void VehicleInterpolator::Clear()
 {
-    std::lock_guard<std::mutex> lock(m_buffers_mutex);
-    m_vehicle_buffers.clear();
-    std::cout << "[INTERPOLATOR] Cleared all buffers" << std::endl;
+    std::lock_guard<std::mutex> lock(m_producer_mutex);
+    for (size_t i = 0; i < MAX_VEHICLES; ++i) {
+        RetireSlotLocked(i);
+    }
+    LOG_INFO(Vehicle, "[INTERPOLATOR] Cleared all buffers");
 }
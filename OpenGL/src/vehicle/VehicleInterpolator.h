@@ -1,11 +1,16 @@
 #pragma once
 
-#include <map>
-#include <deque>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include <mutex>
 #include <chrono>
 #include <cstdint>
 
+#include "PlayoutDelay.h"
+
+namespace TrackGeometry { struct Snapshot; }
+
 // ============================================================================
 // VEHICLE SNAPSHOT - Single state sample from network
 // ============================================================================
@@ -15,16 +20,62 @@ struct VehicleSnapshot
     double x, y;                // Normalized position
     double speed_kph;           // Speed in km/h
     double heading;             // Direction angle in radians
+    double yaw_rate;            // Radians per second (0 when unknown)
     double track_progress;      // Progress along track (0.0 - 1.0)
     
     VehicleSnapshot() 
         : timestamp(0.0), x(0.0), y(0.0), speed_kph(0.0), 
-          heading(0.0), track_progress(0.0) {}
+          heading(0.0), yaw_rate(0.0), track_progress(0.0) {}
+};
+
+// One snapshot tagged with its vehicle (batch ingest of multi-car frames)
+struct VehicleSnapshotUpdate
+{
+    int32_t vehicleID = 0;
+    VehicleSnapshot snapshot;
+};
+
+// Interpolated pose of one vehicle for one frame
+struct VehiclePose
+{
+    bool valid = false;         // False: not enough data, use the raw telemetry
+    double x = 0.0, y = 0.0;    // Normalized position
+    double heading = 0.0;       // Radians
+    double speed_kph = 0.0;
+    double track_progress = 0.0; // 0..1, interpolated along the centre line
+    double playout_time = 0.0;  // Buffer time the pose was taken at
+};
+
+// Playout buffer state of one vehicle (for the latency panel)
+struct VehiclePlayoutStats
+{
+    int32_t vehicleID = 0;
+    PlayoutDelay::Stats playout;
 };
 
 // ============================================================================
 // VEHICLE INTERPOLATOR - Jitter Buffer + Client-Side Prediction
-// Thread-safe singleton for smooth vehicle rendering
+// Thread-safe singleton for smooth vehicle rendering. Each vehicle is played
+// out with its own adaptive delay (see PlayoutDelay.h).
+//
+// Between two fixes a car moves along the smoothed centre line, not across
+// the infield: both fixes are taken into track space (arc length from their
+// track_progress, offset from the line), the arc length follows a cubic
+// Hermite with the reported speeds as its slope (a car on the inside of a
+// bend covers more of the centre line than it drives), and the result is
+// mapped back through the current TrackGeometry. Extrapolation runs along the line the
+// same way. Fixes that are not on the current track fall back to straight
+// lines.
+//
+// Every vehicle owns a slot in a fixed array: a ring of the last RING_SIZE
+// snapshots that one producer writes and the render thread reads without
+// locks. Producers (ingest threads) take m_producer_mutex, once per batch, so
+// each ring has a single writer at a time. A slot whose vehicle has sent
+// nothing for STALE_AFTER seconds is retired and reused.
+//
+// The render thread is the only consumer: GetInterpolatedStates (and
+// GetInterpolatedState, GetPlayoutStats, ResetPlayoutCounters) must be called
+// from it alone — they advance and read the per-vehicle playout clocks.
 // ============================================================================
 class VehicleInterpolator
 {
@@ -34,16 +85,28 @@ public:
     
     // Add new snapshot from network (called from processIncomingTelemetry)
     void AddSnapshot(int32_t vehicleID, const VehicleSnapshot& snapshot);
+
+    // Same as AddSnapshot for a whole frame under a single producer lock
+    // (called from processIncomingTelemetryBatch)
+    void AddSnapshots(const VehicleSnapshotUpdate* updates, size_t count);
     
-    // Get interpolated state for rendering (called from renderAllVehicles)
+    // Poses of `count` vehicles for one frame (called from renderAllVehicles,
+    // once per frame — it advances each vehicle's playout clock). out[i] is
+    // the pose of ids[i]. No locks.
+    void GetInterpolatedStates(double renderTime, const int32_t* ids, size_t count, VehiclePose* out);
+
+    // Single-vehicle form of GetInterpolatedStates
     // Returns false if not enough data for interpolation
+    // out_playout_time: buffer time the state was taken at (render time -
+    // the vehicle's current delay)
     bool GetInterpolatedState(
         int32_t vehicleID, 
         double renderTime,
         double& out_x, 
         double& out_y, 
         double& out_heading,
-        double& out_speed
+        double& out_speed,
+        double* out_playout_time = nullptr
     );
     
     // Remove vehicle from interpolator (called when vehicle disconnects)
@@ -54,6 +117,12 @@ public:
     
     // Get current time in seconds
     static double GetTime();
+
+    // Playout delay, rate, jitter, loss and underruns of every buffer
+    void GetPlayoutStats(std::vector<VehiclePlayoutStats>& out);
+
+    // Zero the frame/underrun counters (latency panel Reset)
+    void ResetPlayoutCounters();
     
 private:
     // Private constructor for singleton
@@ -67,34 +136,88 @@ private:
     // ========================================================================
     // CONFIGURATION
     // ========================================================================
-    static constexpr size_t MAX_BUFFER_SIZE = 20;          // Keep last 20 snapshots
-    static constexpr double INTERPOLATION_DELAY = 0.033;   // Small buffer for high-rate simulation packets
-    static constexpr double EXTRAPOLATION_LIMIT = 0.050;   // Short prediction window before freezing
+    static constexpr size_t RING_SIZE = 32;                // > PlayoutDelay::MAX_DELAY at 60 Hz
+    static constexpr size_t MAX_VEHICLES = 256;            // Slots
+    static constexpr int32_t DIRECT_IDS = 1024;            // IDs below this are looked up directly
+    static constexpr double EXTRAPOLATION_LIMIT = 0.100;   // Prediction window before freezing (turns with the yaw rate)
+    static constexpr double EXTRAPOLATION_LIMIT_ON_TRACK = 0.120;  // Following the line bends with the track
+    static constexpr double STALE_AFTER = 10.0;            // Retire a slot silent this long
+    static constexpr double SWEEP_INTERVAL = 1.0;          // How often producers look for stale slots
+    static constexpr size_t READ_SLACK = 4;                // Writes a reader survives mid-search
+    static constexpr int READ_ATTEMPTS = 3;
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
     
     // ========================================================================
-    // PER-VEHICLE BUFFER
+    // PER-VEHICLE RING
     // ========================================================================
-    struct VehicleBuffer
+    // Snapshot fields as relaxed atomics: a reader racing the writer sees
+    // old or new values, never a torn double, and the ring indices below
+    // tell it whether to trust them.
+    struct RingSnapshot
     {
-        std::deque<VehicleSnapshot> snapshots;
-        std::mutex mutex;
-        
-        // Get two snapshots for interpolation at given time
-        bool GetBracketingSnapshots(
-            double time, 
-            VehicleSnapshot& out_before, 
-            VehicleSnapshot& out_after
-        ) const;
-        
-        // Remove old snapshots to prevent memory growth
-        void Cleanup(double currentTime);
+        std::atomic<double> timestamp{ 0.0 };
+        std::atomic<double> x{ 0.0 }, y{ 0.0 };
+        std::atomic<double> speed_kph{ 0.0 };
+        std::atomic<double> heading{ 0.0 };
+        std::atomic<double> yaw_rate{ 0.0 };
+        std::atomic<double> track_progress{ 0.0 };
+
+        void Store(const VehicleSnapshot& s);
+        VehicleSnapshot Load() const;
+    };
+
+    struct VehicleSlot
+    {
+        // Odd while a vehicle owns the slot; bumped on claim and retire, so a
+        // reader that saw the same odd value before and after read one vehicle.
+        std::atomic<uint32_t> generation{ 0 };
+        std::atomic<int32_t>  vehicleID{ -1 };
+
+        // Ring indices count snapshots ever written. Entry i lives in
+        // ring[i % RING_SIZE]; `begun` moves before an entry is overwritten,
+        // `published` after it is complete.
+        std::atomic<uint64_t> begun{ 0 };
+        std::atomic<uint64_t> published{ 0 };
+        RingSnapshot ring[RING_SIZE];
+
+        PlayoutDelay playout;
+
+        // Producer only
+        double newestTimestamp = 0.0;
+        double lastArrival = 0.0;
+
+        // Consumer only
+        uint32_t renderedGeneration = 0;
+
+        // Append in timestamp order (producer holds m_producer_mutex)
+        void Push(const VehicleSnapshot& snapshot, double arrivalTime);
+
+        // First ring index in [lo, hi) with a timestamp after `time` (binary
+        // search; hi if none). Consumer only.
+        uint64_t FindAfter(double time, uint64_t lo, uint64_t hi) const;
     };
     
     // ========================================================================
     // DATA
     // ========================================================================
-    std::map<int32_t, VehicleBuffer> m_vehicle_buffers;
-    std::mutex m_buffers_mutex;  // Protects m_vehicle_buffers map
+    std::unique_ptr<VehicleSlot[]> m_slots;
+    std::atomic<int16_t> m_slot_of_id[DIRECT_IDS];      // -1 = none; verified against the slot
+    std::mutex m_producer_mutex;                        // Serializes producers, never the renderer
+    double m_last_sweep = 0.0;                          // Producer only
+
+    // Producer side (m_producer_mutex held)
+    VehicleSlot* ClaimSlotLocked(int32_t vehicleID, double now);
+    void RetireSlotLocked(size_t index);
+    void SweepStaleLocked(double now);
+    void PushLocked(int32_t vehicleID, const VehicleSnapshot& snapshot, double now);
+
+    // Slot currently owned by vehicleID, or -1 (either side; the consumer
+    // re-checks the owner around its read)
+    int FindSlot(int32_t vehicleID) const;
+
+    // Consumer side; track may be null or empty
+    VehiclePose Sample(VehicleSlot& slot, int32_t vehicleID, double renderTime,
+        const TrackGeometry::Snapshot* track);
     
     // ========================================================================
     // INTERPOLATION LOGIC
@@ -110,7 +233,25 @@ private:
         double& out_speed
     );
     
-    // Extrapolate (predict) beyond last known snapshot
+    // Hermite in arc length between two fixes on the centre line; false if
+    // either fix is off the track (caller falls back to Interpolate)
+    static bool InterpolateOnTrack(
+        const TrackGeometry::Snapshot& track,
+        const VehicleSnapshot& before,
+        const VehicleSnapshot& after,
+        double alpha,
+        VehiclePose& out
+    );
+
+    // Extrapolate along the centre line; false if `last` is off the track
+    static bool ExtrapolateOnTrack(
+        const TrackGeometry::Snapshot& track,
+        const VehicleSnapshot& last,
+        double deltaTime,
+        VehiclePose& out
+    );
+
+    // Extrapolate (predict) beyond last known snapshot, turning at its yaw rate
     static void Extrapolate(
         const VehicleSnapshot& last,
         double deltaTime,
@@ -0,0 +1,112 @@
+#pragma once
+
+// ============================================================================
+// CarTrace — a simulated car and the telemetry a logger would send for it,
+// for the VehicleFilter test and benchmark.
+//
+// The car weaves through corners of up to 1.3 g and brakes and accelerates
+// at up to 0.6 g between 17 and 33 m/s; its ground truth is integrated every
+// millisecond. Records carry GNSS fixes with Gaussian noise and occasional
+// outliers, the speed, and lateral/longitudinal G as signed g with their own
+// noise and the logger's mounting signs.
+// ============================================================================
+
+#include "src/vehicle/VehicleFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace CarTrace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kGravity = 9.81;
+constexpr double kStep = 0.001;        // Truth resolution, s
+
+struct Truth {
+    double time, easting, northing, heading, speed, yawRate, accel;
+};
+
+struct Noise {
+    double positionSigma = 1.5;        // m
+    double outlierRate = 0.02;         // Share of fixes off by outlierMetres
+    double outlierMetres = 25.0;
+    double speedSigma = 0.3;           // m/s
+    double gSigma = 0.05;              // g
+    int    fixType = 1;
+    int    lateralSign = 1;            // Logger axes as mounted
+    int    longitudinalSign = 1;
+};
+
+struct Record {
+    Truth truth;
+    VehicleFilter::Measurement m;
+    bool outlier = false;
+};
+
+inline double SpeedAt(double t) { return 25.0 + 8.0 * std::sin(2.0 * kPi * t / 9.0); }
+inline double AccelAt(double t) { return 8.0 * 2.0 * kPi / 9.0 * std::cos(2.0 * kPi * t / 9.0); }
+inline double YawRateAt(double t) { return 0.4 * std::sin(2.0 * kPi * t / 7.0) * std::sin(2.0 * kPi * t / 23.0); }
+
+// Ground truth every kStep from `startEasting`/`startNorthing`, heading east
+inline std::vector<Truth> Simulate(double seconds, double startEasting = 500000.0, double startNorthing = 6200000.0)
+{
+    std::vector<Truth> truth;
+    truth.reserve(static_cast<size_t>(seconds / kStep) + 2);
+    Truth s{ 0.0, startEasting, startNorthing, 0.0, SpeedAt(0.0), YawRateAt(0.0), AccelAt(0.0) };
+    for (size_t i = 0; s.time <= seconds; ++i) {
+        truth.push_back(s);
+        // Midpoint step
+        const double tm = s.time + 0.5 * kStep;
+        const double heading = s.heading + 0.5 * kStep * s.yawRate;
+        s.easting += SpeedAt(tm) * std::cos(heading) * kStep;
+        s.northing += SpeedAt(tm) * std::sin(heading) * kStep;
+        s.heading += YawRateAt(tm) * kStep;
+        s.time = static_cast<double>(i + 1) * kStep;
+        s.speed = SpeedAt(s.time);
+        s.yawRate = YawRateAt(s.time);
+        s.accel = AccelAt(s.time);
+    }
+    return truth;
+}
+
+// Telemetry of `truth` at `rateHz`
+inline std::vector<Record> Sample(const std::vector<Truth>& truth, double rateHz, const Noise& noise, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const size_t stride = static_cast<size_t>(std::lround(1.0 / (rateHz * kStep)));
+    std::vector<Record> records;
+    records.reserve(truth.size() / stride + 1);
+    for (size_t i = 0; i < truth.size(); i += stride) {
+        const Truth& t = truth[i];
+        Record r;
+        r.truth = t;
+        r.m.time = t.time;
+        r.m.fixType = noise.fixType;
+        r.m.easting = t.easting + noise.positionSigma * gauss(rng);
+        r.m.northing = t.northing + noise.positionSigma * gauss(rng);
+        if (unit(rng) < noise.outlierRate) {
+            const double a = 2.0 * kPi * unit(rng);
+            r.m.easting += noise.outlierMetres * std::cos(a);
+            r.m.northing += noise.outlierMetres * std::sin(a);
+            r.outlier = true;
+        }
+        r.m.speed = std::max(0.0, t.speed + noise.speedSigma * gauss(rng));
+        r.m.lateralG = noise.lateralSign * (t.speed * t.yawRate / kGravity + noise.gSigma * gauss(rng));
+        r.m.longitudinalG = noise.longitudinalSign * (t.accel / kGravity + noise.gSigma * gauss(rng));
+        records.push_back(r);
+    }
+    return records;
+}
+
+inline double WrapAngle(double a)
+{
+    while (a > kPi) a -= 2.0 * kPi;
+    while (a < -kPi) a += 2.0 * kPi;
+    return a;
+}
+
+} // namespace CarTrace
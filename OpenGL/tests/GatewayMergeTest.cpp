@@ -0,0 +1,255 @@
+// GatewayMerge behind real decoders: three gateways hear one race with
+// overlapping losses (each drops its own frames, some frames reach nobody),
+// each gateway's byte stream goes through its own RajaStreamDecoder, and the
+// copies arrive interleaved with per-gateway lag. Every frame that reached a
+// gateway must be accepted exactly once, from its earliest copy, and the
+// per-gateway frames / firsts / exclusive / coverage figures must match what
+// was sent.
+
+#include "src/network/GatewayMerge.h"
+#include "src/network/RajaStreamDecoder.h"
+#include "RajaTestFrames.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using RajaTestFrames::Frame;
+
+namespace {
+
+constexpr size_t kGateways = 3;
+constexpr int kCars = 12;
+constexpr uint32_t kFramesPerCar = 400;
+
+struct Arrival {
+    double at = 0.0;            // Arrival time, in frame slots
+    size_t gateway = 0;
+    size_t frame = 0;           // Index into Race::frames
+};
+
+struct Race {
+    std::vector<Frame> frames;                      // In send order
+    std::vector<uint8_t> heardBy;                   // Bit per gateway, per frame
+    std::vector<Arrival> arrivals;                  // Sorted by time
+    std::vector<uint8_t> streams[kGateways];        // Bytes each port read
+};
+
+// Gateway 0 covers the main straight, 1 the far side, 2 the whole paddock
+// badly. Losses depend on where the car is, so they overlap.
+Race makeRace(unsigned seed)
+{
+    Race race;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double lag[kGateways] = { 0.0, 1.5, 3.0 };
+
+    for (uint32_t n = 0; n < kFramesPerCar; ++n) {
+        for (int car = 1; car <= kCars; ++car) {
+            const size_t index = race.frames.size();
+            race.frames.push_back(RajaTestFrames::CarFrame(car, n));
+
+            const double lapPos = std::fmod(n * 0.01 + car * 0.083, 1.0);
+            const double loss[kGateways] = {
+                lapPos < 0.5 ? 0.05 : 0.7,
+                lapPos < 0.5 ? 0.7 : 0.05,
+                0.45,
+            };
+            uint8_t mask = 0;
+            for (size_t g = 0; g < kGateways; ++g) {
+                if (unit(rng) < loss[g])
+                    continue;
+                mask |= static_cast<uint8_t>(1u << g);
+                race.arrivals.push_back({ static_cast<double>(index) + lag[g] + unit(rng) * 2.0, g, index });
+            }
+            race.heardBy.push_back(mask);
+        }
+    }
+
+    std::stable_sort(race.arrivals.begin(), race.arrivals.end(),
+        [](const Arrival& a, const Arrival& b) { return a.at < b.at; });
+    for (const Arrival& a : race.arrivals) {
+        std::vector<uint8_t>& stream = race.streams[a.gateway];
+        if (rng() % 4 == 0)
+            RajaTestFrames::AppendNoise(stream, 1 + rng() % 60, rng);
+        RajaTestFrames::Append(stream, race.frames[a.frame]);
+    }
+    return race;
+}
+
+std::vector<rajagp::TelemetryPacket> decodeAll(const std::vector<uint8_t>& bytes)
+{
+    RajaStreamDecoder decoder;
+    std::vector<rajagp::TelemetryPacket> out;
+    rajagp::TelemetryPacket packet{};
+    size_t pos = 0;
+    while (pos < bytes.size()) {
+        pos += decoder.Feed(bytes.data() + pos, std::min<size_t>(bytes.size() - pos, 512));
+        while (decoder.Next(packet))
+            out.push_back(packet);
+    }
+    return out;
+}
+
+void testOverlappingLosses()
+{
+    const Race race = makeRace(3);
+
+    // Each port through its own decoder, as the reader threads do
+    std::vector<rajagp::TelemetryPacket> decoded[kGateways];
+    size_t perGateway[kGateways] = {};
+    for (const Arrival& a : race.arrivals)
+        perGateway[a.gateway]++;
+    for (size_t g = 0; g < kGateways; ++g) {
+        decoded[g] = decodeAll(race.streams[g]);
+        CHECK(decoded[g].size() == perGateway[g]);
+    }
+
+    // Copies reach the merge in arrival order
+    GatewayMerge merge;
+    size_t cursor[kGateways] = {};
+    std::vector<int> acceptedFrom(race.frames.size(), -1);
+    std::vector<int> firstArrival(race.frames.size(), -1);
+    size_t accepted = 0;
+    for (const Arrival& a : race.arrivals) {
+        if (firstArrival[a.frame] < 0)
+            firstArrival[a.frame] = static_cast<int>(a.gateway);
+        const rajagp::TelemetryPacket& packet = decoded[a.gateway][cursor[a.gateway]++];
+        CHECK(RajaTestFrames::Same(race.frames[a.frame], packet));
+        if (merge.Accept(a.gateway, packet)) {
+            CHECK(acceptedFrom[a.frame] < 0);
+            acceptedFrom[a.frame] = static_cast<int>(a.gateway);
+            ++accepted;
+        }
+    }
+
+    // Expected figures straight from who heard what
+    uint64_t heard = 0, lost = 0;
+    uint64_t frames[kGateways] = {}, firsts[kGateways] = {}, exclusive[kGateways] = {};
+    for (size_t i = 0; i < race.frames.size(); ++i) {
+        const uint8_t mask = race.heardBy[i];
+        if (mask == 0) {
+            ++lost;
+            CHECK(acceptedFrom[i] < 0);
+            continue;
+        }
+        ++heard;
+        CHECK(acceptedFrom[i] == firstArrival[i]);
+        firsts[firstArrival[i]]++;
+        for (size_t g = 0; g < kGateways; ++g) {
+            if (mask & (1u << g)) {
+                frames[g]++;
+                if (mask == (1u << g))
+                    exclusive[g]++;
+            }
+        }
+    }
+
+    CHECK(accepted == heard);
+    CHECK(merge.UniqueFrames() == heard);
+    std::printf("  %zu frames sent, %llu heard, %llu lost by every gateway\n", race.frames.size(),
+        static_cast<unsigned long long>(heard), static_cast<unsigned long long>(lost));
+    for (size_t g = 0; g < kGateways; ++g) {
+        const GatewayMerge::GatewayStats s = merge.Stats(g);
+        std::printf("  gateway %zu: %5.1f%% coverage, %llu firsts, %llu exclusive\n", g, s.coveragePct,
+            static_cast<unsigned long long>(s.firsts), static_cast<unsigned long long>(s.exclusive));
+        CHECK(s.frames == frames[g]);
+        CHECK(s.firsts == firsts[g]);
+        CHECK(s.exclusive == exclusive[g]);
+        CHECK_NEAR(s.coveragePct, 100.0 * frames[g] / heard, 1e-9);
+    }
+
+    // A gateway slot reused for another port starts from nothing
+    merge.ResetGateway(2);
+    const GatewayMerge::GatewayStats cleared = merge.Stats(2);
+    CHECK(cleared.frames == 0 && cleared.firsts == 0 && cleared.exclusive == 0);
+    CHECK(merge.UniqueFrames() == heard);
+
+    merge.Reset();
+    CHECK(merge.UniqueFrames() == 0);
+    CHECK(merge.Stats(0).frames == 0);
+}
+
+void testConcurrentReaders()
+{
+    // Another race, one thread per gateway. Threads only stay loosely
+    // in step, like real ports: none runs more than kSlack slots ahead of the
+    // slowest, well inside a car's window.
+    constexpr double kSlack = 100.0;
+    const Race race = makeRace(17);
+    GatewayMerge merge;
+    std::vector<std::pair<int32_t, uint32_t>> accepted[kGateways];
+    std::atomic<double> progress[kGateways];
+    for (std::atomic<double>& p : progress)
+        p.store(0.0);
+
+    std::vector<std::thread> readers;
+    for (size_t g = 0; g < kGateways; ++g) {
+        readers.emplace_back([&, g] {
+            const std::vector<rajagp::TelemetryPacket> packets = decodeAll(race.streams[g]);
+            size_t next = 0;
+            for (const Arrival& a : race.arrivals) {
+                if (a.gateway != g || next >= packets.size())
+                    continue;
+                progress[g].store(a.at);
+                for (size_t other = 0; other < kGateways; ++other)
+                    while (progress[other].load() + kSlack < a.at)
+                        std::this_thread::yield();
+                const rajagp::TelemetryPacket& packet = packets[next++];
+                if (merge.Accept(g, packet))
+                    accepted[g].emplace_back(packet.ID, packet.time);
+            }
+            progress[g].store(1e300);
+        });
+    }
+    for (std::thread& t : readers)
+        t.join();
+
+    std::set<std::pair<int32_t, uint32_t>> unique;
+    size_t total = 0;
+    for (size_t g = 0; g < kGateways; ++g) {
+        total += accepted[g].size();
+        unique.insert(accepted[g].begin(), accepted[g].end());
+    }
+    const size_t heard = static_cast<size_t>(std::count_if(race.heardBy.begin(), race.heardBy.end(),
+        [](uint8_t mask) { return mask != 0; }));
+    CHECK(total == heard);
+    CHECK(unique.size() == heard);
+    CHECK(merge.UniqueFrames() == heard);
+}
+
+void testOutOfRangeGateway()
+{
+    GatewayMerge merge;
+    const Frame frame = RajaTestFrames::CarFrame(1, 0);
+    std::vector<uint8_t> bytes;
+    RajaTestFrames::Append(bytes, frame);
+    const std::vector<rajagp::TelemetryPacket> packets = decodeAll(bytes);
+    CHECK(packets.size() == 1);
+    if (packets.empty())
+        return;
+
+    // Not tracked, never dropped
+    CHECK(merge.Accept(GatewayMerge::kMaxGateways, packets[0]));
+    CHECK(merge.Accept(GatewayMerge::kMaxGateways, packets[0]));
+    CHECK(merge.UniqueFrames() == 0);
+    CHECK(merge.Accept(0, packets[0]));
+    CHECK(!merge.Accept(1, packets[0]));
+    CHECK(!merge.Accept(0, packets[0]));
+    CHECK(merge.Stats(0).frames == 1 && merge.Stats(1).frames == 1);
+    CHECK(merge.Stats(0).exclusive == 0);
+}
+
+} // namespace
+
+int main()
+{
+    testOverlappingLosses();
+    testConcurrentReaders();
+    testOutOfRangeGateway();
+    return Test::Result("GatewayMergeTest");
+}
@@ -0,0 +1,268 @@
+// LapSamples against the doubles it replaced. Every field must round-trip
+// within half its quantization step and saturate at its limits. Then laps
+// of a kart at 10 Hz with jittered spacing, stored both ways: the delta to
+// the best lap and the three sector times, computed the way TimeDiff does
+// on each, must agree within a millisecond. LowerBound must agree with
+// std::lower_bound on the decoded column, across chunk boundaries and runs
+// of equal progress (a stopped car). Finally the chunking: memory in whole
+// chunks, nothing relocated by appends, move and Clear.
+
+#include "src/racing/LapSamples.h"
+#include "src/Config.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace {
+
+// LapInfo as it was: doubles and a time_point in a std::vector
+struct DoubleLapInfo {
+    float timefromstart;
+    double progress;
+    std::chrono::steady_clock::time_point timestamp;
+    double total_progress;
+    float gForceX, gForceY;
+    float aceleration, speed;
+    int curentPosition;
+};
+
+// TimeDiff's interpolation over the old samples
+double timeAtProgress(const std::vector<DoubleLapInfo>& samples, double progress)
+{
+    const auto it = std::lower_bound(samples.begin(), samples.end(), progress,
+        [](const DoubleLapInfo& s, double value) { return s.progress < value; });
+    if (it == samples.end())
+        return samples.back().timefromstart;
+    if (it == samples.begin())
+        return it->timefromstart;
+    const auto prev = std::prev(it);
+    const double t = (progress - prev->progress) / (it->progress - prev->progress);
+    return prev->timefromstart + (it->timefromstart - prev->timefromstart) * t;
+}
+
+// A lap of `seconds` at 10 Hz, spacing jittered by up to 3 ms, speed
+// varying so progress does not grow linearly
+struct TwoWays {
+    std::vector<DoubleLapInfo> doubles;
+    LapSamples compact;
+};
+
+TwoWays lap(double seconds, int racePosition, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    TwoWays both;
+    for (double t = 0.0; t < seconds; t += 0.1 + 0.003 * unit(rng)) {
+        DoubleLapInfo d{};
+        d.timefromstart = static_cast<float>(t);
+        d.progress = std::max(0.0, t / seconds + 0.002 * std::sin(t));
+        d.speed = static_cast<float>(80.0 + 40.0 * std::sin(t));
+        d.gForceX = static_cast<float>(1.2 * std::sin(1.3 * t));
+        d.gForceY = static_cast<float>(0.8 * std::cos(0.7 * t));
+        d.aceleration = static_cast<float>(3.0 * std::cos(t));
+        d.curentPosition = racePosition;
+        both.doubles.push_back(d);
+
+        LapInfo c;
+        c.timefromstart = d.timefromstart;
+        c.progress = d.progress;
+        c.speed = d.speed;
+        c.gForceX = d.gForceX;
+        c.gForceY = d.gForceY;
+        c.aceleration = d.aceleration;
+        c.curentPosition = d.curentPosition;
+        both.compact.Append(c);
+    }
+    return both;
+}
+
+void testRoundTrip()
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    LapSamples samples;
+    std::vector<LapInfo> written;
+    for (int i = 0; i < 5000; ++i) {
+        LapInfo s;
+        s.timefromstart = static_cast<float>(i * 0.1 + 0.0004 * unit(rng));
+        s.progress = i / 5000.0 + 1e-6 * unit(rng);
+        s.position = glm::vec2(static_cast<float>(3.0 * unit(rng)), static_cast<float>(3.0 * unit(rng)));
+        s.speed = static_cast<float>(150.0 + 149.0 * unit(rng));
+        s.gForceX = static_cast<float>(4.0 * unit(rng));
+        s.gForceY = static_cast<float>(4.0 * unit(rng));
+        s.aceleration = static_cast<float>(30.0 * unit(rng));
+        s.curentPosition = i % 60;
+        samples.Append(s);
+        written.push_back(s);
+    }
+
+    double time = 0.0, progress = 0.0, position = 0.0, speed = 0.0, g = 0.0, accel = 0.0;
+    bool racePositions = true, columns = true;
+    for (size_t i = 0; i < written.size(); ++i) {
+        const LapInfo& w = written[i];
+        const LapInfo r = samples.At(i);
+        time = std::max(time, static_cast<double>(std::abs(r.timefromstart - w.timefromstart)));
+        progress = std::max(progress, std::abs(r.progress - std::max(0.0, w.progress)));
+        position = std::max(position, static_cast<double>(glm::length(r.position - w.position)) * MapConstants::MAP_SIZE);
+        speed = std::max(speed, static_cast<double>(std::abs(r.speed - w.speed)));
+        g = std::max({ g, static_cast<double>(std::abs(r.gForceX - w.gForceX)), static_cast<double>(std::abs(r.gForceY - w.gForceY)) });
+        accel = std::max(accel, static_cast<double>(std::abs(r.aceleration - w.aceleration)));
+        racePositions = racePositions && r.curentPosition == w.curentPosition;
+        columns = columns && samples.TimeAt(i) == r.timefromstart && samples.ProgressAt(i) == r.progress;
+    }
+    std::printf("  round trip, worst: time %.3f ms, progress %.2e, position %.2f cm, speed %.4f kph, "
+        "G %.5f g, accel %.4f\n", time * 1e3, progress, position * 100.0, speed, g, accel);
+
+    // Half a step, plus float rounding of the decoded value
+    CHECK(time <= 0.0005 + 1e-5);
+    CHECK(progress <= 0.5 / LapSamples::PROGRESS_ONE + 1e-15);
+    CHECK(position <= 0.005 * std::sqrt(2.0) + 1e-5);
+    CHECK(speed <= 0.005 + 1e-4);
+    CHECK(g <= 0.0005 + 1e-6);
+    CHECK(accel <= 0.005 + 1e-5);
+    CHECK(racePositions && columns);
+    CHECK(samples.Back().curentPosition == written.back().curentPosition);
+
+    // Out of range: saturated, not wrapped
+    LapSamples limits;
+    LapInfo s;
+    s.speed = -5.0f;
+    s.gForceX = 40.0f;
+    s.gForceY = -40.0f;
+    s.aceleration = 1000.0f;
+    s.progress = -0.1;
+    limits.Append(s);
+    const LapInfo r = limits.At(0);
+    CHECK(r.speed == 0.0f && r.progress == 0.0);
+    CHECK_NEAR(r.gForceX, 32.767, 1e-4);
+    CHECK_NEAR(r.gForceY, -32.768, 1e-4);
+    CHECK_NEAR(r.aceleration, 327.67, 1e-3);
+
+    // The race position arrives after the standings sort
+    limits.SetBackRacePosition(7);
+    CHECK(limits.Back().curentPosition == 7);
+}
+
+void testAgainstDoubles()
+{
+    // A 40-lap stint; the best lap is the reference for the deltas
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<TwoWays> laps;
+    size_t best = 0;
+    std::vector<double> seconds;
+    for (int i = 0; i < 40; ++i) {
+        seconds.push_back(60.0 + 10.0 * unit(rng));
+        laps.push_back(lap(seconds.back(), 1 + i % 20, rng));
+        if (seconds.back() < seconds[best])
+            best = laps.size() - 1;
+    }
+
+    double deltaError = 0.0, sectorError = 0.0;
+    for (const TwoWays& current : laps) {
+        // Delta to the best lap at every sample of the current one, as
+        // TimeDiff computes it while the lap is driven
+        for (size_t i = 0; i < current.doubles.size(); ++i) {
+            const double p = current.doubles[i].progress;
+            const double oldDelta = current.doubles[i].timefromstart - timeAtProgress(laps[best].doubles, p);
+            const double newDelta = current.compact.TimeAt(i) - laps[best].compact.TimeAtProgress(current.compact.ProgressAt(i));
+            deltaError = std::max(deltaError, std::abs(oldDelta - newDelta));
+        }
+
+        // Sector times at the thirds, from the samples
+        double oldStart = timeAtProgress(current.doubles, 0.0), newStart = current.compact.TimeAtProgress(0.0);
+        for (double boundary : { 1.0 / 3.0, 2.0 / 3.0, 1.0 }) {
+            const double oldEnd = timeAtProgress(current.doubles, boundary);
+            const double newEnd = current.compact.TimeAtProgress(boundary);
+            sectorError = std::max(sectorError, std::abs((oldEnd - oldStart) - (newEnd - newStart)));
+            oldStart = oldEnd;
+            newStart = newEnd;
+        }
+    }
+    std::printf("  40 laps against doubles, worst: delta to best %.3f ms, sector %.3f ms\n", deltaError * 1e3,
+        sectorError * 1e3);
+    // Both ends rounded to the millisecond: half of one each
+    CHECK(deltaError <= 0.001 + 1e-6);
+    CHECK(sectorError <= 0.001 + 1e-6);
+}
+
+void testSearch()
+{
+    // 1000 samples (four chunks), with a stop: 60 samples at one progress
+    LapSamples samples;
+    std::vector<double> column;
+    double p = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        if (i < 240 || i >= 300)
+            p += 0.001;
+        LapInfo s;
+        s.progress = p;
+        s.timefromstart = i * 0.1f;
+        samples.Append(s);
+        column.push_back(samples.ProgressAt(i));
+    }
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> unit(-0.05, 1.05);
+    bool same = true;
+    std::vector<double> queries = { 0.0, column[0], column[255], column[256], column[240], column.back(), 2.0, -1.0 };
+    for (int i = 0; i < 20000; ++i)
+        queries.push_back(unit(rng));
+    for (double q : queries) {
+        // The search runs on the quantized value of the query
+        const double quantized = std::round(std::clamp(q, 0.0, 3.0) * LapSamples::PROGRESS_ONE) / LapSamples::PROGRESS_ONE;
+        const size_t expected = static_cast<size_t>(std::lower_bound(column.begin(), column.end(), quantized) - column.begin());
+        same = same && samples.LowerBound(q) == expected;
+    }
+    CHECK(same);
+
+    // Equal progress: the first of the run, so the stop is timed from its start
+    CHECK(samples.LowerBound(column[240]) == 239);
+    CHECK_NEAR(samples.TimeAtProgress(column[240]), samples.TimeAt(239), 1e-6);
+    // Clamped to the first and last sample
+    CHECK(samples.TimeAtProgress(-1.0) == samples.TimeAt(0));
+    CHECK(samples.TimeAtProgress(2.0) == samples.TimeAt(999));
+
+    LapSamples empty;
+    CHECK(empty.LowerBound(0.5) == 0 && empty.TimeAtProgress(0.5) == -1.0);
+}
+
+void testChunks()
+{
+    LapSamples samples;
+    CHECK(samples.MemoryBytes() == 0 && samples.Empty());
+    LapInfo s;
+    s.timefromstart = 1.5f;
+    samples.Append(s);
+    const size_t chunkBytes = samples.MemoryBytes();
+    CHECK(chunkBytes == 26 * LapSamples::CHUNK_SAMPLES);     // 26 bytes a sample
+
+    // Appends fill whole chunks and never move what is recorded
+    const LapInfo first = samples.At(0);
+    for (size_t i = 1; i < 3 * LapSamples::CHUNK_SAMPLES + 1; ++i)
+        samples.Append(s);
+    CHECK(samples.Size() == 3 * LapSamples::CHUNK_SAMPLES + 1);
+    CHECK(samples.MemoryBytes() == 4 * chunkBytes);
+    CHECK(samples.At(0).timefromstart == first.timefromstart);
+
+    LapSamples moved = std::move(samples);
+    CHECK(moved.Size() == 3 * LapSamples::CHUNK_SAMPLES + 1 && moved.MemoryBytes() == 4 * chunkBytes);
+    CHECK(samples.Empty() && samples.MemoryBytes() == 0);
+    CHECK(!moved.IsSpilled());
+
+    moved.Clear();
+    CHECK(moved.Empty() && moved.MemoryBytes() == 0);
+}
+
+} // namespace
+
+int main()
+{
+    testRoundTrip();
+    testAgainstDoubles();
+    testSearch();
+    testChunks();
+    return Test::Result("LapSamplesTest");
+}
@@ -0,0 +1,191 @@
+// LapSpill and spilled LapSamples. Before Open() nothing is reserved and a
+// lap stays in RAM. After it, Reserve() hands out 64-byte aligned space
+// across segment boundaries as the writer thread maps them. Reset()
+// rewinds to the start of the file. Then a session of 40 karts, every
+// completed lap spilled except each kart's best, the way RaceManager does:
+// spilled laps must read back exactly as before, and the heap must stay
+// flat however many laps are driven. A second session must reuse the file.
+
+#include "src/racing/LapSamples.h"
+#include "src/racing/LapSpill.h"
+#include "TestSupport.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Reserve, giving the writer thread time to map the next segment
+uint8_t* reserveWaiting(size_t bytes, size_t& misses)
+{
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        if (uint8_t* out = LapSpill::Reserve(bytes))
+            return out;
+        ++misses;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return nullptr;
+}
+
+LapSamples lapOf(double seconds, double offset)
+{
+    LapSamples lap;
+    for (double t = 0.0; t < seconds; t += 0.1) {
+        LapInfo s;
+        s.timefromstart = static_cast<float>(t);
+        s.progress = t / seconds;
+        s.speed = static_cast<float>(100.0 + 30.0 * std::sin(t + offset));
+        s.position = glm::vec2(static_cast<float>(std::cos(t)), static_cast<float>(std::sin(t)));
+        lap.Append(s);
+    }
+    return lap;
+}
+
+bool sameSamples(const LapSamples& a, const std::vector<LapInfo>& expected)
+{
+    bool same = a.Size() == expected.size();
+    for (size_t i = 0; same && i < expected.size(); ++i) {
+        const LapInfo s = a.At(i);
+        same = s.timefromstart == expected[i].timefromstart && s.progress == expected[i].progress &&
+            s.speed == expected[i].speed && s.position == expected[i].position;
+    }
+    return same;
+}
+
+std::vector<LapInfo> decoded(const LapSamples& lap)
+{
+    std::vector<LapInfo> samples;
+    for (size_t i = 0; i < lap.Size(); ++i)
+        samples.push_back(lap.At(i));
+    return samples;
+}
+
+void testBeforeOpen()
+{
+    CHECK(LapSpill::Reserve(100) == nullptr);
+    LapSamples lap = lapOf(10.0, 0.0);
+    CHECK(!lap.Spill() && !lap.IsSpilled() && lap.MemoryBytes() > 0);
+}
+
+void testReserve()
+{
+    LapSpill::Open();
+    LapSpill::Open();     // A second Open is a no-op
+
+    size_t misses = 0;
+    uint8_t* first = reserveWaiting(100, misses);
+    CHECK(first != nullptr);
+    CHECK(reinterpret_cast<uintptr_t>(first) % 64 == 0);
+    CHECK(LapSpill::SpilledBytes() == 128);
+    CHECK(LapSpill::Reserve(0) == nullptr);
+    CHECK(LapSpill::Reserve(LapSpill::SEGMENT_BYTES + 1) == nullptr);
+
+    // Three segments of 1 MB blocks, each stamped, none overlapping
+    constexpr size_t kBlock = size_t(1) << 20;
+    const size_t blocks = 3 * LapSpill::SEGMENT_BYTES / kBlock;
+    std::vector<uint8_t*> written;
+    for (size_t i = 0; i < blocks; ++i) {
+        uint8_t* out = reserveWaiting(kBlock, misses);
+        if (!out)
+            break;
+        std::memset(out, static_cast<int>(i & 0xFF), kBlock);
+        written.push_back(out);
+    }
+    CHECK(written.size() == blocks);
+    bool intact = true;
+    for (size_t i = 0; i < written.size(); ++i)
+        intact = intact && written[i][0] == static_cast<uint8_t>(i) && written[i][kBlock - 1] == static_cast<uint8_t>(i);
+    CHECK(intact);
+    std::printf("  %zu MB reserved in 1 MB blocks, %zu waits for the writer thread\n",
+        LapSpill::SpilledBytes() >> 20, misses);
+
+    // A new session starts over at the same place
+    LapSpill::Reset();
+    CHECK(LapSpill::SpilledBytes() == 0);
+    CHECK(LapSpill::Reserve(64) == first);
+    LapSpill::Reset();
+}
+
+void testSession()
+{
+    constexpr int kKarts = 40;
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    for (int session = 0; session < 2; ++session) {
+        std::vector<std::map<int, LapSamples>> karts(kKarts);
+        std::vector<std::map<int, std::vector<LapInfo>>> expected(kKarts);
+        std::vector<int> best(kKarts, -1);
+        std::vector<double> bestSeconds(kKarts, 1e9);
+        LapSpill::Reset();
+
+        size_t heapAtLap20 = 0, heapAtEnd = 0, notYet = 0;
+        bool readBack = true;
+        for (int lapNumber = 1; lapNumber <= 60; ++lapNumber) {
+            for (int k = 0; k < kKarts; ++k) {
+                const double seconds = 60.0 + 10.0 * unit(rng);
+                LapSamples& lap = karts[k][lapNumber] = lapOf(seconds, k);
+                expected[k][lapNumber] = decoded(lap);
+                if (seconds < bestSeconds[k]) {
+                    bestSeconds[k] = seconds;
+                    best[k] = lapNumber;
+                }
+                // The next lap starts: everything completed but the best goes
+                for (auto& [n, completed] : karts[k]) {
+                    if (n != best[k] && !completed.IsSpilled() && !completed.Spill())
+                        ++notYet;     // Not mapped yet; tried again next lap
+                }
+            }
+            if (lapNumber == 20 || lapNumber == 60) {
+                size_t heap = 0;
+                for (const auto& laps : karts)
+                    for (const auto& [n, lap] : laps)
+                        heap += lap.MemoryBytes();
+                (lapNumber == 20 ? heapAtLap20 : heapAtEnd) = heap;
+            }
+        }
+
+        size_t spilled = 0;
+        for (int k = 0; k < kKarts; ++k) {
+            for (const auto& [n, lap] : karts[k]) {
+                spilled += lap.IsSpilled() ? 1 : 0;
+                readBack = readBack && sameSamples(lap, expected[k][n]);
+                readBack = readBack && lap.IsSpilled() == (n != best[k]) && (lap.MemoryBytes() == 0) == lap.IsSpilled();
+            }
+        }
+        std::printf("  session %d: %zu laps spilled (%.1f MB of file), heap %.2f MB at lap 20 and %.2f MB at lap 60, "
+            "%zu spills retried\n", session + 1, spilled, LapSpill::SpilledBytes() / 1e6, heapAtLap20 / 1e6,
+            heapAtEnd / 1e6, notYet);
+
+        CHECK(readBack);
+        CHECK(spilled == static_cast<size_t>(kKarts * 59));
+        // The best lap of each kart and nothing else: two laps' worth at most
+        CHECK(heapAtEnd <= heapAtLap20 + kKarts * 2 * 2 * 26 * LapSamples::CHUNK_SAMPLES);
+        CHECK(heapAtEnd < static_cast<size_t>(kKarts) * 2 * 4 * 26 * LapSamples::CHUNK_SAMPLES);
+
+        // A spilled lap is complete, and moves with its data
+        LapSamples& spilledLap = karts[0][best[0] == 1 ? 2 : 1];
+        const size_t size = spilledLap.Size();
+        spilledLap.Append(LapInfo{});
+        spilledLap.SetBackRacePosition(9);
+        CHECK(spilledLap.Size() == size && spilledLap.Back().curentPosition == 0);
+        LapSamples moved = std::move(spilledLap);
+        CHECK(moved.IsSpilled() && moved.Size() == size && !spilledLap.IsSpilled() && spilledLap.Empty());
+        CHECK(moved.TimeAtProgress(0.5) > 29.0 && moved.TimeAtProgress(0.5) < 36.0);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testBeforeOpen();
+    testReserve();
+    testSession();
+    return Test::Result("LapSpillTest");
+}
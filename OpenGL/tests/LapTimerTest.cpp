@@ -0,0 +1,235 @@
+// LapTimer on synthetic laps of a 651 m stadium track: fixes at 5 to 50 Hz,
+// spaced regularly or with 30 % jitter on their timestamps, exact or with
+// 0.5 m of GNSS noise. Every crossing and lap time is compared with the
+// ground truth: exact fixes must time every lap to within a few
+// microseconds whatever the rate, noisy ones within the noise, and no lap
+// may be missed or counted twice. Then the jitter cases: a car creeping
+// over the line in noise, one reversing back and forth across it, a line
+// without a direction, the progress-wrap fallback and out-of-order fixes.
+
+#include "src/racing/LapTimer.h"
+#include "StadiumLaps.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace StadiumLaps;
+
+constexpr int kLaps = 10;
+
+LapTimer::Line startFinish()
+{
+    LapTimer::Line line;
+    line.p1 = { 0.0, -kRadius - 10.0 };
+    line.p2 = { 0.0, -kRadius + 10.0 };
+    line.forward = { 1.0, 0.0 };
+    return line;
+}
+
+LapTimer::Fix fixAt(const Truth& truth, int64_t timeUs, double noise, std::mt19937& rng)
+{
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    const double s = truth.ArcAt(static_cast<double>(timeUs) * 1e-6);
+    const glm::dvec2 p = Centre(s);
+    LapTimer::Fix fix;
+    fix.timeUs = timeUs;
+    fix.x = p.x + noise * gauss(rng);
+    fix.y = p.y + noise * gauss(rng);
+    fix.progress = std::fmod(s, kLength) / kLength;
+    return fix;
+}
+
+struct Result {
+    size_t crossings = 0;
+    double maxCrossingErrorUs = 0.0;
+    double maxLapErrorUs = 0.0;
+    double lapErrorRmsUs = 0.0;
+};
+
+Result runLaps(const Truth& truth, double rateHz, double jitter, double noise, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(-0.5, 0.5);
+    const LapTimer::Line line = startFinish();
+    LapTimer timer;
+    Result r;
+    double sumSq = 0.0;
+    size_t laps = 0;
+    for (int k = 0; ; ++k) {
+        const double t = (k + jitter * unit(rng)) / rateHz;
+        if (t > truth.Seconds())
+            break;
+        const LapTimer::Crossing c = timer.OnFix(fixAt(truth, std::llround(std::max(t, 0.0) * 1e6), noise, rng), line);
+        if (!c.crossed)
+            continue;
+        const size_t i = r.crossings++;
+        if (i >= truth.crossings.size())
+            continue;           // Counted once too often; caught by the caller
+        CHECK(c.first == (i == 0));
+        r.maxCrossingErrorUs = std::max(r.maxCrossingErrorUs, std::abs(c.timeUs - truth.crossings[i] * 1e6));
+        if (i > 0) {
+            const double lapError = c.lapUs - (truth.crossings[i] - truth.crossings[i - 1]) * 1e6;
+            r.maxLapErrorUs = std::max(r.maxLapErrorUs, std::abs(lapError));
+            sumSq += lapError * lapError;
+            ++laps;
+        }
+    }
+    r.lapErrorRmsUs = laps ? std::sqrt(sumSq / laps) : 0.0;
+    return r;
+}
+
+void testLapTimes()
+{
+    const Truth truth(kLaps);
+    std::printf("  %d laps of %.0f m; lap time errors, ms\n", kLaps, kLength);
+    std::printf("  %6s %8s %8s %10s %10s %10s\n", "rate", "jitter", "noise", "crossings", "max lap", "RMS lap");
+    for (double rateHz : { 5.0, 10.0, 20.0, 50.0 }) {
+        for (double jitter : { 0.0, 0.3 }) {
+            for (double noise : { 0.0, 0.5 }) {
+                const Result r = runLaps(truth, rateHz, jitter, noise, static_cast<unsigned>(rateHz * 10 + jitter * 10 + noise * 10));
+                std::printf("  %3.0f Hz %7.0f%% %6.1f m %10zu %10.3f %10.3f\n", rateHz, jitter * 100.0, noise,
+                    r.crossings, r.maxLapErrorUs * 1e-3, r.lapErrorRmsUs * 1e-3);
+
+                CHECK(r.crossings == truth.crossings.size());
+                if (noise == 0.0) {
+                    // Rounding to microseconds is all that is left
+                    CHECK(r.maxCrossingErrorUs <= 1.0);
+                    CHECK(r.maxLapErrorUs <= 2.0);
+                } else {
+                    // 0.5 m along the track at 40 m/s is 12.5 ms per crossing
+                    CHECK(r.maxCrossingErrorUs < 60'000.0);
+                    CHECK(r.maxLapErrorUs < 80'000.0);
+                    CHECK(r.lapErrorRmsUs < 30'000.0);
+                }
+            }
+        }
+    }
+}
+
+void testCreepingAndReversing()
+{
+    const LapTimer::Line line = startFinish();
+    std::mt19937 rng(5);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+
+    // Rolling over the line at walking pace in 1 m of noise: the fixes
+    // cross it back and forth many times, one crossing counts
+    LapTimer creeping;
+    size_t crossings = 0, lineCrossings = 0;
+    double lastX = -20.0;
+    for (int k = 0; k <= 400; ++k) {
+        LapTimer::Fix fix;
+        fix.timeUs = k * 100'000;
+        fix.x = -20.0 + 0.1 * k + gauss(rng);
+        fix.y = -kRadius + gauss(rng);
+        lineCrossings += (lastX < 0.0) != (fix.x < 0.0) ? 1 : 0;
+        lastX = fix.x;
+        crossings += creeping.OnFix(fix, line).crossed ? 1 : 0;
+    }
+    CHECK(lineCrossings > 3);
+    CHECK(crossings == 1);
+
+    // Over the line, back behind it, over again: one crossing, its time the
+    // first passage
+    LapTimer reversing;
+    const double xs[] = { -3.0, 1.0, 3.0, -2.0, -4.0, 2.0, 5.0, 8.0 };
+    std::vector<LapTimer::Crossing> seen;
+    for (int k = 0; k < 8; ++k) {
+        LapTimer::Fix fix;
+        fix.timeUs = 1'000'000 + k * 1'000'000;
+        fix.x = xs[k];
+        fix.y = -kRadius;
+        const LapTimer::Crossing c = reversing.OnFix(fix, line);
+        if (c.crossed)
+            seen.push_back(c);
+    }
+    CHECK(seen.size() == 1);
+    if (seen.size() == 1) {
+        CHECK(seen[0].first);
+        CHECK(seen[0].timeUs == 1'750'000);      // -3 -> 1 meets x = 0 three quarters in
+        CHECK(seen[0].lapUs == 750'000);         // Since the first fix
+    }
+
+    // A second forward passage within MIN_LAP_US is the same one
+    LapTimer twice;
+    const double xs2[] = { -4.0, 4.0, 5.0, 7.0 };
+    size_t counted = 0;
+    for (int k = 0; k < 4; ++k) {
+        LapTimer::Fix fix;
+        fix.timeUs = k * 200'000;
+        fix.x = xs2[k];
+        fix.y = -kRadius;
+        fix.progress = k < 2 ? 0.99 : 0.01 * k;  // Progress wraps a fix late
+        fix.progressWrap = true;
+        counted += twice.OnFix(fix, line).crossed ? 1 : 0;
+    }
+    CHECK(counted == 1);
+}
+
+void testLineVariants()
+{
+    // No direction on the line: the first crossing defines forward, and
+    // going back over it the other way is a reversal, not a lap
+    LapTimer::Line line = startFinish();
+    line.forward = glm::dvec2(0.0);
+    LapTimer timer;
+    std::vector<LapTimer::Crossing> seen;
+    const double xs[] = { 4.0, -4.0, -10.0, 4.0, 10.0 };    // Westwards first
+    for (int k = 0; k < 5; ++k) {
+        LapTimer::Fix fix;
+        fix.timeUs = k * 3'000'000;
+        fix.x = xs[k];
+        fix.y = -kRadius;
+        const LapTimer::Crossing c = timer.OnFix(fix, line);
+        if (c.crossed)
+            seen.push_back(c);
+    }
+    CHECK(seen.size() == 1 && seen[0].timeUs == 1'500'000);
+
+    // Low-rate GNSS on a line the fixes never straddle: the progress wrap
+    // places the crossing between the fixes by their progress
+    LapTimer::Line away = startFinish();
+    away.p1 = { 0.0, 500.0 };
+    away.p2 = { 0.0, 510.0 };
+    LapTimer wrap;
+    LapTimer::Fix a;
+    a.timeUs = 10'000'000;
+    a.progress = 0.95;
+    a.progressWrap = true;
+    LapTimer::Fix b = a;
+    b.timeUs = 11'000'000;
+    b.progress = 0.05;
+    b.x = 1.0;
+    wrap.OnFix(a, away);
+    const LapTimer::Crossing c = wrap.OnFix(b, away);
+    CHECK(c.crossed && c.first && c.timeUs == 10'500'000 && c.lapUs == 500'000);
+    CHECK(wrap.LapStartUs() == 10'500'000);
+    CHECK(wrap.ElapsedUs(12'000'000) == 1'500'000);
+    CHECK(wrap.ElapsedUs(10'000'000) == 0);
+
+    // A fix older than the last one is dropped, not paired backwards
+    LapTimer::Fix old = a;
+    old.timeUs = 10'200'000;
+    CHECK(!wrap.OnFix(old, away).crossed);
+    LapTimer::Fix later = b;
+    later.timeUs = 11'500'000;
+    later.progress = 0.10;
+    CHECK(!wrap.OnFix(later, away).crossed);
+
+    wrap.Reset();
+    CHECK(!wrap.HasFix() && wrap.ElapsedUs(12'000'000) == 0);
+}
+
+} // namespace
+
+int main()
+{
+    testLapTimes();
+    testCreepingAndReversing();
+    testLineVariants();
+    return Test::Result("LapTimerTest");
+}
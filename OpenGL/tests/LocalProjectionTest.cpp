@@ -0,0 +1,142 @@
+// LocalProjection against GeographicLib: over a grid of points covering the
+// fitted radius, the polynomial must land within kMaxErrorMeters of
+// UTMUPS::Forward in the origin's zone, at circuits spread over both
+// hemispheres, high latitudes and zone edges. Outside the radius, and for
+// origins the fit refuses, every point must go through the exact fallback.
+
+#include "src/track/LocalProjection.h"
+#include "TestSupport.h"
+
+#include <GeographicLib/UTMUPS.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr double kMetersPerDegree = 111320.0;
+
+struct Site {
+    const char* name;
+    double lat, lon;
+};
+
+MapOrigin makeOrigin(double lat, double lon)
+{
+    MapOrigin origin{};
+    origin.m_origin_lat_dd = lat;
+    origin.m_origin_lon_dd = lon;
+    bool northp = false;
+    GeographicLib::UTMUPS::Forward(lat, lon, origin.m_origin_zone_int, northp,
+        origin.m_origin_meters_easting, origin.m_origin_meters_northing);
+    origin.m_origin_zone_char = northp ? 'N' : 'M';
+    return origin;
+}
+
+void exact(const MapOrigin& origin, double lat, double lon, double& easting, double& northing)
+{
+    int zone = 0;
+    bool northp = false;
+    GeographicLib::UTMUPS::Forward(lat, lon, zone, northp, easting, northing, origin.m_origin_zone_int);
+}
+
+void testSite(const Site& site, double radiusMeters)
+{
+    const MapOrigin origin = makeOrigin(site.lat, site.lon);
+    const LocalProjection projection(origin, radiusMeters);
+    CHECK(projection.IsValid());
+    if (!projection.IsValid()) {
+        std::printf("  %s: fit rejected\n", site.name);
+        return;
+    }
+    CHECK(projection.MaxFitErrorMeters() <= LocalProjection::kMaxErrorMeters);
+
+    // 41 x 41 grid over the square around the radius (corners outside it)
+    constexpr int kSteps = 40;
+    const double halfLat = radiusMeters / kMetersPerDegree;
+    const double halfLon = halfLat / std::cos(site.lat * 3.14159265358979323846 / 180.0);
+    std::vector<double> lat, lon;
+    for (int i = 0; i <= kSteps; ++i) {
+        for (int j = 0; j <= kSteps; ++j) {
+            lat.push_back(site.lat + halfLat * (2.0 * i / kSteps - 1.0));
+            lon.push_back(site.lon + halfLon * (2.0 * j / kSteps - 1.0));
+        }
+    }
+
+    const size_t n = lat.size();
+    std::vector<double> east(n), north(n);
+    const size_t fallbacks = projection.ToMetersBatch(lat.data(), lon.data(), n, east.data(), north.data());
+
+    double worst = 0.0;
+    size_t contained = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double e = 0.0, nn = 0.0;
+        exact(origin, lat[i], lon[i], e, nn);
+        const double err = std::hypot(east[i] - e, north[i] - nn);
+        if (projection.Contains(lat[i], lon[i])) {
+            ++contained;
+            worst = std::max(worst, err);
+        } else {
+            CHECK(err == 0.0);   // Fallback is GeographicLib itself
+        }
+
+        // One point at a time gives the same answer as the batch
+        double e1 = 0.0, n1 = 0.0;
+        CHECK(projection.ToMeters(lat[i], lon[i], e1, n1));
+        CHECK(e1 == east[i] && n1 == north[i]);
+    }
+
+    std::printf("  %-12s r=%5.0f m  worst %.3f mm over %zu points, %zu fallbacks\n",
+        site.name, radiusMeters, worst * 1e3, contained, fallbacks);
+    CHECK(worst <= LocalProjection::kMaxErrorMeters);
+    CHECK(contained + fallbacks == n);
+
+    // The whole radius is fitted, not just the origin's neighbourhood
+    CHECK(projection.Contains(site.lat + halfLat * 0.99, site.lon));
+    CHECK(projection.Contains(site.lat, site.lon - halfLon * 0.99));
+}
+
+void testRejectedOrigins()
+{
+    // Box would cross the equator / reach past UTM's latitude limit / has no zone
+    const LocalProjection equator(makeOrigin(0.01, 10.0), 5000.0);
+    CHECK(!equator.IsValid());
+    const LocalProjection polar(makeOrigin(83.99, 15.0), 5000.0);
+    CHECK(!polar.IsValid());
+    MapOrigin noZone = makeOrigin(55.75, 37.62);
+    noZone.m_origin_zone_int = 0;
+    const LocalProjection unzoned(noZone, 5000.0);
+    CHECK(!unzoned.IsValid());
+
+    // Still converts, exactly like coordinatesToMeters
+    const MapOrigin origin = makeOrigin(0.01, 10.0);
+    double e = 0.0, n = 0.0, refE = 0.0, refN = 0.0;
+    CHECK(equator.ToMeters(0.012, 10.003, e, n));
+    exact(origin, 0.012, 10.003, refE, refN);
+    CHECK(e == refE && n == refN);
+
+    const LocalProjection invalid;
+    CHECK(!invalid.IsValid());
+    CHECK(invalid.ToMeters(48.0, 11.0, e, n));
+}
+
+} // namespace
+
+int main()
+{
+    const Site sites[] = {
+        { "Moscow",      55.7500,  37.6200 },
+        { "Cape Town",  -33.9000,  18.4000 },
+        { "Reykjavik",   64.1000, -21.9000 },
+        { "Monaco",      43.7350,   7.4200 },
+        { "Zone edge",   50.0000,  11.9900 },   // Straddles the 32/33 boundary
+        { "Svalbard",    78.2000,  15.6000 },
+        { "Kuala Lumpur", 2.7600, 101.7400 },
+    };
+    for (const Site& site : sites) {
+        for (double radius : { 2000.0, 10000.0 })
+            testSite(site, radius);
+    }
+    testRejectedOrigins();
+    return Test::Result("LocalProjectionTest");
+}
@@ -0,0 +1,215 @@
+// PlayoutDelay replaying arrival traces: a clean 20 Hz LAN feed, a jittery
+// Wi-Fi one with bursts of loss, a 10 Hz LoRa kart losing a packet in eight,
+// and a link that turns bad halfway. For each it reports underruns and the
+// latency the delay adds, next to the old fixed 33 ms, and checks that the
+// adaptive delay keeps underruns near its target, stays low on a clean
+// link, and moves smoothly when the link changes.
+//
+//   PlayoutDelayTest [trace]
+//
+// A recorded trace (one "timestamp arrival" pair per line, seconds) is
+// replayed and reported as well.
+
+#include "src/vehicle/PlayoutDelay.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <vector>
+
+using Arrival = PlayoutDelay::Arrival;
+
+namespace {
+
+constexpr double kFrameRate = 60.0;
+constexpr double kOldFixedDelay = 0.033;
+
+struct Link {
+    double rateHz;
+    double baseTransit;     // Seconds
+    double jitter;          // Mean of the exponential extra transit, seconds
+    double loss;            // Chance a packet is lost
+    double burst;           // Chance a loss is followed by another
+};
+
+std::vector<Arrival> makeTrace(const Link& first, const Link& second, double seconds, unsigned seed)
+{
+    std::vector<Arrival> trace;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    bool lostLast = false;
+    double t = 0.0;
+    while (t < seconds) {
+        const Link& link = t < seconds / 2 ? first : second;
+        const bool lost = unit(rng) < (lostLast ? link.burst : link.loss);
+        lostLast = lost;
+        if (!lost) {
+            const double extra = link.jitter > 0.0 ? -link.jitter * std::log(1.0 - unit(rng)) : 0.0;
+            trace.push_back({ t, t + link.baseTransit + extra });
+        }
+        t += 1.0 / link.rateHz;
+    }
+    // Packets are handed over in arrival order
+    std::stable_sort(trace.begin(), trace.end(),
+        [](const Arrival& a, const Arrival& b) { return a.arrivalTime < b.arrivalTime; });
+    return trace;
+}
+
+// ReplayTrace with the delay pinned, as VehicleInterpolator used to run.
+PlayoutDelay::ReplayResult replayFixed(const std::vector<Arrival>& trace, double delay)
+{
+    PlayoutDelay::ReplayResult result;
+    size_t next = 0, buffered = 0;
+    double newest = 0.0;
+    const double start = trace.front().arrivalTime;
+    for (uint64_t frame = 0; ; ++frame) {
+        const double t = start + frame / kFrameRate;
+        if (t > trace.back().arrivalTime)
+            break;
+        for (; next < trace.size() && trace[next].arrivalTime <= t; ++next) {
+            if (buffered > 0 && trace[next].timestamp <= newest)
+                continue;
+            newest = trace[next].timestamp;
+            ++buffered;
+        }
+        if (buffered < 2)
+            continue;
+        ++result.frames;
+        result.underruns += (t - delay > newest) ? 1 : 0;
+    }
+    result.meanDelay = result.maxDelay = delay;
+    return result;
+}
+
+double underrunPct(const PlayoutDelay::ReplayResult& r)
+{
+    return r.frames ? 100.0 * static_cast<double>(r.underruns) / static_cast<double>(r.frames) : 0.0;
+}
+
+void report(const char* name, const std::vector<Arrival>& trace, const PlayoutDelay::ReplayResult& adaptive)
+{
+    const PlayoutDelay::ReplayResult fixed = replayFixed(trace, kOldFixedDelay);
+    std::printf("  %-14s %6zu pkts | fixed 33 ms: %6.2f%% underruns | adaptive: %6.2f%% underruns, "
+        "delay mean %5.1f ms, max %5.1f ms\n", name, trace.size(), underrunPct(fixed), underrunPct(adaptive),
+        adaptive.meanDelay * 1e3, adaptive.maxDelay * 1e3);
+}
+
+// Drives one PlayoutDelay by hand and returns the largest change of the
+// delay between two frames once it has settled.
+double largestStep(const std::vector<Arrival>& trace)
+{
+    PlayoutDelay playout;
+    size_t next = 0, arrivals = 0;
+    double last = -1.0, largest = 0.0;
+    const double start = trace.front().arrivalTime;
+    for (uint64_t frame = 0; ; ++frame) {
+        const double t = start + frame / kFrameRate;
+        if (t > trace.back().arrivalTime)
+            break;
+        for (; next < trace.size() && trace[next].arrivalTime <= t; ++next, ++arrivals)
+            playout.OnArrival(trace[next].timestamp, trace[next].arrivalTime);
+        const double delay = playout.Advance(t);
+        if (arrivals > 20 && last >= 0.0)
+            largest = std::max(largest, std::abs(delay - last));
+        last = delay;
+    }
+    return largest;
+}
+
+void testTraces()
+{
+    const Link lan   = { 20.0, 0.002, 0.0015, 0.0,  0.0 };
+    const Link wifi  = { 20.0, 0.004, 0.0080, 0.02, 0.3 };
+    const Link lora  = { 10.0, 0.030, 0.0150, 0.12, 0.2 };
+
+    const std::vector<Arrival> lanTrace = makeTrace(lan, lan, 120.0, 1);
+    const std::vector<Arrival> wifiTrace = makeTrace(wifi, wifi, 120.0, 2);
+    const std::vector<Arrival> loraTrace = makeTrace(lora, lora, 120.0, 3);
+    const std::vector<Arrival> stepTrace = makeTrace(lan, wifi, 120.0, 4);
+
+    const PlayoutDelay::ReplayResult lanResult = PlayoutDelay::ReplayTrace(lanTrace.data(), lanTrace.size(), kFrameRate);
+    const PlayoutDelay::ReplayResult wifiResult = PlayoutDelay::ReplayTrace(wifiTrace.data(), wifiTrace.size(), kFrameRate);
+    const PlayoutDelay::ReplayResult loraResult = PlayoutDelay::ReplayTrace(loraTrace.data(), loraTrace.size(), kFrameRate);
+    const PlayoutDelay::ReplayResult stepResult = PlayoutDelay::ReplayTrace(stepTrace.data(), stepTrace.size(), kFrameRate);
+    report("LAN 20 Hz", lanTrace, lanResult);
+    report("Wi-Fi 20 Hz", wifiTrace, wifiResult);
+    report("LoRa 10 Hz", loraTrace, loraResult);
+    report("LAN -> Wi-Fi", stepTrace, stepResult);
+
+    // Underruns stay near the target wherever the link is
+    for (const PlayoutDelay::ReplayResult* r : { &lanResult, &wifiResult, &loraResult, &stepResult }) {
+        CHECK(r->frames > 0);
+        CHECK(underrunPct(*r) < 3.0);
+        CHECK(r->maxDelay <= PlayoutDelay::MAX_DELAY);
+    }
+
+    // A clean link pays one send interval plus its jitter, no more
+    CHECK(lanResult.meanDelay < 0.050 + 0.015);
+    // A lossy 10 Hz link needs more than the old fixed delay, and gets it
+    CHECK(loraResult.meanDelay > 2 * kOldFixedDelay);
+    CHECK(underrunPct(replayFixed(loraTrace, kOldFixedDelay)) > 10.0 * std::max(underrunPct(loraResult), 0.5));
+
+    // The link turning bad is absorbed by time-warping, not jumps: the delay
+    // moves by at most a tenth of a second per second of playout
+    const double step = largestStep(stepTrace);
+    CHECK(step <= 0.10 / kFrameRate + 1e-12);
+
+    // Same trace, same result
+    const PlayoutDelay::ReplayResult again = PlayoutDelay::ReplayTrace(wifiTrace.data(), wifiTrace.size(), kFrameRate);
+    CHECK(again.frames == wifiResult.frames && again.underruns == wifiResult.underruns);
+    CHECK(again.meanDelay == wifiResult.meanDelay && again.maxDelay == wifiResult.maxDelay);
+}
+
+void testStats()
+{
+    // 10 Hz with every fourth packet lost: interval 100 ms, loss 25 %
+    PlayoutDelay playout;
+    for (int i = 0; i < 400; ++i) {
+        if (i % 4 == 3)
+            continue;
+        playout.OnArrival(i * 0.1, i * 0.1 + 0.02);
+    }
+    const PlayoutDelay::Stats s = playout.GetStats();
+    CHECK_NEAR(s.interval, 0.1, 1e-9);
+    CHECK_NEAR(s.loss, 0.25, 0.01);
+    CHECK_NEAR(s.jitter, 0.0, 1e-9);
+    CHECK_NEAR(s.target, 0.2 + 0.02 + PlayoutDelay::MARGIN, 1e-9);   // Bridges one lost packet
+
+    playout.ResetArrivals();
+    CHECK(playout.GetStats().target == PlayoutDelay::INITIAL_DELAY);
+    CHECK(playout.Advance(0.0) == PlayoutDelay::INITIAL_DELAY);
+    playout.OnRendered(true);
+    CHECK(playout.GetStats().frames == 1 && playout.GetStats().underruns == 1);
+    playout.ResetClock();
+    CHECK(playout.GetStats().frames == 0 && playout.GetStats().delay == PlayoutDelay::INITIAL_DELAY);
+
+    CHECK(PlayoutDelay::ReplayTrace(nullptr, 0, kFrameRate).frames == 0);
+}
+
+void replayFile(const char* path)
+{
+    std::vector<Arrival> trace;
+    std::ifstream in(path);
+    Arrival a{};
+    while (in >> a.timestamp >> a.arrivalTime)
+        trace.push_back(a);
+    if (trace.size() < 2) {
+        std::printf("  %s: no trace\n", path);
+        return;
+    }
+    std::stable_sort(trace.begin(), trace.end(),
+        [](const Arrival& x, const Arrival& y) { return x.arrivalTime < y.arrivalTime; });
+    report(path, trace, PlayoutDelay::ReplayTrace(trace.data(), trace.size(), kFrameRate));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    testTraces();
+    testStats();
+    for (int i = 1; i < argc; ++i)
+        replayFile(argv[i]);
+    return Test::Result("PlayoutDelayTest");
+}
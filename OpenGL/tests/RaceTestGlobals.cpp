@@ -0,0 +1,21 @@
+// Stand-ins for what the racing units take from the rest of the application,
+// so RaceManager links without Vehicle.cpp (UI, ImGui), Input.cpp (GLFW) or
+// Render.cpp (GL): the vehicle table, the map flag, the track cache and a
+// Vehicle left at its member defaults (the real one converts the map origin).
+
+#include "src/vehicle/Vehicle.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+std::map<int32_t, Vehicle> g_vehicles;
+std::mutex g_vehicles_mutex;
+std::atomic<bool> g_is_map_loaded{ true };
+
+Vehicle::Vehicle() {}
+
+namespace TrackRenderer
+{
+    void clearTrackCache() {}
+}
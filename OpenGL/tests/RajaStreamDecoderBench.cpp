@@ -0,0 +1,118 @@
+// Stream decoding throughput: RajaStreamDecoder against the 4-byte window
+// the COM reader used to shift once per byte, on a clean gateway stream and
+// on one that is mostly line noise. Both run from memory, so this is the
+// scan alone; the old reader also paid one readBytes() call per byte.
+
+#include "src/network/RajaStreamDecoder.h"
+#include "RajaTestFrames.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr uint8_t kMagicLE[4] = { 0x41, 0x4A, 0x41, 0x52 };
+
+// The old loop: shift the window, on a magic take the next payload bytes.
+size_t windowScan(const std::vector<uint8_t>& bytes)
+{
+    size_t ok = 0;
+    uint8_t window[4] = { 0, 0, 0, 0 };
+    int windowCount = 0;
+    size_t pos = 0;
+    while (pos < bytes.size()) {
+        window[0] = window[1];
+        window[1] = window[2];
+        window[2] = window[3];
+        window[3] = bytes[pos++];
+        if (windowCount < 4) {
+            windowCount++;
+            continue;
+        }
+        if (window[0] == kMagicLE[0] && window[1] == kMagicLE[1] && window[2] == kMagicLE[2] && window[3] == kMagicLE[3]) {
+            if (bytes.size() - pos < rajagp::kRajaPayloadAfterMagic)
+                break;
+            uint8_t payload[rajagp::kRajaPayloadAfterMagic];
+            std::memcpy(payload, &bytes[pos], sizeof(payload));
+            pos += sizeof(payload);
+            rajagp::TelemetryPacket packet{};
+            if (rajagp::parseRajaPayload(payload, packet))
+                ++ok;
+        }
+    }
+    return ok;
+}
+
+// The new loop: reads of `chunk` bytes, Next() until dry after each.
+size_t decoderScan(RajaStreamDecoder& decoder, const std::vector<uint8_t>& bytes, size_t chunk)
+{
+    size_t ok = 0;
+    rajagp::TelemetryPacket packet{};
+    size_t pos = 0;
+    while (pos < bytes.size()) {
+        size_t space = 0;
+        uint8_t* dst = decoder.WriteSpace(space);
+        const size_t n = std::min({ space, chunk, bytes.size() - pos });
+        std::memcpy(dst, &bytes[pos], n);
+        decoder.Commit(n);
+        pos += n;
+        while (decoder.Next(packet))
+            ++ok;
+    }
+    return ok;
+}
+
+std::vector<uint8_t> makeStream(size_t frames, size_t noisePerFrame)
+{
+    // The port never opens on a frame boundary (and the window cannot match
+    // before it has four bytes in it)
+    std::vector<uint8_t> bytes(1, 0x00);
+    std::mt19937 rng(11);
+    for (uint32_t n = 0; n < frames; ++n) {
+        if (noisePerFrame)
+            RajaTestFrames::AppendNoise(bytes, noisePerFrame, rng);
+        RajaTestFrames::Append(bytes, RajaTestFrames::CarFrame(1 + static_cast<int32_t>(n % 40), n));
+    }
+    return bytes;
+}
+
+} // namespace
+
+int main()
+{
+    struct Case {
+        const char* name;
+        size_t noisePerFrame;
+    };
+    const Case cases[] = {
+        { "clean", 0 },
+        { "noise 4:1", 150 },
+        { "noise 30:1", 1100 },
+    };
+    constexpr int kRepeats = 20;
+
+    std::printf("%-12s %10s %14s %14s %10s\n", "stream", "frames", "window MB/s", "decoder MB/s", "speed-up");
+    for (const Case& c : cases) {
+        const std::vector<uint8_t> bytes = makeStream(20000, c.noisePerFrame);
+        const double mb = static_cast<double>(bytes.size()) / 1e6;
+
+        size_t windowOk = 0, decoderOk = 0;
+        const double windowUs = Test::MicrosPerCall(kRepeats, [&](size_t) {
+            windowOk = windowScan(bytes);
+        });
+        RajaStreamDecoder decoder;
+        const double decoderUs = Test::MicrosPerCall(kRepeats, [&](size_t) {
+            decoder.Reset();
+            decoderOk = decoderScan(decoder, bytes, 4096);
+        });
+        Test::Consume(static_cast<double>(windowOk + decoderOk));
+
+        std::printf("%-12s %10zu %14.0f %14.0f %9.1fx\n", c.name, decoderOk,
+            mb / (windowUs * 1e-6), mb / (decoderUs * 1e-6), windowUs / decoderUs);
+        if (windowOk != decoderOk)
+            std::printf("  frame counts differ: window %zu, decoder %zu\n", windowOk, decoderOk);
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+// RajaStreamDecoder on synthetic serial streams: every valid frame comes out
+// once and in order whatever surrounds it (line noise full of partial
+// magics, corrupted frames, false magics overlapping a real frame) and
+// however the bytes are chunked by the reads.
+
+#include "src/network/RajaStreamDecoder.h"
+#include "RajaTestFrames.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <vector>
+
+using RajaTestFrames::Frame;
+
+namespace {
+
+struct Stream {
+    std::vector<uint8_t> bytes;
+    std::vector<Frame> expected;    // Valid frames, in order
+    size_t corrupted = 0;
+};
+
+// Frames with noise, flipped bytes, truncations and false magics in between.
+Stream makeStream(size_t frames, unsigned seed)
+{
+    Stream s;
+    std::mt19937 rng(seed);
+    for (uint32_t n = 0; n < frames; ++n) {
+        const Frame frame = RajaTestFrames::CarFrame(1 + static_cast<int32_t>(n % 7), n);
+        switch (rng() % 8) {
+        case 0:
+            RajaTestFrames::AppendNoise(s.bytes, 1 + rng() % 120, rng);
+            break;
+        case 1: {
+            // One payload byte flipped: fails its check, the next frame survives
+            const size_t at = s.bytes.size();
+            RajaTestFrames::Append(s.bytes, frame);
+            s.bytes[at + 4 + rng() % (RajaTestFrames::kFrameSize - 4)] ^= 0x10;
+            ++s.corrupted;
+            continue;
+        }
+        case 2: {
+            // Cut short by a dropout: the next frame starts inside its payload.
+            // At least the checksum goes, or a cut byte that happens to equal
+            // the next frame's first one leaves a valid frame behind.
+            RajaTestFrames::Append(s.bytes, frame);
+            s.bytes.resize(s.bytes.size() - (4 + rng() % 20));
+            ++s.corrupted;
+            continue;
+        }
+        case 3:
+            // "AJAR" in noise whose would-be payload runs into this frame
+            RajaTestFrames::AppendFalseMagic(s.bytes, rng() % 30);
+            break;
+        default:
+            break;
+        }
+        RajaTestFrames::Append(s.bytes, frame);
+        s.expected.push_back(frame);
+    }
+    return s;
+}
+
+// Runs the stream through `decoder` in reads of 1..maxChunk bytes, the way
+// the COM reader does (WriteSpace / Commit, then Next until dry).
+std::vector<rajagp::TelemetryPacket> decode(RajaStreamDecoder& decoder, const std::vector<uint8_t>& bytes,
+                                            size_t maxChunk, std::mt19937& rng)
+{
+    std::vector<rajagp::TelemetryPacket> out;
+    rajagp::TelemetryPacket packet{};
+    size_t pos = 0;
+    while (pos < bytes.size()) {
+        size_t space = 0;
+        uint8_t* dst = decoder.WriteSpace(space);
+        const size_t n = std::min({ space, bytes.size() - pos, 1 + rng() % maxChunk });
+        std::copy(bytes.begin() + pos, bytes.begin() + pos + n, dst);
+        decoder.Commit(n);
+        pos += n;
+        while (decoder.Next(packet))
+            out.push_back(packet);
+    }
+    return out;
+}
+
+bool matches(const std::vector<Frame>& expected, const std::vector<rajagp::TelemetryPacket>& got)
+{
+    if (expected.size() != got.size())
+        return false;
+    for (size_t i = 0; i < expected.size(); ++i)
+        if (!RajaTestFrames::Same(expected[i], got[i]))
+            return false;
+    return true;
+}
+
+void testCleanStream()
+{
+    std::vector<uint8_t> bytes;
+    std::vector<Frame> expected;
+    for (uint32_t n = 0; n < 500; ++n) {
+        expected.push_back(RajaTestFrames::CarFrame(3, n));
+        RajaTestFrames::Append(bytes, expected.back());
+    }
+
+    RajaStreamDecoder decoder;
+    std::mt19937 rng(1);
+    CHECK(matches(expected, decode(decoder, bytes, 4096, rng)));
+    const RajaStreamDecoder::Counters& c = decoder.GetCounters();
+    CHECK(c.bytes == bytes.size());
+    CHECK(c.ok == 500 && c.bad == 0 && c.headers == 500);
+    CHECK(c.nonmatch == 0);
+    CHECK(decoder.Buffered() == 0);
+}
+
+void testNoisyStream(size_t maxChunk, size_t capacity)
+{
+    const Stream s = makeStream(3000, static_cast<unsigned>(maxChunk * 131 + capacity));
+    RajaStreamDecoder decoder(capacity);
+    std::mt19937 rng(static_cast<unsigned>(maxChunk));
+    const std::vector<rajagp::TelemetryPacket> got = decode(decoder, s.bytes, maxChunk, rng);
+
+    const bool ok = matches(s.expected, got);
+    if (!ok)
+        std::printf("  chunks <= %zu, capacity %zu: %zu of %zu frames\n", maxChunk, capacity, got.size(), s.expected.size());
+    CHECK(ok);
+
+    const RajaStreamDecoder::Counters& c = decoder.GetCounters();
+    CHECK(c.ok == s.expected.size());
+    CHECK(c.bytes == s.bytes.size());
+    CHECK(c.bad >= s.corrupted / 2);    // Truncated frames often end before a check
+    CHECK(decoder.Buffered() < RajaStreamDecoder::kFrameSize);
+}
+
+void testFeedAndReset()
+{
+    const Stream s = makeStream(200, 99);
+    RajaStreamDecoder decoder(RajaStreamDecoder::kFrameSize);   // Clamped up to a few frames
+    std::vector<rajagp::TelemetryPacket> got;
+    rajagp::TelemetryPacket packet{};
+
+    // Feed() takes what fits; the rest goes in once Next() made room
+    size_t pos = 0;
+    while (pos < s.bytes.size()) {
+        const size_t taken = decoder.Feed(s.bytes.data() + pos, s.bytes.size() - pos);
+        pos += taken;
+        while (decoder.Next(packet))
+            got.push_back(packet);
+        CHECK(taken > 0 || decoder.Buffered() < RajaStreamDecoder::kFrameSize);
+        if (taken == 0 && decoder.Buffered() >= RajaStreamDecoder::kFrameSize)
+            break;
+    }
+    CHECK(matches(s.expected, got));
+
+    decoder.Reset();
+    CHECK(decoder.Buffered() == 0);
+    CHECK(decoder.GetCounters().bytes == 0 && decoder.GetCounters().ok == 0);
+}
+
+void testFrameSplitAtEveryByte()
+{
+    // One frame after noise, split at every possible offset
+    std::mt19937 rng(5);
+    std::vector<uint8_t> bytes;
+    RajaTestFrames::AppendNoise(bytes, 13, rng);
+    const Frame frame = RajaTestFrames::CarFrame(9, 42);
+    RajaTestFrames::Append(bytes, frame);
+
+    for (size_t split = 0; split <= bytes.size(); ++split) {
+        RajaStreamDecoder decoder;
+        rajagp::TelemetryPacket packet{};
+        decoder.Feed(bytes.data(), split);
+        int decoded = 0;
+        while (decoder.Next(packet))
+            ++decoded;
+        decoder.Feed(bytes.data() + split, bytes.size() - split);
+        while (decoder.Next(packet)) {
+            ++decoded;
+            CHECK(RajaTestFrames::Same(frame, packet));
+        }
+        CHECK(decoded == 1);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testCleanStream();
+    for (size_t maxChunk : { 1u, 7u, 64u, 1024u })
+        testNoisyStream(maxChunk, 4096);
+    testNoisyStream(300, 256);
+    testFeedAndReset();
+    testFrameSplitAtEveryByte();
+    return Test::Result("RajaStreamDecoderTest");
+}
@@ -0,0 +1,115 @@
+#include "RajaTestFrames.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kMagicLE[4] = { 0x41, 0x4A, 0x41, 0x52 };
+constexpr size_t kChecksumAt = rajagp::kRajaPayloadAfterMagic - 4;
+
+// FNV-1a: 32 bits, so junk after a false or cut-off magic never checks out
+// by chance over the few thousand tries a test makes.
+uint32_t checksum(const uint8_t* payload)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < kChecksumAt; ++i)
+        hash = (hash ^ payload[i]) * 16777619u;
+    return hash;
+}
+
+void put32(uint8_t* at, uint32_t value)
+{
+    std::memcpy(at, &value, sizeof(value));
+}
+
+uint32_t get32(const uint8_t* at)
+{
+    uint32_t value = 0;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+// The stand-in for rajagp_core's parser (see RajaTestFrames.h).
+namespace rajagp {
+
+bool parseRajaPayload(const uint8_t* payload, TelemetryPacket& out)
+{
+    if (checksum(payload) != get32(payload + kChecksumAt))
+        return false;
+    out = TelemetryPacket{};
+    out.MagicMarker = PacketMagic::DATA;
+    out.ID    = static_cast<decltype(out.ID)>(get32(payload + 0));
+    out.time  = static_cast<decltype(out.time)>(get32(payload + 4));
+    out.lat   = static_cast<decltype(out.lat)>(get32(payload + 8));
+    out.lon   = static_cast<decltype(out.lon)>(get32(payload + 12));
+    out.speed = static_cast<decltype(out.speed)>(get32(payload + 16));
+    return true;
+}
+
+} // namespace rajagp
+
+namespace RajaTestFrames {
+
+void Append(std::vector<uint8_t>& stream, const Frame& frame)
+{
+    uint8_t payload[rajagp::kRajaPayloadAfterMagic] = {};
+    put32(payload + 0, static_cast<uint32_t>(frame.id));
+    put32(payload + 4, frame.time);
+    put32(payload + 8, static_cast<uint32_t>(frame.lat));
+    put32(payload + 12, static_cast<uint32_t>(frame.lon));
+    put32(payload + 16, static_cast<uint32_t>(frame.speed));
+    for (size_t i = 20; i < kChecksumAt; ++i)
+        payload[i] = static_cast<uint8_t>(frame.time * 31u + i);
+    put32(payload + kChecksumAt, checksum(payload));
+
+    stream.insert(stream.end(), kMagicLE, kMagicLE + 4);
+    stream.insert(stream.end(), payload, payload + sizeof(payload));
+}
+
+void AppendNoise(std::vector<uint8_t>& stream, size_t bytes, std::mt19937& rng)
+{
+    const size_t end = stream.size() + bytes;
+    while (stream.size() < end) {
+        const uint32_t r = rng();
+        if (r % 5 == 0) {
+            // Partial magic, one to three bytes of it
+            const size_t len = 1 + (r >> 8) % 3;
+            for (size_t i = 0; i < len && stream.size() < end; ++i)
+                stream.push_back(kMagicLE[i]);
+        } else {
+            stream.push_back(static_cast<uint8_t>(r >> 16));
+        }
+        // Never complete a magic by accident
+        const size_t n = stream.size();
+        if (n >= 4 && std::memcmp(&stream[n - 4], kMagicLE, 4) == 0)
+            stream.back() = 0x00;
+    }
+}
+
+void AppendFalseMagic(std::vector<uint8_t>& stream, size_t bytes)
+{
+    stream.insert(stream.end(), kMagicLE, kMagicLE + 4);
+    for (size_t i = 0; i < bytes; ++i)
+        stream.push_back(static_cast<uint8_t>(0xE0 + i % 16));
+}
+
+Frame CarFrame(int32_t id, uint32_t n)
+{
+    Frame frame;
+    frame.id = id;
+    frame.time = 1000u + n * 100u;
+    frame.lat = 557500000 + static_cast<int32_t>(n) * 17 + id;
+    frame.lon = 376200000 - static_cast<int32_t>(n) * 11;
+    frame.speed = 8000 + static_cast<int32_t>(n % 50) * 10;
+    return frame;
+}
+
+bool Same(const Frame& frame, const rajagp::TelemetryPacket& packet)
+{
+    return packet.ID == frame.id && packet.time == frame.time &&
+        packet.lat == frame.lat && packet.lon == frame.lon && packet.speed == frame.speed;
+}
+
+} // namespace RajaTestFrames
@@ -0,0 +1,51 @@
+#pragma once
+
+// ============================================================================
+// RajaTestFrames — synthetic RAJA frames for the serial-side tests.
+//
+// The decoder and the gateway merge only rely on rajagp::parseRajaPayload to
+// say whether 33 bytes after a magic are a valid frame. The tests link this
+// stand-in instead of rajagp_core's parser: its payload is the fields below
+// plus a 32-bit checksum, so a test can build, corrupt and recognise frames
+// without the radio's wire format.
+//
+//   0  int32 ID      4  uint32 time     8  int32 lat     12 int32 lon
+//   16 int32 speed   20 filler          29 checksum of bytes 0-28
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <rajagp/RajaParser.h>
+
+namespace RajaTestFrames {
+
+constexpr size_t kFrameSize = 4 + rajagp::kRajaPayloadAfterMagic;
+
+struct Frame {
+    int32_t id = 0;
+    uint32_t time = 0;
+    int32_t lat = 0;
+    int32_t lon = 0;
+    int32_t speed = 0;
+};
+
+// Magic + payload, checksum included.
+void Append(std::vector<uint8_t>& stream, const Frame& frame);
+
+// Line noise that is rich in partial magics ("A", "AJ", "AJA"), never a
+// whole one.
+void AppendNoise(std::vector<uint8_t>& stream, size_t bytes, std::mt19937& rng);
+
+// A whole magic followed by `bytes` of junk that cannot check out: a false
+// frame that overlaps whatever is appended after it.
+void AppendFalseMagic(std::vector<uint8_t>& stream, size_t bytes);
+
+// Car `id`'s frame number `n` (distinct time and position per n).
+Frame CarFrame(int32_t id, uint32_t n);
+
+bool Same(const Frame& frame, const rajagp::TelemetryPacket& packet);
+
+} // namespace RajaTestFrames
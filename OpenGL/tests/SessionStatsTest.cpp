@@ -0,0 +1,296 @@
+// SessionStats against a brute-force recount: a session of 20 cars and 40
+// laps each, three sectors, two speed traps and mini-sectors, some sectors
+// untimed. After every completed lap, every number the panels read must
+// match a recount over all laps so far. That covers the bests and their
+// holders, the theoretical best, the rolling mean and deviation, and the
+// purple/green/yellow marks. Revisions must move only for the vehicle that
+// completed the lap. Then: timing lines republished mid-session, laps
+// without a time, Reset, a reader thread on Current() while laps are
+// published, and the cost of a lap early and late in the session.
+
+#include "src/racing/SessionStats.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+using SessionStats::Mark;
+
+namespace {
+
+constexpr int kCars = 20;
+constexpr int kLaps = 40;
+constexpr int kSectors = 3;
+
+struct Lap {
+    int32_t car;
+    int number;
+    TimingRecord::Splits splits;
+};
+
+// Sector times around 30 s, each car with its own pace; one sector in
+// twenty untimed (a boundary missed)
+std::vector<Lap> session(unsigned seed, uint64_t linesVersion = 1)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<Lap> laps;
+    for (int n = 1; n <= kLaps; ++n) {
+        for (int32_t car = 0; car < kCars; ++car) {
+            Lap lap{ car * 7 + 3, n, TimingRecord::Splits{} };
+            TimingRecord::Splits& s = lap.splits;
+            s.sectorCount = kSectors;
+            s.linesVersion = linesVersion;
+            s.lapUs = 0;
+            for (int k = 0; k < kSectors; ++k) {
+                const int64_t us = std::llround((30.0 + 0.05 * car + 0.4 * gauss(rng)) * 1e6);
+                s.lapUs += us;
+                s.sectorUs[k] = unit(rng) < 0.05 ? -1 : us;
+            }
+            for (int t = 0; t < 2; ++t)
+                s.trapKph[t] = static_cast<float>(180.0 + 40.0 * t - 0.2 * car + 3.0 * gauss(rng));
+            for (int m = 0; m < TimingRecord::MINI_SECTORS; ++m)
+                s.miniSectors[m] = static_cast<float>(s.lapUs / 1e6 / TimingRecord::MINI_SECTORS + 0.05 * gauss(rng));
+            laps.push_back(lap);
+        }
+    }
+    return laps;
+}
+
+Mark markOf(int64_t us, int64_t personalBest, int64_t sessionBest)
+{
+    return us < 0 ? Mark::None : us <= sessionBest ? Mark::Purple : us <= personalBest ? Mark::Green : Mark::Yellow;
+}
+
+// Everything the table should say after `done`, recounted from scratch
+void checkAgainstRecount(const SessionStats::Table& table, const std::vector<Lap>& done, bool& ok)
+{
+    const Lap& latest = done.back();
+    std::map<int32_t, std::vector<const Lap*>> byCar;
+    for (const Lap& lap : done)
+        byCar[lap.car].push_back(&lap);
+
+    int64_t sessionLap = -1, sessionSector[kSectors] = { -1, -1, -1 };
+    float sessionTrap[2] = { -1.0f, -1.0f }, sessionMini[TimingRecord::MINI_SECTORS];
+    std::fill(std::begin(sessionMini), std::end(sessionMini), -1.0f);
+    for (const Lap& lap : done) {
+        if (sessionLap < 0 || lap.splits.lapUs < sessionLap)
+            sessionLap = lap.splits.lapUs;
+        for (int k = 0; k < kSectors; ++k)
+            if (lap.splits.sectorUs[k] >= 0 && (sessionSector[k] < 0 || lap.splits.sectorUs[k] < sessionSector[k]))
+                sessionSector[k] = lap.splits.sectorUs[k];
+        for (int t = 0; t < 2; ++t)
+            sessionTrap[t] = std::max(sessionTrap[t], lap.splits.trapKph[t]);
+        for (int m = 0; m < TimingRecord::MINI_SECTORS; ++m)
+            if (sessionMini[m] < 0.0f || lap.splits.miniSectors[m] < sessionMini[m])
+                sessionMini[m] = lap.splits.miniSectors[m];
+    }
+
+    ok = ok && table.bestLapUs == sessionLap && table.sectorCount == kSectors;
+    ok = ok && table.Find(table.bestLapHolder) && table.Find(table.bestLapHolder)->bestLapUs == sessionLap;
+    for (int k = 0; k < kSectors; ++k) {
+        ok = ok && table.bestSectorUs[k] == sessionSector[k];
+        ok = ok && table.Find(table.bestSectorHolder[k]) &&
+            table.Find(table.bestSectorHolder[k])->bestSectorUs[k] == sessionSector[k];
+    }
+    for (int t = 0; t < 2; ++t)
+        ok = ok && table.bestTrapKph[t] == sessionTrap[t] && table.Find(table.bestTrapHolder[t]) &&
+            table.Find(table.bestTrapHolder[t])->bestTrapKph[t] == sessionTrap[t];
+    ok = ok && std::equal(std::begin(sessionMini), std::end(sessionMini), std::begin(table.bestMiniSectors));
+
+    // The car that just completed its lap
+    const std::vector<const Lap*>& laps = byCar[latest.car];
+    const SessionStats::VehicleStats* stats = table.Find(latest.car);
+    if (!stats) {
+        ok = false;
+        return;
+    }
+    const Lap* best = laps[0];
+    int64_t bestSector[kSectors] = { -1, -1, -1 };
+    for (const Lap* lap : laps) {
+        if (lap->splits.lapUs < best->splits.lapUs)
+            best = lap;
+        for (int k = 0; k < kSectors; ++k)
+            if (lap->splits.sectorUs[k] >= 0 && (bestSector[k] < 0 || lap->splits.sectorUs[k] < bestSector[k]))
+                bestSector[k] = lap->splits.sectorUs[k];
+    }
+    int64_t theoretical = 0;
+    for (int k = 0; k < kSectors; ++k)
+        theoretical = (theoretical < 0 || bestSector[k] < 0) ? -1 : theoretical + bestSector[k];
+
+    ok = ok && stats->revision == table.version && stats->completedLaps == static_cast<int>(laps.size());
+    ok = ok && stats->lastLapNumber == latest.number && stats->lastLapUs == latest.splits.lapUs;
+    ok = ok && stats->bestLapUs == best->splits.lapUs && stats->bestLapNumber == best->number;
+    ok = ok && std::equal(std::begin(best->splits.miniSectors), std::end(best->splits.miniSectors),
+        std::begin(stats->bestLapMiniSectors));
+    ok = ok && stats->theoreticalBestUs == theoretical;
+    ok = ok && stats->lastLapMark == markOf(latest.splits.lapUs, best->splits.lapUs, sessionLap);
+    for (int k = 0; k < kSectors; ++k) {
+        ok = ok && stats->bestSectorUs[k] == bestSector[k] && stats->lastSectorUs[k] == latest.splits.sectorUs[k];
+        ok = ok && stats->lastSectorMark[k] == markOf(latest.splits.sectorUs[k], bestSector[k], sessionSector[k]);
+    }
+
+    // Rolling stats over the last ROLLING_LAPS laps, sample deviation
+    const size_t n = std::min(laps.size(), static_cast<size_t>(SessionStats::ROLLING_LAPS));
+    double mean = 0.0, squares = 0.0;
+    for (size_t i = laps.size() - n; i < laps.size(); ++i)
+        mean += laps[i]->splits.lapUs / 1e6 / n;
+    for (size_t i = laps.size() - n; i < laps.size(); ++i)
+        squares += (laps[i]->splits.lapUs / 1e6 - mean) * (laps[i]->splits.lapUs / 1e6 - mean);
+    const double deviation = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+    ok = ok && stats->rollingCount == static_cast<int>(n);
+    ok = ok && std::abs(stats->rollingMeanS - mean) < 1e-9 && std::abs(stats->rollingStdDevS - deviation) < 1e-9;
+}
+
+void testAgainstRecount()
+{
+    SessionStats::Reset();
+    const std::vector<Lap> laps = session(1);
+    std::vector<Lap> done;
+    std::map<int32_t, uint64_t> revisions;
+    bool ok = true, othersUntouched = true;
+    Mark seen[4] = {};
+    for (const Lap& lap : laps) {
+        const uint64_t before = SessionStats::Current()->version;
+        SessionStats::OnLapCompleted(lap.car, lap.number, lap.splits);
+        done.push_back(lap);
+
+        const SessionStats::TablePtr table = SessionStats::Current();
+        CHECK(table->version == before + 1);
+        checkAgainstRecount(*table, done, ok);
+        for (const auto& [id, stats] : table->vehicles)
+            othersUntouched = othersUntouched && (id == lap.car || stats.revision == revisions[id]);
+        revisions[lap.car] = table->version;
+        const Mark mark = table->Find(lap.car)->lastLapMark;
+        seen[static_cast<int>(mark)] = mark;
+    }
+    CHECK(ok);
+    CHECK(othersUntouched);
+    CHECK(seen[1] == Mark::Purple && seen[2] == Mark::Green && seen[3] == Mark::Yellow);
+    CHECK(SessionStats::Current()->vehicles.size() == static_cast<size_t>(kCars));
+}
+
+void testLinesAndEdges()
+{
+    SessionStats::Reset();
+    CHECK(!SessionStats::Current()->Find(3) && SessionStats::Current()->bestLapUs == -1);
+
+    // No lap time: nothing published
+    const uint64_t version = SessionStats::Current()->version;
+    SessionStats::OnLapCompleted(3, 1, TimingRecord::Splits{});
+    CHECK(SessionStats::Current()->version == version && !SessionStats::Current()->Find(3));
+
+    const std::vector<Lap> laps = session(2, 4);
+    for (int i = 0; i < kCars * 3; ++i)
+        SessionStats::OnLapCompleted(laps[i].car, laps[i].number, laps[i].splits);
+    const SessionStats::TablePtr onOld = SessionStats::Current();
+    CHECK(onOld->linesVersion == 4 && onOld->bestSectorUs[0] > 0 && onOld->Find(3)->theoreticalBestUs > 0);
+
+    // A lap still timed on older lines: its time counts, its sectors do not
+    TimingRecord::Splits stale = laps[0].splits;
+    stale.linesVersion = 3;
+    stale.lapUs = onOld->bestLapUs - 1;
+    stale.sectorUs[0] = 1;
+    SessionStats::OnLapCompleted(10, 9, stale);
+    const SessionStats::TablePtr afterStale = SessionStats::Current();
+    CHECK(afterStale->bestLapUs == stale.lapUs && afterStale->bestLapHolder == 10);
+    CHECK(afterStale->bestSectorUs[0] == onOld->bestSectorUs[0] && afterStale->linesVersion == 4);
+    CHECK(afterStale->Find(10)->lastSectorMark[0] == Mark::None && afterStale->Find(10)->lastTrapKph[0] < 0.0f);
+
+    // New lines: every line-based best starts over, lap bests stay
+    TimingRecord::Splits fresh = laps[kCars * 3].splits;
+    fresh.linesVersion = 5;
+    fresh.sectorCount = 2;
+    SessionStats::OnLapCompleted(17, 4, fresh);
+    const SessionStats::TablePtr onNew = SessionStats::Current();
+    CHECK(onNew->linesVersion == 5 && onNew->sectorCount == 2);
+    CHECK(onNew->bestSectorUs[0] == fresh.sectorUs[0] && onNew->bestSectorHolder[0] == 17);
+    CHECK(onNew->bestSectorUs[2] == -1 && onNew->bestTrapKph[0] == fresh.trapKph[0]);
+    CHECK(onNew->bestLapUs == stale.lapUs);
+    CHECK(onNew->Find(3)->bestSectorUs[0] == -1 && onNew->Find(3)->theoreticalBestUs == -1);
+    CHECK(onNew->Find(3)->bestLapUs == onOld->Find(3)->bestLapUs);
+    CHECK(onNew->Find(3)->revision == onOld->Find(3)->revision);
+
+    // The snapshots readers hold are not touched by later publishes
+    CHECK(onOld->linesVersion == 4 && onOld->bestSectorUs[0] > 0);
+
+    SessionStats::Reset();
+    CHECK(SessionStats::Current()->vehicles.empty() && SessionStats::Current()->version > onNew->version);
+}
+
+void testCost()
+{
+    const std::vector<Lap> laps = session(3);
+    for (const Lap& lap : laps)        // Warm up
+        SessionStats::OnLapCompleted(lap.car, lap.number, lap.splits);
+    SessionStats::Reset();
+
+    // Per lap, at the start and at the end of the session: no scan over
+    // earlier laps, so only the vehicle count matters
+    const size_t quarter = laps.size() / 4;
+    const double earlyUs = Test::MicrosPerCall(quarter, [&](size_t i) {
+        SessionStats::OnLapCompleted(laps[i].car, laps[i].number, laps[i].splits);
+    });
+    for (size_t i = quarter; i < laps.size() - quarter; ++i)
+        SessionStats::OnLapCompleted(laps[i].car, laps[i].number, laps[i].splits);
+    const double lateUs = Test::MicrosPerCall(quarter, [&](size_t i) {
+        const Lap& lap = laps[laps.size() - quarter + i];
+        SessionStats::OnLapCompleted(lap.car, lap.number, lap.splits);
+    });
+    std::printf("  %d cars: %.2f us per lap in the first %d laps, %.2f us in the last %d\n", kCars, earlyUs, kLaps / 4,
+        lateUs, kLaps / 4);
+    CHECK(SessionStats::Current()->Find(3)->completedLaps == kLaps);
+}
+
+void testReader()
+{
+    SessionStats::Reset();
+    const std::vector<Lap> laps = session(4);
+
+    // A panel thread reading while the ingest thread publishes: every table
+    // it sees is whole (session best is the best of the vehicles' bests) and
+    // versions never go back
+    std::atomic<bool> done{ false };
+    std::atomic<size_t> reads{ 0 };
+    bool consistent = true;
+    std::thread reader([&] {
+        uint64_t last = 0;
+        while (!done.load()) {
+            const SessionStats::TablePtr table = SessionStats::Current();
+            int64_t best = -1;
+            for (const auto& [id, stats] : table->vehicles)
+                if (best < 0 || stats.bestLapUs < best)
+                    best = stats.bestLapUs;
+            consistent = consistent && table->bestLapUs == best && table->version >= last;
+            last = table->version;
+            ++reads;
+        }
+    });
+    while (reads.load() == 0)
+        std::this_thread::yield();
+
+    for (const Lap& lap : laps)
+        SessionStats::OnLapCompleted(lap.car, lap.number, lap.splits);
+    const size_t readsWhilePublishing = reads.load();
+    done = true;
+    reader.join();
+
+    std::printf("  %zu tables read while %zu laps were published\n", readsWhilePublishing, laps.size());
+    CHECK(consistent);
+}
+
+} // namespace
+
+int main()
+{
+    testAgainstRecount();
+    testLinesAndEdges();
+    testCost();
+    testReader();
+    return Test::Result("SessionStatsTest");
+}
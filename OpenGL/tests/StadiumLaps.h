@@ -0,0 +1,103 @@
+#pragma once
+
+// ============================================================================
+// StadiumLaps — laps of a 651 m stadium track and their ground truth, for the
+// LapTimer and TimingRecord tests.
+//
+// Two 200 m straights joined by 40 m half circles, centred on the origin,
+// driven anticlockwise from the west end of the bottom straight. The bottom
+// straight is taken at 40 m/s throughout, so crossings there are exact;
+// the car slows to 28 m/s through the far side of the lap. The arc length is
+// integrated every millisecond.
+// ============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace StadiumLaps {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kStraight = 200.0;            // m
+constexpr double kRadius = 40.0;
+constexpr double kLength = 2.0 * kStraight + 2.0 * kPi * kRadius;
+constexpr double kLineArc = 100.0;             // S/F in the middle of the bottom straight
+constexpr double kStep = 0.001;                // Truth resolution, s
+
+inline double SpeedAt(double s)
+{
+    const double lapS = std::fmod(s, kLength);
+    if (lapS < kStraight)
+        return 40.0;
+    const double a = std::sin(kPi * (lapS - kStraight) / (kLength - kStraight));
+    return 40.0 - 12.0 * a * a;
+}
+
+inline glm::dvec2 Centre(double s)
+{
+    s = std::fmod(s, kLength);
+    const double half = kStraight / 2.0;
+    if (s < kStraight)
+        return { -half + s, -kRadius };
+    s -= kStraight;
+    if (s < kPi * kRadius) {
+        const double a = -kPi / 2.0 + s / kRadius;
+        return { half + kRadius * std::cos(a), kRadius * std::sin(a) };
+    }
+    s -= kPi * kRadius;
+    if (s < kStraight)
+        return { half - s, kRadius };
+    s -= kStraight;
+    const double a = kPi / 2.0 + s / kRadius;
+    return { -half + kRadius * std::cos(a), kRadius * std::sin(a) };
+}
+
+// Direction of travel at `s`
+inline glm::dvec2 Tangent(double s)
+{
+    return glm::normalize(Centre(s + 0.01) - Centre(s - 0.01));
+}
+
+// Progress from the start/finish line, 0..1
+inline double ProgressAt(double s)
+{
+    return std::fmod(s - kLineArc + kLength, kLength) / kLength;
+}
+
+struct Truth {
+    std::vector<double> arc;                   // Every kStep from a standing start at arc 0
+    std::vector<double> crossings;             // Seconds the car passes the line
+
+    explicit Truth(int laps)
+    {
+        double s = 0.0;
+        while (s < laps * kLength + kLineArc + 50.0) {
+            arc.push_back(s);
+            s += SpeedAt(s + 0.5 * kStep * SpeedAt(s)) * kStep;
+        }
+        for (int lap = 0; lap <= laps; ++lap)
+            crossings.push_back(TimeAt(kLineArc + lap * kLength));
+    }
+
+    double Seconds() const { return static_cast<double>(arc.size() - 2) * kStep; }
+
+    double ArcAt(double t) const
+    {
+        const double i = std::clamp(t / kStep, 0.0, static_cast<double>(arc.size() - 2));
+        const size_t k = static_cast<size_t>(i);
+        return arc[k] + (arc[k + 1] - arc[k]) * (i - static_cast<double>(k));
+    }
+
+    // When the car reaches arc `s`; linear within a step, exact at constant speed
+    double TimeAt(double s) const
+    {
+        const size_t k = static_cast<size_t>(std::upper_bound(arc.begin(), arc.end(), s) - arc.begin());
+        if (k == 0 || k == arc.size())
+            return -1.0;
+        return (static_cast<double>(k - 1) + (s - arc[k - 1]) / (arc[k] - arc[k - 1])) * kStep;
+    }
+};
+
+} // namespace StadiumLaps
@@ -0,0 +1,183 @@
+// Per-frame standings cost at 20, 100 and 500 cars, each with 30 laps
+// stored, driving round a 400-point track at about a lap a minute at 60 fps.
+// A frame costs Update(), PublishSnapshot() and one GetStandings() (the lap
+// timer overlay).
+//
+// "before" replays what each of those calls used to do: rebuild every row
+// (re-sum every stored lap, and compute both gaps through TimeDiff, the
+// leader gap searching all cars again for the leader), then sort from
+// scratch, three times a frame. "after" is RaceManager as it is. Every frame
+// also checks the published standings against the live vehicles. Rows must
+// be in order and hold the current lap count and total. Progress may lag by
+// at most one 1/1000-lap bucket.
+
+#include "src/racing/RaceManager.h"
+#include "src/racing/RaceSnapshot.h"
+#include "src/racing/TimeDiffirence/TimeDiff.h"
+#include "src/track/TrackGeometry.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int kFrames = 600;
+constexpr int kStoredLaps = 30;
+
+void publishTrack()
+{
+    std::vector<SplinePoint> points(400);
+    for (size_t i = 0; i < points.size(); ++i) {
+        const double a = 2.0 * 3.14159265358979323846 * i / points.size();
+        points[i].position = glm::vec2(10.0 * std::cos(a), 6.0 * std::sin(a));
+    }
+    TrackGeometry::PublishPoints(points);
+}
+
+void fillGrid(int cars)
+{
+    std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+    g_vehicles.clear();
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int32_t id = 0; id < cars; ++id) {
+        Vehicle& v = g_vehicles[id];
+        v.m_has_started_first_lap = true;
+        v.m_completed_laps = kStoredLaps;
+        v.m_current_lap_number = kStoredLaps + 1;
+        for (int lap = 1; lap <= kStoredLaps; ++lap)
+            v.m_laps[lap] = LapData(static_cast<float>(60.0 + 10.0 * unit(rng)), 0);
+
+        // A best lap with samples, for the delta to it
+        CarLapSessions best;
+        best.lapnumber = 1;
+        for (int k = 0; k < 600; ++k) {
+            LapInfo sample{};
+            sample.progress = k / 600.0;
+            sample.timefromstart = k / 10.0f;
+            best.samples.Append(sample);
+        }
+        v.laps[1] = std::move(best);
+        v.bestlapID = 1;
+        v.m_best_lap_time = 60.0f;
+        v.m_track_progress = unit(rng);
+        v.m_total_progress = v.m_completed_laps + v.m_track_progress;
+        v.m_speed_kph = static_cast<float>(150.0 + 50.0 * unit(rng));
+    }
+}
+
+// One frame of driving: 0.9 to 1.1 laps a minute
+void drive()
+{
+    std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+    for (auto& [id, v] : g_vehicles) {
+        v.m_track_progress += (0.9 + 0.2 * ((id * 7919) % 100) / 100.0) / 3600.0;
+        if (v.m_track_progress >= 1.0) {
+            v.m_track_progress -= 1.0;
+            v.m_completed_laps++;
+            v.m_current_lap_number++;
+            v.m_laps[v.m_completed_laps] = LapData(61.0f, 0);
+        }
+        v.m_total_progress = v.m_completed_laps + v.m_track_progress;
+        v.m_current_lap_timer += 1.0f / 60.0f;
+    }
+}
+
+// The standings the way every call built them before
+std::vector<VehicleStanding> fullRebuild()
+{
+    std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+    std::vector<VehicleStanding> standings;
+    for (const auto& [id, v] : g_vehicles) {
+        VehicleStanding s;
+        s.vehicleID = id;
+        s.completedLaps = v.m_completed_laps;
+        s.currentLapNumber = v.m_current_lap_number;
+        s.currentLapTime = v.m_current_lap_timer;
+        s.hasStartedFirstLap = v.m_has_started_first_lap;
+        s.distanceFromStart = v.m_track_progress;
+        s.bestLapTime = v.m_best_lap_time;
+        for (const auto& [lap, data] : v.m_laps)
+            s.totalRaceTime += data.lapTime;
+        s.deltaTimeToBest = CalculateLapTimeDiffInternal(id);
+        s.deltaTimeToLeader = CalculateLeaderTimeDiffInternal(id);
+        standings.push_back(s);
+    }
+    std::sort(standings.begin(), standings.end(), [](const VehicleStanding& a, const VehicleStanding& b) {
+        if (a.hasStartedFirstLap != b.hasStartedFirstLap)
+            return a.hasStartedFirstLap > b.hasStartedFirstLap;
+        if (a.completedLaps != b.completedLaps)
+            return a.completedLaps > b.completedLaps;
+        return a.distanceFromStart > b.distanceFromStart;
+    });
+    for (size_t i = 0; i < standings.size(); ++i) {
+        standings[i].position = static_cast<int>(i + 1);
+        standings[i].isLapped = standings[i].completedLaps < standings[0].completedLaps;
+    }
+    return standings;
+}
+
+// Rows of the published standings that do not match the live vehicles
+size_t staleRows()
+{
+    const std::vector<VehicleStanding>& standings = RaceSnapshot::Current().standings;
+    std::lock_guard<std::mutex> lock(g_vehicles_mutex);
+    size_t stale = standings.size() == g_vehicles.size() ? 0 : 1;
+    for (size_t i = 0; i < standings.size(); ++i) {
+        const VehicleStanding& s = standings[i];
+        const Vehicle& v = g_vehicles.at(s.vehicleID);
+        float total = 0.0f;
+        for (const auto& [lap, data] : v.m_laps)
+            total += data.lapTime;
+        const bool current = s.completedLaps == v.m_completed_laps && std::abs(s.totalRaceTime - total) < 1e-3f &&
+            std::abs(s.distanceFromStart - v.m_track_progress) <= 1.0 / 1000.0 + 1e-9;
+        const bool ordered = i == 0 || standings[i - 1].completedLaps > s.completedLaps ||
+            (standings[i - 1].completedLaps == s.completedLaps &&
+             standings[i - 1].distanceFromStart >= s.distanceFromStart);
+        stale += (current && ordered) ? 0 : 1;
+    }
+    return stale;
+}
+
+} // namespace
+
+int main()
+{
+    publishTrack();
+    RaceManager race;
+    g_race_manager = &race;
+    race.SetStartFinishLine({ 9.0f, 0.0f }, { 11.0f, 0.0f });
+    race.StartSession();
+
+    std::printf("%6s %14s %14s %8s %12s\n", "cars", "before us", "after us", "ratio", "stale rows");
+    for (int cars : { 20, 100, 500 }) {
+        fillGrid(cars);
+        double beforeUs = 0.0;
+        for (int frame = 0; frame < kFrames; ++frame) {
+            drive();
+            beforeUs += Test::MicrosPerCall(3, [](size_t) { Test::Consume(static_cast<double>(fullRebuild().size())); });
+        }
+        beforeUs = beforeUs * 3.0 / kFrames;
+
+        fillGrid(cars);
+        size_t stale = 0;
+        double afterUs = 0.0;
+        for (int frame = 0; frame < kFrames; ++frame) {
+            drive();
+            afterUs += Test::MicrosPerCall(1, [&](size_t) {
+                race.Update();
+                race.PublishSnapshot();
+                Test::Consume(static_cast<double>(race.GetStandings().size()));
+            });
+            stale += staleRows();
+        }
+        afterUs /= kFrames;
+        std::printf("%6d %14.1f %14.1f %7.1fx %12zu\n", cars, beforeUs, afterUs, beforeUs / afterUs, stale);
+    }
+    g_race_manager = nullptr;
+    return 0;
+}
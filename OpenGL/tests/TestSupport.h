@@ -0,0 +1,76 @@
+#pragma once
+
+// ============================================================================
+// TestSupport — the few checks the console tests need, no framework.
+//
+// A failed CHECK prints where and what and the test carries on, so one run
+// reports every broken case; main() returns Test::Result() and CTest reads
+// the exit code. Benchmarks time with MicrosPerCall and print their own
+// tables.
+// ============================================================================
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+namespace Test {
+
+inline int& Failures()
+{
+    static int s_failures = 0;
+    return s_failures;
+}
+
+inline void Fail(const char* file, int line, const char* what)
+{
+    std::printf("  FAILED %s:%d: %s\n", file, line, what);
+    ++Failures();
+}
+
+inline void FailNear(const char* file, int line, const char* what, double actual, double expected, double tolerance)
+{
+    std::printf("  FAILED %s:%d: %s = %.9g, expected %.9g +- %.3g\n", file, line, what, actual, expected, tolerance);
+    ++Failures();
+}
+
+inline int Result(const char* name)
+{
+    if (Failures() == 0) {
+        std::printf("[PASS] %s\n", name);
+        return 0;
+    }
+    std::printf("[FAIL] %s: %d check(s) failed\n", name, Failures());
+    return 1;
+}
+
+// Keeps a benchmark's result alive so the optimiser cannot drop the work.
+inline void Consume(double value)
+{
+    static volatile double s_sink = 0.0;
+    s_sink = s_sink + value;
+}
+
+// Wall-clock microseconds per call, `fn(i)` called for i in [0, iterations).
+template <typename Fn>
+double MicrosPerCall(size_t iterations, Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        fn(i);
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return iterations ? elapsed.count() / static_cast<double>(iterations) : 0.0;
+}
+
+} // namespace Test
+
+#define CHECK(cond) \
+    do { if (!(cond)) Test::Fail(__FILE__, __LINE__, #cond); } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        const double actual_ = static_cast<double>(actual); \
+        const double expected_ = static_cast<double>(expected); \
+        if (!(std::abs(actual_ - expected_) <= (tolerance))) \
+            Test::FailNear(__FILE__, __LINE__, #actual, actual_, expected_, (tolerance)); \
+    } while (0)
@@ -0,0 +1,358 @@
+// TimingRecord on synthetic laps of the stadium track (StadiumLaps.h), fed
+// the way RaceManager does: start/finish first, then the timing lines, every
+// fix. Three sectors, with one boundary on the top straight and one in the
+// last bend, and a speed trap on the top straight where the car is braking.
+// Fixes come at 5 to 50 Hz with 30 % jitter on their timestamps, exact or
+// with 0.5 m of GNSS noise. Every sector, trap speed and mini-sector must
+// match the ground truth. The three sectors must add up to the lap exactly,
+// and no lap may go untimed. Then the bookkeeping: timing lines republished
+// mid-lap, an origin publish, the pit lane, a track with no sector lines,
+// Stop and out-of-order fixes.
+
+#include "src/racing/TimingRecord.h"
+#include "src/track/TrackGeometry.h"
+#include "StadiumLaps.h"
+#include "TestSupport.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace StadiumLaps;
+using Kind = TrackGeometry::TimingLine::Kind;
+
+constexpr int kLaps = 8;
+constexpr double kSector1Arc = 380.0;          // Top straight
+constexpr double kSector2Arc = 600.0;          // Last bend
+constexpr double kTrapArc = 500.0;             // Top straight, slowing down
+constexpr double kPitLaneY = -kRadius - 15.0;  // Alongside the bottom straight
+
+// A line 20 m long across the track at arc `s`
+TrackGeometry::TimingLine lineAt(Kind kind, double s)
+{
+    const glm::dvec2 c = Centre(s), t = Tangent(s), n(-t.y, t.x);
+    TrackGeometry::TimingLine line;
+    line.kind = kind;
+    line.p1 = glm::vec2(c - 10.0 * n);
+    line.p2 = glm::vec2(c + 10.0 * n);
+    line.forward = glm::vec2(t);
+    line.progress = static_cast<float>(ProgressAt(s));
+    return line;
+}
+
+// Across the pit lane at `x`, clear of the track
+TrackGeometry::TimingLine pitLine(Kind kind, double x)
+{
+    TrackGeometry::TimingLine line;
+    line.kind = kind;
+    line.p1 = { static_cast<float>(x), static_cast<float>(kPitLaneY - 3.0) };
+    line.p2 = { static_cast<float>(x), static_cast<float>(kPitLaneY + 3.0) };
+    line.forward = { 1.0f, 0.0f };
+    line.progress = static_cast<float>(ProgressAt(kLineArc + x));
+    return line;
+}
+
+TrackGeometry::Snapshot stadium()
+{
+    TrackGeometry::Snapshot track;
+    track.timingLines = {
+        pitLine(Kind::PitEntry, -30.0),
+        pitLine(Kind::PitExit, 30.0),
+        lineAt(Kind::Sector, kSector1Arc),
+        lineAt(Kind::SpeedTrap, kTrapArc),
+        lineAt(Kind::Sector, kSector2Arc),
+    };
+    std::sort(track.timingLines.begin(), track.timingLines.end(),
+        [](const TrackGeometry::TimingLine& a, const TrackGeometry::TimingLine& b) { return a.progress < b.progress; });
+    track.sectorCount = 3;
+    track.version = 4;
+    track.timingLinesVersion = 3;
+    return track;
+}
+
+LapTimer::Line startFinish()
+{
+    LapTimer::Line line;
+    line.p1 = { 0.0, -kRadius - 10.0 };
+    line.p2 = { 0.0, -kRadius + 10.0 };
+    line.forward = { 1.0, 0.0 };
+    return line;
+}
+
+// One vehicle's timing as RaceManager keeps it
+struct Car {
+    LapTimer startFinish;
+    TimingRecord timing;
+    std::vector<int> closed;
+
+    void OnFix(const LapTimer::Fix& fix, double speedKph, const TrackGeometry::Snapshot& track)
+    {
+        const LapTimer::Crossing c = startFinish.OnFix(fix, ::startFinish());
+        if (c.crossed) {
+            if (c.first) {
+                timing.StartLap(1, c.timeUs);
+            } else {
+                const int lap = timing.LapNumber();
+                if (timing.CloseLap(c.timeUs))
+                    closed.push_back(lap);
+            }
+        }
+        timing.OnFix(fix, speedKph, track);
+    }
+};
+
+LapTimer::Fix fixAt(double s, int64_t timeUs)
+{
+    const glm::dvec2 p = Centre(s);
+    LapTimer::Fix fix;
+    fix.timeUs = timeUs;
+    fix.x = p.x;
+    fix.y = p.y;
+    fix.progress = ProgressAt(s);
+    return fix;
+}
+
+struct Errors {
+    size_t laps = 0;
+    bool allTimed = true;
+    bool sectorsAddUp = true;
+    double sectorMs = 0.0;             // Worst over every lap
+    double trapKph = 0.0;
+    double miniMs = 0.0;
+    double miniSumMs = 0.0;            // The slices against the lap
+};
+
+Errors runLaps(const Truth& truth, double rateHz, double noise, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(-0.5, 0.5);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    const TrackGeometry::Snapshot track = stadium();
+    Car car;
+    for (int k = 0; ; ++k) {
+        const double t = (k + 0.3 * unit(rng)) / rateHz;
+        if (t > truth.Seconds())
+            break;
+        const double s = truth.ArcAt(std::max(t, 0.0));
+        LapTimer::Fix fix = fixAt(s, std::llround(std::max(t, 0.0) * 1e6));
+        // Noise along the track shows in the matched progress too
+        const double along = noise * gauss(rng), across = noise * gauss(rng);
+        const glm::dvec2 tangent = Tangent(s);
+        fix.x += along * tangent.x - across * tangent.y;
+        fix.y += along * tangent.y + across * tangent.x;
+        fix.progress = ProgressAt(s + along);
+        car.OnFix(fix, SpeedAt(s) * 3.6, track);
+    }
+    CHECK(!car.timing.InPit() && car.timing.PitEntryUs() < 0);
+
+    Errors e;
+    e.laps = car.closed.size();
+    for (int lap : car.closed) {
+        const TimingRecord::Splits* splits = car.timing.Lap(lap);
+        const double start = kLineArc + (lap - 1) * kLength;
+        const double boundaries[] = { start, start + kSector1Arc - kLineArc, start + kSector2Arc - kLineArc, start + kLength };
+        e.allTimed = e.allTimed && splits && splits->sectorCount == 3 && splits->linesVersion == 3;
+        if (!splits)
+            continue;
+
+        int64_t sum = 0;
+        for (int i = 0; i < 3; ++i) {
+            const double expected = (truth.TimeAt(boundaries[i + 1]) - truth.TimeAt(boundaries[i])) * 1e3;
+            e.allTimed = e.allTimed && splits->sectorUs[i] >= 0;
+            e.sectorMs = std::max(e.sectorMs, std::abs(splits->sectorUs[i] * 1e-3 - expected));
+            sum += splits->sectorUs[i];
+        }
+        e.sectorsAddUp = e.sectorsAddUp && sum == splits->lapUs;
+
+        e.allTimed = e.allTimed && splits->trapKph[0] >= 0.0f && splits->trapKph[1] < 0.0f;
+        e.trapKph = std::max(e.trapKph, std::abs(splits->trapKph[0] - SpeedAt(kTrapArc) * 3.6));
+
+        double miniSum = 0.0;
+        for (int i = 0; i < TimingRecord::MINI_SECTORS; ++i) {
+            const double from = start + kLength * i / TimingRecord::MINI_SECTORS;
+            const double to = start + kLength * (i + 1) / TimingRecord::MINI_SECTORS;
+            const double expected = (truth.TimeAt(to) - truth.TimeAt(from)) * 1e3;
+            e.allTimed = e.allTimed && splits->miniSectors[i] >= 0.0f;
+            e.miniMs = std::max(e.miniMs, std::abs(splits->miniSectors[i] * 1e3 - expected));
+            miniSum += splits->miniSectors[i];
+        }
+        e.miniSumMs = std::max(e.miniSumMs, std::abs(miniSum * 1e3 - splits->lapUs * 1e-3));
+    }
+    return e;
+}
+
+void testSectorsAndTraps()
+{
+    const Truth truth(kLaps);
+    std::printf("  %d laps, 3 sectors, 30 %% timestamp jitter; worst errors\n", kLaps);
+    std::printf("  %6s %8s %6s %10s %10s %10s %12s\n", "rate", "noise", "laps", "sector ms", "trap kph", "mini ms",
+        "mini sum ms");
+    for (double rateHz : { 5.0, 10.0, 20.0, 50.0 }) {
+        for (double noise : { 0.0, 0.5 }) {
+            const Errors e = runLaps(truth, rateHz, noise, static_cast<unsigned>(rateHz * 10 + noise * 10));
+            std::printf("  %3.0f Hz %6.1f m %6zu %10.3f %10.3f %10.3f %12.3f\n", rateHz, noise, e.laps, e.sectorMs,
+                e.trapKph, e.miniMs, e.miniSumMs);
+
+            CHECK(e.laps == static_cast<size_t>(kLaps));
+            CHECK(e.allTimed);
+            CHECK(e.sectorsAddUp);
+            // Seconds in floats: 48 roundings of a few microseconds
+            CHECK(e.miniSumMs < 0.1);
+            if (noise == 0.0) {
+                // Only the curvature of the path between two fixes is left
+                CHECK(e.sectorMs < 2.0);
+                CHECK(e.trapKph < 0.2);
+                CHECK(e.miniMs < 2.0);
+            } else {
+                // 0.5 m is 12.5 to 18 ms at these speeds, at each end
+                CHECK(e.sectorMs < 80.0);
+                CHECK(e.trapKph < 0.5);
+                CHECK(e.miniMs < 100.0);            // Both ends from noisy progress
+            }
+        }
+    }
+}
+
+// Fixes along the bottom straight from `fromX` to `toX` at 40 m/s, 10 Hz
+void drive(Car& car, const TrackGeometry::Snapshot& track, int64_t& timeUs, double fromX, double toX, double y)
+{
+    for (double x = fromX; x <= toX; x += 4.0) {
+        LapTimer::Fix fix;
+        fix.timeUs = timeUs;
+        fix.x = x;
+        fix.y = y;
+        fix.progress = ProgressAt(kLineArc + x);
+        car.OnFix(fix, 144.0, track);
+        timeUs += 100'000;
+    }
+}
+
+void testLinesRepublished()
+{
+    const Truth truth(3);
+    TrackGeometry::Snapshot track = stadium();
+    Car car;
+    int64_t nextUs = 0;
+    const auto runTo = [&](double seconds, const TrackGeometry::Snapshot& t) {
+        for (; nextUs * 1e-6 <= seconds; nextUs += 50'000) {
+            const double s = truth.ArcAt(nextUs * 1e-6);
+            car.OnFix(fixAt(s, nextUs), SpeedAt(s) * 3.6, t);
+        }
+    };
+
+    // Into lap 2, past the first boundary
+    runTo(truth.TimeAt(kLength + kSector1Arc + 20.0), track);
+    CHECK(car.timing.InLap() && car.timing.LapNumber() == 2);
+    CHECK(car.timing.BoundaryUs(1) > 0 && car.timing.Current().sectorUs[0] > 0);
+
+    // An origin publish keeps the lines and their version: nothing is lost
+    track.version = 5;
+    runTo(truth.TimeAt(kLength + kSector1Arc + 40.0), track);
+    CHECK(car.timing.BoundaryUs(1) > 0 && car.timing.Current().sectorUs[0] > 0);
+
+    // New lines: the sectors timed so far against the old ones are dropped,
+    // the lap itself goes on
+    const int64_t lapStartUs = car.timing.LapStartUs();
+    track.version = 6;
+    track.timingLinesVersion = 6;
+    runTo(truth.TimeAt(kLength + kSector1Arc + 60.0), track);
+    CHECK(car.timing.InLap() && car.timing.LapNumber() == 2 && car.timing.LapStartUs() == lapStartUs);
+    CHECK(car.timing.BoundaryUs(0) == 0 && car.timing.BoundaryUs(1) == -1);
+    CHECK(car.timing.Current().sectorUs[0] == -1 && car.timing.Current().linesVersion == 6);
+
+    // Closed on the new lines: the first two sectors untimed, the last one
+    // timed from its boundary, the lap itself whole
+    runTo(truth.crossings[2] + 1.0, track);
+    const TimingRecord::Splits* lap = car.timing.Lap(2);
+    CHECK(lap && lap->linesVersion == 6);
+    if (lap) {
+        CHECK(lap->sectorUs[0] == -1 && lap->sectorUs[1] == -1 && lap->sectorUs[2] > 0);
+        CHECK(std::abs(lap->lapUs * 1e-6 - (truth.crossings[2] - truth.crossings[1])) < 1e-3);
+        CHECK(lap->trapKph[0] > 0.0f);                  // Trap still ahead when the lines changed
+    }
+    CHECK(car.timing.LastLap() == lap && car.timing.Lap(1) && !car.timing.Lap(3));
+}
+
+void testPitLane()
+{
+    const TrackGeometry::Snapshot track = stadium();
+    Car car;
+    int64_t timeUs = 0;
+
+    // Down the bottom straight first: no pit lines crossed
+    drive(car, track, timeUs, -90.0, -50.0, -kRadius);
+    CHECK(!car.timing.InPit() && car.timing.PitEntryUs() == -1);
+
+    // Then into the pit lane alongside: entry at x = -30, exit at x = +30,
+    // halfway between fixes 4 m apart
+    drive(car, track, timeUs, -52.0, -32.0, kPitLaneY);
+    const int64_t beforeEntryUs = timeUs - 100'000;
+    drive(car, track, timeUs, -28.0, 28.0, kPitLaneY);
+    CHECK(car.timing.InPit() && car.timing.PitEntryUs() == beforeEntryUs + 50'000 && car.timing.PitExitUs() == -1);
+    const int64_t beforeExitUs = timeUs - 100'000;
+    drive(car, track, timeUs, 32.0, 60.0, kPitLaneY);
+    CHECK(!car.timing.InPit() && car.timing.PitExitUs() == beforeExitUs + 50'000);
+    CHECK(car.timing.PitEntryUs() == beforeEntryUs + 50'000);
+}
+
+void testSingleSector()
+{
+    // No sector lines: start/finish to start/finish is the one sector
+    TrackGeometry::Snapshot track;
+    track.timingLinesVersion = 1;
+    Car car;
+    int64_t timeUs = 0;
+    for (int lap = 0; lap < 3; ++lap) {
+        drive(car, track, timeUs, -40.0, 40.0, -kRadius);
+        timeUs += 3'000'000;        // Round the rest of the lap
+    }
+    CHECK(car.closed.size() == 2);
+    const TimingRecord::Splits* last = car.timing.LastLap();
+    CHECK(last && last->sectorCount == 1 && last->sectorUs[0] == last->lapUs && last->sectorUs[1] == -1);
+    CHECK(last && last->trapKph[0] < 0.0f);
+}
+
+void testStopAndOrder()
+{
+    const TrackGeometry::Snapshot track = stadium();
+    const Truth truth(2);
+
+    // No lap before the first start/finish crossing, none after Stop
+    TimingRecord timing;
+    CHECK(!timing.CloseLap(1'000'000) && !timing.LastLap() && timing.BoundaryUs(0) == -1);
+    for (int64_t us = 0; us * 1e-6 < truth.crossings[0]; us += 100'000)
+        timing.OnFix(fixAt(truth.ArcAt(us * 1e-6), us), 144.0, track);
+    CHECK(!timing.InLap());
+
+    timing.StartLap(1, static_cast<int64_t>(truth.crossings[0] * 1e6));
+    timing.Stop();
+    CHECK(!timing.InLap() && timing.BoundaryUs(0) == -1);
+    for (int64_t us = static_cast<int64_t>(truth.crossings[0] * 1e6); us * 1e-6 < truth.crossings[1]; us += 100'000)
+        timing.OnFix(fixAt(truth.ArcAt(us * 1e-6), us), 144.0, track);
+    CHECK(timing.Current().sectorUs[0] == -1 && timing.Current().trapKph[0] < 0.0f);
+    CHECK(!timing.CloseLap(static_cast<int64_t>(truth.crossings[1] * 1e6)));
+
+    // A fix older than the last one is dropped before any line sees it
+    TimingRecord ordered;
+    ordered.StartLap(1, 0);
+    const double before = truth.TimeAt(kSector1Arc - 10.0), after = truth.TimeAt(kSector1Arc + 10.0);
+    ordered.OnFix(fixAt(truth.ArcAt(after), static_cast<int64_t>(after * 1e6)), 144.0, track);
+    ordered.OnFix(fixAt(truth.ArcAt(before), static_cast<int64_t>(before * 1e6)), 144.0, track);
+    CHECK(ordered.BoundaryUs(1) == -1);
+
+    ordered.Reset();
+    CHECK(!ordered.InLap() && !ordered.LastLap() && ordered.PitEntryUs() == -1);
+}
+
+} // namespace
+
+int main()
+{
+    testSectorsAndTraps();
+    testLinesRepublished();
+    testPitLane();
+    testSingleSector();
+    testStopAndOrder();
+    return Test::Result("TimingRecordTest");
+}
@@ -0,0 +1,104 @@
+// TrackGeometry publishes. A writer loads track after track, each with its
+// own origin, through Publish(origin, points), while a reader takes Current()
+// in a loop the way the ingest thread does: every snapshot it sees must hold
+// the points that belong to its origin. Then the single-field publishes:
+// PublishOrigin keeps the centre line and its timing-lines version (an origin
+// calibration), ClearPoints keeps the origin.
+
+#include "src/track/TrackGeometry.h"
+#include "src/Config.h"
+#include "TestSupport.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Track k: a 20 m square, shifted by k metres east, origin tagged with k
+MapOrigin originOf(int k)
+{
+    MapOrigin origin{};
+    origin.m_origin_lat_dd = 52.0;
+    origin.m_origin_lon_dd = 13.0;
+    origin.m_origin_meters_easting = 390000.0 + k;
+    origin.m_origin_meters_northing = 5762000.0;
+    origin.m_origin_zone_int = 33;
+    origin.m_origin_zone_char = 'U';
+    origin.m_map_size = MapConstants::MAP_SIZE;
+    return origin;
+}
+
+std::vector<SplinePoint> pointsOf(int k)
+{
+    std::vector<SplinePoint> points;
+    for (int i = 0; i < 40; ++i) {
+        const float side = static_cast<float>(i % 10) * 2.0f;
+        SplinePoint point;
+        point.position = glm::vec2(static_cast<float>(k) + (i < 10 ? side : i < 20 ? 20.0f : i < 30 ? 20.0f - side : 0.0f),
+            i < 10 ? 0.0f : i < 20 ? side : i < 30 ? 20.0f : 20.0f - side) / static_cast<float>(MapConstants::MAP_SIZE);
+        points.push_back(point);
+    }
+    return points;
+}
+
+int trackOf(const TrackGeometry::Snapshot& s)
+{
+    return s.HasTrack() ? static_cast<int>(std::lround(s.points[0].position.x * MapConstants::MAP_SIZE)) : -1;
+}
+
+void testPublishTogether()
+{
+    constexpr int kTracks = 50;
+    std::atomic<bool> done{ false };
+    std::atomic<int> seen{ 0 }, mismatched{ 0 };
+    std::thread reader([&] {
+        while (!done.load()) {
+            const TrackGeometry::SnapshotPtr s = TrackGeometry::Current();
+            if (!s->HasTrack())
+                continue;
+            ++seen;
+            const int origin = static_cast<int>(std::lround(s->origin.m_origin_meters_easting - 390000.0));
+            if (origin != trackOf(*s) || !s->projection)
+                ++mismatched;
+        }
+    });
+    for (int k = 0; k < kTracks; ++k)
+        TrackGeometry::Publish(originOf(k), pointsOf(k));
+    done.store(true);
+    reader.join();
+
+    std::printf("  %d tracks published, %d snapshots read, %d with another track's origin\n", kTracks, seen.load(),
+        mismatched.load());
+    CHECK(seen.load() > 0);
+    CHECK(mismatched.load() == 0);
+    const TrackGeometry::SnapshotPtr last = TrackGeometry::Current();
+    CHECK(trackOf(*last) == kTracks - 1 && last->timingLinesVersion == last->version);
+}
+
+void testSingleFields()
+{
+    TrackGeometry::Publish(originOf(3), pointsOf(3));
+    const TrackGeometry::SnapshotPtr loaded = TrackGeometry::Current();
+
+    // Calibration: new origin, same centre line, timing state kept
+    TrackGeometry::PublishOrigin(originOf(5));
+    const TrackGeometry::SnapshotPtr calibrated = TrackGeometry::Current();
+    CHECK(trackOf(*calibrated) == 3);
+    CHECK(calibrated->origin.m_origin_meters_easting == originOf(5).m_origin_meters_easting);
+    CHECK(calibrated->timingLinesVersion == loaded->timingLinesVersion && calibrated->version > loaded->version);
+
+    TrackGeometry::ClearPoints();
+    const TrackGeometry::SnapshotPtr cleared = TrackGeometry::Current();
+    CHECK(!cleared->HasTrack());
+    CHECK(cleared->origin.m_origin_meters_easting == originOf(5).m_origin_meters_easting && cleared->projection);
+}
+
+} // namespace
+
+int main()
+{
+    testPublishTogether();
+    testSingleFields();
+    return Test::Result("TrackGeometryTest");
+}
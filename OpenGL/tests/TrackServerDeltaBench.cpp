@@ -0,0 +1,63 @@
+// What delta1 saves over JSON state frames: bytes on the wire and client
+// CPU (TrackServerJson::parse against Decoder::Decode) at 20, 40 and 100
+// cars, with the default keyframe interval. Encoding cost (the server's
+// side) is shown too.
+
+#include "src/network/TrackServerDelta.h"
+#include "TrackServerFrames.h"
+#include "TestSupport.h"
+
+#include <string>
+#include <vector>
+
+int main()
+{
+    constexpr int kTicks = 600;     // 30 s at 20 Hz
+
+    std::printf("%5s %12s %12s %8s %12s %12s %8s %12s\n", "cars", "JSON B/fr", "delta B/fr", "ratio",
+        "parse us", "decode us", "ratio", "encode us");
+    for (int cars : { 20, 40, 100 }) {
+        std::vector<std::string> json(kTicks);
+        std::vector<std::string> delta(kTicks);
+        std::vector<TrackServerJson::Frame> parsed(kTicks);
+        TrackServerDelta::Encoder encoder;
+        encoder.SetOrigin(TrackServerFrames::kOriginLat, TrackServerFrames::kOriginLon);
+        size_t jsonBytes = 0, deltaBytes = 0;
+        for (int tick = 0; tick < kTicks; ++tick) {
+            json[tick] = TrackServerFrames::StateFrame(cars, tick);
+            TrackServerJson::parse(json[tick], parsed[tick]);
+            encoder.Encode(parsed[tick], delta[tick]);
+            jsonBytes += json[tick].size();
+            deltaBytes += delta[tick].size();
+        }
+
+        TrackServerJson::Frame frame;
+        const double parseUs = Test::MicrosPerCall(kTicks * 5, [&](size_t i) {
+            TrackServerJson::parse(json[i % kTicks], frame);
+            Test::Consume(frame.cars.empty() ? 0.0 : frame.cars.back().lat);
+        });
+
+        // A decoder only follows its stream in order: one pass per round
+        TrackServerDelta::Decoder decoder;
+        const double decodeUs = Test::MicrosPerCall(kTicks * 5, [&](size_t i) {
+            if (i % kTicks == 0)
+                decoder.Reset();
+            decoder.Decode(delta[i % kTicks], frame);
+            Test::Consume(frame.cars.empty() ? 0.0 : frame.cars.back().lat);
+        });
+
+        std::string out;
+        const double encodeUs = Test::MicrosPerCall(kTicks * 5, [&](size_t i) {
+            if (i % kTicks == 0)
+                encoder.Reset();
+            encoder.Encode(parsed[i % kTicks], out);
+            Test::Consume(static_cast<double>(out.size()));
+        });
+
+        const double jsonPerFrame = static_cast<double>(jsonBytes) / kTicks;
+        const double deltaPerFrame = static_cast<double>(deltaBytes) / kTicks;
+        std::printf("%5d %12.0f %12.0f %7.1fx %12.2f %12.2f %7.1fx %12.2f\n", cars, jsonPerFrame, deltaPerFrame,
+            jsonPerFrame / deltaPerFrame, parseUs, decodeUs, parseUs / decodeUs, encodeUs);
+    }
+    return 0;
+}
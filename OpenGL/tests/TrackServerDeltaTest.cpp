@@ -0,0 +1,164 @@
+// delta1 round trip: a race's JSON state frames go through the Encoder (the
+// stand-in for the server's) and the Decoder, and every decoded frame must
+// equal what TrackServerJson reads from the JSON — across keyframes, cars
+// joining and leaving, flag changes, a decoder that joins mid-stream, and
+// frames that are cut short or corrupted.
+
+#include "src/network/TrackServerDelta.h"
+#include "TrackServerFrames.h"
+#include "TestSupport.h"
+
+#include <string>
+#include <vector>
+
+using TrackServerJson::Frame;
+
+namespace {
+
+constexpr int kCars = 30;
+constexpr int kTicks = 400;
+
+bool sameFrame(const Frame& json, const Frame& delta)
+{
+    if (delta.type != "state" || delta.seq != json.seq || delta.server_time_ms != json.server_time_ms ||
+        delta.epoch != json.epoch || delta.flag != json.flag || delta.race != json.race ||
+        delta.cars.size() != json.cars.size())
+        return false;
+    for (size_t i = 0; i < json.cars.size(); ++i) {
+        const TrackServerJson::Car& a = json.cars[i];
+        const TrackServerJson::Car& b = delta.cars[i];
+        const bool same = b.has_id && a.id == b.id && a.lat == b.lat && a.lon == b.lon &&
+            a.gps_ms == b.gps_ms && a.speed == b.speed && a.accel == b.accel &&
+            a.gfx == b.gfx && a.gfy == b.gfy && a.fix == b.fix && a.lap == b.lap && a.pos == b.pos &&
+            std::abs(a.best_lap - b.best_lap) < 1e-9 && std::abs(a.lap_time - b.lap_time) < 1e-9 &&
+            std::abs(a.last_lap - b.last_lap) < 1e-9 && a.fin == b.fin;
+        if (!same)
+            return false;
+    }
+    return true;
+}
+
+void testRoundTrip(uint32_t keyframeInterval)
+{
+    TrackServerDelta::Encoder encoder;
+    encoder.SetOrigin(TrackServerFrames::kOriginLat, TrackServerFrames::kOriginLon);
+    encoder.SetKeyframeInterval(keyframeInterval);
+    TrackServerDelta::Decoder decoder;
+    TrackServerDelta::Decoder lateDecoder;      // Connects at tick 10
+
+    Frame json, decoded;
+    std::string bytes;
+    size_t mismatches = 0, lateDecoded = 0;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        const std::string text = TrackServerFrames::StateFrame(kCars, tick);
+        CHECK(TrackServerJson::parse(text, json));
+        encoder.Encode(json, bytes);
+        CHECK(TrackServerDelta::isDeltaFrame(bytes) && !TrackServerDelta::isDeltaFrame(text));
+
+        if (!decoder.Decode(bytes, decoded) || !sameFrame(json, decoded))
+            ++mismatches;
+
+        // Deltas before its first keyframe are dropped, then it is in step
+        if (tick >= 10 && lateDecoder.Decode(bytes, decoded)) {
+            ++lateDecoded;
+            if (!sameFrame(json, decoded))
+                ++mismatches;
+        }
+    }
+    CHECK(mismatches == 0);
+    if (keyframeInterval == 0)
+        CHECK(lateDecoded == 0);
+    else
+        CHECK(lateDecoded == static_cast<size_t>(kTicks - (10 + keyframeInterval - 1) / keyframeInterval * keyframeInterval));
+}
+
+void testCorruption()
+{
+    TrackServerDelta::Encoder encoder;
+    encoder.SetOrigin(TrackServerFrames::kOriginLat, TrackServerFrames::kOriginLon);
+    encoder.SetKeyframeInterval(50);
+    std::vector<std::string> frames(kTicks);
+    Frame json;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        TrackServerJson::parse(TrackServerFrames::StateFrame(kCars, tick), json);
+        encoder.Encode(json, frames[tick]);
+    }
+
+    // Every prefix of a delta is refused
+    TrackServerDelta::Decoder decoder;
+    Frame decoded;
+    CHECK(decoder.Decode(frames[0], decoded));
+    const std::string& delta = frames[1];
+    for (size_t n = 0; n < delta.size(); ++n) {
+        TrackServerDelta::Decoder fresh;
+        fresh.Decode(frames[0], decoded);
+        CHECK(!fresh.Decode(std::string_view(delta.data(), n), decoded));
+    }
+    std::string trailing = delta + '\0';
+    CHECK(!decoder.Decode(trailing, decoded));
+
+    // After a bad frame the decoder waits for the next keyframe, then
+    // reads every frame exactly again
+    for (int tick = 2; tick < 50; ++tick)
+        CHECK(!decoder.Decode(frames[tick], decoded));
+    for (int tick = 50; tick < kTicks; ++tick) {
+        CHECK(decoder.Decode(frames[tick], decoded));
+        TrackServerJson::parse(TrackServerFrames::StateFrame(kCars, tick), json);
+        CHECK(sameFrame(json, decoded));
+    }
+
+    // Not delta1 at all; a field mask past the field list. Both keyframes
+    // below carry one car (id 1): one with field 0 changed, one with field
+    // 14, which does not exist.
+    CHECK(!decoder.Decode("{\"type\":\"state\"}", decoded));
+    CHECK(!TrackServerDelta::isDeltaFrame(""));
+    const char goodMask[] = { '\xD1', 1, 0, 0, 0, 0, 0, 1, 2, 1, 2 };
+    const char badMask[] = { '\xD1', 1, 0, 0, 0, 0, 0, 1, 2, '\x80', '\x80', 1, 2 };
+    TrackServerDelta::Decoder strict;
+    CHECK(strict.Decode(std::string_view(goodMask, sizeof(goodMask)), decoded));
+    CHECK(decoded.cars.size() == 1 && decoded.cars[0].id == 1 && decoded.cars[0].lat == 1);
+    CHECK(!strict.Decode(std::string_view(badMask, sizeof(badMask)), decoded));
+
+    // Reset forgets the keyframe
+    decoder.Decode(frames[50], decoded);
+    decoder.Reset();
+    CHECK(!decoder.Decode(frames[51], decoded));
+}
+
+void testQuantization()
+{
+    // Lap times keep the JSON's millisecond precision; ids may go down and
+    // be negative; values far from the origin survive
+    const char* text = R"({"type":"state","seq":1,"server_time_ms":2,"epoch":3,"flag":"","race":"","cars":[)"
+        R"({"id":7,"lat":-899999999,"lon":1799999999,"lap_time":61.2346,"best_lap":0.0005,"last_lap":-1},)"
+        R"({"id":-3,"lat":0,"lon":0,"gps_ms":4294967295,"fin":1},{"lap":2}]})";
+    Frame json, decoded;
+    CHECK(TrackServerJson::parse(text, json));
+    TrackServerDelta::Encoder encoder;
+    encoder.SetOrigin(TrackServerFrames::kOriginLat, TrackServerFrames::kOriginLon);
+    std::string bytes;
+    encoder.Encode(json, bytes);
+    TrackServerDelta::Decoder decoder;
+    CHECK(decoder.Decode(bytes, decoded));
+    CHECK(decoded.cars.size() == 2);                // The car without an id is not sent
+    if (decoded.cars.size() == 2) {
+        CHECK(decoded.cars[0].id == 7 && decoded.cars[0].lat == -899999999 && decoded.cars[0].lon == 1799999999);
+        CHECK_NEAR(decoded.cars[0].lap_time, 61.235, 1e-9);
+        CHECK_NEAR(decoded.cars[0].best_lap, 0.001, 1e-9);
+        CHECK_NEAR(decoded.cars[0].last_lap, -1.0, 1e-9);
+        CHECK(decoded.cars[1].id == -3 && decoded.cars[1].gps_ms == 4294967295.0 && decoded.cars[1].fin == 1.0);
+    }
+    CHECK(decoded.flag.empty() && decoded.race.empty());
+}
+
+} // namespace
+
+int main()
+{
+    testRoundTrip(100);
+    testRoundTrip(25);
+    testRoundTrip(0);
+    testCorruption();
+    testQuantization();
+    return Test::Result("TrackServerDeltaTest");
+}
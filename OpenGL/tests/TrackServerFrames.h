@@ -0,0 +1,58 @@
+#pragma once
+
+// ============================================================================
+// TrackServerFrames — JSON state frames of a made-up race, written the way
+// the Track Server writes them, for the delta1 test and benchmark.
+//
+// `cars` cars lap a 1.2 km loop at 20 Hz. Along the session a car joins,
+// one drops out and comes back, the flag goes yellow and green again, and
+// lap counters, lap times and finish flags move as they would in a race.
+// ============================================================================
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace TrackServerFrames {
+
+constexpr int kOriginLat = 557500000;  // deg * 1e7
+constexpr int kOriginLon = 376200000;
+
+inline std::string StateFrame(int cars, int tick)
+{
+    const double t = tick * 0.05;
+    const char* flag = (tick >= 120 && tick < 180) ? "yellow" : "green";
+    const char* race = tick < 20 ? "grid" : "running";
+    char buf[384];
+    std::snprintf(buf, sizeof(buf),
+        R"({"type":"state","seq":%d,"server_time_ms":%lld,"epoch":%d,"flag":"%s","race":"%s","cars":[)",
+        tick, 1700000000000LL + tick * 50LL, tick < 300 ? 4 : 5, flag, race);
+    std::string out = buf;
+
+    bool first = true;
+    for (int i = 0; i < cars + 1; ++i) {
+        const int id = 10 + i * 3;
+        if (i == cars && tick < 50) continue;                   // Joins late
+        if (i == 2 && tick >= 80 && tick < 110) continue;       // Drops out for a while
+        const double lapSeconds = 58.0 + (i % 7) * 0.37;
+        const double laps = std::max(0.0, t - 1.0) / lapSeconds + i * 0.011;
+        const double a = 6.283185307179586 * (laps - std::floor(laps));
+        const int lat = kOriginLat + static_cast<int>(std::lround(1700.0 * std::sin(a) + i * 3));
+        const int lon = kOriginLon + static_cast<int>(std::lround(3000.0 * std::cos(a) - i * 2));
+        const int lap = static_cast<int>(laps) + 1;
+        const double lapTime = (laps - std::floor(laps)) * lapSeconds;
+        const double lastLap = lap > 1 ? lapSeconds + 0.001 * (i % 5) : 0.0;
+        const double bestLap = lap > 1 ? lapSeconds - 0.25 : 0.0;
+        std::snprintf(buf, sizeof(buf),
+            R"(%s{"id":%d,"lat":%d,"lon":%d,"gps_ms":%lld,"speed":%d,"accel":%d,"gfx":%d,"gfy":%d,"fix":%d,)"
+            R"("lap":%d,"pos":%d,"best_lap":%.3f,"lap_time":%.3f,"last_lap":%.3f,"fin":%d})",
+            first ? "" : ",", id, lat, lon, 1700000000000LL + tick * 50LL - i, 9000 + static_cast<int>(300 * std::cos(3 * a)),
+            static_cast<int>(120 * std::sin(3 * a)), static_cast<int>(-80 * std::cos(a)), static_cast<int>(40 * std::sin(2 * a)),
+            tick % 97 == i ? 2 : 3, lap, i + 1, bestLap, lapTime, lastLap, lap > 20 ? 1 : 0);
+        out += buf;
+        first = false;
+    }
+    return out + "]}";
+}
+
+} // namespace TrackServerFrames
@@ -0,0 +1,157 @@
+// State frame parsing: TrackServerJson against the find/strtod reader
+// handleState used before (one substr per car, one search per field).
+//
+//   TrackServerJsonBench [recording]
+//
+// A recording made with BONI_TRACK_RECORD (one frame per line) is replayed
+// as is; without one, 40-car frames shaped like the replay server's are
+// generated.
+
+#include "src/network/TrackServerJson.h"
+#include "TestSupport.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// The old reader, as it was in TrackServerClient.cpp
+// ---------------------------------------------------------------------------
+std::string jsonString(const std::string& text, const std::string& key, size_t from = 0)
+{
+    const std::string pat = "\"" + key + "\":\"";
+    const auto pos = text.find(pat, from);
+    if (pos == std::string::npos) return {};
+    const auto start = pos + pat.size();
+    const auto end = text.find('"', start);
+    if (end == std::string::npos) return {};
+    return text.substr(start, end - start);
+}
+
+double jsonNumber(const std::string& text, const std::string& key, size_t from, bool& ok)
+{
+    const std::string pat = "\"" + key + "\":";
+    const auto pos = text.find(pat, from);
+    if (pos == std::string::npos) { ok = false; return 0.0; }
+    ok = true;
+    return std::strtod(text.c_str() + pos + pat.size(), nullptr);
+}
+
+// Sum of the fields handleState read, so both readers do the same work.
+double oldState(const std::string& text)
+{
+    double sum = 0.0;
+    bool ok = false;
+    if (jsonString(text, "type") != "state")
+        return sum;
+    sum += jsonNumber(text, "seq", 0, ok) + jsonNumber(text, "server_time_ms", 0, ok);
+    sum += static_cast<double>(jsonString(text, "flag").size() + jsonString(text, "race").size());
+    sum += jsonNumber(text, "epoch", 0, ok);
+
+    const auto cars_pos = text.find("\"cars\":[");
+    if (cars_pos == std::string::npos) return sum;
+    size_t pos = cars_pos + 8;
+    while (true) {
+        const auto obj_start = text.find('{', pos);
+        if (obj_start == std::string::npos) break;
+        const auto obj_end = text.find('}', obj_start);
+        if (obj_end == std::string::npos) break;
+        const std::string car = text.substr(obj_start, obj_end - obj_start + 1);
+        pos = obj_end + 1;
+        sum += jsonNumber(car, "id", 0, ok);
+        if (!ok) continue;
+        for (const char* key : { "lat", "lon", "gps_ms", "speed", "accel", "gfx", "gfy", "fix",
+                                 "lap", "pos", "best_lap", "lap_time", "last_lap", "fin" })
+            sum += jsonNumber(car, key, 0, ok);
+    }
+    return sum;
+}
+
+double newState(const std::string& text, TrackServerJson::Frame& frame)
+{
+    double sum = 0.0;
+    if (!TrackServerJson::parse(text, frame) || frame.type != "state")
+        return sum;
+    sum += frame.seq + frame.server_time_ms + frame.epoch;
+    sum += static_cast<double>(frame.flag.size() + frame.race.size());
+    for (const TrackServerJson::Car& c : frame.cars) {
+        sum += c.id + c.lat + c.lon + c.gps_ms + c.speed + c.accel + c.gfx + c.gfy + c.fix;
+        sum += c.lap + c.pos + c.best_lap + c.lap_time + c.last_lap + c.fin;
+    }
+    return sum;
+}
+
+std::vector<std::string> syntheticFrames(int frames, int cars)
+{
+    std::vector<std::string> out;
+    char buf[320];
+    for (int f = 0; f < frames; ++f) {
+        std::snprintf(buf, sizeof(buf),
+            R"({"type":"state","seq":%d,"server_time_ms":%d,"epoch":1,"flag":"green","race":"running","cars":[)",
+            f, 1000000 + f * 50);
+        std::string text = buf;
+        for (int i = 0; i < cars; ++i) {
+            std::snprintf(buf, sizeof(buf),
+                R"(%s{"id":%d,"lat":%d,"lon":%d,"gps_ms":%d,"speed":%d,"accel":0,"gfx":0,"gfy":0,"fix":3,)"
+                R"("lap":%d,"pos":%d,"best_lap":%.3f,"lap_time":%.3f,"last_lap":%.3f,"fin":0})",
+                i ? "," : "", i + 1, 557500000 + f * 31 + i * 977, 376200000 + f * 17 - i * 531,
+                f * 50, 9000 + (f + i) % 700, 1 + f / 600, i + 1, 58.125 + i * 0.1, (f % 1200) * 0.05,
+                59.375 + i * 0.1);
+            text += buf;
+        }
+        out.push_back(text + "]}");
+    }
+    return out;
+}
+
+std::vector<std::string> recordedFrames(const char* path)
+{
+    std::vector<std::string> out;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line))
+        if (line.find("\"type\":\"state\"") != std::string::npos)
+            out.push_back(line);
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::vector<std::string> frames = argc > 1 ? recordedFrames(argv[1]) : syntheticFrames(200, 40);
+    if (frames.empty()) {
+        std::printf("no state frames in %s\n", argv[1]);
+        return 1;
+    }
+    size_t bytes = 0;
+    for (const std::string& f : frames)
+        bytes += f.size();
+
+    // Both readers must agree before their timings mean anything
+    TrackServerJson::Frame frame;
+    size_t mismatches = 0;
+    for (const std::string& f : frames)
+        if (std::abs(oldState(f) - newState(f, frame)) > 1e-6 * std::abs(oldState(f)))
+            ++mismatches;
+
+    constexpr size_t kRounds = 20;
+    const size_t calls = frames.size() * kRounds;
+    const double oldUs = Test::MicrosPerCall(calls, [&](size_t i) {
+        Test::Consume(oldState(frames[i % frames.size()]));
+    });
+    const double newUs = Test::MicrosPerCall(calls, [&](size_t i) {
+        Test::Consume(newState(frames[i % frames.size()], frame));
+    });
+
+    std::printf("%zu state frames, %.1f KB each on average%s\n", frames.size(),
+        static_cast<double>(bytes) / frames.size() / 1024.0, argc > 1 ? " (recorded)" : "");
+    std::printf("%-22s %10.2f us/frame\n", "find + strtod", oldUs);
+    std::printf("%-22s %10.2f us/frame  (%.1fx)\n", "TrackServerJson", newUs, oldUs / newUs);
+    if (mismatches)
+        std::printf("%zu frame(s) read differently by the two readers\n", mismatches);
+    return 0;
+}
@@ -0,0 +1,170 @@
+// TrackServerJson on the frames the Track Server sends: state, track, hello
+// and pong come out field for field; keys only count at their own level;
+// anything cut short or malformed is refused; a reused Frame parses a state
+// frame again without growing.
+
+#include "src/network/TrackServerJson.h"
+#include "TestSupport.h"
+
+#include <string>
+#include <vector>
+
+using TrackServerJson::Frame;
+
+namespace {
+
+std::string carJson(int id, int i)
+{
+    char buf[320];
+    std::snprintf(buf, sizeof(buf),
+        R"({"id":%d,"lat":%d,"lon":%d,"gps_ms":%d,"speed":%d,"accel":-%d,"gfx":%d,"gfy":-%d,"fix":3,)"
+        R"("lap":%d,"pos":%d,"best_lap":%.3f,"lap_time":%.3f,"last_lap":%.3f,"fin":%d})",
+        id, 557500000 + i * 13, 376200000 - i * 7, 1000 + i * 50, 8000 + i, i, i * 2, i * 3,
+        i / 4 + 1, i + 1, 61.25 + i, 12.5 + i, 62.125 + i, i % 5 == 0 ? 1 : 0);
+    return buf;
+}
+
+std::string stateJson(int cars)
+{
+    std::string text = R"({"type":"state","seq":4242,"server_time_ms":98765432,"epoch":7,"flag":"green","race":"running","cars":[)";
+    for (int i = 0; i < cars; ++i)
+        text += (i ? "," : "") + carJson(100 + i, i);
+    return text + "]}";
+}
+
+void testState()
+{
+    const std::string text = stateJson(40);
+    Frame frame;
+    CHECK(TrackServerJson::parse(text, frame));
+    CHECK(frame.type == "state");
+    CHECK(frame.flag == "green" && frame.race == "running");
+    CHECK(frame.has_seq && frame.seq == 4242.0);
+    CHECK(frame.has_server_time && frame.server_time_ms == 98765432.0);
+    CHECK(frame.has_epoch && frame.epoch == 7.0);
+    CHECK(frame.cars.size() == 40);
+    for (size_t k = 0; k < frame.cars.size(); ++k) {
+        const TrackServerJson::Car& car = frame.cars[k];
+        const int i = static_cast<int>(k);
+        CHECK(car.has_id && car.id == 100 + i);
+        CHECK(car.lat == 557500000 + i * 13 && car.lon == 376200000 - i * 7);
+        CHECK(car.gps_ms == 1000 + i * 50 && car.speed == 8000 + i);
+        CHECK(car.accel == -i && car.gfx == i * 2 && car.gfy == -i * 3 && car.fix == 3);
+        CHECK(car.lap == i / 4 + 1 && car.pos == i + 1);
+        CHECK_NEAR(car.best_lap, 61.25 + i, 1e-9);
+        CHECK_NEAR(car.lap_time, 12.5 + i, 1e-9);
+        CHECK_NEAR(car.last_lap, 62.125 + i, 1e-9);
+        CHECK(car.fin == (i % 5 == 0 ? 1.0 : 0.0));
+    }
+
+    // Reused: same capacity, no reallocation
+    const TrackServerJson::Car* data = frame.cars.data();
+    const size_t capacity = frame.cars.capacity();
+    CHECK(TrackServerJson::parse(text, frame));
+    CHECK(frame.cars.size() == 40 && frame.cars.data() == data && frame.cars.capacity() == capacity);
+
+    // A different frame type clears what the last one set
+    CHECK(TrackServerJson::parse(R"({"type":"pong","t0":1234,"t1":5.5,"t2":6.25})", frame));
+    CHECK(frame.cars.empty() && !frame.has_seq && frame.flag.empty());
+    CHECK(frame.has_t0 && frame.t0 == 1234.0 && frame.t1 == 5.5 && frame.t2 == 6.25);
+}
+
+void testKeysAtTheirOwnLevel()
+{
+    // "lap", "id" and "type" nested in other objects must not land in fields,
+    // and keys may come in any order, spaced out
+    const char* text = R"( { "cars" : [ { "meta" : { "lap" : 99, "id" : 5 }, "lap" : 3 ,
+        "extra" : [ 1, { "pos": 8 }, "x\"y" ], "id" : 12, "pos" : 2 },
+        { "lap": 1 } ],
+        "debug": { "type": "hello", "seq": 1 },
+        "type" : "state", "seq" : 9 } )";
+    Frame frame;
+    CHECK(TrackServerJson::parse(text, frame));
+    CHECK(frame.type == "state");
+    CHECK(frame.has_seq && frame.seq == 9.0);
+    CHECK(frame.cars.size() == 2);
+    if (frame.cars.size() == 2) {
+        CHECK(frame.cars[0].has_id && frame.cars[0].id == 12.0);
+        CHECK(frame.cars[0].lap == 3.0 && frame.cars[0].pos == 2.0);
+        CHECK(!frame.cars[1].has_id && frame.cars[1].lap == 1.0);
+    }
+
+    // Values of the wrong type are skipped, not misread
+    CHECK(TrackServerJson::parse(R"({"type":"state","seq":"12","flag":7,"cars":{"id":1},"epoch":true})", frame));
+    CHECK(!frame.has_seq && frame.flag.empty() && frame.cars.empty());
+    CHECK(frame.has_epoch && frame.epoch == 1.0);
+
+    // Escaped quotes stay inside the string
+    CHECK(TrackServerJson::parse(R"({"type":"admin","error":"say \"hi\" \\","flag":"yellow"})", frame));
+    CHECK(frame.type == "admin" && frame.flag == "yellow");
+}
+
+void testTrackAndHello()
+{
+    std::string text = R"({"type":"track","left":[)";
+    for (int i = 0; i < 500; ++i)
+        text += (i ? "," : "") + std::string("[") + std::to_string(i * 0.001) + "," + std::to_string(-i * 0.002) + "]";
+    text += R"(],"right":[[0.5,0.25,9],[1e-3,-2.5E-1]],"origin_easting":412345.5,"origin_northing":6178901.25,)"
+            R"("origin_zone":37,"origin_zone_char":"U","map_size":2048})";
+
+    Frame frame;
+    CHECK(TrackServerJson::parse(text, frame));
+    CHECK(frame.type == "track");
+    CHECK(frame.left.size() == 500);
+    if (frame.left.size() == 500) {
+        CHECK_NEAR(frame.left[499].x, 0.499, 1e-6);
+        CHECK_NEAR(frame.left[499].y, -0.998, 1e-6);
+    }
+    CHECK(frame.right.size() == 2);
+    if (frame.right.size() == 2) {
+        CHECK(frame.right[0].x == 0.5f && frame.right[0].y == 0.25f);   // Third element ignored
+        CHECK_NEAR(frame.right[1].x, 0.001, 1e-9);
+        CHECK_NEAR(frame.right[1].y, -0.25, 1e-9);
+    }
+    CHECK(frame.has_origin_easting && frame.origin_easting == 412345.5);
+    CHECK(frame.origin_northing == 6178901.25 && frame.origin_zone == 37.0);
+    CHECK(frame.origin_zone_char == "U");
+    CHECK(frame.has_map_size && frame.map_size == 2048.0);
+
+    CHECK(TrackServerJson::parse(R"({"type":"hello","role":"viewer","formats":["json","delta1"],"features":["ping"],"v":2})", frame));
+    CHECK(frame.type == "hello" && frame.role == "viewer");
+    CHECK(frame.formats.size() == 2 && frame.formats[1] == "delta1");
+    CHECK(frame.features.size() == 1 && frame.features[0] == "ping");
+    CHECK(frame.left.empty() && frame.right.empty());
+}
+
+void testMalformed()
+{
+    Frame frame;
+    const char* bad[] = {
+        "", "[]", "{", "{\"type\"}", "{\"type\":}", "{\"type\":\"state\",}",
+        "{\"type\":\"state\"} trailing", "{\"seq\":1e}", "{\"cars\":[{\"id\":1}",
+        "{\"type\":\"state\" \"seq\":1}", "{\"type\":\"unterminated}",
+    };
+    for (const char* text : bad)
+        CHECK(!TrackServerJson::parse(text, frame));
+
+    // Every prefix of a real frame is refused (and none reads past its end)
+    const std::string text = stateJson(3);
+    for (size_t n = 0; n < text.size(); ++n) {
+        const std::string cut = text.substr(0, n);
+        CHECK(!TrackServerJson::parse(cut, frame));
+    }
+
+    // Nesting past the limit is refused instead of recursing on
+    const std::string deep = "{\"x\":" + std::string(200, '[') + std::string(200, ']') + "}";
+    CHECK(!TrackServerJson::parse(deep, frame));
+    const std::string shallow = "{\"x\":" + std::string(10, '[') + std::string(10, ']') + "}";
+    CHECK(TrackServerJson::parse(shallow, frame));
+}
+
+} // namespace
+
+int main()
+{
+    testState();
+    testKeysAtTheirOwnLevel();
+    testTrackAndHello();
+    testMalformed();
+    return Test::Result("TrackServerJsonTest");
+}
@@ -0,0 +1,75 @@
+// Nearest-segment projection: TrackSpatialIndex against the linear scan it
+// replaced, at 500, 5k and 50k centre-line points. Cars are mostly on the
+// line (within a couple of metres); a quarter of the queries are anywhere on
+// the map, as for a car in the paddock or a bad fix.
+
+#include "src/track/TrackSpatialIndex.h"
+#include "src/rendering/Interpolation.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<SplinePoint> makeTrack(size_t count)
+{
+    std::vector<SplinePoint> points(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float a = 6.2831853f * static_cast<float>(i) / static_cast<float>(count);
+        const float r = 0.5f + 0.2f * std::sin(7.0f * a);
+        points[i].position = { 2.0f * r * std::cos(a), r * std::sin(a) };
+        points[i].tangent = { 0.0f, 0.0f };
+    }
+    return points;
+}
+
+float linearNearestDistSq(const std::vector<SplinePoint>& points, const glm::vec2& p)
+{
+    float best = std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        const glm::vec2 a = points[i].position;
+        const glm::vec2 ab = points[i + 1].position - a;
+        const float lenSq = glm::dot(ab, ab);
+        if (lenSq < 1e-10f)
+            continue;
+        const float t = glm::clamp(glm::dot(p - a, ab) / lenSq, 0.0f, 1.0f);
+        const glm::vec2 d = p - (a + ab * t);
+        best = std::min(best, glm::dot(d, d));
+    }
+    return best;
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("%8s %14s %14s %10s\n", "points", "linear us", "grid us", "speed-up");
+    for (size_t count : { 500u, 5000u, 50000u }) {
+        const std::vector<SplinePoint> points = makeTrack(count);
+        TrackSpatialIndex index;
+        index.Build(points);
+
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<glm::vec2> queries(20000);
+        for (size_t k = 0; k < queries.size(); ++k) {
+            queries[k] = (k % 4 == 3)
+                ? glm::vec2(unit(rng), unit(rng)) * 1.5f
+                : points[rng() % count].position + glm::vec2(unit(rng), unit(rng)) * 0.002f;
+        }
+
+        // The scan is slow at 50k points: fewer queries are enough
+        const size_t linearQueries = count >= 50000 ? 2000 : queries.size();
+        const double linearUs = Test::MicrosPerCall(linearQueries, [&](size_t k) {
+            Test::Consume(linearNearestDistSq(points, queries[k]));
+        });
+        const double gridUs = Test::MicrosPerCall(queries.size(), [&](size_t k) {
+            Test::Consume(index.Nearest(queries[k]).distSq);
+        });
+        std::printf("%8zu %14.3f %14.3f %9.0fx\n", count, linearUs, gridUs, linearUs / gridUs);
+    }
+    return 0;
+}
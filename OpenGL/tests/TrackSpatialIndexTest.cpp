@@ -0,0 +1,160 @@
+// TrackSpatialIndex against a brute-force scan of the same polyline: every
+// query must find the same distance as checking each segment in turn, on
+// tracks from a few points to 50k, for points on, near and far off the line.
+
+#include "src/track/TrackSpatialIndex.h"
+#include "src/rendering/Interpolation.h"
+#include "TestSupport.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Closed, wavy loop about 2 x 1 map units (a bent oval with 7 bumps).
+std::vector<SplinePoint> makeTrack(size_t count)
+{
+    std::vector<SplinePoint> points(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float a = 6.2831853f * static_cast<float>(i) / static_cast<float>(count);
+        const float r = 0.5f + 0.2f * std::sin(7.0f * a);
+        points[i].position = { 2.0f * r * std::cos(a), r * std::sin(a) };
+        points[i].tangent = { 0.0f, 0.0f };
+    }
+    return points;
+}
+
+// The linear scan TrackSpatialIndex replaced (degenerate segments skipped).
+TrackSpatialIndex::Hit bruteNearest(const std::vector<SplinePoint>& points, const glm::vec2& p)
+{
+    TrackSpatialIndex::Hit best;
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        const glm::vec2 a = points[i].position;
+        const glm::vec2 ab = points[i + 1].position - a;
+        const float lenSq = glm::dot(ab, ab);
+        if (lenSq < 1e-10f)
+            continue;
+        const float t = glm::clamp(glm::dot(p - a, ab) / lenSq, 0.0f, 1.0f);
+        const glm::vec2 d = p - (a + ab * t);
+        const float distSq = glm::dot(d, d);
+        if (distSq < best.distSq) {
+            best.found = true;
+            best.segment = i;
+            best.t = t;
+            best.distSq = distSq;
+        }
+    }
+    return best;
+}
+
+void testAgainstBruteForce(size_t count)
+{
+    std::vector<SplinePoint> points = makeTrack(count);
+    TrackSpatialIndex index;
+    index.Build(points);
+    CHECK(!index.Empty());
+
+    std::mt19937 rng(static_cast<unsigned>(count));
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    int mismatches = 0;
+    for (int k = 0; k < 4000; ++k) {
+        // On the line, near it, inside the map and far outside the grid
+        glm::vec2 p;
+        switch (k % 4) {
+        case 0:  p = points[rng() % count].position + glm::vec2(unit(rng), unit(rng)) * 0.01f; break;
+        case 1:  p = glm::vec2(unit(rng), unit(rng)) * 1.2f; break;
+        case 2:  p = glm::vec2(unit(rng), unit(rng)) * 3.0f; break;
+        default: p = glm::vec2(unit(rng), unit(rng)) * 30.0f; break;
+        }
+
+        const TrackSpatialIndex::Hit ref = bruteNearest(points, p);
+        const TrackSpatialIndex::Hit hit = index.Nearest(p);
+        if (!hit.found || std::abs(hit.distSq - ref.distSq) > 1e-9f * (1.0f + ref.distSq))
+            ++mismatches;
+
+        // The closest point it reports really is that far away
+        const glm::vec2 d = p - hit.closest;
+        CHECK_NEAR(glm::dot(d, d), hit.distSq, 1e-6 * (1.0 + hit.distSq));
+
+        for (float radius : { 0.01f, 0.15f, 10.0f }) {
+            const bool inside = ref.distSq <= radius * radius;
+            const bool onEdge = std::abs(ref.distSq - radius * radius) < 1e-7f;
+            if (!onEdge && index.IsWithin(p, radius) != inside)
+                ++mismatches;
+        }
+
+        const TrackSpatialIndex::Hit within = index.NearestWithin(p, 0.1f);
+        if (std::abs(ref.distSq - 0.01f) > 1e-7f && within.found != (ref.distSq <= 0.01f))
+            ++mismatches;
+        if (within.found && std::abs(within.distSq - ref.distSq) > 1e-9f * (1.0f + ref.distSq))
+            ++mismatches;
+    }
+    if (mismatches != 0)
+        std::printf("  %zu points: %d mismatches\n", count, mismatches);
+    CHECK(mismatches == 0);
+}
+
+void testDegenerateAndEmpty()
+{
+    TrackSpatialIndex index;
+    CHECK(index.Empty());
+    CHECK(!index.Nearest({ 0.0f, 0.0f }).found);
+    CHECK(!index.IsWithin({ 0.0f, 0.0f }, 100.0f));
+
+    // A repeated point makes a zero-length segment: never returned
+    std::vector<SplinePoint> points = makeTrack(3);
+    points[1].position = points[0].position;
+    index.Build(points);
+    const TrackSpatialIndex::Hit hit = index.Nearest(points[0].position);
+    CHECK(hit.found);
+    CHECK(hit.segment == 1);
+
+    index.Clear();
+    CHECK(index.Empty());
+}
+
+void testNearestAround()
+{
+    const size_t count = 2000;
+    std::vector<SplinePoint> points = makeTrack(count);
+    TrackSpatialIndex index;
+    index.Build(points);
+
+    // A hint on the car's own segment finds what the full search finds
+    for (size_t seg = 0; seg + 1 < count; seg += 97) {
+        const glm::vec2 p = glm::mix(points[seg].position, points[seg + 1].position, 0.3f) + glm::vec2(0.001f, -0.002f);
+        const TrackSpatialIndex::Hit around = index.NearestAround(p, seg, 0.05f, 0.05f);
+        const TrackSpatialIndex::Hit ref = index.Nearest(p);
+        CHECK(around.found);
+        CHECK_NEAR(around.distSq, ref.distSq, 1e-9);
+    }
+
+    // Hint just before the end of the polyline, car just past its start:
+    // the window wraps over start/finish
+    const glm::vec2 pastStart = glm::mix(points[1].position, points[2].position, 0.5f);
+    const TrackSpatialIndex::Hit wrapped = index.NearestAround(pastStart, count - 3, 0.01f, 0.05f);
+    CHECK(wrapped.found);
+    CHECK(wrapped.segment == 1);
+    CHECK(wrapped.distSq < 1e-10f);
+
+    // The window only looks at segments near the hint: the other side of the
+    // loop is not searched
+    const glm::vec2 farSide = points[count / 2].position;
+    const TrackSpatialIndex::Hit local = index.NearestAround(farSide, 0, 0.05f, 0.05f);
+    CHECK(local.found);
+    CHECK(local.distSq > 0.1f);
+
+    CHECK(!index.NearestAround(farSide, count, 1.0f, 1.0f).found);
+}
+
+} // namespace
+
+int main()
+{
+    for (size_t count : { 3u, 500u, 5000u, 50000u })
+        testAgainstBruteForce(count);
+    testDegenerateAndEmpty();
+    testNearestAround();
+    return Test::Result("TrackSpatialIndexTest");
+}
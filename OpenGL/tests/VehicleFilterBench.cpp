@@ -0,0 +1,45 @@
+// VehicleFilter at grid size: 200 cars at 50 Hz, every record a noisy fix
+// with speed and both G axes (CarTrace.h), fed frame by frame as the ingest
+// thread does. Prints the cost of Update and At and the share of one core
+// the filters take at that rate.
+
+#include "src/vehicle/VehicleFilter.h"
+#include "CarTrace.h"
+#include "TestSupport.h"
+
+#include <vector>
+
+int main()
+{
+    constexpr int kCars = 200;
+    constexpr double kRateHz = 50.0;
+    constexpr double kSeconds = 20.0;
+
+    const std::vector<CarTrace::Truth> truth = CarTrace::Simulate(kSeconds);
+    std::vector<std::vector<CarTrace::Record>> records(kCars);
+    for (int car = 0; car < kCars; ++car)
+        records[car] = CarTrace::Sample(truth, kRateHz, CarTrace::Noise{}, 100 + car);
+    const size_t frames = records[0].size();
+
+    // Two passes over the session, the first one to warm up
+    std::vector<VehicleFilter> filters(kCars);
+    double updateUs = 0.0;
+    for (int pass = 0; pass < 2; ++pass) {
+        filters.assign(kCars, VehicleFilter{});
+        updateUs = Test::MicrosPerCall(frames * kCars, [&](size_t i) {
+            const size_t frame = i / kCars, car = i % kCars;
+            Test::Consume(filters[car].Update(records[car][frame].m) ? 1.0 : 0.0);
+        });
+    }
+
+    // One frame ahead of the last record, as the interpolator asks
+    const double atUs = Test::MicrosPerCall(frames * kCars, [&](size_t i) {
+        const VehicleFilter& filter = filters[i % kCars];
+        Test::Consume(filter.At(filter.LastUpdateTime() + 0.02).easting);
+    });
+
+    const double share = updateUs * kCars * kRateHz / 1e6;
+    std::printf("%d cars at %.0f Hz, %zu records each\n", kCars, kRateHz, frames);
+    std::printf("  Update %8.3f us   At %8.3f us   %.2f %% of one core\n", updateUs, atUs, 100.0 * share);
+    return 0;
+}
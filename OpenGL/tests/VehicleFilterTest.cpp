@@ -0,0 +1,229 @@
+// VehicleFilter on a simulated car (CarTrace.h): with 1.5 m GNSS noise and
+// one fix in fifty 25 m off, the G axis signs of a logger mounted back to
+// front must be learned, after which the filtered position,
+// heading and speed must be far closer to the truth than the raw fixes at 50
+// and 10 Hz; every outlier must be gated. GNSS alone (no G reported) is shown
+// for comparison. Then the edges: a stationary start, a car moved across the
+// paddock, a gap in the data, the At() horizon and a record without a fix.
+
+#include "src/vehicle/VehicleFilter.h"
+#include "CarTrace.h"
+#include "TestSupport.h"
+
+#include <vector>
+
+using CarTrace::Record;
+
+namespace {
+
+struct Run {
+    double learnedAt = -1.0;           // Both G axis signs known, s
+    double rawRms = 0.0;               // Fixes against the truth, m
+    double positionRms = 0.0;          // Filter against the truth, m
+    double headingRms = 0.0;           // rad
+    double speedRms = 0.0;             // m/s
+    size_t outliers = 0;
+    size_t outliersRejected = 0;
+    size_t goodRejected = 0;
+    size_t fixes = 0;
+    VehicleFilter::Stats stats;
+};
+
+Run run(const std::vector<Record>& records)
+{
+    VehicleFilter filter;
+    Run r;
+    double raw = 0.0, position = 0.0, heading = 0.0, speed = 0.0;
+    size_t counted = 0;
+    for (const Record& rec : records) {
+        const bool accepted = filter.Update(rec.m);
+        // Errors count once the filter has settled: the signs learned, or
+        // (G not reported) after 10 s
+        const VehicleFilter::Stats& stats = filter.GetStats();
+        if (r.learnedAt < 0.0 && stats.lateralSign != 0 && stats.longitudinalSign != 0)
+            r.learnedAt = rec.m.time;
+        const bool reportsG = rec.m.lateralG != 0.0;
+        if (reportsG ? r.learnedAt < 0.0 : rec.m.time < 10.0)
+            continue;
+        ++r.fixes;
+        if (rec.outlier) {
+            ++r.outliers;
+            r.outliersRejected += accepted ? 0 : 1;
+        } else {
+            r.goodRejected += accepted ? 0 : 1;
+        }
+        const VehicleFilter::State s = filter.At(rec.m.time);
+        const double re = rec.m.easting - rec.truth.easting, rn = rec.m.northing - rec.truth.northing;
+        const double fe = s.easting - rec.truth.easting, fn = s.northing - rec.truth.northing;
+        const double he = CarTrace::WrapAngle(s.heading - rec.truth.heading);
+        const double se = s.speed - rec.truth.speed;
+        raw += re * re + rn * rn;
+        position += fe * fe + fn * fn;
+        heading += he * he;
+        speed += se * se;
+        ++counted;
+    }
+    if (counted) {
+        r.rawRms = std::sqrt(raw / counted);
+        r.positionRms = std::sqrt(position / counted);
+        r.headingRms = std::sqrt(heading / counted);
+        r.speedRms = std::sqrt(speed / counted);
+    }
+    r.stats = filter.GetStats();
+    return r;
+}
+
+void testNoisyFixes()
+{
+    const std::vector<CarTrace::Truth> truth = CarTrace::Simulate(180.0);
+    CarTrace::Noise noise;
+    noise.lateralSign = -1;            // Logger mounted facing backwards
+    noise.longitudinalSign = -1;
+
+    std::printf("  %-12s %10s %10s %12s %10s %14s %10s\n", "", "raw RMS m", "pos RMS m", "heading rad", "speed m/s",
+        "outliers gated", "G signs");
+    for (double rateHz : { 50.0, 10.0 }) {
+        std::vector<Record> records = CarTrace::Sample(truth, rateHz, noise, 11);
+        const Run r = run(records);
+        std::printf("  %3.0f Hz       %10.2f %10.2f %12.3f %10.2f %7zu / %-6zu %7.1f s\n", rateHz, r.rawRms,
+            r.positionRms, r.headingRms, r.speedRms, r.outliersRejected, r.outliers, r.learnedAt);
+
+        // Learning windows are counted in records: slower at 10 Hz
+        CHECK(r.learnedAt > 0.0 && r.learnedAt < (rateHz > 20.0 ? 10.0 : 90.0));
+        CHECK(r.stats.lateralSign == -1 && r.stats.longitudinalSign == -1);
+        CHECK(r.positionRms < r.rawRms / 4.0);
+        CHECK(r.positionRms < (rateHz > 20.0 ? 0.5 : 0.9));
+        CHECK(r.headingRms < (rateHz > 20.0 ? 0.02 : 0.04));
+        CHECK(r.speedRms < 0.3);
+        CHECK(r.outliers > 0 && r.outliersRejected == r.outliers);
+        CHECK(r.goodRejected * 200 < r.fixes);     // Under 0.5 % of good fixes lost
+        CHECK(r.stats.resets == 0);
+
+        for (Record& rec : records)
+            rec.m.lateralG = rec.m.longitudinalG = 0.0;
+        const Run gnss = run(records);
+        std::printf("  %3.0f Hz GNSS  %10.2f %10.2f %12.3f %10.2f %7zu / %-6zu\n", rateHz, gnss.rawRms,
+            gnss.positionRms, gnss.headingRms, gnss.speedRms, gnss.outliersRejected, gnss.outliers);
+        CHECK(gnss.positionRms < gnss.rawRms / 3.0);
+        CHECK(gnss.headingRms < 0.2);
+        CHECK(gnss.outliersRejected == gnss.outliers);
+    }
+
+    // RTK fixed, no outliers: the filter follows within centimetres
+    CarTrace::Noise rtk;
+    rtk.positionSigma = 0.02;
+    rtk.outlierRate = 0.0;
+    rtk.fixType = 5;
+    const Run r = run(CarTrace::Sample(truth, 20.0, rtk, 12));
+    CHECK(r.positionRms < 0.05);
+    CHECK(r.goodRejected == 0);
+
+    // Same records, same estimates
+    const std::vector<Record> records = CarTrace::Sample(truth, 50.0, noise, 13);
+    VehicleFilter a, b;
+    bool same = true;
+    for (const Record& rec : records) {
+        a.Update(rec.m);
+        b.Update(rec.m);
+        const VehicleFilter::State sa = a.At(rec.m.time + 0.02), sb = b.At(rec.m.time + 0.02);
+        same = same && sa.easting == sb.easting && sa.northing == sb.northing && sa.heading == sb.heading &&
+            sa.speed == sb.speed && sa.yawRate == sb.yawRate && sa.accel == sb.accel;
+    }
+    CHECK(same);
+}
+
+VehicleFilter::Measurement fix(double time, double easting, double northing, double speed = -1.0)
+{
+    VehicleFilter::Measurement m;
+    m.time = time;
+    m.easting = easting;
+    m.northing = northing;
+    m.fixType = 4;
+    m.speed = speed;
+    return m;
+}
+
+void testStationaryStart()
+{
+    // On the grid: no heading until the car has moved a few metres
+    VehicleFilter filter;
+    CHECK(!filter.Update(VehicleFilter::Measurement{}));      // No fix yet
+    CHECK(!filter.IsInitialized());
+    for (int i = 0; i < 50; ++i)
+        CHECK(filter.Update(fix(i * 0.1, 1000.0 + 0.1 * (i % 3), 2000.0, 0.0)));
+    CHECK(filter.IsInitialized() && !filter.HasHeading());
+    CHECK(filter.At(5.0).heading == 0.0 && filter.At(5.0).yawRate == 0.0);
+
+    // Pulls away heading north at 10 m/s
+    for (int i = 1; i <= 20; ++i)
+        filter.Update(fix(5.0 + i * 0.1, 1000.0, 2000.0 + i * 1.0, 10.0));
+    CHECK(filter.HasHeading());
+    CHECK_NEAR(filter.At(7.0).heading, CarTrace::kPi / 2.0, 0.05);
+    CHECK_NEAR(filter.At(7.0).speed, 10.0, 0.5);
+}
+
+void testMovedCar()
+{
+    // Recovered and put back 400 m away: GATE_RESETS fixes are refused,
+    // then the filter re-seeds there and follows the car again
+    const std::vector<CarTrace::Truth> before = CarTrace::Simulate(30.0);
+    CarTrace::Noise noise;
+    noise.outlierRate = 0.0;
+    VehicleFilter filter;
+    for (const Record& rec : CarTrace::Sample(before, 20.0, noise, 21))
+        filter.Update(rec.m);
+    CHECK(filter.GetStats().rejected == 0);
+
+    const std::vector<CarTrace::Truth> after = CarTrace::Simulate(10.0, before.back().easting + 400.0, before.back().northing);
+    std::vector<Record> records = CarTrace::Sample(after, 20.0, noise, 22);
+    for (Record& rec : records) {
+        rec.m.time += before.back().time + 0.05;
+        filter.Update(rec.m);
+    }
+    const VehicleFilter::Stats& stats = filter.GetStats();
+    CHECK(stats.resets == 1);
+    CHECK(stats.rejected == static_cast<uint64_t>(VehicleFilter::GATE_RESETS));
+    const VehicleFilter::State s = filter.At(records.back().m.time);
+    CHECK(std::hypot(s.easting - records.back().truth.easting, s.northing - records.back().truth.northing) < 2.0);
+    // The mounting signs are not forgotten with the motion
+    CHECK(stats.lateralSign == 1 && stats.longitudinalSign == 1);
+}
+
+void testGapsAndHorizon()
+{
+    VehicleFilter filter;
+    for (int i = 0; i < 40; ++i)
+        filter.Update(fix(i * 0.1, 100.0 + i * 2.0, 0.0, 20.0));
+    CHECK(filter.HasHeading());
+
+    // At() predicts up to MAX_PREDICT ahead and no further
+    const double last = filter.LastUpdateTime();
+    const VehicleFilter::State limit = filter.At(last + VehicleFilter::MAX_PREDICT);
+    const VehicleFilter::State beyond = filter.At(last + 10.0);
+    CHECK(limit.easting == beyond.easting && limit.northing == beyond.northing);
+    CHECK_NEAR(limit.easting, 100.0 + 39 * 2.0 + 20.0 * VehicleFilter::MAX_PREDICT, 0.5);
+
+    // A record without a fix still carries the speed
+    VehicleFilter::Measurement noFix = fix(last + 0.1, 0.0, 0.0, 20.6);
+    noFix.fixType = 0;
+    CHECK(!filter.Update(noFix));
+    CHECK(filter.GetStats().rejected == 0);
+    CHECK(filter.LastUpdateTime() == last + 0.1);
+    CHECK(filter.At(last + 0.1).speed > 20.1);
+
+    // Silent for longer than MAX_GAP: starts over from the next fix
+    CHECK(filter.Update(fix(last + VehicleFilter::MAX_GAP + 1.0, 5000.0, 5000.0)));
+    CHECK(filter.IsInitialized() && !filter.HasHeading());
+    CHECK(filter.At(0.0).easting == 5000.0);
+}
+
+} // namespace
+
+int main()
+{
+    testNoisyFixes();
+    testStationaryStart();
+    testMovedCar();
+    testGapsAndHorizon();
+    return Test::Result("VehicleFilterTest");
+}
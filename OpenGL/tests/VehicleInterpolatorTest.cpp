@@ -0,0 +1,310 @@
+// VehicleInterpolator against a simulated car: a 350 m paperclip circuit with
+// two 8 m hairpins, speed falling from 100 to 35 km/h into each and the
+// racing line swinging 6 m across the track. Fixes are sampled from the
+// ground truth at 20, 10, 5 and 3 Hz and played out at 60 fps; every pose is
+// compared with where the car really was at the pose's playout time, next
+// to what straight lines between the fixes (and along the last heading)
+// would have drawn. Two laps, so start/finish is crossed too.
+//
+// The interpolation must stay on the racing line at every rate and beat
+// straight lines where they cut the hairpins; a 100 ms prediction must
+// follow the hairpin instead of leaving the track. A fix that is not on
+// the loaded track falls back to straight lines.
+
+#include "src/vehicle/VehicleInterpolator.h"
+#include "src/track/TrackGeometry.h"
+#include "src/Config.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kStraight = 149.87;            // m; 2 straights + 2 hairpins = 350 m
+constexpr double kRadius = 8.0;
+constexpr double kHairpin = kPi * kRadius;
+constexpr double kLoop = 2.0 * (kStraight + kHairpin);
+constexpr double kLineSpacing = 0.25;           // Centre line resolution, m
+constexpr double kFrameRate = 60.0;
+constexpr double kTruthStep = 0.001;            // s
+constexpr double kLookahead = 0.6;              // Fixes handed over ahead of the render clock
+constexpr double kPrediction = 0.100;           // Extrapolation horizon checked
+constexpr int32_t kCar = 7;
+
+struct Vec {
+    double x, y;
+};
+
+// Centre line at arc length s (m), counter-clockwise from the start of the
+// bottom straight, and its unit tangent.
+void centre(double s, Vec& p, Vec& t)
+{
+    s = std::fmod(s, kLoop);
+    if (s < 0.0) s += kLoop;
+    const double half = kStraight / 2.0;
+    if (s < kStraight) {
+        p = { -half + s, -kRadius };
+        t = { 1.0, 0.0 };
+    } else if (s < kStraight + kHairpin) {
+        const double a = -kPi / 2.0 + (s - kStraight) / kRadius;
+        p = { half + kRadius * std::cos(a), kRadius * std::sin(a) };
+        t = { -std::sin(a), std::cos(a) };
+    } else if (s < 2.0 * kStraight + kHairpin) {
+        p = { half - (s - kStraight - kHairpin), kRadius };
+        t = { -1.0, 0.0 };
+    } else {
+        const double a = kPi / 2.0 + (s - 2.0 * kStraight - kHairpin) / kRadius;
+        p = { -half + kRadius * std::cos(a), kRadius * std::sin(a) };
+        t = { -std::sin(a), std::cos(a) };
+    }
+}
+
+// 1 at each hairpin apex, falling off over `width` metres either side.
+double nearApex(double s, double width)
+{
+    double w = 0.0;
+    for (double apex : { kStraight + kHairpin / 2.0, 2.0 * kStraight + 1.5 * kHairpin }) {
+        double d = std::fmod(s - apex, kLoop);
+        if (d > kLoop / 2.0) d -= kLoop;
+        if (d < -kLoop / 2.0) d += kLoop;
+        w += std::exp(-(d * d) / (width * width));
+    }
+    return w;
+}
+
+// Racing line: outside on the straights, inside at the apex (left of the
+// centre line is the inside on this loop)
+Vec racingLine(double s)
+{
+    Vec p, t;
+    centre(s, p, t);
+    const double offset = -3.0 + 6.0 * nearApex(s, 15.0);
+    return { p.x - t.y * offset, p.y + t.x * offset };
+}
+
+// Rate of progress along the centre line, m/s
+double progressRate(double s)
+{
+    return (100.0 - 65.0 * nearApex(s, 25.0)) / 3.6;
+}
+
+struct Truth {
+    std::vector<double> arc;                    // Centre-line arc length every kTruthStep
+
+    explicit Truth(double seconds)
+    {
+        double s = 0.0;
+        for (double t = 0.0; t <= seconds + 1.0; t += kTruthStep) {
+            arc.push_back(s);
+            // Midpoint step; the step is far below the time the speed changes in
+            s += progressRate(s + 0.5 * kTruthStep * progressRate(s)) * kTruthStep;
+        }
+    }
+
+    double arcAt(double t) const
+    {
+        const double i = std::clamp(t / kTruthStep, 0.0, static_cast<double>(arc.size() - 2));
+        const size_t k = static_cast<size_t>(i);
+        return arc[k] + (arc[k + 1] - arc[k]) * (i - static_cast<double>(k));
+    }
+
+    Vec at(double t) const { return racingLine(arcAt(t)); }
+
+    VehicleSnapshot Fix(double t) const
+    {
+        const double h = 0.0005;
+        const Vec a = at(t - h), b = at(t + h), p = at(t);
+        const double vx = (b.x - a.x) / (2.0 * h), vy = (b.y - a.y) / (2.0 * h);
+        VehicleSnapshot fix;
+        fix.timestamp = t;
+        fix.x = p.x / MapConstants::MAP_SIZE;
+        fix.y = p.y / MapConstants::MAP_SIZE;
+        fix.speed_kph = std::hypot(vx, vy) * 3.6;
+        fix.heading = std::atan2(vy, vx);
+        fix.yaw_rate = 0.0;
+        // What the ingest matcher reports: the fix projected on the line
+        const TrackGeometry::SnapshotPtr track = TrackGeometry::Current();
+        const TrackSpatialIndex::Hit hit = track->segmentIndex.Nearest(
+            glm::vec2(static_cast<float>(fix.x), static_cast<float>(fix.y)));
+        if (hit.found) {
+            fix.track_progress = (static_cast<double>(track->cumulative[hit.segment]) +
+                static_cast<double>(hit.segmentLength * hit.t)) / track->openLength;
+        }
+        return fix;
+    }
+};
+
+void publishTrack()
+{
+    std::vector<SplinePoint> points;
+    for (double s = 0.0; s < kLoop - kLineSpacing / 2.0; s += kLineSpacing) {
+        Vec p, t;
+        centre(s, p, t);
+        SplinePoint point;
+        point.position = glm::vec2(static_cast<float>(p.x / MapConstants::MAP_SIZE), static_cast<float>(p.y / MapConstants::MAP_SIZE));
+        point.tangent = glm::vec2(static_cast<float>(t.x), static_cast<float>(t.y));
+        points.push_back(point);
+    }
+    TrackGeometry::PublishPoints(points);
+}
+
+double metresFrom(const Vec& truth, double x, double y)
+{
+    return std::hypot(x * MapConstants::MAP_SIZE - truth.x, y * MapConstants::MAP_SIZE - truth.y);
+}
+
+struct Errors {
+    double linear = 0.0;
+    double track = 0.0;
+    size_t samples = 0;
+};
+
+// Streams the fixes of two laps at `rateHz` and renders at 60 fps. Fixes are
+// handed over kLookahead ahead of the render clock, so every frame falls
+// between two of them whatever delay the buffer settles on.
+Errors interpolation(const Truth& truth, double seconds, double rateHz)
+{
+    VehicleInterpolator& interpolator = VehicleInterpolator::Get();
+    interpolator.Clear();
+    std::vector<VehicleSnapshot> fixes;
+    for (int k = 0; k / rateHz <= seconds + kLookahead; ++k)
+        fixes.push_back(truth.Fix(k / rateHz));
+
+    Errors errors;
+    size_t next = 0;
+    for (int frame = 0; frame / kFrameRate <= seconds; ++frame) {
+        const double t = frame / kFrameRate;
+        for (; next < fixes.size() && fixes[next].timestamp <= t + kLookahead; ++next)
+            interpolator.AddSnapshot(kCar, fixes[next]);
+        VehiclePose pose;
+        interpolator.GetInterpolatedStates(t, &kCar, 1, &pose);
+        if (!pose.valid || pose.playout_time < 1.0)
+            continue;                   // The car is still leaving the grid
+        CHECK(pose.playout_time < fixes[next - 1].timestamp);
+
+        const size_t k = static_cast<size_t>(pose.playout_time * rateHz);
+        const VehicleSnapshot& a = fixes[k];
+        const VehicleSnapshot& b = fixes[k + 1];
+        const double alpha = (pose.playout_time - a.timestamp) / (b.timestamp - a.timestamp);
+        const Vec real = truth.at(pose.playout_time);
+        errors.linear = std::max(errors.linear, metresFrom(real, a.x + (b.x - a.x) * alpha, a.y + (b.y - a.y) * alpha));
+        errors.track = std::max(errors.track, metresFrom(real, pose.x, pose.y));
+        ++errors.samples;
+    }
+    return errors;
+}
+
+// Pose of kCar taken at `playoutTime`. Until its buffer has settled a
+// vehicle's delay is its current target, which only moves on arrivals: one
+// frame finds it, the second renders that far ahead.
+VehiclePose poseAt(double playoutTime)
+{
+    VehiclePose pose;
+    VehicleInterpolator::Get().GetInterpolatedStates(playoutTime, &kCar, 1, &pose);
+    const double delay = playoutTime - pose.playout_time;
+    VehicleInterpolator::Get().GetInterpolatedStates(playoutTime + delay, &kCar, 1, &pose);
+    return pose;
+}
+
+// kPrediction past the newest of two fixes, every 50 ms along two laps.
+// Each sample is a fresh vehicle.
+Errors extrapolation(const Truth& truth, double seconds, double rateHz)
+{
+    VehicleInterpolator& interpolator = VehicleInterpolator::Get();
+    interpolator.Clear();
+    Errors errors;
+    for (double t = 1.0; t <= seconds; t += 0.05) {
+        const VehicleSnapshot before = truth.Fix(t - 1.0 / rateHz);
+        const VehicleSnapshot last = truth.Fix(t);
+        interpolator.AddSnapshot(kCar, before);
+        interpolator.AddSnapshot(kCar, last);
+        const VehiclePose pose = poseAt(t + kPrediction);
+        interpolator.RemoveVehicle(kCar);
+        CHECK(pose.valid);
+        const double ahead = pose.playout_time - last.timestamp;
+        CHECK_NEAR(ahead, kPrediction, 1e-9);
+        if (!pose.valid || ahead <= 0.0)
+            continue;
+
+        const double distance = last.speed_kph / 3.6 / MapConstants::MAP_SIZE * ahead;
+        const Vec real = truth.at(pose.playout_time);
+        errors.linear = std::max(errors.linear, metresFrom(real,
+            last.x + std::cos(last.heading) * distance, last.y + std::sin(last.heading) * distance));
+        errors.track = std::max(errors.track, metresFrom(real, pose.x, pose.y));
+        ++errors.samples;
+    }
+    return errors;
+}
+
+void testAgainstTruth()
+{
+    const Truth truth(40.0);
+    const double lapTime = static_cast<double>(std::lower_bound(truth.arc.begin(), truth.arc.end(), kLoop) - truth.arc.begin()) * kTruthStep;
+    const double seconds = 2.0 * lapTime + 0.5;
+    std::printf("  paperclip %.0f m, lap %.2f s; max position error, m\n", kLoop, lapTime);
+    std::printf("  %6s %22s %26s\n", "fixes", "interp linear / track", "extrap 100 ms linear / track");
+
+    for (double rateHz : { 20.0, 10.0, 5.0, 3.0 }) {
+        const Errors interp = interpolation(truth, seconds, rateHz);
+        const Errors extrap = extrapolation(truth, seconds, rateHz);
+        std::printf("  %3.0f Hz %13.3f / %.3f %19.3f / %.3f\n", rateHz, interp.linear, interp.track, extrap.linear, extrap.track);
+
+        CHECK(interp.samples > static_cast<size_t>(1.9 * lapTime * kFrameRate));
+        CHECK(extrap.samples > static_cast<size_t>(1.9 * lapTime / 0.05));
+        // On the racing line at every rate; no worse than straight lines
+        // when the fixes are dense, far better when they are sparse
+        CHECK(interp.track < 0.15);
+        CHECK(interp.track <= interp.linear + 0.005);
+        if (rateHz <= 5.0)
+            CHECK(interp.track < 0.6 * interp.linear);
+        // The prediction follows the hairpin
+        CHECK(extrap.track < 0.15);
+        CHECK(extrap.track < 0.6 * extrap.linear);
+    }
+}
+
+void testOffTrackFallsBack()
+{
+    // Progress matched to the far straight: the fixes are more than 12 m
+    // from where it says, so the pose is the straight line between them
+    const Truth truth(5.0);
+    VehicleSnapshot a = truth.Fix(1.0), b = truth.Fix(1.1);
+    a.track_progress = b.track_progress = 0.5;
+
+    VehicleInterpolator& interpolator = VehicleInterpolator::Get();
+    interpolator.Clear();
+    interpolator.AddSnapshot(kCar, a);
+    interpolator.AddSnapshot(kCar, b);
+    VehiclePose pose = poseAt(1.05);
+    CHECK(pose.valid);
+    CHECK_NEAR(pose.playout_time, 1.05, 1e-9);
+    CHECK_NEAR(pose.x, (a.x + b.x) / 2.0, 1e-12);
+    CHECK_NEAR(pose.y, (a.y + b.y) / 2.0, 1e-12);
+    CHECK(pose.track_progress == a.track_progress);
+
+    // No track loaded: straight lines as well
+    TrackGeometry::ClearPoints();
+    interpolator.Clear();
+    a = truth.Fix(1.0);
+    b = truth.Fix(1.1);
+    interpolator.AddSnapshot(kCar, a);
+    interpolator.AddSnapshot(kCar, b);
+    pose = poseAt(1.05);
+    CHECK(pose.valid);
+    CHECK_NEAR(pose.x, (a.x + b.x) / 2.0, 1e-12);
+    CHECK_NEAR(pose.y, (a.y + b.y) / 2.0, 1e-12);
+    publishTrack();
+}
+
+} // namespace
+
+int main()
+{
+    publishTrack();
+    testAgainstTruth();
+    testOffTrackFallsBack();
+    VehicleInterpolator::Get().Clear();
+    return Test::Result("VehicleInterpolatorTest");
+}
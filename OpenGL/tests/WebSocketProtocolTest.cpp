@@ -0,0 +1,120 @@
+// WebSocketProtocol against RFC 6455: the handshake key and frames of the
+// RFC's own examples, header round trips at every length encoding, partial
+// headers, masking and HTTP header lookup.
+
+#include "src/network/WebSocketProtocol.h"
+#include "TestSupport.h"
+
+#include <cstring>
+#include <vector>
+
+namespace WS = WebSocketProtocol;
+
+namespace {
+
+void testHandshake()
+{
+    // RFC 6455 section 1.3
+    CHECK(WS::acceptKey("dGhlIHNhbXBsZSBub25jZQ==") == "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+
+    // RFC 4648 section 10
+    const char* plain[] = { "", "f", "fo", "foo", "foob", "fooba", "foobar" };
+    const char* coded[] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+    for (size_t i = 0; i < 7; ++i)
+        CHECK(WS::base64(reinterpret_cast<const uint8_t*>(plain[i]), std::strlen(plain[i])) == coded[i]);
+
+    const char* head =
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "upgrade: websocket\r\n"
+        "Connection:Upgrade\r\n"
+        "SEC-WEBSOCKET-ACCEPT:   s3pPLMBiTxaQ9kYGzzhZRbK+xOo=  \r\n";
+    CHECK(WS::headerValue(head, "Sec-WebSocket-Accept") == "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+    CHECK(WS::headerValue(head, "Upgrade") == "websocket");
+    CHECK(WS::headerValue(head, "connection") == "Upgrade");
+    CHECK(WS::headerValue(head, "Sec-WebSocket-Key").empty());
+    CHECK(WS::headerValue(head, "HTTP/1.1 101 Switching Protocols").empty());   // Status line is no header
+}
+
+void testRfcFrames()
+{
+    // RFC 6455 section 5.7: unmasked and masked "Hello"
+    const uint8_t unmasked[] = { 0x81, 0x05, 'H', 'e', 'l', 'l', 'o' };
+    WS::FrameHeader h;
+    CHECK(WS::parseFrameHeader(unmasked, sizeof(unmasked), h));
+    CHECK(h.fin && h.opcode == WS::kText && !h.masked && h.payloadSize == 5 && h.headerSize == 2);
+
+    uint8_t masked[] = { 0x81, 0x85, 0x37, 0xfa, 0x21, 0x3d, 0x7f, 0x9f, 0x4d, 0x51, 0x58 };
+    CHECK(WS::parseFrameHeader(masked, sizeof(masked), h));
+    CHECK(h.fin && h.opcode == WS::kText && h.masked && h.payloadSize == 5 && h.headerSize == 6);
+    WS::applyMask(masked + h.headerSize, 5, h.mask);
+    CHECK(std::memcmp(masked + h.headerSize, "Hello", 5) == 0);
+
+    // First fragment of a fragmented message, and a ping
+    const uint8_t fragment[] = { 0x01, 0x03, 'H', 'e', 'l' };
+    CHECK(WS::parseFrameHeader(fragment, sizeof(fragment), h));
+    CHECK(!h.fin && h.opcode == WS::kText);
+    const uint8_t ping[] = { 0x89, 0x00 };
+    CHECK(WS::parseFrameHeader(ping, sizeof(ping), h));
+    CHECK(h.fin && h.opcode == WS::kPing && h.payloadSize == 0);
+
+    // 256-byte and 64 KiB binary, unmasked
+    const uint8_t medium[] = { 0x82, 0x7E, 0x01, 0x00 };
+    CHECK(WS::parseFrameHeader(medium, sizeof(medium), h));
+    CHECK(h.opcode == WS::kBinary && h.payloadSize == 256 && h.headerSize == 4);
+    const uint8_t large[] = { 0x82, 0x7F, 0, 0, 0, 0, 0, 1, 0, 0 };
+    CHECK(WS::parseFrameHeader(large, sizeof(large), h));
+    CHECK(h.payloadSize == 65536 && h.headerSize == 10);
+}
+
+void testHeaderRoundTrip()
+{
+    const uint8_t mask[4] = { 0xA1, 0x02, 0x7F, 0xFE };
+    const uint64_t sizes[] = { 0, 1, 125, 126, 127, 65535, 65536, 1ull << 32, (1ull << 63) - 1 };
+    for (const uint64_t size : sizes) {
+        for (const uint8_t* m : { static_cast<const uint8_t*>(nullptr), mask }) {
+            uint8_t buf[WS::kMaxHeaderSize];
+            const size_t n = WS::writeFrameHeader(buf, WS::kBinary, size, m);
+            const size_t expected = (size < 126 ? 2 : size <= 0xFFFF ? 4 : 10) + (m ? 4 : 0);
+            CHECK(n == expected);
+
+            WS::FrameHeader h;
+            CHECK(WS::parseFrameHeader(buf, n, h));
+            CHECK(h.fin && h.opcode == WS::kBinary && h.payloadSize == size && h.headerSize == n);
+            CHECK(h.masked == (m != nullptr));
+            if (m)
+                CHECK(std::memcmp(h.mask, mask, 4) == 0);
+
+            // Any shorter prefix is not a header yet
+            for (size_t cut = 0; cut < n; ++cut)
+                CHECK(!WS::parseFrameHeader(buf, cut, h));
+        }
+    }
+}
+
+void testMask()
+{
+    const uint8_t mask[4] = { 0x12, 0x34, 0x56, 0x78 };
+    std::vector<uint8_t> data(1003);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<uint8_t>(i * 7);
+    const std::vector<uint8_t> original = data;
+
+    WS::applyMask(data.data(), data.size(), mask);
+    bool masked = true;
+    for (size_t i = 0; i < data.size(); ++i)
+        masked = masked && data[i] == static_cast<uint8_t>(original[i] ^ mask[i % 4]);
+    CHECK(masked);
+    WS::applyMask(data.data(), data.size(), mask);
+    CHECK(data == original);
+}
+
+} // namespace
+
+int main()
+{
+    testHandshake();
+    testRfcFrames();
+    testHeaderRoundTrip();
+    testMask();
+    return Test::Result("WebSocketProtocolTest");
+}
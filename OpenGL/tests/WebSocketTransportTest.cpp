@@ -0,0 +1,325 @@
+// The epoll WebSocketTransport against a loopback server written with
+// WebSocketProtocol: frames glued to the handshake, fragmented messages
+// with a ping in between, a large message dribbled in small writes, client
+// sends, close, Abort() from another thread, refused upgrades — and a load
+// run at 120 cars x 50 Hz that reports per-message latency and fails on a
+// stall. Linux only, like the backend.
+
+#include "src/network/WebSocketTransport.h"
+#include "src/network/WebSocketProtocol.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace WS = WebSocketProtocol;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool sendAll(int fd, const void* data, size_t size)
+{
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool sendAll(int fd, const std::string& bytes)
+{
+    return sendAll(fd, bytes.data(), bytes.size());
+}
+
+bool recvAll(int fd, void* data, size_t size)
+{
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t n = ::recv(fd, p, size, 0);
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// One unmasked frame, as a server sends it. `fin` false = more fragments.
+std::string frame(uint8_t opcode, const std::string& payload, bool fin = true)
+{
+    uint8_t head[WS::kMaxHeaderSize];
+    const size_t n = WS::writeFrameHeader(head, opcode, payload.size());
+    if (!fin)
+        head[0] &= 0x7F;
+    return std::string(reinterpret_cast<const char*>(head), n) + payload;
+}
+
+// Reads one client frame, which must be masked, and unmasks it.
+bool readClientFrame(int fd, uint8_t& opcode, std::string& payload)
+{
+    uint8_t head[WS::kMaxHeaderSize];
+    size_t have = 0;
+    WS::FrameHeader h;
+    while (!WS::parseFrameHeader(head, have, h)) {
+        if (have == sizeof(head) || !recvAll(fd, head + have, 1))
+            return false;
+        ++have;
+    }
+    payload.resize(static_cast<size_t>(h.payloadSize));
+    if (!payload.empty() && !recvAll(fd, &payload[0], payload.size()))
+        return false;
+    if (!h.masked)
+        return false;
+    WS::applyMask(reinterpret_cast<uint8_t*>(&payload[0]), payload.size(), h.mask);
+    opcode = h.opcode;
+    return true;
+}
+
+// A one-connection server on 127.0.0.1. It reads the upgrade request and
+// hands the socket to `script` with the 101 response still to send, so the
+// script can glue frames behind it (or send something else instead).
+class LoopbackServer
+{
+public:
+    using Script = std::function<void(int fd, const std::string& upgrade)>;
+
+    explicit LoopbackServer(Script script)
+    {
+        m_listen = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(m_listen, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(m_listen, 1);
+        socklen_t len = sizeof(addr);
+        ::getsockname(m_listen, reinterpret_cast<sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+
+        m_thread = std::thread([this, script = std::move(script)] {
+            const int fd = ::accept(m_listen, nullptr, nullptr);
+            if (fd < 0)
+                return;
+            const int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            std::string head;
+            char c = 0;
+            while (head.find("\r\n\r\n") == std::string::npos && ::recv(fd, &c, 1, 0) == 1)
+                head += c;
+            const std::string upgrade =
+                "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                "Sec-WebSocket-Accept: " + WS::acceptKey(WS::headerValue(head, "Sec-WebSocket-Key")) + "\r\n\r\n";
+            script(fd, upgrade);
+            ::close(fd);
+        });
+    }
+
+    ~LoopbackServer()
+    {
+        Join();
+        ::close(m_listen);
+    }
+
+    uint16_t Port() const { return m_port; }
+
+    // Until the script has returned (what it recorded is safe to read)
+    void Join()
+    {
+        ::shutdown(m_listen, SHUT_RDWR);
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+private:
+    int m_listen = -1;
+    uint16_t m_port = 0;
+    std::thread m_thread;
+};
+
+// CPU time of the calling thread: what receiving costs, waits excluded.
+double threadCpuUs()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+}
+
+std::string pattern(size_t size, unsigned seed)
+{
+    std::string s(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+        s[i] = static_cast<char>('a' + (i * 7 + seed) % 26);
+    return s;
+}
+
+void testMessages()
+{
+    const std::string big = pattern(200 * 1024, 3);
+    std::string pong, fromClient;
+    uint8_t pongOpcode = 0, clientOpcode = 0, closeOpcode = 0;
+
+    LoopbackServer server([&](int fd, const std::string& upgrade) {
+        // A message in the same segment as the handshake response
+        sendAll(fd, upgrade + frame(WS::kText, "first"));
+
+        // Three fragments with a ping between them
+        sendAll(fd, frame(WS::kText, "frag-", false) + frame(WS::kContinuation, "men", false) +
+                    frame(WS::kPing, "p1") + frame(WS::kContinuation, "ted"));
+        readClientFrame(fd, pongOpcode, pong);
+
+        // 200 KB in 40 fragments, written a kilobyte at a time
+        std::string bytes;
+        const size_t piece = big.size() / 40;
+        for (size_t i = 0; i < 40; ++i)
+            bytes += frame(i ? WS::kContinuation : WS::kBinary, big.substr(i * piece, piece), i == 39);
+        for (size_t pos = 0; pos < bytes.size(); pos += 1024) {
+            sendAll(fd, bytes.data() + pos, std::min<size_t>(1024, bytes.size() - pos));
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        readClientFrame(fd, clientOpcode, fromClient);
+        sendAll(fd, frame(WS::kText, "") + frame(WS::kClose, std::string("\x03\xE8", 2)));
+        std::string echo;
+        readClientFrame(fd, closeOpcode, echo);
+    });
+
+    std::unique_ptr<WebSocketTransport> ws = CreateWebSocketTransport();
+    CHECK(ws->Connect("127.0.0.1", server.Port(), "/"));
+    std::string_view message;
+    CHECK(ws->ReceiveMessage(message) == WebSocketTransport::Receive::Message);
+    CHECK(message == "first");
+    CHECK(ws->ReceiveMessage(message) == WebSocketTransport::Receive::Message);
+    CHECK(message == "frag-mented");
+    CHECK(ws->ReceiveMessage(message) == WebSocketTransport::Receive::Message);
+    CHECK(message.size() == big.size() && message == big);
+    CHECK(ws->SendText("subscribe"));
+    CHECK(ws->ReceiveMessage(message) == WebSocketTransport::Receive::Message);
+    CHECK(message.empty());
+    CHECK(ws->ReceiveMessage(message) == WebSocketTransport::Receive::Closed);
+    ws.reset();
+    server.Join();
+
+    CHECK(pongOpcode == WS::kPong && pong == "p1");
+    CHECK(clientOpcode == WS::kText && fromClient == "subscribe");
+    CHECK(closeOpcode == WS::kClose);
+}
+
+void testAbortAndRefusal()
+{
+    // Abort() from another thread ends a ReceiveMessage that has nothing coming
+    {
+        LoopbackServer server([](int fd, const std::string& upgrade) {
+            sendAll(fd, upgrade);
+            char c = 0;
+            ::recv(fd, &c, 1, 0);   // Until the client goes away
+        });
+        std::unique_ptr<WebSocketTransport> ws = CreateWebSocketTransport();
+        CHECK(ws->Connect("127.0.0.1", server.Port(), "/"));
+        std::thread aborter([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            ws->Abort();
+        });
+        const Clock::time_point start = Clock::now();
+        std::string_view message;
+        CHECK(ws->ReceiveMessage(message) == WebSocketTransport::Receive::Closed);
+        CHECK(Clock::now() - start < std::chrono::seconds(2));
+        aborter.join();
+        CHECK(!ws->SendText("late"));
+        ws.reset();
+    }
+
+    // No upgrade, and an upgrade with the wrong accept key
+    const std::string replies[] = {
+        "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n",
+        "HTTP/1.1 101 Switching Protocols\r\nSec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n\r\n",
+    };
+    for (const std::string& reply : replies) {
+        LoopbackServer server([&](int fd, const std::string&) { sendAll(fd, reply); });
+        std::unique_ptr<WebSocketTransport> ws = CreateWebSocketTransport();
+        CHECK(!ws->Connect("127.0.0.1", server.Port(), "/"));
+        CHECK(!ws->LastError().empty());
+    }
+}
+
+void testLoad()
+{
+    // 120 cars x 50 Hz for 3 s: state-sized text frames stamped with their
+    // send time. A stall is a frame arriving more than kStallMs late.
+    constexpr int kCars = 120;
+    constexpr int kRateHz = 50;
+    constexpr int kFrames = kRateHz * 3;
+    constexpr double kStallMs = 100.0;
+    const std::string cars = pattern(kCars * 190, 5);
+
+    LoopbackServer server([&](int fd, const std::string& upgrade) {
+        sendAll(fd, upgrade);
+        const Clock::time_point start = Clock::now();
+        for (int i = 0; i < kFrames; ++i) {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(1000000 / kRateHz) * i);
+            const long long sentNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now().time_since_epoch()).count();
+            if (!sendAll(fd, frame(WS::kText, std::to_string(sentNs) + ";" + cars)))
+                return;
+        }
+        sendAll(fd, frame(WS::kClose, std::string("\x03\xE8", 2)));
+        uint8_t opcode = 0;
+        std::string echo;
+        readClientFrame(fd, opcode, echo);
+    });
+
+    std::unique_ptr<WebSocketTransport> ws = CreateWebSocketTransport();
+    CHECK(ws->Connect("127.0.0.1", server.Port(), "/"));
+    std::vector<double> latencyMs;
+    std::string_view message;
+    const double cpuStart = threadCpuUs();
+    for (;;) {
+        const WebSocketTransport::Receive r = ws->ReceiveMessage(message);
+        if (r != WebSocketTransport::Receive::Message)
+            break;
+        const Clock::time_point now = Clock::now();
+        const long long sentNs = std::stoll(std::string(message.substr(0, message.find(';'))));
+        latencyMs.push_back((now.time_since_epoch().count() - sentNs) * 1e-6);
+        CHECK(message.size() == message.find(';') + 1 + cars.size());
+    }
+
+    const double cpuUs = threadCpuUs() - cpuStart;
+    CHECK(latencyMs.size() == static_cast<size_t>(kFrames));
+    if (latencyMs.empty())
+        return;
+    std::vector<double> sorted = latencyMs;
+    std::sort(sorted.begin(), sorted.end());
+    double mean = 0.0;
+    for (double l : sorted)
+        mean += l;
+    mean /= sorted.size();
+    std::printf("  %d cars x %d Hz, %zu frames of %zu bytes: latency mean %.3f ms, p99 %.3f ms, max %.3f ms;"
+        " receive thread %.1f us CPU per frame\n", kCars, kRateHz, sorted.size(), cars.size(), mean,
+        sorted[sorted.size() * 99 / 100], sorted.back(), cpuUs / sorted.size());
+    CHECK(sorted.back() < kStallMs);
+}
+
+} // namespace
+
+int main()
+{
+    testMessages();
+    testAbortAndRefusal();
+    testLoad();
+    return Test::Result("WebSocketTransportTest");
+}